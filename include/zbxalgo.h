@@ -185,6 +185,71 @@ void	*zbx_hashset_iter_next(zbx_hashset_iter_t *iter);
 void	zbx_hashset_iter_remove(zbx_hashset_iter_t *iter);
 void	zbx_hashset_copy(zbx_hashset_t *dst, const zbx_hashset_t *src, size_t size);
 
+/* open addressing hashset */
+
+/* Hashset with the same interface as zbx_hashset_t, but storing entries of a fixed   */
+/* size directly in a Robin Hood open addressing slot array together with their       */
+/* hashes, so inserts do not allocate memory and lookups do not follow pointers.      */
+/* Entries are moved when other entries are inserted or removed, so pointers          */
+/* returned by insert, search and iterator functions are valid only until the next    */
+/* hashset modification (except removal of the current entry through iterator).       */
+
+typedef struct
+{
+	zbx_uint32_t	dist;	/* distance from the home slot plus one, 0 for free slots */
+	zbx_hash_t	hash;
+}
+zbx_oahashset_slot_t;
+
+typedef struct
+{
+	unsigned char		*slots;		/* slot headers, each followed by entry data */
+	size_t			entry_size;
+	size_t			slot_size;
+	int			num_slots;	/* number of home slots, power of 2 */
+	int			num_overflow;	/* number of overflow slots after the home slots */
+	int			num_data;
+	zbx_hash_func_t		hash_func;
+	zbx_compare_func_t	compare_func;
+	zbx_clean_func_t	clean_func;
+	zbx_mem_malloc_func_t	mem_malloc_func;
+	zbx_mem_realloc_func_t	mem_realloc_func;
+	zbx_mem_free_func_t	mem_free_func;
+}
+zbx_oahashset_t;
+
+void	zbx_oahashset_create(zbx_oahashset_t *hs, size_t init_size, size_t entry_size,
+				zbx_hash_func_t hash_func,
+				zbx_compare_func_t compare_func);
+void	zbx_oahashset_create_ext(zbx_oahashset_t *hs, size_t init_size, size_t entry_size,
+				zbx_hash_func_t hash_func,
+				zbx_compare_func_t compare_func,
+				zbx_clean_func_t clean_func,
+				zbx_mem_malloc_func_t mem_malloc_func,
+				zbx_mem_realloc_func_t mem_realloc_func,
+				zbx_mem_free_func_t mem_free_func);
+void	zbx_oahashset_destroy(zbx_oahashset_t *hs);
+
+int	zbx_oahashset_reserve(zbx_oahashset_t *hs, int num_slots_req);
+void	*zbx_oahashset_insert(zbx_oahashset_t *hs, const void *data, size_t size);
+void	*zbx_oahashset_insert_ext(zbx_oahashset_t *hs, const void *data, size_t size, size_t offset);
+void	*zbx_oahashset_search(const zbx_oahashset_t *hs, const void *data);
+void	zbx_oahashset_remove(zbx_oahashset_t *hs, const void *data);
+void	zbx_oahashset_remove_direct(zbx_oahashset_t *hs, void *data);
+
+void	zbx_oahashset_clear(zbx_oahashset_t *hs);
+
+typedef struct
+{
+	zbx_oahashset_t	*hashset;
+	int		slot;
+}
+zbx_oahashset_iter_t;
+
+void	zbx_oahashset_iter_reset(zbx_oahashset_t *hs, zbx_oahashset_iter_t *iter);
+void	*zbx_oahashset_iter_next(zbx_oahashset_iter_t *iter);
+void	zbx_oahashset_iter_remove(zbx_oahashset_iter_t *iter);
+
 /* hashmap */
 
 /* currently, we only have a very specialized hashmap */
@@ -285,6 +350,48 @@ void			zbx_binary_heap_remove_direct(zbx_binary_heap_t *heap, zbx_uint64_t key);
 
 void			zbx_binary_heap_clear(zbx_binary_heap_t *heap);
 
+/* timer wheel */
+
+/* Hierarchical timing wheel with one second resolution. The wheel nodes are embedded */
+/* in the scheduled objects, so scheduling does not allocate memory and the wheel can */
+/* be stored in shared memory. Nodes are expired in no particular order within the    */
+/* same second.                                                                       */
+
+#define ZBX_TIMER_WHEEL_ROOT_BITS	6
+#define ZBX_TIMER_WHEEL_LEVEL_BITS	6
+#define ZBX_TIMER_WHEEL_LEVELS		3
+
+#define ZBX_TIMER_WHEEL_ROOT_SIZE	(1 << ZBX_TIMER_WHEEL_ROOT_BITS)
+#define ZBX_TIMER_WHEEL_LEVEL_SIZE	(1 << ZBX_TIMER_WHEEL_LEVEL_BITS)
+
+typedef struct zbx_timer_wheel_node
+{
+	struct zbx_timer_wheel_node	*next;
+	/* the pointer referencing this node - slot list head or the next pointer of previous node */
+	struct zbx_timer_wheel_node	**pprev;
+	int				expires;
+}
+zbx_timer_wheel_node_t;
+
+typedef struct
+{
+	/* list heads of the root (one second) slots and higher level slots */
+	zbx_timer_wheel_node_t	*root[ZBX_TIMER_WHEEL_ROOT_SIZE];
+	zbx_timer_wheel_node_t	*levels[ZBX_TIMER_WHEEL_LEVELS][ZBX_TIMER_WHEEL_LEVEL_SIZE];
+
+	/* the current wheel time, nodes expiring before it have been expired */
+	int			time;
+	int			nodes_num;
+}
+zbx_timer_wheel_t;
+
+void			zbx_timer_wheel_create(zbx_timer_wheel_t *wheel, int time);
+void			zbx_timer_wheel_insert(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node, int expires);
+void			zbx_timer_wheel_remove(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node);
+int			zbx_timer_wheel_scheduled(const zbx_timer_wheel_node_t *node);
+zbx_timer_wheel_node_t	*zbx_timer_wheel_expire(zbx_timer_wheel_t *wheel, int now);
+int			zbx_timer_wheel_next(const zbx_timer_wheel_t *wheel);
+
 /* vector implementation start */
 
 #define ZBX_VECTOR_STRUCT_DECL(__id, __type)									\
@@ -22,6 +22,7 @@
 
 #include "zbxdbhigh.h"
 #include "zbxcomms.h"
+#include "zbxcompress.h"
 #include "zbxeval.h"
 #include "zbxavailability.h"
 #include "zbxversion.h"
@@ -43,6 +44,9 @@
 #define ZBX_POLLER_TYPE_INTERNAL	10
 #define	ZBX_POLLER_TYPE_COUNT		11	/* number of poller types */
 
+/* poller scheduling latency histogram buckets: <1s, 1-4s, 5-9s, 10-29s, 30-59s, 60s and more */
+#define ZBX_POLLER_LATENCY_BUCKETS	6
+
 typedef enum
 {
 	ZBX_SESSION_TYPE_DATA = 0,
@@ -301,6 +305,7 @@ typedef struct
 	zbx_uint64_t	itemid;
 	char		*function;
 	char		*parameter;
+	zbx_uint64_t	revision;	/* the latest revision of function and user macros used in its parameters */
 	unsigned char	type;
 }
 zbx_dc_function_t;
@@ -572,6 +577,28 @@ typedef struct
 }
 zbx_queue_item_t;
 
+typedef struct
+{
+	int		queued;		/* items due to be polled */
+	int		scheduled;	/* items scheduled for later polling */
+	zbx_uint64_t	latency[ZBX_POLLER_LATENCY_BUCKETS];	/* items taken by pollers by scheduling latency */
+}
+zbx_dc_poller_stats_t;
+
+typedef struct
+{
+	zbx_uint64_t	opened;		/* connections opened to passive agents */
+	zbx_uint64_t	requests;	/* requests sent to passive agents */
+}
+zbx_dc_agent_conn_stats_t;
+
+typedef struct
+{
+	zbx_uint64_t	hits;		/* trigger function results taken from history syncer cache */
+	zbx_uint64_t	misses;		/* cacheable trigger functions that had to be evaluated */
+}
+zbx_dc_func_cache_stats_t;
+
 typedef union
 {
 	zbx_uint64_t	ui64;
@@ -890,6 +917,13 @@ int	zbx_dc_interface_deactivate(zbx_uint64_t interfaceid, const zbx_timespec_t *
 #define ZBX_QUEUE_TO_INFINITY	-1	/* no upper limit for delay */
 void	zbx_dc_free_item_queue(zbx_vector_ptr_t *queue);
 int	zbx_dc_get_item_queue(zbx_vector_ptr_t *queue, int from, int to);
+void	zbx_dc_get_poller_stats(zbx_dc_poller_stats_t *stats);
+void	zbx_dc_update_agent_conn_stats(const zbx_dc_agent_conn_stats_t *stats);
+void	zbx_dc_get_agent_conn_stats(zbx_dc_agent_conn_stats_t *stats);
+void	zbx_dc_update_func_cache_stats(const zbx_dc_func_cache_stats_t *stats);
+void	zbx_dc_get_func_cache_stats(zbx_dc_func_cache_stats_t *stats);
+void	zbx_dc_flush_compress_stats(void);
+void	zbx_dc_get_compress_stats(int codec, zbx_compress_stats_t *stats);
 
 zbx_uint64_t	zbx_dc_get_item_count(zbx_uint64_t hostid);
 zbx_uint64_t	zbx_dc_get_item_unsupported_count(zbx_uint64_t hostid);
@@ -67,6 +67,7 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 void	zbx_free_database_cache(int sync, const zbx_events_funcs_t *events_cbs);
 
 void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_events_funcs_t *events_cbs, int *more);
+void	zbx_hc_set_syncer_num(int syncer_num);
 
 #define ZBX_STATS_HISTORY_COUNTER	0
 #define ZBX_STATS_HISTORY_FLOAT_COUNTER	1
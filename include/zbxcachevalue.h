@@ -49,6 +49,9 @@
  *   functions. Afterwards the retrieved history data must be freed by the caller by using
  *   either zbx_history_record_vector_destroy() function (free the zbx_vc_get_values()
  *   call output) or zbx_history_record_clear() function (free the zbx_vc_get_value() call output).
+ *   Sum, average, minimum, maximum and count of numeric item values in a time period can
+ *   be retrieved with zbx_vc_get_aggregate() function without copying the values, if the
+ *   cache keeps running aggregates for the period.
  *
  * Locking
  *
@@ -61,6 +64,10 @@
 #define ZBX_VC_MODE_NORMAL	0
 #define ZBX_VC_MODE_LOWMEM	1
 
+/* numeric value storage in full cache chunks */
+#define ZBX_VC_COMPRESSION_NONE		0
+#define ZBX_VC_COMPRESSION_DELTA	1
+
 /* indicates that all values from database are cached */
 #define ZBX_ITEM_STATUS_CACHED_ALL	1
 
@@ -83,6 +90,17 @@ typedef struct
 }
 zbx_vc_stats_t;
 
+/* the aggregates of item values in a time period */
+typedef struct
+{
+	int			values_num;
+	zbx_history_value_t	sum;
+	zbx_history_value_t	min;
+	zbx_history_value_t	max;
+	double			avg;
+}
+zbx_vc_aggregate_t;
+
 /* item diagnostic statistics */
 typedef struct
 {
@@ -92,7 +110,16 @@ typedef struct
 }
 zbx_vc_item_stats_t;
 
-int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error);
+/* item history revision, see zbx_vc_get_items_revisions() */
+typedef struct
+{
+	zbx_uint64_t	itemid;
+	zbx_uint64_t	revision;	/* 0 if the item is not cached or has no values */
+	zbx_timespec_t	ts;		/* the last (newest) value timestamp */
+}
+zbx_vc_item_revision_t;
+
+int	zbx_vc_init(zbx_uint64_t value_cache_size, int compression, char **error);
 
 void	zbx_vc_destroy(void);
 
@@ -110,6 +137,11 @@ int	zbx_vc_get_value(zbx_uint64_t itemid, unsigned char value_type, const zbx_ti
 
 int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush);
 
+int	zbx_vc_get_aggregate(zbx_uint64_t itemid, unsigned char value_type, int seconds, const zbx_timespec_t *ts,
+		zbx_vc_aggregate_t *aggregate);
+
+void	zbx_vc_get_items_revisions(zbx_vc_item_revision_t *revisions, int revisions_num);
+
 int	zbx_vc_get_statistics(zbx_vc_stats_t *stats);
 
 void	zbx_vc_remove_items_by_ids(zbx_vector_uint64_t *itemids);
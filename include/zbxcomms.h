@@ -22,6 +22,7 @@
 
 #include "zbxalgo.h"
 #include "zbxtime.h"
+#include "zbxcompress.h"
 
 #define ZBX_IPV4_MAX_CIDR_PREFIX	32	/* max number of bits in IPv4 CIDR prefix */
 #define ZBX_IPV6_MAX_CIDR_PREFIX	128	/* max number of bits in IPv6 CIDR prefix */
@@ -177,8 +178,11 @@ typedef struct
 	char	psk_buf[HOST_TLS_PSK_LEN / 2];
 	int	psk_len;
 	size_t	identity_len;
+	int	has_psk;					/* accepted connection uses PSK */
+	char	psk_identity[PSK_MAX_IDENTITY_LEN + 1];		/* PSK identity of accepted connection */
 #endif
 #endif
+	unsigned int			psk_usage;	/* where PSK of accepted connection was found */
 } zbx_tls_context_t;
 #endif
 
@@ -213,14 +217,15 @@ zbx_socket_t;
 
 typedef struct
 {
-	size_t		buf_dyn_bytes;
-	size_t		buf_stat_bytes;
-	size_t		offset;
-	zbx_uint64_t	expected_len;
-	zbx_uint64_t	reserved;
-	zbx_uint64_t	max_len;
-	unsigned char	expect;
-	int		protocol_version;
+	size_t			buf_dyn_bytes;
+	size_t			buf_stat_bytes;
+	size_t			offset;
+	zbx_uint64_t		expected_len;
+	zbx_uint64_t		reserved;
+	zbx_uint64_t		max_len;
+	unsigned char		expect;
+	int			protocol_version;
+	zbx_uncompress_stream_t	*stream;
 }
 zbx_tcp_recv_context_t;
 
@@ -261,6 +266,14 @@ int	zbx_socket_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char
 #define ZBX_TCP_PROTOCOL		0x01
 #define ZBX_TCP_COMPRESS		0x02
 #define ZBX_TCP_LARGE			0x04
+#define ZBX_TCP_COMPRESS_ZSTD		0x08	/* compressed data uses zstd instead of zlib, */
+						/* must be combined with ZBX_TCP_COMPRESS     */
+#define ZBX_TCP_COMPRESS_LZ4		0x10	/* compressed data uses lz4 instead of zlib,  */
+						/* must be combined with ZBX_TCP_COMPRESS     */
+
+/* Older peers reject the codec flags, so senders must not set them unless the peer has advertised the */
+/* codec (see zbx_get_compress_flags()). Responses use the codec of the request when it is not set.    */
+#define ZBX_TCP_COMPRESS_CODECS		(ZBX_TCP_COMPRESS_ZSTD | ZBX_TCP_COMPRESS_LZ4)
 
 #define ZBX_TCP_SEC_UNENCRYPTED		1		/* do not use encryption with this socket */
 #define ZBX_TCP_SEC_TLS_PSK		2		/* use TLS with pre-shared key (PSK) with this socket */
@@ -271,6 +284,9 @@ int	zbx_socket_tls_connect(zbx_socket_t *s, unsigned int tls_connect, const char
 
 const char	*zbx_tcp_connection_type_name(unsigned int type);
 
+int	zbx_tcp_compress_codec(unsigned char flags);
+unsigned char	zbx_tcp_compress_codec_flags(int codec);
+
 #define zbx_tcp_send(s, d)				zbx_tcp_send_ext((s), (d), strlen(d), 0, ZBX_TCP_PROTOCOL, 0)
 #define zbx_tcp_send_to(s, d, timeout)			zbx_tcp_send_ext((s), (d), strlen(d), 0,	\
 									ZBX_TCP_PROTOCOL, timeout)
@@ -295,6 +311,8 @@ int	zbx_tcp_listen(zbx_socket_t *s, const char *listen_ip, unsigned short listen
 void	zbx_tcp_unlisten(zbx_socket_t *s);
 
 int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout);
+int	zbx_tcp_accept_connection(zbx_socket_t *s, int poll_timeout);
+int	zbx_tcp_accept_handshake(zbx_socket_t *s, unsigned int tls_accept, short *event);
 void	zbx_tcp_unaccept(zbx_socket_t *s);
 
 #define ZBX_TCP_READ_UNTIL_CLOSE 0x01
@@ -312,6 +330,7 @@ const char	*zbx_tcp_recv_line(zbx_socket_t *s);
 
 void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv_context, unsigned char flags);
 ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, unsigned char flags, short *events);
+void	zbx_tcp_recv_context_clear(zbx_tcp_recv_context_t *tcp_recv_context);
 
 void	zbx_socket_set_deadline(zbx_socket_t *s, int timeout);
 int	zbx_socket_check_deadline(zbx_socket_t *s);
@@ -450,7 +469,7 @@ int		zbx_tls_validate_attr(const zbx_socket_t *sock, const zbx_tls_conn_attr_t *
 				const char *tls_subject, const char *tls_psk_identity, const char **msg);
 int		zbx_check_server_issuer_subject(const zbx_socket_t *sock, const char *allowed_issuer,
 				const char *allowed_subject, char **error);
-unsigned int	zbx_tls_get_psk_usage(void);
+unsigned int	zbx_tls_get_psk_usage(const zbx_socket_t *s);
 
 /* TLS BLOCK END */
 
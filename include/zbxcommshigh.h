@@ -21,14 +21,20 @@
 #define ZABBIX_COMMSHIGH_H
 
 #include "zbxcomms.h"
+#include "zbxjson.h"
 #include "cfg.h"
 
 int	zbx_connect_to_server(zbx_socket_t *sock, const char *source_ip, zbx_vector_addr_ptr_t *addrs, int timeout,
 		int connect_timeout, int retry_interval, int level, const zbx_config_tls_t *config_tls);
 void	zbx_disconnect_from_server(zbx_socket_t *sock);
 
-int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error);
-int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error);
+int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char flags, char **error);
+int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char flags, char **error);
+
+void	zbx_add_compress_codecs(struct zbx_json *j);
+unsigned char	zbx_get_compress_flags(const struct zbx_json_parse *jp);
 
 int	zbx_send_response_ext(zbx_socket_t *sock, int result, const char *info, const char *version, int protocol,
 		int timeout);
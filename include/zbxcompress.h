@@ -22,8 +22,34 @@
 
 #include "zbxtypes.h"
 
+#define ZBX_COMPRESS_ZLIB	0
+#define ZBX_COMPRESS_ZSTD	1
+#define ZBX_COMPRESS_LZ4	2
+
+#define ZBX_COMPRESS_CODEC_NUM	3
+
+/* compression statistics of a codec */
+typedef struct
+{
+	zbx_uint64_t	size;			/* uncompressed data size */
+	zbx_uint64_t	size_compressed;	/* compressed data size */
+	double		cpu_time;		/* CPU time spent compressing and uncompressing, seconds */
+}
+zbx_compress_stats_t;
+
 int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out);
 int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out);
+int	zbx_compress_ext(int codec, const char *in, size_t size_in, char **out, size_t *size_out);
+int	zbx_uncompress_ext(int codec, const char *in, size_t size_in, char *out, size_t *size_out);
+int	zbx_compress_codec_supported(int codec);
+const char	*zbx_compress_codec_name(int codec);
 const char	*zbx_compress_strerror(void);
+void	zbx_compress_get_stats(zbx_compress_stats_t *stats);
+
+typedef struct zbx_uncompress_stream	zbx_uncompress_stream_t;
+
+zbx_uncompress_stream_t	*zbx_uncompress_stream_open(int codec, size_t size_max);
+int	zbx_uncompress_stream_write(zbx_uncompress_stream_t *stream, const char *in, size_t size_in);
+int	zbx_uncompress_stream_close(zbx_uncompress_stream_t *stream, char **out, size_t *size_out);
 
 #endif
@@ -142,6 +142,9 @@ void	zbx_postgresql_escape_bin(const char *src, char **dst, size_t size);
 #endif
 
 int		zbx_db_vexecute(const char *fmt, va_list args);
+int		zbx_db_copy_basic(const char *sql, const char *data, size_t size);
+void		zbx_db_pipeline_begin(void);
+int		zbx_db_pipeline_end(void);
 zbx_db_result_t	zbx_db_vselect(const char *fmt, va_list args);
 zbx_db_result_t	zbx_db_select_n_basic(const char *query, int n);
 
@@ -704,6 +704,32 @@ void	zbx_db_insert_clean(zbx_db_insert_t *self);
 void	zbx_db_insert_autoincrement(zbx_db_insert_t *self, const char *field_name);
 zbx_uint64_t	zbx_db_insert_get_lastid(zbx_db_insert_t *self);
 
+/* bulk copy support */
+
+/* database bulk copy data */
+typedef struct
+{
+	/* the target table */
+	const zbx_db_table_t	*table;
+	/* the fields to copy (pointers to the zbx_db_field_t structures from database schema) */
+	zbx_vector_ptr_t	fields;
+	/* the rows to copy, encoded in PostgreSQL binary COPY format */
+	char			*data;
+	size_t			data_alloc;
+	size_t			data_offset;
+	/* the number of added rows */
+	int			rows_num;
+}
+zbx_db_copy_t;
+
+void	zbx_db_copy_prepare_dyn(zbx_db_copy_t *self, const zbx_db_table_t *table, const zbx_db_field_t **fields,
+		int fields_num);
+void	zbx_db_copy_prepare(zbx_db_copy_t *self, const char *table, ...);
+void	zbx_db_copy_add_values_dyn(zbx_db_copy_t *self, zbx_db_value_t **values, int values_num);
+void	zbx_db_copy_add_values(zbx_db_copy_t *self, ...);
+int	zbx_db_copy_execute(zbx_db_copy_t *self);
+void	zbx_db_copy_clean(zbx_db_copy_t *self);
+
 int	zbx_db_get_database_type(void);
 
 typedef struct
@@ -40,6 +40,7 @@ typedef enum
 	ZBX_DIAGINFO_LOCKS,
 	ZBX_DIAGINFO_CONNECTOR,
 	ZBX_DIAGINFO_PROXYBUFFER,
+	ZBX_DIAGINFO_POLLERS,
 }
 zbx_diaginfo_section_t;
 
@@ -62,6 +63,7 @@ typedef int (*zbx_diag_add_section_info_func_t)(const char *section, const struc
 #define ZBX_DIAG_LOCKS		"locks"
 #define ZBX_DIAG_CONNECTOR	"connector"
 #define ZBX_DIAG_PROXYBUFFER	"proxybuffer"
+#define ZBX_DIAG_POLLERS	"pollers"
 
 void	zbx_diag_map_free(zbx_diag_map_t *map);
 int	zbx_diag_parse_request(const struct zbx_json_parse *jp, const zbx_diag_map_t *field_map, zbx_uint64_t
@@ -69,6 +71,7 @@ int	zbx_diag_parse_request(const struct zbx_json_parse *jp, const zbx_diag_map_t
 void	zbx_diag_add_mem_stats(struct zbx_json *json, const char *name, const zbx_shmem_stats_t *stats);
 int	zbx_diag_add_historycache_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
 void	zbx_diag_add_locks_info(struct zbx_json *json);
+void	zbx_diag_add_pollers_info(struct zbx_json *json);
 int	zbx_diag_add_connector_info(const struct zbx_json_parse *jp, struct zbx_json *json, char **error);
 
 void	zbx_diag_init(zbx_diag_add_section_info_func_t cb);
@@ -145,6 +145,8 @@ void	zbx_evaluate_expressions(zbx_vector_dc_trigger_t *triggers, const zbx_vecto
 void	zbx_format_value(char *value, size_t max_len, zbx_uint64_t valuemapid,
 		const char *units, unsigned char value_type);
 
+void	zbx_get_trigger_functions_stats(zbx_uint64_t *evaluated, zbx_uint64_t *hits, zbx_uint64_t *misses);
+
 void	zbx_determine_items_in_expressions(zbx_vector_dc_trigger_t *trigger_order, const zbx_uint64_t *itemids,
 		int item_num);
 
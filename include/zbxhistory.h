@@ -52,7 +52,7 @@ void	zbx_history_value2variant(const zbx_history_value_t *value, unsigned char v
 /* mirrors the vector creation function to vector destroying function.                    */
 #define zbx_history_record_vector_create(vector)	zbx_vector_history_record_create(vector)
 
-int	zbx_history_init(char **error);
+int	zbx_history_init(int config_history_db_copy, char **error);
 void	zbx_history_destroy(void);
 
 int	zbx_history_add_values(const zbx_vector_ptr_t *history, int *ret_flush);
@@ -208,6 +208,7 @@
 #define ZBX_PROTO_TAG_ACKNOWLEDGEID		"acknowledgeid"
 #define ZBX_PROTO_TAG_WAIT			"wait"
 #define ZBX_PROTO_TAG_RUNTIME_ERROR		"runtime_error"
+#define ZBX_PROTO_TAG_COMPRESSION		"compression"
 
 #define ZBX_PROTO_VALUE_FAILED		"failed"
 #define ZBX_PROTO_VALUE_SUCCESS		"success"
@@ -329,6 +330,8 @@ const char	*zbx_json_decodevalue_dyn(const char *p, char **string, size_t *strin
 void		zbx_json_escape(char **string);
 int		zbx_json_open_path(const struct zbx_json_parse *jp, const char *path, struct zbx_json_parse *out);
 zbx_json_type_t	zbx_json_valuetype(const char *p);
+void		zbx_json_index_open(const struct zbx_json_parse *jp);
+void		zbx_json_index_close(void);
 
 /* jsonpath support */
 
@@ -35,6 +35,11 @@ typedef HANDLE zbx_mutex_t;
 #	define zbx_mutex_lock(mutex)		__zbx_mutex_lock(__FILE__, __LINE__, mutex)
 #	define zbx_mutex_unlock(mutex)		__zbx_mutex_unlock(__FILE__, __LINE__, mutex)
 #else	/* not _WINDOWS */
+/* number of history queue shards, each protected by its own mutex */
+#define ZBX_MUTEX_HISTORY_QUEUE_NUM	8
+/* number of poller queues, each protected by its own mutex, must match ZBX_POLLER_TYPE_COUNT */
+#define ZBX_MUTEX_POLLER_QUEUE_NUM	11
+
 typedef enum
 {
 	ZBX_MUTEX_LOG = 0,
@@ -57,6 +62,10 @@ typedef enum
 	ZBX_MUTEX_REMOTE_COMMANDS,
 	ZBX_MUTEX_PROXY_BUFFER,
 	ZBX_MUTEX_VPS_MONITOR,
+	ZBX_MUTEX_HISTORY_QUEUE,
+	ZBX_MUTEX_HISTORY_QUEUE_LAST = ZBX_MUTEX_HISTORY_QUEUE + ZBX_MUTEX_HISTORY_QUEUE_NUM - 1,
+	ZBX_MUTEX_POLLER_QUEUE,
+	ZBX_MUTEX_POLLER_QUEUE_LAST = ZBX_MUTEX_POLLER_QUEUE + ZBX_MUTEX_POLLER_QUEUE_NUM - 1,
 	/* NOTE: Do not forget to sync changes here with mutex names in diag_add_locks_info()! */
 	ZBX_MUTEX_COUNT
 }
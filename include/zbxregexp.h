@@ -46,6 +46,9 @@ ZBX_PTR_VECTOR_DECL(expression, zbx_expression_t *)
 /* regular expressions */
 int	zbx_regexp_compile(const char *pattern, zbx_regexp_t **regexp, char **err_msg);
 int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags, char **err_msg);
+int	zbx_regexp_compile_cached(const char *pattern, const zbx_regexp_t **regexp, char **err_msg);
+int	zbx_regexp_compile_ext_cached(const char *pattern, const zbx_regexp_t **regexp, int flags, char **err_msg);
+void	zbx_regexp_cache_get_stats(zbx_uint64_t *hits, zbx_uint64_t *misses);
 void	zbx_regexp_free(zbx_regexp_t *regexp);
 int	zbx_regexp_match_precompiled(const char *string, const zbx_regexp_t *regexp);
 int	zbx_regexp_match_precompiled2(const char *string, const zbx_regexp_t *regexp, char **err_msg);
@@ -68,6 +71,7 @@ int	zbx_regexp_sub_ex2(const zbx_vector_expression_t *regexps, const char *strin
 		int case_sensitive, const char *output_template, char **output, char **err_msg);
 int	zbx_global_regexp_exists(const char *name, const zbx_vector_expression_t *regexps);
 void	zbx_regexp_escape(char **string);
+char	*zbx_regexp_get_literal(const char *pattern);
 
 /* wildcards */
 void	zbx_wildcard_minimize(char *str);
@@ -28,6 +28,18 @@
 #define SHMEM_MAX_BUCKET_SIZE		256 /* starting from this size all free chunks are put into the same bucket */
 #define ZBX_SHMEM_BUCKET_COUNT		((SHMEM_MAX_BUCKET_SIZE - ZBX_SHMEM_MIN_BUCKET_SIZE) / 8 + 1)
 
+#define ZBX_SHMEM_SLAB_MAX_SIZE		SHMEM_MAX_BUCKET_SIZE	/* objects up to this size are allocated from slabs */
+#define ZBX_SHMEM_SLAB_CLASS_COUNT	(ZBX_SHMEM_SLAB_MAX_SIZE / 8)
+
+typedef struct
+{
+	void		*pages;		/* slab pages having free objects */
+	zbx_uint64_t	pages_num;
+	zbx_uint64_t	objects_num;
+	zbx_uint64_t	objects_used;
+}
+zbx_shmem_slab_class_t;
+
 typedef struct
 {
 	void		*base;
@@ -45,8 +57,13 @@ typedef struct
 	/* Set this flag to 1 to allow execution in out of memory situations.     */
 	char		allow_oom;
 
+	/* Serve small allocations from fixed size class slabs, see zbx_shmem_enable_slabs(). */
+	char		use_slabs;
+
 	const char	*mem_descr;
 	const char	*mem_param;
+
+	zbx_shmem_slab_class_t	slabs[ZBX_SHMEM_SLAB_CLASS_COUNT];
 }
 zbx_shmem_info_t;
 
@@ -60,6 +77,11 @@ typedef struct
 	unsigned int	chunks_num[ZBX_SHMEM_BUCKET_COUNT];
 	unsigned int	free_chunks;
 	unsigned int	used_chunks;
+	zbx_uint64_t	slab_pages;
+	zbx_uint64_t	slab_used_objects;
+	zbx_uint64_t	slab_free_objects;
+	zbx_uint64_t	slab_used_size;		/* memory used by objects allocated from slabs */
+	zbx_uint64_t	slab_free_size;		/* memory of free slab objects, included in free_size */
 }
 zbx_shmem_stats_t;
 
@@ -68,6 +90,7 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 int	zbx_shmem_create_min(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
 		int allow_oom, char **error);
 void	zbx_shmem_destroy(zbx_shmem_info_t *info);
+void	zbx_shmem_enable_slabs(zbx_shmem_info_t *info);
 
 #define	zbx_shmem_malloc(info, old, size) __zbx_shmem_malloc(__FILE__, __LINE__, info, old, size)
 #define	zbx_shmem_realloc(info, old, size) __zbx_shmem_realloc(__FILE__, __LINE__, info, old, size)
@@ -0,0 +1,119 @@
+# LIBLZ4_CHECK_CONFIG ([DEFAULT-ACTION])
+# ----------------------------------------------------------
+#
+# Checks for liblz4.  DEFAULT-ACTION is the string yes or no to
+# specify whether to default to --with-lz4 or --without-lz4.
+# If not supplied, DEFAULT-ACTION is no.
+#
+# This macro #defines HAVE_LZ4 if required header files are
+# found, and sets @LZ4_LDFLAGS@, @LZ4_CFLAGS@ and @LZ4_LIBS@
+# to the necessary values.
+#
+# This macro is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+AC_DEFUN([LIBLZ4_TRY_LINK],
+[
+found_lz4=$1
+AC_LINK_IFELSE([AC_LANG_PROGRAM([[
+#include <lz4frame.h>
+]], [[
+	LZ4F_dctx	*dctx;
+
+	LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+	LZ4F_resetDecompressionContext(dctx);
+	LZ4F_freeDecompressionContext(dctx);
+]])],[found_lz4="yes"],[])
+])dnl
+
+AC_DEFUN([LIBLZ4_CHECK_CONFIG],
+[
+	AC_ARG_WITH([lz4],[
+If you want to use lz4 compression for Zabbix protocol:
+AS_HELP_STRING([--with-lz4@<:@=DIR@:>@], [use lz4 from given base install directory (DIR), default is to search through a number of common places for the lz4 files.])],
+		[
+			if test "x$withval" = "xno"; then
+				want_lz4="no"
+			elif test "x$withval" = "xyes"; then
+				want_lz4="yes"
+			else
+				want_lz4="yes"
+				LZ4_CFLAGS="-I$withval/include"
+				LZ4_LDFLAGS="-L$withval/lib"
+				_lz4_dir_set="yes"
+			fi
+		],
+		[want_lz4=ifelse([$1],,[no],[$1])]
+	)
+
+	AC_ARG_WITH([lz4-include],
+		AS_HELP_STRING([--with-lz4-include=DIR],
+			[use lz4 include headers from given path.]
+		),
+		[
+			LZ4_CFLAGS="-I$withval"
+			_lz4_dir_set="yes"
+		]
+	)
+
+	AC_ARG_WITH([lz4-lib],
+		AS_HELP_STRING([--with-lz4-lib=DIR],
+			[use lz4 libraries from given path.]
+		),
+		[
+			LZ4_LDFLAGS="-L$withval"
+			_lz4_dir_set="yes"
+		]
+	)
+
+	if test "x$want_lz4" = "xyes"; then
+		AC_MSG_CHECKING(for lz4 support)
+
+		LZ4_LIBS="-llz4"
+
+		if test -n "$_lz4_dir_set" -o -f /usr/include/lz4frame.h; then
+			found_lz4="yes"
+		elif test -f /usr/local/include/lz4frame.h; then
+			LZ4_CFLAGS="-I/usr/local/include"
+			LZ4_LDFLAGS="-L/usr/local/lib"
+			found_lz4="yes"
+		elif test -f /usr/pkg/include/lz4frame.h; then
+			LZ4_CFLAGS="-I/usr/pkg/include"
+			LZ4_LDFLAGS="-L/usr/pkg/lib"
+			found_lz4="yes"
+		else
+			found_lz4="no"
+		fi
+
+		if test "x$found_lz4" = "xyes"; then
+			am_save_CFLAGS="$CFLAGS"
+			am_save_LDFLAGS="$LDFLAGS"
+			am_save_LIBS="$LIBS"
+
+			CFLAGS="$CFLAGS $LZ4_CFLAGS"
+			LDFLAGS="$LDFLAGS $LZ4_LDFLAGS"
+			LIBS="$LIBS $LZ4_LIBS"
+
+			LIBLZ4_TRY_LINK([no])
+
+			CFLAGS="$am_save_CFLAGS"
+			LDFLAGS="$am_save_LDFLAGS"
+			LIBS="$am_save_LIBS"
+		fi
+
+		if test "x$found_lz4" = "xyes"; then
+			AC_DEFINE([HAVE_LZ4], 1, [Define to 1 if you have the 'lz4' library (-llz4)])
+			AC_MSG_RESULT(yes)
+		else
+			AC_MSG_RESULT(no)
+			LZ4_CFLAGS=""
+			LZ4_LDFLAGS=""
+			LZ4_LIBS=""
+		fi
+	fi
+
+	AC_SUBST(LZ4_CFLAGS)
+	AC_SUBST(LZ4_LDFLAGS)
+	AC_SUBST(LZ4_LIBS)
+])dnl
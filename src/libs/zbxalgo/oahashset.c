@@ -0,0 +1,562 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxalgo.h"
+
+/******************************************************************************
+ *                                                                            *
+ * The slot array consists of num_slots home slots followed by num_overflow   *
+ * overflow slots. Each slot has a header with the entry hash and distance    *
+ * from the entry home slot, followed by the entry data of fixed size.        *
+ * An entry is placed in the first free slot starting from its home slot      *
+ * (hash & (num_slots - 1)). The probe sequence never wraps around - when it  *
+ * reaches the end of the overflow slots the table is grown instead.          *
+ * Doubling home slots does not help when many entries share the same hash,   *
+ * so after a few attempts the overflow slots are doubled instead, degrading  *
+ * such entries to a linear scan rather than growing the table without limit. *
+ *                                                                            *
+ * Robin Hood rule is used when inserting - an entry further away from its    *
+ * home slot takes the place of an entry closer to its home slot. This keeps  *
+ * entries of a probe run ordered by their home slots, so an entry is         *
+ * inserted by shifting the rest of the run by one slot, and allows to stop   *
+ * a failed search as soon as an entry closer to its home slot than the       *
+ * searched one is found.                                                     *
+ *                                                                            *
+ * Entries are removed with backward shift deletion, so no tombstones are     *
+ * needed. As entries are shifted only towards lower slots, an iterator       *
+ * can remove the current entry and continue from the same slot.              *
+ *                                                                            *
+ ******************************************************************************/
+
+#define	CRIT_LOAD_FACTOR	4/5
+
+#define OAHASHSET_DEFAULT_SLOTS		16
+#define OAHASHSET_OVERFLOW_SLOTS	64
+
+/* number of home slot doublings tried before doubling the overflow slots */
+#define OAHASHSET_GROW_TRIES		2
+
+#define OAHASHSET_HOME(hs, hash)	((int)((hash) & (zbx_hash_t)((hs)->num_slots - 1)))
+#define OAHASHSET_SLOTS_TOTAL(hs)	((hs)->num_slots + (hs)->num_overflow)
+#define OAHASHSET_SLOT(hs, i)		((zbx_oahashset_slot_t *)((hs)->slots + (size_t)(i) * (hs)->slot_size))
+#define OAHASHSET_ENTRY(slot)		((void *)((zbx_oahashset_slot_t *)(slot) + 1))
+
+/* private hashset functions */
+
+static int	oahashset_slots_by_size(size_t size)
+{
+	int	num_slots = OAHASHSET_DEFAULT_SLOTS;
+
+	/* keep the load factor below CRIT_LOAD_FACTOR after inserting size entries */
+	while ((size_t)num_slots * CRIT_LOAD_FACTOR <= size)
+		num_slots *= 2;
+
+	return num_slots;
+}
+
+static int	oahashset_alloc_slots(zbx_oahashset_t *hs, int num_slots, int num_overflow)
+{
+	size_t	alloc_size = ((size_t)num_slots + (size_t)num_overflow) * hs->slot_size;
+
+	if (NULL == (hs->slots = (unsigned char *)hs->mem_malloc_func(NULL, alloc_size)))
+		return FAIL;
+
+	memset(hs->slots, 0, alloc_size);
+	hs->num_slots = num_slots;
+	hs->num_overflow = num_overflow;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reserves slot for entry with the specified hash according to      *
+ *          Robin Hood rule                                                   *
+ *                                                                            *
+ * Parameters: hs   - [IN] the hashset                                        *
+ *             hash - [IN] the entry hash                                     *
+ *                                                                            *
+ * Return value: index of the reserved slot, its entry data must be copied by *
+ *               the caller, or -1 if there are no free slots after the entry *
+ *               home slot and the slot array must be grown                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	oahashset_place(zbx_oahashset_t *hs, zbx_hash_t hash)
+{
+	int			i, pos = -1, home, slots_total = OAHASHSET_SLOTS_TOTAL(hs);
+	zbx_uint32_t		dist;
+	zbx_oahashset_slot_t	*slot;
+
+	home = OAHASHSET_HOME(hs, hash);
+
+	for (i = home, dist = 1; i < slots_total; i++, dist++)
+	{
+		slot = OAHASHSET_SLOT(hs, i);
+
+		if (0 == slot->dist)
+			break;
+
+		if (-1 == pos && slot->dist < dist)
+			pos = i;
+	}
+
+	if (i == slots_total)
+		return -1;
+
+	if (-1 == pos)
+	{
+		pos = i;
+	}
+	else
+	{
+		int	j;
+
+		/* shift the entries closer to their home slots by one slot towards the free slot */
+		memmove(OAHASHSET_SLOT(hs, pos + 1), OAHASHSET_SLOT(hs, pos), (size_t)(i - pos) * hs->slot_size);
+
+		for (j = pos + 1; j <= i; j++)
+			OAHASHSET_SLOT(hs, j)->dist++;
+	}
+
+	slot = OAHASHSET_SLOT(hs, pos);
+	slot->dist = (zbx_uint32_t)(pos - home + 1);
+	slot->hash = hash;
+
+	return pos;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: grows the slot array and reserves slot for the pending entry      *
+ *                                                                            *
+ * Parameters: hs           - [IN] the hashset                                *
+ *             num_slots    - [IN] the minimum number of home slots           *
+ *             num_overflow - [IN] the minimum number of overflow slots       *
+ *             pending      - [IN] hash of the entry to place after growing   *
+ *                                 the array, can be NULL                     *
+ *             pending_pos  - [OUT] slot reserved for the pending entry       *
+ *                                                                            *
+ * Return value: SUCCEED - the slot array was grown                           *
+ *               FAIL    - not enough memory                                  *
+ *                                                                            *
+ * Comments: On failure the hashset is left unchanged.                        *
+ *                                                                            *
+ *           If entries cannot be placed, home slots are doubled up to        *
+ *           OAHASHSET_GROW_TRIES times. Further attempts, or all attempts    *
+ *           once the overflow slots were enlarged, double the overflow slots *
+ *           instead. Overflow slots are bounded by the number of entries, so *
+ *           the array size stays proportional to the hashset size even when  *
+ *           all keys have the same hash.                                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	oahashset_grow(zbx_oahashset_t *hs, int num_slots, int num_overflow, const zbx_hash_t *pending,
+		int *pending_pos)
+{
+	unsigned char	*old_slots = hs->slots;
+	int		i, pos, old_slots_total = OAHASHSET_SLOTS_TOTAL(hs), old_num_slots = hs->num_slots,
+			old_num_overflow = hs->num_overflow, tries = 0;
+
+	while (1)
+	{
+		if (SUCCEED != oahashset_alloc_slots(hs, num_slots, num_overflow))
+		{
+			hs->slots = old_slots;
+			hs->num_slots = old_num_slots;
+			hs->num_overflow = old_num_overflow;
+
+			return FAIL;
+		}
+
+		for (i = 0; i < old_slots_total; i++)
+		{
+			const zbx_oahashset_slot_t	*old = (const zbx_oahashset_slot_t *)(old_slots +
+									(size_t)i * hs->slot_size);
+
+			if (0 == old->dist)
+				continue;
+
+			if (-1 == (pos = oahashset_place(hs, old->hash)))
+				break;
+
+			memcpy(OAHASHSET_ENTRY(OAHASHSET_SLOT(hs, pos)), OAHASHSET_ENTRY(old), hs->entry_size);
+		}
+
+		if (i == old_slots_total && (NULL == pending || -1 != (*pending_pos = oahashset_place(hs, *pending))))
+			break;
+
+		/* too long probe sequence, try with more slots */
+		hs->mem_free_func(hs->slots);
+
+		if (OAHASHSET_OVERFLOW_SLOTS == num_overflow && OAHASHSET_GROW_TRIES > tries++)
+			num_slots *= 2;
+		else
+			num_overflow *= 2;
+	}
+
+	if (NULL != old_slots)
+		hs->mem_free_func(old_slots);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds slot of the entry matching the given data                   *
+ *                                                                            *
+ * Return value: the slot index or -1 if the entry was not found              *
+ *                                                                            *
+ ******************************************************************************/
+static int	oahashset_find(const zbx_oahashset_t *hs, const void *data, zbx_hash_t hash)
+{
+	int		i, slots_total = OAHASHSET_SLOTS_TOTAL(hs);
+	zbx_uint32_t	dist;
+
+	for (i = OAHASHSET_HOME(hs, hash), dist = 1; i < slots_total; i++, dist++)
+	{
+		const zbx_oahashset_slot_t	*slot = OAHASHSET_SLOT(hs, i);
+
+		/* a free slot or an entry closer to its home slot ends the probe sequence */
+		if (slot->dist < dist)
+			break;
+
+		if (slot->hash == hash && 0 == hs->compare_func(OAHASHSET_ENTRY(slot), data))
+			return i;
+	}
+
+	return -1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes entry from the specified slot                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	oahashset_remove_slot(zbx_oahashset_t *hs, int i)
+{
+	int	j, slots_total = OAHASHSET_SLOTS_TOTAL(hs);
+
+	if (NULL != hs->clean_func)
+		hs->clean_func(OAHASHSET_ENTRY(OAHASHSET_SLOT(hs, i)));
+
+	hs->num_data--;
+
+	/* shift back the following entries that are not in their home slots */
+	for (j = i + 1; j < slots_total && 1 < OAHASHSET_SLOT(hs, j)->dist; j++)
+		;
+
+	if (j > i + 1)
+	{
+		int	k;
+
+		memmove(OAHASHSET_SLOT(hs, i), OAHASHSET_SLOT(hs, i + 1), (size_t)(j - i - 1) * hs->slot_size);
+
+		for (k = i; k < j - 1; k++)
+			OAHASHSET_SLOT(hs, k)->dist--;
+	}
+
+	OAHASHSET_SLOT(hs, j - 1)->dist = 0;
+}
+
+/* public hashset interface */
+
+void	zbx_oahashset_create(zbx_oahashset_t *hs, size_t init_size, size_t entry_size,
+				zbx_hash_func_t hash_func,
+				zbx_compare_func_t compare_func)
+{
+	zbx_oahashset_create_ext(hs, init_size, entry_size, hash_func, compare_func, NULL,
+					ZBX_DEFAULT_MEM_MALLOC_FUNC,
+					ZBX_DEFAULT_MEM_REALLOC_FUNC,
+					ZBX_DEFAULT_MEM_FREE_FUNC);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: creates open addressing hashset                                   *
+ *                                                                            *
+ * Parameters: hs         - [OUT] the hashset                                 *
+ *             init_size  - [IN] number of entries to allocate slots for      *
+ *             entry_size - [IN] size of hashset entries, entries are stored  *
+ *                               directly in the slot array                   *
+ *             ...        - [IN] the same as for zbx_hashset_create_ext()     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_oahashset_create_ext(zbx_oahashset_t *hs, size_t init_size, size_t entry_size,
+				zbx_hash_func_t hash_func,
+				zbx_compare_func_t compare_func,
+				zbx_clean_func_t clean_func,
+				zbx_mem_malloc_func_t mem_malloc_func,
+				zbx_mem_realloc_func_t mem_realloc_func,
+				zbx_mem_free_func_t mem_free_func)
+{
+	hs->hash_func = hash_func;
+	hs->compare_func = compare_func;
+	hs->clean_func = clean_func;
+	hs->mem_malloc_func = mem_malloc_func;
+	hs->mem_realloc_func = mem_realloc_func;
+	hs->mem_free_func = mem_free_func;
+
+	/* keep entry data aligned for 64-bit fields */
+	hs->entry_size = entry_size;
+	hs->slot_size = sizeof(zbx_oahashset_slot_t) + ((entry_size + 7) & ~(size_t)7);
+
+	hs->num_data = 0;
+	hs->num_slots = 0;
+	hs->num_overflow = 0;
+	hs->slots = NULL;
+
+	if (0 < init_size)
+		(void)oahashset_alloc_slots(hs, oahashset_slots_by_size(init_size), OAHASHSET_OVERFLOW_SLOTS);
+}
+
+void	zbx_oahashset_destroy(zbx_oahashset_t *hs)
+{
+	zbx_oahashset_clear(hs);
+
+	hs->num_slots = 0;
+	hs->num_overflow = 0;
+
+	if (NULL != hs->slots)
+	{
+		hs->mem_free_func(hs->slots);
+		hs->slots = NULL;
+	}
+
+	hs->hash_func = NULL;
+	hs->compare_func = NULL;
+	hs->mem_malloc_func = NULL;
+	hs->mem_realloc_func = NULL;
+	hs->mem_free_func = NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates enough slots to store the required number of entries    *
+ *          without growing the hashset                                       *
+ *                                                                            *
+ * Parameters: hs            - [IN] destination hashset                       *
+ *             num_slots_req - [IN] number of required slots                  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_oahashset_reserve(zbx_oahashset_t *hs, int num_slots_req)
+{
+	int	num_slots;
+
+	if (0 == hs->num_slots)
+	{
+		return oahashset_alloc_slots(hs, oahashset_slots_by_size((size_t)num_slots_req),
+				OAHASHSET_OVERFLOW_SLOTS);
+	}
+
+	if ((num_slots = oahashset_slots_by_size((size_t)num_slots_req)) > hs->num_slots)
+		return oahashset_grow(hs, num_slots, hs->num_overflow, NULL, NULL);
+
+	return SUCCEED;
+}
+
+void	*zbx_oahashset_insert(zbx_oahashset_t *hs, const void *data, size_t size)
+{
+	return zbx_oahashset_insert_ext(hs, data, size, 0);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: inserts entry into hashset                                        *
+ *                                                                            *
+ * Parameters: hs     - [IN] the hashset                                      *
+ *             data   - [IN] the entry data                                   *
+ *             size   - [IN] the entry data size, must not exceed the entry   *
+ *                           size the hashset was created with                *
+ *             offset - [IN] the offset of entry data to copy                 *
+ *                                                                            *
+ * Return value: pointer to the new or existing entry or NULL if there is not *
+ *               enough memory                                                *
+ *                                                                            *
+ ******************************************************************************/
+void	*zbx_oahashset_insert_ext(zbx_oahashset_t *hs, const void *data, size_t size, size_t offset)
+{
+	int		i;
+	zbx_hash_t	hash;
+	void		*entry;
+
+	if (size > hs->entry_size)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return NULL;
+	}
+
+	if (0 == hs->num_slots &&
+			SUCCEED != oahashset_alloc_slots(hs, OAHASHSET_DEFAULT_SLOTS, OAHASHSET_OVERFLOW_SLOTS))
+	{
+		return NULL;
+	}
+
+	hash = hs->hash_func(data);
+
+	if (-1 != (i = oahashset_find(hs, data, hash)))
+		return OAHASHSET_ENTRY(OAHASHSET_SLOT(hs, i));
+
+	if ((size_t)hs->num_slots * CRIT_LOAD_FACTOR <= (size_t)hs->num_data)
+	{
+		if (SUCCEED != oahashset_grow(hs, hs->num_slots * 2, hs->num_overflow, &hash, &i))
+			return NULL;
+	}
+	else if (-1 == (i = oahashset_place(hs, hash)))
+	{
+		int	ret;
+
+		/* once overflow slots were enlarged the probe sequences are long because of colliding */
+		/* hashes and not because of the load factor, doubling home slots would not help        */
+		if (OAHASHSET_OVERFLOW_SLOTS == hs->num_overflow)
+			ret = oahashset_grow(hs, hs->num_slots * 2, hs->num_overflow, &hash, &i);
+		else
+			ret = oahashset_grow(hs, hs->num_slots, hs->num_overflow * 2, &hash, &i);
+
+		if (SUCCEED != ret)
+			return NULL;
+	}
+
+	entry = OAHASHSET_ENTRY(OAHASHSET_SLOT(hs, i));
+	memcpy((char *)entry + offset, (const char *)data + offset, size - offset);
+	hs->num_data++;
+
+	return entry;
+}
+
+void	*zbx_oahashset_search(const zbx_oahashset_t *hs, const void *data)
+{
+	int	i;
+
+	if (0 == hs->num_slots)
+		return NULL;
+
+	if (-1 == (i = oahashset_find(hs, data, hs->hash_func(data))))
+		return NULL;
+
+	return OAHASHSET_ENTRY(OAHASHSET_SLOT(hs, i));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove a hashset entry using comparison with the given data       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_oahashset_remove(zbx_oahashset_t *hs, const void *data)
+{
+	int	i;
+
+	if (0 == hs->num_slots)
+		return;
+
+	if (-1 != (i = oahashset_find(hs, data, hs->hash_func(data))))
+		oahashset_remove_slot(hs, i);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove a hashset entry using a data pointer returned to the user  *
+ *          by zbx_oahashset_insert[_ext]() and zbx_oahashset_search()        *
+ *          functions                                                         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_oahashset_remove_direct(zbx_oahashset_t *hs, void *data)
+{
+	size_t	offset;
+	int	i;
+
+	if (0 == hs->num_slots || (unsigned char *)data < hs->slots + sizeof(zbx_oahashset_slot_t))
+		return;
+
+	offset = (size_t)((unsigned char *)data - hs->slots) - sizeof(zbx_oahashset_slot_t);
+
+	if (0 != offset % hs->slot_size || OAHASHSET_SLOTS_TOTAL(hs) <= (i = (int)(offset / hs->slot_size)))
+		return;
+
+	if (0 != OAHASHSET_SLOT(hs, i)->dist)
+		oahashset_remove_slot(hs, i);
+}
+
+void	zbx_oahashset_clear(zbx_oahashset_t *hs)
+{
+	int	i, slots_total;
+
+	if (0 == hs->num_slots)
+		return;
+
+	slots_total = OAHASHSET_SLOTS_TOTAL(hs);
+
+	if (NULL != hs->clean_func)
+	{
+		for (i = 0; i < slots_total; i++)
+		{
+			zbx_oahashset_slot_t	*slot = OAHASHSET_SLOT(hs, i);
+
+			if (0 != slot->dist)
+				hs->clean_func(OAHASHSET_ENTRY(slot));
+		}
+	}
+
+	memset(hs->slots, 0, (size_t)slots_total * hs->slot_size);
+	hs->num_data = 0;
+}
+
+#define	ITER_START	(-1)
+#define	ITER_FINISH	(-2)
+
+void	zbx_oahashset_iter_reset(zbx_oahashset_t *hs, zbx_oahashset_iter_t *iter)
+{
+	iter->hashset = hs;
+	iter->slot = ITER_START;
+}
+
+void	*zbx_oahashset_iter_next(zbx_oahashset_iter_t *iter)
+{
+	int	slots_total;
+
+	if (ITER_FINISH == iter->slot || 0 == iter->hashset->num_slots)
+		return NULL;
+
+	slots_total = OAHASHSET_SLOTS_TOTAL(iter->hashset);
+
+	while (++iter->slot < slots_total)
+	{
+		zbx_oahashset_slot_t	*slot = OAHASHSET_SLOT(iter->hashset, iter->slot);
+
+		if (0 != slot->dist)
+			return OAHASHSET_ENTRY(slot);
+	}
+
+	iter->slot = ITER_FINISH;
+
+	return NULL;
+}
+
+void	zbx_oahashset_iter_remove(zbx_oahashset_iter_t *iter)
+{
+	if (ITER_START == iter->slot || ITER_FINISH == iter->slot ||
+			0 == OAHASHSET_SLOT(iter->hashset, iter->slot)->dist)
+	{
+		zabbix_log(LOG_LEVEL_CRIT, "removing a hashset entry through a bad iterator");
+		exit(EXIT_FAILURE);
+	}
+
+	oahashset_remove_slot(iter->hashset, iter->slot);
+
+	/* the next entry might have been shifted into the current slot */
+	iter->slot--;
+}
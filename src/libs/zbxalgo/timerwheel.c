@@ -0,0 +1,254 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxalgo.h"
+
+/******************************************************************************
+ *                                                                            *
+ * The root wheel has a slot for each of the next ZBX_TIMER_WHEEL_ROOT_SIZE   *
+ * seconds. Every higher level slot covers the whole range of the level       *
+ * below it, so a node is placed in the lowest level that can hold its        *
+ * expiry time. When the root wheel wraps around, the next slot of the first  *
+ * level is cascaded - its nodes are placed again, now into the root wheel.   *
+ * The same is done with higher levels when the lower level wraps around.     *
+ *                                                                            *
+ * Slot lists are singly linked lists with back references to the previous    *
+ * link, so nodes can be removed without knowing their slot while slot list   *
+ * heads take only a pointer each.                                            *
+ *                                                                            *
+ ******************************************************************************/
+
+#define TIMER_WHEEL_ROOT_MASK	(ZBX_TIMER_WHEEL_ROOT_SIZE - 1)
+#define TIMER_WHEEL_LEVEL_MASK	(ZBX_TIMER_WHEEL_LEVEL_SIZE - 1)
+
+#define TIMER_WHEEL_LEVEL_SHIFT(level)	(ZBX_TIMER_WHEEL_ROOT_BITS + (level) * ZBX_TIMER_WHEEL_LEVEL_BITS)
+
+/* the maximum time range covered by the wheel, later expiry times are placed in the last slot */
+#define TIMER_WHEEL_RANGE	(1 << TIMER_WHEEL_LEVEL_SHIFT(ZBX_TIMER_WHEEL_LEVELS))
+
+static void	timer_wheel_list_push(zbx_timer_wheel_node_t **head, zbx_timer_wheel_node_t *node)
+{
+	if (NULL != (node->next = *head))
+		node->next->pprev = &node->next;
+
+	node->pprev = head;
+	*head = node;
+}
+
+static void	timer_wheel_list_unlink(zbx_timer_wheel_node_t *node)
+{
+	if (NULL != (*node->pprev = node->next))
+		node->next->pprev = node->pprev;
+
+	node->next = NULL;
+	node->pprev = NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get slot list head for the specified expiry time                  *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_timer_wheel_node_t	**timer_wheel_slot(zbx_timer_wheel_t *wheel, int expires)
+{
+	int	delta, level;
+
+	if (0 > (delta = expires - wheel->time))
+		return &wheel->root[wheel->time & TIMER_WHEEL_ROOT_MASK];
+
+	if (ZBX_TIMER_WHEEL_ROOT_SIZE > delta)
+		return &wheel->root[expires & TIMER_WHEEL_ROOT_MASK];
+
+	if (TIMER_WHEEL_RANGE <= delta)
+		expires = wheel->time + TIMER_WHEEL_RANGE - 1;
+
+	for (level = 0; level < ZBX_TIMER_WHEEL_LEVELS - 1; level++)
+	{
+		if ((1 << TIMER_WHEEL_LEVEL_SHIFT(level + 1)) > delta)
+			break;
+	}
+
+	return &wheel->levels[level][(expires >> TIMER_WHEEL_LEVEL_SHIFT(level)) & TIMER_WHEEL_LEVEL_MASK];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: place all nodes of the specified higher level slot again          *
+ *                                                                            *
+ ******************************************************************************/
+static void	timer_wheel_cascade(zbx_timer_wheel_t *wheel, int level)
+{
+	zbx_timer_wheel_node_t	**head, *node;
+	int			index;
+
+	index = (wheel->time >> TIMER_WHEEL_LEVEL_SHIFT(level)) & TIMER_WHEEL_LEVEL_MASK;
+	head = &wheel->levels[level][index];
+
+	/* detach the slot list first, as nodes can be placed back in the same slot */
+	node = *head;
+	*head = NULL;
+
+	while (NULL != node)
+	{
+		zbx_timer_wheel_node_t	*next = node->next;
+
+		timer_wheel_list_push(timer_wheel_slot(wheel, node->expires), node);
+		node = next;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize timer wheel                                            *
+ *                                                                            *
+ * Parameters: wheel - [IN] the timer wheel                                   *
+ *             time  - [IN] the initial wheel time                            *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_timer_wheel_create(zbx_timer_wheel_t *wheel, int time)
+{
+	memset(wheel->root, 0, sizeof(wheel->root));
+	memset(wheel->levels, 0, sizeof(wheel->levels));
+
+	wheel->time = time;
+	wheel->nodes_num = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: schedule node                                                     *
+ *                                                                            *
+ * Parameters: wheel   - [IN] the timer wheel                                 *
+ *             node    - [IN] the node to schedule, must not be scheduled     *
+ *             expires - [IN] the node expiry time                            *
+ *                                                                            *
+ * Comments: Nodes with expiry time before the current wheel time are         *
+ *           expired with the nodes of the current second.                    *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_timer_wheel_insert(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node, int expires)
+{
+	node->expires = expires;
+	timer_wheel_list_push(timer_wheel_slot(wheel, expires), node);
+	wheel->nodes_num++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove scheduled node                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_timer_wheel_remove(zbx_timer_wheel_t *wheel, zbx_timer_wheel_node_t *node)
+{
+	timer_wheel_list_unlink(node);
+	wheel->nodes_num--;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if node is scheduled in a timer wheel                       *
+ *                                                                            *
+ * Comments: The node must be zero initialized before its first use.          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_timer_wheel_scheduled(const zbx_timer_wheel_node_t *node)
+{
+	return NULL != node->pprev ? SUCCEED : FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove and return the next node expiring at or before the         *
+ *          specified time                                                    *
+ *                                                                            *
+ * Parameters: wheel - [IN] the timer wheel                                   *
+ *             now   - [IN] the current time                                  *
+ *                                                                            *
+ * Return value: the expired node or NULL if there are no expired nodes       *
+ *                                                                            *
+ * Comments: The wheel time is advanced up to the specified time, so nodes    *
+ *           inserted later with expiry time before it will be expired        *
+ *           by the next call.                                                *
+ *                                                                            *
+ ******************************************************************************/
+zbx_timer_wheel_node_t	*zbx_timer_wheel_expire(zbx_timer_wheel_t *wheel, int now)
+{
+	zbx_timer_wheel_node_t	*node;
+	int			level;
+
+	if (0 == wheel->nodes_num)
+	{
+		if (wheel->time < now)
+			wheel->time = now;
+
+		return NULL;
+	}
+
+	if (wheel->time > now)
+		return NULL;
+
+	for (;;)
+	{
+		if (NULL != (node = wheel->root[wheel->time & TIMER_WHEEL_ROOT_MASK]))
+		{
+			zbx_timer_wheel_remove(wheel, node);
+
+			return node;
+		}
+
+		if (wheel->time >= now)
+			return NULL;
+
+		wheel->time++;
+
+		/* cascade higher level slots when the lower level wraps around */
+		for (level = 0; level < ZBX_TIMER_WHEEL_LEVELS; level++)
+		{
+			if (0 != (wheel->time & ((1 << TIMER_WHEEL_LEVEL_SHIFT(level)) - 1)))
+				break;
+
+			timer_wheel_cascade(wheel, level);
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the earliest time when a node might expire                    *
+ *                                                                            *
+ * Return value: the expiry time of the earliest node in root wheel or the    *
+ *               time of the next cascade if root wheel is empty,             *
+ *               FAIL if the wheel is empty                                   *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_timer_wheel_next(const zbx_timer_wheel_t *wheel)
+{
+	int	i;
+
+	if (0 == wheel->nodes_num)
+		return FAIL;
+
+	for (i = 0; i < ZBX_TIMER_WHEEL_ROOT_SIZE; i++)
+	{
+		if (NULL != wheel->root[(wheel->time + i) & TIMER_WHEEL_ROOT_MASK])
+			return wheel->time + i;
+	}
+
+	return (wheel->time | TIMER_WHEEL_ROOT_MASK) + 1;
+}
@@ -120,6 +120,18 @@ zbx_rwlock_t		config_lock = ZBX_RWLOCK_NULL;
 zbx_rwlock_t		config_history_lock = ZBX_RWLOCK_NULL;
 zbx_shmem_info_t	*config_mem;
 
+#if ZBX_MUTEX_POLLER_QUEUE_NUM != ZBX_POLLER_TYPE_COUNT
+#	error "ZBX_MUTEX_POLLER_QUEUE_NUM must match ZBX_POLLER_TYPE_COUNT"
+#endif
+
+/* Poller queues are additionally protected by per poller type mutexes, so pollers can move */
+/* scheduled items to the queue heap and check for due items without configuration cache    */
+/* write lock. When both locks are needed the configuration cache lock must be taken first. */
+static zbx_mutex_t	poller_queue_locks[ZBX_POLLER_TYPE_COUNT];
+
+#define	LOCK_POLLER_QUEUE(poller_type)		zbx_mutex_lock(poller_queue_locks[poller_type])
+#define	UNLOCK_POLLER_QUEUE(poller_type)	zbx_mutex_unlock(poller_queue_locks[poller_type])
+
 ZBX_SHMEM_FUNC_IMPL(__config, config_mem)
 
 static void	dc_maintenance_precache_nested_groups(void);
@@ -776,6 +788,127 @@ int	dc_strpool_replace(int found, const char **curr, const char *new_str)
 	return SUCCEED;	/* indicate that the string has been replaced */
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add item to its poller queue                                      *
+ *                                                                            *
+ * Comments: Only items that are due are kept in the poller queue heap. Items *
+ *           scheduled for later are kept in the poller queue timer wheel     *
+ *           until pollers move them to the heap, so requeuing items does     *
+ *           not depend on the total number of queued items.                  *
+ *           The poller queue lock must be held by the caller.                *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_queue_insert(ZBX_DC_ITEM *item)
+{
+	zbx_timer_wheel_t	*wheel = &config->queue_wheels[item->poller_type];
+	zbx_binary_heap_elem_t	elem;
+
+	if (item->nextcheck > wheel->time)
+	{
+		zbx_timer_wheel_insert(wheel, &item->queue_node, item->nextcheck);
+		return;
+	}
+
+	elem.key = item->itemid;
+	elem.data = (void *)item;
+
+	zbx_binary_heap_insert(&config->queues[item->poller_type], &elem);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove item from the specified poller queue                       *
+ *                                                                            *
+ * Comments: The poller queue lock must be held by the caller.                *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_item_queue_remove(ZBX_DC_ITEM *item, unsigned char poller_type)
+{
+	if (SUCCEED == zbx_timer_wheel_scheduled(&item->queue_node))
+		zbx_timer_wheel_remove(&config->queue_wheels[poller_type], &item->queue_node);
+	else
+		zbx_binary_heap_remove_direct(&config->queues[poller_type], item->itemid);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the first item in poller queue heap                           *
+ *                                                                            *
+ * Return value: the first item or NULL if the heap is empty                  *
+ *                                                                            *
+ * Comments: Pollers move items to the heap without configuration cache       *
+ *           write lock, so the returned item must be removed from the heap   *
+ *           with dc_item_queue_pop() rather than by removing heap minimum.   *
+ *                                                                            *
+ ******************************************************************************/
+static ZBX_DC_ITEM	*dc_item_queue_peek(unsigned char poller_type)
+{
+	ZBX_DC_ITEM	*dc_item = NULL;
+
+	LOCK_POLLER_QUEUE(poller_type);
+
+	if (FAIL == zbx_binary_heap_empty(&config->queues[poller_type]))
+		dc_item = (ZBX_DC_ITEM *)zbx_binary_heap_find_min(&config->queues[poller_type])->data;
+
+	UNLOCK_POLLER_QUEUE(poller_type);
+
+	return dc_item;
+}
+
+static void	dc_item_queue_pop(ZBX_DC_ITEM *dc_item, unsigned char poller_type)
+{
+	LOCK_POLLER_QUEUE(poller_type);
+	zbx_binary_heap_remove_direct(&config->queues[poller_type], dc_item->itemid);
+	UNLOCK_POLLER_QUEUE(poller_type);
+
+	dc_item->location = ZBX_LOC_NOWHERE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: move items that became due to poller queue heap and check if      *
+ *          there are items to poll                                           *
+ *                                                                            *
+ * Return value: SUCCEED - there are due items in the heap                    *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: This function is called without configuration cache lock, so     *
+ *           the item nextcheck can be updated concurrently. Pollers recheck  *
+ *           nextcheck under configuration cache lock before taking items.    *
+ *                                                                            *
+ ******************************************************************************/
+static int	dc_item_queue_prepare(unsigned char poller_type, int now)
+{
+	int				ret = FAIL;
+	zbx_binary_heap_t		*queue = &config->queues[poller_type];
+	zbx_timer_wheel_node_t		*node;
+	zbx_binary_heap_elem_t		elem;
+	const zbx_binary_heap_elem_t	*min;
+
+	LOCK_POLLER_QUEUE(poller_type);
+
+	while (NULL != (node = zbx_timer_wheel_expire(&config->queue_wheels[poller_type], now)))
+	{
+		elem.data = (void *)((char *)node - offsetof(ZBX_DC_ITEM, queue_node));
+		elem.key = ((ZBX_DC_ITEM *)elem.data)->itemid;
+
+		zbx_binary_heap_insert(queue, &elem);
+	}
+
+	if (FAIL == zbx_binary_heap_empty(queue))
+	{
+		min = zbx_binary_heap_find_min(queue);
+
+		if (((const ZBX_DC_ITEM *)min->data)->nextcheck <= now)
+			ret = SUCCEED;
+	}
+
+	UNLOCK_POLLER_QUEUE(poller_type);
+
+	return ret;
+}
+
 static void	DCupdate_item_queue(ZBX_DC_ITEM *item, unsigned char old_poller_type, int old_nextcheck)
 {
 	zbx_binary_heap_elem_t	elem;
@@ -786,7 +919,10 @@ static void	DCupdate_item_queue(ZBX_DC_ITEM *item, unsigned char old_poller_type
 	if (ZBX_LOC_QUEUE == item->location && old_poller_type != item->poller_type)
 	{
 		item->location = ZBX_LOC_NOWHERE;
-		zbx_binary_heap_remove_direct(&config->queues[old_poller_type], item->itemid);
+
+		LOCK_POLLER_QUEUE(old_poller_type);
+		dc_item_queue_remove(item, old_poller_type);
+		UNLOCK_POLLER_QUEUE(old_poller_type);
 	}
 
 	if (item->poller_type == ZBX_NO_POLLER)
@@ -795,16 +931,49 @@ static void	DCupdate_item_queue(ZBX_DC_ITEM *item, unsigned char old_poller_type
 	if (ZBX_LOC_QUEUE == item->location && old_nextcheck == item->nextcheck)
 		return;
 
-	elem.key = item->itemid;
-	elem.data = (void *)item;
+	LOCK_POLLER_QUEUE(item->poller_type);
 
 	if (ZBX_LOC_QUEUE != item->location)
 	{
 		item->location = ZBX_LOC_QUEUE;
-		zbx_binary_heap_insert(&config->queues[item->poller_type], &elem);
+		dc_item_queue_insert(item);
 	}
-	else
+	else if (SUCCEED != zbx_timer_wheel_scheduled(&item->queue_node) &&
+			item->nextcheck <= config->queue_wheels[item->poller_type].time)
+	{
+		/* update heap position only if the item is still due, otherwise place it again */
+		elem.key = item->itemid;
+		elem.data = (void *)item;
+
 		zbx_binary_heap_update_direct(&config->queues[item->poller_type], &elem);
+	}
+	else
+	{
+		dc_item_queue_remove(item, item->poller_type);
+		dc_item_queue_insert(item);
+	}
+
+	UNLOCK_POLLER_QUEUE(item->poller_type);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: update poller scheduling latency histogram                        *
+ *                                                                            *
+ * Parameters: poller_type - [IN] the poller type                             *
+ *             latency     - [IN] the delay between item nextcheck and the    *
+ *                                time it was taken by poller                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	dc_poller_latency_update(unsigned char poller_type, int latency)
+{
+	static const int	bounds[ZBX_POLLER_LATENCY_BUCKETS - 1] = {1, 5, 10, 30, 60};
+	int			i;
+
+	for (i = 0; i < ZBX_POLLER_LATENCY_BUCKETS - 1 && latency >= bounds[i]; i++)
+		;
+
+	config->poller_latency[poller_type][i]++;
 }
 
 static void	DCupdate_proxy_queue(ZBX_DC_PROXY *proxy)
@@ -2940,6 +3109,7 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 			item->poller_type = ZBX_NO_POLLER;
 			item->queue_priority = ZBX_QUEUE_PRIORITY_NORMAL;
 			item->delay_ex = NULL;
+			memset(&item->queue_node, 0, sizeof(item->queue_node));
 
 			if (ZBX_SYNCED_NEW_CONFIG_YES == synced && 0 == host->proxyid)
 				flags |= ZBX_ITEM_NEW;
@@ -3652,7 +3822,11 @@ static void	DCsync_items(zbx_dbsync_t *sync, zbx_uint64_t revision, int flags, z
 		}
 
 		if (ZBX_LOC_QUEUE == item->location)
-			zbx_binary_heap_remove_direct(&config->queues[item->poller_type], item->itemid);
+		{
+			LOCK_POLLER_QUEUE(item->poller_type);
+			dc_item_queue_remove(item, item->poller_type);
+			UNLOCK_POLLER_QUEUE(item->poller_type);
+		}
 
 		dc_strpool_release(item->key);
 		dc_strpool_release(item->error);
@@ -4444,6 +4618,7 @@ static void	DCsync_functions(zbx_dbsync_t *sync, zbx_uint64_t revision)
 		dc_strpool_replace(found, &function->parameter, row[3]);
 
 		function->type = zbx_get_function_type(function->function);
+		function->macros = (NULL != strstr(function->parameter, "{$") ? 1 : 0);
 		function->revision = revision;
 
 		dc_item_reset_triggers(item, NULL);
@@ -8101,8 +8276,9 @@ zbx_uint64_t	zbx_dc_sync_configuration(unsigned char mode, zbx_synced_new_config
 
 		for (i = 0; ZBX_POLLER_TYPE_COUNT > i; i++)
 		{
-			zabbix_log(LOG_LEVEL_DEBUG, "%s() queue[%d]   : %d (%d allocated)", __func__,
-					i, config->queues[i].elems_num, config->queues[i].elems_alloc);
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() queue[%d]   : %d (%d allocated), %d scheduled", __func__,
+					i, config->queues[i].elems_num, config->queues[i].elems_alloc,
+					config->queue_wheels[i].nodes_num);
 		}
 
 		zabbix_log(LOG_LEVEL_DEBUG, "%s() pqueue     : %d (%d allocated)", __func__,
@@ -8592,12 +8768,20 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 	if (SUCCEED != (ret = zbx_rwlock_create(&config_history_lock, ZBX_RWLOCK_CONFIG_HISTORY, error)))
 		goto out;
 
+	for (i = 0; i < ZBX_POLLER_TYPE_COUNT; i++)
+	{
+		if (SUCCEED != (ret = zbx_mutex_create(&poller_queue_locks[i], ZBX_MUTEX_POLLER_QUEUE + i, error)))
+			goto out;
+	}
+
 	if (SUCCEED != (ret = zbx_shmem_create(&config_mem, conf_cache_size, "configuration cache",
 			"CacheSize", 0, error)))
 	{
 		goto out;
 	}
 
+	zbx_shmem_enable_slabs(config_mem);
+
 	config = (ZBX_DC_CONFIG *)__config_shmem_malloc_func(NULL, sizeof(ZBX_DC_CONFIG) +
 			(size_t)get_config_forks_cb(ZBX_PROCESS_TYPE_TIMER) * sizeof(zbx_vector_ptr_t));
 
@@ -8719,8 +8903,15 @@ int	zbx_init_configuration_cache(zbx_get_program_type_f get_program_type, zbx_ge
 						__config_shmem_free_func);
 				break;
 		}
+
+		zbx_timer_wheel_create(&config->queue_wheels[i], (int)time(NULL));
 	}
 
+	memset(config->poller_latency, 0, sizeof(config->poller_latency));
+	memset(&config->agent_conn_stats, 0, sizeof(config->agent_conn_stats));
+	memset(&config->func_cache_stats, 0, sizeof(config->func_cache_stats));
+	memset(config->compress_stats, 0, sizeof(config->compress_stats));
+
 	zbx_binary_heap_create_ext(&config->pqueue,
 					__config_proxy_compare,
 					ZBX_BINARY_HEAP_OPTION_DIRECT,
@@ -8815,6 +9006,8 @@ out:
  ******************************************************************************/
 void	zbx_free_configuration_cache(void)
 {
+	int	i;
+
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	WRLOCK_CACHE;
@@ -8827,6 +9020,9 @@ void	zbx_free_configuration_cache(void)
 
 	zbx_shmem_destroy(config_mem);
 	config_mem = NULL;
+	for (i = 0; i < ZBX_POLLER_TYPE_COUNT; i++)
+		zbx_mutex_destroy(&poller_queue_locks[i]);
+
 	zbx_rwlock_destroy(&config_history_lock);
 	zbx_rwlock_destroy(&config_lock);
 
@@ -9669,6 +9865,19 @@ void	DCget_function(zbx_dc_function_t *dst_function, const ZBX_DC_FUNCTION *src_
 	dst_function->triggerid = src_function->triggerid;
 	dst_function->itemid = src_function->itemid;
 	dst_function->type = src_function->type;
+	dst_function->revision = src_function->revision;
+
+	/* parameters with user macros must be expanded again when any of host or global macros change */
+	if (0 != src_function->macros)
+	{
+		const ZBX_DC_ITEM	*dc_item;
+
+		um_cache_get_macro_revision(config->um_cache, ZBX_UM_CACHE_GLOBAL_MACRO_HOSTID,
+				&dst_function->revision);
+
+		if (NULL != (dc_item = (const ZBX_DC_ITEM *)zbx_hashset_search(&config->items, &src_function->itemid)))
+			um_cache_get_macro_revision(config->um_cache, dc_item->hostid, &dst_function->revision);
+	}
 
 	sz_function = strlen(src_function->function) + 1;
 	sz_parameter = strlen(src_function->parameter) + 1;
@@ -11039,16 +11248,22 @@ unlock:
  *                                                                            *
  * Purpose: Get nextcheck for selected queue                                  *
  *                                                                            *
- * Parameters: queue - [IN]                                                   *
+ * Parameters: poller_type - [IN] poller type (ZBX_POLLER_TYPE_...)           *
  *                                                                            *
  * Return value: nextcheck or FAIL if no items for the specified queue        *
  *                                                                            *
+ * Comments: Items in the queue timer wheel are scheduled after the items in  *
+ *           the heap, so the wheel is checked only when the heap is empty.   *
+ *                                                                            *
  ******************************************************************************/
-static int	dc_config_get_queue_nextcheck(zbx_binary_heap_t *queue)
+static int	dc_config_get_queue_nextcheck(unsigned char poller_type)
 {
 	int				nextcheck;
 	const zbx_binary_heap_elem_t	*min;
 	const ZBX_DC_ITEM		*dc_item;
+	zbx_binary_heap_t		*queue = &config->queues[poller_type];
+
+	LOCK_POLLER_QUEUE(poller_type);
 
 	if (FAIL == zbx_binary_heap_empty(queue))
 	{
@@ -11058,7 +11273,9 @@ static int	dc_config_get_queue_nextcheck(zbx_binary_heap_t *queue)
 		nextcheck = dc_item->nextcheck;
 	}
 	else
-		nextcheck = FAIL;
+		nextcheck = zbx_timer_wheel_next(&config->queue_wheels[poller_type]);
+
+	UNLOCK_POLLER_QUEUE(poller_type);
 
 	return nextcheck;
 }
@@ -11074,16 +11291,13 @@ static int	dc_config_get_queue_nextcheck(zbx_binary_heap_t *queue)
  ******************************************************************************/
 int	zbx_dc_config_get_poller_nextcheck(unsigned char poller_type)
 {
-	int			nextcheck;
-	zbx_binary_heap_t	*queue;
+	int	nextcheck;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() poller_type:%d", __func__, (int)poller_type);
 
-	queue = &config->queues[poller_type];
-
 	RDLOCK_CACHE;
 
-	nextcheck = dc_config_get_queue_nextcheck(queue);
+	nextcheck = dc_config_get_queue_nextcheck(poller_type);
 
 	UNLOCK_CACHE;
 
@@ -11159,15 +11373,13 @@ static void	dc_requeue_item_at(ZBX_DC_ITEM *dc_item, ZBX_DC_HOST *dc_host, time_
 int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout, int processing,
 		int config_max_concurrent_checks, zbx_dc_item_t **items)
 {
-	int			now, num = 0, max_items, items_alloc = 0;
-	zbx_binary_heap_t	*queue;
+	int		now, num = 0, max_items, items_alloc = 0;
+	ZBX_DC_ITEM	*dc_item;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() poller_type:%d", __func__, (int)poller_type);
 
 	now = time(NULL);
 
-	queue = &config->queues[poller_type];
-
 	switch (poller_type)
 	{
 		case ZBX_POLLER_TYPE_JAVA:
@@ -11189,20 +11401,19 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 			max_items = 1;
 	}
 
+	/* avoid configuration cache write lock when there are no due items */
+	if (SUCCEED != dc_item_queue_prepare(poller_type, now))
+		goto out;
+
 	WRLOCK_CACHE;
 
-	while (num < max_items && FAIL == zbx_binary_heap_empty(queue))
+	while (num < max_items && NULL != (dc_item = dc_item_queue_peek(poller_type)))
 	{
 		int				disable_until;
-		const zbx_binary_heap_elem_t	*min;
 		ZBX_DC_HOST			*dc_host;
 		ZBX_DC_INTERFACE		*dc_interface;
-		ZBX_DC_ITEM			*dc_item;
 		static const ZBX_DC_ITEM	*dc_item_prev = NULL;
 
-		min = zbx_binary_heap_find_min(queue);
-		dc_item = (ZBX_DC_ITEM *)min->data;
-
 		if (dc_item->nextcheck > now)
 			break;
 
@@ -11223,8 +11434,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 			}
 		}
 
-		zbx_binary_heap_remove_min(queue);
-		dc_item->location = ZBX_LOC_NOWHERE;
+		dc_item_queue_pop(dc_item, poller_type);
 
 		if (NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &dc_item->hostid)))
 			continue;
@@ -11295,6 +11505,7 @@ int	zbx_dc_config_get_poller_items(unsigned char poller_type, int config_timeout
 
 		dc_item_prev = dc_item;
 		dc_item->location = ZBX_LOC_POLLER;
+		dc_poller_latency_update(poller_type, now - dc_item->nextcheck);
 		DCget_host(&(*items)[num].host, dc_host);
 		DCget_item(&(*items)[num], dc_item);
 		num++;
@@ -11328,31 +11539,25 @@ out:
 int	zbx_dc_config_get_ipmi_poller_items(int now, int items_num, int config_timeout, zbx_dc_item_t *items,
 		int *nextcheck)
 {
-	int			num = 0;
-	zbx_binary_heap_t	*queue;
+	int		num = 0;
+	ZBX_DC_ITEM	*dc_item;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	queue = &config->queues[ZBX_POLLER_TYPE_IPMI];
-
 	WRLOCK_CACHE;
 
-	while (num < items_num && FAIL == zbx_binary_heap_empty(queue))
-	{
-		int				disable_until;
-		const zbx_binary_heap_elem_t	*min;
-		ZBX_DC_HOST			*dc_host;
-		ZBX_DC_INTERFACE		*dc_interface;
-		ZBX_DC_ITEM			*dc_item;
+	dc_item_queue_prepare(ZBX_POLLER_TYPE_IPMI, now);
 
-		min = zbx_binary_heap_find_min(queue);
-		dc_item = (ZBX_DC_ITEM *)min->data;
+	while (num < items_num && NULL != (dc_item = dc_item_queue_peek(ZBX_POLLER_TYPE_IPMI)))
+	{
+		int			disable_until;
+		ZBX_DC_HOST		*dc_host;
+		ZBX_DC_INTERFACE	*dc_interface;
 
 		if (dc_item->nextcheck > now)
 			break;
 
-		zbx_binary_heap_remove_min(queue);
-		dc_item->location = ZBX_LOC_NOWHERE;
+		dc_item_queue_pop(dc_item, ZBX_POLLER_TYPE_IPMI);
 
 		if (NULL == (dc_host = (ZBX_DC_HOST *)zbx_hashset_search(&config->hosts, &dc_item->hostid)))
 			continue;
@@ -11389,12 +11594,13 @@ int	zbx_dc_config_get_ipmi_poller_items(int now, int items_num, int config_timeo
 		}
 
 		dc_item->location = ZBX_LOC_POLLER;
+		dc_poller_latency_update(ZBX_POLLER_TYPE_IPMI, now - dc_item->nextcheck);
 		DCget_host(&items[num].host, dc_host);
 		DCget_item(&items[num], dc_item);
 		num++;
 	}
 
-	*nextcheck = dc_config_get_queue_nextcheck(&config->queues[ZBX_POLLER_TYPE_IPMI]);
+	*nextcheck = dc_config_get_queue_nextcheck(ZBX_POLLER_TYPE_IPMI);
 
 	UNLOCK_CACHE;
 
@@ -11583,7 +11789,7 @@ void	zbx_dc_poller_requeue_items(const zbx_uint64_t *itemids, const int *lastclo
 	WRLOCK_CACHE;
 
 	dc_requeue_items(itemids, lastclocks, errcodes, num);
-	*nextcheck = dc_config_get_queue_nextcheck(&config->queues[poller_type]);
+	*nextcheck = dc_config_get_queue_nextcheck(poller_type);
 
 	UNLOCK_CACHE;
 }
@@ -12473,6 +12679,142 @@ void	zbx_dc_free_item_queue(zbx_vector_ptr_t *queue)
 		zbx_free(queue->values[i]);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get poller queue sizes and scheduling latency statistics          *
+ *                                                                            *
+ * Parameters: stats - [OUT] the statistics, array of ZBX_POLLER_TYPE_COUNT   *
+ *                           elements indexed by poller type                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_poller_stats(zbx_dc_poller_stats_t *stats)
+{
+	int	i;
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < ZBX_POLLER_TYPE_COUNT; i++)
+	{
+		LOCK_POLLER_QUEUE(i);
+		stats[i].queued = config->queues[i].elems_num;
+		stats[i].scheduled = config->queue_wheels[i].nodes_num;
+		UNLOCK_POLLER_QUEUE(i);
+		memcpy(stats[i].latency, config->poller_latency[i], sizeof(stats[i].latency));
+	}
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add passive agent connection statistics collected by a poller     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_update_agent_conn_stats(const zbx_dc_agent_conn_stats_t *stats)
+{
+	WRLOCK_CACHE;
+
+	config->agent_conn_stats.opened += stats->opened;
+	config->agent_conn_stats.requests += stats->requests;
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get passive agent connection statistics                           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_agent_conn_stats(zbx_dc_agent_conn_stats_t *stats)
+{
+	RDLOCK_CACHE;
+
+	*stats = config->agent_conn_stats;
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add trigger function cache statistics collected by a history      *
+ *          syncer                                                            *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_update_func_cache_stats(const zbx_dc_func_cache_stats_t *stats)
+{
+	WRLOCK_CACHE;
+
+	config->func_cache_stats.hits += stats->hits;
+	config->func_cache_stats.misses += stats->misses;
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get trigger function cache statistics                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_func_cache_stats(zbx_dc_func_cache_stats_t *stats)
+{
+	RDLOCK_CACHE;
+
+	*stats = config->func_cache_stats;
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add protocol compression statistics collected by the calling      *
+ *          thread since the last flush                                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_flush_compress_stats(void)
+{
+	zbx_compress_stats_t	stats[ZBX_COMPRESS_CODEC_NUM];
+	int			i;
+
+	zbx_compress_get_stats(stats);
+
+	for (i = 0; i < ZBX_COMPRESS_CODEC_NUM; i++)
+	{
+		if (0 != stats[i].size)
+			break;
+	}
+
+	if (ZBX_COMPRESS_CODEC_NUM == i)
+		return;
+
+	WRLOCK_CACHE;
+
+	for (i = 0; i < ZBX_COMPRESS_CODEC_NUM; i++)
+	{
+		config->compress_stats[i].size += stats[i].size;
+		config->compress_stats[i].size_compressed += stats[i].size_compressed;
+		config->compress_stats[i].cpu_time += stats[i].cpu_time;
+	}
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get protocol compression statistics                               *
+ *                                                                            *
+ * Parameters: codec - [IN] the compression codec (ZBX_COMPRESS_*)            *
+ *             stats - [OUT] the compression statistics                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_dc_get_compress_stats(int codec, zbx_compress_stats_t *stats)
+{
+	RDLOCK_CACHE;
+
+	*stats = config->compress_stats[codec];
+
+	UNLOCK_CACHE;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieves vector of delayed items                                 *
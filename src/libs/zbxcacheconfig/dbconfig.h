@@ -102,6 +102,7 @@ typedef struct
 	zbx_uint64_t	revision;
 	zbx_uint64_t	timer_revision;
 	unsigned char	type;
+	unsigned char	macros;		/* 1 if parameters contain user macros, 0 otherwise */
 }
 ZBX_DC_FUNCTION;
 
@@ -152,6 +153,9 @@ typedef struct
 
 	zbx_vector_ptr_t	tags;
 	const char		*timeout;
+
+	/* poller queue timer wheel node, used while the item is in queue but not yet due */
+	zbx_timer_wheel_node_t	queue_node;
 }
 ZBX_DC_ITEM;
 
@@ -996,7 +1000,12 @@ typedef struct
 	zbx_hashset_t		connectors;
 	zbx_hashset_t		connector_tags;
 	zbx_hashset_t		sessions[ZBX_SESSION_TYPE_COUNT];
-	zbx_binary_heap_t	queues[ZBX_POLLER_TYPE_COUNT];
+	zbx_binary_heap_t	queues[ZBX_POLLER_TYPE_COUNT];	/* items due to be polled */
+	zbx_timer_wheel_t	queue_wheels[ZBX_POLLER_TYPE_COUNT];	/* items scheduled for later polling */
+	zbx_uint64_t		poller_latency[ZBX_POLLER_TYPE_COUNT][ZBX_POLLER_LATENCY_BUCKETS];
+	zbx_dc_agent_conn_stats_t	agent_conn_stats;
+	zbx_dc_func_cache_stats_t	func_cache_stats;
+	zbx_compress_stats_t	compress_stats[ZBX_COMPRESS_CODEC_NUM];
 	zbx_binary_heap_t	pqueue;
 	zbx_binary_heap_t	trigger_queue;
 	zbx_binary_heap_t	drule_queue;
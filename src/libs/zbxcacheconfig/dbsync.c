@@ -529,7 +529,7 @@ int	zbx_dbsync_env_prepare(unsigned char mode)
 
 static void	dbsync_env_flush_journal(zbx_dbsync_journal_t *journal)
 {
-	zbx_hashset_t	objectids;
+	zbx_oahashset_t	objectids;
 	int		i, j, objects_num;
 
 	if (0 == journal->changelog.values_num)
@@ -540,8 +540,8 @@ static void	dbsync_env_flush_journal(zbx_dbsync_journal_t *journal)
 	for (i = 0; i < journal->syncs.values_num; i++)
 		objects_num += journal->syncs.values[i]->rows.values_num;
 
-	zbx_hashset_create(&objectids, (size_t)objects_num, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&objectids, (size_t)objects_num, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	for (j = 0; j < journal->syncs.values_num; j++)
 	{
@@ -549,26 +549,26 @@ static void	dbsync_env_flush_journal(zbx_dbsync_journal_t *journal)
 		{
 			zbx_dbsync_row_t	*row = (zbx_dbsync_row_t *)journal->syncs.values[j]->rows.values[i];
 
-			zbx_hashset_insert(&objectids, &row->rowid, sizeof(row->rowid));
+			zbx_oahashset_insert(&objectids, &row->rowid, sizeof(row->rowid));
 		}
 	}
 
 	for (i = 0; i < journal->inserts.values_num; i++)
-		zbx_hashset_insert(&objectids, &journal->inserts.values[i], sizeof(journal->inserts.values[i]));
+		zbx_oahashset_insert(&objectids, &journal->inserts.values[i], sizeof(journal->inserts.values[i]));
 
 	for (i = 0; i < journal->updates.values_num; i++)
-		zbx_hashset_insert(&objectids, &journal->updates.values[i], sizeof(journal->updates.values[i]));
+		zbx_oahashset_insert(&objectids, &journal->updates.values[i], sizeof(journal->updates.values[i]));
 
 	for (i = 0; i < journal->changelog.values_num; i++)
 	{
-		if (NULL != zbx_hashset_search(&objectids, &journal->changelog.values[i].objectid))
+		if (NULL != zbx_oahashset_search(&objectids, &journal->changelog.values[i].objectid))
 		{
 			zbx_hashset_insert(&dbsync_env.changelog, &journal->changelog.values[i].changelog,
 					sizeof(zbx_dbsync_changelog_t));
 		}
 	}
 
-	zbx_hashset_destroy(&objectids);
+	zbx_oahashset_destroy(&objectids);
 }
 
 void	zbx_dbsync_env_flush_changelog(void)
@@ -1077,7 +1077,7 @@ int	zbx_dbsync_compare_host_inventory(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	ZBX_DC_HOST_INVENTORY	*hi;
@@ -1107,15 +1107,15 @@ int	zbx_dbsync_compare_host_inventory(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->host_inventories.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->host_inventories.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (hi = (ZBX_DC_HOST_INVENTORY *)zbx_hashset_search(&dbsync_env.cache->host_inventories,
 				&rowid)))
@@ -1133,11 +1133,11 @@ int	zbx_dbsync_compare_host_inventory(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->host_inventories, &iter);
 	while (NULL != (hi = (ZBX_DC_HOST_INVENTORY *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &hi->hostid))
+		if (NULL == zbx_oahashset_search(&ids, &hi->hostid))
 			dbsync_add_row(sync, hi->hostid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -1298,7 +1298,7 @@ int	zbx_dbsync_compare_global_macros(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid, *prowid = &rowid;
 	zbx_um_macro_t		**pmacro;
@@ -1318,15 +1318,15 @@ int	zbx_dbsync_compare_global_macros(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->gmacros.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->gmacros.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (pmacro = (zbx_um_macro_t **)zbx_hashset_search(&dbsync_env.cache->gmacros, &prowid)))
 			tag = ZBX_DBSYNC_ROW_ADD;
@@ -1340,11 +1340,11 @@ int	zbx_dbsync_compare_global_macros(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->gmacros, &iter);
 	while (NULL != (pmacro = (zbx_um_macro_t **)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &(*pmacro)->macroid))
+		if (NULL == zbx_oahashset_search(&ids, &(*pmacro)->macroid))
 			dbsync_add_row(sync, (*pmacro)->macroid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -1428,7 +1428,7 @@ int	zbx_dbsync_compare_host_macros(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid, *prowid = &rowid;
 	zbx_um_macro_t		**pmacro;
@@ -1450,15 +1450,15 @@ int	zbx_dbsync_compare_host_macros(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->hmacros.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->hmacros.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (pmacro = (zbx_um_macro_t **)zbx_hashset_search(&dbsync_env.cache->hmacros, &prowid)))
 			tag = ZBX_DBSYNC_ROW_ADD;
@@ -1472,11 +1472,11 @@ int	zbx_dbsync_compare_host_macros(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->hmacros, &iter);
 	while (NULL != (pmacro = (zbx_um_macro_t **)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &(*pmacro)->macroid))
+		if (NULL == zbx_oahashset_search(&ids, &(*pmacro)->macroid))
 			dbsync_add_row(sync, (*pmacro)->macroid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -1630,7 +1630,7 @@ int	zbx_dbsync_compare_interfaces(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	ZBX_DC_INTERFACE	*interface;
@@ -1654,8 +1654,8 @@ int	zbx_dbsync_compare_interfaces(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->interfaces.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->interfaces.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
@@ -1663,7 +1663,7 @@ int	zbx_dbsync_compare_interfaces(zbx_dbsync_t *sync)
 		char		**row;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		row = dbsync_preproc_row(sync, dbrow);
 
@@ -1679,11 +1679,11 @@ int	zbx_dbsync_compare_interfaces(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->interfaces, &iter);
 	while (NULL != (interface = (ZBX_DC_INTERFACE *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &interface->interfaceid))
+		if (NULL == zbx_oahashset_search(&ids, &interface->interfaceid))
 			dbsync_add_row(sync, interface->interfaceid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -1793,7 +1793,7 @@ int	zbx_dbsync_compare_item_discovery(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	ZBX_DC_ITEM_DISCOVERY	*item_discovery;
@@ -1810,15 +1810,15 @@ int	zbx_dbsync_compare_item_discovery(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->item_discovery.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->item_discovery.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		row = dbsync_preproc_row(sync, dbrow);
 
@@ -1837,11 +1837,11 @@ int	zbx_dbsync_compare_item_discovery(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->item_discovery, &iter);
 	while (NULL != (item_discovery = (ZBX_DC_ITEM_DISCOVERY *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &item_discovery->itemid))
+		if (NULL == zbx_oahashset_search(&ids, &item_discovery->itemid))
 			dbsync_add_row(sync, item_discovery->itemid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -1870,7 +1870,7 @@ int	zbx_dbsync_compare_template_items(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	ZBX_DC_TEMPLATE_ITEM	*item;
@@ -1891,15 +1891,15 @@ int	zbx_dbsync_compare_template_items(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->template_items.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->template_items.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		row = dbsync_preproc_row(sync, dbrow);
 
@@ -1918,11 +1918,11 @@ int	zbx_dbsync_compare_template_items(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->template_items, &iter);
 	while (NULL != (item = (ZBX_DC_TEMPLATE_ITEM *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &item->itemid))
+		if (NULL == zbx_oahashset_search(&ids, &item->itemid))
 			dbsync_add_row(sync, item->itemid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -2260,7 +2260,7 @@ int	zbx_dbsync_compare_expressions(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	ZBX_DC_EXPRESSION	*expression;
@@ -2281,15 +2281,15 @@ int	zbx_dbsync_compare_expressions(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->expressions.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->expressions.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[1]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (expression = (ZBX_DC_EXPRESSION *)zbx_hashset_search(&dbsync_env.cache->expressions,
 				&rowid)))
@@ -2306,11 +2306,11 @@ int	zbx_dbsync_compare_expressions(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->expressions, &iter);
 	while (NULL != (expression = (ZBX_DC_EXPRESSION *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &expression->expressionid))
+		if (NULL == zbx_oahashset_search(&ids, &expression->expressionid))
 			dbsync_add_row(sync, expression->expressionid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -2356,7 +2356,7 @@ int	zbx_dbsync_compare_actions(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	zbx_dc_action_t		*action;
@@ -2379,15 +2379,15 @@ int	zbx_dbsync_compare_actions(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->actions.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->actions.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (action = (zbx_dc_action_t *)zbx_hashset_search(&dbsync_env.cache->actions, &rowid)))
 			tag = ZBX_DBSYNC_ROW_ADD;
@@ -2401,11 +2401,11 @@ int	zbx_dbsync_compare_actions(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->actions, &iter);
 	while (NULL != (action = (zbx_dc_action_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &action->actionid))
+		if (NULL == zbx_oahashset_search(&ids, &action->actionid))
 			dbsync_add_row(sync, action->actionid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -2550,7 +2550,7 @@ int	zbx_dbsync_compare_action_conditions(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t				dbrow;
 	zbx_db_result_t			result;
-	zbx_hashset_t			ids;
+	zbx_oahashset_t			ids;
 	zbx_hashset_iter_t		iter;
 	zbx_uint64_t			rowid;
 	zbx_dc_action_condition_t	*condition;
@@ -2573,15 +2573,15 @@ int	zbx_dbsync_compare_action_conditions(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->action_conditions.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->action_conditions.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (condition = (zbx_dc_action_condition_t *)zbx_hashset_search(
 				&dbsync_env.cache->action_conditions, &rowid)))
@@ -2598,11 +2598,11 @@ int	zbx_dbsync_compare_action_conditions(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->action_conditions, &iter);
 	while (NULL != (condition = (zbx_dc_action_condition_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &condition->conditionid))
+		if (NULL == zbx_oahashset_search(&ids, &condition->conditionid))
 			dbsync_add_row(sync, condition->conditionid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -2752,7 +2752,7 @@ int	zbx_dbsync_compare_correlations(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	zbx_dc_correlation_t	*correlation;
@@ -2774,15 +2774,15 @@ int	zbx_dbsync_compare_correlations(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->correlations.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->correlations.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (correlation = (zbx_dc_correlation_t *)zbx_hashset_search(&dbsync_env.cache->correlations,
 				&rowid)))
@@ -2799,11 +2799,11 @@ int	zbx_dbsync_compare_correlations(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->correlations, &iter);
 	while (NULL != (correlation = (zbx_dc_correlation_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &correlation->correlationid))
+		if (NULL == zbx_oahashset_search(&ids, &correlation->correlationid))
 			dbsync_add_row(sync, correlation->correlationid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -2878,7 +2878,7 @@ int	zbx_dbsync_compare_corr_conditions(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	zbx_dc_corr_condition_t	*corr_condition;
@@ -2910,15 +2910,15 @@ int	zbx_dbsync_compare_corr_conditions(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->corr_conditions.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->corr_conditions.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (corr_condition = (zbx_dc_corr_condition_t *)zbx_hashset_search(
 				&dbsync_env.cache->corr_conditions, &rowid)))
@@ -2935,11 +2935,11 @@ int	zbx_dbsync_compare_corr_conditions(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->corr_conditions, &iter);
 	while (NULL != (corr_condition = (zbx_dc_corr_condition_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &corr_condition->corr_conditionid))
+		if (NULL == zbx_oahashset_search(&ids, &corr_condition->corr_conditionid))
 			dbsync_add_row(sync, corr_condition->corr_conditionid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -2983,7 +2983,7 @@ int	zbx_dbsync_compare_corr_operations(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	zbx_dc_corr_operation_t	*corr_operation;
@@ -3006,15 +3006,15 @@ int	zbx_dbsync_compare_corr_operations(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->corr_operations.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->corr_operations.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (corr_operation = (zbx_dc_corr_operation_t *)zbx_hashset_search(
 				&dbsync_env.cache->corr_operations, &rowid)))
@@ -3031,11 +3031,11 @@ int	zbx_dbsync_compare_corr_operations(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->corr_operations, &iter);
 	while (NULL != (corr_operation = (zbx_dc_corr_operation_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &corr_operation->corr_operationid))
+		if (NULL == zbx_oahashset_search(&ids, &corr_operation->corr_operationid))
 			dbsync_add_row(sync, corr_operation->corr_operationid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -3074,7 +3074,7 @@ int	zbx_dbsync_compare_host_groups(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	zbx_dc_hostgroup_t	*group;
@@ -3090,15 +3090,15 @@ int	zbx_dbsync_compare_host_groups(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->hostgroups.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->hostgroups.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		if (NULL == (group = (zbx_dc_hostgroup_t *)zbx_hashset_search(&dbsync_env.cache->hostgroups, &rowid)))
 			tag = ZBX_DBSYNC_ROW_ADD;
@@ -3112,11 +3112,11 @@ int	zbx_dbsync_compare_host_groups(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->hostgroups, &iter);
 	while (NULL != (group = (zbx_dc_hostgroup_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &group->groupid))
+		if (NULL == zbx_oahashset_search(&ids, &group->groupid))
 			dbsync_add_row(sync, group->groupid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -3228,7 +3228,7 @@ int	zbx_dbsync_compare_item_script_param(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t			dbrow;
 	zbx_db_result_t			result;
-	zbx_hashset_t			ids;
+	zbx_oahashset_t			ids;
 	zbx_hashset_iter_t		iter;
 	zbx_uint64_t			rowid;
 	zbx_dc_scriptitem_param_t	*itemscript_params;
@@ -3256,15 +3256,15 @@ int	zbx_dbsync_compare_item_script_param(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->itemscript_params.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->itemscript_params.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		row = dbsync_preproc_row(sync, dbrow);
 
@@ -3286,11 +3286,11 @@ int	zbx_dbsync_compare_item_script_param(zbx_dbsync_t *sync)
 
 	while (NULL != (itemscript_params = (zbx_dc_scriptitem_param_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &itemscript_params->item_script_paramid))
+		if (NULL == zbx_oahashset_search(&ids, &itemscript_params->item_script_paramid))
 			dbsync_add_row(sync, itemscript_params->item_script_paramid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -3310,7 +3310,7 @@ int	zbx_dbsync_compare_maintenances(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t		dbrow;
 	zbx_db_result_t		result;
-	zbx_hashset_t		ids;
+	zbx_oahashset_t		ids;
 	zbx_hashset_iter_t	iter;
 	zbx_uint64_t		rowid;
 	zbx_dc_maintenance_t	*maintenance;
@@ -3329,15 +3329,15 @@ int	zbx_dbsync_compare_maintenances(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->maintenances.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->maintenances.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		maintenance = (zbx_dc_maintenance_t *)zbx_hashset_search(&dbsync_env.cache->maintenances, &rowid);
 
@@ -3353,11 +3353,11 @@ int	zbx_dbsync_compare_maintenances(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->maintenances, &iter);
 	while (NULL != (maintenance = (zbx_dc_maintenance_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &maintenance->maintenanceid))
+		if (NULL == zbx_oahashset_search(&ids, &maintenance->maintenanceid))
 			dbsync_add_row(sync, maintenance->maintenanceid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -3403,7 +3403,7 @@ int	zbx_dbsync_compare_maintenance_tags(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t			dbrow;
 	zbx_db_result_t			result;
-	zbx_hashset_t			ids;
+	zbx_oahashset_t			ids;
 	zbx_hashset_iter_t		iter;
 	zbx_uint64_t			rowid;
 	zbx_dc_maintenance_tag_t	*maintenance_tag;
@@ -3422,15 +3422,15 @@ int	zbx_dbsync_compare_maintenance_tags(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->maintenance_tags.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->maintenance_tags.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		maintenance_tag = (zbx_dc_maintenance_tag_t *)zbx_hashset_search(&dbsync_env.cache->maintenance_tags,
 				&rowid);
@@ -3447,11 +3447,11 @@ int	zbx_dbsync_compare_maintenance_tags(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->maintenance_tags, &iter);
 	while (NULL != (maintenance_tag = (zbx_dc_maintenance_tag_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &maintenance_tag->maintenancetagid))
+		if (NULL == zbx_oahashset_search(&ids, &maintenance_tag->maintenancetagid))
 			dbsync_add_row(sync, maintenance_tag->maintenancetagid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -3512,7 +3512,7 @@ int	zbx_dbsync_compare_maintenance_periods(zbx_dbsync_t *sync)
 {
 	zbx_db_row_t			dbrow;
 	zbx_db_result_t			result;
-	zbx_hashset_t			ids;
+	zbx_oahashset_t			ids;
 	zbx_hashset_iter_t		iter;
 	zbx_uint64_t			rowid;
 	zbx_dc_maintenance_period_t	*period;
@@ -3533,15 +3533,15 @@ int	zbx_dbsync_compare_maintenance_periods(zbx_dbsync_t *sync)
 		return SUCCEED;
 	}
 
-	zbx_hashset_create(&ids, (size_t)dbsync_env.cache->maintenance_periods.num_data, ZBX_DEFAULT_UINT64_HASH_FUNC,
-			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_oahashset_create(&ids, (size_t)dbsync_env.cache->maintenance_periods.num_data, sizeof(zbx_uint64_t),
+			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	while (NULL != (dbrow = zbx_db_fetch(result)))
 	{
 		unsigned char	tag = ZBX_DBSYNC_ROW_NONE;
 
 		ZBX_STR2UINT64(rowid, dbrow[0]);
-		zbx_hashset_insert(&ids, &rowid, sizeof(rowid));
+		zbx_oahashset_insert(&ids, &rowid, sizeof(rowid));
 
 		period = (zbx_dc_maintenance_period_t *)zbx_hashset_search(&dbsync_env.cache->maintenance_periods,
 				&rowid);
@@ -3558,11 +3558,11 @@ int	zbx_dbsync_compare_maintenance_periods(zbx_dbsync_t *sync)
 	zbx_hashset_iter_reset(&dbsync_env.cache->maintenance_periods, &iter);
 	while (NULL != (period = (zbx_dc_maintenance_period_t *)zbx_hashset_iter_next(&iter)))
 	{
-		if (NULL == zbx_hashset_search(&ids, &period->timeperiodid))
+		if (NULL == zbx_oahashset_search(&ids, &period->timeperiodid))
 			dbsync_add_row(sync, period->timeperiodid, ZBX_DBSYNC_ROW_REMOVE, NULL);
 	}
 
-	zbx_hashset_destroy(&ids);
+	zbx_oahashset_destroy(&ids);
 	zbx_db_free_result(result);
 
 	return SUCCEED;
@@ -1284,6 +1284,38 @@ int	um_cache_get_host_revision(const zbx_um_cache_t *cache, zbx_uint64_t hostid,
 	return SUCCEED;
 }
 
+/*********************************************************************************
+ *                                                                               *
+ * Purpose: get the latest revision of user macros resolved for the host         *
+ *                                                                               *
+ * Parameters: cache    - [IN] the user macro cache                              *
+ *             hostid   - [IN] the host identifier                               *
+ *             revision - [IN/OUT] the revision, updated if host, its templates  *
+ *                                 or their template links have newer revision   *
+ *                                                                               *
+ * Comments: Unlike um_cache_get_host_revision() template link changes are also  *
+ *           taken into account.                                                 *
+ *                                                                               *
+ *********************************************************************************/
+void	um_cache_get_macro_revision(const zbx_um_cache_t *cache, zbx_uint64_t hostid, zbx_uint64_t *revision)
+{
+	const zbx_um_host_t	* const *phost;
+	int			i;
+	zbx_uint64_t		*phostid = &hostid;
+
+	if (NULL == (phost = (const zbx_um_host_t * const *)zbx_hashset_search(&cache->hosts, &phostid)))
+		return;
+
+	if ((*phost)->macro_revision > *revision)
+		*revision = (*phost)->macro_revision;
+
+	if ((*phost)->link_revision > *revision)
+		*revision = (*phost)->link_revision;
+
+	for (i = 0; i < (*phost)->templateids.values_num; i++)
+		um_cache_get_macro_revision(cache, (*phost)->templateids.values[i], revision);
+}
+
 static void	um_cache_get_hosts(const zbx_um_cache_t *cache, const zbx_uint64_t *phostid, zbx_uint64_t revision,
 		zbx_vector_um_host_t *hosts)
 {
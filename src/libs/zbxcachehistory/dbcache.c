@@ -48,10 +48,16 @@ static zbx_shmem_info_t	*trend_mem = NULL;
 #define	UNLOCK_TRENDS	zbx_mutex_unlock(trends_lock)
 #define	LOCK_CACHE_IDS		zbx_mutex_lock(cache_ids_lock)
 #define	UNLOCK_CACHE_IDS	zbx_mutex_unlock(cache_ids_lock)
+#define	LOCK_QUEUE(shard)	zbx_mutex_lock(queue_locks[shard])
+#define	UNLOCK_QUEUE(shard)	zbx_mutex_unlock(queue_locks[shard])
 
 static zbx_mutex_t	cache_lock = ZBX_MUTEX_NULL;
 static zbx_mutex_t	trends_lock = ZBX_MUTEX_NULL;
 static zbx_mutex_t	cache_ids_lock = ZBX_MUTEX_NULL;
+static zbx_mutex_t	queue_locks[ZBX_MUTEX_HISTORY_QUEUE_NUM];
+
+/* the history queue shard history syncer pops items from first */
+static int		queue_shard = 0;
 
 static char		*sql = NULL;
 static size_t		sql_alloc = 4 * ZBX_KIBIBYTE;
@@ -63,6 +69,11 @@ static zbx_history_sync_f	sync_history_cb = NULL;
 
 #define ZBX_HC_ITEMS_INIT_SIZE	1000
 
+#define ZBX_HC_QUEUE_SHARD(itemid)	(zbx_hash_splittable64(&(itemid)) % ZBX_MUTEX_HISTORY_QUEUE_NUM)
+
+/* history queue elements are ordered by the timestamp of the item's oldest value stored in the element key */
+#define ZBX_HC_QUEUE_KEY(ts)	(((zbx_uint64_t)(ts).sec << 32) | (zbx_uint64_t)(ts).ns)
+
 #define ZBX_TRENDS_CLEANUP_TIME	(SEC_PER_MIN * 55)
 
 /* the minimum processed item percentage of item candidates to continue synchronizing */
@@ -108,7 +119,10 @@ typedef struct
 	zbx_dc_stats_t		stats;
 
 	zbx_hashset_t		history_items;
-	zbx_binary_heap_t	history_queue;
+
+	/* history queue is split into shards by itemid, each shard is protected by its own */
+	/* lock, allowing history syncers to pop items without locking the whole cache      */
+	zbx_binary_heap_t	history_queue[ZBX_MUTEX_HISTORY_QUEUE_NUM];
 
 	int			history_num;
 	int			trends_num;
@@ -3015,9 +3029,7 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 
 		*more = ZBX_SYNC_DONE;
 
-		LOCK_CACHE;
 		hc_pop_items(&history_items);		/* select and take items out of history cache */
-		UNLOCK_CACHE;
 
 		if (0 != history_items.values_num)
 		{
@@ -3085,8 +3097,12 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 				{
 					zbx_db_begin();
 
+					/* item and trend updates do not depend on affected row counts, */
+					/* so they can be sent in batches instead of one by one         */
+					zbx_db_pipeline_begin();
 					DBmass_update_items(&item_diff, &inventory_values);
 					DBmass_update_trends(trends, trends_num, &trends_diff);
+					zbx_db_pipeline_end();
 
 					if (NULL != events_cbs->process_events_cb)
 					{
@@ -3156,6 +3172,9 @@ void	zbx_sync_server_history(int *values_num, int *triggers_num, const zbx_event
 						events_cbs->process_events_cb(&trigger_diff, &triggerids);
 					}
 
+					/* send trigger changes together with commit */
+					zbx_db_pipeline_begin();
+
 					if (0 != trigger_diff.values_num)
 						zbx_db_save_trigger_changes(&trigger_diff);
 
@@ -3359,7 +3378,8 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs)
 	int			values_num = 0, triggers_num = 0, more;
 	zbx_hashset_iter_t	iter;
 	zbx_hc_item_t		*item;
-	zbx_binary_heap_t	tmp_history_queue;
+	zbx_binary_heap_t	tmp_history_queue[ZBX_MUTEX_HISTORY_QUEUE_NUM];
+	int			i;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() history_num:%d", __func__, cache->history_num);
 
@@ -3380,9 +3400,13 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs)
 		zbx_dc_config_unlock_all_triggers();
 	}
 
-	tmp_history_queue = cache->history_queue;
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE_NUM; i++)
+	{
+		tmp_history_queue[i] = cache->history_queue[i];
+		zbx_binary_heap_create(&cache->history_queue[i], hc_queue_elem_compare_func,
+				ZBX_BINARY_HEAP_OPTION_EMPTY);
+	}
 
-	zbx_binary_heap_create(&cache->history_queue, hc_queue_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY);
 	zbx_hashset_iter_reset(&cache->history_items, &iter);
 
 	/* add all items from history index to the new history queue */
@@ -3411,8 +3435,11 @@ static void	sync_history_cache_full(const zbx_events_funcs_t *events_cbs)
 		zabbix_log(LOG_LEVEL_WARNING, "syncing history data done");
 	}
 
-	zbx_binary_heap_destroy(&cache->history_queue);
-	cache->history_queue = tmp_history_queue;
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE_NUM; i++)
+	{
+		zbx_binary_heap_destroy(&cache->history_queue[i]);
+		cache->history_queue[i] = tmp_history_queue[i];
+	}
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -4037,11 +4064,11 @@ static int	hc_queue_elem_compare_func(const void *d1, const void *d2)
 	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
 	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
 
-	const zbx_hc_item_t	*item1 = (const zbx_hc_item_t *)e1->data;
-	const zbx_hc_item_t	*item2 = (const zbx_hc_item_t *)e2->data;
+	/* compare by timestamp of the oldest value, item data is not accessed */
+	/* so queue shards can be popped without locking history cache         */
+	ZBX_RETURN_IF_NOT_EQUAL(e1->key, e2->key);
 
-	/* compare by timestamp of the oldest value */
-	return zbx_timespec_compare(&item1->tail->ts, &item2->tail->ts);
+	return 0;
 }
 
 /******************************************************************************
@@ -4096,12 +4123,20 @@ static void	hc_free_data(zbx_hc_data_t *data)
  *                                                                            *
  * Parameters: data - [IN] history item data                                  *
  *                                                                            *
+ * Comments: The history cache must be locked - queue shard lock is always    *
+ *           acquired after cache lock. The timestamp of the oldest value is  *
+ *           copied into element key, so the queue can be popped with only    *
+ *           the shard lock.                                                  *
+ *                                                                            *
  ******************************************************************************/
 static void	hc_queue_item(zbx_hc_item_t *item)
 {
-	zbx_binary_heap_elem_t	elem = {item->itemid, (void *)item};
+	zbx_binary_heap_elem_t	elem = {ZBX_HC_QUEUE_KEY(item->tail->ts), (void *)item};
+	int			shard = ZBX_HC_QUEUE_SHARD(item->itemid);
 
-	zbx_binary_heap_insert(&cache->history_queue, &elem);
+	LOCK_QUEUE(shard);
+	zbx_binary_heap_insert(&cache->history_queue[shard], &elem);
+	UNLOCK_QUEUE(shard);
 }
 
 /******************************************************************************
@@ -4485,6 +4520,42 @@ static void	hc_copy_history_data(zbx_dc_history_t *history, zbx_uint64_t itemid,
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pops the oldest items from history queue shards                   *
+ *                                                                            *
+ * Parameters: queues        - [IN] the history queue shards                  *
+ *             queues_num    - [IN] the number of shards                      *
+ *             shard         - [IN] the shard to pop items from first         *
+ *             items_max     - [IN] the maximum number of items to pop        *
+ *             history_items - [OUT] the popped history items                 *
+ *                                                                            *
+ * Comments: Items are popped from the specified shard and if it does not     *
+ *           have enough items the rest are taken from the following shards.  *
+ *           Only one shard is locked at a time.                              *
+ *                                                                            *
+ ******************************************************************************/
+void	hc_pop_queue_items(zbx_binary_heap_t *queues, int queues_num, int shard, int items_max,
+		zbx_vector_ptr_t *history_items)
+{
+	int	i, index;
+
+	for (i = 0; i < queues_num && items_max > history_items->values_num; i++)
+	{
+		index = (shard + i) % queues_num;
+
+		LOCK_QUEUE(index);
+
+		while (items_max > history_items->values_num && FAIL == zbx_binary_heap_empty(&queues[index]))
+		{
+			zbx_vector_ptr_append(history_items, zbx_binary_heap_find_min(&queues[index])->data);
+			zbx_binary_heap_remove_min(&queues[index]);
+		}
+
+		UNLOCK_QUEUE(index);
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: pops the next batch of history items from cache for processing    *
@@ -4494,20 +4565,18 @@ static void	hc_copy_history_data(zbx_dc_history_t *history, zbx_uint64_t itemid,
  * Comments: The history_items must be returned back to history cache with    *
  *           hc_push_items() function after they have been processed.         *
  *                                                                            *
+ *           Only the history queue shards are locked, so this function must  *
+ *           be called without history cache lock. The shard popped first is  *
+ *           advanced after every batch, so under sustained backlog syncers   *
+ *           cycle through all shards and none of them is starved.            *
+ *                                                                            *
  ******************************************************************************/
 void	hc_pop_items(zbx_vector_ptr_t *history_items)
 {
-	zbx_binary_heap_elem_t	*elem;
-	zbx_hc_item_t		*item;
-
-	while (ZBX_HC_SYNC_MAX > history_items->values_num && FAIL == zbx_binary_heap_empty(&cache->history_queue))
-	{
-		elem = zbx_binary_heap_find_min(&cache->history_queue);
-		item = (zbx_hc_item_t *)elem->data;
-		zbx_vector_ptr_append(history_items, item);
+	hc_pop_queue_items(cache->history_queue, ZBX_MUTEX_HISTORY_QUEUE_NUM, queue_shard, ZBX_HC_SYNC_MAX,
+			history_items);
 
-		zbx_binary_heap_remove_min(&cache->history_queue);
-	}
+	queue_shard = (queue_shard + 1) % ZBX_MUTEX_HISTORY_QUEUE_NUM;
 }
 
 /******************************************************************************
@@ -4586,7 +4655,28 @@ void	hc_push_items(zbx_vector_ptr_t *history_items)
  ******************************************************************************/
 int	hc_queue_get_size(void)
 {
-	return cache->history_queue.elems_num;
+	int	i, size = 0;
+
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE_NUM; i++)
+	{
+		LOCK_QUEUE(i);
+		size += cache->history_queue[i].elems_num;
+		UNLOCK_QUEUE(i);
+	}
+
+	return size;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets the history queue shard history syncer pops items from first *
+ *                                                                            *
+ * Parameters: syncer_num - [IN] the history syncer process number (1..N)     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_hc_set_syncer_num(int syncer_num)
+{
+	queue_shard = (syncer_num - 1) % ZBX_MUTEX_HISTORY_QUEUE_NUM;
 }
 
 int	hc_get_history_compression_age(void)
@@ -4666,7 +4756,7 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 		zbx_uint64_t history_cache_size, zbx_uint64_t history_index_cache_size,zbx_uint64_t *trends_cache_size,
 		char **error)
 {
-	int	ret;
+	int	ret, i;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -4685,6 +4775,12 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 	if (SUCCEED != (ret = zbx_mutex_create(&cache_ids_lock, ZBX_MUTEX_CACHE_IDS, error)))
 		goto out;
 
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE_NUM; i++)
+	{
+		if (SUCCEED != (ret = zbx_mutex_create(&queue_locks[i], ZBX_MUTEX_HISTORY_QUEUE + i, error)))
+			goto out;
+	}
+
 	if (SUCCEED != (ret = zbx_shmem_create(&hc_mem, history_cache_size, "history cache",
 			"HistoryCacheSize", 1, error)))
 	{
@@ -4697,6 +4793,9 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 		goto out;
 	}
 
+	zbx_shmem_enable_slabs(hc_mem);
+	zbx_shmem_enable_slabs(hc_index_mem);
+
 	cache = (ZBX_DC_CACHE *)__hc_index_shmem_malloc_func(NULL, sizeof(ZBX_DC_CACHE));
 	memset(cache, 0, sizeof(ZBX_DC_CACHE));
 
@@ -4707,8 +4806,12 @@ int	zbx_init_database_cache(zbx_get_program_type_f get_program_type, zbx_history
 			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC, NULL,
 			__hc_index_shmem_malloc_func, __hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
 
-	zbx_binary_heap_create_ext(&cache->history_queue, hc_queue_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY,
-			__hc_index_shmem_malloc_func, __hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE_NUM; i++)
+	{
+		zbx_binary_heap_create_ext(&cache->history_queue[i], hc_queue_elem_compare_func,
+				ZBX_BINARY_HEAP_OPTION_EMPTY, __hc_index_shmem_malloc_func,
+				__hc_index_shmem_realloc_func, __hc_index_shmem_free_func);
+	}
 
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
 	{
@@ -4762,6 +4865,8 @@ static void	DCsync_all(const zbx_events_funcs_t *events_cbs)
  ******************************************************************************/
 void	zbx_free_database_cache(int sync, const zbx_events_funcs_t *events_cbs)
 {
+	int	i;
+
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
 	if (ZBX_SYNC_ALL == sync)
@@ -4777,6 +4882,9 @@ void	zbx_free_database_cache(int sync, const zbx_events_funcs_t *events_cbs)
 	zbx_mutex_destroy(&cache_lock);
 	zbx_mutex_destroy(&cache_ids_lock);
 
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE_NUM; i++)
+		zbx_mutex_destroy(&queue_locks[i]);
+
 	if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_SERVER))
 	{
 		zbx_shmem_destroy(trend_mem);
@@ -34,6 +34,8 @@
 void	dbcache_lock(void);
 void	dbcache_unlock(void);
 
+void	hc_pop_queue_items(zbx_binary_heap_t *queues, int queues_num, int shard, int items_max,
+		zbx_vector_ptr_t *history_items);
 void	hc_pop_items(zbx_vector_ptr_t *history_items);
 void	hc_push_items(zbx_vector_ptr_t *history_items);
 void	hc_get_item_values(zbx_dc_history_t *history, zbx_vector_ptr_t *history_items);
@@ -389,13 +389,9 @@ void	zbx_sync_proxy_history(int *values_num, int *triggers_num, const zbx_events
 	{
 		*more = ZBX_SYNC_DONE;
 
-		dbcache_lock();
-
 		hc_pop_items(&history_items);		/* select and take items out of history cache */
 		history_num = history_items.values_num;
 
-		dbcache_unlock();
-
 		if (0 == history_num)
 			break;
 
@@ -100,6 +100,11 @@ typedef struct zbx_vc_chunk
 	/* the number of item value slots in chunk */
 	int			slots_num;
 
+	/* The size of packed value data in bytes or 0 for unpacked chunks. */
+	/* Packed chunks keep the first and last values in slots[0] and     */
+	/* slots[1] while all chunk values are packed after them.           */
+	int			packed_size;
+
 	/* the item value data */
 	zbx_history_record_t	slots[1];
 }
@@ -113,6 +118,42 @@ zbx_vc_chunk_t;
 #define ZBX_VC_MAX_CHUNK_RECORDS	((64 * ZBX_KIBIBYTE - sizeof(zbx_vc_chunk_t)) / \
 		sizeof(zbx_history_record_t) + 1)
 
+/* the maximum number of aggregated time windows per item */
+#define ZBX_VC_WINDOWS_MAX	4
+
+/* the aggregated time windows not requested during this period are dropped */
+#define ZBX_VC_WINDOW_EXPIRE_PERIOD	SEC_PER_HOUR
+
+/* the running aggregates of item values in time window ending with the newest value */
+typedef struct
+{
+	/* the window length in seconds, 0 for unused window slots */
+	int			seconds;
+
+	/* the number of values in window or -1 if the window must be recalculated */
+	int			values_num;
+
+	/* The number of values removed from window since it was calculated.     */
+	/* Used to recalculate the window once all its values have been replaced */
+	/* to avoid accumulating floating point rounding errors in the sum.      */
+	int			removed_num;
+
+	/* the last time when the window was requested */
+	int			last_accessed;
+
+	/* the number of unsigned sum overflows (wraparounds) */
+	int			sum_overflows;
+
+	/* the oldest and the newest value timestamps in window */
+	zbx_timespec_t		first;
+	zbx_timespec_t		last;
+
+	zbx_history_value_t	sum;
+	zbx_history_value_t	min;
+	zbx_history_value_t	max;
+}
+zbx_vc_window_t;
+
 /* the value cache item data */
 typedef struct
 {
@@ -170,11 +211,19 @@ typedef struct
 	/* in low memory situation.                                   */
 	zbx_uint64_t	hits;
 
+	/* The item history revision, changed whenever new values are */
+	/* added to the item or the item is added to cache.           */
+	zbx_uint64_t	revision;
+
 	/* the last (newest) chunk of item history data               */
 	zbx_vc_chunk_t	*head;
 
 	/* the first (oldest) chunk of item history data              */
 	zbx_vc_chunk_t	*tail;
+
+	/* The running aggregates of requested time windows, an array */
+	/* of ZBX_VC_WINDOWS_MAX slots or NULL.                       */
+	zbx_vc_window_t	*windows;
 }
 zbx_vc_item_t;
 
@@ -190,6 +239,12 @@ typedef struct
 	/* value cache operating mode - see ZBX_VC_MODE_* defines */
 	int		mode;
 
+	/* numeric value storage mode - see ZBX_VC_COMPRESSION_* defines */
+	int		compression;
+
+	/* the last assigned item history revision */
+	zbx_uint64_t	revision;
+
 	/* time when cache operating mode was changed */
 	int		mode_time;
 
@@ -224,7 +279,8 @@ ZBX_VECTOR_IMPL(vc_itemweight, zbx_vc_item_weight_t)
 typedef enum
 {
 	ZBX_VC_UPDATE_STATS,
-	ZBX_VC_UPDATE_RANGE
+	ZBX_VC_UPDATE_RANGE,
+	ZBX_VC_UPDATE_WINDOW
 }
 zbx_vc_item_update_type_t;
 
@@ -240,6 +296,12 @@ enum
 	ZBX_VC_UPDATE_RANGE_NOW
 };
 
+enum
+{
+	ZBX_VC_UPDATE_WINDOW_SECONDS,
+	ZBX_VC_UPDATE_WINDOW_NOW
+};
+
 typedef struct
 {
 	zbx_uint64_t			itemid;
@@ -1269,250 +1331,796 @@ static void	vc_item_update_db_cached_from(zbx_vc_item_t *item, int timestamp)
  * range) are automatically removed from cache.
  */
 
+/*
+ * Full chunks of numeric (float, unsigned) items can be packed to reduce the
+ * memory used by long history ranges. The packed chunk keeps its first and
+ * last values unpacked in slots[0] and slots[1], so range checks can be done
+ * without unpacking. All chunk values (including the first and last values)
+ * are packed into a bit stream after them:
+ *
+ *   timestamps - the first timestamp is stored as is, the following timestamps
+ *                (in nanoseconds) as a difference between the current and
+ *                previous timestamp deltas
+ *   float      - the first value is stored as is, the following values as XOR
+ *                with the previous value, reusing the previous meaningful bit
+ *                window when possible
+ *   unsigned   - the same as timestamps
+ *
+ * The differences are zigzag encoded and written as 0 bit for zero or
+ * 1 bit, 6 bits of value length and the value bits.
+ *
+ * Packed chunks are read-only. Values are unpacked into a local buffer when
+ * reading and the chunk is replaced with unpacked chunk if its values must be
+ * modified (except for removing the oldest values by advancing first_value).
+ */
+
+#define VC_PACK_SEC_BITS	32
+#define VC_PACK_NS_BITS		30
+#define VC_PACK_LEN_BITS	6
+
+typedef struct
+{
+	unsigned char	*data;
+	size_t		data_alloc;
+	size_t		bits;
+}
+zbx_vc_bitstream_t;
+
+static zbx_vc_bitstream_t	vc_pack_stream;
+
+static zbx_history_record_t	*vc_unpack_buf = NULL;
+static int			vc_unpack_alloc = 0;
+
 /******************************************************************************
  *                                                                            *
- * Purpose: updates item range with current request range                     *
+ * Purpose: writes bits to bit stream                                         *
  *                                                                            *
- * Parameters: item   - [IN] the item                                         *
- *             range  - [IN] the request range                                *
- *             now    - [IN] the current timestamp                            *
+ * Parameters: stream - [IN/OUT] the bit stream                               *
+ *             value  - [IN] the value to write                               *
+ *             nbits  - [IN] the number of least significant bits to write    *
  *                                                                            *
  ******************************************************************************/
-static void	vch_item_update_range(zbx_vc_item_t *item, int range, int now)
+static void	vc_bitstream_write(zbx_vc_bitstream_t *stream, zbx_uint64_t value, int nbits)
 {
-	int		diff, last_value_timestamp;
-	unsigned char	hour;
-
-	if (VC_MIN_RANGE > range)
-		range = VC_MIN_RANGE;
-
-	if (item->daily_range < range)
-		item->daily_range = range;
-
-	hour = (unsigned char)((now / SEC_PER_HOUR) & 0xff);
-
-	if (0 > (diff = hour - item->range_sync_hour))
-		diff += 0xff;
+	if (stream->data_alloc * 8 < stream->bits + (size_t)nbits)
+	{
+		size_t	old_alloc = stream->data_alloc;
 
-	if (NULL != item->head)
-		last_value_timestamp = item->head->slots[item->head->last_value].timestamp.sec;
-	else
-		last_value_timestamp = now;
+		stream->data_alloc = MAX(stream->data_alloc * 2, 1024);
+		stream->data = (unsigned char *)zbx_realloc(stream->data, stream->data_alloc);
+		memset(stream->data + old_alloc, 0, stream->data_alloc - old_alloc);
+	}
 
-	if (item->active_range < item->daily_range || (ZBX_VC_RANGE_SYNC_PERIOD < diff &&
-			(now - last_value_timestamp) / SEC_PER_HOUR < ZBX_VC_RANGE_SYNC_PERIOD))
+	while (0 < nbits)
 	{
-		item->active_range = item->daily_range;
-		item->daily_range = range;
-		item->range_sync_hour = hour;
+		int	free_bits = 8 - (int)(stream->bits & 7), n = MIN(free_bits, nbits);
+
+		nbits -= n;
+		stream->data[stream->bits >> 3] |= (unsigned char)(((value >> nbits) & ((1u << n) - 1)) <<
+				(free_bits - n));
+		stream->bits += (size_t)n;
 	}
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: calculates optimal number of slots for an item data chunk         *
- *                                                                            *
- * Parameters:  item        - [IN] the item                                   *
- *              values_new  - [IN] the number of values to be added           *
+ * Purpose: reads bits from bit stream                                        *
  *                                                                            *
- * Return value: the number of slots for a new item data chunk                *
+ * Parameters: data  - [IN] the bit stream data                               *
+ *             pos   - [IN/OUT] the bit position in stream                    *
+ *             nbits - [IN] the number of bits to read                        *
  *                                                                            *
- * Comments: From size perspective the optimal slot count per chunk is        *
- *           approximately square root of the number of cached values.        *
- *           Still creating too many chunks might affect timeshift request    *
- *           performance, so don't try creating more than 32 chunks unless    *
- *           the calculated slot count exceeds the maximum limit.             *
+ * Return value: the read bits                                                *
  *                                                                            *
  ******************************************************************************/
-static int	vch_item_chunk_slot_count(zbx_vc_item_t *item, int values_new)
+static zbx_uint64_t	vc_bitstream_read(const unsigned char *data, size_t *pos, int nbits)
 {
-	int	nslots, values;
+	zbx_uint64_t	value = 0;
 
-	values = item->values_total + values_new;
+	while (0 < nbits)
+	{
+		int	left_bits = 8 - (int)(*pos & 7), n = MIN(left_bits, nbits);
 
-	nslots = (int)zbx_isqrt32((unsigned int)values);
+		value = (value << n) | (zbx_uint64_t)((data[*pos >> 3] >> (left_bits - n)) & ((1u << n) - 1));
+		nbits -= n;
+		*pos += (size_t)n;
+	}
 
-	if ((values + nslots - 1) / nslots + 1 > 32)
-		nslots = values / 32;
+	return value;
+}
 
-	if (nslots > (int)ZBX_VC_MAX_CHUNK_RECORDS)
-		nslots = ZBX_VC_MAX_CHUNK_RECORDS;
-	if (nslots < (int)ZBX_VC_MIN_CHUNK_RECORDS)
-		nslots = ZBX_VC_MIN_CHUNK_RECORDS;
+static int	vc_bit_length(zbx_uint64_t value)
+{
+	int	len = 0;
 
-	return nslots;
+	while (0 != value)
+	{
+		value >>= 1;
+		len++;
+	}
+
+	return len;
+}
+
+static int	vc_trailing_zeros(zbx_uint64_t value)
+{
+	int	zeros = 0;
+
+	while (0 == (value & 1))
+	{
+		value >>= 1;
+		zeros++;
+	}
+
+	return zeros;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: adds a new data chunk at the end of item's history data list      *
- *                                                                            *
- * Parameters: item          - [IN/OUT] the item to add chunk to              *
- *             nslots        - [IN] the number of slots in the new chunk      *
- *             insert_before - [IN] the target chunk before which the new     *
- *                             chunk must be inserted. If this value is NULL  *
- *                             then the new chunk is appended at the end of   *
- *                             chunk list (making it the newest chunk).       *
+ * Purpose: writes difference between current and previous delta              *
  *                                                                            *
- * Return value:  SUCCEED - the chunk was added successfully                  *
- *                FAIL - failed to create a new chunk (not enough memory)     *
+ * Parameters: stream - [IN/OUT] the bit stream                               *
+ *             value  - [IN] the current value                                *
+ *             last   - [IN/OUT] the previous value                           *
+ *             delta  - [IN/OUT] the previous delta                           *
  *                                                                            *
  ******************************************************************************/
-static int	vch_item_add_chunk(zbx_vc_item_t *item, int nslots, zbx_vc_chunk_t *insert_before)
+static void	vc_pack_write_delta(zbx_vc_bitstream_t *stream, zbx_uint64_t value, zbx_uint64_t *last,
+		zbx_uint64_t *delta)
 {
-	zbx_vc_chunk_t	*chunk;
-	size_t		chunk_size;
+	zbx_uint64_t	dod, zigzag;
+	int		len;
 
-	chunk_size =sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) * (size_t)(nslots - 1);
+	dod = value - *last - *delta;
+	*delta = value - *last;
+	*last = value;
 
-	if (NULL == (chunk = (zbx_vc_chunk_t *)vc_item_malloc(item, chunk_size)))
-		return FAIL;
+	if (0 == dod)
+	{
+		vc_bitstream_write(stream, 0, 1);
+		return;
+	}
 
-	memset(chunk, 0, sizeof(zbx_vc_chunk_t));
-	chunk->slots_num = nslots;
+	zigzag = (dod << 1) ^ (0 != (dod >> 63) ? ~(zbx_uint64_t)0 : 0);
+	len = vc_bit_length(zigzag);
 
-	chunk->next = insert_before;
+	vc_bitstream_write(stream, 1, 1);
+	vc_bitstream_write(stream, (zbx_uint64_t)(len - 1), VC_PACK_LEN_BITS);
+	vc_bitstream_write(stream, zigzag, len);
+}
 
-	if (NULL == insert_before)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads value written by vc_pack_write_delta()                      *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	vc_unpack_read_delta(const unsigned char *data, size_t *pos, zbx_uint64_t *last,
+		zbx_uint64_t *delta)
+{
+	if (0 != vc_bitstream_read(data, pos, 1))
 	{
-		chunk->prev = item->head;
+		zbx_uint64_t	zigzag;
+		int		len;
 
-		if (NULL != item->head)
-			item->head->next = chunk;
-		else
-			item->tail = chunk;
-
-		item->head = chunk;
+		len = (int)vc_bitstream_read(data, pos, VC_PACK_LEN_BITS) + 1;
+		zigzag = vc_bitstream_read(data, pos, len);
+		*delta += (zigzag >> 1) ^ (0 != (zigzag & 1) ? ~(zbx_uint64_t)0 : 0);
 	}
-	else
+
+	*last += *delta;
+
+	return *last;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: writes floating point value as XOR with the previous value        *
+ *                                                                            *
+ * Parameters: stream   - [IN/OUT] the bit stream                             *
+ *             value    - [IN] the current value bits                         *
+ *             last     - [IN/OUT] the previous value bits                    *
+ *             leading  - [IN/OUT] the previous leading zero bits             *
+ *             trailing - [IN/OUT] the previous trailing zero bits            *
+ *                                                                            *
+ ******************************************************************************/
+static void	vc_pack_write_xor(zbx_vc_bitstream_t *stream, zbx_uint64_t value, zbx_uint64_t *last,
+		int *leading, int *trailing)
+{
+	zbx_uint64_t	xor = value ^ *last;
+	int		lz, tz;
+
+	*last = value;
+
+	if (0 == xor)
 	{
-		chunk->prev = insert_before->prev;
-		insert_before->prev = chunk;
+		vc_bitstream_write(stream, 0, 1);
+		return;
+	}
 
-		if (item->tail == insert_before)
-			item->tail = chunk;
-		else
-			chunk->prev->next = chunk;
+	lz = 64 - vc_bit_length(xor);
+	tz = vc_trailing_zeros(xor);
+
+	if (0 <= *leading && lz >= *leading && tz >= *trailing)
+	{
+		vc_bitstream_write(stream, 2, 2);
+		vc_bitstream_write(stream, xor >> *trailing, 64 - *leading - *trailing);
+		return;
 	}
 
-	return SUCCEED;
+	vc_bitstream_write(stream, 3, 2);
+	vc_bitstream_write(stream, (zbx_uint64_t)lz, VC_PACK_LEN_BITS);
+	vc_bitstream_write(stream, (zbx_uint64_t)(64 - lz - tz - 1), VC_PACK_LEN_BITS);
+	vc_bitstream_write(stream, xor >> tz, 64 - lz - tz);
+
+	*leading = lz;
+	*trailing = tz;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: find the index of the last value in chunk with timestamp less or  *
- *          equal to the specified timestamp.                                 *
+ * Purpose: reads value written by vc_pack_write_xor()                        *
  *                                                                            *
- * Parameters:  chunk - [IN] the chunk                                        *
- *              ts    - [IN] the target timestamp                             *
+ ******************************************************************************/
+static zbx_uint64_t	vc_unpack_read_xor(const unsigned char *data, size_t *pos, zbx_uint64_t *last,
+		int *leading, int *trailing)
+{
+	if (0 == vc_bitstream_read(data, pos, 1))
+		return *last;
+
+	if (0 != vc_bitstream_read(data, pos, 1))
+	{
+		*leading = (int)vc_bitstream_read(data, pos, VC_PACK_LEN_BITS);
+		*trailing = 64 - *leading - ((int)vc_bitstream_read(data, pos, VC_PACK_LEN_BITS) + 1);
+	}
+
+	*last ^= vc_bitstream_read(data, pos, 64 - *leading - *trailing) << *trailing;
+
+	return *last;
+}
+
+/******************************************************************************
  *                                                                            *
- * Return value: The index of the last value in chunk with timestamp less or  *
- *               equal to the specified timestamp.                            *
- *               -1 is returned in the case of failure (meaning that all      *
- *               values have timestamps greater than the target timestamp).   *
+ * Purpose: packs values into bit stream                                      *
+ *                                                                            *
+ * Parameters: stream     - [OUT] the bit stream                              *
+ *             value_type - [IN] the value type (float or unsigned)           *
+ *             values     - [IN] the values to pack                           *
+ *             values_num - [IN] the number of values to pack                 *
  *                                                                            *
  ******************************************************************************/
-static int	vch_chunk_find_last_value_before(const zbx_vc_chunk_t *chunk, const zbx_timespec_t *ts)
+static void	vc_pack_values(zbx_vc_bitstream_t *stream, unsigned char value_type,
+		const zbx_history_record_t *values, int values_num)
 {
-	int	start = chunk->first_value, end = chunk->last_value, middle;
+	zbx_uint64_t	ts_last, ts_delta = 0, value_last, value_delta = 0;
+	int		i, leading = -1, trailing = 0;
 
-	/* check if the last value timestamp is already greater or equal to the specified timestamp */
-	if (0 >= zbx_timespec_compare(&chunk->slots[end].timestamp, ts))
-		return end;
+	if (NULL != stream->data)
+		memset(stream->data, 0, stream->data_alloc);
+	stream->bits = 0;
 
-	/* chunk contains only one value, which did not pass the above check, return failure */
-	if (start == end)
-		return -1;
+	vc_bitstream_write(stream, (zbx_uint64_t)(zbx_uint32_t)values[0].timestamp.sec, VC_PACK_SEC_BITS);
+	vc_bitstream_write(stream, (zbx_uint64_t)values[0].timestamp.ns, VC_PACK_NS_BITS);
+	ts_last = (zbx_uint64_t)(zbx_uint32_t)values[0].timestamp.sec * 1000000000 +
+			(zbx_uint64_t)values[0].timestamp.ns;
 
-	/* perform value lookup using binary search */
-	while (start != end)
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		memcpy(&value_last, &values[0].value.dbl, sizeof(value_last));
+	else
+		value_last = values[0].value.ui64;
+
+	vc_bitstream_write(stream, value_last, 64);
+
+	for (i = 1; i < values_num; i++)
 	{
-		middle = start + (end - start) / 2;
+		vc_pack_write_delta(stream, (zbx_uint64_t)(zbx_uint32_t)values[i].timestamp.sec * 1000000000 +
+				(zbx_uint64_t)values[i].timestamp.ns, &ts_last, &ts_delta);
 
-		if (0 < zbx_timespec_compare(&chunk->slots[middle].timestamp, ts))
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
 		{
-			end = middle;
-			continue;
-		}
+			zbx_uint64_t	value;
 
-		if (0 >= zbx_timespec_compare(&chunk->slots[middle + 1].timestamp, ts))
-		{
-			start = middle;
-			continue;
+			memcpy(&value, &values[i].value.dbl, sizeof(value));
+			vc_pack_write_xor(stream, value, &value_last, &leading, &trailing);
 		}
-
-		return middle;
+		else
+			vc_pack_write_delta(stream, values[i].value.ui64, &value_last, &value_delta);
 	}
-
-	return -1;
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: gets the chunk and index of the last value with a timestamp less  *
- *          or equal to the specified timestamp                               *
- *                                                                            *
- * Parameters:  item          - [IN] the item                                 *
- *              ts            - [IN] the target timestamp                     *
- *                                   (NULL - current time)                    *
- *              pchunk        - [OUT] the chunk containing the target value   *
- *              pindex        - [OUT] the index of the target value           *
- *                                                                            *
- * Return value: SUCCEED - the last value was found successfully              *
- *               FAIL - all values in cache have timestamps greater than the  *
- *                      target (timeshift) timestamp.                         *
+ * Purpose: unpacks values packed by vc_pack_values()                         *
  *                                                                            *
- * Comments: If end_timestamp value is 0, then simply the last item value in  *
- *           cache is returned.                                               *
+ * Parameters: data       - [IN] the packed data                              *
+ *             value_type - [IN] the value type (float or unsigned)           *
+ *             values     - [OUT] the unpacked values                         *
+ *             values_num - [IN] the number of values to unpack               *
  *                                                                            *
  ******************************************************************************/
-static int	vch_item_get_last_value(const zbx_vc_item_t *item, const zbx_timespec_t *ts, zbx_vc_chunk_t **pchunk,
-		int *pindex)
+static void	vc_unpack_values(const unsigned char *data, unsigned char value_type, zbx_history_record_t *values,
+		int values_num)
 {
-	zbx_vc_chunk_t	*chunk = item->head;
-	int		index;
+	zbx_uint64_t	ts_last, ts_delta = 0, value_last, value_delta = 0;
+	size_t		pos = 0;
+	int		i, leading = 0, trailing = 0;
 
-	if (NULL == chunk)
-		return FAIL;
+	values[0].timestamp.sec = (int)vc_bitstream_read(data, &pos, VC_PACK_SEC_BITS);
+	values[0].timestamp.ns = (int)vc_bitstream_read(data, &pos, VC_PACK_NS_BITS);
+	ts_last = (zbx_uint64_t)(zbx_uint32_t)values[0].timestamp.sec * 1000000000 +
+			(zbx_uint64_t)values[0].timestamp.ns;
 
-	index = chunk->last_value;
+	value_last = vc_bitstream_read(data, &pos, 64);
 
-	if (0 < zbx_timespec_compare(&chunk->slots[index].timestamp, ts))
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+		memcpy(&values[0].value.dbl, &value_last, sizeof(value_last));
+	else
+		values[0].value.ui64 = value_last;
+
+	for (i = 1; i < values_num; i++)
 	{
-		while (0 < zbx_timespec_compare(&chunk->slots[chunk->first_value].timestamp, ts))
+		zbx_uint64_t	ts;
+
+		ts = vc_unpack_read_delta(data, &pos, &ts_last, &ts_delta);
+		values[i].timestamp.sec = (int)(ts / 1000000000);
+		values[i].timestamp.ns = (int)(ts % 1000000000);
+
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
 		{
-			chunk = chunk->prev;
-			/* there are no values for requested range, return failure */
-			if (NULL == chunk)
-				return FAIL;
+			zbx_uint64_t	value;
+
+			value = vc_unpack_read_xor(data, &pos, &value_last, &leading, &trailing);
+			memcpy(&values[i].value.dbl, &value, sizeof(value));
 		}
-		index = vch_chunk_find_last_value_before(chunk, ts);
+		else
+			values[i].value.ui64 = vc_unpack_read_delta(data, &pos, &value_last, &value_delta);
 	}
+}
 
-	*pchunk = chunk;
-	*pindex = index;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns the size of memory allocated for chunk                    *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	vch_chunk_size(const zbx_vc_chunk_t *chunk)
+{
+	if (0 != chunk->packed_size)
+		return sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) + (size_t)chunk->packed_size;
 
-	return SUCCEED;
+	return sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) * (size_t)(chunk->slots_num - 1);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: copies value in the specified item's chunk slot                   *
- *                                                                            *
- * Parameters: chunk        - [IN/OUT] the target chunk                       *
- *             index        - [IN] the target slot                            *
- *             source_value - [IN] the value to copy                          *
+ * Purpose: returns the first (oldest) chunk value                            *
  *                                                                            *
- * Return value: SUCCEED - the value was copied successfully                  *
- *               FAIL    - the value copying failed (not enough space for     *
- *                         string, text or log type data)                     *
+ ******************************************************************************/
+static const zbx_history_record_t	*vch_chunk_first(const zbx_vc_chunk_t *chunk)
+{
+	return 0 == chunk->packed_size ? &chunk->slots[chunk->first_value] : &chunk->slots[0];
+}
+
+/******************************************************************************
  *                                                                            *
- * Comments: This function is used to copy data to cache. The contents of     *
- *           str, text and log type values are stored in cache string pool.   *
+ * Purpose: returns the last (newest) chunk value                             *
  *                                                                            *
  ******************************************************************************/
-static int	vch_item_copy_value(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk, int index,
-		const zbx_history_record_t *source_value)
+static const zbx_history_record_t	*vch_chunk_last(const zbx_vc_chunk_t *chunk)
+{
+	return 0 == chunk->packed_size ? &chunk->slots[chunk->last_value] : &chunk->slots[1];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns chunk value slots, unpacking them if necessary            *
+ *                                                                            *
+ * Parameters: item  - [IN] the chunk owner item                              *
+ *             chunk - [IN] the chunk                                         *
+ *                                                                            *
+ * Return value: The chunk value slots. For packed chunks the values are      *
+ *               unpacked into local buffer, which is valid until the next    *
+ *               call of this function.                                       *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_history_record_t	*vch_chunk_slots(const zbx_vc_item_t *item, zbx_vc_chunk_t *chunk)
+{
+	if (0 == chunk->packed_size)
+		return chunk->slots;
+
+	if (vc_unpack_alloc < chunk->slots_num)
+	{
+		vc_unpack_alloc = chunk->slots_num;
+		vc_unpack_buf = (zbx_history_record_t *)zbx_realloc(vc_unpack_buf,
+				sizeof(zbx_history_record_t) * (size_t)vc_unpack_alloc);
+	}
+
+	vc_unpack_values((const unsigned char *)&chunk->slots[2], item->value_type, vc_unpack_buf,
+			chunk->slots_num);
+
+	return vc_unpack_buf;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: replaces chunk in item's chunk list                               *
+ *                                                                            *
+ * Parameters: item      - [IN/OUT] the chunk owner item                      *
+ *             chunk     - [IN] the chunk to replace, it's freed afterwards   *
+ *             new_chunk - [IN] the new chunk                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_replace_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk, zbx_vc_chunk_t *new_chunk)
+{
+	new_chunk->prev = chunk->prev;
+	new_chunk->next = chunk->next;
+
+	if (NULL != chunk->prev)
+		chunk->prev->next = new_chunk;
+	else
+		item->tail = new_chunk;
+
+	if (NULL != chunk->next)
+		chunk->next->prev = new_chunk;
+	else
+		item->head = new_chunk;
+
+	__vc_shmem_free_func(chunk);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: packs full chunk of a numeric item                                *
+ *                                                                            *
+ * Parameters: item  - [IN/OUT] the chunk owner item                          *
+ *             chunk - [IN] the chunk to pack                                 *
+ *                                                                            *
+ * Comments: The chunk is left unpacked if packing is disabled, does not      *
+ *           reduce the chunk size or there is not enough memory.             *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_pack_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk)
+{
+	zbx_vc_chunk_t	*packed;
+	size_t		packed_size, chunk_size;
+	int		values_num;
+
+	if (ZBX_VC_COMPRESSION_NONE == vc_cache->compression || 0 != chunk->packed_size)
+		return;
+
+	if (ITEM_VALUE_TYPE_FLOAT != item->value_type && ITEM_VALUE_TYPE_UINT64 != item->value_type)
+		return;
+
+	values_num = chunk->last_value - chunk->first_value + 1;
+
+	vc_pack_values(&vc_pack_stream, item->value_type, &chunk->slots[chunk->first_value], values_num);
+	packed_size = (vc_pack_stream.bits + 7) / 8;
+	chunk_size = sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) + packed_size;
+
+	if (chunk_size >= vch_chunk_size(chunk))
+		return;
+
+	if (NULL == (packed = (zbx_vc_chunk_t *)__vc_shmem_malloc_func(NULL, chunk_size)))
+		return;
+
+	packed->slots_num = values_num;
+	packed->first_value = 0;
+	packed->last_value = values_num - 1;
+	packed->packed_size = (int)packed_size;
+	packed->slots[0] = chunk->slots[chunk->first_value];
+	packed->slots[1] = chunk->slots[chunk->last_value];
+	memcpy(&packed->slots[2], vc_pack_stream.data, packed_size);
+
+	vch_item_replace_chunk(item, chunk, packed);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: replaces packed chunk with unpacked one                           *
+ *                                                                            *
+ * Parameters: item  - [IN/OUT] the chunk owner item                          *
+ *             chunk - [IN/OUT] the chunk to unpack                           *
+ *                                                                            *
+ * Return value: SUCCEED - the chunk was unpacked                             *
+ *               FAIL    - not enough memory                                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_item_unpack_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t **chunk)
+{
+	zbx_vc_chunk_t	*unpacked;
+	size_t		chunk_size;
+
+	if (0 == (*chunk)->packed_size)
+		return SUCCEED;
+
+	chunk_size = sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) * (size_t)((*chunk)->slots_num - 1);
+
+	if (NULL == (unpacked = (zbx_vc_chunk_t *)__vc_shmem_malloc_func(NULL, chunk_size)))
+		return FAIL;
+
+	unpacked->slots_num = (*chunk)->slots_num;
+	unpacked->first_value = (*chunk)->first_value;
+	unpacked->last_value = (*chunk)->last_value;
+	unpacked->packed_size = 0;
+	vc_unpack_values((const unsigned char *)&(*chunk)->slots[2], item->value_type, unpacked->slots,
+			unpacked->slots_num);
+
+	vch_item_replace_chunk(item, *chunk, unpacked);
+	*chunk = unpacked;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes the oldest values from chunk                              *
+ *                                                                            *
+ * Parameters: item        - [IN/OUT] the chunk owner item                    *
+ *             chunk       - [IN/OUT] the chunk                               *
+ *             slots       - [IN] the chunk value slots                       *
+ *             first_value - [IN] the index of new first value                *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_remove_first_values(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk, zbx_history_record_t *slots,
+		int first_value)
+{
+	vc_item_free_values(item, slots, chunk->first_value, first_value - 1);
+	chunk->first_value = first_value;
+
+	if (0 != chunk->packed_size)
+		chunk->slots[0] = slots[first_value];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: updates item range with current request range                     *
+ *                                                                            *
+ * Parameters: item   - [IN] the item                                         *
+ *             range  - [IN] the request range                                *
+ *             now    - [IN] the current timestamp                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_update_range(zbx_vc_item_t *item, int range, int now)
+{
+	int		diff, last_value_timestamp;
+	unsigned char	hour;
+
+	if (VC_MIN_RANGE > range)
+		range = VC_MIN_RANGE;
+
+	if (item->daily_range < range)
+		item->daily_range = range;
+
+	hour = (unsigned char)((now / SEC_PER_HOUR) & 0xff);
+
+	if (0 > (diff = hour - item->range_sync_hour))
+		diff += 0xff;
+
+	if (NULL != item->head)
+		last_value_timestamp = vch_chunk_last(item->head)->timestamp.sec;
+	else
+		last_value_timestamp = now;
+
+	if (item->active_range < item->daily_range || (ZBX_VC_RANGE_SYNC_PERIOD < diff &&
+			(now - last_value_timestamp) / SEC_PER_HOUR < ZBX_VC_RANGE_SYNC_PERIOD))
+	{
+		item->active_range = item->daily_range;
+		item->daily_range = range;
+		item->range_sync_hour = hour;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates optimal number of slots for an item data chunk         *
+ *                                                                            *
+ * Parameters:  item        - [IN] the item                                   *
+ *              values_new  - [IN] the number of values to be added           *
+ *                                                                            *
+ * Return value: the number of slots for a new item data chunk                *
+ *                                                                            *
+ * Comments: From size perspective the optimal slot count per chunk is        *
+ *           approximately square root of the number of cached values.        *
+ *           Still creating too many chunks might affect timeshift request    *
+ *           performance, so don't try creating more than 32 chunks unless    *
+ *           the calculated slot count exceeds the maximum limit.             *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_item_chunk_slot_count(zbx_vc_item_t *item, int values_new)
+{
+	int	nslots, values;
+
+	values = item->values_total + values_new;
+
+	nslots = (int)zbx_isqrt32((unsigned int)values);
+
+	if ((values + nslots - 1) / nslots + 1 > 32)
+		nslots = values / 32;
+
+	if (nslots > (int)ZBX_VC_MAX_CHUNK_RECORDS)
+		nslots = ZBX_VC_MAX_CHUNK_RECORDS;
+	if (nslots < (int)ZBX_VC_MIN_CHUNK_RECORDS)
+		nslots = ZBX_VC_MIN_CHUNK_RECORDS;
+
+	return nslots;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds a new data chunk at the end of item's history data list      *
+ *                                                                            *
+ * Parameters: item          - [IN/OUT] the item to add chunk to              *
+ *             nslots        - [IN] the number of slots in the new chunk      *
+ *             insert_before - [IN] the target chunk before which the new     *
+ *                             chunk must be inserted. If this value is NULL  *
+ *                             then the new chunk is appended at the end of   *
+ *                             chunk list (making it the newest chunk).       *
+ *                                                                            *
+ * Return value:  SUCCEED - the chunk was added successfully                  *
+ *                FAIL - failed to create a new chunk (not enough memory)     *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_item_add_chunk(zbx_vc_item_t *item, int nslots, zbx_vc_chunk_t *insert_before)
+{
+	zbx_vc_chunk_t	*chunk;
+	size_t		chunk_size;
+
+	chunk_size =sizeof(zbx_vc_chunk_t) + sizeof(zbx_history_record_t) * (size_t)(nslots - 1);
+
+	if (NULL == (chunk = (zbx_vc_chunk_t *)vc_item_malloc(item, chunk_size)))
+		return FAIL;
+
+	memset(chunk, 0, sizeof(zbx_vc_chunk_t));
+	chunk->slots_num = nslots;
+
+	chunk->next = insert_before;
+
+	if (NULL == insert_before)
+	{
+		chunk->prev = item->head;
+
+		if (NULL != item->head)
+			item->head->next = chunk;
+		else
+			item->tail = chunk;
+
+		item->head = chunk;
+	}
+	else
+	{
+		chunk->prev = insert_before->prev;
+		insert_before->prev = chunk;
+
+		if (item->tail == insert_before)
+			item->tail = chunk;
+		else
+			chunk->prev->next = chunk;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find the index of the last value in chunk with timestamp less or  *
+ *          equal to the specified timestamp.                                 *
+ *                                                                            *
+ * Parameters:  chunk - [IN] the chunk                                        *
+ *              slots - [IN] the chunk value slots                            *
+ *              ts    - [IN] the target timestamp                             *
+ *                                                                            *
+ * Return value: The index of the last value in chunk with timestamp less or  *
+ *               equal to the specified timestamp.                            *
+ *               -1 is returned in the case of failure (meaning that all      *
+ *               values have timestamps greater than the target timestamp).   *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_chunk_find_last_value_before(const zbx_vc_chunk_t *chunk, const zbx_history_record_t *slots,
+		const zbx_timespec_t *ts)
+{
+	int	start = chunk->first_value, end = chunk->last_value, middle;
+
+	/* check if the last value timestamp is already greater or equal to the specified timestamp */
+	if (0 >= zbx_timespec_compare(&slots[end].timestamp, ts))
+		return end;
+
+	/* chunk contains only one value, which did not pass the above check, return failure */
+	if (start == end)
+		return -1;
+
+	/* perform value lookup using binary search */
+	while (start != end)
+	{
+		middle = start + (end - start) / 2;
+
+		if (0 < zbx_timespec_compare(&slots[middle].timestamp, ts))
+		{
+			end = middle;
+			continue;
+		}
+
+		if (0 >= zbx_timespec_compare(&slots[middle + 1].timestamp, ts))
+		{
+			start = middle;
+			continue;
+		}
+
+		return middle;
+	}
+
+	return -1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets the chunk and index of the last value with a timestamp less  *
+ *          or equal to the specified timestamp                               *
+ *                                                                            *
+ * Parameters:  item          - [IN] the item                                 *
+ *              ts            - [IN] the target timestamp                     *
+ *                                   (NULL - current time)                    *
+ *              pchunk        - [OUT] the chunk containing the target value   *
+ *              pslots        - [OUT] the chunk value slots                   *
+ *              pindex        - [OUT] the index of the target value           *
+ *                                                                            *
+ * Return value: SUCCEED - the last value was found successfully              *
+ *               FAIL - all values in cache have timestamps greater than the  *
+ *                      target (timeshift) timestamp.                         *
+ *                                                                            *
+ * Comments: If end_timestamp value is 0, then simply the last item value in  *
+ *           cache is returned.                                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_item_get_last_value(const zbx_vc_item_t *item, const zbx_timespec_t *ts, zbx_vc_chunk_t **pchunk,
+		zbx_history_record_t **pslots, int *pindex)
+{
+	zbx_vc_chunk_t		*chunk = item->head;
+	zbx_history_record_t	*slots;
+	int			index;
+
+	if (NULL == chunk)
+		return FAIL;
+
+	index = chunk->last_value;
+
+	if (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, ts))
+	{
+		while (0 < zbx_timespec_compare(&vch_chunk_first(chunk)->timestamp, ts))
+		{
+			chunk = chunk->prev;
+			/* there are no values for requested range, return failure */
+			if (NULL == chunk)
+				return FAIL;
+		}
+		slots = vch_chunk_slots(item, chunk);
+		index = vch_chunk_find_last_value_before(chunk, slots, ts);
+	}
+	else
+		slots = vch_chunk_slots(item, chunk);
+
+	*pchunk = chunk;
+	*pslots = slots;
+	*pindex = index;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copies value in the specified item's chunk slot                   *
+ *                                                                            *
+ * Parameters: chunk        - [IN/OUT] the target chunk                       *
+ *             index        - [IN] the target slot                            *
+ *             source_value - [IN] the value to copy                          *
+ *                                                                            *
+ * Return value: SUCCEED - the value was copied successfully                  *
+ *               FAIL    - the value copying failed (not enough space for     *
+ *                         string, text or log type data)                     *
+ *                                                                            *
+ * Comments: This function is used to copy data to cache. The contents of     *
+ *           str, text and log type values are stored in cache string pool.   *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_item_copy_value(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk, int index,
+		const zbx_history_record_t *source_value)
 {
 	zbx_history_record_t	*value;
 	int			ret = FAIL;
@@ -1617,8 +2225,13 @@ static size_t	vch_item_free_chunk(zbx_vc_item_t *item, zbx_vc_chunk_t *chunk)
 {
 	size_t	freed;
 
-	freed = sizeof(zbx_vc_chunk_t) + (size_t)(chunk->slots_num - 1) * sizeof(zbx_history_record_t);
-	freed += vc_item_free_values(item, chunk->slots, chunk->first_value, chunk->last_value);
+	freed = vch_chunk_size(chunk);
+
+	/* packed chunks hold only numeric values, which have no resources to free */
+	if (0 != chunk->packed_size)
+		item->values_total -= chunk->last_value - chunk->first_value + 1;
+	else
+		freed += vc_item_free_values(item, chunk->slots, chunk->first_value, chunk->last_value);
 
 	__vc_shmem_free_func(chunk);
 
@@ -1673,9 +2286,8 @@ static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp)
 		/* Try to remove chunks with all history values older than maximum request range, maximum */
 		/* request range should be calculated from last received value with which active range    */
 		/* was calculated to avoid dropping of chunks that might be still used in count request.  */
-		while (NULL != chunk && chunk->slots[chunk->last_value].timestamp.sec < timestamp &&
-				chunk->slots[chunk->last_value].timestamp.sec !=
-						item->head->slots[item->head->last_value].timestamp.sec)
+		while (NULL != chunk && vch_chunk_last(chunk)->timestamp.sec < timestamp &&
+				vch_chunk_last(chunk)->timestamp.sec != vch_chunk_last(item->head)->timestamp.sec)
 		{
 			/* don't remove the head chunk */
 			if (NULL == (next = chunk->next))
@@ -1689,18 +2301,20 @@ static void	vch_item_clean_cache(zbx_vc_item_t *item, int timestamp)
 			/* In this case increase the first value index of the next chunk until the first  */
 			/* value timestamp is greater.                                                    */
 
-			if (next->slots[next->first_value].timestamp.sec != next->slots[next->last_value].timestamp.sec)
+			if (vch_chunk_first(next)->timestamp.sec != vch_chunk_last(next)->timestamp.sec &&
+					vch_chunk_first(next)->timestamp.sec == vch_chunk_last(chunk)->timestamp.sec)
 			{
-				while (next->slots[next->first_value].timestamp.sec ==
-						chunk->slots[chunk->last_value].timestamp.sec)
-				{
-					vc_item_free_values(item, next->slots, next->first_value, next->first_value);
-					next->first_value++;
-				}
+				zbx_history_record_t	*slots = vch_chunk_slots(item, next);
+				int			first_value = next->first_value;
+
+				while (slots[first_value].timestamp.sec == vch_chunk_last(chunk)->timestamp.sec)
+					first_value++;
+
+				vch_item_remove_first_values(item, next, slots, first_value);
 			}
 
 			/* set the database cached from timestamp to the last (oldest) removed value timestamp + 1 */
-			item->db_cached_from = chunk->slots[chunk->last_value].timestamp.sec + 1;
+			item->db_cached_from = vch_chunk_last(chunk)->timestamp.sec + 1;
 
 			vch_item_remove_chunk(item, chunk);
 
@@ -1731,20 +2345,22 @@ static void	vch_item_remove_values(zbx_vc_item_t *item, int timestamp)
 		item->status = 0;
 
 	/* try to remove chunks with all history values older than the timestamp */
-	while (NULL != chunk && chunk->slots[chunk->first_value].timestamp.sec < timestamp)
+	while (NULL != chunk && vch_chunk_first(chunk)->timestamp.sec < timestamp)
 	{
 		zbx_vc_chunk_t	*next;
 
 		/* If chunk contains values with timestamp greater or equal - remove */
 		/* only the values with less timestamp. Otherwise remove the while   */
 		/* chunk and check next one.                                         */
-		if (chunk->slots[chunk->last_value].timestamp.sec >= timestamp)
+		if (vch_chunk_last(chunk)->timestamp.sec >= timestamp)
 		{
-			while (chunk->slots[chunk->first_value].timestamp.sec < timestamp)
-			{
-				vc_item_free_values(item, chunk->slots, chunk->first_value, chunk->first_value);
-				chunk->first_value++;
-			}
+			zbx_history_record_t	*slots = vch_chunk_slots(item, chunk);
+			int			first_value = chunk->first_value;
+
+			while (slots[first_value].timestamp.sec < timestamp)
+				first_value++;
+
+			vch_item_remove_first_values(item, chunk, slots, first_value);
 
 			break;
 		}
@@ -1773,12 +2389,13 @@ static void	vch_item_remove_values(zbx_vc_item_t *item, int timestamp)
 static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_record_t *value)
 {
 	int		ret = FAIL, index, sindex, nslots = 0;
-	zbx_vc_chunk_t	*chunk, *schunk;
+	zbx_vc_chunk_t	*chunk, *schunk, *head = item->head;
 
-	if (NULL != item->head &&
-			0 < zbx_history_record_compare_asc_func(&item->head->slots[item->head->last_value], value))
+	item->revision = ++vc_cache->revision;
+
+	if (NULL != item->head && 0 < zbx_history_record_compare_asc_func(vch_chunk_last(item->head), value))
 	{
-		if (0 < zbx_history_record_compare_asc_func(&item->tail->slots[item->tail->first_value], value))
+		if (0 < zbx_history_record_compare_asc_func(vch_chunk_first(item->tail), value))
 		{
 			/* If the added value has the same or older timestamp as the first value in cache */
 			/* we can't add it to keep cache consistency. Additionally we must make sure no   */
@@ -1799,6 +2416,17 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 			goto out;
 		}
 
+		/* values newer than the added value will be shifted, so their chunks (and the chunk */
+		/* where the shifting stops) must be unpacked                                       */
+		for (chunk = item->head; NULL != chunk; chunk = chunk->prev)
+		{
+			if (SUCCEED != vch_item_unpack_chunk(item, &chunk))
+				goto out;
+
+			if (0 >= zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &value->timestamp))
+				break;
+		}
+
 		sindex = item->head->last_value;
 		schunk = item->head;
 
@@ -1860,6 +2488,10 @@ static int	vch_item_add_value_at_head(zbx_vc_item_t *item, const zbx_history_rec
 	if (SUCCEED != vch_item_copy_value(item, chunk, index, value))
 		goto out;
 
+	/* the previous head chunk is full and will not be modified anymore */
+	if (NULL != head && head != item->head)
+		vch_item_pack_chunk(item, head);
+
 	ret = SUCCEED;
 out:
 	return ret;
@@ -1888,7 +2520,7 @@ static int	vch_item_add_values_at_tail(zbx_vc_item_t *item, const zbx_history_re
 	/* skip values already added to the item cache by another process */
 	if (NULL != item->tail)
 	{
-		int	sec = item->tail->slots[item->tail->first_value].timestamp.sec;
+		int	sec = vch_chunk_first(item->tail)->timestamp.sec;
 
 		while (--count >= 0 && values[count].timestamp.sec >= sec)
 			;
@@ -1900,7 +2532,7 @@ static int	vch_item_add_values_at_tail(zbx_vc_item_t *item, const zbx_history_re
 		int	copy_slots, nslots = 0;
 
 		/* find the number of free slots on the left side in first (tail) chunk */
-		if (NULL != item->tail)
+		if (NULL != item->tail && 0 == item->tail->packed_size)
 			nslots = item->tail->first_value;
 
 		if (0 == nslots)
@@ -1912,6 +2544,10 @@ static int	vch_item_add_values_at_tail(zbx_vc_item_t *item, const zbx_history_re
 
 			item->tail->last_value = nslots - 1;
 			item->tail->first_value = nslots;
+
+			/* the previous tail chunk will not be modified anymore unless it's the head chunk */
+			if (NULL != item->tail->next && item->tail->next != item->head)
+				vch_item_pack_chunk(item, item->tail->next);
 		}
 
 		/* copy values to chunk */
@@ -1959,7 +2595,7 @@ static int	vch_item_cache_values_by_time(zbx_vc_item_t **item, int range_start)
 	if (NULL != (*item)->tail)
 	{
 		/* we need to get item values before the first cached value, but not including it */
-		range_end = (*item)->tail->slots[(*item)->tail->first_value].timestamp.sec - 1;
+		range_end = vch_chunk_first((*item)->tail)->timestamp.sec - 1;
 	}
 	else
 		range_end = ZBX_JAN_2038;
@@ -1987,7 +2623,8 @@ static int	vch_item_cache_values_by_time(zbx_vc_item_t **item, int range_start)
 
 	if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
 	{
-		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type};
+		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type,
+				.revision = ++vc_cache->revision};
 
 		if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_insert(&vc_cache->items, &new_item,
 				sizeof(new_item))))
@@ -2050,10 +2687,11 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 	/* find if the cache should be updated to cover the required count */
 	if (NULL != (*item)->head)
 	{
-		zbx_vc_chunk_t	*chunk;
-		int		index;
+		zbx_vc_chunk_t		*chunk;
+		zbx_history_record_t	*slots;
+		int			index;
 
-		if (SUCCEED == vch_item_get_last_value(*item, ts, &chunk, &index))
+		if (SUCCEED == vch_item_get_last_value(*item, ts, &chunk, &slots, &index))
 		{
 			cached_records = index - chunk->first_value + 1;
 
@@ -2068,7 +2706,7 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 
 	/* get the end timestamp to which (including) the values should be cached */
 	if (NULL != (*item)->head)
-		range_end = (*item)->tail->slots[(*item)->tail->first_value].timestamp.sec - 1;
+		range_end = vch_chunk_first((*item)->tail)->timestamp.sec - 1;
 	else
 		range_end = ZBX_JAN_2038;
 
@@ -2100,7 +2738,8 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 
 	if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)))
 	{
-		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type};
+		zbx_vc_item_t	new_item = {.itemid = itemid, .value_type = value_type,
+				.revision = ++vc_cache->revision};
 
 		if (NULL == (*item = (zbx_vc_item_t *)zbx_hashset_insert(&vc_cache->items, &new_item, sizeof(new_item))))
 		{
@@ -2127,7 +2766,7 @@ static int	vch_item_cache_values_by_time_and_count(zbx_vc_item_t **item, int ran
 	if ((count <= records.values_num || 0 == range_start) && 0 != records.values_num)
 	{
 		vc_item_update_db_cached_from(*item,
-				(*item)->tail->slots[(*item)->tail->first_value].timestamp.sec);
+				vch_chunk_first((*item)->tail)->timestamp.sec);
 	}
 	else if (0 != range_start)
 		vc_item_update_db_cached_from(*item, range_start);
@@ -2152,9 +2791,10 @@ out:
 static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
 		const zbx_timespec_t *ts)
 {
-	int		index, now;
-	zbx_timespec_t	start = {ts->sec - seconds, ts->ns};
-	zbx_vc_chunk_t	*chunk;
+	int			index, now;
+	zbx_timespec_t		start = {ts->sec - seconds, ts->ns};
+	zbx_vc_chunk_t		*chunk;
+	zbx_history_record_t	*slots;
 
 	/* Check if maximum request range is not set and all data are cached.  */
 	/* Because that indicates there was a count based request with unknown */
@@ -2166,204 +2806,549 @@ static void	vch_item_get_values_by_time(const zbx_vc_item_t *item, zbx_vector_hi
 		vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_RANGE, seconds + now - ts->sec + 1, now);
 	}
 
-	if (FAIL == vch_item_get_last_value(item, ts, &chunk, &index))
+	if (FAIL == vch_item_get_last_value(item, ts, &chunk, &slots, &index))
+	{
+		/* Cache does not contain records for the specified timeshift & seconds range. */
+		/* Return empty vector with success.                                           */
+		return;
+	}
+
+	/* fill the values vector with item history values until the start timestamp is reached */
+	while (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &start))
+	{
+		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&slots[index].timestamp, &start))
+			vc_history_record_vector_append(values, item->value_type, &slots[index--]);
+
+		if (NULL == (chunk = chunk->prev))
+			break;
+
+		index = chunk->last_value;
+
+		/* don't unpack the chunk if it's outside the requested range */
+		if (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &start))
+			slots = vch_chunk_slots(item, chunk);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: retrieves item history data from cache                            *
+ *                                                                            *
+ * Parameters: item      - [IN] the item                                      *
+ *             values    - [OUT] the item history data stored time/value      *
+ *                         pairs in undefined order, optional                 *
+ *                         If null then cache is updated if necessary, but no *
+ *                         values are returned. Used to ensure that cache     *
+ *                         contains a value of the specified timestamp.       *
+ *             seconds   - [IN] the time period                               *
+ *             count     - [IN] the number of history values to retrieve      *
+ *             timestamp - [IN] the target timestamp                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vector_history_record_t *values,
+		int seconds, int count, const zbx_timespec_t *ts)
+{
+	int			index, now, range_timestamp;
+	zbx_vc_chunk_t		*chunk;
+	zbx_history_record_t	*slots;
+	zbx_timespec_t		start;
+
+	/* set start timestamp of the requested time period */
+	if (0 != seconds)
+	{
+		start.sec = ts->sec - seconds;
+		start.ns = ts->ns;
+	}
+	else
+	{
+		start.sec = 0;
+		start.ns = 0;
+	}
+
+	if (FAIL == vch_item_get_last_value(item, ts, &chunk, &slots, &index))
+	{
+		/* return empty vector with success */
+		goto out;
+	}
+
+	/* fill the values vector with item history values until the <count> values are read    */
+	/* or no more values within specified time period                                       */
+	/* fill the values vector with item history values until the start timestamp is reached */
+	while (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &start))
+	{
+		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&slots[index].timestamp, &start))
+		{
+			vc_history_record_vector_append(values, item->value_type, &slots[index--]);
+
+			if (values->values_num == count)
+				goto out;
+		}
+
+		if (NULL == (chunk = chunk->prev))
+			break;
+
+		index = chunk->last_value;
+
+		if (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &start))
+			slots = vch_chunk_slots(item, chunk);
+	}
+out:
+	if (count > values->values_num)
+	{
+		if (0 == seconds)
+			return;
+
+		/* not enough data in the requested period, set the range equal to the period plus */
+		/* one second to include nanosecond shifts                                         */
+		range_timestamp = ts->sec - seconds;
+	}
+	else
+	{
+		/* the requested number of values was retrieved, set the range to the oldest value timestamp */
+		range_timestamp = values->values[values->values_num - 1].timestamp.sec - 1;
+	}
+
+	now = (int)time(NULL);
+	vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_RANGE, now - range_timestamp, now);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get item values for the specified range                           *
+ *                                                                            *
+ * Parameters: item      - [IN] the item                                      *
+ *             values    - [OUT] the item history data stored time/value      *
+ *                         pairs in undefined order, optional                 *
+ *                         If null then cache is updated if necessary, but no *
+ *                         values are returned. Used to ensure that cache     *
+ *                         contains a value of the specified timestamp.       *
+ *             seconds   - [IN] the time period to retrieve data for          *
+ *             count     - [IN] the number of history values to retrieve      *
+ *             ts        - [IN] the target timestamp                          *
+ *                                                                            *
+ * Return value:  SUCCEED - the item history data was retrieved successfully  *
+ *                FAIL    - the item history data was not retrieved           *
+ *                                                                            *
+ * Comments: This function returns data from cache if necessary updating it   *
+ *           from DB. If cache update was required and failed (not enough     *
+ *           memory to cache DB values), then this function also fails.       *
+ *                                                                            *
+ *           If <count> is set then value range is defined as <count> values  *
+ *           before <timestamp>. Otherwise the range is defined as <seconds>  *
+ *           seconds before <timestamp>.                                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
+		int count, const zbx_timespec_t *ts)
+{
+	int	ret, records_read, hits, misses, range_start;
+
+	zbx_vector_history_record_clear(values);
+
+	if (0 == count)
+	{
+		if (0 > (range_start = ts->sec - seconds))
+			range_start = 0;
+
+		if (FAIL == (ret = vch_item_cache_values_by_time(&item, range_start)))
+			goto out;
+
+		records_read = ret;
+
+		vch_item_get_values_by_time(item, values, seconds, ts);
+
+		if (records_read > values->values_num)
+			records_read = values->values_num;
+	}
+	else
+	{
+		range_start = (0 == seconds ? 0 : ts->sec - seconds);
+
+		if (FAIL == (ret = vch_item_cache_values_by_time_and_count(&item, range_start, count, ts)))
+			goto out;
+
+		records_read = ret;
+
+		vch_item_get_values_by_time_and_count(item, values, seconds, count, ts);
+
+		if (records_read > values->values_num)
+			records_read = values->values_num;
+	}
+
+	hits = values->values_num - records_read;
+	misses = records_read;
+
+	vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_STATS, hits, misses);
+
+	ret = SUCCEED;
+out:
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: frees resources allocated for item history data                   *
+ *                                                                            *
+ * Parameters: item    - [IN] the item                                        *
+ *                                                                            *
+ * Return value: the size of freed memory (bytes)                             *
+ *                                                                            *
+ ******************************************************************************/
+static size_t	vch_item_free_cache(zbx_vc_item_t *item)
+{
+	size_t	freed = 0;
+
+	zbx_vc_chunk_t	*chunk = item->tail;
+
+	while (NULL != chunk)
+	{
+		zbx_vc_chunk_t	*next = chunk->next;
+
+		freed += vch_item_free_chunk(item, chunk);
+		chunk = next;
+	}
+	item->values_total = 0;
+	item->head = NULL;
+	item->tail = NULL;
+
+	if (NULL != item->windows)
+	{
+		__vc_shmem_free_func(item->windows);
+		item->windows = NULL;
+		freed += sizeof(zbx_vc_window_t) * ZBX_VC_WINDOWS_MAX;
+	}
+
+	return freed;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds value to time window aggregates                              *
+ *                                                                            *
+ * Parameters: window     - [IN/OUT] the time window                          *
+ *             value_type - [IN] the item value type (float or unsigned)      *
+ *             value      - [IN] the value to add                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	vc_window_add_value(zbx_vc_window_t *window, unsigned char value_type, const zbx_history_value_t *value)
+{
+	if (0 == window->values_num++)
+	{
+		window->sum = *value;
+		window->min = *value;
+		window->max = *value;
+		window->sum_overflows = 0;
+
+		return;
+	}
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		window->sum.dbl += value->dbl;
+
+		if (value->dbl < window->min.dbl)
+			window->min.dbl = value->dbl;
+		if (value->dbl > window->max.dbl)
+			window->max.dbl = value->dbl;
+	}
+	else
+	{
+		if ((window->sum.ui64 += value->ui64) < value->ui64)
+			window->sum_overflows++;
+
+		if (value->ui64 < window->min.ui64)
+			window->min.ui64 = value->ui64;
+		if (value->ui64 > window->max.ui64)
+			window->max.ui64 = value->ui64;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: removes value from time window aggregates                         *
+ *                                                                            *
+ * Parameters: window     - [IN/OUT] the time window                          *
+ *             value_type - [IN] the item value type (float or unsigned)      *
+ *             value      - [IN] the value to remove                          *
+ *                                                                            *
+ * Return value: SUCCEED - the value was removed                              *
+ *               FAIL    - the removed value was window minimum or maximum,   *
+ *                         the window must be recalculated                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	vc_window_remove_value(zbx_vc_window_t *window, unsigned char value_type,
+		const zbx_history_value_t *value)
+{
+	window->removed_num++;
+
+	if (0 == --window->values_num)
+	{
+		memset(&window->sum, 0, sizeof(window->sum));
+		window->sum_overflows = 0;
+
+		return SUCCEED;
+	}
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		window->sum.dbl -= value->dbl;
+
+		if (value->dbl == window->min.dbl || value->dbl == window->max.dbl)
+			return FAIL;
+	}
+	else
+	{
+		if (window->sum.ui64 < value->ui64)
+			window->sum_overflows--;
+
+		window->sum.ui64 -= value->ui64;
+
+		if (value->ui64 == window->min.ui64 || value->ui64 == window->max.ui64)
+			return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculates time window aggregates from cached item values         *
+ *                                                                            *
+ * Parameters: item   - [IN] the item                                         *
+ *             window - [IN/OUT] the time window                              *
+ *                                                                            *
+ * Comments: The window is left invalid (not calculated) if the cache does    *
+ *           not contain all values of the time window.                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_calculate_window(const zbx_vc_item_t *item, zbx_vc_window_t *window)
+{
+	zbx_timespec_t		start;
+	zbx_vc_chunk_t		*chunk;
+	zbx_history_record_t	*slots;
+	int			index;
+
+	window->values_num = -1;
+	window->removed_num = 0;
+
+	if (NULL == (chunk = item->head))
+		return;
+
+	window->last = vch_chunk_last(chunk)->timestamp;
+	start.sec = window->last.sec - window->seconds;
+	start.ns = window->last.ns;
+
+	if (ZBX_ITEM_STATUS_CACHED_ALL != item->status &&
+			(0 == item->db_cached_from || start.sec < item->db_cached_from))
 	{
-		/* Cache does not contain records for the specified timeshift & seconds range. */
-		/* Return empty vector with success.                                           */
 		return;
 	}
 
-	/* fill the values vector with item history values until the start timestamp is reached */
-	while (0 < zbx_timespec_compare(&chunk->slots[chunk->last_value].timestamp, &start))
+	window->values_num = 0;
+	slots = vch_chunk_slots(item, chunk);
+	index = chunk->last_value;
+
+	/* add values from the newest to the oldest, the same order as time period requests return them */
+	while (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &start))
 	{
-		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&chunk->slots[index].timestamp, &start))
-			vc_history_record_vector_append(values, item->value_type, &chunk->slots[index--]);
+		for (; index >= chunk->first_value && 0 < zbx_timespec_compare(&slots[index].timestamp, &start);
+				index--)
+		{
+			vc_window_add_value(window, item->value_type, &slots[index].value);
+			window->first = slots[index].timestamp;
+		}
 
 		if (NULL == (chunk = chunk->prev))
 			break;
 
 		index = chunk->last_value;
+
+		if (0 < zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &start))
+			slots = vch_chunk_slots(item, chunk);
 	}
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: retrieves item history data from cache                            *
+ * Purpose: moves time window to include a new value added at item head       *
  *                                                                            *
- * Parameters: item      - [IN] the item                                      *
- *             values    - [OUT] the item history data stored time/value      *
- *                         pairs in undefined order, optional                 *
- *                         If null then cache is updated if necessary, but no *
- *                         values are returned. Used to ensure that cache     *
- *                         contains a value of the specified timestamp.       *
- *             seconds   - [IN] the time period                               *
- *             count     - [IN] the number of history values to retrieve      *
- *             timestamp - [IN] the target timestamp                          *
+ * Parameters: item   - [IN] the item                                         *
+ *             window - [IN/OUT] the time window                              *
+ *             value  - [IN] the new value                                    *
  *                                                                            *
  ******************************************************************************/
-static void	vch_item_get_values_by_time_and_count(zbx_vc_item_t *item, zbx_vector_history_record_t *values,
-		int seconds, int count, const zbx_timespec_t *ts)
+static void	vch_item_move_window(const zbx_vc_item_t *item, zbx_vc_window_t *window,
+		const zbx_history_record_t *value)
 {
-	int		index, now, range_timestamp;
-	zbx_vc_chunk_t	*chunk;
-	zbx_timespec_t	start;
+	zbx_timespec_t		start, first;
+	zbx_vc_chunk_t		*chunk;
+	zbx_history_record_t	*slots;
+	int			index;
 
-	/* set start timestamp of the requested time period */
-	if (0 != seconds)
-	{
-		start.sec = ts->sec - seconds;
-		start.ns = ts->ns;
-	}
-	else
+	vc_window_add_value(window, item->value_type, &value->value);
+	window->last = value->timestamp;
+
+	if (1 == window->values_num)
 	{
-		start.sec = 0;
-		start.ns = 0;
+		window->first = value->timestamp;
+		return;
 	}
 
-	if (FAIL == vch_item_get_last_value(item, ts, &chunk, &index))
+	start.sec = window->last.sec - window->seconds;
+	start.ns = window->last.ns;
+
+	if (0 < zbx_timespec_compare(&window->first, &start))
+		return;
+
+	/* remove values from the oldest window value up to the new window start */
+
+	if (FAIL == vch_item_get_last_value(item, &start, &chunk, &slots, &index))
 	{
-		/* return empty vector with success */
-		goto out;
+		vch_item_calculate_window(item, window);
+		return;
 	}
 
-	/* fill the values vector with item history values until the <count> values are read    */
-	/* or no more values within specified time period                                       */
-	/* fill the values vector with item history values until the start timestamp is reached */
-	while (0 < zbx_timespec_compare(&chunk->slots[chunk->last_value].timestamp, &start))
+	if (index < chunk->last_value)
+		first = slots[index + 1].timestamp;
+	else
+		first = vch_chunk_first(chunk->next)->timestamp;
+
+	for (;;)
 	{
-		while (index >= chunk->first_value && 0 < zbx_timespec_compare(&chunk->slots[index].timestamp, &start))
+		for (; index >= chunk->first_value &&
+				0 <= zbx_timespec_compare(&slots[index].timestamp, &window->first); index--)
 		{
-			vc_history_record_vector_append(values, item->value_type, &chunk->slots[index--]);
-
-			if (values->values_num == count)
-				goto out;
+			if (SUCCEED != vc_window_remove_value(window, item->value_type, &slots[index].value))
+			{
+				vch_item_calculate_window(item, window);
+				return;
+			}
 		}
 
-		if (NULL == (chunk = chunk->prev))
+		if (index >= chunk->first_value || NULL == (chunk = chunk->prev) ||
+				0 > zbx_timespec_compare(&vch_chunk_last(chunk)->timestamp, &window->first))
+		{
 			break;
+		}
 
+		slots = vch_chunk_slots(item, chunk);
 		index = chunk->last_value;
 	}
-out:
-	if (count > values->values_num)
-	{
-		if (0 == seconds)
-			return;
 
-		/* not enough data in the requested period, set the range equal to the period plus */
-		/* one second to include nanosecond shifts                                         */
-		range_timestamp = ts->sec - seconds;
-	}
-	else
-	{
-		/* the requested number of values was retrieved, set the range to the oldest value timestamp */
-		range_timestamp = values->values[values->values_num - 1].timestamp.sec - 1;
-	}
+	window->first = first;
 
-	now = (int)time(NULL);
-	vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_RANGE, now - range_timestamp, now);
+	if (window->removed_num > window->values_num)
+		vch_item_calculate_window(item, window);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: get item values for the specified range                           *
- *                                                                            *
- * Parameters: item      - [IN] the item                                      *
- *             values    - [OUT] the item history data stored time/value      *
- *                         pairs in undefined order, optional                 *
- *                         If null then cache is updated if necessary, but no *
- *                         values are returned. Used to ensure that cache     *
- *                         contains a value of the specified timestamp.       *
- *             seconds   - [IN] the time period to retrieve data for          *
- *             count     - [IN] the number of history values to retrieve      *
- *             ts        - [IN] the target timestamp                          *
- *                                                                            *
- * Return value:  SUCCEED - the item history data was retrieved successfully  *
- *                FAIL    - the item history data was not retrieved           *
- *                                                                            *
- * Comments: This function returns data from cache if necessary updating it   *
- *           from DB. If cache update was required and failed (not enough     *
- *           memory to cache DB values), then this function also fails.       *
+ * Purpose: updates item time windows after a value was added to item         *
  *                                                                            *
- *           If <count> is set then value range is defined as <count> values  *
- *           before <timestamp>. Otherwise the range is defined as <seconds>  *
- *           seconds before <timestamp>.                                      *
+ * Parameters: item     - [IN] the item                                       *
+ *             value    - [IN] the added value                                *
+ *             appended - [IN] SUCCEED - the value was added after all cached *
+ *                                       values                               *
+ *                             FAIL    - the value was inserted between       *
+ *                                       cached values or dropped             *
+ *             now      - [IN] the current time                               *
  *                                                                            *
  ******************************************************************************/
-static int	vch_item_get_values(zbx_vc_item_t *item, zbx_vector_history_record_t *values, int seconds,
-		int count, const zbx_timespec_t *ts)
+static void	vch_item_update_windows(zbx_vc_item_t *item, const zbx_history_record_t *value, int appended,
+		int now)
 {
-	int	ret, records_read, hits, misses, range_start;
-
-	zbx_vector_history_record_clear(values);
+	int	i;
 
-	if (0 == count)
+	for (i = 0; i < ZBX_VC_WINDOWS_MAX; i++)
 	{
-		if (0 > (range_start = ts->sec - seconds))
-			range_start = 0;
+		zbx_vc_window_t	*window = &item->windows[i];
 
-		if (FAIL == (ret = vch_item_cache_values_by_time(&item, range_start)))
-			goto out;
+		if (0 == window->seconds)
+			continue;
 
-		records_read = ret;
+		if (window->last_accessed < now - ZBX_VC_WINDOW_EXPIRE_PERIOD)
+		{
+			window->seconds = 0;
+			continue;
+		}
 
-		vch_item_get_values_by_time(item, values, seconds, ts);
+		/* the oldest window values might have been dropped from cache */
+		if (0 < window->values_num && NULL != item->tail &&
+				0 > zbx_timespec_compare(&window->first, &vch_chunk_first(item->tail)->timestamp))
+		{
+			window->values_num = -1;
+		}
 
-		if (records_read > values->values_num)
-			records_read = values->values_num;
+		if (SUCCEED != appended || 0 > window->values_num)
+			vch_item_calculate_window(item, window);
+		else
+			vch_item_move_window(item, window, value);
 	}
-	else
-	{
-		range_start = (0 == seconds ? 0 : ts->sec - seconds);
+}
 
-		if (FAIL == (ret = vch_item_cache_values_by_time_and_count(&item, range_start, count, ts)))
-			goto out;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: marks item time window as requested, adding it if necessary       *
+ *                                                                            *
+ * Parameters: item    - [IN] the item                                        *
+ *             seconds - [IN] the window length                               *
+ *             now     - [IN] the current time                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	vch_item_touch_window(zbx_vc_item_t *item, int seconds, int now)
+{
+	zbx_vc_window_t	*window = NULL;
+	int		i;
 
-		records_read = ret;
+	if (NULL == item->windows)
+	{
+		size_t	size = sizeof(zbx_vc_window_t) * ZBX_VC_WINDOWS_MAX;
 
-		vch_item_get_values_by_time_and_count(item, values, seconds, count, ts);
+		if (NULL == (item->windows = (zbx_vc_window_t *)vc_item_malloc(item, size)))
+			return;
 
-		if (records_read > values->values_num)
-			records_read = values->values_num;
+		memset(item->windows, 0, size);
 	}
 
-	hits = values->values_num - records_read;
-	misses = records_read;
+	for (i = 0; i < ZBX_VC_WINDOWS_MAX; i++)
+	{
+		if (seconds == item->windows[i].seconds)
+		{
+			item->windows[i].last_accessed = now;
+			return;
+		}
 
-	vc_cache_item_update(item->itemid, ZBX_VC_UPDATE_STATS, hits, misses);
+		if (NULL == window && 0 == item->windows[i].seconds)
+			window = &item->windows[i];
+	}
 
-	ret = SUCCEED;
-out:
-	return ret;
+	if (NULL == window)
+		return;
+
+	window->seconds = seconds;
+	window->last_accessed = now;
+	vch_item_calculate_window(item, window);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: frees resources allocated for item history data                   *
- *                                                                            *
- * Parameters: item    - [IN] the item                                        *
- *                                                                            *
- * Return value: the size of freed memory (bytes)                             *
+ * Purpose: finds item time window                                            *
  *                                                                            *
  ******************************************************************************/
-static size_t	vch_item_free_cache(zbx_vc_item_t *item)
+static const zbx_vc_window_t	*vch_item_get_window(const zbx_vc_item_t *item, int seconds)
 {
-	size_t	freed = 0;
+	int	i;
 
-	zbx_vc_chunk_t	*chunk = item->tail;
+	if (NULL == item->windows)
+		return NULL;
 
-	while (NULL != chunk)
+	for (i = 0; i < ZBX_VC_WINDOWS_MAX; i++)
 	{
-		zbx_vc_chunk_t	*next = chunk->next;
-
-		freed += vch_item_free_chunk(item, chunk);
-		chunk = next;
+		if (seconds == item->windows[i].seconds)
+			return &item->windows[i];
 	}
-	item->values_total = 0;
-	item->head = NULL;
-	item->tail = NULL;
 
-	return freed;
+	return NULL;
 }
 
 /******************************************************************************************************************
@@ -2376,8 +3361,13 @@ static size_t	vch_item_free_cache(zbx_vc_item_t *item)
  *                                                                            *
  * Purpose: initializes value cache                                           *
  *                                                                            *
+ * Parameters: value_cache_size - [IN] the value cache size                   *
+ *             compression      - [IN] the numeric value storage mode, see    *
+ *                                     ZBX_VC_COMPRESSION_* defines           *
+ *             error            - [OUT] the error message                     *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error)
+int	zbx_vc_init(zbx_uint64_t value_cache_size, int compression, char **error)
 {
 	zbx_uint64_t	size_reserved;
 	int		ret = FAIL;
@@ -2398,6 +3388,8 @@ int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error)
 		goto out;
 	}
 
+	zbx_shmem_enable_slabs(vc_mem);
+
 	value_cache_size -= size_reserved;
 
 	vc_cache = (zbx_vc_cache_t *)__vc_shmem_malloc_func(vc_cache, sizeof(zbx_vc_cache_t));
@@ -2408,6 +3400,7 @@ int	zbx_vc_init(zbx_uint64_t value_cache_size, char **error)
 		goto out;
 	}
 	memset(vc_cache, 0, sizeof(zbx_vc_cache_t));
+	vc_cache->compression = compression;
 
 	zbx_hashset_create_ext(&vc_cache->items, VC_ITEMS_INIT_SIZE,
 			ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC, NULL,
@@ -2470,6 +3463,11 @@ void	zbx_vc_destroy(void)
 		zbx_rwlock_destroy(&vc_lock);
 	}
 
+	zbx_free(vc_pack_stream.data);
+	vc_pack_stream.data_alloc = 0;
+	zbx_free(vc_unpack_buf);
+	vc_unpack_alloc = 0;
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -2525,7 +3523,7 @@ void	zbx_vc_reset(void)
 int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 {
 	zbx_vc_item_t		*item;
-	int			i;
+	int			i, now;
 	zbx_dc_history_t	*h;
 
 	if (SUCCEED != zbx_history_add_values(history, ret_flush))
@@ -2534,6 +3532,8 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 	if (ZBX_VC_DISABLED == vc_state)
 		return SUCCEED;
 
+	now = (int)time(NULL);
+
 	WRLOCK_CACHE;
 
 	for (i = 0; i < history->values_num; i++)
@@ -2544,12 +3544,20 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 		{
 			zbx_history_record_t	record = {h->ts, h->value};
 			zbx_vc_chunk_t		*head = item->head;
-			int			last_value_timestamp;
+			int			last_value_timestamp, appended = SUCCEED;
 
 			if (NULL != head)
-				last_value_timestamp = head->slots[head->last_value].timestamp.sec;
+			{
+				last_value_timestamp = vch_chunk_last(head)->timestamp.sec;
+
+				if (0 < zbx_history_record_compare_asc_func(vch_chunk_last(head), &record))
+					appended = FAIL;
+			}
 			else
-				last_value_timestamp = (int)time(NULL);
+			{
+				last_value_timestamp = now;
+				appended = FAIL;
+			}
 
 			/* If the new value type does not match the item's type in cache remove it, */
 			/* so it's cached with the correct type from correct tables when accessed   */
@@ -2566,6 +3574,9 @@ int	zbx_vc_add_values(zbx_vector_ptr_t *history, int *ret_flush)
 			/* try to remove old (unused) chunks if a new chunk was added */
 			if (head != item->head)
 				vch_item_clean_cache(item, last_value_timestamp);
+
+			if (NULL != item->windows)
+				vch_item_update_windows(item, &record, appended, now);
 		}
 	}
 
@@ -2693,6 +3704,143 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get history revisions and last value timestamps of items          *
+ *                                                                            *
+ * Parameters: revisions     - [IN/OUT] the items with itemid set             *
+ *             revisions_num - [IN] the number of items                       *
+ *                                                                            *
+ * Comments: The revision is changed whenever values are added to the item,   *
+ *           so while it stays the same the item history is not changed.      *
+ *           Revision is set to 0 for items that are not cached or have no    *
+ *           values. All revisions are read under a single cache lock.        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_vc_get_items_revisions(zbx_vc_item_revision_t *revisions, int revisions_num)
+{
+	zbx_vc_item_t	*item;
+	int		i;
+
+	for (i = 0; i < revisions_num; i++)
+		revisions[i].revision = 0;
+
+	if (ZBX_VC_DISABLED == vc_state || 0 == revisions_num)
+		return;
+
+	RDLOCK_CACHE;
+
+	for (i = 0; i < revisions_num; i++)
+	{
+		if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &revisions[i].itemid)) ||
+				NULL == item->head)
+		{
+			continue;
+		}
+
+		revisions[i].revision = item->revision;
+		revisions[i].ts = vch_chunk_last(item->head)->timestamp;
+	}
+
+	UNLOCK_CACHE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get aggregates of item values for the specified time period       *
+ *                                                                            *
+ * Parameters: itemid     - [IN] the item id                                  *
+ *             value_type - [IN] the item value type                          *
+ *             seconds    - [IN] the time period length                       *
+ *             ts         - [IN] the period end timestamp                     *
+ *             aggregate  - [OUT] the value aggregates                        *
+ *                                                                            *
+ * Return value: SUCCEED - the aggregates were returned                       *
+ *               FAIL    - the period aggregates are not available, values    *
+ *                         must be retrieved with zbx_vc_get_values()         *
+ *                                                                            *
+ * Comments: Running aggregates are kept for the requested time periods of    *
+ *           numeric items and are updated when values are added to cache.    *
+ *           The first request of a period adds it to the item, so the        *
+ *           aggregates are available starting with the next request.         *
+ *                                                                            *
+ *           The aggregates are kept for periods ending with the newest item  *
+ *           value. They are returned if the requested period selects the     *
+ *           same values - there are no values after the newest value and     *
+ *           the oldest value is inside the requested period.                 *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_vc_get_aggregate(zbx_uint64_t itemid, unsigned char value_type, int seconds, const zbx_timespec_t *ts,
+		zbx_vc_aggregate_t *aggregate)
+{
+	zbx_vc_item_t		*item;
+	const zbx_vc_window_t	*window;
+	zbx_timespec_t		start = {ts->sec - seconds, ts->ns};
+	int			now, ret = FAIL;
+
+	if (ZBX_VC_DISABLED == vc_state || 0 >= seconds)
+		return FAIL;
+
+	if (ITEM_VALUE_TYPE_FLOAT != value_type && ITEM_VALUE_TYPE_UINT64 != value_type)
+		return FAIL;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() itemid:" ZBX_FS_UI64 " period:%d end_timestamp '%s'", __func__, itemid,
+			seconds, zbx_timespec_str(ts));
+
+	now = (int)time(NULL);
+
+	RDLOCK_CACHE;
+
+	if (NULL == (item = (zbx_vc_item_t *)zbx_hashset_search(&vc_cache->items, &itemid)) ||
+			item->value_type != value_type)
+	{
+		goto out;
+	}
+
+	vc_cache_item_update(itemid, ZBX_VC_UPDATE_WINDOW, seconds, now);
+
+	if (NULL == (window = vch_item_get_window(item, seconds)) || 0 > window->values_num ||
+			0 > zbx_timespec_compare(ts, &window->last))
+	{
+		goto out;
+	}
+
+	if (0 != window->values_num && 0 >= zbx_timespec_compare(&window->first, &start))
+		goto out;
+
+	/* the unsigned average is calculated from sum, which must not overflow */
+	if (0 != window->sum_overflows)
+		goto out;
+
+	memset(aggregate, 0, sizeof(zbx_vc_aggregate_t));
+
+	if (0 != (aggregate->values_num = window->values_num))
+	{
+		aggregate->sum = window->sum;
+		aggregate->min = window->min;
+		aggregate->max = window->max;
+
+		if (ITEM_VALUE_TYPE_FLOAT == value_type)
+			aggregate->avg = window->sum.dbl / window->values_num;
+		else
+			aggregate->avg = (double)window->sum.ui64 / window->values_num;
+	}
+
+	/* keep the period values cached in the same way as time period requests do */
+	if (0 != item->active_range || ZBX_ITEM_STATUS_CACHED_ALL != item->status)
+		vc_cache_item_update(itemid, ZBX_VC_UPDATE_RANGE, seconds + now - ts->sec + 1, now);
+
+	vc_cache_item_update(itemid, ZBX_VC_UPDATE_STATS, window->values_num, 0);
+
+	ret = SUCCEED;
+out:
+	UNLOCK_CACHE;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
+
+	return ret;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: retrieves usage cache statistics                                  *
@@ -2867,6 +4015,10 @@ void	zbx_vc_flush_stats(void)
 				vc_update_statistics(item, update->data[ZBX_VC_UPDATE_STATS_HITS],
 						update->data[ZBX_VC_UPDATE_STATS_MISSES], now);
 				break;
+			case ZBX_VC_UPDATE_WINDOW:
+				vch_item_touch_window(item, update->data[ZBX_VC_UPDATE_WINDOW_SECONDS],
+						update->data[ZBX_VC_UPDATE_WINDOW_NOW]);
+				break;
 		}
 	}
 
@@ -807,18 +807,41 @@ int	zbx_tcp_send_context_init(const char *data, size_t len, size_t reserved, uns
 		return FAIL;
 	}
 
+	/* pre-compressed data must be compressed with the codec specified by flags, */
+	/* otherwise fall back to zlib if the requested codec is not available      */
+	if (0 == (flags & ZBX_TCP_COMPRESS) || (0 == reserved &&
+			SUCCEED != zbx_compress_codec_supported(zbx_tcp_compress_codec(flags))))
+	{
+		flags &= (unsigned char)~ZBX_TCP_COMPRESS_CODECS;
+	}
+
 	if (0 != (flags & ZBX_TCP_COMPRESS))
 	{
 		/* compress if not compressed yet */
 		if (0 == reserved)
 		{
-			if (SUCCEED != zbx_compress(data, len, &context->compressed_data, &context->send_len))
+			int	codec = zbx_tcp_compress_codec(flags);
+			double	time_start = 0;
+
+			if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
+				time_start = zbx_time();
+
+			if (SUCCEED != zbx_compress_ext(codec, data, len, &context->compressed_data,
+					&context->send_len))
 			{
 				zbx_set_socket_strerror("cannot compress data: %s", zbx_compress_strerror());
 
 				return FAIL;
 			}
 
+			if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
+			{
+				zabbix_log(LOG_LEVEL_TRACE, "%s(): compressed " ZBX_FS_SIZE_T " bytes with %s"
+						" compression ratio %.1f in " ZBX_FS_DBL " sec", __func__,
+						(zbx_fs_size_t)len, zbx_compress_codec_name(codec),
+						(double)len / (double)context->send_len, zbx_time() - time_start);
+			}
+
 			context->data = context->compressed_data;
 			reserved = len;
 		}
@@ -952,6 +975,10 @@ int	zbx_tcp_send_ext(zbx_socket_t *s, const char *data, size_t len, size_t reser
 	if (0 != timeout)
 		zbx_socket_set_deadline(s, timeout);
 
+	/* peer has sent data compressed with the codec, so it can also receive it */
+	if (0 == reserved && 0 == (flags & ZBX_TCP_COMPRESS_CODECS))
+		flags |= (s->protocol & ZBX_TCP_COMPRESS_CODECS);
+
 	if (SUCCEED == (ret = zbx_tcp_send_context_init(data, len, reserved, flags, &context)))
 	{
 		ret = zbx_tcp_send_context(s, &context, NULL);
@@ -1545,10 +1572,9 @@ void	zbx_tcp_unlisten(zbx_socket_t *s)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: permits an incoming connection attempt on a socket                *
+ * Purpose: accepts an incoming connection without waiting for data           *
  *                                                                            *
  * Parameters: s              - [IN/OUT] socket to listen                     *
- *             tls_accept     - [IN] TLS configuration                        *
  *             poll_timeout   - [IN] milliseconds to wait for connection      *
  *                                  (0 - don't wait, -1 - wait forever        *
  *                                                                            *
@@ -1556,15 +1582,16 @@ void	zbx_tcp_unlisten(zbx_socket_t *s)
  *               FAIL          - an error occurred                            *
  *               TIMEOUT_ERROR - no connections for the timeout period        *
  *                                                                            *
+ * Comments: The connection type must be established with                     *
+ *           zbx_tcp_accept_handshake() before exchanging data.               *
+ *                                                                            *
  ******************************************************************************/
-int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
+int	zbx_tcp_accept_connection(zbx_socket_t *s, int poll_timeout)
 {
 	ZBX_SOCKADDR	serv_addr;
 	ZBX_SOCKET	accepted_socket;
 	ZBX_SOCKLEN_T	nlen;
 	int		i, ret = FAIL;
-	ssize_t		res;
-	char		buf;	/* 1 byte buffer */
 	zbx_pollfd_t	*pds;
 
 	zbx_tcp_unaccept(s);
@@ -1593,6 +1620,8 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
 		goto out;
 	}
 
+	ret = FAIL;
+
 	for (i = 0; i < s->num_socks; i++)
 	{
 		if (0 != (pds[i].revents & POLLIN))
@@ -1641,14 +1670,66 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
 		goto out;
 	}
 
-	zbx_socket_set_deadline(s, s->timeout);
+	ret = SUCCEED;
+out:
+	zbx_free(pds);
 
-	if (FAIL == (res = tcp_peek(s, &buf, 1)) || TIMEOUT_ERROR == res)
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: establishes type of accepted connection                           *
+ *                                                                            *
+ * Parameters: s          - [IN/OUT] accepted socket                          *
+ *             tls_accept - [IN] TLS configuration                            *
+ *             event      - [OUT] poll event to wait for before calling       *
+ *                                again, used in non-blocking mode only       *
+ *                                (can be NULL)                               *
+ *                                                                            *
+ * Return value: SUCCEED - success                                            *
+ *               FAIL    - an error occurred, the connection is closed, or,   *
+ *                         if event is set, the handshake must be continued   *
+ *                         when the socket is ready                           *
+ *                                                                            *
+ * Comments: Waits for the first byte and performs TLS handshake if it        *
+ *           starts a TLS connection.                                         *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_accept_handshake(zbx_socket_t *s, unsigned int tls_accept, short *event)
+{
+	ssize_t	res;
+	char	buf;	/* 1 byte buffer */
+
+	if (NULL == event)
+	{
+		zbx_socket_set_deadline(s, s->timeout);
+		res = tcp_peek(s, &buf, 1);
+	}
+#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
+	else if (NULL != s->tls_ctx)
+	{
+		/* continue TLS handshake */
+		buf = '\x16';
+		res = 1;
+	}
+#endif
+	else if (0 > (res = ZBX_TCP_RECV(s->socket, &buf, 1, MSG_PEEK)) &&
+			SUCCEED == zbx_socket_had_nonblocking_error())
+	{
+		*event = POLLIN;
+		return FAIL;
+	}
+
+	if (NULL != event)
+		*event = 0;
+
+	if (FAIL == res || TIMEOUT_ERROR == res)
 	{
 		zbx_set_socket_strerror("from %s: reading first byte from connection failed: %s", s->peer,
 				zbx_strerror_from_system(zbx_socket_last_error()));
 		zbx_tcp_unaccept(s);
-		goto out;
+		return FAIL;
 	}
 
 	/* if the 1st byte is 0x16 then assume it's a TLS connection */
@@ -1659,24 +1740,27 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
 		{
 			char	*error = NULL;
 
-			if (SUCCEED != zbx_tls_accept(s, tls_accept, &error))
+			if (SUCCEED != zbx_tls_accept(s, tls_accept, event, &error))
 			{
+				if (NULL != event && 0 != *event)
+					return FAIL;
+
 				zbx_set_socket_strerror("from %s: %s", s->peer, error);
 				zbx_tcp_unaccept(s);
 				zbx_free(error);
-				goto out;
+				return FAIL;
 			}
 		}
 		else
 		{
 			zbx_set_socket_strerror("from %s: TLS connections are not allowed", s->peer);
 			zbx_tcp_unaccept(s);
-			goto out;
+			return FAIL;
 		}
 #else
 		zbx_set_socket_strerror("from %s: support for TLS was not compiled in", s->peer);
 		zbx_tcp_unaccept(s);
-		goto out;
+		return FAIL;
 #endif
 	}
 	else
@@ -1685,7 +1769,7 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
 		{
 			zbx_set_socket_strerror("from %s: unencrypted connections are not allowed", s->peer);
 			zbx_tcp_unaccept(s);
-			goto out;
+			return FAIL;
 		}
 
 		s->connection_type = ZBX_TCP_SEC_UNENCRYPTED;
@@ -1693,11 +1777,31 @@ int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
 
 	zbx_socket_set_deadline(s, 0);
 
-	ret = SUCCEED;
-out:
-	zbx_free(pds);
+	return SUCCEED;
+}
 
-	return ret;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: permits an incoming connection attempt on a socket                *
+ *                                                                            *
+ * Parameters: s              - [IN/OUT] socket to listen                     *
+ *             tls_accept     - [IN] TLS configuration                        *
+ *             poll_timeout   - [IN] milliseconds to wait for connection      *
+ *                                  (0 - don't wait, -1 - wait forever        *
+ *                                                                            *
+ * Return value: SUCCEED       - success                                      *
+ *               FAIL          - an error occurred                            *
+ *               TIMEOUT_ERROR - no connections for the timeout period        *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_accept(zbx_socket_t *s, unsigned int tls_accept, int poll_timeout)
+{
+	int	ret;
+
+	if (SUCCEED != (ret = zbx_tcp_accept_connection(s, poll_timeout)))
+		return ret;
+
+	return zbx_tcp_accept_handshake(s, tls_accept, NULL);
 }
 
 /******************************************************************************
@@ -1947,6 +2051,7 @@ void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv
 	tcp_recv_context->expected_len = 16 * ZBX_MEBIBYTE;
 	tcp_recv_context->reserved = 0;
 	tcp_recv_context->expect = ZBX_TCP_EXPECT_HEADER;
+	tcp_recv_context->stream = NULL;
 #if defined(_WINDOWS)
 	tcp_recv_context->max_len = ZBX_MAX_RECV_DATA_SIZE;
 #else
@@ -1959,13 +2064,102 @@ void	zbx_tcp_recv_context_init(zbx_socket_t *s, zbx_tcp_recv_context_t *tcp_recv
 	s->buffer = s->buf_stat;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compression codec specified by protocol flags                 *
+ *                                                                            *
+ * Parameters: flags - [IN] the protocol flags (ZBX_TCP_*)                    *
+ *                                                                            *
+ * Return value: the compression codec (ZBX_COMPRESS_*)                       *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_tcp_compress_codec(unsigned char flags)
+{
+	if (0 != (flags & ZBX_TCP_COMPRESS_ZSTD))
+		return ZBX_COMPRESS_ZSTD;
+
+	if (0 != (flags & ZBX_TCP_COMPRESS_LZ4))
+		return ZBX_COMPRESS_LZ4;
+
+	return ZBX_COMPRESS_ZLIB;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get protocol flags of compression codec                           *
+ *                                                                            *
+ * Parameters: codec - [IN] the compression codec (ZBX_COMPRESS_*)            *
+ *                                                                            *
+ * Return value: the protocol flags (ZBX_TCP_COMPRESS and codec flag)         *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_tcp_compress_codec_flags(int codec)
+{
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZSTD:
+			return ZBX_TCP_COMPRESS | ZBX_TCP_COMPRESS_ZSTD;
+		case ZBX_COMPRESS_LZ4:
+			return ZBX_TCP_COMPRESS | ZBX_TCP_COMPRESS_LZ4;
+		default:
+			return ZBX_TCP_COMPRESS;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compression codec of received message                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	tcp_recv_codec(const zbx_tcp_recv_context_t *context)
+{
+	return zbx_tcp_compress_codec(context->protocol_version);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free resources of unfinished message receiving                    *
+ *                                                                            *
+ * Comments: Must be called when non-blocking receiving is abandoned before   *
+ *           the whole message is received.                                   *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_tcp_recv_context_clear(zbx_tcp_recv_context_t *tcp_recv_context)
+{
+	if (NULL != tcp_recv_context->stream)
+	{
+		zbx_uncompress_stream_close(tcp_recv_context->stream, NULL, NULL);
+		tcp_recv_context->stream = NULL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: receive message                                                   *
+ *                                                                            *
+ * Return value: number of bytes received - success,                          *
+ *               FAIL - an error occurred                                     *
+ *                                                                            *
+ * Comments: Large compressed messages are uncompressed while being received, *
+ *           so only the uncompressed message is kept in memory. In           *
+ *           non-blocking mode (events is not NULL) the uncompression state   *
+ *           is kept in context between calls.                                *
+ *                                                                            *
+ ******************************************************************************/
 ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, unsigned char flags, short *events)
 {
-	ssize_t	nbytes;
+	ssize_t			nbytes;
+	unsigned char		protocol_accept = ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS | flags;
 
 	if (NULL != events)
 		*events = 0;
 
+	if (SUCCEED == zbx_compress_codec_supported(ZBX_COMPRESS_ZSTD))
+		protocol_accept |= ZBX_TCP_COMPRESS_ZSTD;
+
+	if (SUCCEED == zbx_compress_codec_supported(ZBX_COMPRESS_LZ4))
+		protocol_accept |= ZBX_TCP_COMPRESS_LZ4;
+
 	while (0 != (nbytes = zbx_tcp_read(s, s->buf_stat + context->buf_stat_bytes,
 			sizeof(s->buf_stat) - context->buf_stat_bytes, events)))
 	{
@@ -1977,7 +2171,19 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 		else
 		{
 			if (context->buf_dyn_bytes + (size_t)nbytes <= context->expected_len)
-				memcpy(s->buffer + context->buf_dyn_bytes, s->buf_stat, (size_t)nbytes);
+			{
+				if (NULL == context->stream)
+				{
+					memcpy(s->buffer + context->buf_dyn_bytes, s->buf_stat, (size_t)nbytes);
+				}
+				else if (FAIL == zbx_uncompress_stream_write(context->stream, s->buf_stat,
+						(size_t)nbytes))
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+			}
 			context->buf_dyn_bytes += (size_t)nbytes;
 		}
 
@@ -2008,6 +2214,8 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 
 		if (ZBX_TCP_EXPECT_VERSION == context->expect)
 		{
+			unsigned char	codecs;
+
 			if (context->offset + 1 > context->buf_stat_bytes)
 				continue;
 
@@ -2015,11 +2223,20 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 			context->protocol_version = s->buf_stat[ZBX_TCP_HEADER_LEN];
 
 			if (0 == (context->protocol_version & ZBX_TCP_PROTOCOL) ||
-					context->protocol_version > (ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS | flags))
+					0 != (context->protocol_version & ~protocol_accept))
 			{
 				/* invalid protocol version, abort receiving */
 				break;
 			}
+
+			codecs = context->protocol_version & ZBX_TCP_COMPRESS_CODECS;
+
+			if (0 != codecs && (0 == (context->protocol_version & ZBX_TCP_COMPRESS) ||
+					ZBX_TCP_COMPRESS_CODECS == codecs))
+			{
+				/* compression codec without compression or multiple codecs, abort receiving */
+				break;
+			}
 			s->protocol = context->protocol_version;
 			context->expect = ZBX_TCP_EXPECT_LENGTH;
 			context->offset++;
@@ -2087,6 +2304,24 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 				context->buf_stat_bytes -= context->offset;
 				memmove(s->buf_stat, s->buf_stat + context->offset, context->buf_stat_bytes);
 			}
+			else if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
+			{
+				/* uncompress while receiving instead of keeping the whole compressed message, */
+				/* the uncompressed size from header only limits the stream output buffer      */
+				s->buf_type = ZBX_BUF_TYPE_DYN;
+				s->buffer = NULL;
+				context->buf_dyn_bytes = context->buf_stat_bytes - context->offset;
+				context->buf_stat_bytes = 0;
+
+				if (NULL == (context->stream = zbx_uncompress_stream_open(tcp_recv_codec(context),
+						context->reserved)) || FAIL == zbx_uncompress_stream_write(
+						context->stream, s->buf_stat + context->offset, context->buf_dyn_bytes))
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+			}
 			else
 			{
 				s->buf_type = ZBX_BUF_TYPE_DYN;
@@ -2107,14 +2342,45 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 	{
 		if (context->buf_stat_bytes + context->buf_dyn_bytes == context->expected_len)
 		{
-			if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
+			if (NULL != context->stream)
+			{
+				size_t	out_size;
+				int	ret;
+
+				ret = zbx_uncompress_stream_close(context->stream, &s->buffer, &out_size);
+				context->stream = NULL;
+
+				if (FAIL == ret)
+				{
+					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+
+				if (out_size != context->reserved)
+				{
+					zbx_set_socket_strerror("size of uncompressed data is less than expected");
+					nbytes = ZBX_PROTO_ERROR;
+					goto out;
+				}
+
+				s->read_bytes = context->reserved;
+			}
+			else if (0 != (context->protocol_version & ZBX_TCP_COMPRESS))
 			{
 				char	*out;
 				size_t	out_size = context->reserved;
+				int	codec;
+				double	time_start = 0;
+
+				codec = tcp_recv_codec(context);
+
+				if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
+					time_start = zbx_time();
 
 				out = (char *)zbx_malloc(NULL, context->reserved + 1);
-				if (FAIL == zbx_uncompress(s->buffer, context->buf_stat_bytes + context->buf_dyn_bytes,
-						out, &out_size))
+				if (FAIL == zbx_uncompress_ext(codec, s->buffer, context->buf_stat_bytes +
+						context->buf_dyn_bytes, out, &out_size))
 				{
 					zbx_free(out);
 					zbx_set_socket_strerror("cannot uncompress data: %s", zbx_compress_strerror());
@@ -2137,11 +2403,12 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 				s->buffer = out;
 				s->read_bytes = context->reserved;
 
-				zabbix_log(LOG_LEVEL_TRACE, "%s(): received " ZBX_FS_SIZE_T " bytes with"
-						" compression ratio %.1f", __func__,
+				zabbix_log(LOG_LEVEL_TRACE, "%s(): received " ZBX_FS_SIZE_T " bytes with %s"
+						" compression ratio %.1f, uncompressed in " ZBX_FS_DBL " sec", __func__,
 						(zbx_fs_size_t)(context->buf_stat_bytes + context->buf_dyn_bytes),
-						(double)context->reserved / (double)(context->buf_stat_bytes +
-						context->buf_dyn_bytes));
+						zbx_compress_codec_name(codec), (double)context->reserved /
+						(double)(context->buf_stat_bytes + context->buf_dyn_bytes),
+						zbx_time() - time_start);
 			}
 			else
 				s->read_bytes = context->buf_stat_bytes + context->buf_dyn_bytes;
@@ -2194,6 +2461,10 @@ ssize_t	zbx_tcp_recv_context(zbx_socket_t *s, zbx_tcp_recv_context_t *context, u
 		s->buffer[s->read_bytes] = '\0';
 	}
 out:
+	/* keep uncompressing when more data arrives */
+	if (NULL == events || 0 == *events)
+		zbx_tcp_recv_context_clear(context);
+
 	return (ZBX_PROTO_ERROR == nbytes ? FAIL : (ssize_t)(s->read_bytes + context->offset));
 
 #undef ZBX_TCP_EXPECT_HEADER
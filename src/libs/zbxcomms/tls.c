@@ -200,9 +200,6 @@ static ZBX_THREAD_LOCAL size_t		my_psk_len		= 0;
 /* but other components (e.g. agent) do not link dbconfig.o. */
 size_t	(*find_psk_in_cache)(const unsigned char *, unsigned char *, unsigned int *) = NULL;
 
-/* variable for passing information from callback functions if PSK was found among host PSKs or autoregistration PSK */
-static unsigned int	psk_usage;
-
 static zbx_tls_status_t	tls_status = ZBX_TLS_INIT_NONE;
 
 #if defined(HAVE_GNUTLS)
@@ -224,11 +221,6 @@ static ZBX_THREAD_LOCAL size_t			psk_identity_len_for_cb	= 0;
 static ZBX_THREAD_LOCAL char			*psk_for_cb		= NULL;
 static ZBX_THREAD_LOCAL size_t			psk_len_for_cb		= 0;
 #endif
-#ifdef HAVE_OPENSSL_WITH_PSK
-/* variables for capturing PSK identity from server callback function */
-static ZBX_THREAD_LOCAL int			incoming_connection_has_psk = 0;
-static ZBX_THREAD_LOCAL char			incoming_connection_psk_id[PSK_MAX_IDENTITY_LEN + 1];
-#endif
 /* buffer for messages produced by zbx_openssl_info_cb() */
 ZBX_THREAD_LOCAL char				info_buf[256];
 #endif
@@ -505,18 +497,17 @@ static int	zbx_psk_cb(gnutls_session_t session, const char *psk_identity, gnutls
 	char		*psk;
 	size_t		psk_len = 0;
 	int		psk_bin_len;
-	unsigned char	tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
-
-	ZBX_UNUSED(session);
+	unsigned char		tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
+	zbx_tls_context_t	*tls_ctx = (zbx_tls_context_t *)gnutls_session_get_ptr(session);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() requested PSK identity \"%s\"", __func__, psk_identity);
 
-	psk_usage = 0;
+	tls_ctx->psk_usage = 0;
 
 	if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
 	{
 		/* call the function zbx_dc_get_psk_by_identity() by pointer */
-		if (0 < find_psk_in_cache((const unsigned char *)psk_identity, tls_psk_hex, &psk_usage))
+		if (0 < find_psk_in_cache((const unsigned char *)psk_identity, tls_psk_hex, &tls_ctx->psk_usage))
 		{
 			/* The PSK is in configuration cache. Convert PSK to binary form. */
 			if (0 >= (psk_bin_len = zbx_hex2bin(tls_psk_hex, psk_buf, sizeof(psk_buf))))
@@ -535,13 +526,13 @@ static int	zbx_psk_cb(gnutls_session_t session, const char *psk_identity, gnutls
 				strcmp(my_psk_identity, psk_identity))
 		{
 			/* the PSK is in proxy configuration file */
-			psk_usage |= ZBX_PSK_FOR_PROXY;
+			tls_ctx->psk_usage |= ZBX_PSK_FOR_PROXY;
 
 			if (0 < psk_len && (psk_len != my_psk_len || 0 != memcmp(psk, my_psk, psk_len)))
 			{
 				/* PSK was also found in configuration cache but with different value */
 				zbx_psk_warn_misconfig(psk_identity);
-				psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
+				tls_ctx->psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
 			}
 
 			psk = my_psk;	/* prefer PSK from proxy configuration file */
@@ -650,7 +641,8 @@ static unsigned int	zbx_psk_client_cb(SSL *ssl, const char *hint, char *identity
  *     set pre-shared key for incoming TLS connection upon OpenSSL request    *
  *                                                                            *
  * Parameters:                                                                *
- *     ssl              - [IN] not used                                       *
+ *     ssl              - [IN] TLS connection, its application data is the    *
+ *                             TLS context of accepted socket                 *
  *     identity         - [IN] PSK identity sent by client                    *
  *     psk              - [OUT] buffer to write PSK into                      *
  *     max_psk_len      - [IN] size of the 'psk' buffer                       *
@@ -670,19 +662,18 @@ static unsigned int	zbx_psk_server_cb(SSL *ssl, const char *identity, unsigned c
 	const char	*psk_loc;
 	size_t		psk_len = 0;
 	int		psk_bin_len;
-	unsigned char	tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
-
-	ZBX_UNUSED(ssl);
+	unsigned char		tls_psk_hex[HOST_TLS_PSK_LEN_MAX], psk_buf[HOST_TLS_PSK_LEN / 2];
+	zbx_tls_context_t	*tls_ctx = (zbx_tls_context_t *)SSL_get_app_data(ssl);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "%s() requested PSK identity \"%s\"", __func__, identity);
 
-	incoming_connection_has_psk = 1;
-	psk_usage = 0;
+	tls_ctx->has_psk = 1;
+	tls_ctx->psk_usage = 0;
 
 	if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
 	{
 		/* call the function zbx_dc_get_psk_by_identity() by pointer */
-		if (0 < find_psk_in_cache((const unsigned char *)identity, tls_psk_hex, &psk_usage))
+		if (0 < find_psk_in_cache((const unsigned char *)identity, tls_psk_hex, &tls_ctx->psk_usage))
 		{
 			/* The PSK is in configuration cache. Convert PSK to binary form. */
 			if (0 >= (psk_bin_len = zbx_hex2bin(tls_psk_hex, psk_buf, sizeof(psk_buf))))
@@ -702,13 +693,13 @@ static unsigned int	zbx_psk_server_cb(SSL *ssl, const char *identity, unsigned c
 				0 == strcmp(my_psk_identity, identity))
 		{
 			/* the PSK is in proxy configuration file */
-			psk_usage |= ZBX_PSK_FOR_PROXY;
+			tls_ctx->psk_usage |= ZBX_PSK_FOR_PROXY;
 
 			if (0 < psk_len && (psk_len != my_psk_len || 0 != memcmp(psk_loc, my_psk, psk_len)))
 			{
 				/* PSK was also found in configuration cache but with different value */
 				zbx_psk_warn_misconfig(identity);
-				psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
+				tls_ctx->psk_usage &= ~(unsigned int)ZBX_PSK_FOR_AUTOREG;
 			}
 
 			psk_loc = my_psk;	/* prefer PSK from proxy configuration file */
@@ -749,12 +740,12 @@ static unsigned int	zbx_psk_server_cb(SSL *ssl, const char *identity, unsigned c
 		}
 
 		memcpy(psk, psk_loc, psk_len);
-		zbx_strlcpy(incoming_connection_psk_id, identity, sizeof(incoming_connection_psk_id));
+		zbx_strlcpy(tls_ctx->psk_identity, identity, sizeof(tls_ctx->psk_identity));
 
 		return (unsigned int)psk_len;	/* success */
 	}
 fail:
-	incoming_connection_psk_id[0] = '\0';
+	tls_ctx->psk_identity[0] = '\0';
 	return 0;	/* PSK not found */
 }
 #endif
@@ -3334,152 +3325,166 @@ out1:
  *                                                                            *
  * Parameters:                                                                *
  *     s          - [IN] socket with opened connection                        *
- *     error      - [OUT] dynamically allocated memory with error message     *
  *     tls_accept - [IN] type of connection to accept. Can be be either       *
  *                       ZBX_TCP_SEC_TLS_CERT or ZBX_TCP_SEC_TLS_PSK, or      *
  *                       a bitwise 'OR' of both.                              *
+ *     event      - [OUT] poll event to wait for before calling again, used   *
+ *                        in non-blocking mode only (can be NULL)             *
+ *     error      - [OUT] dynamically allocated memory with error message     *
  *                                                                            *
  * Return value:                                                              *
  *     SUCCEED - successful TLS handshake with a valid certificate or PSK     *
- *     FAIL - an error occurred                                               *
+ *     FAIL - an error occurred or, if event is set, the handshake must be    *
+ *            continued when the socket is ready                              *
  *                                                                            *
  ******************************************************************************/
 #if defined(HAVE_GNUTLS)
-int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
+int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, short *event, char **error)
 {
 	int				ret = FAIL, res;
 	gnutls_credentials_type_t	creds;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	/* set up TLS context */
+	if (NULL != event)
+		*event = 0;
 
-	s->tls_ctx = zbx_malloc(s->tls_ctx, sizeof(zbx_tls_context_t));
-	s->tls_ctx->ctx = NULL;
-	s->tls_ctx->psk_client_creds = NULL;
-	s->tls_ctx->psk_server_creds = NULL;
+	/* set up TLS context */
 
-	if (GNUTLS_E_SUCCESS != (res = gnutls_init(&s->tls_ctx->ctx, GNUTLS_SERVER)))
+	if (NULL == s->tls_ctx)
 	{
-		*error = zbx_dsprintf(*error, "gnutls_init() failed: %d %s", res, gnutls_strerror(res));
-		goto out;
-	}
-
-	/* prepare to accept with certificate */
+		s->tls_ctx = zbx_malloc(s->tls_ctx, sizeof(zbx_tls_context_t));
+		s->tls_ctx->ctx = NULL;
+		s->tls_ctx->psk_client_creds = NULL;
+		s->tls_ctx->psk_server_creds = NULL;
+		s->tls_ctx->psk_usage = 0;
 
-	if (0 != (tls_accept & ZBX_TCP_SEC_TLS_CERT))
-	{
-		if (NULL != my_cert_creds && GNUTLS_E_SUCCESS != (res = gnutls_credentials_set(s->tls_ctx->ctx,
-				GNUTLS_CRD_CERTIFICATE, my_cert_creds)))
+		if (GNUTLS_E_SUCCESS != (res = gnutls_init(&s->tls_ctx->ctx, GNUTLS_SERVER)))
 		{
-			*error = zbx_dsprintf(*error, "gnutls_credentials_set() for certificate failed: %d %s", res,
-					gnutls_strerror(res));
+			*error = zbx_dsprintf(*error, "gnutls_init() failed: %d %s", res, gnutls_strerror(res));
 			goto out;
 		}
 
-		/* client certificate is mandatory unless pre-shared key is used */
-		gnutls_certificate_server_set_request(s->tls_ctx->ctx, GNUTLS_CERT_REQUIRE);
-	}
+		/* PSK callback stores PSK usage in the context of the connection */
+		gnutls_session_set_ptr(s->tls_ctx->ctx, s->tls_ctx);
 
-	/* prepare to accept with pre-shared key */
+		/* prepare to accept with certificate */
 
-	if (0 != (tls_accept & ZBX_TCP_SEC_TLS_PSK))
-	{
-		/* for agentd the only possibility is a PSK from configuration file */
-		if (0 != (zbx_get_program_type_cb() & ZBX_PROGRAM_TYPE_AGENTD) &&
-				GNUTLS_E_SUCCESS != (res = gnutls_credentials_set(s->tls_ctx->ctx, GNUTLS_CRD_PSK,
-				my_psk_server_creds)))
-		{
-			*error = zbx_dsprintf(*error, "gnutls_credentials_set() for my_psk_server_creds failed: %d %s",
-					res, gnutls_strerror(res));
-			goto out;
-		}
-		else if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
+		if (0 != (tls_accept & ZBX_TCP_SEC_TLS_CERT))
 		{
-			/* For server or proxy a PSK can come from configuration file or database. */
-			/* Set up a callback function for finding the requested PSK. */
-			if (GNUTLS_E_SUCCESS != (res = gnutls_psk_allocate_server_credentials(
-					&s->tls_ctx->psk_server_creds)))
+			if (NULL != my_cert_creds && GNUTLS_E_SUCCESS != (res = gnutls_credentials_set(s->tls_ctx->ctx,
+					GNUTLS_CRD_CERTIFICATE, my_cert_creds)))
 			{
-				*error = zbx_dsprintf(*error, "gnutls_psk_allocate_server_credentials() for"
-						" psk_server_creds failed: %d %s", res, gnutls_strerror(res));
+				*error = zbx_dsprintf(*error, "gnutls_credentials_set() for certificate failed: %d %s",
+						res, gnutls_strerror(res));
 				goto out;
 			}
 
-			gnutls_psk_set_server_credentials_function(s->tls_ctx->psk_server_creds, zbx_psk_cb);
+			/* client certificate is mandatory unless pre-shared key is used */
+			gnutls_certificate_server_set_request(s->tls_ctx->ctx, GNUTLS_CERT_REQUIRE);
+		}
+
+		/* prepare to accept with pre-shared key */
 
-			if (GNUTLS_E_SUCCESS != (res = gnutls_credentials_set(s->tls_ctx->ctx, GNUTLS_CRD_PSK,
-					s->tls_ctx->psk_server_creds)))
+		if (0 != (tls_accept & ZBX_TCP_SEC_TLS_PSK))
+		{
+			/* for agentd the only possibility is a PSK from configuration file */
+			if (0 != (zbx_get_program_type_cb() & ZBX_PROGRAM_TYPE_AGENTD) &&
+					GNUTLS_E_SUCCESS != (res = gnutls_credentials_set(s->tls_ctx->ctx,
+					GNUTLS_CRD_PSK, my_psk_server_creds)))
 			{
-				*error = zbx_dsprintf(*error, "gnutls_credentials_set() for psk_server_creds failed"
-						": %d %s", res, gnutls_strerror(res));
+				*error = zbx_dsprintf(*error, "gnutls_credentials_set() for my_psk_server_creds failed:"
+						" %d %s", res, gnutls_strerror(res));
 				goto out;
 			}
+			else if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
+			{
+				/* For server or proxy a PSK can come from configuration file or database. */
+				/* Set up a callback function for finding the requested PSK. */
+				if (GNUTLS_E_SUCCESS != (res = gnutls_psk_allocate_server_credentials(
+						&s->tls_ctx->psk_server_creds)))
+				{
+					*error = zbx_dsprintf(*error, "gnutls_psk_allocate_server_credentials() for"
+							" psk_server_creds failed: %d %s", res, gnutls_strerror(res));
+					goto out;
+				}
+
+				gnutls_psk_set_server_credentials_function(s->tls_ctx->psk_server_creds, zbx_psk_cb);
+
+				if (GNUTLS_E_SUCCESS != (res = gnutls_credentials_set(s->tls_ctx->ctx, GNUTLS_CRD_PSK,
+						s->tls_ctx->psk_server_creds)))
+				{
+					*error = zbx_dsprintf(*error, "gnutls_credentials_set() for psk_server_creds"
+							" failed: %d %s", res, gnutls_strerror(res));
+					goto out;
+				}
+			}
 		}
-	}
 
-	/* set up ciphersuites */
+		/* set up ciphersuites */
 
-	if ((ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK) == (tls_accept & (ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK)))
-	{
-		/* common case in trapper - be ready for all types of incoming connections */
-		if (NULL != my_cert_creds)
+		if ((ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK) ==
+				(tls_accept & (ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK)))
 		{
-			/* it can also be a case in agentd listener - when both certificate and PSK is allowed, e.g. */
-			/* for switching of TLS connections from PSK to using a certificate */
-			if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_all)))
+			/* common case in trapper - be ready for all types of incoming connections */
+			if (NULL != my_cert_creds)
 			{
-				*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_all' failed: %d"
-						" %s", res, gnutls_strerror(res));
-				goto out;
+				/* it can also be a case in agentd listener - when both certificate and PSK is */
+				/* allowed, e.g. for switching of TLS connections from PSK to using a certificate */
+				if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_all)))
+				{
+					*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_all'"
+							" failed: %d %s", res, gnutls_strerror(res));
+					goto out;
+				}
+			}
+			else
+			{
+				/* assume PSK, although it is not yet known will there be the right PSK available */
+				if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_psk)))
+				{
+					*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_psk'"
+							" failed: %d %s", res, gnutls_strerror(res));
+					goto out;
+				}
 			}
 		}
-		else
+		else if (0 != (tls_accept & ZBX_TCP_SEC_TLS_CERT) && NULL != my_cert_creds)
 		{
-			/* assume PSK, although it is not yet known will there be the right PSK available */
-			if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_psk)))
+			if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_cert)))
 			{
-				*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_psk' failed: %d"
-						" %s", res, gnutls_strerror(res));
+				*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_cert' failed:"
+						" %d %s", res, gnutls_strerror(res));
 				goto out;
 			}
 		}
-	}
-	else if (0 != (tls_accept & ZBX_TCP_SEC_TLS_CERT) && NULL != my_cert_creds)
-	{
-		if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_cert)))
+		else if (0 != (tls_accept & ZBX_TCP_SEC_TLS_PSK))
 		{
-			*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_cert' failed: %d %s",
-					res, gnutls_strerror(res));
-			goto out;
+			if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_psk)))
+			{
+				*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_psk' failed:"
+						" %d %s", res, gnutls_strerror(res));
+				goto out;
+			}
 		}
-	}
-	else if (0 != (tls_accept & ZBX_TCP_SEC_TLS_PSK))
-	{
-		if (GNUTLS_E_SUCCESS != (res = gnutls_priority_set(s->tls_ctx->ctx, ciphersuites_psk)))
+
+		if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
 		{
-			*error = zbx_dsprintf(*error, "gnutls_priority_set() for 'ciphersuites_psk' failed: %d %s", res,
-					gnutls_strerror(res));
-			goto out;
+			/* set our own debug callback function */
+			gnutls_global_set_log_function(zbx_gnutls_debug_cb);
+
+			/* for Zabbix LOG_LEVEL_TRACE, GnuTLS debug level 4 seems the best */
+			/* (the highest GnuTLS debug level is 9) */
+			gnutls_global_set_log_level(4);
 		}
-	}
+		else
+			gnutls_global_set_log_level(0);		/* restore default log level */
 
-	if (SUCCEED == ZBX_CHECK_LOG_LEVEL(LOG_LEVEL_TRACE))
-	{
-		/* set our own debug callback function */
-		gnutls_global_set_log_function(zbx_gnutls_debug_cb);
+		/* set our own callback function to log issues into Zabbix log */
+		gnutls_global_set_audit_log_function(zbx_gnutls_audit_cb);
 
-		/* for Zabbix LOG_LEVEL_TRACE, GnuTLS debug level 4 seems the best */
-		/* (the highest GnuTLS debug level is 9) */
-		gnutls_global_set_log_level(4);
+		gnutls_transport_set_int(s->tls_ctx->ctx, ZBX_SOCKET_TO_INT(s->socket));
 	}
-	else
-		gnutls_global_set_log_level(0);		/* restore default log level */
-
-	/* set our own callback function to log issues into Zabbix log */
-	gnutls_global_set_audit_log_function(zbx_gnutls_audit_cb);
-
-	gnutls_transport_set_int(s->tls_ctx->ctx, ZBX_SOCKET_TO_INT(s->socket));
 
 	/* TLS handshake */
 
@@ -3487,6 +3492,13 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 	{
 		if (GNUTLS_E_INTERRUPTED == res || GNUTLS_E_AGAIN == res)
 		{
+			if (NULL != event)
+			{
+				tls_socket_event(s->tls_ctx->ctx, 0, event);
+				zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, tls_error_string(res));
+				return FAIL;
+			}
+
 			if (FAIL == tls_socket_wait(s->socket, s->tls_ctx->ctx, 0))
 			{
 				*error = zbx_dsprintf(*error, "cannot wait for TLS handshake: %s",
@@ -3612,7 +3624,7 @@ out1:
 	return ret;
 }
 #elif defined(HAVE_OPENSSL)
-int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
+int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, short *event, char **error)
 {
 	const char	*cipher_name;
 	int		ret = FAIL, res;
@@ -3624,35 +3636,70 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 #endif
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	s->tls_ctx = zbx_malloc(s->tls_ctx, sizeof(zbx_tls_context_t));
-	s->tls_ctx->ctx = NULL;
+	if (NULL != event)
+		*event = 0;
 
+	if (NULL == s->tls_ctx)
+	{
+		s->tls_ctx = zbx_malloc(s->tls_ctx, sizeof(zbx_tls_context_t));
+		s->tls_ctx->ctx = NULL;
+		s->tls_ctx->psk_usage = 0;
 #if defined(HAVE_OPENSSL_WITH_PSK)
-	incoming_connection_has_psk = 0;	/* assume certificate-based connection by default */
+		s->tls_ctx->has_psk = 0;	/* assume certificate-based connection by default */
+		s->tls_ctx->psk_identity[0] = '\0';
 #endif
-	if ((ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK) == (tls_accept & (ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK)))
-	{
+		if ((ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK) ==
+				(tls_accept & (ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK)))
+		{
 #if defined(HAVE_OPENSSL_WITH_PSK)
-		/* common case in trapper - be ready for all types of incoming connections but possible also in */
-		/* agentd listener */
+			/* common case in trapper - be ready for all types of incoming connections but possible */
+			/* also in agentd listener */
 
-		if (NULL != ctx_all)
-		{
-			if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_all)))
+			if (NULL != ctx_all)
 			{
-				zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context to accept"
-						" connection:");
-				zbx_tls_error_msg(error, &error_alloc, &error_offset);
-				goto out;
+				if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_all)))
+				{
+					zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context"
+							" to accept connection:");
+					zbx_tls_error_msg(error, &error_alloc, &error_offset);
+					goto out;
+				}
 			}
-		}
 #else
-		if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
-		{
-			/* server or proxy running with OpenSSL or LibreSSL without PSK support */
-			if (NULL != ctx_cert)
+			if (0 != (zbx_get_program_type_cb() & (ZBX_PROGRAM_TYPE_PROXY | ZBX_PROGRAM_TYPE_SERVER)))
 			{
-				if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_cert)))
+				/* server or proxy running with OpenSSL or LibreSSL without PSK support */
+				if (NULL != ctx_cert)
+				{
+					if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_cert)))
+					{
+						zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create"
+								" context to accept connection:");
+						zbx_tls_error_msg(error, &error_alloc, &error_offset);
+						goto out;
+					}
+				}
+				else
+				{
+					*error = zbx_strdup(*error, "not ready for certificate-based incoming"
+							" connection: certificate not loaded. PSK support not compiled"
+							" in.");
+					goto out;
+				}
+			}
+#endif
+			else if (0 != (zbx_get_program_type_cb() & ZBX_PROGRAM_TYPE_AGENTD))
+			{
+				THIS_SHOULD_NEVER_HAPPEN;
+				goto out;
+			}
+#if defined(HAVE_OPENSSL_WITH_PSK)
+			else if (NULL != ctx_psk)
+			{
+				/* Server or proxy with no certificate configured. PSK is always assumed to be */
+				/* configured on server or proxy because PSK can come from database. */
+
+				if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_psk)))
 				{
 					zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context"
 							" to accept connection:");
@@ -3662,92 +3709,70 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 			}
 			else
 			{
-				*error = zbx_strdup(*error, "not ready for certificate-based incoming connection:"
-						" certificate not loaded. PSK support not compiled in.");
+				THIS_SHOULD_NEVER_HAPPEN;
 				goto out;
 			}
-		}
 #endif
-		else if (0 != (zbx_get_program_type_cb() & ZBX_PROGRAM_TYPE_AGENTD))
-		{
-			THIS_SHOULD_NEVER_HAPPEN;
-			goto out;
 		}
-#if defined(HAVE_OPENSSL_WITH_PSK)
-		else if (NULL != ctx_psk)
+		else if (0 != (tls_accept & ZBX_TCP_SEC_TLS_CERT))
 		{
-			/* Server or proxy with no certificate configured. PSK is always assumed to be configured on */
-			/* server or proxy because PSK can come from database. */
-
-			if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_psk)))
+			if (NULL != ctx_cert)
 			{
-				zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context to accept"
-						" connection:");
-				zbx_tls_error_msg(error, &error_alloc, &error_offset);
-				goto out;
+				if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_cert)))
+				{
+					zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context"
+							" to accept connection:");
+					zbx_tls_error_msg(error, &error_alloc, &error_offset);
+					goto out;
+				}
 			}
-		}
-		else
-		{
-			THIS_SHOULD_NEVER_HAPPEN;
-			goto out;
-		}
-#endif
-	}
-	else if (0 != (tls_accept & ZBX_TCP_SEC_TLS_CERT))
-	{
-		if (NULL != ctx_cert)
-		{
-			if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_cert)))
+			else
 			{
-				zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context to accept"
-						" connection:");
-				zbx_tls_error_msg(error, &error_alloc, &error_offset);
+				*error = zbx_strdup(*error, "not ready for certificate-based incoming connection:"
+						" certificate not loaded");
 				goto out;
 			}
 		}
-		else
+		else	/* PSK */
 		{
-			*error = zbx_strdup(*error, "not ready for certificate-based incoming connection: certificate"
-					" not loaded");
-			goto out;
-		}
-	}
-	else	/* PSK */
-	{
 #if defined(HAVE_OPENSSL_WITH_PSK)
-		if (NULL != ctx_psk)
-		{
-			if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_psk)))
+			if (NULL != ctx_psk)
 			{
-				zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context to accept"
-						" connection:");
-				zbx_tls_error_msg(error, &error_alloc, &error_offset);
+				if (NULL == (s->tls_ctx->ctx = SSL_new(ctx_psk)))
+				{
+					zbx_snprintf_alloc(error, &error_alloc, &error_offset, "cannot create context"
+							" to accept connection:");
+					zbx_tls_error_msg(error, &error_alloc, &error_offset);
+					goto out;
+				}
+			}
+			else
+			{
+				*error = zbx_strdup(*error, "not ready for PSK-based incoming connection: PSK not"
+						" loaded");
 				goto out;
 			}
+#else
+			*error = zbx_strdup(*error, "support for PSK was not compiled in");
+			goto out;
+#endif
 		}
-		else
+
+#if OPENSSL_VERSION_NUMBER >= 0x1010100fL	/* OpenSSL 1.1.1 or newer, or LibreSSL */
+		if (1 != SSL_set_session_id_context(s->tls_ctx->ctx, session_id_context, sizeof(session_id_context)))
 		{
-			*error = zbx_strdup(*error, "not ready for PSK-based incoming connection: PSK not loaded");
+			*error = zbx_strdup(*error, "cannot set session_id_context");
 			goto out;
 		}
-#else
-		*error = zbx_strdup(*error, "support for PSK was not compiled in");
-		goto out;
 #endif
-	}
+		/* PSK callback stores PSK identity and usage in the context of the connection */
+		SSL_set_app_data(s->tls_ctx->ctx, s->tls_ctx);
 
-#if OPENSSL_VERSION_NUMBER >= 0x1010100fL	/* OpenSSL 1.1.1 or newer, or LibreSSL */
-	if (1 != SSL_set_session_id_context(s->tls_ctx->ctx, session_id_context, sizeof(session_id_context)))
-	{
-		*error = zbx_strdup(*error, "cannot set session_id_context");
-		goto out;
-	}
-#endif
-	if (1 != SSL_set_fd(s->tls_ctx->ctx, s->socket))
-	{
-		*error = zbx_strdup(*error, "cannot set socket for TLS context");
-		goto out;
+		if (1 != SSL_set_fd(s->tls_ctx->ctx, s->socket))
+		{
+			*error = zbx_strdup(*error, "cannot set socket for TLS context");
+			goto out;
+		}
 	}
 
 	/* TLS handshake */
@@ -3763,6 +3788,15 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 		if (SSL_ERROR_WANT_READ != ssl_err && SSL_ERROR_WANT_WRITE != ssl_err)
 			break;
 
+		if (NULL != event)
+		{
+			tls_socket_event(s->tls_ctx->ctx, ssl_err, event);
+
+			zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s %s", __func__, tls_error_string(ssl_err),
+					zbx_result_string(ret));
+			return FAIL;
+		}
+
 		if (FAIL == tls_socket_wait(s->socket, s->tls_ctx->ctx, ssl_err))
 		{
 			*error = zbx_dsprintf(*error, "cannot wait for TLS handshake: %s",
@@ -3814,7 +3848,7 @@ int	zbx_tls_accept(zbx_socket_t *s, unsigned int tls_accept, char **error)
 	cipher_name = SSL_get_cipher(s->tls_ctx->ctx);
 
 #if defined(HAVE_OPENSSL_WITH_PSK)
-	if (1 == incoming_connection_has_psk)
+	if (1 == s->tls_ctx->has_psk)
 	{
 		s->connection_type = ZBX_TCP_SEC_TLS_PSK;
 	}
@@ -4243,14 +4277,12 @@ int	zbx_tls_get_attr_psk(const zbx_socket_t *s, zbx_tls_conn_attr_t *attr)
 #elif defined(HAVE_OPENSSL) && defined(HAVE_OPENSSL_WITH_PSK)
 int	zbx_tls_get_attr_psk(const zbx_socket_t *s, zbx_tls_conn_attr_t *attr)
 {
-	ZBX_UNUSED(s);
-
 	/* SSL_get_psk_identity() is not used here. It works with TLS 1.2, */
 	/* but returns NULL with TLS 1.3 in OpenSSL 1.1.1 */
-	if ('\0' == incoming_connection_psk_id[0])
+	if ('\0' == s->tls_ctx->psk_identity[0])
 		return FAIL;
 
-	attr->psk_identity = incoming_connection_psk_id;
+	attr->psk_identity = s->tls_ctx->psk_identity;
 	attr->psk_identity_len = strlen(attr->psk_identity);
 	return SUCCEED;
 }
@@ -4406,8 +4438,8 @@ void	zbx_tls_take_vars(ZBX_THREAD_SENDVAL_TLS_ARGS *args)
 }
 #endif
 
-unsigned int	zbx_tls_get_psk_usage(void)
+unsigned int	zbx_tls_get_psk_usage(const zbx_socket_t *s)
 {
-	return	psk_usage;
+	return	s->tls_ctx->psk_usage;
 }
 #endif
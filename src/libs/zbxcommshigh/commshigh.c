@@ -23,6 +23,7 @@
 #include "zbxjson.h"
 #include "zbxlog.h"
 #include "zbxtime.h"
+#include "zbxstr.h"
 
 #if !defined(_WINDOWS) && !defined(__MINGW32)
 #include "zbxnix.h"
@@ -142,17 +143,27 @@ void	zbx_disconnect_from_server(zbx_socket_t *sock)
  *                                                                            *
  * Purpose: get configuration and other data from server                      *
  *                                                                            *
+ * Parameters: sock        - [IN] the connection socket                       *
+ *             buffer      - [IN/OUT] the data to send, freed after sending   *
+ *             buffer_size - [IN] the data size                               *
+ *             reserved    - [IN] the uncompressed data size if the data is   *
+ *                                compressed, 0 otherwise                     *
+ *             flags       - [IN] the compression flags (ZBX_TCP_COMPRESS and *
+ *                                codec) used to compress the data            *
+ *             error       - [OUT] the error message                          *
+ *                                                                            *
  * Return value: SUCCEED - processed successfully                             *
  *               FAIL - an error occurred                                     *
  *                                                                            *
  ******************************************************************************/
-int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error)
+int	zbx_get_data_from_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char flags, char **error)
 {
 	int		ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, 0))
+	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | flags, 0))
 	{
 		*error = zbx_strdup(*error, zbx_socket_strerror());
 		goto exit;
@@ -179,17 +190,27 @@ exit:
  *                                                                            *
  * Purpose: send data to server                                               *
  *                                                                            *
+ * Parameters: sock        - [IN] the connection socket                       *
+ *             buffer      - [IN/OUT] the data to send, freed after sending   *
+ *             buffer_size - [IN] the data size                               *
+ *             reserved    - [IN] the uncompressed data size if the data is   *
+ *                                compressed, 0 otherwise                     *
+ *             flags       - [IN] the compression flags (ZBX_TCP_COMPRESS and *
+ *                                codec) used to compress the data            *
+ *             error       - [OUT] the error message                          *
+ *                                                                            *
  * Return value: SUCCEED - processed successfully                             *
  *               FAIL - an error occurred                                     *
  *                                                                            *
  ******************************************************************************/
-int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved, char **error)
+int	zbx_put_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
+		unsigned char flags, char **error)
 {
 	int	ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() datalen:" ZBX_FS_SIZE_T, __func__, (zbx_fs_size_t)buffer_size);
 
-	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS, 0))
+	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | flags, 0))
 	{
 		*error = zbx_strdup(*error, zbx_socket_strerror());
 		goto out;
@@ -363,3 +384,69 @@ out:
 
 	return ret;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: advertises compression codecs that can be received in addition    *
+ *          to zlib                                                           *
+ *                                                                            *
+ * Parameters: j - [IN/OUT] the JSON message to peer                          *
+ *                                                                            *
+ * Comments: The peer uses the advertised codecs to select compression of the *
+ *           messages it sends (see zbx_get_compress_flags()). Peers that do  *
+ *           not know the tag ignore it and keep using zlib.                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_add_compress_codecs(struct zbx_json *j)
+{
+	char	codecs[64];
+	size_t	offset = 0;
+	int	i;
+
+	for (i = 0; i < ZBX_COMPRESS_CODEC_NUM; i++)
+	{
+		if (ZBX_COMPRESS_ZLIB == i || SUCCEED != zbx_compress_codec_supported(i))
+			continue;
+
+		offset += zbx_snprintf(codecs + offset, sizeof(codecs) - offset, "%s%s", 0 == offset ? "" : ",",
+				zbx_compress_codec_name(i));
+	}
+
+	if (0 != offset)
+		zbx_json_addstring(j, ZBX_PROTO_TAG_COMPRESSION, codecs, ZBX_JSON_TYPE_STRING);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: selects compression of messages sent to peer                      *
+ *                                                                            *
+ * Parameters: jp - [IN] the JSON message received from peer                  *
+ *                                                                            *
+ * Return value: ZBX_TCP_COMPRESS combined with the flag of the preferred     *
+ *               codec advertised by peer and supported locally, or just      *
+ *               ZBX_TCP_COMPRESS (zlib) if there is no such codec            *
+ *                                                                            *
+ * Comments: zstd is preferred to lz4 because it compresses better at the     *
+ *           default level while still being much faster than zlib.           *
+ *                                                                            *
+ ******************************************************************************/
+unsigned char	zbx_get_compress_flags(const struct zbx_json_parse *jp)
+{
+	const int	preferred[] = {ZBX_COMPRESS_ZSTD, ZBX_COMPRESS_LZ4};
+	char		codecs[64];
+	size_t		i;
+
+	if (SUCCEED != zbx_json_value_by_name(jp, ZBX_PROTO_TAG_COMPRESSION, codecs, sizeof(codecs), NULL))
+		return ZBX_TCP_COMPRESS;
+
+	for (i = 0; i < ARRSIZE(preferred); i++)
+	{
+		if (SUCCEED == zbx_compress_codec_supported(preferred[i]) &&
+				SUCCEED == zbx_str_in_list(codecs, zbx_compress_codec_name(preferred[i]), ','))
+		{
+			return zbx_tcp_compress_codec_flags(preferred[i]);
+		}
+	}
+
+	return ZBX_TCP_COMPRESS;
+}
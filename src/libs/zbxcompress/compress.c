@@ -24,9 +24,65 @@
 #ifdef HAVE_ZLIB
 #include "zlib.h"
 
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+#ifdef HAVE_LZ4
+#define LZ4F_STATIC_LINKING_ONLY
+#include <lz4frame.h>
+#endif
+
 #define ZBX_COMPRESS_STRERROR_LEN	512
 
-static int	zbx_zlib_errno = 0;
+/* the error state is kept per thread, so it refers to the last call made by the calling thread */
+static ZBX_THREAD_LOCAL int	zbx_compress_codec = ZBX_COMPRESS_ZLIB;
+static ZBX_THREAD_LOCAL int	zbx_zlib_errno = 0;
+
+static ZBX_THREAD_LOCAL zbx_compress_stats_t	compress_stats[ZBX_COMPRESS_CODEC_NUM];
+
+#ifdef HAVE_ZSTD
+static ZBX_THREAD_LOCAL size_t	zbx_zstd_errno = 0;
+
+/* compression contexts are kept between calls to avoid reallocating their */
+/* internal state (which is a few hundred kilobytes for zstd) per message  */
+static ZBX_THREAD_LOCAL ZSTD_CCtx	*zstd_cctx = NULL;
+static ZBX_THREAD_LOCAL ZSTD_DCtx	*zstd_dctx = NULL;
+#endif
+
+#ifdef HAVE_LZ4
+static ZBX_THREAD_LOCAL LZ4F_errorCode_t	zbx_lz4_errno = 0;
+static ZBX_THREAD_LOCAL LZ4F_dctx		*lz4_dctx = NULL;
+
+#define ZBX_LZ4_ERROR(code)	((LZ4F_errorCode_t)-(ptrdiff_t)(code))
+#endif
+
+/* initial size of uncompression stream output buffer */
+#define ZBX_UNCOMPRESS_STREAM_ALLOC	(64 * ZBX_KIBIBYTE)
+
+struct zbx_uncompress_stream
+{
+	int		codec;
+	int		finished;
+	size_t		size_in;
+	double		cpu_time;
+	char		*out;		/* uncompressed data, one byte larger than out_alloc */
+	size_t		out_alloc;
+	size_t		out_max;	/* maximum uncompressed data size */
+	size_t		out_pos;
+	z_stream	zlib;
+};
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns CPU time used by the process in seconds                   *
+ *                                                                            *
+ ******************************************************************************/
+static double	compress_cpu_time(void)
+{
+	return (double)clock() / CLOCKS_PER_SEC;
+}
 
 /******************************************************************************
  *                                                                            *
@@ -35,8 +91,22 @@ static int	zbx_zlib_errno = 0;
  ******************************************************************************/
 const char	*zbx_compress_strerror(void)
 {
-	static char	message[ZBX_COMPRESS_STRERROR_LEN];
+	static ZBX_THREAD_LOCAL char	message[ZBX_COMPRESS_STRERROR_LEN];
 
+#ifdef HAVE_ZSTD
+	if (ZBX_COMPRESS_ZSTD == zbx_compress_codec)
+	{
+		zbx_strlcpy(message, ZSTD_getErrorName(zbx_zstd_errno), sizeof(message));
+		return message;
+	}
+#endif
+#ifdef HAVE_LZ4
+	if (ZBX_COMPRESS_LZ4 == zbx_compress_codec)
+	{
+		zbx_strlcpy(message, LZ4F_getErrorName(zbx_lz4_errno), sizeof(message));
+		return message;
+	}
+#endif
 	switch (zbx_zlib_errno)
 	{
 		case Z_ERRNO:
@@ -61,21 +131,59 @@ const char	*zbx_compress_strerror(void)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: compress data                                                     *
+ * Purpose: checks if compression codec is supported                          *
  *                                                                            *
- * Parameters: in       - [IN] the data to compress                           *
- *             size_in  - [IN] the input data size                            *
- *             out      - [OUT] the compressed data                           *
- *             size_out - [OUT] the compressed data size                      *
+ * Parameters: codec - [IN] the compression codec (ZBX_COMPRESS_*)            *
  *                                                                            *
- * Return value: SUCCEED - the data was compressed successfully               *
+ * Return value: SUCCEED - the codec is supported                             *
  *               FAIL    - otherwise                                          *
  *                                                                            *
- * Comments: In the case of success the output buffer must be freed by the    *
- *           caller.                                                          *
+ ******************************************************************************/
+int	zbx_compress_codec_supported(int codec)
+{
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			return SUCCEED;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			return SUCCEED;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			return SUCCEED;
+#endif
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns compression codec name                                    *
  *                                                                            *
  ******************************************************************************/
-int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
+const char	*zbx_compress_codec_name(int codec)
+{
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			return "zlib";
+		case ZBX_COMPRESS_ZSTD:
+			return "zstd";
+		case ZBX_COMPRESS_LZ4:
+			return "lz4";
+		default:
+			return "unknown";
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data with zlib                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	compress_zlib(const char *in, size_t size_in, char **out, size_t *size_out)
 {
 	Bytef	*buf;
 	uLongf	buf_size;
@@ -97,10 +205,273 @@ int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: uncompress data                                                   *
+ * Purpose: uncompress data with zlib                                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	uncompress_zlib(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	uLongf	size_o = *size_out;
+
+	if (Z_OK != (zbx_zlib_errno = uncompress((Bytef *)out, &size_o, (const Bytef *)in, size_in)))
+		return FAIL;
+
+	*size_out = size_o;
+
+	return SUCCEED;
+}
+
+#ifdef HAVE_ZSTD
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data with zstd                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	compress_zstd(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	char	*buf;
+	size_t	buf_size;
+
+	if (NULL == zstd_cctx && NULL == (zstd_cctx = ZSTD_createCCtx()))
+	{
+		zbx_zstd_errno = (size_t)-ZSTD_error_memory_allocation;
+		return FAIL;
+	}
+
+	buf_size = ZSTD_compressBound(size_in);
+	buf = (char *)zbx_malloc(NULL, buf_size);
+
+	zbx_zstd_errno = ZSTD_compressCCtx(zstd_cctx, buf, buf_size, in, size_in, ZSTD_CLEVEL_DEFAULT);
+
+	if (0 != ZSTD_isError(zbx_zstd_errno))
+	{
+		zbx_free(buf);
+		return FAIL;
+	}
+
+	*out = buf;
+	*size_out = zbx_zstd_errno;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data with zstd                                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	uncompress_zstd(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	if (NULL == zstd_dctx && NULL == (zstd_dctx = ZSTD_createDCtx()))
+	{
+		zbx_zstd_errno = (size_t)-ZSTD_error_memory_allocation;
+		return FAIL;
+	}
+
+	zbx_zstd_errno = ZSTD_decompressDCtx(zstd_dctx, out, *size_out, in, size_in);
+
+	if (0 != ZSTD_isError(zbx_zstd_errno))
+		return FAIL;
+
+	*size_out = zbx_zstd_errno;
+
+	return SUCCEED;
+}
+#endif
+
+#ifdef HAVE_LZ4
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data with lz4 frame format                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	compress_lz4(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	LZ4F_preferences_t	prefs;
+	char			*buf;
+	size_t			buf_size;
+
+	memset(&prefs, 0, sizeof(prefs));
+	prefs.frameInfo.contentSize = size_in;
+
+	buf_size = LZ4F_compressFrameBound(size_in, &prefs);
+	buf = (char *)zbx_malloc(NULL, buf_size);
+
+	zbx_lz4_errno = LZ4F_compressFrame(buf, buf_size, in, size_in, &prefs);
+
+	if (0 != LZ4F_isError(zbx_lz4_errno))
+	{
+		zbx_free(buf);
+		return FAIL;
+	}
+
+	*out = buf;
+	*size_out = zbx_lz4_errno;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress the next part of lz4 frame                             *
  *                                                                            *
  * Parameters: in       - [IN] the data to uncompress                         *
  *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the buffer for uncompressed data              *
+ *             size_out - [IN] the buffer size                                *
+ *             pos      - [IN/OUT] the uncompressed data size in buffer       *
+ *             finished - [OUT] 1 if the frame is complete, 0 otherwise       *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	uncompress_lz4_part(const char *in, size_t size_in, char *out, size_t size_out, size_t *pos,
+		int *finished)
+{
+	while (0 != size_in)
+	{
+		size_t	src_size = size_in, dst_size = size_out - *pos;
+
+		if (0 != *finished)
+		{
+			zbx_lz4_errno = ZBX_LZ4_ERROR(LZ4F_ERROR_frameSize_wrong);
+			return FAIL;
+		}
+
+		zbx_lz4_errno = LZ4F_decompress(lz4_dctx, out + *pos, &dst_size, in, &src_size, NULL);
+
+		if (0 != LZ4F_isError(zbx_lz4_errno))
+			return FAIL;
+
+		/* frame is complete when zero is returned */
+		*finished = (0 == zbx_lz4_errno ? 1 : 0);
+
+		if (0 == src_size && 0 == dst_size)
+		{
+			zbx_lz4_errno = ZBX_LZ4_ERROR(LZ4F_ERROR_dstMaxSize_tooSmall);
+			return FAIL;
+		}
+
+		in += src_size;
+		size_in -= src_size;
+		*pos += dst_size;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepare lz4 decompression context for a new frame                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	uncompress_lz4_init(void)
+{
+	if (NULL == lz4_dctx)
+	{
+		if (0 != LZ4F_isError(zbx_lz4_errno = LZ4F_createDecompressionContext(&lz4_dctx, LZ4F_VERSION)))
+		{
+			lz4_dctx = NULL;
+			return FAIL;
+		}
+	}
+	else
+		LZ4F_resetDecompressionContext(lz4_dctx);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data with lz4 frame format                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	uncompress_lz4(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	size_t	pos = 0;
+	int	finished = 0;
+
+	if (SUCCEED != uncompress_lz4_init())
+		return FAIL;
+
+	if (SUCCEED != uncompress_lz4_part(in, size_in, out, *size_out, &pos, &finished))
+		return FAIL;
+
+	if (0 == finished)
+	{
+		zbx_lz4_errno = ZBX_LZ4_ERROR(LZ4F_ERROR_frameSize_wrong);
+		return FAIL;
+	}
+
+	*size_out = pos;
+
+	return SUCCEED;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data with the specified codec                            *
+ *                                                                            *
+ * Parameters: codec    - [IN] the compression codec (ZBX_COMPRESS_*)         *
+ *             in       - [IN] the data to compress                           *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the compressed data                           *
+ *             size_out - [OUT] the compressed data size                      *
+ *                                                                            *
+ * Return value: SUCCEED - the data was compressed successfully               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: In the case of success the output buffer must be freed by the    *
+ *           caller.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress_ext(int codec, const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	int	ret;
+	double	cpu_start;
+
+	zbx_compress_codec = codec;
+	cpu_start = compress_cpu_time();
+
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			ret = compress_zlib(in, size_in, out, size_out);
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			ret = compress_zstd(in, size_in, out, size_out);
+			break;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			ret = compress_lz4(in, size_in, out, size_out);
+			break;
+#endif
+		default:
+			zbx_compress_codec = ZBX_COMPRESS_ZLIB;
+			zbx_zlib_errno = Z_VERSION_ERROR;
+			return FAIL;
+	}
+
+	if (SUCCEED == ret)
+	{
+		compress_stats[codec].size += size_in;
+		compress_stats[codec].size_compressed += *size_out;
+		compress_stats[codec].cpu_time += compress_cpu_time() - cpu_start;
+	}
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data with the specified codec                          *
+ *                                                                            *
+ * Parameters: codec    - [IN] the compression codec (ZBX_COMPRESS_*)         *
+ *             in       - [IN] the data to uncompress                         *
+ *             size_in  - [IN] the input data size                            *
  *             out      - [OUT] the uncompressed data                         *
  *             size_out - [IN/OUT] the buffer and uncompressed data size      *
  *                                                                            *
@@ -108,18 +479,433 @@ int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
+int	zbx_uncompress_ext(int codec, const char *in, size_t size_in, char *out, size_t *size_out)
 {
-	uLongf	size_o = *size_out;
+	int	ret;
+	double	cpu_start;
 
-	if (Z_OK != (zbx_zlib_errno = uncompress((Bytef *)out, &size_o, (const Bytef *)in, size_in)))
-		return FAIL;
+	zbx_compress_codec = codec;
+	cpu_start = compress_cpu_time();
 
-	*size_out = size_o;
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			ret = uncompress_zlib(in, size_in, out, size_out);
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			ret = uncompress_zstd(in, size_in, out, size_out);
+			break;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			ret = uncompress_lz4(in, size_in, out, size_out);
+			break;
+#endif
+		default:
+			zbx_compress_codec = ZBX_COMPRESS_ZLIB;
+			zbx_zlib_errno = Z_VERSION_ERROR;
+			return FAIL;
+	}
+
+	if (SUCCEED == ret)
+	{
+		compress_stats[codec].size += *size_out;
+		compress_stats[codec].size_compressed += size_in;
+		compress_stats[codec].cpu_time += compress_cpu_time() - cpu_start;
+	}
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start uncompressing data that is received in parts                *
+ *                                                                            *
+ * Parameters: codec    - [IN] the compression codec (ZBX_COMPRESS_*)         *
+ *             size_max - [IN] the maximum uncompressed data size             *
+ *                                                                            *
+ * Return value: the uncompression stream or NULL on error                    *
+ *                                                                            *
+ * Comments: The output buffer is allocated as the data is uncompressed, so   *
+ *           memory is not reserved for the maximum size in advance.          *
+ *           The stream must be closed with zbx_uncompress_stream_close().    *
+ *                                                                            *
+ ******************************************************************************/
+zbx_uncompress_stream_t	*zbx_uncompress_stream_open(int codec, size_t size_max)
+{
+	zbx_uncompress_stream_t	*stream;
+
+	zbx_compress_codec = codec;
+
+	switch (codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			stream = (zbx_uncompress_stream_t *)zbx_malloc(NULL, sizeof(zbx_uncompress_stream_t));
+			memset(&stream->zlib, 0, sizeof(stream->zlib));
+
+			if (Z_OK != (zbx_zlib_errno = inflateInit(&stream->zlib)))
+			{
+				zbx_free(stream);
+				return NULL;
+			}
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			if (NULL == zstd_dctx && NULL == (zstd_dctx = ZSTD_createDCtx()))
+			{
+				zbx_zstd_errno = (size_t)-ZSTD_error_memory_allocation;
+				return NULL;
+			}
+
+			if (0 != ZSTD_isError(zbx_zstd_errno = ZSTD_DCtx_reset(zstd_dctx, ZSTD_reset_session_only)))
+				return NULL;
+
+			stream = (zbx_uncompress_stream_t *)zbx_malloc(NULL, sizeof(zbx_uncompress_stream_t));
+			break;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			if (SUCCEED != uncompress_lz4_init())
+				return NULL;
+
+			stream = (zbx_uncompress_stream_t *)zbx_malloc(NULL, sizeof(zbx_uncompress_stream_t));
+			break;
+#endif
+		default:
+			zbx_compress_codec = ZBX_COMPRESS_ZLIB;
+			zbx_zlib_errno = Z_VERSION_ERROR;
+			return NULL;
+	}
+
+	stream->codec = codec;
+	stream->finished = 0;
+	stream->size_in = 0;
+	stream->cpu_time = 0;
+	stream->out = (char *)zbx_malloc(NULL, 1);
+	stream->out_alloc = 0;
+	stream->out_max = size_max;
+	stream->out_pos = 0;
+
+	return stream;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: set stream error when the output buffer cannot hold more data     *
+ *                                                                            *
+ ******************************************************************************/
+static void	uncompress_stream_set_overflow(const zbx_uncompress_stream_t *stream)
+{
+	switch (stream->codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			zbx_zlib_errno = Z_BUF_ERROR;
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			zbx_zstd_errno = (size_t)-ZSTD_error_dstSize_tooSmall;
+			break;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			zbx_lz4_errno = ZBX_LZ4_ERROR(LZ4F_ERROR_dstMaxSize_tooSmall);
+			break;
+#endif
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data into the free space of the output buffer          *
+ *                                                                            *
+ * Parameters: stream   - [IN] the uncompression stream                       *
+ *             in       - [IN] the data to uncompress                         *
+ *             size_in  - [IN] the input data size                            *
+ *             consumed - [OUT] the number of input bytes consumed            *
+ *             produced - [OUT] the number of output bytes produced           *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	uncompress_stream_step(zbx_uncompress_stream_t *stream, const char *in, size_t size_in,
+		size_t *consumed, size_t *produced)
+{
+	size_t	free_out = stream->out_alloc - stream->out_pos;
+
+	switch (stream->codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			{
+				/* zlib buffer sizes are limited to unsigned int */
+				uInt	chunk_in = (uInt)MIN(size_in, ZBX_MEBIBYTE);
+				uInt	chunk_out = (uInt)MIN(free_out, ZBX_MEBIBYTE);
+
+				stream->zlib.next_in = (Bytef *)in;
+				stream->zlib.avail_in = chunk_in;
+				stream->zlib.next_out = (Bytef *)stream->out + stream->out_pos;
+				stream->zlib.avail_out = chunk_out;
+
+				zbx_zlib_errno = inflate(&stream->zlib, Z_NO_FLUSH);
+
+				if (Z_STREAM_END == zbx_zlib_errno)
+					stream->finished = 1;
+				else if (Z_OK != zbx_zlib_errno && Z_BUF_ERROR != zbx_zlib_errno)
+					return FAIL;
+
+				/* Z_BUF_ERROR only means that no progress was possible */
+				*consumed = chunk_in - stream->zlib.avail_in;
+				*produced = chunk_out - stream->zlib.avail_out;
+			}
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			{
+				ZSTD_inBuffer	zstd_in = {in, size_in, 0};
+				ZSTD_outBuffer	zstd_out = {stream->out + stream->out_pos, free_out, 0};
+
+				zbx_zstd_errno = ZSTD_decompressStream(zstd_dctx, &zstd_out, &zstd_in);
+
+				if (0 != ZSTD_isError(zbx_zstd_errno))
+					return FAIL;
+
+				/* frame is complete when zero is returned */
+				stream->finished = (0 == zbx_zstd_errno ? 1 : 0);
+
+				*consumed = zstd_in.pos;
+				*produced = zstd_out.pos;
+			}
+			break;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			*consumed = size_in;
+			*produced = free_out;
+
+			zbx_lz4_errno = LZ4F_decompress(lz4_dctx, stream->out + stream->out_pos, produced, in,
+					consumed, NULL);
+
+			if (0 != LZ4F_isError(zbx_lz4_errno))
+				return FAIL;
+
+			/* frame is complete when zero is returned */
+			stream->finished = (0 == zbx_lz4_errno ? 1 : 0);
+			break;
+#endif
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			return FAIL;
+	}
 
 	return SUCCEED;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress the next part of data                                  *
+ *                                                                            *
+ * Parameters: stream  - [IN] the uncompression stream                        *
+ *             in      - [IN] the data to uncompress                          *
+ *             size_in - [IN] the input data size                             *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The output buffer is grown when it is full, but not above the    *
+ *           maximum size specified when opening the stream.                  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_write(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	double	cpu_start;
+	int	ret = SUCCEED;
+
+	zbx_compress_codec = stream->codec;
+	cpu_start = compress_cpu_time();
+	stream->size_in += size_in;
+
+	for (;;)
+	{
+		size_t	consumed, produced;
+
+		if (0 != stream->finished)
+		{
+			/* data after the end of compressed stream */
+			if (0 != size_in)
+			{
+				uncompress_stream_set_overflow(stream);
+				ret = FAIL;
+			}
+			break;
+		}
+
+		/* codecs can keep uncompressed data internally when the output buffer is full */
+		if (stream->out_pos == stream->out_alloc && stream->out_alloc < stream->out_max)
+		{
+			stream->out_alloc = MIN(stream->out_max, MAX(stream->out_alloc * 2,
+					ZBX_UNCOMPRESS_STREAM_ALLOC));
+			stream->out = (char *)zbx_realloc(stream->out, stream->out_alloc + 1);
+		}
+		else if (0 == size_in)
+			break;
+
+		if (SUCCEED != (ret = uncompress_stream_step(stream, in, size_in, &consumed, &produced)))
+			break;
+
+		/* no progress means that all input was used and no more data is buffered */
+		if (0 == consumed && 0 == produced)
+		{
+			if (0 != size_in)
+			{
+				uncompress_stream_set_overflow(stream);
+				ret = FAIL;
+			}
+			break;
+		}
+
+		in += consumed;
+		size_in -= consumed;
+		stream->out_pos += produced;
+	}
+
+	stream->cpu_time += compress_cpu_time() - cpu_start;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finish uncompressing data and free the stream                     *
+ *                                                                            *
+ * Parameters: stream   - [IN] the uncompression stream                       *
+ *             out      - [OUT] the uncompressed data, optional               *
+ *             size_out - [OUT] the uncompressed data size, optional          *
+ *                                                                            *
+ * Return value: SUCCEED - the complete data was uncompressed                 *
+ *               FAIL    - the compressed data is incomplete                  *
+ *                                                                            *
+ * Comments: In the case of success the uncompressed data is terminated with  *
+ *           zero byte and must be freed by the caller.                       *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress_stream_close(zbx_uncompress_stream_t *stream, char **out, size_t *size_out)
+{
+	int	ret = SUCCEED;
+
+	zbx_compress_codec = stream->codec;
+
+	switch (stream->codec)
+	{
+		case ZBX_COMPRESS_ZLIB:
+			if (0 == stream->finished)
+			{
+				zbx_zlib_errno = Z_DATA_ERROR;
+				ret = FAIL;
+			}
+
+			inflateEnd(&stream->zlib);
+			break;
+#ifdef HAVE_ZSTD
+		case ZBX_COMPRESS_ZSTD:
+			if (0 == stream->finished)
+			{
+				zbx_zstd_errno = (size_t)-ZSTD_error_srcSize_wrong;
+				ret = FAIL;
+			}
+			break;
+#endif
+#ifdef HAVE_LZ4
+		case ZBX_COMPRESS_LZ4:
+			if (0 == stream->finished)
+			{
+				zbx_lz4_errno = ZBX_LZ4_ERROR(LZ4F_ERROR_frameSize_wrong);
+				ret = FAIL;
+			}
+			break;
+#endif
+	}
+
+	if (NULL != size_out)
+		*size_out = stream->out_pos;
+
+	if (SUCCEED == ret)
+	{
+		compress_stats[stream->codec].size += stream->out_pos;
+		compress_stats[stream->codec].size_compressed += stream->size_in;
+	}
+
+	compress_stats[stream->codec].cpu_time += stream->cpu_time;
+
+	if (SUCCEED == ret && NULL != out)
+	{
+		stream->out[stream->out_pos] = '\0';
+		*out = stream->out;
+	}
+	else
+		zbx_free(stream->out);
+
+	zbx_free(stream);
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compress data                                                     *
+ *                                                                            *
+ * Parameters: in       - [IN] the data to compress                           *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the compressed data                           *
+ *             size_out - [OUT] the compressed data size                      *
+ *                                                                            *
+ * Return value: SUCCEED - the data was compressed successfully               *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: In the case of success the output buffer must be freed by the    *
+ *           caller.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	return zbx_compress_ext(ZBX_COMPRESS_ZLIB, in, size_in, out, size_out);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: uncompress data                                                   *
+ *                                                                            *
+ * Parameters: in       - [IN] the data to uncompress                         *
+ *             size_in  - [IN] the input data size                            *
+ *             out      - [OUT] the uncompressed data                         *
+ *             size_out - [IN/OUT] the buffer and uncompressed data size      *
+ *                                                                            *
+ * Return value: SUCCEED - the data was uncompressed successfully             *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	return zbx_uncompress_ext(ZBX_COMPRESS_ZLIB, in, size_in, out, size_out);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get compression statistics collected since the last call          *
+ *                                                                            *
+ * Parameters: stats - [OUT] the statistics of ZBX_COMPRESS_CODEC_NUM codecs, *
+ *                           indexed by codec (ZBX_COMPRESS_*)                *
+ *                                                                            *
+ * Comments: The statistics are collected per thread and are reset after      *
+ *           being returned, so they can be added to shared totals.           *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_compress_get_stats(zbx_compress_stats_t *stats)
+{
+	memcpy(stats, compress_stats, sizeof(compress_stats));
+	memset(compress_stats, 0, sizeof(compress_stats));
+}
+
 #else
 
 int	zbx_compress(const char *in, size_t size_in, char **out, size_t *size_out)
@@ -140,9 +926,69 @@ int	zbx_uncompress(const char *in, size_t size_in, char *out, size_t *size_out)
 	return FAIL;
 }
 
+int	zbx_compress_ext(int codec, const char *in, size_t size_in, char **out, size_t *size_out)
+{
+	ZBX_UNUSED(codec);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
+int	zbx_uncompress_ext(int codec, const char *in, size_t size_in, char *out, size_t *size_out)
+{
+	ZBX_UNUSED(codec);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
+int	zbx_compress_codec_supported(int codec)
+{
+	ZBX_UNUSED(codec);
+	return FAIL;
+}
+
+const char	*zbx_compress_codec_name(int codec)
+{
+	ZBX_UNUSED(codec);
+	return "";
+}
+
 const char	*zbx_compress_strerror(void)
 {
 	return "";
 }
 
+void	zbx_compress_get_stats(zbx_compress_stats_t *stats)
+{
+	memset(stats, 0, sizeof(zbx_compress_stats_t) * ZBX_COMPRESS_CODEC_NUM);
+}
+
+zbx_uncompress_stream_t	*zbx_uncompress_stream_open(int codec, size_t size_max)
+{
+	ZBX_UNUSED(codec);
+	ZBX_UNUSED(size_max);
+	return NULL;
+}
+
+int	zbx_uncompress_stream_write(zbx_uncompress_stream_t *stream, const char *in, size_t size_in)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(in);
+	ZBX_UNUSED(size_in);
+	return FAIL;
+}
+
+int	zbx_uncompress_stream_close(zbx_uncompress_stream_t *stream, char **out, size_t *size_out)
+{
+	ZBX_UNUSED(stream);
+	ZBX_UNUSED(out);
+	ZBX_UNUSED(size_out);
+	return FAIL;
+}
+
 #endif
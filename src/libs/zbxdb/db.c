@@ -75,6 +75,17 @@ static int		config_log_slow_queries;
 
 static int		db_auto_increment;
 
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+/* the queued statements are sent when their size exceeds this limit */
+#define ZBX_DB_PIPELINE_SIZE	(512 * ZBX_KIBIBYTE)
+
+/* non-select statements queued within transaction to be sent in a single request */
+static char		*pipeline_sql = NULL;
+static size_t		pipeline_sql_alloc = 0, pipeline_sql_offset = 0;
+static int		pipeline_active = 0;
+
+#endif
+
 #if defined(HAVE_MYSQL)
 static MYSQL			*conn = NULL;
 static zbx_uint32_t		ZBX_MYSQL_SVERSION = ZBX_DBVERSION_UNDEFINED;
@@ -936,8 +947,70 @@ void	zbx_db_deinit_basic(void)
 #endif
 }
 
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add statement to the pipeline queue                               *
+ *                                                                            *
+ * Comments: Trailing statement separators are replaced with a single one,    *
+ *           as MySQL fails on empty statements.                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_pipeline_queue(const char *sql)
+{
+	size_t	len;
+
+	for (len = strlen(sql); 0 < len && NULL != strchr("; \t\r\n", sql[len - 1]); len--)
+		;
+
+	if (0 == len)
+		return;
+
+	zbx_strncpy_alloc(&pipeline_sql, &pipeline_sql_alloc, &pipeline_sql_offset, sql, len);
+	zbx_strcpy_alloc(&pipeline_sql, &pipeline_sql_alloc, &pipeline_sql_offset, ";\n");
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: send the queued statements to database                            *
+ *                                                                            *
+ * Return value: ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *               or number of rows affected (on success)                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	db_pipeline_flush(void)
+{
+	int	ret, active = pipeline_active;
+
+	if (0 == pipeline_sql_offset)
+		return ZBX_DB_OK;
+
+	pipeline_active = 0;
+	ret = zbx_db_execute_basic("%s", pipeline_sql);
+	pipeline_active = active;
+
+	pipeline_sql_offset = 0;
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: discard the queued statements and stop queuing                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_pipeline_reset(void)
+{
+	pipeline_sql_offset = 0;
+	pipeline_active = 0;
+}
+#endif
+
 void	zbx_db_close_basic(void)
 {
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	db_pipeline_reset();
+#endif
 #if defined(HAVE_MYSQL)
 	if (NULL != conn)
 	{
@@ -1006,6 +1079,56 @@ void	zbx_db_close_basic(void)
 #endif
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start queuing non-select statements of the current transaction    *
+ *                                                                            *
+ * Comments: The queued statements are sent to database in a single request   *
+ *           before the next select statement, with transaction commit or     *
+ *           when pipeline is ended. Queuing stops at the end of transaction. *
+ *                                                                            *
+ *           Queued statements return ZBX_DB_OK instead of the number of      *
+ *           affected rows and their errors are reported by the statement     *
+ *           that sends the queue, so pipeline must be used only by code that *
+ *           does not depend on results of individual statements.             *
+ *                                                                            *
+ *           Supported by MySQL and PostgreSQL, ignored by other databases.   *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_db_pipeline_begin(void)
+{
+	if (0 == txn_level)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		return;
+	}
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	pipeline_active = 1;
+#endif
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: send the queued statements and stop queuing                       *
+ *                                                                            *
+ * Return value: ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *               or number of rows affected (on success)                      *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_pipeline_end(void)
+{
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	int	ret;
+
+	ret = db_pipeline_flush();
+	pipeline_active = 0;
+
+	return ret;
+#else
+	return ZBX_DB_OK;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: start transaction                                                 *
@@ -1068,6 +1191,13 @@ int	zbx_db_commit_basic(void)
 #elif defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL) || defined(HAVE_SQLITE3)
 	rc = zbx_db_execute_basic("commit;");
 #endif
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	/* commit is queued if pipeline is active, send it together with the queued statements */
+	if (ZBX_DB_OK <= rc)
+		rc = db_pipeline_flush();
+
+	pipeline_active = 0;
+#endif
 
 	if (ZBX_DB_OK > rc) { /* commit failed */
 		txn_error = rc;
@@ -1110,6 +1240,11 @@ int	zbx_db_rollback_basic(void)
 	/* allow rollback of failed transaction */
 	txn_error = ZBX_DB_OK;
 
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	/* the queued statements would be rolled back anyway */
+	db_pipeline_reset();
+#endif
+
 #if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
 	rc = zbx_db_execute_basic("rollback;");
 #elif defined(HAVE_ORACLE)
@@ -1482,6 +1617,19 @@ int	zbx_db_vexecute(const char *fmt, va_list args)
 		goto clean;
 	}
 
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	if (0 != pipeline_active)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "queue query [txnlev:%d] [%s]", txn_level, sql);
+
+		db_pipeline_queue(sql);
+
+		if (ZBX_DB_PIPELINE_SIZE <= pipeline_sql_offset)
+			ret = db_pipeline_flush();
+
+		goto clean;
+	}
+#endif
 	zabbix_log(LOG_LEVEL_DEBUG, "query [txnlev:%d] [%s]", txn_level, sql);
 
 #if defined(HAVE_MYSQL)
@@ -1625,6 +1773,144 @@ clean:
 	return ret;
 }
 
+#if defined(HAVE_POSTGRESQL)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check PostgreSQL result and log error if the result status does   *
+ *          not match the expected one                                        *
+ *                                                                            *
+ * Return value: ZBX_DB_OK, ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on         *
+ *               recoverable error)                                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	postgresql_check_result(PGresult *result, ExecStatusType status, const char *sql)
+{
+	zbx_err_codes_t	errcode;
+	char		*error = NULL;
+
+	if (NULL == result)
+	{
+		zbx_db_errlog(ERR_Z3005, 0, "result is NULL", sql);
+		return CONNECTION_OK == PQstatus(conn) ? ZBX_DB_FAIL : ZBX_DB_DOWN;
+	}
+
+	if (status == PQresultStatus(result))
+		return ZBX_DB_OK;
+
+	zbx_postgresql_error(&error, result);
+
+	if (0 == zbx_strcmp_null(PQresultErrorField(result, PG_DIAG_SQLSTATE), "23505"))
+		errcode = ERR_Z3008;
+	else
+		errcode = ERR_Z3005;
+
+	zbx_db_errlog(errcode, 0, error, sql);
+	zbx_free(error);
+
+	return SUCCEED == is_recoverable_postgresql_error(conn, result) ? ZBX_DB_DOWN : ZBX_DB_FAIL;
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: copy rows into table with COPY ... FROM STDIN statement           *
+ *                                                                            *
+ * Parameters: sql  - [IN] the COPY statement                                 *
+ *             data - [IN] the rows in the format specified by statement      *
+ *             size - [IN] the data size                                      *
+ *                                                                            *
+ * Return value: ZBX_DB_FAIL (on error) or ZBX_DB_DOWN (on recoverable error) *
+ *               or number of rows copied (on success)                        *
+ *                                                                            *
+ * Comments: Supported only by PostgreSQL, fails with other databases.        *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_copy_basic(const char *sql, const char *data, size_t size)
+{
+#if defined(HAVE_POSTGRESQL)
+	int		ret;
+	double		sec = 0;
+	PGresult	*result;
+	size_t		offset;
+
+	if (0 != config_log_slow_queries)
+		sec = zbx_time();
+
+	if (0 == txn_level)
+		zabbix_log(LOG_LEVEL_DEBUG, "query without transaction detected");
+
+	if (ZBX_DB_OK != txn_error)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "ignoring query [txnlev:%d] [%s] within failed transaction", txn_level,
+				sql);
+		return ZBX_DB_FAIL;
+	}
+
+	if (ZBX_DB_OK > (ret = db_pipeline_flush()))
+		return ret;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "query [txnlev:%d] [%s] data size:" ZBX_FS_SIZE_T, txn_level, sql,
+			(zbx_fs_size_t)size);
+
+	result = PQexec(conn, sql);
+	ret = postgresql_check_result(result, PGRES_COPY_IN, sql);
+	PQclear(result);
+
+	if (ZBX_DB_OK != ret)
+		goto out;
+
+	/* PQputCopyData() takes data size as int, send large data in chunks */
+	for (offset = 0; offset < size; offset += ZBX_MEBIBYTE)
+	{
+		int	chunk_size = (int)MIN(size - offset, ZBX_MEBIBYTE);
+
+		if (1 != PQputCopyData(conn, data + offset, chunk_size))
+			break;
+	}
+
+	if (offset < size)
+		PQputCopyEnd(conn, "cannot send data");
+	else
+		PQputCopyEnd(conn, NULL);
+
+	result = PQgetResult(conn);
+
+	if (ZBX_DB_OK == (ret = postgresql_check_result(result, PGRES_COMMAND_OK, sql)))
+		ret = atoi(PQcmdTuples(result));
+
+	PQclear(result);
+
+	/* consume the remaining results so the connection is ready for the next query */
+	while (NULL != (result = PQgetResult(conn)))
+		PQclear(result);
+out:
+	if (0 != config_log_slow_queries)
+	{
+		sec = zbx_time() - sec;
+		if (sec > (double)config_log_slow_queries / 1000.0)
+			zabbix_log(LOG_LEVEL_WARNING, "slow query: " ZBX_FS_DBL " sec, \"%s\"", sec, sql);
+	}
+
+	if (ZBX_DB_FAIL == ret && 0 < txn_level)
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "query [%s] failed, setting transaction as failed", sql);
+		txn_error = ZBX_DB_FAIL;
+	}
+
+	return ret;
+#else
+	ZBX_UNUSED(data);
+	ZBX_UNUSED(size);
+
+	zbx_db_errlog(ERR_Z3005, 0, "bulk copy is supported only by PostgreSQL database", sql);
+
+	if (0 < txn_level)
+		txn_error = ZBX_DB_FAIL;
+
+	return ZBX_DB_FAIL;
+#endif
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: execute a select statement                                        *
@@ -1660,6 +1946,20 @@ zbx_db_result_t	zbx_db_vselect(const char *fmt, va_list args)
 		goto clean;
 	}
 
+#if defined(HAVE_MYSQL) || defined(HAVE_POSTGRESQL)
+	/* the select might depend on the queued statements */
+	switch (db_pipeline_flush())
+	{
+		case ZBX_DB_DOWN:
+			result = (zbx_db_result_t)ZBX_DB_DOWN;
+			goto clean;
+		case ZBX_DB_FAIL:
+			goto clean;
+		default:
+			break;
+	}
+#endif
+
 	zabbix_log(LOG_LEVEL_DEBUG, "query [txnlev:%d] [%s]", txn_level, sql);
 
 #if defined(HAVE_MYSQL)
@@ -3213,6 +3213,408 @@ zbx_uint64_t	zbx_db_insert_get_lastid(zbx_db_insert_t *self)
 	return self->lastid;
 }
 
+/* PostgreSQL binary COPY format signature */
+#define ZBX_DB_COPY_SIGNATURE		"PGCOPY\n\377\r\n"
+#define ZBX_DB_COPY_SIGNATURE_LEN	11
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reserves space for bulk copy data                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_reserve(zbx_db_copy_t *self, size_t size)
+{
+	if (self->data_alloc - self->data_offset >= size)
+		return;
+
+	while (self->data_alloc - self->data_offset < size)
+		self->data_alloc *= 2;
+
+	self->data = (char *)zbx_realloc(self->data, self->data_alloc);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds integer in network byte order to bulk copy data              *
+ *                                                                            *
+ * Parameters: self  - [IN] the bulk copy data                                *
+ *             value - [IN] the value to add                                  *
+ *             size  - [IN] the integer size in bytes                         *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_add_int(zbx_db_copy_t *self, zbx_uint64_t value, size_t size)
+{
+	unsigned char	*ptr;
+
+	db_copy_reserve(self, size);
+
+	self->data_offset += size;
+	ptr = (unsigned char *)self->data + self->data_offset;
+
+	while (0 != size--)
+	{
+		*(--ptr) = (unsigned char)value;
+		value >>= 8;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds unsigned 64 bit integer as PostgreSQL numeric value          *
+ *                                                                            *
+ * Comments: Numeric value is stored as base 10000 digits starting with the   *
+ *           most significant, the weight is the power of the first digit.    *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_add_numeric(zbx_db_copy_t *self, zbx_uint64_t value)
+{
+	zbx_uint64_t	digits[5];
+	int		digits_num = 0, weight, i;
+
+	for (; 0 != value; value /= 10000)
+		digits[digits_num++] = value % 10000;
+
+	weight = (0 != digits_num ? digits_num - 1 : 0);
+
+	/* trailing zero digits are not stored */
+	for (i = 0; i < digits_num && 0 == digits[i]; i++)
+		;
+
+	db_copy_add_int(self, (zbx_uint64_t)(8 + (digits_num - i) * 2), 4);
+	db_copy_add_int(self, (zbx_uint64_t)(digits_num - i), 2);
+	db_copy_add_int(self, (zbx_uint64_t)weight, 2);
+	db_copy_add_int(self, 0, 2);	/* positive sign */
+	db_copy_add_int(self, 0, 2);	/* display scale */
+
+	while (i < digits_num)
+		db_copy_add_int(self, digits[--digits_num], 2);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds field value to bulk copy data                                *
+ *                                                                            *
+ * Parameters: self  - [IN] the bulk copy data                                *
+ *             field - [IN] the field                                         *
+ *             value - [IN] the value to add                                  *
+ *                                                                            *
+ * Comments: String values are truncated to the field length in the same way  *
+ *           as with bulk insert, binary values are Base64 decoded.           *
+ *                                                                            *
+ ******************************************************************************/
+static void	db_copy_add_value(zbx_db_copy_t *self, const zbx_db_field_t *field, const zbx_db_value_t *value)
+{
+	zbx_uint64_t	dbl_bits;
+	size_t		len;
+
+	switch (field->type)
+	{
+		case ZBX_TYPE_CHAR:
+		case ZBX_TYPE_TEXT:
+		case ZBX_TYPE_SHORTTEXT:
+		case ZBX_TYPE_LONGTEXT:
+		case ZBX_TYPE_CUID:
+			len = zbx_strlen_utf8_nchars(value->str, get_string_field_chars(field));
+			db_copy_add_int(self, (zbx_uint64_t)len, 4);
+			db_copy_reserve(self, len);
+			memcpy(self->data + self->data_offset, value->str, len);
+			self->data_offset += len;
+			break;
+		case ZBX_TYPE_BLOB:
+			len = strlen(value->str) * 3 / 4 + 1;
+			db_copy_reserve(self, len + 4);
+			zbx_base64_decode(value->str, self->data + self->data_offset + 4, len, &len);
+			db_copy_add_int(self, (zbx_uint64_t)len, 4);
+			self->data_offset += len;
+			break;
+		case ZBX_TYPE_INT:
+			db_copy_add_int(self, 4, 4);
+			db_copy_add_int(self, (zbx_uint64_t)value->i32, 4);
+			break;
+		case ZBX_TYPE_FLOAT:
+			memcpy(&dbl_bits, &value->dbl, sizeof(dbl_bits));
+			db_copy_add_int(self, 8, 4);
+			db_copy_add_int(self, dbl_bits, 8);
+			break;
+		case ZBX_TYPE_ID:
+			db_copy_add_int(self, 8, 4);
+			db_copy_add_int(self, value->ui64, 8);
+			break;
+		case ZBX_TYPE_UINT:
+			db_copy_add_numeric(self, value->ui64);
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			exit(EXIT_FAILURE);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: releases resources allocated by bulk copy operations              *
+ *                                                                            *
+ * Parameters: self - [IN] the bulk copy data                                 *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_db_copy_clean(zbx_db_copy_t *self)
+{
+	zbx_free(self->data);
+	zbx_vector_ptr_destroy(&self->fields);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepare for database bulk copy operation                          *
+ *                                                                            *
+ * Parameters: self        - [IN] the bulk copy data                          *
+ *             table       - [IN] the target table name                       *
+ *             fields      - [IN] names of the fields to copy                 *
+ *             fields_num  - [IN] the number of items in fields array         *
+ *                                                                            *
+ * Comments: Bulk copy is an alternative to bulk insert for large amounts of  *
+ *           rows. The rows are encoded when added and sent to database with  *
+ *           a single COPY statement. Supported only by PostgreSQL.           *
+ *                                                                            *
+ *           Usage example:                                                   *
+ *             zbx_db_copy_t copy;                                            *
+ *                                                                            *
+ *             zbx_db_copy_prepare(&copy, "history", "id", "value");          *
+ *             zbx_db_copy_add_values(&copy, (zbx_uint64_t)1, 1.0);           *
+ *             zbx_db_copy_add_values(&copy, (zbx_uint64_t)2, 2.0);           *
+ *               ...                                                          *
+ *             zbx_db_copy_execute(&copy);                                    *
+ *             zbx_db_copy_clean(&copy);                                      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_db_copy_prepare_dyn(zbx_db_copy_t *self, const zbx_db_table_t *table, const zbx_db_field_t **fields,
+		int fields_num)
+{
+	int	i;
+
+	if (0 == fields_num)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		exit(EXIT_FAILURE);
+	}
+
+	zbx_vector_ptr_create(&self->fields);
+
+	self->table = table;
+
+	for (i = 0; i < fields_num; i++)
+		zbx_vector_ptr_append(&self->fields, (zbx_db_field_t *)fields[i]);
+
+	self->rows_num = 0;
+	self->data_alloc = ZBX_KIBIBYTE;
+	self->data_offset = 0;
+	self->data = (char *)zbx_malloc(NULL, self->data_alloc);
+
+	/* header - signature, flags and header extension length */
+	memcpy(self->data, ZBX_DB_COPY_SIGNATURE, ZBX_DB_COPY_SIGNATURE_LEN);
+	self->data_offset = ZBX_DB_COPY_SIGNATURE_LEN;
+	db_copy_add_int(self, 0, 4);
+	db_copy_add_int(self, 0, 4);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: prepare for database bulk copy operation                          *
+ *                                                                            *
+ * Parameters: self  - [IN] the bulk copy data                                *
+ *             table - [IN] the target table name                             *
+ *             ...   - [IN] names of the fields to copy                       *
+ *             NULL  - [IN] terminating NULL pointer                          *
+ *                                                                            *
+ * Comments: This is a convenience wrapper for zbx_db_copy_prepare_dyn()      *
+ *           function.                                                        *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_db_copy_prepare(zbx_db_copy_t *self, const char *table, ...)
+{
+	zbx_vector_ptr_t	fields;
+	va_list			args;
+	char			*field;
+	const zbx_db_table_t	*ptable;
+	const zbx_db_field_t	*pfield;
+
+	/* find the table and fields in database schema */
+	if (NULL == (ptable = zbx_db_get_table(table)))
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		exit(EXIT_FAILURE);
+	}
+
+	va_start(args, table);
+
+	zbx_vector_ptr_create(&fields);
+
+	while (NULL != (field = va_arg(args, char *)))
+	{
+		if (NULL == (pfield = zbx_db_get_field(ptable, field)))
+		{
+			zabbix_log(LOG_LEVEL_ERR, "Cannot locate table \"%s\" field \"%s\" in database schema",
+					table, field);
+			THIS_SHOULD_NEVER_HAPPEN;
+			exit(EXIT_FAILURE);
+		}
+		zbx_vector_ptr_append(&fields, (zbx_db_field_t *)pfield);
+	}
+
+	va_end(args);
+
+	zbx_db_copy_prepare_dyn(self, ptable, (const zbx_db_field_t **)fields.values, fields.values_num);
+
+	zbx_vector_ptr_destroy(&fields);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds row values for database bulk copy operation                  *
+ *                                                                            *
+ * Parameters: self        - [IN] the bulk copy data                          *
+ *             values      - [IN] the values to copy                          *
+ *             values_num  - [IN] the number of items in values array         *
+ *                                                                            *
+ * Comments: The values must be listed in the same order as the field names   *
+ *           for copy preparation functions.                                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_db_copy_add_values_dyn(zbx_db_copy_t *self, zbx_db_value_t **values, int values_num)
+{
+	int	i;
+
+	if (values_num != self->fields.values_num)
+	{
+		THIS_SHOULD_NEVER_HAPPEN;
+		exit(EXIT_FAILURE);
+	}
+
+	db_copy_add_int(self, (zbx_uint64_t)self->fields.values_num, 2);
+
+	for (i = 0; i < self->fields.values_num; i++)
+		db_copy_add_value(self, (const zbx_db_field_t *)self->fields.values[i], values[i]);
+
+	self->rows_num++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: adds row values for database bulk copy operation                  *
+ *                                                                            *
+ * Parameters: self - [IN] the bulk copy data                                 *
+ *             ...  - [IN] the values to copy                                 *
+ *                                                                            *
+ * Comments: The values are encoded directly without creating value array     *
+ *           for zbx_db_copy_add_values_dyn() function.                       *
+ *           Note that the types of the passed values must conform to the     *
+ *           corresponding field types.                                       *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_db_copy_add_values(zbx_db_copy_t *self, ...)
+{
+	va_list			args;
+	int			i;
+	const zbx_db_field_t	*field;
+	zbx_db_value_t		value;
+
+	va_start(args, self);
+
+	db_copy_add_int(self, (zbx_uint64_t)self->fields.values_num, 2);
+
+	for (i = 0; i < self->fields.values_num; i++)
+	{
+		field = (const zbx_db_field_t *)self->fields.values[i];
+
+		switch (field->type)
+		{
+			case ZBX_TYPE_CHAR:
+			case ZBX_TYPE_TEXT:
+			case ZBX_TYPE_SHORTTEXT:
+			case ZBX_TYPE_LONGTEXT:
+			case ZBX_TYPE_CUID:
+			case ZBX_TYPE_BLOB:
+				value.str = va_arg(args, char *);
+				break;
+			case ZBX_TYPE_INT:
+				value.i32 = va_arg(args, int);
+				break;
+			case ZBX_TYPE_FLOAT:
+				value.dbl = va_arg(args, double);
+				break;
+			case ZBX_TYPE_UINT:
+			case ZBX_TYPE_ID:
+				value.ui64 = va_arg(args, zbx_uint64_t);
+				break;
+			default:
+				THIS_SHOULD_NEVER_HAPPEN;
+				exit(EXIT_FAILURE);
+		}
+
+		db_copy_add_value(self, field, &value);
+	}
+
+	va_end(args);
+
+	self->rows_num++;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes the prepared database bulk copy operation                *
+ *                                                                            *
+ * Parameters: self - [IN] the bulk copy data                                 *
+ *                                                                            *
+ * Return value: SUCCEED if the operation completed successfully or           *
+ *               FAIL otherwise.                                              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_db_copy_execute(zbx_db_copy_t *self)
+{
+	char	*sql = NULL;
+	size_t	sql_alloc = 0, sql_offset = 0;
+	int	i, rc;
+
+	if (0 == self->rows_num)
+		return SUCCEED;
+
+	zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "copy %s (", self->table->table);
+
+	for (i = 0; i < self->fields.values_num; i++)
+	{
+		const zbx_db_field_t	*field = (const zbx_db_field_t *)self->fields.values[i];
+
+		zbx_snprintf_alloc(&sql, &sql_alloc, &sql_offset, "%s,", field->name);
+	}
+
+	sql_offset--;
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, ") from stdin (format binary)");
+
+	/* trailer - field count of -1 */
+	db_copy_add_int(self, 0xffff, 2);
+
+	rc = zbx_db_copy_basic(sql, self->data, self->data_offset);
+
+	while (ZBX_DB_DOWN == rc)
+	{
+		zbx_db_close();
+		zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
+
+		if (ZBX_DB_DOWN == (rc = zbx_db_copy_basic(sql, self->data, self->data_offset)))
+		{
+			zabbix_log(LOG_LEVEL_ERR, "database is down: retrying in %d seconds", ZBX_DB_WAIT_DOWN);
+			connection_failure = 1;
+			sleep(ZBX_DB_WAIT_DOWN);
+		}
+	}
+
+	/* remove trailer so the operation can be executed again */
+	self->data_offset -= 2;
+
+	zbx_free(sql);
+
+	return ZBX_DB_OK <= rc ? SUCCEED : FAIL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: determine is it a server or a proxy database                      *
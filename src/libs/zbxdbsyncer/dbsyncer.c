@@ -29,6 +29,7 @@
 #include "zbxalgo.h"
 #include "zbxcacheconfig.h"
 #include "zbxdbhigh.h"
+#include "zbxexpression.h"
 #include "zbxstr.h"
 #include "zbxthreads.h"
 
@@ -105,6 +106,8 @@ ZBX_THREAD_ENTRY(zbx_dbsyncer_thread, args)
 {
 	int			sleeptime = -1, total_values_num = 0, values_num, more, total_triggers_num = 0,
 				triggers_num;
+	zbx_uint64_t		funcs_evaluated, funcs_hits, funcs_misses, total_funcs_evaluated = 0;
+	zbx_dc_func_cache_stats_t	func_cache_stats = {0};
 	double			sec, total_sec = 0.0;
 	time_t			last_stat_time;
 	char			*stats = NULL;
@@ -123,6 +126,8 @@ ZBX_THREAD_ENTRY(zbx_dbsyncer_thread, args)
 
 	zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
+	zbx_hc_set_syncer_num(process_num);
+
 #define STAT_INTERVAL	5	/* if a process is busy and does not sleep then update status not faster than */
 				/* once in STAT_INTERVAL seconds */
 
@@ -177,6 +182,12 @@ ZBX_THREAD_ENTRY(zbx_dbsyncer_thread, args)
 
 		total_values_num += values_num;
 		total_triggers_num += triggers_num;
+
+		zbx_get_trigger_functions_stats(&funcs_evaluated, &funcs_hits, &funcs_misses);
+		total_funcs_evaluated += funcs_evaluated;
+		func_cache_stats.hits += funcs_hits;
+		func_cache_stats.misses += funcs_misses;
+
 		total_sec += zbx_time() - sec;
 
 		sleeptime = (ZBX_SYNC_MORE == more ? 0 : dbsyncer_args->config_histsyncer_frequency);
@@ -191,6 +202,16 @@ ZBX_THREAD_ENTRY(zbx_dbsyncer_thread, args)
 			{
 				zbx_snprintf_alloc(&stats, &stats_alloc, &stats_offset, ", %d triggers",
 						total_triggers_num);
+
+				if (0 != func_cache_stats.hits)
+				{
+					zbx_snprintf_alloc(&stats, &stats_alloc, &stats_offset, " (" ZBX_FS_UI64
+							" functions evaluated, " ZBX_FS_UI64 " cached)",
+							total_funcs_evaluated, func_cache_stats.hits);
+				}
+
+				if (0 != func_cache_stats.hits || 0 != func_cache_stats.misses)
+					zbx_dc_update_func_cache_stats(&func_cache_stats);
 			}
 
 			zbx_snprintf_alloc(&stats, &stats_alloc, &stats_offset, " in " ZBX_FS_DBL " sec", total_sec);
@@ -207,6 +228,9 @@ ZBX_THREAD_ENTRY(zbx_dbsyncer_thread, args)
 
 			total_values_num = 0;
 			total_triggers_num = 0;
+			total_funcs_evaluated = 0;
+			func_cache_stats.hits = 0;
+			func_cache_stats.misses = 0;
 			total_sec = 0.0;
 			last_stat_time = time(NULL);
 		}
@@ -392,7 +392,7 @@ int	zbx_check_access_passive_proxy(zbx_socket_t *sock, int send_response, const
 	}
 	else if (ZBX_TCP_SEC_TLS_PSK == sock->connection_type)
 	{
-		if (0 != (ZBX_PSK_FOR_PROXY & zbx_tls_get_psk_usage()))
+		if (0 != (ZBX_PSK_FOR_PROXY & zbx_tls_get_psk_usage(sock)))
 			return SUCCEED;
 
 		zabbix_log(LOG_LEVEL_WARNING, "%s from server \"%s\" is not allowed: it used PSK which is not"
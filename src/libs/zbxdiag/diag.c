@@ -23,6 +23,7 @@
 #include "zbxalgo.h"
 #include "zbxshmem.h"
 #include "zbxcachehistory.h"
+#include "zbxcacheconfig.h"
 #include "zbxconnector.h"
 #include "zbxlog.h"
 #include "zbxmutexs.h"
@@ -200,6 +201,22 @@ void	zbx_diag_add_mem_stats(struct zbx_json *json, const char *name, const zbx_s
 
 	zbx_json_close(json);
 	zbx_json_close(json);
+
+	if (0 != stats->slab_pages)
+	{
+		zbx_json_addobject(json, "slabs");
+		zbx_json_adduint64(json, "pages", stats->slab_pages);
+		zbx_json_addobject(json, "objects");
+		zbx_json_adduint64(json, "free", stats->slab_free_objects);
+		zbx_json_adduint64(json, "used", stats->slab_used_objects);
+		zbx_json_close(json);
+		zbx_json_addobject(json, "size");
+		zbx_json_adduint64(json, "free", stats->slab_free_size);
+		zbx_json_adduint64(json, "used", stats->slab_used_size);
+		zbx_json_close(json);
+		zbx_json_close(json);
+	}
+
 	zbx_json_close(json);
 }
 
@@ -429,13 +446,33 @@ void	zbx_diag_add_locks_info(struct zbx_json *json)
 #endif
 	zbx_json_addarray(json, ZBX_DIAG_LOCKS);
 
-	for (i = 0; i < ZBX_MUTEX_COUNT; i++)
+	for (i = 0; i < ZBX_MUTEX_HISTORY_QUEUE; i++)
 	{
 		zbx_json_addobject(json, NULL);
 		zbx_json_addhex(json, names[i], (zbx_uint64_t)zbx_mutex_addr_get(i));
 		zbx_json_close(json);
 	}
 
+	for (i = ZBX_MUTEX_HISTORY_QUEUE; i <= ZBX_MUTEX_HISTORY_QUEUE_LAST; i++)
+	{
+		char	name[64];
+
+		zbx_snprintf(name, sizeof(name), "ZBX_MUTEX_HISTORY_QUEUE_%d", i - ZBX_MUTEX_HISTORY_QUEUE);
+		zbx_json_addobject(json, NULL);
+		zbx_json_addhex(json, name, (zbx_uint64_t)zbx_mutex_addr_get(i));
+		zbx_json_close(json);
+	}
+
+	for (i = ZBX_MUTEX_POLLER_QUEUE; i <= ZBX_MUTEX_POLLER_QUEUE_LAST; i++)
+	{
+		char	name[64];
+
+		zbx_snprintf(name, sizeof(name), "ZBX_MUTEX_POLLER_QUEUE_%d", i - ZBX_MUTEX_POLLER_QUEUE);
+		zbx_json_addobject(json, NULL);
+		zbx_json_addhex(json, name, (zbx_uint64_t)zbx_mutex_addr_get(i));
+		zbx_json_close(json);
+	}
+
 	zbx_json_addobject(json, NULL);
 	zbx_json_addhex(json, "ZBX_RWLOCK_CONFIG", (zbx_uint64_t)zbx_rwlock_addr_get(ZBX_RWLOCK_CONFIG));
 	zbx_json_close(json);
@@ -451,6 +488,54 @@ void	zbx_diag_add_locks_info(struct zbx_json *json)
 	zbx_json_close(json);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add poller queue diagnostic information to json data              *
+ *                                                                            *
+ * Parameters: json  - [IN/OUT] the json to update                            *
+ *                                                                            *
+ * Comments: The latency.<N>s fields contain the number of items taken by     *
+ *           pollers at least N seconds (but less than the next field) after  *
+ *           their scheduled check time.                                      *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_diag_add_pollers_info(struct zbx_json *json)
+{
+	int			i, j;
+	const char		*names[ZBX_POLLER_TYPE_COUNT] = {"normal", "unreachable", "ipmi", "pinger", "java",
+					"history", "odbc", "http agent", "agent", "snmp", "internal"};
+	const char		*latency[ZBX_POLLER_LATENCY_BUCKETS] = {"latency.0s", "latency.1s", "latency.5s",
+					"latency.10s", "latency.30s", "latency.60s"};
+	zbx_dc_poller_stats_t	stats[ZBX_POLLER_TYPE_COUNT];
+
+	zbx_dc_get_poller_stats(stats);
+
+	zbx_json_addarray(json, ZBX_DIAG_POLLERS);
+
+	for (i = 0; i < ZBX_POLLER_TYPE_COUNT; i++)
+	{
+		zbx_uint64_t	taken = 0;
+
+		for (j = 0; j < ZBX_POLLER_LATENCY_BUCKETS; j++)
+			taken += stats[i].latency[j];
+
+		if (0 == stats[i].queued && 0 == stats[i].scheduled && 0 == taken)
+			continue;
+
+		zbx_json_addobject(json, NULL);
+		zbx_json_addstring(json, "poller", names[i], ZBX_JSON_TYPE_STRING);
+		zbx_json_addint64(json, "queued", stats[i].queued);
+		zbx_json_addint64(json, "scheduled", stats[i].scheduled);
+
+		for (j = 0; j < ZBX_POLLER_LATENCY_BUCKETS; j++)
+			zbx_json_adduint64(json, latency[j], stats[i].latency[j]);
+
+		zbx_json_close(json);
+	}
+
+	zbx_json_close(json);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get diagnostic information                                        *
@@ -555,6 +640,9 @@ static void	diag_prepare_default_request(struct zbx_json *j, unsigned int flags)
 	if (0 != (flags & (1 << ZBX_DIAGINFO_PROXYBUFFER)))
 		diag_add_section_request(j, ZBX_DIAG_PROXYBUFFER, NULL);
 
+	if (0 != (flags & (1 << ZBX_DIAGINFO_POLLERS)))
+		diag_add_section_request(j, ZBX_DIAG_POLLERS, NULL);
+
 }
 
 /******************************************************************************
@@ -898,6 +986,14 @@ void	zbx_diag_log_info(unsigned int flags, char **result)
 				diag_log_connector(&jp_section, result, &result_alloc, &result_offset);
 			else if (0 == strcmp(section, ZBX_DIAG_PROXYBUFFER))
 				diag_log_proxybuffer(&jp_section, result, &result_alloc, &result_offset);
+			else if (0 == strcmp(section, ZBX_DIAG_POLLERS))
+			{
+				zbx_strlog_alloc(LOG_LEVEL_INFORMATION, result, &result_alloc, &result_offset,
+						"== pollers diagnostic information ==");
+				diag_log_top_view(&jp_section, ZBX_DIAG_POLLERS, NULL, result, &result_alloc,
+						&result_offset);
+				zbx_strlog_alloc(LOG_LEVEL_INFORMATION, result, &result_alloc, &result_offset, "==");
+			}
 		}
 	}
 	else
@@ -2483,6 +2483,26 @@ static double	eval_math_func_signum(double x)
 	return 1;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if argument is in the domain of single parameter           *
+ *          mathematical function                                             *
+ *                                                                            *
+ * Return value: SUCCEED - the argument is valid                              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_math_func_check_arg(double (*func)(double), double arg)
+{
+	if (((log == func || log10 == func) && 0 >= arg) || (sqrt == func && 0 > arg) ||
+			(eval_math_func_cot == func && 0 == arg))
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluates mathematical function by calling passed function        *
@@ -2519,8 +2539,7 @@ static int	eval_execute_math_function_single_param(const zbx_eval_context_t *ctx
 	input_value = output->values[output->values_num - 1].data.vector;
 	arg = &input_value->values[0];
 
-	if (((log == func || log10 == func) && 0 >= arg->data.dbl) || (sqrt == func && 0 > arg->data.dbl) ||
-			(eval_math_func_cot == func && 0 == arg->data.dbl))
+	if (SUCCEED != eval_math_func_check_arg(func, arg->data.dbl))
 	{
 		*error = zbx_dsprintf(*error, "invalid argument for function at \"%s\"",
 				ctx->expression + token->loc.l);
@@ -2566,6 +2585,29 @@ static double	eval_math_func_truncate(double n, double decimal_points)
 	return floor(multiplier * n) / multiplier;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if arguments are in the domain of double parameter         *
+ *          mathematical function                                             *
+ *                                                                            *
+ * Return value: SUCCEED - the arguments are valid                            *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_math_func_check_args(double (*func)(double, double), double arg1, double arg2)
+{
+	if (((eval_math_func_round == func || eval_math_func_truncate == func) && (0 > arg2 ||
+			0.0 != fmod(arg2, 1))) || (fmod == func && 0.0 == arg2))
+	{
+		return FAIL;
+	}
+
+	if (atan2 == func && 0.0 == arg1 && 0.0 == arg2)
+		return FAIL;
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluates mathematical function by calling passed function        *
@@ -2604,19 +2646,18 @@ static int	eval_execute_math_function_double_param(const zbx_eval_context_t *ctx
 	arg1 = &input_vector->values[0];
 	arg2 = &input_vector->values[1];
 
-	if (((eval_math_func_round == func || eval_math_func_truncate == func) && (0 > arg2->data.dbl ||
-			0.0 != fmod(arg2->data.dbl, 1))) || (fmod == func && 0.0 == arg2->data.dbl))
-	{
-		*error = zbx_dsprintf(*error, "invalid second argument for function at \"%s\"",
-				ctx->expression + token->loc.l);
-
-		return FAIL;
-	}
-
-	if (atan2 == func && 0.0 == arg1->data.dbl && 0.0 == arg2->data.dbl)
+	if (SUCCEED != eval_math_func_check_args(func, arg1->data.dbl, arg2->data.dbl))
 	{
-		*error = zbx_dsprintf(*error, "undefined result for arguments (0,0) for function 'atan2' at \"%s\"",
-				ctx->expression + token->loc.l);
+		if (atan2 == func)
+		{
+			*error = zbx_dsprintf(*error, "undefined result for arguments (0,0) for function 'atan2'"
+					" at \"%s\"", ctx->expression + token->loc.l);
+		}
+		else
+		{
+			*error = zbx_dsprintf(*error, "invalid second argument for function at \"%s\"",
+					ctx->expression + token->loc.l);
+		}
 
 		return FAIL;
 	}
@@ -2962,6 +3003,172 @@ static int	eval_execute_function_xmlxpath(const zbx_eval_context_t *ctx, const z
 #endif
 }
 
+typedef int	(*eval_function_exec_t)(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
+		zbx_vector_var_t *output, char **error);
+
+typedef enum
+{
+	EVAL_FUNCTION_GENERIC,
+	EVAL_FUNCTION_BITWISE,
+	EVAL_FUNCTION_TRIM,
+	EVAL_FUNCTION_MATH1,
+	EVAL_FUNCTION_MATH2,
+	EVAL_FUNCTION_CONST,
+	EVAL_FUNCTION_STAT
+}
+eval_function_type_t;
+
+/* common function definition, the function handler depends on function type */
+typedef struct
+{
+	const char		*name;
+	size_t			name_len;
+	eval_function_type_t	type;
+	eval_function_exec_t	exec;
+	double			(*math1)(double);
+	double			(*math2)(double, double);
+	zbx_statistical_func_t	stat;
+	int			optype;
+	double			value;
+}
+eval_function_t;
+
+#define EVAL_FUNCTION(name, exec)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_GENERIC, exec, NULL, NULL, NULL, 0, 0}
+#define EVAL_FUNCTION_BITWISE(name, optype)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_BITWISE, NULL, NULL, NULL, NULL, optype, 0}
+#define EVAL_FUNCTION_TRIM(name, optype)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_TRIM, NULL, NULL, NULL, NULL, optype, 0}
+#define EVAL_FUNCTION_MATH1(name, func)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_MATH1, NULL, func, NULL, NULL, 0, 0}
+#define EVAL_FUNCTION_MATH2(name, func)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_MATH2, NULL, NULL, func, NULL, 0, 0}
+#define EVAL_FUNCTION_CONST(name, value)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_CONST, NULL, NULL, NULL, NULL, 0, value}
+#define EVAL_FUNCTION_STAT(name, func)	\
+		{name, ZBX_CONST_STRLEN(name), EVAL_FUNCTION_STAT, NULL, NULL, NULL, func, 0, 0}
+
+/* common functions, sorted by name for binary search */
+static const eval_function_t	eval_functions[] = {
+	EVAL_FUNCTION("abs", eval_execute_function_abs),
+	EVAL_FUNCTION_MATH1("acos", acos),
+	EVAL_FUNCTION("ascii", eval_execute_function_ascii),
+	EVAL_FUNCTION_MATH1("asin", asin),
+	EVAL_FUNCTION_MATH1("atan", atan),
+	EVAL_FUNCTION_MATH2("atan2", atan2),
+	EVAL_FUNCTION("avg", eval_execute_function_avg),
+	EVAL_FUNCTION("between", eval_execute_function_between),
+	EVAL_FUNCTION_BITWISE("bitand", FUNCTION_OPTYPE_BIT_AND),
+	EVAL_FUNCTION("bitlength", eval_execute_function_bitlength),
+	EVAL_FUNCTION_BITWISE("bitlshift", FUNCTION_OPTYPE_BIT_LSHIFT),
+	EVAL_FUNCTION("bitnot", eval_execute_function_bitnot),
+	EVAL_FUNCTION_BITWISE("bitor", FUNCTION_OPTYPE_BIT_OR),
+	EVAL_FUNCTION_BITWISE("bitrshift", FUNCTION_OPTYPE_BIT_RSHIFT),
+	EVAL_FUNCTION_BITWISE("bitxor", FUNCTION_OPTYPE_BIT_XOR),
+	EVAL_FUNCTION("bytelength", eval_execute_function_bytelength),
+	EVAL_FUNCTION_MATH1("cbrt", cbrt),
+	EVAL_FUNCTION_MATH1("ceil", ceil),
+	EVAL_FUNCTION("char", eval_execute_function_char),
+	EVAL_FUNCTION("concat", eval_execute_function_concat),
+	EVAL_FUNCTION_MATH1("cos", cos),
+	EVAL_FUNCTION_MATH1("cosh", cosh),
+	EVAL_FUNCTION_MATH1("cot", eval_math_func_cot),
+	EVAL_FUNCTION("count", eval_execute_function_count),
+	EVAL_FUNCTION("date", eval_execute_function_date),
+	EVAL_FUNCTION("dayofmonth", eval_execute_function_dayofmonth),
+	EVAL_FUNCTION("dayofweek", eval_execute_function_dayofweek),
+	EVAL_FUNCTION_MATH1("degrees", eval_math_func_degrees),
+	EVAL_FUNCTION_CONST("e", ZBX_MATH_CONST_E),
+	EVAL_FUNCTION_MATH1("exp", exp),
+	EVAL_FUNCTION_MATH1("expm1", expm1),
+	EVAL_FUNCTION_MATH1("floor", floor),
+	EVAL_FUNCTION("histogram_quantile", eval_execute_function_histogram_quantile),
+	EVAL_FUNCTION("in", eval_execute_function_in),
+	EVAL_FUNCTION("insert", eval_execute_function_insert),
+	EVAL_FUNCTION("jsonpath", eval_execute_function_jsonpath),
+	EVAL_FUNCTION_STAT("kurtosis", zbx_eval_calc_kurtosis),
+	EVAL_FUNCTION("left", eval_execute_function_left),
+	EVAL_FUNCTION("length", eval_execute_function_length),
+	EVAL_FUNCTION_MATH1("log", log),
+	EVAL_FUNCTION_MATH1("log10", log10),
+	EVAL_FUNCTION_TRIM("ltrim", FUNCTION_OPTYPE_TRIM_LEFT),
+	EVAL_FUNCTION_STAT("mad", zbx_eval_calc_mad),
+	EVAL_FUNCTION("max", eval_execute_function_max),
+	EVAL_FUNCTION("mid", eval_execute_function_mid),
+	EVAL_FUNCTION("min", eval_execute_function_min),
+	EVAL_FUNCTION_MATH2("mod", fmod),
+	EVAL_FUNCTION("now", eval_execute_function_now),
+	EVAL_FUNCTION_CONST("pi", ZBX_MATH_CONST_PI),
+	EVAL_FUNCTION_MATH2("power", pow),
+	EVAL_FUNCTION_MATH1("radians", eval_math_func_radians),
+	EVAL_FUNCTION_CONST("rand", ZBX_MATH_RANDOM),
+	EVAL_FUNCTION("repeat", eval_execute_function_repeat),
+	EVAL_FUNCTION("replace", eval_execute_function_replace),
+	EVAL_FUNCTION("right", eval_execute_function_right),
+	EVAL_FUNCTION_MATH2("round", eval_math_func_round),
+	EVAL_FUNCTION_TRIM("rtrim", FUNCTION_OPTYPE_TRIM_RIGHT),
+	EVAL_FUNCTION_MATH1("signum", eval_math_func_signum),
+	EVAL_FUNCTION_MATH1("sin", sin),
+	EVAL_FUNCTION_MATH1("sinh", sinh),
+	EVAL_FUNCTION_STAT("skewness", zbx_eval_calc_skewness),
+	EVAL_FUNCTION_MATH1("sqrt", sqrt),
+	EVAL_FUNCTION_STAT("stddevpop", zbx_eval_calc_stddevpop),
+	EVAL_FUNCTION_STAT("stddevsamp", zbx_eval_calc_stddevsamp),
+	EVAL_FUNCTION("sum", eval_execute_function_sum),
+	EVAL_FUNCTION_STAT("sumofsquares", zbx_eval_calc_sumofsquares),
+	EVAL_FUNCTION_MATH1("tan", tan),
+	EVAL_FUNCTION("time", eval_execute_function_time),
+	EVAL_FUNCTION_TRIM("trim", FUNCTION_OPTYPE_TRIM_ALL),
+	EVAL_FUNCTION_MATH2("truncate", eval_math_func_truncate),
+	EVAL_FUNCTION_STAT("varpop", zbx_eval_calc_varpop),
+	EVAL_FUNCTION_STAT("varsamp", zbx_eval_calc_varsamp),
+	EVAL_FUNCTION("xmlxpath", eval_execute_function_xmlxpath)
+};
+
+#undef EVAL_FUNCTION
+#undef EVAL_FUNCTION_BITWISE
+#undef EVAL_FUNCTION_TRIM
+#undef EVAL_FUNCTION_MATH1
+#undef EVAL_FUNCTION_MATH2
+#undef EVAL_FUNCTION_CONST
+#undef EVAL_FUNCTION_STAT
+
+static int	eval_function_compare(const void *d1, const void *d2)
+{
+	const eval_function_t	*f1 = (const eval_function_t *)d1;
+	const eval_function_t	*f2 = (const eval_function_t *)d2;
+	int			ret;
+
+	if (0 != (ret = memcmp(f1->name, f2->name, MIN(f1->name_len, f2->name_len))))
+		return ret;
+
+	ZBX_RETURN_IF_NOT_EQUAL(f1->name_len, f2->name_len);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: finds common function definition by function token name           *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             token - [IN] function token                                    *
+ *                                                                            *
+ * Return value: function definition or NULL if the function is not a         *
+ *               built-in common function                                     *
+ *                                                                            *
+ ******************************************************************************/
+static const eval_function_t	*eval_get_function(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token)
+{
+	eval_function_t	func_local;
+
+	func_local.name = ctx->expression + token->loc.l;
+	func_local.name_len = token->loc.r - token->loc.l + 1;
+
+	return (const eval_function_t *)bsearch(&func_local, eval_functions, ARRSIZE(eval_functions),
+			sizeof(eval_function_t), eval_function_compare);
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluates common function                                         *
@@ -2978,6 +3185,8 @@ static int	eval_execute_function_xmlxpath(const zbx_eval_context_t *ctx, const z
 static int	eval_execute_common_function(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
 		zbx_vector_var_t *output, char **error)
 {
+	const eval_function_t	*func;
+
 	if ((zbx_uint32_t)output->values_num < token->opt)
 	{
 		*error = zbx_dsprintf(*error, "not enough arguments for function at \"%s\"",
@@ -2985,155 +3194,28 @@ static int	eval_execute_common_function(const zbx_eval_context_t *ctx, const zbx
 		return FAIL;
 	}
 
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "min", ZBX_CONST_STRLEN("min")))
-		return eval_execute_function_min(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "max", ZBX_CONST_STRLEN("max")))
-		return eval_execute_function_max(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sum", ZBX_CONST_STRLEN("sum")))
-		return eval_execute_function_sum(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "avg", ZBX_CONST_STRLEN("avg")))
-		return eval_execute_function_avg(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "abs", ZBX_CONST_STRLEN("abs")))
-		return eval_execute_function_abs(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "length", ZBX_CONST_STRLEN("length")))
-		return eval_execute_function_length(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "date", ZBX_CONST_STRLEN("date")))
-		return eval_execute_function_date(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "time", ZBX_CONST_STRLEN("time")))
-		return eval_execute_function_time(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "now", ZBX_CONST_STRLEN("now")))
-		return eval_execute_function_now(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "dayofweek", ZBX_CONST_STRLEN("dayofweek")))
-		return eval_execute_function_dayofweek(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "dayofmonth", ZBX_CONST_STRLEN("dayofmonth")))
-		return eval_execute_function_dayofmonth(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitand", ZBX_CONST_STRLEN("bitand")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_AND, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitor", ZBX_CONST_STRLEN("bitor")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_OR, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitxor", ZBX_CONST_STRLEN("bitxor")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_XOR, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitlshift", ZBX_CONST_STRLEN("bitlshift")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_LSHIFT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitrshift", ZBX_CONST_STRLEN("bitrshift")))
-		return eval_execute_function_bitwise(ctx, token, FUNCTION_OPTYPE_BIT_RSHIFT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitnot", ZBX_CONST_STRLEN("bitnot")))
-		return eval_execute_function_bitnot(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "between", ZBX_CONST_STRLEN("between")))
-		return eval_execute_function_between(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "in", ZBX_CONST_STRLEN("in")))
-		return eval_execute_function_in(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "ascii", ZBX_CONST_STRLEN("ascii")))
-		return eval_execute_function_ascii(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "char", ZBX_CONST_STRLEN("char")))
-		return eval_execute_function_char(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "left", ZBX_CONST_STRLEN("left")))
-		return eval_execute_function_left(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "right", ZBX_CONST_STRLEN("right")))
-		return eval_execute_function_right(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "mid", ZBX_CONST_STRLEN("mid")))
-		return eval_execute_function_mid(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bitlength", ZBX_CONST_STRLEN("bitlength")))
-		return eval_execute_function_bitlength(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "bytelength", ZBX_CONST_STRLEN("bytelength")))
-		return eval_execute_function_bytelength(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "concat", ZBX_CONST_STRLEN("concat")))
-		return eval_execute_function_concat(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "insert", ZBX_CONST_STRLEN("insert")))
-		return eval_execute_function_insert(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "replace", ZBX_CONST_STRLEN("replace")))
-		return eval_execute_function_replace(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "repeat", ZBX_CONST_STRLEN("repeat")))
-		return eval_execute_function_repeat(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "ltrim", ZBX_CONST_STRLEN("ltrim")))
-		return eval_execute_function_trim(ctx, token, FUNCTION_OPTYPE_TRIM_LEFT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "rtrim", ZBX_CONST_STRLEN("rtrim")))
-		return eval_execute_function_trim(ctx, token, FUNCTION_OPTYPE_TRIM_RIGHT, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "trim", ZBX_CONST_STRLEN("trim")))
-		return eval_execute_function_trim(ctx, token, FUNCTION_OPTYPE_TRIM_ALL, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cbrt", ZBX_CONST_STRLEN("cbrt")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, cbrt);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "ceil", ZBX_CONST_STRLEN("ceil")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, ceil);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "exp", ZBX_CONST_STRLEN("exp")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, exp);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "expm1", ZBX_CONST_STRLEN("expm1")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, expm1);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "floor", ZBX_CONST_STRLEN("floor")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, floor);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "signum", ZBX_CONST_STRLEN("signum")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_signum);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "degrees", ZBX_CONST_STRLEN("degrees")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_degrees);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "radians", ZBX_CONST_STRLEN("radians")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_radians);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "acos", ZBX_CONST_STRLEN("acos")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, acos);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "asin", ZBX_CONST_STRLEN("asin")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, asin);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "atan", ZBX_CONST_STRLEN("atan")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, atan);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cos", ZBX_CONST_STRLEN("cos")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, cos);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cosh", ZBX_CONST_STRLEN("cosh")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, cosh);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "cot", ZBX_CONST_STRLEN("cot")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, eval_math_func_cot);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sin", ZBX_CONST_STRLEN("sin")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, sin);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sinh", ZBX_CONST_STRLEN("sinh")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, sinh);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "tan", ZBX_CONST_STRLEN("tan")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, tan);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "log", ZBX_CONST_STRLEN("log")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, log);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "log10", ZBX_CONST_STRLEN("log10")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, log10);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sqrt", ZBX_CONST_STRLEN("sqrt")))
-		return eval_execute_math_function_single_param(ctx, token, output, error, sqrt);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "power", ZBX_CONST_STRLEN("power")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, pow);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "round", ZBX_CONST_STRLEN("round")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, eval_math_func_round);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "mod", ZBX_CONST_STRLEN("mod")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, fmod);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "truncate", ZBX_CONST_STRLEN("truncate")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, eval_math_func_truncate);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "atan2", ZBX_CONST_STRLEN("atan2")))
-		return eval_execute_math_function_double_param(ctx, token, output, error, atan2);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "pi", ZBX_CONST_STRLEN("pi")))
-		return eval_execute_math_return_value(ctx, token, output, error, ZBX_MATH_CONST_PI);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "e", ZBX_CONST_STRLEN("e")))
-		return eval_execute_math_return_value(ctx, token, output, error, ZBX_MATH_CONST_E);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "rand", ZBX_CONST_STRLEN("rand")))
-		return eval_execute_math_return_value(ctx, token, output, error, ZBX_MATH_RANDOM);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "kurtosis", ZBX_CONST_STRLEN("kurtosis")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_kurtosis, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "mad", ZBX_CONST_STRLEN("mad")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_mad, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "skewness", ZBX_CONST_STRLEN("skewness")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_skewness, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "stddevpop", ZBX_CONST_STRLEN("stddevpop")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_stddevpop, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "stddevsamp", ZBX_CONST_STRLEN("stddevsamp")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_stddevsamp, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "sumofsquares", ZBX_CONST_STRLEN("sumofsquares")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_sumofsquares, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "varpop", ZBX_CONST_STRLEN("varpop")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_varpop, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "varsamp", ZBX_CONST_STRLEN("varsamp")))
-		return eval_execute_statistical_function(ctx, token, zbx_eval_calc_varsamp, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "count", ZBX_CONST_STRLEN("count")))
-		return eval_execute_function_count(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "histogram_quantile",
-			ZBX_CONST_STRLEN("histogram_quantile")))
-	{
-		return eval_execute_function_histogram_quantile(ctx, token, output, error);
-	}
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "jsonpath", ZBX_CONST_STRLEN("jsonpath")))
-		return eval_execute_function_jsonpath(ctx, token, output, error);
-	if (SUCCEED == eval_compare_token(ctx, &token->loc, "xmlxpath", ZBX_CONST_STRLEN("xmlxpath")))
-		return eval_execute_function_xmlxpath(ctx, token, output, error);
+	if (NULL != (func = eval_get_function(ctx, token)))
+	{
+		switch (func->type)
+		{
+			case EVAL_FUNCTION_GENERIC:
+				return func->exec(ctx, token, output, error);
+			case EVAL_FUNCTION_BITWISE:
+				return eval_execute_function_bitwise(ctx, token,
+						(zbx_function_bit_optype_t)func->optype, output, error);
+			case EVAL_FUNCTION_TRIM:
+				return eval_execute_function_trim(ctx, token, (zbx_function_trim_optype_t)func->optype,
+						output, error);
+			case EVAL_FUNCTION_MATH1:
+				return eval_execute_math_function_single_param(ctx, token, output, error, func->math1);
+			case EVAL_FUNCTION_MATH2:
+				return eval_execute_math_function_double_param(ctx, token, output, error, func->math2);
+			case EVAL_FUNCTION_CONST:
+				return eval_execute_math_return_value(ctx, token, output, error, func->value);
+			case EVAL_FUNCTION_STAT:
+				return eval_execute_statistical_function(ctx, token, func->stat, output, error);
+		}
+	}
 
 	if (NULL != ctx->common_func_cb)
 		return eval_execute_cb_function(ctx, token, ctx->common_func_cb, output, error);
@@ -3205,6 +3287,561 @@ static void	eval_throw_exception(zbx_vector_var_t *output, char **error)
 	zbx_variant_set_none(arg);
 }
 
+/* compiled expression operation codes */
+typedef enum
+{
+	EVAL_VM_PUSH_CONST,
+	EVAL_VM_PUSH_NUM,
+	EVAL_VM_PUSH_VAR,
+	EVAL_VM_NEG,
+	EVAL_VM_NOT,
+	EVAL_VM_MATH1,
+	EVAL_VM_ADD,
+	EVAL_VM_SUB,
+	EVAL_VM_MUL,
+	EVAL_VM_DIV,
+	EVAL_VM_EQ,
+	EVAL_VM_NE,
+	EVAL_VM_LT,
+	EVAL_VM_LE,
+	EVAL_VM_GT,
+	EVAL_VM_GE,
+	EVAL_VM_AND,
+	EVAL_VM_OR,
+	EVAL_VM_MATH2
+}
+eval_vm_opcode_t;
+
+typedef struct
+{
+	eval_vm_opcode_t	opcode;
+	union
+	{
+		double			value;
+		const zbx_eval_token_t	*token;
+		double			(*math1)(double);
+		double			(*math2)(double, double);
+	}
+	data;
+}
+eval_vm_op_t;
+
+/* limits of expressions executed by the numeric VM, larger expressions are interpreted */
+#define EVAL_VM_PROGRAM_SIZE	128
+#define EVAL_VM_STACK_SIZE	32
+
+/* the largest unsigned integer that can be converted to double without loss of precision */
+#define EVAL_VM_UI64_MAX	(__UINT64_C(1) << 53)
+
+static int	eval_vm_check_value(double value)
+{
+	if (FP_ZERO != fpclassify(value) && FP_NORMAL != fpclassify(value))
+		return FAIL;
+
+	return SUCCEED;
+}
+
+static int	eval_vm_compare(double left, double right)
+{
+	if (SUCCEED == zbx_double_compare(left, right))
+		return 0;
+
+	return left < right ? -1 : 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: executes compiled operator or function on the value stack         *
+ *                                                                            *
+ * Parameters: op    - [IN] compiled operation                                *
+ *             stack - [IN/OUT] value stack                                   *
+ *             top   - [IN/OUT] number of values in stack                     *
+ *                                                                            *
+ * Return value: SUCCEED - operation was executed successfully                *
+ *               FAIL    - operation failed, the error must be reported by    *
+ *                         interpreting the expression                        *
+ *                                                                            *
+ * Comments: The semantics must match eval_execute_op_unary(),                *
+ *           eval_execute_op_binary() and mathematical function evaluation    *
+ *           for floating point operands.                                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_execute_op(const eval_vm_op_t *op, double *stack, int *top)
+{
+	double	left, right, value;
+
+	if (EVAL_VM_MATH1 >= op->opcode)
+	{
+		right = stack[*top - 1];
+
+		switch (op->opcode)
+		{
+			case EVAL_VM_NEG:
+				value = -right;
+				break;
+			case EVAL_VM_NOT:
+				value = (SUCCEED == zbx_double_compare(right, 0) ? 1 : 0);
+				break;
+			case EVAL_VM_MATH1:
+				if (SUCCEED != eval_math_func_check_arg(op->data.math1, right))
+					return FAIL;
+
+				value = op->data.math1(right);
+				break;
+			default:
+				THIS_SHOULD_NEVER_HAPPEN;
+				return FAIL;
+		}
+
+		stack[*top - 1] = value;
+
+		return eval_vm_check_value(value);
+	}
+
+	left = stack[*top - 2];
+	right = stack[*top - 1];
+
+	switch (op->opcode)
+	{
+		case EVAL_VM_ADD:
+			value = left + right;
+			break;
+		case EVAL_VM_SUB:
+			value = left - right;
+			break;
+		case EVAL_VM_MUL:
+			value = left * right;
+			break;
+		case EVAL_VM_DIV:
+			if (SUCCEED == zbx_double_compare(right, 0))
+				return FAIL;
+
+			value = left / right;
+			break;
+		case EVAL_VM_EQ:
+			value = (0 == eval_vm_compare(left, right) ? 1 : 0);
+			break;
+		case EVAL_VM_NE:
+			value = (0 == eval_vm_compare(left, right) ? 0 : 1);
+			break;
+		case EVAL_VM_LT:
+			value = (0 > eval_vm_compare(left, right) ? 1 : 0);
+			break;
+		case EVAL_VM_LE:
+			value = (0 >= eval_vm_compare(left, right) ? 1 : 0);
+			break;
+		case EVAL_VM_GT:
+			value = (0 < eval_vm_compare(left, right) ? 1 : 0);
+			break;
+		case EVAL_VM_GE:
+			value = (0 <= eval_vm_compare(left, right) ? 1 : 0);
+			break;
+		case EVAL_VM_AND:
+			if (SUCCEED == zbx_double_compare(left, 0) || SUCCEED == zbx_double_compare(right, 0))
+				value = 0;
+			else
+				value = 1;
+			break;
+		case EVAL_VM_OR:
+			if (SUCCEED != zbx_double_compare(left, 0) || SUCCEED != zbx_double_compare(right, 0))
+				value = 1;
+			else
+				value = 0;
+			break;
+		case EVAL_VM_MATH2:
+			if (SUCCEED != eval_math_func_check_args(op->data.math2, left, right))
+				return FAIL;
+
+			value = op->data.math2(left, right);
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+			return FAIL;
+	}
+
+	stack[--(*top) - 1] = value;
+
+	return eval_vm_check_value(value);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets numeric value of variable token                              *
+ *                                                                            *
+ * Parameters: token - [IN] variable token with value set                     *
+ *             value - [OUT]                                                  *
+ *                                                                            *
+ * Return value: SUCCEED - the token value was converted to double without    *
+ *                         changing expression result                         *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_get_var(const zbx_eval_token_t *token, double *value)
+{
+	char	suffix;
+
+	switch (token->value.type)
+	{
+		case ZBX_VARIANT_DBL:
+			*value = token->value.data.dbl;
+			break;
+		case ZBX_VARIANT_UI64:
+			/* larger values are compared as integers by interpreter */
+			if (EVAL_VM_UI64_MAX < token->value.data.ui64)
+				return FAIL;
+
+			*value = (double)token->value.data.ui64;
+			break;
+		case ZBX_VARIANT_STR:
+			/* only expanded user macros are converted to numbers when pushed to stack */
+			if (ZBX_EVAL_TOKEN_VAR_USERMACRO != token->type ||
+					SUCCEED != eval_suffixed_number_parse(token->value.data.str, &suffix))
+			{
+				return FAIL;
+			}
+
+			*value = atof(token->value.data.str) * suffix2factor(suffix);
+			break;
+		default:
+			return FAIL;
+	}
+
+	return eval_vm_check_value(*value);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles function token into direct mathematical function call    *
+ *          or constant                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_compile_function(const zbx_eval_context_t *ctx, const zbx_eval_token_t *token,
+		eval_vm_op_t *op)
+{
+	const eval_function_t	*func;
+
+	if (NULL == (func = eval_get_function(ctx, token)))
+		return FAIL;
+
+	switch (func->type)
+	{
+		case EVAL_FUNCTION_MATH1:
+			if (1 != token->opt)
+				return FAIL;
+
+			op->opcode = EVAL_VM_MATH1;
+			op->data.math1 = func->math1;
+			return SUCCEED;
+		case EVAL_FUNCTION_MATH2:
+			if (2 != token->opt)
+				return FAIL;
+
+			op->opcode = EVAL_VM_MATH2;
+			op->data.math2 = func->math2;
+			return SUCCEED;
+		case EVAL_FUNCTION_GENERIC:
+			/* abs() of a single number is the only generic function not depending on argument type */
+			if (eval_execute_function_abs != func->exec || 1 != token->opt)
+				return FAIL;
+
+			op->opcode = EVAL_VM_MATH1;
+			op->data.math1 = fabs;
+			return SUCCEED;
+		case EVAL_FUNCTION_CONST:
+			if (0 != token->opt || ZBX_MATH_RANDOM == func->value)
+				return FAIL;
+
+			op->opcode = EVAL_VM_PUSH_CONST;
+			op->data.value = func->value;
+			return SUCCEED;
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: checks if variable token value can be used by numeric VM          *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_check_var(const zbx_eval_token_t *token)
+{
+	switch (token->value.type)
+	{
+		case ZBX_VARIANT_DBL:
+		case ZBX_VARIANT_UI64:
+			return SUCCEED;
+		case ZBX_VARIANT_STR:
+			return ZBX_EVAL_TOKEN_VAR_USERMACRO == token->type ? SUCCEED : FAIL;
+		default:
+			return FAIL;
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: converts numeric constant token operation to constant value       *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_parse_num(const zbx_eval_context_t *ctx, eval_vm_op_t *op)
+{
+	const zbx_eval_token_t	*token = op->data.token;
+	zbx_uint64_t		ui64;
+
+	if (SUCCEED == zbx_is_uint64_n(ctx->expression + token->loc.l, token->loc.r - token->loc.l + 1, &ui64))
+	{
+		/* larger values are compared as integers by interpreter */
+		if (EVAL_VM_UI64_MAX < ui64)
+			return FAIL;
+
+		op->data.value = (double)ui64;
+	}
+	else
+		op->data.value = atof(ctx->expression + token->loc.l) * suffix2factor(ctx->expression[token->loc.r]);
+
+	op->opcode = EVAL_VM_PUSH_CONST;
+
+	return eval_vm_check_value(op->data.value);
+}
+
+static int	eval_vm_get_args_num(eval_vm_opcode_t opcode)
+{
+	if (EVAL_VM_PUSH_VAR >= opcode)
+		return 0;
+
+	if (EVAL_VM_MATH1 >= opcode)
+		return 1;
+
+	return 2;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles expression into numeric VM program                       *
+ *                                                                            *
+ * Parameters: ctx     - [IN] evaluation context                              *
+ *             program - [OUT] compiled program                               *
+ *             ops_num - [OUT] number of program operations                   *
+ *                                                                            *
+ * Return value: SUCCEED - expression was compiled                            *
+ *               FAIL    - expression must be interpreted                     *
+ *                                                                            *
+ * Comments: Only expressions operating on numeric values are compiled -      *
+ *           constants, trigger functions, user macros, operators and         *
+ *           mathematical functions. Function names are resolved to direct    *
+ *           function pointers. Numeric constants are parsed later by         *
+ *           eval_vm_optimize(), so unsupported expressions are rejected      *
+ *           before doing any conversions.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_compile(const zbx_eval_context_t *ctx, eval_vm_op_t *program, int *ops_num)
+{
+	int	i, args_num, depth = 0, ops = 0;
+
+	if (EVAL_VM_PROGRAM_SIZE < ctx->stack.values_num)
+		return FAIL;
+
+	for (i = 0; i < ctx->stack.values_num; i++)
+	{
+		const zbx_eval_token_t	*token = &ctx->stack.values[i];
+		eval_vm_op_t		*op = &program[ops];
+
+		switch (token->type)
+		{
+			case ZBX_EVAL_TOKEN_NOP:
+				continue;
+			case ZBX_EVAL_TOKEN_VAR_NUM:
+				if (ZBX_VARIANT_NONE == token->value.type)
+				{
+					op->opcode = EVAL_VM_PUSH_NUM;
+					op->data.token = token;
+					break;
+				}
+				ZBX_FALLTHROUGH;
+			case ZBX_EVAL_TOKEN_VAR_USERMACRO:
+			case ZBX_EVAL_TOKEN_FUNCTIONID:
+				if (SUCCEED != eval_vm_check_var(token))
+					return FAIL;
+
+				op->opcode = EVAL_VM_PUSH_VAR;
+				op->data.token = token;
+				break;
+			case ZBX_EVAL_TOKEN_OP_MINUS:
+				op->opcode = EVAL_VM_NEG;
+				break;
+			case ZBX_EVAL_TOKEN_OP_NOT:
+				op->opcode = EVAL_VM_NOT;
+				break;
+			case ZBX_EVAL_TOKEN_OP_ADD:
+				op->opcode = EVAL_VM_ADD;
+				break;
+			case ZBX_EVAL_TOKEN_OP_SUB:
+				op->opcode = EVAL_VM_SUB;
+				break;
+			case ZBX_EVAL_TOKEN_OP_MUL:
+				op->opcode = EVAL_VM_MUL;
+				break;
+			case ZBX_EVAL_TOKEN_OP_DIV:
+				op->opcode = EVAL_VM_DIV;
+				break;
+			case ZBX_EVAL_TOKEN_OP_EQ:
+				op->opcode = EVAL_VM_EQ;
+				break;
+			case ZBX_EVAL_TOKEN_OP_NE:
+				op->opcode = EVAL_VM_NE;
+				break;
+			case ZBX_EVAL_TOKEN_OP_LT:
+				op->opcode = EVAL_VM_LT;
+				break;
+			case ZBX_EVAL_TOKEN_OP_LE:
+				op->opcode = EVAL_VM_LE;
+				break;
+			case ZBX_EVAL_TOKEN_OP_GT:
+				op->opcode = EVAL_VM_GT;
+				break;
+			case ZBX_EVAL_TOKEN_OP_GE:
+				op->opcode = EVAL_VM_GE;
+				break;
+			case ZBX_EVAL_TOKEN_OP_AND:
+				op->opcode = EVAL_VM_AND;
+				break;
+			case ZBX_EVAL_TOKEN_OP_OR:
+				op->opcode = EVAL_VM_OR;
+				break;
+			case ZBX_EVAL_TOKEN_FUNCTION:
+				if (SUCCEED != eval_vm_compile_function(ctx, token, op))
+					return FAIL;
+				break;
+			default:
+				return FAIL;
+		}
+
+		if (depth < (args_num = eval_vm_get_args_num(op->opcode)))
+			return FAIL;
+
+		if (EVAL_VM_STACK_SIZE < (depth += 1 - args_num))
+			return FAIL;
+
+		ops++;
+	}
+
+	/* single values keep their type when returned, leave them to interpreter */
+	if (1 != depth || (1 == ops && EVAL_VM_PUSH_CONST != program[0].opcode))
+		return FAIL;
+
+	*ops_num = ops;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses numeric constants and replaces operations with constant    *
+ *          operands by their results                                         *
+ *                                                                            *
+ * Parameters: ctx     - [IN] evaluation context                              *
+ *             program - [IN/OUT] compiled program                            *
+ *             ops_num - [IN/OUT] number of program operations                *
+ *                                                                            *
+ * Return value: SUCCEED - program was optimized                              *
+ *               FAIL    - expression must be interpreted                     *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_optimize(const zbx_eval_context_t *ctx, eval_vm_op_t *program, int *ops_num)
+{
+	int	i, j, args_num, top, ops = 0;
+	double	stack[2];
+
+	for (i = 0; i < *ops_num; i++)
+	{
+		eval_vm_op_t	*op = &program[ops++];
+
+		*op = program[i];
+
+		if (EVAL_VM_PUSH_NUM == op->opcode && SUCCEED != eval_vm_parse_num(ctx, op))
+			return FAIL;
+
+		if (0 == (args_num = eval_vm_get_args_num(op->opcode)))
+			continue;
+
+		for (j = ops - args_num - 1, top = 0; j < ops - 1; j++)
+		{
+			if (EVAL_VM_PUSH_CONST != program[j].opcode)
+				break;
+
+			stack[top++] = program[j].data.value;
+		}
+
+		/* failed operations are left for execution to report the error */
+		if (top != args_num || SUCCEED != eval_vm_execute_op(op, stack, &top))
+			continue;
+
+		ops -= args_num;
+		program[ops - 1].opcode = EVAL_VM_PUSH_CONST;
+		program[ops - 1].data.value = stack[0];
+	}
+
+	*ops_num = ops;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluates numeric expression on unboxed floating point values     *
+ *                                                                            *
+ * Parameters: ctx   - [IN] evaluation context                                *
+ *             value - [OUT] resulting value                                  *
+ *                                                                            *
+ * Return value: SUCCEED - expression was evaluated successfully              *
+ *               FAIL    - expression cannot be evaluated by numeric VM or    *
+ *                         the evaluation failed, the expression must be      *
+ *                         interpreted                                        *
+ *                                                                            *
+ * Comments: Compiled expressions have no side effects, so they can be        *
+ *           interpreted after failure to get the exact error message.        *
+ *                                                                            *
+ *           The program is compiled on every call and is not cached in the   *
+ *           context. Whether a variable can be loaded as a number depends on *
+ *           the token values set before each execution, and trigger and      *
+ *           calculated item contexts are deserialized for every evaluation   *
+ *           anyway. Compilation is a single pass over the token stack into   *
+ *           a fixed size program on the stack.                               *
+ *                                                                            *
+ ******************************************************************************/
+static int	eval_vm_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value)
+{
+	eval_vm_op_t	program[EVAL_VM_PROGRAM_SIZE];
+	double		stack[EVAL_VM_STACK_SIZE];
+	int		i, ops_num, top = 0;
+
+	if (SUCCEED != eval_vm_compile(ctx, program, &ops_num) || SUCCEED != eval_vm_optimize(ctx, program, &ops_num))
+		return FAIL;
+
+	for (i = 0; i < ops_num; i++)
+	{
+		const eval_vm_op_t	*op = &program[i];
+
+		switch (op->opcode)
+		{
+			case EVAL_VM_PUSH_CONST:
+				stack[top++] = op->data.value;
+				break;
+			case EVAL_VM_PUSH_VAR:
+				if (SUCCEED != eval_vm_get_var(op->data.token, &stack[top++]))
+					return FAIL;
+				break;
+			default:
+				if (SUCCEED != eval_vm_execute_op(op, stack, &top))
+					return FAIL;
+		}
+	}
+
+	zbx_variant_set_dbl(value, stack[0]);
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: evaluates pre-parsed expression                                   *
@@ -3223,6 +3860,9 @@ static int	eval_execute(const zbx_eval_context_t *ctx, zbx_variant_t *value, cha
 	int			i, ret = FAIL;
 	char			*errmsg = NULL;
 
+	if (SUCCEED == eval_vm_execute(ctx, value))
+		return SUCCEED;
+
 	zbx_vector_var_create(&output);
 
 	for (i = 0; i < ctx->stack.values_num; i++)
@@ -624,7 +624,7 @@ int	zbx_evaluatable_for_notsupported(const char *fn)
  * Purpose: get last Nth value defined by #num:now-timeshift first parameter. *
  *                                                                            *
  * Parameters: item       - [IN] item (performance metric)                    *
- *             parameters - [IN] parameter string with #sec|num/timeshift in  *
+ *             params     - [IN] parameter string with #sec|num/timeshift in  *
  *                               first parameter                              *
  *             ts         - [IN] starting timestamp                           *
  *             value      - [OUT] Nth value                                   *
@@ -634,8 +634,8 @@ int	zbx_evaluatable_for_notsupported(const char *fn)
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	get_last_n_value(const zbx_dc_evaluate_item_t *item, const char *parameters, const zbx_timespec_t *ts,
-		zbx_history_record_t *value, char **error)
+static int	get_last_n_value(const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
+		const zbx_timespec_t *ts, zbx_history_record_t *value, char **error)
 {
 	int				arg1 = 1, ret = FAIL, time_shift;
 	zbx_value_type_t		arg1_type = ZBX_VALUE_NVALUES;
@@ -644,7 +644,7 @@ static int	get_last_n_value(const zbx_dc_evaluate_item_t *item, const char *para
 
 	zbx_history_record_vector_create(&values);
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift))
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift))
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
@@ -681,7 +681,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] regex string for event id matching           *
+ *             params     - [IN] regex string for event id matching           *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -689,8 +689,8 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_LOGEVENTID(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_LOGEVENTID(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	char			*pattern = NULL;
 	int			ret = FAIL, nparams;
@@ -707,7 +707,7 @@ static int	evaluate_LOGEVENTID(zbx_variant_t *value, const zbx_dc_evaluate_item_
 		goto out;
 	}
 
-	if (2 < (nparams = zbx_num_param(parameters)))
+	if (2 < (nparams = params->num))
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
@@ -715,7 +715,7 @@ static int	evaluate_LOGEVENTID(zbx_variant_t *value, const zbx_dc_evaluate_item_
 
 	if (2 == nparams)
 	{
-		if (SUCCEED != get_function_parameter_str(parameters, 2, &pattern))
+		if (SUCCEED != get_function_parameter_str(params->str, 2, &pattern))
 		{
 			*error = zbx_strdup(*error, "invalid third parameter");
 			goto out;
@@ -736,7 +736,7 @@ static int	evaluate_LOGEVENTID(zbx_variant_t *value, const zbx_dc_evaluate_item_
 	else
 		pattern = zbx_strdup(NULL, "");
 
-	if (SUCCEED == get_last_n_value(item, parameters, ts, &vc_value, error))
+	if (SUCCEED == get_last_n_value(item, params, ts, &vc_value, error))
 	{
 		char	logeventid[16];
 		int	regexp_ret;
@@ -778,7 +778,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] ignored                                      *
+ *             params     - [IN] ignored                                      *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -786,8 +786,8 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_LOGSOURCE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_LOGSOURCE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	char			*pattern = NULL;
 	int			ret = FAIL, nparams;
@@ -804,7 +804,7 @@ static int	evaluate_LOGSOURCE(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 		goto out;
 	}
 
-	if (2 < (nparams = zbx_num_param(parameters)))
+	if (2 < (nparams = params->num))
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
@@ -812,7 +812,7 @@ static int	evaluate_LOGSOURCE(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 
 	if (2 == nparams)
 	{
-		if (SUCCEED != get_function_parameter_str(parameters, 2, &pattern))
+		if (SUCCEED != get_function_parameter_str(params->str, 2, &pattern))
 		{
 			*error = zbx_strdup(*error, "invalid third parameter");
 			goto out;
@@ -833,7 +833,7 @@ static int	evaluate_LOGSOURCE(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 	else
 		pattern = zbx_strdup(NULL, "");
 
-	if (SUCCEED == get_last_n_value(item, parameters, ts, &vc_value, error))
+	if (SUCCEED == get_last_n_value(item, params, ts, &vc_value, error))
 	{
 		switch (zbx_regexp_match_ex(&regexps, vc_value.value.log->source, pattern, ZBX_CASE_SENSITIVE))
 		{
@@ -870,7 +870,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] Nth last value and time shift (optional)     *
+ *             params     - [IN] Nth last value and time shift (optional)     *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -878,8 +878,8 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_LOGSEVERITY(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_LOGSEVERITY(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int			ret = FAIL;
 	zbx_history_record_t	vc_value;
@@ -892,13 +892,13 @@ static int	evaluate_LOGSEVERITY(zbx_variant_t *value, const zbx_dc_evaluate_item
 		goto out;
 	}
 
-	if (1 < zbx_num_param(parameters))
+	if (1 < params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED == get_last_n_value(item, parameters, ts, &vc_value, error))
+	if (SUCCEED == get_last_n_value(item, params, ts, &vc_value, error))
 	{
 		zbx_variant_set_dbl(value, vc_value.value.log->severity);
 		zbx_history_record_clear(&vc_value, item->value_type);
@@ -1053,7 +1053,7 @@ int	zbx_execute_count_with_pattern(char *pattern, unsigned char value_type, zbx_
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] up to three comma-separated fields:          *
+ *             params     - [IN] up to three comma-separated fields:          *
  *                            (1) number of seconds/values + timeshift        *
  *                            (2) comparison operator (optional)              *
  *                            (3) value to compare with (optional)            *
@@ -1074,8 +1074,8 @@ int	zbx_execute_count_with_pattern(char *pattern, unsigned char value_type, zbx_
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_COUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, int limit, int unique, char **error)
+static int	evaluate_COUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, int limit, int unique, char **error)
 {
 	int				arg1, nparams, count = 0, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
 	char				*operator = NULL, *pattern = NULL;
@@ -1084,23 +1084,23 @@ static int	evaluate_COUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 	zbx_timespec_t			ts_end = *ts;
 	zbx_eval_count_pattern_data_t	pdata;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() params:%s", __func__, ZBX_NULL2EMPTY_STR(parameters));
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() params:%s", __func__, ZBX_NULL2EMPTY_STR(params->str));
 
 	zbx_history_record_vector_create(&values);
 
-	if (3 < (nparams = zbx_num_param(parameters)))
+	if (3 < (nparams = params->num))
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift))
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift))
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (2 <= nparams && SUCCEED != get_function_parameter_str(parameters, 2, &operator))
+	if (2 <= nparams && SUCCEED != get_function_parameter_str(params->str, 2, &operator))
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
 		goto out;
@@ -1108,7 +1108,7 @@ static int	evaluate_COUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 
 	if (3 <= nparams)
 	{
-		if (SUCCEED != get_function_parameter_str(parameters, 3, &pattern))
+		if (SUCCEED != get_function_parameter_str(params->str, 3, &pattern))
 		{
 			*error = zbx_strdup(*error, "invalid fourth parameter");
 			goto out;
@@ -1137,6 +1137,18 @@ static int	evaluate_COUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	if (OP_ANY == pdata.op && COUNT_ALL == unique && 0 != seconds)
+	{
+		zbx_vc_aggregate_t	aggregate;
+
+		if (SUCCEED == zbx_vc_get_aggregate(item->itemid, item->value_type, seconds, &ts_end, &aggregate))
+		{
+			zbx_variant_set_dbl(value, MIN(aggregate.values_num, limit));
+			ret = SUCCEED;
+			goto clean;
+		}
+	}
+
 	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
@@ -1210,7 +1222,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds/values and time shift      *
+ *             params     - [IN] number of seconds/values and time shift      *
  *                               (optional)                                   *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
@@ -1219,7 +1231,7 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
+static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
 		const zbx_timespec_t *ts, char **error)
 {
 	int				arg1, i, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
@@ -1238,13 +1250,13 @@ static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 		goto out;
 	}
 
-	if (1 != zbx_num_param(parameters))
+	if (1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
@@ -1265,6 +1277,18 @@ static int	evaluate_SUM(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	if (0 != seconds)
+	{
+		zbx_vc_aggregate_t	aggregate;
+
+		if (SUCCEED == zbx_vc_get_aggregate(item->itemid, item->value_type, seconds, &ts_end, &aggregate))
+		{
+			zbx_history_value2variant(&aggregate.sum, item->value_type, value);
+			ret = SUCCEED;
+			goto out;
+		}
+	}
+
 	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
@@ -1302,7 +1326,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds/values and time shift      *
+ *             params     - [IN] number of seconds/values and time shift      *
  *                               (optional)                                   *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
@@ -1311,12 +1335,14 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
+static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
 		const zbx_timespec_t *ts, char **error)
 {
-	int				arg1, ret = FAIL, i, seconds = 0, nvalues = 0, time_shift;
+	int				arg1, ret = FAIL, i, seconds = 0, nvalues = 0, time_shift, values_num;
+	double				avg = 0;
 	zbx_value_type_t		arg1_type;
 	zbx_vector_history_record_t	values;
+	zbx_vc_aggregate_t		aggregate;
 	zbx_timespec_t			ts_end = *ts;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -1329,13 +1355,13 @@ static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 		goto out;
 	}
 
-	if (1 != zbx_num_param(parameters))
+	if (1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
@@ -1356,28 +1382,39 @@ static int	evaluate_AVG(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
-	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
+	if (0 != seconds && SUCCEED == zbx_vc_get_aggregate(item->itemid, item->value_type, seconds, &ts_end,
+			&aggregate))
 	{
-		*error = zbx_strdup(*error, "cannot get values from value cache");
-		goto out;
+		values_num = aggregate.values_num;
+		avg = aggregate.avg;
 	}
-
-	if (0 < values.values_num)
+	else
 	{
-		double	avg = 0;
-
-		if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
+		if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 		{
-			for (i = 0; i < values.values_num; i++)
-				avg += values.values[i].value.dbl / (i + 1) - avg / (i + 1);
+			*error = zbx_strdup(*error, "cannot get values from value cache");
+			goto out;
 		}
-		else
+
+		if (0 < (values_num = values.values_num))
 		{
-			for (i = 0; i < values.values_num; i++)
-				avg += (double)values.values[i].value.ui64;
+			if (ITEM_VALUE_TYPE_FLOAT == item->value_type)
+			{
+				for (i = 0; i < values.values_num; i++)
+					avg += values.values[i].value.dbl / (i + 1) - avg / (i + 1);
+			}
+			else
+			{
+				for (i = 0; i < values.values_num; i++)
+					avg += (double)values.values[i].value.ui64;
 
-			avg = avg / values.values_num;
+				avg = avg / values.values_num;
+			}
 		}
+	}
+
+	if (0 < values_num)
+	{
 		zbx_variant_set_dbl(value, avg);
 
 		ret = SUCCEED;
@@ -1401,7 +1438,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] Nth last value and time shift (optional)     *
+ *             params     - [IN] Nth last value and time shift (optional)     *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -1409,7 +1446,7 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
+static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
 		const zbx_timespec_t *ts, char **error)
 {
 	int			ret;
@@ -1417,7 +1454,7 @@ static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (SUCCEED == (ret = get_last_n_value(item, parameters, ts, &vc_value, error)))
+	if (SUCCEED == (ret = get_last_n_value(item, params, ts, &vc_value, error)))
 	{
 		zbx_history_value2variant(&vc_value.value, item->value_type, value);
 		zbx_history_record_clear(&vc_value, item->value_type);
@@ -1449,7 +1486,7 @@ static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds/values and time shift      *
+ *             params     - [IN] number of seconds/values and time shift      *
  *                               (optional)                                   *
  *             ts         - [IN] starting timestamp                           *
  *             min_or_max - [IN] is this evaluate_MIN or evaluate_MAX         *
@@ -1459,8 +1496,8 @@ static int	evaluate_LAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error, int min_or_max)
+static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error, int min_or_max)
 {
 	int				arg1, i, ret = FAIL, seconds = 0, nvalues = 0, time_shift;
 	zbx_value_type_t		arg1_type;
@@ -1477,13 +1514,13 @@ static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_
 		goto out;
 	}
 
-	if (1 != zbx_num_param(parameters))
+	if (1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
@@ -1504,6 +1541,20 @@ static int	evaluate_MIN_or_MAX(zbx_variant_t *value, const zbx_dc_evaluate_item_
 			THIS_SHOULD_NEVER_HAPPEN;
 	}
 
+	if (0 != seconds)
+	{
+		zbx_vc_aggregate_t	aggregate;
+
+		if (SUCCEED == zbx_vc_get_aggregate(item->itemid, item->value_type, seconds, &ts_end, &aggregate) &&
+				0 < aggregate.values_num)
+		{
+			zbx_history_value2variant(EVALUATE_MIN == min_or_max ? &aggregate.min : &aggregate.max,
+					item->value_type, value);
+			ret = SUCCEED;
+			goto out;
+		}
+	}
+
 	if (FAIL == zbx_vc_get_values(item->itemid, item->value_type, &values, seconds, nvalues, &ts_end))
 	{
 		*error = zbx_strdup(*error, "cannot get values from value cache");
@@ -1559,7 +1610,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] seconds/values, time shift (optional),       *
+ *             params     - [IN] seconds/values, time shift (optional),       *
  *                               percentage                                   *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
@@ -1569,8 +1620,8 @@ out:
  *               FAIL    - failed to evaluate function                        *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_PERCENTILE(zbx_variant_t  *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_PERCENTILE(zbx_variant_t  *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int				arg1, time_shift, ret = FAIL, seconds = 0, nvalues = 0;
 	zbx_value_type_t		arg1_type;
@@ -1588,13 +1639,13 @@ static int	evaluate_PERCENTILE(zbx_variant_t  *value, const zbx_dc_evaluate_item
 		goto out;
 	}
 
-	if (2 != zbx_num_param(parameters))
+	if (2 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
@@ -1615,7 +1666,7 @@ static int	evaluate_PERCENTILE(zbx_variant_t  *value, const zbx_dc_evaluate_item
 
 	ts_end.sec -= time_shift;
 
-	if (SUCCEED != get_function_parameter_float(parameters, 2, ZBX_FLAG_DOUBLE_PLAIN, &percentage) ||
+	if (SUCCEED != get_function_parameter_float(params->str, 2, ZBX_FLAG_DOUBLE_PLAIN, &percentage) ||
 			0.0 > percentage || 100.0 < percentage)
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
@@ -1665,15 +1716,15 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds                            *
+ *             params     - [IN] number of seconds                            *
  *             error      - [OUT]                                             *
  *                                                                            *
  * Return value: SUCCEED - evaluated successfully, result is stored in 'value'*
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_NODATA(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		char **error)
+static int	evaluate_NODATA(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, char **error)
 {
 	int				arg1, num, period, lazy = 1, ret = FAIL;
 	zbx_value_type_t		arg1_type;
@@ -1686,20 +1737,20 @@ static int	evaluate_NODATA(zbx_variant_t *value, const zbx_dc_evaluate_item_t *i
 
 	zbx_history_record_vector_create(&values);
 
-	if (2 < (num = zbx_num_param(parameters)))
+	if (2 < (num = params->num))
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_period(parameters, 1, &arg1, &arg1_type) ||
+	if (SUCCEED != get_function_parameter_period(params->str, 1, &arg1, &arg1_type) ||
 			ZBX_VALUE_SECONDS != arg1_type || 0 >= arg1)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (1 < num && (SUCCEED != get_function_parameter_str(parameters, 2, &arg2) ||
+	if (1 < num && (SUCCEED != get_function_parameter_str(params->str, 2, &arg2) ||
 			('\0' != *arg2 && 0 != (lazy = strcmp("strict", arg2)))))
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
@@ -1849,7 +1900,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds                            *
+ *             params     - [IN] number of seconds                            *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -1857,8 +1908,8 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_FUZZYTIME(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_FUZZYTIME(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int			arg1, ret = FAIL;
 	zbx_value_type_t	arg1_type;
@@ -1873,13 +1924,13 @@ static int	evaluate_FUZZYTIME(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 		goto out;
 	}
 
-	if (1 < zbx_num_param(parameters))
+	if (1 < params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_period(parameters, 1, &arg1, &arg1_type) ||
+	if (SUCCEED != get_function_parameter_period(params->str, 1, &arg1, &arg1_type) ||
 			0 >= arg1)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
@@ -1931,7 +1982,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] dynamic buffer,result                       *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] to 2 comma-separated fields:                 *
+ *             params     - [IN] to 2 comma-separated fields:                 *
  *                            (1) same as the 1st parameter for function      *
  *                                evaluate_LAST() (see documentation of       *
  *                                trigger function last()),                   *
@@ -1943,10 +1994,9 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_BITAND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_BITAND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
-	char		*last_parameters = NULL;
 	int		ret = FAIL;
 	zbx_uint64_t	mask;
 
@@ -1958,22 +2008,20 @@ static int	evaluate_BITAND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *i
 		goto clean;
 	}
 
-	if (2 < zbx_num_param(parameters))
+	if (2 < params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto clean;
 	}
 
-	if (SUCCEED != get_function_parameter_uint64(parameters, 2, &mask))
+	if (SUCCEED != get_function_parameter_uint64(params->str, 2, &mask))
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
 		goto clean;
 	}
 
-	/* prepare the 1st and the 3rd parameter for passing to evaluate_LAST() */
-	last_parameters = zbx_function_get_param_dyn(parameters, 1);
-
-	if (SUCCEED == evaluate_LAST(value, item, last_parameters, ts, error))
+	/* evaluate_LAST() uses only the first parameter */
+	if (SUCCEED == evaluate_LAST(value, item, params, ts, error))
 	{
 		/* the evaluate_LAST() should return uint64 value, but just to be sure try to convert it */
 		if (SUCCEED != zbx_variant_convert(value, ZBX_VARIANT_UI64))
@@ -1984,8 +2032,6 @@ static int	evaluate_BITAND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *i
 		zbx_variant_set_dbl(value, value->data.ui64 & (zbx_uint64_t)mask);
 		ret = SUCCEED;
 	}
-
-	zbx_free(last_parameters);
 clean:
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
@@ -1998,7 +2044,7 @@ clean:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds/values and time shift      *
+ *             params     - [IN] number of seconds/values and time shift      *
  *                               (optional)                                   *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
@@ -2007,8 +2053,8 @@ clean:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_FORECAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_FORECAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	char				*fit_str = NULL, *mode_str = NULL;
 	double				*t = NULL, *x = NULL;
@@ -2031,20 +2077,20 @@ static int	evaluate_FORECAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 		goto out;
 	}
 
-	if (2 > (nparams = zbx_num_param(parameters)) || nparams > 4)
+	if (2 > (nparams = params->num) || nparams > 4)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_period(parameters, 2, &time, &time_type) ||
+	if (SUCCEED != get_function_parameter_period(params->str, 2, &time, &time_type) ||
 			ZBX_VALUE_SECONDS != time_type)
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
@@ -2053,7 +2099,7 @@ static int	evaluate_FORECAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 
 	if (3 <= nparams)
 	{
-		if (SUCCEED != get_function_parameter_str(parameters, 3, &fit_str) ||
+		if (SUCCEED != get_function_parameter_str(params->str, 3, &fit_str) ||
 				SUCCEED != zbx_fit_code(fit_str, &fit, &k, error))
 		{
 			*error = zbx_strdup(*error, "invalid fourth parameter");
@@ -2067,7 +2113,7 @@ static int	evaluate_FORECAST(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 
 	if (4 == nparams)
 	{
-		if (SUCCEED != get_function_parameter_str(parameters, 4, &mode_str) ||
+		if (SUCCEED != get_function_parameter_str(params->str, 4, &mode_str) ||
 				SUCCEED != zbx_mode_code(mode_str, &mode, error))
 		{
 			*error = zbx_strdup(*error, "invalid fifth parameter");
@@ -2155,7 +2201,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds/values and time shift      *
+ *             params     - [IN] number of seconds/values and time shift      *
  *                               (optional)                                   *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
@@ -2165,8 +2211,8 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_TIMELEFT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_TIMELEFT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	char				*fit_str = NULL;
 	double				*t = NULL, *x = NULL, threshold;
@@ -2188,20 +2234,20 @@ static int	evaluate_TIMELEFT(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 		goto out;
 	}
 
-	if (2 > (nparams = zbx_num_param(parameters)) || nparams > 3)
+	if (2 > (nparams = params->num) || nparams > 3)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_float(parameters, 2, ZBX_FLAG_DOUBLE_SUFFIX, &threshold))
+	if (SUCCEED != get_function_parameter_float(params->str, 2, ZBX_FLAG_DOUBLE_SUFFIX, &threshold))
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
 		goto out;
@@ -2209,7 +2255,7 @@ static int	evaluate_TIMELEFT(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 
 	if (3 == nparams)
 	{
-		if (SUCCEED != get_function_parameter_str(parameters, 3, &fit_str) ||
+		if (SUCCEED != get_function_parameter_str(params->str, 3, &fit_str) ||
 				SUCCEED != zbx_fit_code(fit_str, &fit, &k, error))
 		{
 			*error = zbx_strdup(*error, "invalid fourth parameter");
@@ -2376,7 +2422,7 @@ out:
  *             item       - [IN] item (performance metric)                    *
  *             func       - [IN] the trend function to evaluate               *
  *                               (avg, sum, count, delta, max, min)           *
- *             parameters - [IN] function parameters                          *
+ *             params     - [IN] function parameters                          *
  *             ts         - [IN] historical time when function must be        *
  *                               evaluated                                    *
  *             error      - [OUT]                                             *
@@ -2387,7 +2433,7 @@ out:
  *                                                                            *
  ******************************************************************************/
 static int	evaluate_TREND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *func,
-		const char *parameters, const zbx_timespec_t *ts, char **error)
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	time_t		start, end;
 	int		ret = FAIL;
@@ -2397,19 +2443,19 @@ static int	evaluate_TREND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
-	if (0 != strcmp(func, "stl") && 1 != zbx_num_param(parameters))
+	if (0 != strcmp(func, "stl") && 1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (0 == strcmp(func, "stl") && (3 > zbx_num_param(parameters) || 6 < zbx_num_param(parameters)))
+	if (0 == strcmp(func, "stl") && (3 > params->num || 6 < params->num))
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_str(parameters, 1, &period))
+	if (SUCCEED != get_function_parameter_str(params->str, 1, &period))
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
@@ -2460,7 +2506,7 @@ static int	evaluate_TREND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 		zbx_uint64_t		s_window;
 		zbx_value_type_t	detect_period_type, season_type;
 
-		if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 2, &detect_period,
+		if (SUCCEED != get_function_parameter_hist_range(ts->sec, params->str, 2, &detect_period,
 				&detect_period_type, &detect_period_shift))
 		{
 			*error = zbx_strdup(*error, "invalid third parameter");
@@ -2484,7 +2530,7 @@ static int	evaluate_TREND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 			goto out;
 		}
 
-		if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 3, &season, &season_type,
+		if (SUCCEED != get_function_parameter_hist_range(ts->sec, params->str, 3, &season, &season_type,
 				&season_shift))
 		{
 			*error = zbx_strdup(*error, "invalid fourth parameter");
@@ -2499,10 +2545,10 @@ static int	evaluate_TREND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 			goto out;
 		}
 
-		if (SUCCEED != get_function_parameter_float(parameters, 4, ZBX_FLAG_DOUBLE_PLAIN, &deviations))
+		if (SUCCEED != get_function_parameter_float(params->str, 4, ZBX_FLAG_DOUBLE_PLAIN, &deviations))
 			deviations = STL_DEF_DEVIATIONS;
 
-		if (SUCCEED != get_function_parameter_str(parameters, 5, &dev_alg) || '\0' == *dev_alg)
+		if (SUCCEED != get_function_parameter_str(params->str, 5, &dev_alg) || '\0' == *dev_alg)
 		{
 			dev_alg = zbx_strdup(dev_alg, "mad");
 		}
@@ -2514,7 +2560,7 @@ static int	evaluate_TREND(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 			goto out;
 		}
 
-		if (SUCCEED != get_function_parameter_uint64(parameters, 6, &s_window))
+		if (SUCCEED != get_function_parameter_uint64(params->str, 6, &s_window))
 			s_window = S_WINDOW_DEF;
 
 		season_processed = (int)((double)season / 3600);
@@ -2539,7 +2585,7 @@ out:
 	return ret;
 }
 
-static int	validate_params_and_get_data(const zbx_dc_evaluate_item_t *item, const char *parameters,
+static int	validate_params_and_get_data(const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
 		const zbx_timespec_t *ts, zbx_vector_history_record_t *values, char **error)
 {
 	int			arg1, seconds = 0, nvalues = 0, time_shift;
@@ -2552,13 +2598,13 @@ static int	validate_params_and_get_data(const zbx_dc_evaluate_item_t *item, cons
 		return FAIL;
 	}
 
-	if (1 != zbx_num_param(parameters))
+	if (1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		return FAIL;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid parameter");
@@ -2596,7 +2642,7 @@ static int	validate_params_and_get_data(const zbx_dc_evaluate_item_t *item, cons
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] Nth first value and time shift (optional)    *
+ *             params     - [IN] Nth first value and time shift (optional)    *
  *             ts         - [IN] starting timestamp                           *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -2605,8 +2651,8 @@ static int	validate_params_and_get_data(const zbx_dc_evaluate_item_t *item, cons
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_FIRST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_FIRST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int				arg1 = 1, ret = FAIL, seconds = 0, time_shift;
 	zbx_value_type_t		arg1_type = ZBX_VALUE_NVALUES;
@@ -2617,13 +2663,13 @@ static int	evaluate_FIRST(zbx_variant_t *value, const zbx_dc_evaluate_item_t *it
 
 	zbx_history_record_vector_create(&values);
 
-	if (1 != zbx_num_param(parameters))
+	if (1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift))
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift))
 	{
 		*error = zbx_strdup(*error, "invalid parameter");
 		goto out;
@@ -2708,7 +2754,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] mode, strict or weak monotonicity            *
+ *             params     - [IN] mode, strict or weak monotonicity            *
  *             ts         - [IN] function execution time                      *
  *             gradient   - [IN] check increase or decrease of monotonicity   *
  *             error      - [OUT]                                             *
@@ -2718,7 +2764,7 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_MONO(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
+static int	evaluate_MONO(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
 		const zbx_timespec_t *ts, int gradient, char **error)
 {
 	int				arg1, i, num, time_shift, strict = 0, ret = FAIL, seconds = 0, nvalues = 0;
@@ -2738,7 +2784,7 @@ static int	evaluate_MONO(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 		goto out;
 	}
 
-	num = zbx_num_param(parameters);
+	num = params->num;
 
 	if (1 > num || 2 < num )
 	{
@@ -2746,14 +2792,14 @@ static int	evaluate_MONO(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (1 < num && (SUCCEED != get_function_parameter_str(parameters, 2, &arg2) ||
+	if (1 < num && (SUCCEED != get_function_parameter_str(params->str, 2, &arg2) ||
 			('\0' != *arg2 && 0 == (strict = (0 == strcmp("strict", arg2))) &&
 			0 != strcmp("weak", arg2))))
 	{
@@ -2848,7 +2894,7 @@ out:
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] seconds, time shift (optional)               *
+ *             params     - [IN] seconds, time shift (optional)               *
  *             ts         - [IN] function execution time                      *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -2857,7 +2903,7 @@ out:
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_RATE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
+static int	evaluate_RATE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const zbx_func_params_t *params,
 		const zbx_timespec_t *ts, char **error)
 {
 #	define HVD(v) (ITEM_VALUE_TYPE_FLOAT == item->value_type ? v.dbl : (double)v.ui64)
@@ -2870,7 +2916,7 @@ static int	evaluate_RATE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 	zbx_vector_history_record_t	values;
 	zbx_timespec_t			ts_end = *ts;
 
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() params:%s", __func__, parameters);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() params:%s", __func__, params->str);
 
 	zbx_history_record_vector_create(&values);
 
@@ -2880,13 +2926,13 @@ static int	evaluate_RATE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *ite
 		goto out;
 	}
 
-	if (1 != zbx_num_param(parameters))
+	if (1 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
@@ -2996,6 +3042,8 @@ int	zbx_evaluate_RATE(zbx_variant_t *value, zbx_dc_item_t *item, const char *par
 		char **error)
 {
 	zbx_dc_evaluate_item_t	evaluate_item;
+	zbx_func_params_t	params;
+	int			ret;
 
 	evaluate_item.itemid = item->itemid;
 	evaluate_item.value_type = item->value_type;
@@ -3003,7 +3051,11 @@ int	zbx_evaluate_RATE(zbx_variant_t *value, zbx_dc_item_t *item, const char *par
 	evaluate_item.host = item->host.host;
 	evaluate_item.key_orig = item->key_orig;
 
-	return evaluate_RATE(value, &evaluate_item, parameters, ts, error);
+	function_params_parse(&params, parameters);
+	ret = evaluate_RATE(value, &evaluate_item, &params, ts, error);
+	function_params_clear(&params);
+
+	return ret;
 }
 
 #define LAST(v, type) v.values[i].value.type
@@ -3058,7 +3110,7 @@ int	zbx_evaluate_RATE(zbx_variant_t *value, zbx_dc_item_t *item, const char *par
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] mode, increases, decreases or all changes    *
+ *             params     - [IN] mode, increases, decreases or all changes    *
  *             ts         - [IN] function execution time                      *
  *             error      - [OUT]                                             *
  *                                                                            *
@@ -3067,8 +3119,8 @@ int	zbx_evaluate_RATE(zbx_variant_t *value, zbx_dc_item_t *item, const char *par
  *               FAIL - failed to evaluate function                           *
  *                                                                            *
  ******************************************************************************/
-static int	evaluate_CHANGECOUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *parameters,
-		const zbx_timespec_t *ts, char **error)
+static int	evaluate_CHANGECOUNT(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int				arg1, i, nparams, time_shift, mode, ret = FAIL, seconds = 0, nvalues = 0;
 	char				*arg2 = NULL;
@@ -3081,21 +3133,21 @@ static int	evaluate_CHANGECOUNT(zbx_variant_t *value, const zbx_dc_evaluate_item
 
 	zbx_history_record_vector_create(&values);
 
-	nparams = zbx_num_param(parameters);
+	nparams = params->num;
 	if (1 > nparams || 2 < nparams)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_hist_range(ts->sec, parameters, 1, &arg1, &arg1_type, &time_shift) ||
+	if (SUCCEED != get_function_params_hist_range(ts->sec, params, &arg1, &arg1_type, &time_shift) ||
 			ZBX_VALUE_NONE == arg1_type)
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (1 < nparams && (SUCCEED != get_function_parameter_str(parameters, 2, &arg2)))
+	if (1 < nparams && (SUCCEED != get_function_parameter_str(params->str, 2, &arg2)))
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
 		goto out;
@@ -3219,7 +3271,7 @@ out:
  * Parameters: value      - [OUT] function result                             *
  *             item       - [IN] item (performance metric)                    *
  *             func       - [IN] baseline function to evaluate (wma, dev)     *
- *             parameters - [IN] function parameters                          *
+ *             params     - [IN] function parameters                          *
  *             ts         - [IN] historical time when function must be        *
  *                               evaluated                                    *
  *             error      - [OUT]                                             *
@@ -3230,7 +3282,7 @@ out:
  *                                                                            *
  ******************************************************************************/
 static int	evaluate_BASELINE(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *func,
-		const char *parameters, const zbx_timespec_t *ts, char **error)
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int			ret = FAIL, season_num;
 	char			*period = NULL, *tmp = NULL;
@@ -3244,19 +3296,19 @@ static int	evaluate_BASELINE(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 	zbx_vector_dbl_create(&values);
 	zbx_vector_uint64_create(&index);
 
-	if (3 != zbx_num_param(parameters))
+	if (3 != params->num)
 	{
 		*error = zbx_strdup(*error, "invalid number of parameters");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_str(parameters, 1, &period))
+	if (SUCCEED != get_function_parameter_str(params->str, 1, &period))
 	{
 		*error = zbx_strdup(*error, "invalid second parameter");
 		goto out;
 	}
 
-	if (SUCCEED != get_function_parameter_str(parameters, 2, &tmp) ||
+	if (SUCCEED != get_function_parameter_str(params->str, 2, &tmp) ||
 			ZBX_TIME_UNIT_HOUR > (season_unit = zbx_tm_str_to_unit(tmp)))
 	{
 		*error = zbx_strdup(*error, "invalid third parameter");
@@ -3264,7 +3316,7 @@ static int	evaluate_BASELINE(zbx_variant_t *value, const zbx_dc_evaluate_item_t
 	}
 	zbx_free(tmp);
 
-	if (SUCCEED != get_function_parameter_str(parameters, 3, &tmp) || 0 >= (season_num = atoi(tmp)))
+	if (SUCCEED != get_function_parameter_str(params->str, 3, &tmp) || 0 >= (season_num = atoi(tmp)))
 	{
 		*error = zbx_strdup(*error, "invalid fourth parameter");
 		goto out;
@@ -3378,7 +3430,7 @@ static void	history_to_dbl_vector(const zbx_history_record_t *v, int n, unsigned
  *                                                                            *
  * Parameters: value      - [OUT] result                                      *
  *             item       - [IN] item (performance metric)                    *
- *             parameters - [IN] number of seconds/values and time shift      *
+ *             params     - [IN] number of seconds/values and time shift      *
  *                               (optional)                                   *
  *             ts         - [IN] time shift                                   *
  *             stat_func  - [IN] pointer to aggregate function to be called   *
@@ -3391,8 +3443,8 @@ static void	history_to_dbl_vector(const zbx_history_record_t *v, int n, unsigned
  *                                                                            *
  ******************************************************************************/
 static int	evaluate_statistical_func(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
-		const char *parameters, const zbx_timespec_t *ts, zbx_statistical_func_t stat_func, int min_values,
-		char **error)
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, zbx_statistical_func_t stat_func,
+		int min_values, char **error)
 {
 	int				ret = FAIL;
 	zbx_vector_history_record_t	values;
@@ -3401,7 +3453,7 @@ static int	evaluate_statistical_func(zbx_variant_t *value, const zbx_dc_evaluate
 
 	zbx_history_record_vector_create(&values);
 
-	if (SUCCEED != validate_params_and_get_data(item, parameters, ts, &values, error))
+	if (SUCCEED != validate_params_and_get_data(item, params, ts, &values, error))
 		goto out;
 
 	if (min_values <= values.values_num)
@@ -3430,63 +3482,67 @@ out:
 
 /******************************************************************************
  *                                                                            *
- * Purpose: evaluate function.                                                *
+ * Purpose: evaluate function with parsed parameters.                         *
  *                                                                            *
- * Parameters: value     - [OUT] dynamic buffer, result                       *
- *             item      - [IN] item to calculate function for                *
- *             function  - [IN] function (for example, 'max')                 *
- *             parameter - [IN] parameter of function                         *
- *             ts        - [IN] starting timestamp                            *
- *             error     - [OUT]                                              *
+ * Parameters: value    - [OUT] dynamic buffer, result                        *
+ *             item     - [IN] item to calculate function for                 *
+ *             function - [IN] function (for example, 'max')                  *
+ *             params   - [IN] parsed parameters of function                  *
+ *             ts       - [IN] starting timestamp                             *
+ *             error    - [OUT]                                               *
  *                                                                            *
  * Return value: SUCCEED - evaluated successfully, value contains its value   *
  *               FAIL - evaluation failed                                     *
  *                                                                            *
+ * Comments: Parameters can be parsed once with function_params_parse() and   *
+ *           reused while function and its user macros are not changed.       *
+ *                                                                            *
  ******************************************************************************/
-int	evaluate_function(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *function,
-		const char *parameter, const zbx_timespec_t *ts, char **error)
+int	evaluate_function_parsed(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *function,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error)
 {
 	int		ret;
 	const char	*ptr;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() function:'%s(/%s/%s,%s)' ts:'%s\'", __func__,
-			function, item->host, item->key_orig, parameter, zbx_timespec_str(ts));
+			function, item->host, item->key_orig, ZBX_NULL2EMPTY_STR(params->str),
+			zbx_timespec_str(ts));
 
 	if (0 == strcmp(function, "last"))
 	{
-		ret = evaluate_LAST(value, item, parameter, ts, error);
+		ret = evaluate_LAST(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "min"))
 	{
-		ret = evaluate_MIN_or_MAX(value, item, parameter, ts, error, EVALUATE_MIN);
+		ret = evaluate_MIN_or_MAX(value, item, params, ts, error, EVALUATE_MIN);
 	}
 	else if (0 == strcmp(function, "max"))
 	{
-		ret = evaluate_MIN_or_MAX(value, item, parameter, ts, error, EVALUATE_MAX);
+		ret = evaluate_MIN_or_MAX(value, item, params, ts, error, EVALUATE_MAX);
 	}
 	else if (0 == strcmp(function, "avg"))
 	{
-		ret = evaluate_AVG(value, item, parameter, ts, error);
+		ret = evaluate_AVG(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "sum"))
 	{
-		ret = evaluate_SUM(value, item, parameter, ts, error);
+		ret = evaluate_SUM(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "percentile"))
 	{
-		ret = evaluate_PERCENTILE(value, item, parameter, ts, error);
+		ret = evaluate_PERCENTILE(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "count"))
 	{
-		ret = evaluate_COUNT(value, item, parameter, ts, ZBX_MAX_UINT31_1, COUNT_ALL, error);
+		ret = evaluate_COUNT(value, item, params, ts, ZBX_MAX_UINT31_1, COUNT_ALL, error);
 	}
 	else if (0 == strcmp(function, "countunique"))
 	{
-		ret = evaluate_COUNT(value, item, parameter, ts, ZBX_MAX_UINT31_1, COUNT_UNIQUE, error);
+		ret = evaluate_COUNT(value, item, params, ts, ZBX_MAX_UINT31_1, COUNT_UNIQUE, error);
 	}
 	else if (0 == strcmp(function, "nodata"))
 	{
-		ret = evaluate_NODATA(value, item, parameter, error);
+		ret = evaluate_NODATA(value, item, params, error);
 	}
 	else if (0 == strcmp(function, "change"))
 	{
@@ -3494,95 +3550,95 @@ int	evaluate_function(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
 	}
 	else if (0 == strcmp(function, "find"))
 	{
-		ret = evaluate_COUNT(value, item, parameter, ts, 1, COUNT_ALL, error);
+		ret = evaluate_COUNT(value, item, params, ts, 1, COUNT_ALL, error);
 	}
 	else if (0 == strcmp(function, "fuzzytime"))
 	{
-		ret = evaluate_FUZZYTIME(value, item, parameter, ts, error);
+		ret = evaluate_FUZZYTIME(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "logeventid"))
 	{
-		ret = evaluate_LOGEVENTID(value, item, parameter, ts, error);
+		ret = evaluate_LOGEVENTID(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "logseverity"))
 	{
-		ret = evaluate_LOGSEVERITY(value, item, parameter, ts, error);
+		ret = evaluate_LOGSEVERITY(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "logsource"))
 	{
-		ret = evaluate_LOGSOURCE(value, item, parameter, ts, error);
+		ret = evaluate_LOGSOURCE(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "bitand"))
 	{
-		ret = evaluate_BITAND(value, item, parameter, ts, error);
+		ret = evaluate_BITAND(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "forecast"))
 	{
-		ret = evaluate_FORECAST(value, item, parameter, ts, error);
+		ret = evaluate_FORECAST(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "timeleft"))
 	{
-		ret = evaluate_TIMELEFT(value, item, parameter, ts, error);
+		ret = evaluate_TIMELEFT(value, item, params, ts, error);
 	}
 	else if (0 == strncmp(function, "trend", 5))
 	{
-		ret = evaluate_TREND(value, item, function + 5, parameter, ts, error);
+		ret = evaluate_TREND(value, item, function + 5, params, ts, error);
 	}
 	else if (0 == strcmp(function, "first"))
 	{
-		ret = evaluate_FIRST(value, item, parameter, ts, error);
+		ret = evaluate_FIRST(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "kurtosis"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_kurtosis, 1, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_kurtosis, 1, error);
 	}
 	else if (0 == strcmp(function, "mad"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_mad, 1, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_mad, 1, error);
 	}
 	else if (0 == strcmp(function, "skewness"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_skewness, 1, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_skewness, 1, error);
 	}
 	else if (0 == strcmp(function, "stddevpop"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_stddevpop, 1, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_stddevpop, 1, error);
 	}
 	else if (0 == strcmp(function, "stddevsamp"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_stddevsamp, 2, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_stddevsamp, 2, error);
 	}
 	else if (0 == strcmp(function, "sumofsquares"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_sumofsquares, 1, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_sumofsquares, 1, error);
 	}
 	else if (0 == strcmp(function, "varpop"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_varpop, 1, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_varpop, 1, error);
 	}
 	else if (0 == strcmp(function, "varsamp"))
 	{
-		ret = evaluate_statistical_func(value, item, parameter, ts, zbx_eval_calc_varsamp, 2, error);
+		ret = evaluate_statistical_func(value, item, params, ts, zbx_eval_calc_varsamp, 2, error);
 	}
 	else if (0 == strcmp(function, "monoinc"))
 	{
-		ret = evaluate_MONO(value, item, parameter, ts, MONOINC, error);
+		ret = evaluate_MONO(value, item, params, ts, MONOINC, error);
 	}
 	else if (0 == strcmp(function, "monodec"))
 	{
-		ret = evaluate_MONO(value, item, parameter, ts, MONODEC, error);
+		ret = evaluate_MONO(value, item, params, ts, MONODEC, error);
 	}
 	else if (0 == strcmp(function, "rate"))
 	{
-		ret = evaluate_RATE(value, item, parameter, ts, error);
+		ret = evaluate_RATE(value, item, params, ts, error);
 	}
 	else if (0 == strcmp(function, "changecount"))
 	{
-		ret = evaluate_CHANGECOUNT(value, item, parameter, ts, error);
+		ret = evaluate_CHANGECOUNT(value, item, params, ts, error);
 	}
 	else if (0 == strncmp(function, "baseline", 8))
 	{
-		ret = evaluate_BASELINE(value, item, function + 8, parameter, ts, error);
+		ret = evaluate_BASELINE(value, item, function + 8, params, ts, error);
 	}
 	else if (NULL != (ptr = strstr(function, "_foreach")) && ZBX_CONST_STRLEN("_foreach") == strlen(ptr))
 	{
@@ -3600,6 +3656,34 @@ int	evaluate_function(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item,
 
 	return ret;
 }
+/******************************************************************************
+ *                                                                            *
+ * Purpose: evaluate function.                                                *
+ *                                                                            *
+ * Parameters: value     - [OUT] dynamic buffer, result                       *
+ *             item      - [IN] item to calculate function for                *
+ *             function  - [IN] function (for example, 'max')                 *
+ *             parameter - [IN] parameter of function                         *
+ *             ts        - [IN] starting timestamp                            *
+ *             error     - [OUT]                                              *
+ *                                                                            *
+ * Return value: SUCCEED - evaluated successfully, value contains its value   *
+ *               FAIL - evaluation failed                                     *
+ *                                                                            *
+ ******************************************************************************/
+int	evaluate_function(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *function,
+		const char *parameter, const zbx_timespec_t *ts, char **error)
+{
+	zbx_func_params_t	params;
+	int			ret;
+
+	function_params_parse(&params, parameter);
+	ret = evaluate_function_parsed(value, item, function, &params, ts, error);
+	function_params_clear(&params);
+
+	return ret;
+}
+
 #undef MONOINC
 #undef MONODEC
 #undef EVALUATE_MIN
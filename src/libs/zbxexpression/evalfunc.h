@@ -38,6 +38,18 @@ typedef enum
 }
 zbx_value_type_t;
 
+/* trigger function parameters parsed for repeated evaluation */
+typedef struct
+{
+	char			*str;		/* parameters with expanded user macros */
+	int			num;		/* number of parameters */
+	int			range;		/* the first parameter - sec|#num history range */
+	zbx_value_type_t	range_type;
+	char			*range_shift;	/* the history range timeshift, NULL if absent */
+	int			range_ret;	/* SUCCEED if the first parameter is valid history range */
+}
+zbx_func_params_t;
+
 typedef struct
 {
 	char	value[ZBX_VALUEMAP_STRING_LEN];
@@ -56,6 +68,8 @@ int	zbx_evaluate_RATE(zbx_variant_t *value, zbx_dc_item_t *item, const char *par
 
 int	evaluate_function(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *function,
 		const char *parameter, const zbx_timespec_t *ts, char **error);
+int	evaluate_function_parsed(zbx_variant_t *value, const zbx_dc_evaluate_item_t *item, const char *function,
+		const zbx_func_params_t *params, const zbx_timespec_t *ts, char **error);
 int	evaluate_value_by_map(char *value, size_t max_len, zbx_vector_valuemaps_ptr_t *valuemaps,
 		unsigned char value_type);
 
@@ -23,6 +23,7 @@
 #include "zbxtrends.h"
 #include "zbxnum.h"
 #include "zbxexpr.h"
+#include "zbxparam.h"
 #include "zbxtime.h"
 
 int	get_function_parameter_uint64(const char *parameters, int Nparam, zbx_uint64_t *value)
@@ -85,6 +86,65 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse sec|#num history range without timeshift                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	function_parameter_parse_range(const char *parameter, int *value, zbx_value_type_t *type)
+{
+	if ('\0' == *parameter)
+	{
+		*value = 0;
+		*type = ZBX_VALUE_NONE;
+	}
+	else if ('#' != *parameter)
+	{
+		if (SUCCEED != zbx_is_time_suffix(parameter, value, ZBX_LENGTH_UNLIMITED) || 0 > *value)
+			return FAIL;
+
+		*type = ZBX_VALUE_SECONDS;
+	}
+	else
+	{
+		if (SUCCEED != zbx_is_uint31(parameter + 1, value) || 0 >= *value)
+			return FAIL;
+		*type = ZBX_VALUE_NVALUES;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: calculate history range timeshift relative to the function        *
+ *          calculation time                                                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	function_parameter_parse_timeshift(int from, const char *shift, int *timeshift)
+{
+	struct tm	tm;
+	char		*error = NULL;
+	int		end;
+
+	if (SUCCEED != zbx_trends_parse_timeshift(from, shift, &tm, &error))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() timeshift error:%s", __func__, error);
+		zbx_free(error);
+		return FAIL;
+	}
+
+	if (-1 == (end = (int)mktime(&tm)))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "%s() invalid timeshift value:%s", __func__, zbx_strerror(errno));
+		return FAIL;
+	}
+
+	*timeshift = from - end;
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: get the value of sec|num + timeshift trigger function parameter.  *
@@ -116,46 +176,13 @@ int	get_function_parameter_hist_range(int from, const char *parameters, int Npar
 	if (NULL != (shift = strchr(parameter, ':')))
 		*shift++ = '\0';
 
-	if ('\0' == *parameter)
-	{
-		*value = 0;
-		*type = ZBX_VALUE_NONE;
-	}
-	else if ('#' != *parameter)
-	{
-		if (SUCCEED != zbx_is_time_suffix(parameter, value, ZBX_LENGTH_UNLIMITED) || 0 > *value)
-			goto out;
-
-		*type = ZBX_VALUE_SECONDS;
-	}
-	else
-	{
-		if (SUCCEED != zbx_is_uint31(parameter + 1, value) || 0 >= *value)
-			goto out;
-		*type = ZBX_VALUE_NVALUES;
-	}
+	if (SUCCEED != function_parameter_parse_range(parameter, value, type))
+		goto out;
 
 	if (NULL != shift)
 	{
-		struct tm	tm;
-		char		*error = NULL;
-		int		end;
-
-		if (SUCCEED != zbx_trends_parse_timeshift(from, shift, &tm, &error))
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "%s() timeshift error:%s", __func__, error);
-			zbx_free(error);
+		if (SUCCEED != function_parameter_parse_timeshift(from, shift, timeshift))
 			goto out;
-		}
-
-		if (-1 == (end = (int)mktime(&tm)))
-		{
-			zabbix_log(LOG_LEVEL_DEBUG, "%s() invalid timeshift value:%s", __func__,
-					zbx_strerror(errno));
-			goto out;
-		}
-
-		*timeshift = from - end;
 	}
 	else
 		*timeshift = 0;
@@ -230,3 +257,86 @@ out:
 
 	return ret;
 }
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parse trigger function parameters into reusable form              *
+ *                                                                            *
+ * Parameters: params     - [OUT] the parsed parameters                       *
+ *             parameters - [IN] trigger function parameters with expanded    *
+ *                               user macros                                  *
+ *                                                                            *
+ * Comments: The first parameter is parsed as sec|#num history range, which   *
+ *           is used by most of history functions. Its timeshift depends on   *
+ *           the calculation time, so only its presence is checked here.      *
+ *           The parsed parameters must be freed with                         *
+ *           function_params_clear().                                         *
+ *                                                                            *
+ ******************************************************************************/
+void	function_params_parse(zbx_func_params_t *params, const char *parameters)
+{
+	char	*parameter, *shift;
+
+	params->str = NULL != parameters ? zbx_strdup(NULL, parameters) : NULL;
+	params->num = zbx_num_param(parameters);
+	params->range = 0;
+	params->range_type = ZBX_VALUE_NONE;
+	params->range_shift = NULL;
+	params->range_ret = FAIL;
+
+	if (NULL == parameters || NULL == (parameter = zbx_function_get_param_dyn(parameters, 1)))
+		return;
+
+	if (NULL != (shift = strchr(parameter, ':')))
+		*shift++ = '\0';
+
+	if (SUCCEED == (params->range_ret = function_parameter_parse_range(parameter, &params->range,
+			&params->range_type)) && NULL != shift)
+	{
+		params->range_shift = zbx_strdup(NULL, shift);
+	}
+
+	zbx_free(parameter);
+}
+
+void	function_params_clear(zbx_func_params_t *params)
+{
+	zbx_free(params->str);
+	zbx_free(params->range_shift);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the value of sec|num + timeshift first parameter of parsed    *
+ *          trigger function parameters                                       *
+ *                                                                            *
+ * Parameters: from      - [IN] function calculation time                     *
+ *             params    - [IN] the parsed trigger function parameters        *
+ *             value     - [OUT] parameter value                              *
+ *             type      - [OUT] parameter value type (number of seconds      *
+ *                               or number of values)                         *
+ *             timeshift - [OUT] timeshift value (0 if absent)                *
+ *                                                                            *
+ * Return value: SUCCEED - parameter is valid                                 *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ ******************************************************************************/
+int	get_function_params_hist_range(int from, const zbx_func_params_t *params, int *value, zbx_value_type_t *type,
+		int *timeshift)
+{
+	if (SUCCEED != params->range_ret)
+		return FAIL;
+
+	if (NULL != params->range_shift)
+	{
+		if (SUCCEED != function_parameter_parse_timeshift(from, params->range_shift, timeshift))
+			return FAIL;
+	}
+	else
+		*timeshift = 0;
+
+	*value = params->range;
+	*type = params->range_type;
+
+	return SUCCEED;
+}
@@ -28,4 +28,9 @@ int	get_function_parameter_str(const char *parameters, int Nparam, char **value)
 int	get_function_parameter_hist_range(int from, const char *parameters, int Nparam, int *value,
 		zbx_value_type_t *type, int *timeshift);
 int	get_function_parameter_period(const char *parameters, int Nparam, int *value, zbx_value_type_t *type);
+
+void	function_params_parse(zbx_func_params_t *params, const char *parameters);
+void	function_params_clear(zbx_func_params_t *params);
+int	get_function_params_hist_range(int from, const zbx_func_params_t *params, int *value, zbx_value_type_t *type,
+		int *timeshift);
 #endif
@@ -18,6 +18,7 @@
 **/
 
 #include "evalfunc.h"
+#include "funcparam.h"
 #include "expression.h"
 
 #include "zbxdbhigh.h"
@@ -32,6 +33,7 @@
 #include "zbxeval.h"
 #include "zbxexpression.h"
 #include "zbxnum.h"
+#include "zbxstr.h"
 #include "zbxtime.h"
 
 static void	zbx_extract_functionids(zbx_vector_uint64_t *functionids, zbx_vector_dc_trigger_t *triggers)
@@ -222,10 +224,12 @@ void	zbx_determine_items_in_expressions(zbx_vector_dc_trigger_t *trigger_order,
 typedef struct
 {
 	/* input data */
+	zbx_uint64_t	functionid;
 	zbx_uint64_t	itemid;
 	char		*function;
 	char		*parameter;
 	zbx_timespec_t	timespec;
+	zbx_uint64_t	revision;
 	unsigned char	type;
 
 	/* output data */
@@ -286,6 +290,308 @@ static void	func_clean(void *ptr)
 	zbx_variant_clear(&func->value);
 }
 
+/* function results cached between trigger recalculations, indexed by functionid */
+typedef struct
+{
+	zbx_uint64_t	functionid;
+	zbx_uint64_t	itemid;
+	zbx_uint64_t	revision;
+	zbx_timespec_t	timespec;	/* the evaluation time for time window functions */
+	char		*function;
+	char		*params;
+	int		lastaccess;
+	zbx_variant_t	value;
+}
+zbx_func_cache_t;
+
+#define ZBX_FUNC_CACHE_TTL		SEC_PER_HOUR
+#define ZBX_FUNC_CACHE_CLEANUP_PERIOD	(10 * SEC_PER_MIN)
+
+#define ZBX_FUNC_CACHE_NONE	0	/* function result cannot be cached */
+#define ZBX_FUNC_CACHE_VALUES	1	/* function result depends only on item values */
+#define ZBX_FUNC_CACHE_WINDOW	2	/* function result depends on item values and evaluation time */
+
+/* parsed function parameters with expanded user macros, indexed by functionid */
+typedef struct
+{
+	zbx_uint64_t		functionid;
+	zbx_uint64_t		revision;
+	int			lastaccess;
+	zbx_func_params_t	params;
+}
+zbx_func_params_cache_t;
+
+static zbx_hashset_t	func_cache;
+static zbx_hashset_t	func_params_cache;
+static int		func_cache_cleanup_time;
+static zbx_uint64_t	funcs_evaluated, funcs_hits, funcs_misses;
+
+static void	func_cache_clean(void *ptr)
+{
+	zbx_func_cache_t	*cache = (zbx_func_cache_t *)ptr;
+
+	zbx_free(cache->function);
+	zbx_free(cache->params);
+	zbx_variant_clear(&cache->value);
+}
+
+static void	func_params_cache_clean(void *ptr)
+{
+	zbx_func_params_cache_t	*cache = (zbx_func_params_cache_t *)ptr;
+
+	function_params_clear(&cache->params);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get parsed function parameters with expanded user macros          *
+ *                                                                            *
+ * Parameters: func   - [IN] the function                                     *
+ *             hostid - [IN] the function item host identifier                *
+ *                                                                            *
+ * Return value: the parsed function parameters                               *
+ *                                                                            *
+ * Comments: Parameters are parsed only when the function is evaluated for    *
+ *           the first time and again after the function or user macros used  *
+ *           in its parameters were changed, which is tracked by function     *
+ *           revision provided by configuration cache.                        *
+ *                                                                            *
+ ******************************************************************************/
+static const zbx_func_params_t	*func_params_get(const zbx_func_t *func, zbx_uint64_t hostid)
+{
+	zbx_func_params_cache_t	*cache;
+	char			*params;
+
+	if (0 == func_params_cache.num_slots)
+	{
+		zbx_hashset_create_ext(&func_params_cache, 1000, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC, func_params_cache_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	}
+
+	if (NULL == (cache = (zbx_func_params_cache_t *)zbx_hashset_search(&func_params_cache, &func->functionid)))
+	{
+		zbx_func_params_cache_t	cache_local;
+
+		cache_local.functionid = func->functionid;
+		cache = (zbx_func_params_cache_t *)zbx_hashset_insert(&func_params_cache, &cache_local,
+				sizeof(cache_local));
+	}
+	else if (cache->revision == func->revision)
+	{
+		cache->lastaccess = (int)time(NULL);
+
+		return &cache->params;
+	}
+	else
+		function_params_clear(&cache->params);
+
+	params = zbx_dc_expand_user_macros_in_func_params(func->parameter, hostid);
+	function_params_parse(&cache->params, params);
+	zbx_free(params);
+
+	cache->revision = func->revision;
+	cache->lastaccess = (int)time(NULL);
+
+	return &cache->params;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: check if function result can be cached and what it depends on     *
+ *                                                                            *
+ * Parameters: func   - [IN] the function                                     *
+ *             params - [IN] the function parameters with expanded macros     *
+ *                                                                            *
+ * Return value: ZBX_FUNC_CACHE_VALUES - the result depends only on item      *
+ *                                       values (no period or count based     *
+ *                                       period without time shift)           *
+ *               ZBX_FUNC_CACHE_WINDOW - the result depends on item values    *
+ *                                       and the evaluation time (time based  *
+ *                                       period or time shift)                *
+ *               ZBX_FUNC_CACHE_NONE   - the result cannot be cached          *
+ *                                                                            *
+ * Comments: Functions with patterns are not cached as global regular         *
+ *           expressions might be changed without changing function           *
+ *           parameters.                                                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	func_get_cache_mode(const zbx_func_t *func, const char *params)
+{
+	const char	*ptr;
+
+	if (ZBX_FUNCTION_TYPE_HISTORY != func->type)
+		return ZBX_FUNC_CACHE_NONE;
+
+	if (SUCCEED != zbx_str_in_list("last,min,max,avg,sum,percentile,countunique,change,logseverity,bitand,"
+			"kurtosis,mad,skewness,stddevpop,stddevsamp,sumofsquares,varpop,varsamp,monoinc,monodec,"
+			"changecount", func->function, ','))
+	{
+		return ZBX_FUNC_CACHE_NONE;
+	}
+
+	for (ptr = params; ' ' == *ptr; ptr++)
+		;
+
+	if ('\0' == *ptr || ',' == *ptr)
+		return ZBX_FUNC_CACHE_VALUES;
+
+	if ('#' != *ptr++ || 0 == isdigit((unsigned char)*ptr))
+		return ZBX_FUNC_CACHE_WINDOW;
+
+	while (0 != isdigit((unsigned char)*ptr))
+		ptr++;
+
+	while (' ' == *ptr)
+		ptr++;
+
+	return '\0' == *ptr || ',' == *ptr ? ZBX_FUNC_CACHE_VALUES : ZBX_FUNC_CACHE_WINDOW;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get cached function result                                        *
+ *                                                                            *
+ * Parameters: func       - [IN/OUT] the function                             *
+ *             params     - [IN] the function parameters with expanded macros *
+ *             revision   - [IN] the item history revision                    *
+ *             cache_mode - [IN] ZBX_FUNC_CACHE_VALUES or                     *
+ *                               ZBX_FUNC_CACHE_WINDOW                        *
+ *                                                                            *
+ * Return value: SUCCEED - the cached result was copied to function value     *
+ *               FAIL    - the function result is not cached or is outdated   *
+ *                                                                            *
+ * Comments: Results of time window functions are reused only when evaluated  *
+ *           with the same time (window end).                                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	func_cache_get(zbx_func_t *func, const char *params, zbx_uint64_t revision, int cache_mode)
+{
+	zbx_func_cache_t	*cache;
+
+	if (0 == func_cache.num_slots)
+		return FAIL;
+
+	if (NULL == (cache = (zbx_func_cache_t *)zbx_hashset_search(&func_cache, &func->functionid)))
+		return FAIL;
+
+	if (cache->itemid != func->itemid || cache->revision != revision || 0 != strcmp(cache->function,
+			func->function) || 0 != strcmp(cache->params, params))
+	{
+		return FAIL;
+	}
+
+	if (ZBX_FUNC_CACHE_WINDOW == cache_mode && 0 != zbx_timespec_compare(&cache->timespec, &func->timespec))
+		return FAIL;
+
+	cache->lastaccess = (int)time(NULL);
+	zbx_variant_copy(&func->value, &cache->value);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: cache function result                                             *
+ *                                                                            *
+ * Parameters: func     - [IN] the evaluated function                         *
+ *             params   - [IN] the function parameters with expanded macros   *
+ *             revision - [IN] the item history revision before evaluation    *
+ *                                                                            *
+ ******************************************************************************/
+static void	func_cache_set(const zbx_func_t *func, const char *params, zbx_uint64_t revision)
+{
+	zbx_func_cache_t	*cache, cache_local;
+
+	if (0 == func_cache.num_slots)
+	{
+		zbx_hashset_create_ext(&func_cache, 1000, ZBX_DEFAULT_UINT64_HASH_FUNC,
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC, func_cache_clean, ZBX_DEFAULT_MEM_MALLOC_FUNC,
+				ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+		func_cache_cleanup_time = (int)time(NULL);
+	}
+
+	if (NULL == (cache = (zbx_func_cache_t *)zbx_hashset_search(&func_cache, &func->functionid)))
+	{
+		memset(&cache_local, 0, sizeof(cache_local));
+		cache_local.functionid = func->functionid;
+		cache = (zbx_func_cache_t *)zbx_hashset_insert(&func_cache, &cache_local, sizeof(cache_local));
+	}
+	else
+		zbx_variant_clear(&cache->value);
+
+	cache->itemid = func->itemid;
+	cache->revision = revision;
+	cache->timespec = func->timespec;
+	cache->function = zbx_strdup(cache->function, func->function);
+	cache->params = zbx_strdup(cache->params, params);
+	cache->lastaccess = (int)time(NULL);
+	zbx_variant_copy(&cache->value, &func->value);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove cached results and parameters of functions not evaluated   *
+ *          for a while                                                       *
+ *                                                                            *
+ ******************************************************************************/
+static void	func_cache_cleanup(void)
+{
+	zbx_func_cache_t	*cache;
+	zbx_func_params_cache_t	*params_cache;
+	zbx_hashset_iter_t	iter;
+	int			now;
+
+	now = (int)time(NULL);
+
+	if (now - func_cache_cleanup_time < ZBX_FUNC_CACHE_CLEANUP_PERIOD)
+		return;
+
+	if (0 != func_cache.num_slots)
+	{
+		zbx_hashset_iter_reset(&func_cache, &iter);
+		while (NULL != (cache = (zbx_func_cache_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (now - cache->lastaccess >= ZBX_FUNC_CACHE_TTL)
+				zbx_hashset_iter_remove(&iter);
+		}
+	}
+
+	if (0 != func_params_cache.num_slots)
+	{
+		zbx_hashset_iter_reset(&func_params_cache, &iter);
+		while (NULL != (params_cache = (zbx_func_params_cache_t *)zbx_hashset_iter_next(&iter)))
+		{
+			if (now - params_cache->lastaccess >= ZBX_FUNC_CACHE_TTL)
+				zbx_hashset_iter_remove(&iter);
+		}
+	}
+
+	func_cache_cleanup_time = now;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get trigger function statistics since the last call               *
+ *                                                                            *
+ * Parameters: evaluated - [OUT] the number of evaluated functions            *
+ *             hits      - [OUT] the number of function results taken from    *
+ *                               cache                                        *
+ *             misses    - [OUT] the number of cacheable functions that were  *
+ *                               not found in cache and had to be evaluated   *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_get_trigger_functions_stats(zbx_uint64_t *evaluated, zbx_uint64_t *hits, zbx_uint64_t *misses)
+{
+	*evaluated = funcs_evaluated;
+	*hits = funcs_hits;
+	*misses = funcs_misses;
+
+	funcs_evaluated = 0;
+	funcs_hits = 0;
+	funcs_misses = 0;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: prepare hashset of functions to evaluate.                         *
@@ -343,9 +649,11 @@ static void	zbx_populate_function_items(const zbx_vector_uint64_t *functionids,
 		if (NULL == (func = (zbx_func_t *)zbx_hashset_search(funcs, &func_local)))
 		{
 			func = (zbx_func_t *)zbx_hashset_insert(funcs, &func_local, sizeof(func_local));
+			func->functionid = functions[i].functionid;
 			func->function = zbx_strdup(NULL, func_local.function);
 			func->parameter = zbx_strdup(NULL, func_local.parameter);
 			func->type = functions[i].type;
+			func->revision = functions[i].revision;
 			zbx_variant_set_none(&func->value);
 		}
 
@@ -369,18 +677,38 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 	char			*error = NULL;
 	int			i;
 	zbx_func_t		*func;
-	zbx_vector_uint64_t	itemids;
+	zbx_vector_uint64_t	itemids, revision_itemids;
 	zbx_hashset_iter_t	iter;
+	zbx_vc_item_revision_t	*revisions = NULL;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s() funcs_num:%d", __func__, funcs->num_data);
 
 	zbx_vector_uint64_create(&itemids);
+	zbx_vector_uint64_create(&revision_itemids);
 
 	zbx_hashset_iter_reset(funcs, &iter);
 	while (NULL != (func = (zbx_func_t *)zbx_hashset_iter_next(&iter)))
 	{
 		if (FAIL == zbx_vector_uint64_bsearch(history_itemids, func->itemid, ZBX_DEFAULT_UINT64_COMPARE_FUNC))
 			zbx_vector_uint64_append(&itemids, func->itemid);
+
+		if (ZBX_FUNCTION_TYPE_HISTORY == func->type)
+			zbx_vector_uint64_append(&revision_itemids, func->itemid);
+	}
+
+	/* read history revisions of all items with cacheable functions under one value cache lock */
+	if (0 != revision_itemids.values_num)
+	{
+		zbx_vector_uint64_sort(&revision_itemids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+		zbx_vector_uint64_uniq(&revision_itemids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+		revisions = (zbx_vc_item_revision_t *)zbx_malloc(NULL, sizeof(zbx_vc_item_revision_t) *
+				(size_t)revision_itemids.values_num);
+
+		for (i = 0; i < revision_itemids.values_num; i++)
+			revisions[i].itemid = revision_itemids.values[i];
+
+		zbx_vc_get_items_revisions(revisions, revision_itemids.values_num);
 	}
 
 	if (0 != itemids.values_num)
@@ -402,8 +730,10 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 	{
 		int				errcode, ret;
 		const zbx_history_sync_item_t	*item;
-		char				*params;
+		const zbx_func_params_t		*params;
 		zbx_dc_evaluate_item_t		evaluate_item;
+		const zbx_vc_item_revision_t	*revision = NULL;
+		int				cache_mode;
 
 		/* avoid double copying from configuration cache if already retrieved when saving history */
 		if (FAIL != (i = zbx_vector_uint64_bsearch(history_itemids, func->itemid,
@@ -480,7 +810,7 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 			continue;
 		}
 
-		params = zbx_dc_expand_user_macros_in_func_params(func->parameter, item->host.hostid);
+		params = func_params_get(func, item->host.hostid);
 
 		evaluate_item.itemid = item->itemid;
 		evaluate_item.value_type = item->value_type;
@@ -488,8 +818,35 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 		evaluate_item.host = item->host.host;
 		evaluate_item.key_orig = item->key_orig;
 
-		ret = evaluate_function(&func->value, &evaluate_item, func->function, params, &func->timespec, &error);
-		zbx_free(params);
+		/* the function result can be reused while no values are added to the item history and     */
+		/* either all item values were included in both cached and current evaluation time ranges  */
+		/* or the function time window did not change                                              */
+		if (ZBX_FUNC_CACHE_NONE != (cache_mode = func_get_cache_mode(func, params->str)) &&
+				NULL != (revision = (const zbx_vc_item_revision_t *)bsearch(&func->itemid, revisions,
+				(size_t)revision_itemids.values_num, sizeof(zbx_vc_item_revision_t),
+				ZBX_DEFAULT_UINT64_COMPARE_FUNC)))
+		{
+			if (0 == revision->revision || (ZBX_FUNC_CACHE_VALUES == cache_mode &&
+					0 < zbx_timespec_compare(&revision->ts, &func->timespec)))
+			{
+				revision = NULL;
+			}
+			else if (SUCCEED == func_cache_get(func, params->str, revision->revision, cache_mode))
+			{
+				funcs_hits++;
+				continue;
+			}
+			else
+				funcs_misses++;
+		}
+
+		funcs_evaluated++;
+
+		if (SUCCEED == (ret = evaluate_function_parsed(&func->value, &evaluate_item, func->function, params,
+				&func->timespec, &error)) && NULL != revision)
+		{
+			func_cache_set(func, params->str, revision->revision);
+		}
 
 		if (SUCCEED != ret)
 		{
@@ -503,8 +860,12 @@ static void	zbx_evaluate_item_functions(zbx_hashset_t *funcs, const zbx_vector_u
 	}
 
 	zbx_vc_flush_stats();
+	zbx_free(revisions);
+	zbx_vector_uint64_destroy(&revision_itemids);
 	zbx_vector_uint64_destroy(&itemids);
 
+	func_cache_cleanup();
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
@@ -741,7 +1102,7 @@ void	zbx_evaluate_expressions(zbx_vector_dc_trigger_t *triggers, const zbx_vecto
 	zbx_db_event		event;
 	zbx_dc_trigger_t	*tr;
 	zbx_history_sync_item_t	*items = NULL;
-	int			i, *items_err, items_num = 0;
+	int			i, *items_err = NULL, items_num = 0;
 	double			expr_result;
 	zbx_dc_um_handle_t	*um_handle;
 	zbx_vector_uint64_t	hostids;
@@ -38,13 +38,18 @@ zbx_history_iface_t	history_ifaces[ITEM_VALUE_TYPE_BIN + 1];
  *           configuration. Every value type can have different history storage     *
  *           backend. (Binary value type is not supported for ElasticSearch)        *
  *                                                                                  *
+ * Parameters: config_history_db_copy - [IN] 1 - write SQL history with bulk copy   *
+ *             error                  - [OUT] the error message                     *
+ *                                                                                  *
  ************************************************************************************/
-int	zbx_history_init(char **error)
+int	zbx_history_init(int config_history_db_copy, char **error)
 {
 	/* TODO: support per value type specific configuration */
 
 	const char	*opts[] = {"dbl", "str", "log", "uint", "text", "bin"};
 
+	zbx_history_sql_set_copy(config_history_db_copy);
+
 	for (int i = ITEM_VALUE_TYPE_FLOAT; i <= ITEM_VALUE_TYPE_BIN; i++)
 	{
 
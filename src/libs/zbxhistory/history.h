@@ -54,6 +54,7 @@ struct zbx_history_iface
 
 /* SQL hist */
 void	zbx_history_sql_init(zbx_history_iface_t *hist, unsigned char value_type);
+void	zbx_history_sql_set_copy(int db_copy);
 
 /* elastic hist */
 int	zbx_history_elastic_init(zbx_history_iface_t *hist, unsigned char value_type, char **error);
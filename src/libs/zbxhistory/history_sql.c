@@ -28,11 +28,19 @@ typedef struct
 {
 	unsigned char		initialized;
 	zbx_vector_ptr_t	dbinserts;
+	zbx_vector_ptr_t	dbcopies;
+	/* the history values and interfaces of bulk copy data, used to insert */
+	/* the values if bulk copy fails                                       */
+	const zbx_vector_ptr_t	*history;
+	zbx_vector_ptr_t	ifaces;
 }
 zbx_sql_writer_t;
 
 static zbx_sql_writer_t	writer;
 
+/* write history with bulk copy instead of bulk insert */
+static int	sql_copy = 0;
+
 typedef void (*vc_str2value_func_t)(zbx_history_value_t *value, zbx_db_row_t row);
 
 /* history table data */
@@ -105,6 +113,9 @@ static void	sql_writer_init(void)
 		return;
 
 	zbx_vector_ptr_create(&writer.dbinserts);
+	zbx_vector_ptr_create(&writer.dbcopies);
+	zbx_vector_ptr_create(&writer.ifaces);
+	writer.history = NULL;
 
 	writer.initialized = 1;
 }
@@ -129,6 +140,17 @@ static void	sql_writer_release(void)
 	zbx_vector_ptr_clear(&writer.dbinserts);
 	zbx_vector_ptr_destroy(&writer.dbinserts);
 
+	for (i = 0; i < writer.dbcopies.values_num; i++)
+	{
+		zbx_db_copy_t	*db_copy = (zbx_db_copy_t *)writer.dbcopies.values[i];
+
+		zbx_db_copy_clean(db_copy);
+		zbx_free(db_copy);
+	}
+	zbx_vector_ptr_destroy(&writer.dbcopies);
+
+	zbx_vector_ptr_destroy(&writer.ifaces);
+
 	writer.initialized = 0;
 }
 
@@ -147,7 +169,60 @@ static void	sql_writer_add_dbinsert(zbx_db_insert_t *db_insert)
 
 /************************************************************************************
  *                                                                                  *
- * Purpose: flushes bulk insert data into database                                  *
+ * Purpose: adds bulk copy data to be flushed later                                 *
+ *                                                                                  *
+ * Parameters: hist    - [IN] history storage interface                             *
+ *             history - [IN] history data vector                                   *
+ *             db_copy - [IN] bulk copy data                                        *
+ *                                                                                  *
+ ************************************************************************************/
+static void	sql_writer_add_dbcopy(zbx_history_iface_t *hist, const zbx_vector_ptr_t *history,
+		zbx_db_copy_t *db_copy)
+{
+	sql_writer_init();
+	zbx_vector_ptr_append(&writer.dbcopies, db_copy);
+	zbx_vector_ptr_append(&writer.ifaces, hist);
+	writer.history = history;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: flushes bulk copy data into database                                    *
+ *                                                                                  *
+ * Return value: FLUSH_SUCCEED - the data was copied                                *
+ *               FLUSH_DUPL_REJECTED - the data was rejected because of duplicate   *
+ *                                     values                                       *
+ *               FLUSH_FAIL - the data must be inserted instead                     *
+ *                                                                                  *
+ ************************************************************************************/
+static int	sql_writer_flush_copy(void)
+{
+	int	i, txn_error;
+
+	do
+	{
+		zbx_db_begin();
+
+		for (i = 0; i < writer.dbcopies.values_num; i++)
+			zbx_db_copy_execute((zbx_db_copy_t *)writer.dbcopies.values[i]);
+	}
+	while (ZBX_DB_DOWN == (txn_error = zbx_db_commit()));
+
+	if (ZBX_DB_OK == txn_error)
+		return FLUSH_SUCCEED;
+
+	if (ZBX_DB_FAIL == txn_error && ERR_Z3008 == zbx_db_last_errcode())
+		return FLUSH_DUPL_REJECTED;
+
+	return FLUSH_FAIL;
+}
+
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: flushes bulk copy and bulk insert data into database                    *
+ *                                                                                  *
+ * Comments: If bulk copy fails for other reason than duplicate values, bulk copy   *
+ *           is disabled and the values are inserted instead.                       *
  *                                                                                  *
  ************************************************************************************/
 static int	sql_writer_flush(void)
@@ -159,6 +234,27 @@ static int	sql_writer_flush(void)
 	if (0 == writer.initialized)
 		return SUCCEED;
 
+	if (0 != writer.dbcopies.values_num)
+	{
+		int	ret;
+
+		if (FLUSH_FAIL != (ret = sql_writer_flush_copy()))
+		{
+			sql_writer_release();
+			return ret;
+		}
+
+		zabbix_log(LOG_LEVEL_WARNING, "cannot write history with bulk copy, switching to bulk insert");
+		sql_copy = 0;
+
+		for (i = 0; i < writer.ifaces.values_num; i++)
+		{
+			zbx_history_iface_t	*hist = (zbx_history_iface_t *)writer.ifaces.values[i];
+
+			hist->data.sql_history_func(writer.history);
+		}
+	}
+
 	do
 	{
 		zbx_db_begin();
@@ -311,6 +407,61 @@ static void	add_history_bin(const zbx_vector_ptr_t *history)
 	sql_writer_add_dbinsert(db_insert);
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: creates bulk copy data of history values with the specified value type  *
+ *                                                                                  *
+ * Parameters: value_type - [IN] the value type                                     *
+ *             history    - [IN] history data vector (may have mixed value types)   *
+ *                                                                                  *
+ * Return value: the bulk copy data                                                 *
+ *                                                                                  *
+ ************************************************************************************/
+static zbx_db_copy_t	*copy_history(unsigned char value_type, const zbx_vector_ptr_t *history)
+{
+	zbx_db_copy_t	*db_copy = (zbx_db_copy_t *)zbx_malloc(NULL, sizeof(zbx_db_copy_t));
+
+	if (ITEM_VALUE_TYPE_LOG == value_type)
+	{
+		zbx_db_copy_prepare(db_copy, "history_log", "itemid", "clock", "ns", "timestamp", "source", "severity",
+				"value", "logeventid", (char *)NULL);
+	}
+	else
+	{
+		zbx_db_copy_prepare(db_copy, vc_history_tables[value_type].name, "itemid", "clock", "ns", "value",
+				(char *)NULL);
+	}
+
+	for (int i = 0; i < history->values_num; i++)
+	{
+		const zbx_dc_history_t	*h = (zbx_dc_history_t *)history->values[i];
+		const zbx_log_value_t	*log;
+
+		if (value_type != h->value_type)
+			continue;
+
+		switch (value_type)
+		{
+			case ITEM_VALUE_TYPE_FLOAT:
+				zbx_db_copy_add_values(db_copy, h->itemid, h->ts.sec, h->ts.ns, h->value.dbl);
+				break;
+			case ITEM_VALUE_TYPE_UINT64:
+				zbx_db_copy_add_values(db_copy, h->itemid, h->ts.sec, h->ts.ns, h->value.ui64);
+				break;
+			case ITEM_VALUE_TYPE_LOG:
+				log = h->value.log;
+				zbx_db_copy_add_values(db_copy, h->itemid, h->ts.sec, h->ts.ns, log->timestamp,
+						ZBX_NULL2EMPTY_STR(log->source), log->severity, log->value,
+						log->logeventid);
+				break;
+			default:
+				zbx_db_copy_add_values(db_copy, h->itemid, h->ts.sec, h->ts.ns, h->value.str);
+		}
+	}
+
+	return db_copy;
+}
+
 /******************************************************************************************************************
  *                                                                                                                *
  * database reading support                                                                                       *
@@ -665,7 +816,12 @@ static int	sql_add_values(zbx_history_iface_t *hist, const zbx_vector_ptr_t *his
 	}
 
 	if (0 != h_num)
-		hist->data.sql_history_func(history);
+	{
+		if (0 != sql_copy)
+			sql_writer_add_dbcopy(hist, history, copy_history(hist->value_type, history));
+		else
+			hist->data.sql_history_func(history);
+	}
 
 	return h_num;
 }
@@ -687,6 +843,18 @@ static int	sql_flush(zbx_history_iface_t *hist)
 	return sql_writer_flush();
 }
 
+/************************************************************************************
+ *                                                                                  *
+ * Purpose: sets if history is written with bulk copy instead of bulk insert        *
+ *                                                                                  *
+ * Parameters:  db_copy - [IN] 1 - use bulk copy, 0 - use bulk insert               *
+ *                                                                                  *
+ ************************************************************************************/
+void	zbx_history_sql_set_copy(int db_copy)
+{
+	sql_copy = db_copy;
+}
+
 /************************************************************************************
  *                                                                                  *
  * Purpose: initializes history storage interface                                   *
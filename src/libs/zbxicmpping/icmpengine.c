@@ -0,0 +1,770 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "icmpengine.h"
+
+#include "zbxcomms.h"
+#include "zbxstr.h"
+#include "zbxip.h"
+
+#define ICMP_ENGINE_ECHO_REQUEST	8
+#define ICMP_ENGINE_ECHO_REPLY		0
+#define ICMP_ENGINE_ECHO6_REQUEST	128
+#define ICMP_ENGINE_ECHO6_REPLY		129
+
+#define ICMP_ENGINE_HEADER_SIZE		8	/* type, code, checksum, identifier and sequence number */
+#define ICMP_ENGINE_DATA_MIN		8	/* packet cookie and index stored in the packet data */
+#define ICMP_ENGINE_PACKET_MAX		65536
+#define ICMP_ENGINE_SEND_BATCH		64
+#define ICMP_ENGINE_RCVBUF		(4 * ZBX_MEBIBYTE)
+
+/* defaults of the corresponding fping options when used with -C option */
+#define ICMP_ENGINE_DEFAULT_PERIOD	1000	/* -p, milliseconds */
+#define ICMP_ENGINE_DEFAULT_SIZE	56	/* -b, bytes */
+#define ICMP_ENGINE_DEFAULT_TIMEOUT_MAX	2000	/* -t defaults to -p period up to this value, milliseconds */
+
+typedef struct
+{
+	int		fd;
+	int		family;
+	/* raw IPv4 sockets receive IP header and ICMP packets of all system processes */
+	unsigned char	raw;
+}
+icmp_socket_t;
+
+typedef struct
+{
+	ZBX_FPING_HOST		*host;
+	/* the socket used to ping target, NULL if target address cannot be resolved */
+	icmp_socket_t		*sock;
+	struct sockaddr_storage	addr;
+	socklen_t		addrlen;
+}
+icmp_target_t;
+
+typedef struct
+{
+	icmp_socket_t	sockets[2];
+	int		sockets_num;
+
+	icmp_target_t	*targets;
+	int		targets_num;
+	int		requests_count;
+
+	/* packet send times, 0 if packet was not sent */
+	double		*sent;
+	char		*received;
+	int		sent_num;
+	int		received_num;
+	double		last_sent;
+
+	double		timeout;
+	unsigned char	allow_redirect;
+
+	unsigned short	id;
+	zbx_uint32_t	cookie;
+
+	unsigned char	*packet;
+	size_t		packet_size;
+}
+icmp_engine_t;
+
+static ZBX_THREAD_LOCAL zbx_uint32_t	icmp_cookie_seed;
+
+static double	icmp_time(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+
+	return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+}
+
+static unsigned short	icmp_checksum(const unsigned char *data, size_t len)
+{
+	zbx_uint32_t	sum = 0;
+	size_t		i;
+
+	for (i = 0; i + 1 < len; i += 2)
+	{
+		unsigned short	word;
+
+		memcpy(&word, data + i, sizeof(word));
+		sum += word;
+	}
+
+	if (i < len)
+	{
+		unsigned short	word = 0;
+
+		memcpy(&word, data + i, 1);
+		sum += word;
+	}
+
+	while (0 != (sum >> 16))
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return (unsigned short)~sum;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: open ICMP socket of the specified address family                  *
+ *                                                                            *
+ * Parameters: sock          - [OUT] the opened socket                        *
+ *             family        - [IN] the address family                        *
+ *             source_ip     - [IN] the source address to bind socket to,     *
+ *                                  optional                                  *
+ *             error         - [OUT] the error message                        *
+ *             max_error_len - [IN] the error buffer size                     *
+ *                                                                            *
+ * Return value: SUCCEED - the socket was opened                              *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: Unprivileged datagram ICMP sockets are tried first and raw       *
+ *           sockets, requiring privileges, next.                             *
+ *                                                                            *
+ ******************************************************************************/
+static int	icmp_socket_open(icmp_socket_t *sock, int family, const char *source_ip, char *error,
+		size_t max_error_len)
+{
+	int	protocol = IPPROTO_ICMP, flags, rcvbuf = ICMP_ENGINE_RCVBUF, on = 1;
+
+#ifdef HAVE_IPV6
+	if (AF_INET6 == family)
+		protocol = IPPROTO_ICMPV6;
+#endif
+	sock->family = family;
+	sock->raw = 0;
+
+	if (-1 == (sock->fd = socket(family, SOCK_DGRAM, protocol)))
+	{
+		if (-1 == (sock->fd = socket(family, SOCK_RAW, protocol)))
+		{
+			zbx_snprintf(error, max_error_len, "cannot create ICMP%s socket: %s",
+					AF_INET == family ? "" : "v6", zbx_strerror(errno));
+			return FAIL;
+		}
+
+		sock->raw = 1;
+	}
+
+	if (-1 == (flags = fcntl(sock->fd, F_GETFL, 0)) || -1 == fcntl(sock->fd, F_SETFL, flags | O_NONBLOCK))
+	{
+		zbx_snprintf(error, max_error_len, "cannot set ICMP socket to non-blocking mode: %s",
+				zbx_strerror(errno));
+		goto fail;
+	}
+
+	/* replies to thousands of targets may arrive in a burst */
+	if (-1 == setsockopt(sock->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)))
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot set ICMP socket receive buffer size: %s", zbx_strerror(errno));
+
+	/* kernel timestamps of received packets are not affected by process scheduling */
+#if defined(SO_TIMESTAMPNS)
+	if (-1 == setsockopt(sock->fd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)))
+#elif defined(SO_TIMESTAMP)
+	if (-1 == setsockopt(sock->fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on)))
+#endif
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot enable ICMP socket timestamps: %s", zbx_strerror(errno));
+
+	if (NULL != source_ip)
+	{
+		struct addrinfo	hints, *ai = NULL;
+		int		rc;
+
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = family;
+		hints.ai_flags = AI_NUMERICHOST;
+
+		if (0 != (rc = getaddrinfo(source_ip, NULL, &hints, &ai)))
+		{
+			zbx_snprintf(error, max_error_len, "invalid source IP address '%s': %s", source_ip,
+					gai_strerror(rc));
+			goto fail;
+		}
+
+		rc = bind(sock->fd, ai->ai_addr, ai->ai_addrlen);
+		freeaddrinfo(ai);
+
+		if (-1 == rc)
+		{
+			zbx_snprintf(error, max_error_len, "cannot bind ICMP socket to '%s': %s", source_ip,
+					zbx_strerror(errno));
+			goto fail;
+		}
+	}
+
+	return SUCCEED;
+fail:
+	close(sock->fd);
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: resolve target address and select socket to ping it               *
+ *                                                                            *
+ ******************************************************************************/
+static void	icmp_target_resolve(icmp_engine_t *engine, icmp_target_t *target)
+{
+	struct addrinfo	hints, *ai = NULL, *cur;
+	int		rc, i;
+
+	target->sock = NULL;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = 1 == engine->sockets_num ? engine->sockets[0].family : AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	if (0 != (rc = getaddrinfo(target->host->addr, NULL, &hints, &ai)))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot resolve ICMP ping target \"%s\": %s", target->host->addr,
+				gai_strerror(rc));
+		return;
+	}
+
+	for (cur = ai; NULL != cur && NULL == target->sock; cur = cur->ai_next)
+	{
+		if (sizeof(target->addr) < cur->ai_addrlen)
+			continue;
+
+		for (i = 0; i < engine->sockets_num; i++)
+		{
+			if (engine->sockets[i].family == cur->ai_family)
+			{
+				target->sock = &engine->sockets[i];
+				memcpy(&target->addr, cur->ai_addr, cur->ai_addrlen);
+				target->addrlen = (socklen_t)cur->ai_addrlen;
+				break;
+			}
+		}
+	}
+
+	freeaddrinfo(ai);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: send echo request packet                                          *
+ *                                                                            *
+ * Parameters: engine - [IN/OUT] the ICMP engine                              *
+ *             index  - [IN] the packet index (target index * requests count  *
+ *                           + request index)                                 *
+ *                                                                            *
+ * Return value: SUCCEED - the packet was sent or cannot be sent at all       *
+ *               FAIL    - the socket send buffer is full, retry later        *
+ *                                                                            *
+ ******************************************************************************/
+static int	icmp_packet_send(icmp_engine_t *engine, int index)
+{
+	const icmp_target_t	*target = &engine->targets[index / engine->requests_count];
+	zbx_uint32_t		packet_index = (zbx_uint32_t)index;
+	unsigned short		seq = (unsigned short)index, checksum = 0;
+	double			now;
+
+	engine->packet[0] = AF_INET == target->sock->family ? ICMP_ENGINE_ECHO_REQUEST : ICMP_ENGINE_ECHO6_REQUEST;
+	engine->packet[1] = 0;
+	memcpy(engine->packet + 2, &checksum, sizeof(checksum));
+	memcpy(engine->packet + 4, &engine->id, sizeof(engine->id));
+	memcpy(engine->packet + 6, &seq, sizeof(seq));
+	memcpy(engine->packet + 12, &packet_index, sizeof(packet_index));
+
+	/* ICMPv6 checksum includes IPv6 pseudo header and is always calculated by kernel */
+	if (AF_INET == target->sock->family)
+	{
+		checksum = icmp_checksum(engine->packet, engine->packet_size);
+		memcpy(engine->packet + 2, &checksum, sizeof(checksum));
+	}
+
+	now = icmp_time();
+
+	if (-1 == sendto(target->sock->fd, engine->packet, engine->packet_size, 0,
+			(const struct sockaddr *)&target->addr, target->addrlen))
+	{
+		if (EAGAIN == errno || EWOULDBLOCK == errno || ENOBUFS == errno || EINTR == errno)
+			return FAIL;
+
+		/* the packet is lost, same as fping does on send errors */
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot send ICMP echo request to \"%s\": %s", target->host->addr,
+				zbx_strerror(errno));
+
+		return SUCCEED;
+	}
+
+	engine->sent[index] = now;
+	engine->sent_num++;
+	engine->last_sent = now;
+
+	return SUCCEED;
+}
+
+static int	icmp_addr_compare(const struct sockaddr_storage *addr1, const struct sockaddr_storage *addr2)
+{
+	if (addr1->ss_family != addr2->ss_family)
+		return FAIL;
+
+	if (AF_INET == addr1->ss_family)
+	{
+		if (0 == memcmp(&((const struct sockaddr_in *)addr1)->sin_addr,
+				&((const struct sockaddr_in *)addr2)->sin_addr, sizeof(struct in_addr)))
+		{
+			return SUCCEED;
+		}
+	}
+#ifdef HAVE_IPV6
+	else if (AF_INET6 == addr1->ss_family)
+	{
+		if (0 == memcmp(&((const struct sockaddr_in6 *)addr1)->sin6_addr,
+				&((const struct sockaddr_in6 *)addr2)->sin6_addr, sizeof(struct in6_addr)))
+		{
+			return SUCCEED;
+		}
+	}
+#endif
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: match received packet to sent echo request and update target host *
+ *          statistics                                                        *
+ *                                                                            *
+ * Parameters: engine    - [IN/OUT] the ICMP engine                           *
+ *             sock      - [IN] the socket packet was received from           *
+ *             data      - [IN] the received packet                           *
+ *             len       - [IN] the received packet length                    *
+ *             from      - [IN] the packet source address                     *
+ *             recv_time - [IN] the packet receive time                       *
+ *                                                                            *
+ * Comments: Replies arriving after timeout are ignored, as well as           *
+ *           redirected replies (coming from other address than the target)   *
+ *           unless redirects are allowed.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	icmp_reply_process(icmp_engine_t *engine, const icmp_socket_t *sock, const unsigned char *data,
+		size_t len, const struct sockaddr_storage *from, double recv_time)
+{
+	unsigned short	id, seq;
+	zbx_uint32_t	cookie, index;
+	icmp_target_t	*target;
+	ZBX_FPING_HOST	*host;
+	double		sec;
+
+	if (0 != sock->raw && AF_INET == sock->family)
+	{
+		size_t	header_len;
+
+		if (0 == len || len < (header_len = (size_t)(data[0] & 0x0f) * 4))
+			return;
+
+		data += header_len;
+		len -= header_len;
+	}
+
+	if (ICMP_ENGINE_HEADER_SIZE + ICMP_ENGINE_DATA_MIN > len)
+		return;
+
+	if (data[0] != (AF_INET == sock->family ? ICMP_ENGINE_ECHO_REPLY : ICMP_ENGINE_ECHO6_REPLY))
+		return;
+
+	/* datagram socket identifiers are managed and checked by kernel */
+	memcpy(&id, data + 4, sizeof(id));
+	if (0 != sock->raw && id != engine->id)
+		return;
+
+	memcpy(&cookie, data + 8, sizeof(cookie));
+	if (cookie != engine->cookie)
+		return;
+
+	memcpy(&index, data + 12, sizeof(index));
+	if (index >= (zbx_uint32_t)(engine->targets_num * engine->requests_count))
+		return;
+
+	memcpy(&seq, data + 6, sizeof(seq));
+	if (seq != (unsigned short)index)
+		return;
+
+	target = &engine->targets[index / (zbx_uint32_t)engine->requests_count];
+
+	/* ignore duplicates */
+	if (target->sock != sock || 0 == engine->sent[index] || 0 != engine->received[index])
+		return;
+
+	if (engine->timeout < (sec = recv_time - engine->sent[index]))
+		return;
+
+	if (SUCCEED != icmp_addr_compare(&target->addr, from))
+	{
+		if (0 == engine->allow_redirect)
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "treating redirected response as target host \"%s\" down",
+					target->host->addr);
+			return;
+		}
+	}
+
+	engine->received[index] = 1;
+	engine->received_num++;
+
+	if (0 > sec)
+		sec = 0;
+
+	host = target->host;
+
+	if (0 == host->rcv || host->min > sec)
+		host->min = sec;
+	if (0 == host->rcv || host->max < sec)
+		host->max = sec;
+	host->sum += sec;
+	host->rcv++;
+}
+
+static double	icmp_recv_time(struct msghdr *msg)
+{
+	struct cmsghdr	*cmsg;
+
+	for (cmsg = CMSG_FIRSTHDR(msg); NULL != cmsg; cmsg = CMSG_NXTHDR(msg, cmsg))
+	{
+		if (SOL_SOCKET != cmsg->cmsg_level)
+			continue;
+#if defined(SO_TIMESTAMPNS)
+		if (SCM_TIMESTAMPNS == cmsg->cmsg_type)
+		{
+			struct timespec	ts;
+
+			memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+
+			return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+		}
+#elif defined(SO_TIMESTAMP)
+		if (SCM_TIMESTAMP == cmsg->cmsg_type)
+		{
+			struct timeval	tv;
+
+			memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+
+			return (double)tv.tv_sec + 1.0e-6 * (double)tv.tv_usec;
+		}
+#endif
+	}
+
+	return icmp_time();
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read all packets queued in socket                                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	icmp_packets_recv(icmp_engine_t *engine, const icmp_socket_t *sock, unsigned char *buf)
+{
+	for (;;)
+	{
+		struct sockaddr_storage	from;
+		struct iovec		iov;
+		struct msghdr		msg;
+		char			control[256];
+		ssize_t			n;
+
+		iov.iov_base = buf;
+		iov.iov_len = ICMP_ENGINE_PACKET_MAX;
+
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_name = &from;
+		msg.msg_namelen = sizeof(from);
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		if (-1 == (n = recvmsg(sock->fd, &msg, 0)))
+		{
+			if (EINTR == errno)
+				continue;
+
+			if (EAGAIN != errno && EWOULDBLOCK != errno)
+				zabbix_log(LOG_LEVEL_DEBUG, "cannot receive ICMP packet: %s", zbx_strerror(errno));
+
+			return;
+		}
+
+		icmp_reply_process(engine, sock, buf, (size_t)n, &from, icmp_recv_time(&msg));
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: set target host names by reverse DNS lookup, same as fping -dA    *
+ *          option                                                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	icmp_targets_resolve_dnsname(icmp_engine_t *engine)
+{
+	int	i;
+
+	for (i = 0; i < engine->targets_num; i++)
+	{
+		icmp_target_t	*target = &engine->targets[i];
+		char		name[NI_MAXHOST];
+
+		if (NULL == target->sock)
+			continue;
+
+		if (0 != getnameinfo((const struct sockaddr *)&target->addr, target->addrlen, name, sizeof(name),
+				NULL, 0, NI_NAMEREQD) || ZBX_MAX_DNSNAME_LEN < zbx_strlen_utf8(name))
+		{
+			*name = '\0';
+		}
+
+		target->host->dnsname = zbx_strdup(target->host->dnsname, name);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: ping hosts using ICMP sockets                                     *
+ *                                                                            *
+ * Parameters: hosts          - [IN/OUT] list of target hosts                 *
+ *             hosts_count    - [IN] number of target hosts                   *
+ *             requests_count - [IN] number of pings to send to each target   *
+ *             period         - [IN] interval between ping packets to one     *
+ *                                   target, in milliseconds, 0 - default     *
+ *             size           - [IN] amount of ping data to send, in bytes,   *
+ *                                   0 - default                              *
+ *             timeout        - [IN] time to wait for every reply, in         *
+ *                                   milliseconds, 0 - default                *
+ *             allow_redirect - [IN] treat redirected response as host up:    *
+ *                                   0 - no, 1 - yes                          *
+ *             rdns           - [IN] set host names by reverse DNS lookup     *
+ *             source_ip      - [IN] source address to send pings from,       *
+ *                                   optional                                 *
+ *             error          - [OUT] error string if function fails          *
+ *             max_error_len  - [IN] length of error buffer                   *
+ *                                                                            *
+ * Return value: SUCCEED      - hosts were pinged                             *
+ *               FAIL         - ICMP sockets cannot be opened, for example    *
+ *                              because of missing privileges                 *
+ *               NOTSUPPORTED - unexpected error                              *
+ *                                                                            *
+ * Comments: Echo requests are sent to all targets in rounds, one round every *
+ *           period. Replies are received from non-blocking sockets in the    *
+ *           same poll loop and their round trip time is measured with kernel *
+ *           receive timestamps when available. Defaults and the host         *
+ *           statistics follow the fping -C output processing.                *
+ *                                                                            *
+ ******************************************************************************/
+int	icmp_engine_ping(ZBX_FPING_HOST *hosts, int hosts_count, int requests_count, int period, int size,
+		int timeout, unsigned char allow_redirect, int rdns, const char *source_ip, char *error,
+		size_t max_error_len)
+{
+	icmp_engine_t	engine;
+	zbx_pollfd_t	pfds[2];
+	unsigned char	*buf = NULL;
+	double		start, period_sec;
+	int		i, ret = NOTSUPPORTED, round = 0, next = 0, packets_num;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() hosts_count:%d", __func__, hosts_count);
+
+	memset(&engine, 0, sizeof(engine));
+
+	if (NULL != source_ip)
+	{
+		int	family = AF_INET;
+
+#ifdef HAVE_IPV6
+		if (SUCCEED != zbx_is_ip4(source_ip))
+			family = AF_INET6;
+#endif
+		if (SUCCEED != icmp_socket_open(&engine.sockets[0], family, source_ip, error, max_error_len))
+		{
+			ret = FAIL;
+			goto out;
+		}
+
+		engine.sockets_num = 1;
+	}
+	else
+	{
+		if (SUCCEED == icmp_socket_open(&engine.sockets[engine.sockets_num], AF_INET, NULL, error,
+				max_error_len))
+		{
+			engine.sockets_num++;
+		}
+#ifdef HAVE_IPV6
+		if (SUCCEED == icmp_socket_open(&engine.sockets[engine.sockets_num], AF_INET6, NULL, error,
+				max_error_len))
+		{
+			engine.sockets_num++;
+		}
+#endif
+		if (0 == engine.sockets_num)
+		{
+			ret = FAIL;
+			goto out;
+		}
+	}
+
+	if (0 == period)
+		period = ICMP_ENGINE_DEFAULT_PERIOD;
+
+	if (0 == size)
+		size = ICMP_ENGINE_DEFAULT_SIZE;
+
+	if (0 == timeout)
+		timeout = MIN(period, ICMP_ENGINE_DEFAULT_TIMEOUT_MAX);
+
+	engine.targets_num = hosts_count;
+	engine.requests_count = requests_count;
+	engine.timeout = timeout / 1000.0;
+	engine.allow_redirect = allow_redirect;
+	engine.id = (unsigned short)getpid();
+	engine.cookie = (zbx_uint32_t)(icmp_time() * 1000000) ^ (zbx_uint32_t)(size_t)&icmp_cookie_seed ^
+			++icmp_cookie_seed;
+
+	engine.packet_size = ICMP_ENGINE_HEADER_SIZE + (size_t)MAX(size, ICMP_ENGINE_DATA_MIN);
+	engine.packet = (unsigned char *)zbx_malloc(NULL, engine.packet_size);
+	memset(engine.packet, 0, engine.packet_size);
+	memcpy(engine.packet + 8, &engine.cookie, sizeof(engine.cookie));
+
+	packets_num = hosts_count * requests_count;
+	engine.sent = (double *)zbx_malloc(NULL, sizeof(double) * (size_t)packets_num);
+	memset(engine.sent, 0, sizeof(double) * (size_t)packets_num);
+	engine.received = (char *)zbx_malloc(NULL, (size_t)packets_num);
+	memset(engine.received, 0, (size_t)packets_num);
+
+	engine.targets = (icmp_target_t *)zbx_malloc(NULL, sizeof(icmp_target_t) * (size_t)hosts_count);
+
+	for (i = 0; i < hosts_count; i++)
+	{
+		engine.targets[i].host = &hosts[i];
+		icmp_target_resolve(&engine, &engine.targets[i]);
+	}
+
+	for (i = 0; i < engine.sockets_num; i++)
+		pfds[i].fd = engine.sockets[i].fd;
+
+	buf = (unsigned char *)zbx_malloc(NULL, ICMP_ENGINE_PACKET_MAX);
+
+	period_sec = period / 1000.0;
+	start = icmp_time();
+
+	for (;;)
+	{
+		double	now = icmp_time(), wait_until;
+		int	blocked = 0, poll_timeout, rc;
+
+		while (round < requests_count && now >= start + round * period_sec)
+		{
+			for (; next < hosts_count; next++)
+			{
+				if (NULL == engine.targets[next].sock)
+					continue;
+
+				if (SUCCEED != icmp_packet_send(&engine, next * requests_count + round))
+				{
+					blocked = 1;
+					break;
+				}
+
+				/* read replies between send batches so they do not overflow socket receive buffers */
+				if (0 == engine.sent_num % ICMP_ENGINE_SEND_BATCH)
+				{
+					for (i = 0; i < engine.sockets_num; i++)
+						icmp_packets_recv(&engine, &engine.sockets[i], buf);
+				}
+			}
+
+			if (0 != blocked)
+				break;
+
+			round++;
+			next = 0;
+		}
+
+		if (round == requests_count)
+		{
+			if (engine.received_num == engine.sent_num || now >= engine.last_sent + engine.timeout)
+				break;
+
+			wait_until = engine.last_sent + engine.timeout;
+		}
+		else
+			wait_until = start + round * period_sec;
+
+		for (i = 0; i < engine.sockets_num; i++)
+		{
+			pfds[i].events = POLLIN;
+			pfds[i].revents = 0;
+
+			/* kernel may report full send buffer without waking up writers, so retry soon anyway */
+			if (0 != blocked)
+			{
+				pfds[i].events |= POLLOUT;
+				wait_until = MIN(wait_until, now + 0.001);
+			}
+		}
+
+		poll_timeout = wait_until > now ? (int)ceil((wait_until - now) * 1000) : 0;
+
+		if (-1 == (rc = zbx_socket_poll(pfds, (unsigned long)engine.sockets_num, poll_timeout)))
+		{
+			if (EINTR == errno)
+				continue;
+
+			zbx_snprintf(error, max_error_len, "cannot wait for ICMP packets: %s", zbx_strerror(errno));
+			goto clean;
+		}
+
+		if (0 == rc)
+			continue;
+
+		for (i = 0; i < engine.sockets_num; i++)
+		{
+			if (0 != (pfds[i].revents & POLLIN))
+				icmp_packets_recv(&engine, &engine.sockets[i], buf);
+		}
+	}
+
+	for (i = 0; i < hosts_count; i++)
+	{
+		if (NULL != engine.targets[i].sock)
+			hosts[i].cnt += requests_count;
+	}
+
+	if (0 != rdns)
+		icmp_targets_resolve_dnsname(&engine);
+
+	ret = SUCCEED;
+clean:
+	zbx_free(buf);
+	zbx_free(engine.targets);
+	zbx_free(engine.received);
+	zbx_free(engine.sent);
+	zbx_free(engine.packet);
+out:
+	for (i = 0; i < engine.sockets_num; i++)
+		close(engine.sockets[i].fd);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s sent:%d received:%d", __func__, zbx_result_string(ret),
+			engine.sent_num, engine.received_num);
+
+	return ret;
+}
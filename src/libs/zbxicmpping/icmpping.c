@@ -18,6 +18,7 @@
 **/
 
 #include "zbxicmpping.h"
+#include "icmpengine.h"
 
 #include <signal.h>
 
@@ -823,6 +824,15 @@ static int	hosts_ping(ZBX_FPING_HOST *hosts, int hosts_count, int requests_count
 
 #undef FPING_CHECK_EXPIRED
 
+	if (FAIL != (ret = icmp_engine_ping(hosts, hosts_count, requests_count, interval, size, timeout, allow_redirect,
+			rdns, config_icmpping->get_source_ip(), error, max_error_len)))
+	{
+		goto out;
+	}
+
+	zabbix_log(LOG_LEVEL_DEBUG, "cannot use ICMP sockets, falling back to fping: %s", error);
+	ret = NOTSUPPORTED;
+
 	linebuf_size = (size_t)(MAX_STRING_LEN + requests_count * response_time_chars_max);
 	linebuf = zbx_malloc(linebuf, linebuf_size);
 
@@ -1202,7 +1212,11 @@ void	zbx_init_icmpping_env(const char *prefix, long int id)
  * Return value: SUCCEED - successfully processed hosts                       *
  *               NOTSUPPORTED - otherwise                                     *
  *                                                                            *
- * Comments: use external binary 'fping' to avoid superuser privileges        *
+ * Comments: ICMP sockets are used when they can be opened - datagram ICMP    *
+ *           sockets are available to unprivileged users allowed by system    *
+ *           configuration (net.ipv4.ping_group_range on Linux), raw sockets  *
+ *           require superuser privileges. Otherwise external binary 'fping'  *
+ *           is used to avoid superuser privileges.                           *
  *                                                                            *
  ******************************************************************************/
 int	zbx_ping(ZBX_FPING_HOST *hosts, int hosts_count, int requests_count, int period, int size, int timeout,
@@ -7,6 +7,8 @@
 #	include <event2/thread.h>
 #endif
 
+#include <sys/uio.h>
+
 #include "zbxipcservice.h"
 #include "zbxalgo.h"
 #include "zbxstr.h"
@@ -15,6 +17,10 @@
 
 #define ZBX_IPC_DATA_DUMP_SIZE		128
 
+/* the maximum number of queued messages and their total size to send with single writev() call */
+#define ZBX_IPC_WRITEV_MESSAGES_MAX	32
+#define ZBX_IPC_WRITEV_SIZE_MAX		ZBX_MEBIBYTE
+
 static char	ipc_path[ZBX_IPC_PATH_MAX] = {0};
 static size_t	ipc_path_root_len = 0;
 
@@ -146,12 +152,13 @@ static const char	*ipc_make_path(const char *service_name, char **error)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: writes data to a socket                                           *
+ * Purpose: writes data from multiple buffers to a socket                     *
  *                                                                            *
  * Parameters: fd        - [IN] the socket file descriptor                    *
- *             data      - [IN] the data                                      *
- *             size      - [IN] the data size                                 *
- *             size_sent - [IN] the actual size written to socket             *
+ *             iov       - [IN/OUT] the data buffers, modified in the case of *
+ *                                  partial writes                            *
+ *             iov_num   - [IN] the number of data buffers                    *
+ *             size_sent - [OUT] the actual size written to socket            *
  *                                                                            *
  * Return value: SUCCEED - no socket errors were detected. Either the data or *
  *                         a part of it was written to socket or a write to   *
@@ -159,15 +166,15 @@ static const char	*ipc_make_path(const char *service_name, char **error)
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_write_data(int fd, const unsigned char *data, zbx_uint32_t size, zbx_uint32_t *size_sent)
+static int	ipc_writev_data(int fd, struct iovec *iov, int iov_num, zbx_uint32_t *size_sent)
 {
 	zbx_uint32_t	offset = 0;
 	int		ret = SUCCEED;
 	ssize_t		n;
 
-	while (offset != size)
+	while (0 != iov_num)
 	{
-		n = write(fd, data + offset, size - offset);
+		n = writev(fd, iov, iov_num);
 
 		if (-1 == n)
 		{
@@ -182,7 +189,21 @@ static int	ipc_write_data(int fd, const unsigned char *data, zbx_uint32_t size,
 			break;
 		}
 
-		offset += n;
+		offset += (zbx_uint32_t)n;
+
+		/* skip the written buffers and adjust the partially written one */
+		while (0 != iov_num && (size_t)n >= iov->iov_len)
+		{
+			n -= (ssize_t)iov->iov_len;
+			iov++;
+			iov_num--;
+		}
+
+		if (0 != n)
+		{
+			iov->iov_base = (unsigned char *)iov->iov_base + n;
+			iov->iov_len -= (size_t)n;
+		}
 	}
 
 	*size_sent = offset;
@@ -233,44 +254,43 @@ static int	ipc_read_data(int fd, unsigned char *buffer, zbx_uint32_t size, zbx_u
 
 /******************************************************************************
  *                                                                            *
- * Purpose: reads data from a socket until the requested data has been read   *
+ * Purpose: reads data from a socket into multiple buffers                    *
  *                                                                            *
  * Parameters: fd        - [IN] the socket file descriptor                    *
- *             buffer    - [IN] the data                                      *
- *             size      - [IN] the data size                                 *
- *             read_size - [IN] the actual size read from socket              *
+ *             iov       - [IN] the data buffers                              *
+ *             iov_num   - [IN] the number of data buffers                    *
+ *             read_size - [OUT] the actual size read from socket             *
  *                                                                            *
  * Return value: SUCCEED - the data was successfully read                     *
  *               FAIL    - otherwise                                          *
  *                                                                            *
- * Comments: When reading data from non-blocking sockets this function will   *
- *           return SUCCEED if there are no data to read, even if not all of  *
- *           the requested data has been read.                                *
+ * Comments: When reading data from non-blocking sockets SUCCEED will be      *
+ *           returned also if there were no more data to read.                *
  *                                                                            *
  ******************************************************************************/
-static int	ipc_read_data_full(int fd, unsigned char *buffer, zbx_uint32_t size, zbx_uint32_t *read_size)
+static int	ipc_readv_data(int fd, const struct iovec *iov, int iov_num, zbx_uint32_t *read_size)
 {
-	int		ret = FAIL;
-	zbx_uint32_t	offset = 0, chunk_size;
+	ssize_t	n;
 
 	*read_size = 0;
 
-	while (offset < size)
+	while (-1 == (n = readv(fd, iov, iov_num)))
 	{
-		if (FAIL == ipc_read_data(fd, buffer + offset, size - offset, &chunk_size))
-			goto out;
+		if (EINTR == errno)
+			continue;
 
-		if (0 == chunk_size)
-			break;
+		if (EWOULDBLOCK == errno || EAGAIN == errno)
+			return SUCCEED;
 
-		offset += chunk_size;
+		return FAIL;
 	}
 
-	ret = SUCCEED;
-out:
-	*read_size = offset;
+	if (0 == n)
+		return FAIL;
 
-	return ret;
+	*read_size = (zbx_uint32_t)n;
+
+	return SUCCEED;
 }
 
 /******************************************************************************
@@ -296,31 +316,25 @@ out:
 static int	ipc_socket_write_message(zbx_ipc_socket_t *csocket, zbx_uint32_t code, const unsigned char *data,
 		zbx_uint32_t size, zbx_uint32_t *tx_size)
 {
-	int		ret;
-	zbx_uint32_t	size_data, buffer[ZBX_IPC_SOCKET_BUFFER_SIZE / sizeof(zbx_uint32_t)];
+	zbx_uint32_t	header[2];
+	struct iovec	iov[2];
+	int		iov_num = 1;
 
-	buffer[0] = code;
-	buffer[1] = size;
+	header[ZBX_IPC_MESSAGE_CODE] = code;
+	header[ZBX_IPC_MESSAGE_SIZE] = size;
 
-	if (ZBX_IPC_SOCKET_BUFFER_SIZE - ZBX_IPC_HEADER_SIZE >= size)
-	{
-		if (0 != size)
-			memcpy(buffer + 2, data, size);
+	/* header and data are gathered by kernel, avoiding copying data into intermediate buffer */
+	iov[0].iov_base = header;
+	iov[0].iov_len = ZBX_IPC_HEADER_SIZE;
 
-		return ipc_write_data(csocket->fd, (unsigned char *)buffer, size + ZBX_IPC_HEADER_SIZE, tx_size);
+	if (0 != size)
+	{
+		iov[1].iov_base = (void *)data;
+		iov[1].iov_len = size;
+		iov_num++;
 	}
 
-	if (FAIL == ipc_write_data(csocket->fd, (unsigned char *)buffer, ZBX_IPC_HEADER_SIZE, tx_size))
-		return FAIL;
-
-	/* in the case of non-blocking sockets only a part of the header might be sent */
-	if (ZBX_IPC_HEADER_SIZE != *tx_size)
-		return SUCCEED;
-
-	ret = ipc_write_data(csocket->fd, data, size, &size_data);
-	*tx_size += size_data;
-
-	return ret;
+	return ipc_writev_data(csocket->fd, iov, iov_num, tx_size);
 }
 
 /******************************************************************************
@@ -448,12 +462,38 @@ static int	ipc_socket_read_message(zbx_ipc_socket_t *csocket, zbx_uint32_t *head
 			offset = *rx_bytes - ZBX_IPC_HEADER_SIZE;
 			data_size = header[ZBX_IPC_MESSAGE_SIZE] - offset;
 
-			/* long messages will be read directly into message buffer */
+			/* Long messages will be read directly into message buffer. The following messages */
+			/* are read into socket buffer with the same call.                                  */
 			if (ZBX_IPC_SOCKET_BUFFER_SIZE * 0.75 < data_size)
 			{
-				ret = ipc_read_data_full(csocket->fd, *data + offset, data_size, &read_size);
+				struct iovec	iov[2];
+
+				iov[0].iov_base = *data + offset;
+				iov[0].iov_len = data_size;
+				iov[1].iov_base = csocket->rx_buffer;
+				iov[1].iov_len = ZBX_IPC_SOCKET_BUFFER_SIZE;
+
+				if (FAIL == ipc_readv_data(csocket->fd, iov, 2, &read_size))
+					goto out;
+
+				if (0 == read_size)
+				{
+					ret = SUCCEED;
+					goto out;
+				}
+
+				if (read_size > data_size)
+				{
+					csocket->rx_buffer_bytes = read_size - data_size;
+					read_size = data_size;
+				}
+
 				*rx_bytes += read_size;
-				goto out;
+
+				if (read_size == data_size)
+					ret = SUCCEED;
+
+				continue;
 			}
 		}
 
@@ -624,46 +664,86 @@ static int	ipc_client_read(zbx_ipc_client_t *client)
  ******************************************************************************/
 static int	ipc_client_write(zbx_ipc_client_t *client)
 {
-	zbx_uint32_t	data_size, write_size;
-
-	data_size = client->tx_header[ZBX_IPC_MESSAGE_SIZE];
+	struct iovec		iov[(ZBX_IPC_WRITEV_MESSAGES_MAX + 1) * 2];
+	zbx_uint32_t		headers[ZBX_IPC_WRITEV_MESSAGES_MAX][2], data_size, write_size, size_left;
+	zbx_uint64_t		batch_size;
+	zbx_ipc_message_t	*message;
+	int			iov_num, pos, messages_num;
 
-	if (data_size < client->tx_bytes)
+	while (0 != client->tx_bytes)
 	{
-		zbx_uint32_t	size, offset;
+		/* add the unsent part of the current message */
+		data_size = client->tx_header[ZBX_IPC_MESSAGE_SIZE];
+		iov_num = 0;
 
-		size = client->tx_bytes - data_size;
-		offset = ZBX_IPC_HEADER_SIZE - size;
+		if (data_size < client->tx_bytes)
+		{
+			zbx_uint32_t	size = client->tx_bytes - data_size;
 
-		if (SUCCEED != ipc_write_data(client->csocket.fd, (unsigned char *)client->tx_header + offset, size,
-				&write_size))
+			iov[iov_num].iov_base = (unsigned char *)client->tx_header + ZBX_IPC_HEADER_SIZE - size;
+			iov[iov_num++].iov_len = size;
+
+			if (0 != data_size)
+			{
+				iov[iov_num].iov_base = client->tx_data;
+				iov[iov_num++].iov_len = data_size;
+			}
+		}
+		else
 		{
-			return FAIL;
+			iov[iov_num].iov_base = client->tx_data + data_size - client->tx_bytes;
+			iov[iov_num++].iov_len = client->tx_bytes;
 		}
 
-		client->tx_bytes -= write_size;
-
-		if (data_size < client->tx_bytes)
-			return SUCCEED;
-	}
+		batch_size = client->tx_bytes;
 
-	while (0 < client->tx_bytes)
-	{
-		if (SUCCEED != ipc_write_data(client->csocket.fd, client->tx_data + data_size - client->tx_bytes,
-				client->tx_bytes, &write_size))
+		/* add the queued messages */
+		for (pos = client->tx_queue.tail_pos, messages_num = 0; pos != client->tx_queue.head_pos &&
+				ZBX_IPC_WRITEV_MESSAGES_MAX > messages_num; messages_num++)
 		{
+			message = (zbx_ipc_message_t *)client->tx_queue.values[pos];
+
+			if (ZBX_IPC_WRITEV_SIZE_MAX < batch_size + ZBX_IPC_HEADER_SIZE + message->size)
+				break;
+
+			headers[messages_num][ZBX_IPC_MESSAGE_CODE] = message->code;
+			headers[messages_num][ZBX_IPC_MESSAGE_SIZE] = message->size;
+
+			iov[iov_num].iov_base = headers[messages_num];
+			iov[iov_num++].iov_len = ZBX_IPC_HEADER_SIZE;
+
+			if (0 != message->size)
+			{
+				iov[iov_num].iov_base = message->data;
+				iov[iov_num++].iov_len = message->size;
+			}
+
+			batch_size += ZBX_IPC_HEADER_SIZE + message->size;
+
+			if (++pos == client->tx_queue.alloc_num)
+				pos = 0;
+		}
+
+		if (SUCCEED != ipc_writev_data(client->csocket.fd, iov, iov_num, &write_size))
 			return FAIL;
+
+		/* advance the current message over the written data, taking next messages from queue */
+		for (size_left = write_size; 0 != size_left;)
+		{
+			zbx_uint32_t	size = MIN(size_left, client->tx_bytes);
+
+			client->tx_bytes -= size;
+			size_left -= size;
+
+			if (0 == client->tx_bytes)
+				ipc_client_pop_tx_message(client);
 		}
 
-		if (0 == write_size)
+		/* socket buffer is full */
+		if (write_size != batch_size)
 			return SUCCEED;
-
-		client->tx_bytes -= write_size;
 	}
 
-	if (0 == client->tx_bytes)
-		ipc_client_pop_tx_message(client);
-
 	return SUCCEED;
 }
 
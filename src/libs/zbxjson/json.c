@@ -23,6 +23,12 @@
 #include "json_parser.h"
 #include "jsonpath.h"
 
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#elif defined(__SSE2__)
+#	include <emmintrin.h>
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: return string describing json error                               *
@@ -538,6 +544,376 @@ static zbx_json_type_t	__zbx_json_type(const char *p)
 	return ZBX_JSON_TYPE_UNKNOWN;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Structural index of JSON buffer. It lists positions of brackets and commas *
+ * outside strings, matching brackets refer to each other. For every block of *
+ * JSON_INDEX_BLOCK_SIZE bytes the index of its first token is stored, so the *
+ * token at the specified position can be found without scanning the text.    *
+ *                                                                            *
+ ******************************************************************************/
+
+#define JSON_INDEX_BLOCK_SIZE	64
+#define JSON_INDEX_NONE		0xffffffff
+
+typedef struct
+{
+	/* offset of the character from the buffer start */
+	zbx_uint32_t	offset;
+
+	/* matching bracket token index for brackets */
+	zbx_uint32_t	pair;
+}
+json_token_t;
+
+typedef struct
+{
+	const char	*start;
+	const char	*end;
+	json_token_t	*tokens;
+	zbx_uint32_t	tokens_num;
+	zbx_uint32_t	tokens_alloc;
+
+	/* index of the first token in each block */
+	zbx_uint32_t	*blocks;
+}
+json_index_t;
+
+static ZBX_THREAD_LOCAL json_index_t	json_index;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get mask of quotes, backslashes, brackets and commas in block     *
+ *                                                                            *
+ * Parameters: block - [IN] JSON_INDEX_BLOCK_SIZE bytes of text               *
+ *                                                                            *
+ * Return value: mask with bits set for positions of the found characters     *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint64_t	json_index_classify(const unsigned char *block)
+{
+	zbx_uint64_t	mask = 0;
+	int		i;
+#if defined(__AVX2__)
+	const __m256i	quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'),
+			comma = _mm256_set1_epi8(','), lbracket = _mm256_set1_epi8('{'),
+			rbracket = _mm256_set1_epi8('}'), lower = _mm256_set1_epi8(0x20);
+
+	for (i = 0; i < JSON_INDEX_BLOCK_SIZE; i += 32)
+	{
+		__m256i	chunk, folded, hits;
+
+		chunk = _mm256_loadu_si256((const __m256i *)(block + i));
+
+		/* '[' and ']' differ from '{' and '}' only by 0x20 bit */
+		folded = _mm256_or_si256(chunk, lower);
+
+		hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+		hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, comma));
+		hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(folded, lbracket));
+		hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(folded, rbracket));
+
+		mask |= (zbx_uint64_t)(zbx_uint32_t)_mm256_movemask_epi8(hits) << i;
+	}
+#elif defined(__SSE2__)
+	const __m128i	quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), comma = _mm_set1_epi8(','),
+			lbracket = _mm_set1_epi8('{'), rbracket = _mm_set1_epi8('}'), lower = _mm_set1_epi8(0x20);
+
+	for (i = 0; i < JSON_INDEX_BLOCK_SIZE; i += 16)
+	{
+		__m128i	chunk, folded, hits;
+
+		chunk = _mm_loadu_si128((const __m128i *)(block + i));
+
+		/* '[' and ']' differ from '{' and '}' only by 0x20 bit */
+		folded = _mm_or_si128(chunk, lower);
+
+		hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, comma));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(folded, lbracket));
+		hits = _mm_or_si128(hits, _mm_cmpeq_epi8(folded, rbracket));
+
+		mask |= (zbx_uint64_t)(zbx_uint32_t)_mm_movemask_epi8(hits) << i;
+	}
+#else
+	for (i = 0; i < JSON_INDEX_BLOCK_SIZE; i++)
+	{
+		switch (block[i])
+		{
+			case '"':
+			case '\\':
+			case ',':
+			case '[':
+			case ']':
+			case '{':
+			case '}':
+				mask |= (zbx_uint64_t)1 << i;
+				break;
+		}
+	}
+#endif
+	return mask;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get position of the lowest set bit                                *
+ *                                                                            *
+ ******************************************************************************/
+static int	json_index_lowest_bit(zbx_uint64_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(mask);
+#else
+	int	bit = 0;
+
+	while (0 == (mask & 1))
+	{
+		mask >>= 1;
+		bit++;
+	}
+
+	return bit;
+#endif
+}
+
+static void	json_index_add_token(zbx_uint32_t offset, zbx_uint32_t pair)
+{
+	if (json_index.tokens_num == json_index.tokens_alloc)
+	{
+		json_index.tokens_alloc += json_index.tokens_alloc / 2;
+		json_index.tokens = (json_token_t *)zbx_realloc(json_index.tokens,
+				json_index.tokens_alloc * sizeof(json_token_t));
+	}
+
+	json_index.tokens[json_index.tokens_num].offset = offset;
+	json_index.tokens[json_index.tokens_num++].pair = pair;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: build structural index for JSON buffer                            *
+ *                                                                            *
+ * Parameters: jp - [IN] the JSON buffer opened with zbx_json_open()          *
+ *                                                                            *
+ * Comments: While the index is open zbx_json_next(), zbx_json_pair_by_name() *
+ *           and other navigation functions locate siblings and closing       *
+ *           brackets inside the buffer with index lookups instead of         *
+ *           scanning the text. It pays off for large buffers with many       *
+ *           lookups, like proxy data or low-level discovery values.          *
+ *                                                                            *
+ *           There is one index per thread, opening a new index closes the    *
+ *           previous one. The buffer must not be changed or freed until      *
+ *           the index is closed.                                             *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_json_index_open(const struct zbx_json_parse *jp)
+{
+	size_t		size, blocks_num, block, escaped;
+	zbx_uint32_t	open = JSON_INDEX_NONE;
+	int		state = 0;	/* 0 - outside string; 1 - inside string */
+
+	zbx_json_index_close();
+
+	size = (size_t)(jp->end - jp->start) + 1;
+
+	if (JSON_INDEX_NONE <= size)
+		return;
+
+	blocks_num = (size + JSON_INDEX_BLOCK_SIZE - 1) / JSON_INDEX_BLOCK_SIZE;
+	json_index.blocks = (zbx_uint32_t *)zbx_malloc(NULL, (blocks_num + 1) * sizeof(zbx_uint32_t));
+
+	json_index.tokens_alloc = size / 16 + 16;
+	json_index.tokens = (json_token_t *)zbx_malloc(NULL, json_index.tokens_alloc * sizeof(json_token_t));
+
+	/* offset of the character following backslash inside string */
+	escaped = size;
+
+	for (block = 0; block < blocks_num; block++)
+	{
+		const unsigned char	*ptr = (const unsigned char *)jp->start + block * JSON_INDEX_BLOCK_SIZE;
+		unsigned char		tail[JSON_INDEX_BLOCK_SIZE];
+		size_t			left = size - block * JSON_INDEX_BLOCK_SIZE;
+		zbx_uint64_t		mask;
+
+		json_index.blocks[block] = json_index.tokens_num;
+
+		/* do not read past the end of buffer */
+		if (JSON_INDEX_BLOCK_SIZE > left)
+		{
+			memcpy(tail, ptr, left);
+			memset(tail + left, ' ', JSON_INDEX_BLOCK_SIZE - left);
+			ptr = tail;
+		}
+
+		for (mask = json_index_classify(ptr); 0 != mask; mask &= mask - 1)
+		{
+			size_t		offset;
+			zbx_uint32_t	pair;
+
+			offset = block * JSON_INDEX_BLOCK_SIZE + (size_t)json_index_lowest_bit(mask);
+
+			if (offset == escaped)
+				continue;
+
+			if ('"' == jp->start[offset])
+			{
+				state = (0 == state ? 1 : 0);
+				continue;
+			}
+
+			if (1 == state)
+			{
+				if ('\\' == jp->start[offset])
+					escaped = offset + 1;
+				continue;
+			}
+
+			switch (jp->start[offset])
+			{
+				case '[':
+				case '{':
+					/* until closed, bracket refers to the enclosing bracket */
+					json_index_add_token((zbx_uint32_t)offset, open);
+					open = json_index.tokens_num - 1;
+					break;
+				case ']':
+				case '}':
+					if (JSON_INDEX_NONE == open)
+						goto fail;
+
+					pair = open;
+					open = json_index.tokens[pair].pair;
+					json_index.tokens[pair].pair = json_index.tokens_num;
+					json_index_add_token((zbx_uint32_t)offset, pair);
+					break;
+				case ',':
+					json_index_add_token((zbx_uint32_t)offset, JSON_INDEX_NONE);
+					break;
+			}
+		}
+	}
+
+	if (JSON_INDEX_NONE != open || 0 != state)
+		goto fail;
+
+	json_index.blocks[blocks_num] = json_index.tokens_num;
+	json_index.start = jp->start;
+	json_index.end = jp->end;
+
+	return;
+fail:
+	zbx_json_index_close();
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: free structural index of JSON buffer                              *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_json_index_close(void)
+{
+	zbx_free(json_index.tokens);
+	zbx_free(json_index.blocks);
+	memset(&json_index, 0, sizeof(json_index));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find the first token at or after the specified position           *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_uint32_t	json_index_find(const char *p)
+{
+	zbx_uint32_t	offset, i;
+
+	offset = (zbx_uint32_t)(p - json_index.start);
+	i = json_index.blocks[offset / JSON_INDEX_BLOCK_SIZE];
+
+	while (i < json_index.tokens_num && json_index.tokens[i].offset < offset)
+		i++;
+
+	return i;
+}
+
+static int	json_index_contains(const char *start, const char *end)
+{
+	if (NULL == json_index.start || start < json_index.start || end > json_index.end)
+		return FAIL;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: find the matching bracket using structural index                  *
+ *                                                                            *
+ * Return value: position of the matching bracket or NULL if the specified    *
+ *               position is not indexed                                      *
+ *                                                                            *
+ ******************************************************************************/
+static const char	*json_index_rbracket(const char *p)
+{
+	zbx_uint32_t	i;
+
+	if (SUCCEED != json_index_contains(p, p))
+		return NULL;
+
+	i = json_index_find(p);
+
+	if (i == json_index.tokens_num || json_index.start + json_index.tokens[i].offset != p)
+		return NULL;
+
+	return json_index.start + json_index.tokens[json_index.tokens[i].pair].offset;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: locate next pair or element using structural index                *
+ *                                                                            *
+ * Parameters: jp   - [IN] the JSON object or array                           *
+ *             p    - [IN] the current pair or element                        *
+ *             next - [OUT] the next pair or element, NULL if none            *
+ *                                                                            *
+ * Return value: SUCCEED - the next pair or element was located               *
+ *               FAIL    - the object is not indexed                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	json_index_next(const struct zbx_json_parse *jp, const char *p, const char **next)
+{
+	zbx_uint32_t	i, end;
+
+	if (SUCCEED != json_index_contains(jp->start, jp->end) || p < jp->start || p > jp->end)
+		return FAIL;
+
+	end = (zbx_uint32_t)(jp->end - json_index.start);
+
+	for (i = json_index_find(p); i < json_index.tokens_num && json_index.tokens[i].offset <= end;)
+	{
+		const char	*token = json_index.start + json_index.tokens[i].offset;
+
+		switch (*token)
+		{
+			case '[':
+			case '{':
+				i = json_index.tokens[i].pair + 1;
+				break;
+			case ',':
+				token++;
+				SKIP_WHITESPACE(token);
+				*next = token;
+				return SUCCEED;
+			default:
+				*next = NULL;
+				return SUCCEED;
+		}
+	}
+
+	*next = NULL;
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Return value: position of the right bracket                                *
@@ -548,7 +924,8 @@ static const char	*__zbx_json_rbracket(const char *p)
 {
 	int	level = 0;
 	int	state = 0; /* 0 - outside string; 1 - inside string */
-	char	lbracket, rbracket;
+	char		lbracket, rbracket;
+	const char	*end;
 
 	assert(p);
 
@@ -559,6 +936,9 @@ static const char	*__zbx_json_rbracket(const char *p)
 
 	rbracket = ('{' == lbracket ? '}' : ']');
 
+	if (NULL != (end = json_index_rbracket(p)))
+		return (rbracket == *end ? end : NULL);
+
 	while ('\0' != *p)
 	{
 		switch (*p)
@@ -646,8 +1026,9 @@ int	zbx_json_open(const char *buffer, struct zbx_json_parse *jp)
  ******************************************************************************/
 const char	*zbx_json_next(const struct zbx_json_parse *jp, const char *p)
 {
-	int	level = 0;
-	int	state = 0;	/* 0 - outside string; 1 - inside string */
+	int		level = 0;
+	int		state = 0;	/* 0 - outside string; 1 - inside string */
+	const char	*next;
 
 	if (1 == jp->end - jp->start)	/* empty object or array */
 		return NULL;
@@ -659,6 +1040,9 @@ const char	*zbx_json_next(const struct zbx_json_parse *jp, const char *p)
 		return p;
 	}
 
+	if (SUCCEED == json_index_next(jp, p, &next))
+		return next;
+
 	while (p <= jp->end)
 	{
 		switch (*p)
@@ -78,11 +78,12 @@ int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *
 
 		if (0 != (fields & ZBX_DIAG_PREPROC_SIMPLE))
 		{
-			zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num;
+			zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num, regexp_hits,
+					regexp_misses;
 
 			time1 = zbx_time();
 			if (FAIL == (ret = zbx_preprocessor_get_diag_stats(&preproc_num, &pending_num, &finished_num,
-					&sequences_num, error)))
+					&sequences_num, &regexp_hits, &regexp_misses, error)))
 			{
 				goto out;
 			}
@@ -96,6 +97,8 @@ int	zbx_diag_add_preproc_info(const struct zbx_json_parse *jp, struct zbx_json *
 				zbx_json_adduint64(json, "pending tasks", pending_num);
 				zbx_json_adduint64(json, "finished tasks", finished_num);
 				zbx_json_adduint64(json, "task sequences", sequences_num);
+				zbx_json_adduint64(json, "regexp cache hits", regexp_hits);
+				zbx_json_adduint64(json, "regexp cache misses", regexp_misses);
 			}
 		}
 
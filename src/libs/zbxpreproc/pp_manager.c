@@ -141,7 +141,7 @@ static zbx_pp_manager_t	*zbx_pp_manager_create(int workers_num, zbx_pp_notify_cb
 	manager = (zbx_pp_manager_t *)zbx_malloc(NULL, sizeof(zbx_pp_manager_t));
 	memset(manager, 0, sizeof(zbx_pp_manager_t));
 
-	if (SUCCEED != pp_task_queue_init(&manager->queue, error))
+	if (SUCCEED != pp_task_queue_init(&manager->queue, workers_num, error))
 		goto out;
 
 	manager->timekeeper = zbx_timekeeper_create(workers_num, NULL);
@@ -654,12 +654,28 @@ zbx_hashset_t  *zbx_pp_manager_items(zbx_pp_manager_t *manager)
  *                                                                            *
  ******************************************************************************/
 static void	zbx_pp_manager_get_diag_stats(zbx_pp_manager_t *manager, zbx_uint64_t *preproc_num,
-		zbx_uint64_t *pending_num, zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num)
+		zbx_uint64_t *pending_num, zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num,
+		zbx_uint64_t *regexp_hits, zbx_uint64_t *regexp_misses)
 {
+	int	i;
+
 	*preproc_num = (zbx_uint64_t)manager->items.num_data;
 	*pending_num = manager->queue.pending_num;
 	*finished_num = manager->queue.finished_num;
 	*sequences_num = (zbx_uint64_t)manager->queue.sequences.num_data;
+
+	*regexp_hits = 0;
+	*regexp_misses = 0;
+
+	pp_task_queue_lock(&manager->queue);
+
+	for (i = 0; i < manager->workers_num; i++)
+	{
+		*regexp_hits += manager->workers[i].regexp_hits;
+		*regexp_misses += manager->workers[i].regexp_misses;
+	}
+
+	pp_task_queue_unlock(&manager->queue);
 }
 
 /******************************************************************************
@@ -1015,12 +1031,14 @@ static void	preprocessor_flush_tasks(zbx_pp_manager_t *manager, zbx_vector_pp_ta
  ******************************************************************************/
 static void	preprocessor_reply_diag_info(zbx_pp_manager_t *manager, zbx_ipc_client_t *client)
 {
-	zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num;
+	zbx_uint64_t	preproc_num, pending_num, finished_num, sequences_num, regexp_hits, regexp_misses;
 	unsigned char	*data;
 	zbx_uint32_t	data_len;
 
-	zbx_pp_manager_get_diag_stats(manager, &preproc_num, &pending_num, &finished_num, &sequences_num);
-	data_len = zbx_preprocessor_pack_diag_stats(&data, preproc_num, pending_num, finished_num, sequences_num);
+	zbx_pp_manager_get_diag_stats(manager, &preproc_num, &pending_num, &finished_num, &sequences_num,
+			&regexp_hits, &regexp_misses);
+	data_len = zbx_preprocessor_pack_diag_stats(&data, preproc_num, pending_num, finished_num, sequences_num,
+			regexp_hits, regexp_misses);
 
 	zbx_ipc_client_send(client, ZBX_IPC_PREPROCESSOR_DIAG_STATS_RESULT, data, data_len);
 
@@ -482,10 +482,13 @@ zbx_uint32_t	zbx_preprocessor_pack_test_result(unsigned char **data, const zbx_p
  *                               preprocessed                                 *
  *             finished_num  - [IN] number of values being preprocessed       *
  *             sequences_num - [IN] number of registered task sequences       *
+ *             regexp_hits   - [IN] number of compiled regexp cache hits      *
+ *             regexp_misses - [IN] number of compiled regexp cache misses    *
  *                                                                            *
  ******************************************************************************/
 zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t preproc_num,
-		zbx_uint64_t pending_num, zbx_uint64_t finished_num, zbx_uint64_t sequences_num)
+		zbx_uint64_t pending_num, zbx_uint64_t finished_num, zbx_uint64_t sequences_num,
+		zbx_uint64_t regexp_hits, zbx_uint64_t regexp_misses)
 {
 	unsigned char	*ptr;
 	zbx_uint32_t	data_len = 0;
@@ -494,6 +497,8 @@ zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t
 	zbx_serialize_prepare_value(data_len, pending_num);
 	zbx_serialize_prepare_value(data_len, finished_num);
 	zbx_serialize_prepare_value(data_len, sequences_num);
+	zbx_serialize_prepare_value(data_len, regexp_hits);
+	zbx_serialize_prepare_value(data_len, regexp_misses);
 
 	*data = (unsigned char *)zbx_malloc(NULL, data_len);
 
@@ -501,7 +506,9 @@ zbx_uint32_t	zbx_preprocessor_pack_diag_stats(unsigned char **data, zbx_uint64_t
 	ptr += zbx_serialize_value(ptr, preproc_num);
 	ptr += zbx_serialize_value(ptr, pending_num);
 	ptr += zbx_serialize_value(ptr, finished_num);
-	(void)zbx_serialize_value(ptr, sequences_num);
+	ptr += zbx_serialize_value(ptr, sequences_num);
+	ptr += zbx_serialize_value(ptr, regexp_hits);
+	(void)zbx_serialize_value(ptr, regexp_misses);
 
 	return data_len;
 }
@@ -704,18 +711,23 @@ void	zbx_preprocessor_unpack_test_result(zbx_vector_pp_result_ptr_t *results, zb
  *                               preprocessed                                 *
  *             finished_num  - [OUT] number of values being preprocessed      *
  *             sequences_num - [OUT] number of registered task sequences      *
+ *             regexp_hits   - [OUT] number of compiled regexp cache hits     *
+ *             regexp_misses - [OUT] number of compiled regexp cache misses   *
  *             data          - [OUT] data buffer                              *
  *                                                                            *
  ******************************************************************************/
 void	zbx_preprocessor_unpack_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
-		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, const unsigned char *data)
+		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, zbx_uint64_t *regexp_hits,
+		zbx_uint64_t *regexp_misses, const unsigned char *data)
 {
 	const unsigned char	*offset = data;
 
 	offset += zbx_deserialize_value(offset, preproc_num);
 	offset += zbx_deserialize_value(offset, pending_num);
 	offset += zbx_deserialize_value(offset, finished_num);
-	(void)zbx_deserialize_value(offset, sequences_num);
+	offset += zbx_deserialize_value(offset, sequences_num);
+	offset += zbx_deserialize_value(offset, regexp_hits);
+	(void)zbx_deserialize_value(offset, regexp_misses);
 }
 
 /******************************************************************************
@@ -1061,7 +1073,8 @@ out:
  *                                                                            *
  ******************************************************************************/
 int	zbx_preprocessor_get_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pending_num,
-		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, char **error)
+		zbx_uint64_t *finished_num, zbx_uint64_t *sequences_num, zbx_uint64_t *regexp_hits,
+		zbx_uint64_t *regexp_misses, char **error)
 {
 	unsigned char	*result;
 
@@ -1071,7 +1084,8 @@ int	zbx_preprocessor_get_diag_stats(zbx_uint64_t *preproc_num, zbx_uint64_t *pen
 		return FAIL;
 	}
 
-	zbx_preprocessor_unpack_diag_stats(preproc_num, pending_num, finished_num, sequences_num, result);
+	zbx_preprocessor_unpack_diag_stats(preproc_num, pending_num, finished_num, sequences_num, regexp_hits,
+			regexp_misses, result);
 	zbx_free(result);
 
 	return SUCCEED;
@@ -36,18 +36,131 @@ typedef struct
 }
 zbx_pp_item_task_sequence_t;
 
+#ifdef HAVE_ATOMIC_BUILTINS
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize task ring                                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_task_ring_init(zbx_pp_task_ring_t *ring)
+{
+	zbx_uint64_t	i;
+
+	for (i = 0; i < PP_TASK_RING_SIZE; i++)
+	{
+		ring->slots[i].sequence = i;
+		ring->slots[i].task = NULL;
+	}
+
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: push task into task ring                                          *
+ *                                                                            *
+ * Parameters: ring - [IN] task ring                                          *
+ *             task - [IN] task to push                                       *
+ *                                                                            *
+ * Return value: SUCCEED - the task was pushed                                *
+ *               FAIL    - the ring is full                                   *
+ *                                                                            *
+ * Comments: Bounded queue where each slot sequence number tells if the slot  *
+ *           is ready for writing (sequence == position) or reading           *
+ *           (sequence == position + 1).                                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	pp_task_ring_push(zbx_pp_task_ring_t *ring, zbx_pp_task_t *task)
+{
+	zbx_pp_task_ring_slot_t	*slot;
+	zbx_uint64_t		pos, seq;
+	zbx_int64_t		diff;
+
+	pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+	for (;;)
+	{
+		slot = &ring->slots[pos & (PP_TASK_RING_SIZE - 1)];
+		seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+		if (0 == (diff = (zbx_int64_t)(seq - pos)))
+		{
+			if (0 != __atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if (0 > diff)
+			return FAIL;
+		else
+			pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+	}
+
+	slot->task = task;
+	__atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pop task from task ring                                           *
+ *                                                                            *
+ * Parameters: ring - [IN] task ring                                          *
+ *                                                                            *
+ * Return value: The popped task or NULL if the ring is empty.                *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_pp_task_t	*pp_task_ring_pop(zbx_pp_task_ring_t *ring)
+{
+	zbx_pp_task_ring_slot_t	*slot;
+	zbx_pp_task_t		*task;
+	zbx_uint64_t		pos, seq;
+	zbx_int64_t		diff;
+
+	pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+	for (;;)
+	{
+		slot = &ring->slots[pos & (PP_TASK_RING_SIZE - 1)];
+		seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+		if (0 == (diff = (zbx_int64_t)(seq - (pos + 1))))
+		{
+			if (0 != __atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if (0 > diff)
+			return NULL;
+		else
+			pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	}
+
+	task = slot->task;
+	__atomic_store_n(&slot->sequence, pos + PP_TASK_RING_SIZE, __ATOMIC_RELEASE);
+
+	return task;
+}
+#endif
+
 /******************************************************************************
  *                                                                            *
  * Purpose: initialize task queue                                             *
  *                                                                            *
- * Parameters: queue - [IN] task queue                                        *
- *             error - [OUT]                                                  *
+ * Parameters: queue       - [IN] task queue                                  *
+ *             workers_num - [IN] number of workers to create task rings for  *
+ *             error       - [OUT]                                            *
  *                                                                            *
  * Return value: SUCCEED - the task queue was initialized successfully        *
  *               FAIL    - otherwise                                          *
  *                                                                            *
  ******************************************************************************/
-int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error)
+int	pp_task_queue_init(zbx_pp_queue_t *queue, int workers_num, char **error)
 {
 	int	err, ret = FAIL;
 
@@ -59,6 +172,18 @@ int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error)
 	zbx_list_create(&queue->immediate);
 	zbx_list_create(&queue->finished);
 
+#ifdef HAVE_ATOMIC_BUILTINS
+	queue->rings_num = workers_num;
+	queue->rings = (zbx_pp_task_ring_t *)zbx_malloc(NULL, sizeof(zbx_pp_task_ring_t) * (size_t)workers_num);
+
+	for (int i = 0; i < workers_num; i++)
+		pp_task_ring_init(&queue->rings[i]);
+#else
+	ZBX_UNUSED(workers_num);
+	queue->rings_num = 0;
+	queue->rings = NULL;
+#endif
+
 	zbx_hashset_create(&queue->sequences, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
 
 	if (0 != (err = pthread_mutex_init(&queue->lock, NULL)))
@@ -118,6 +243,18 @@ void	pp_task_queue_destroy(zbx_pp_queue_t *queue)
 	pp_task_queue_clear_tasks(&queue->finished);
 	zbx_list_destroy(&queue->finished);
 
+#ifdef HAVE_ATOMIC_BUILTINS
+	for (int i = 0; i < queue->rings_num; i++)
+	{
+		zbx_pp_task_t	*task;
+
+		while (NULL != (task = pp_task_ring_pop(&queue->rings[i])))
+			pp_task_free(task);
+	}
+#endif
+	zbx_free(queue->rings);
+	queue->rings_num = 0;
+
 	zbx_hashset_destroy(&queue->sequences);
 
 	queue->init_flags = PP_TASK_QUEUE_INIT_NONE;
@@ -292,19 +429,18 @@ void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task)
 
 /******************************************************************************
  *                                                                            *
- * Purpose: pop task from task queue                                          *
+ * Purpose: pop task from shared task lists                                   *
  *                                                                            *
  * Parameters: queue - [IN] task queue                                        *
  *                                                                            *
  * Return value: The popped task or NULL if there are no tasks to be          *
  *               processed.                                                   *
  *                                                                            *
- * Comments: This function is used by workers to pop tasks for processing.    *
- *           Sequence tasks will be moved to existing tasks sequences or      *
+ * Comments: Sequence tasks will be moved to existing tasks sequences or      *
  *           returned if there are no registered sequences for this item.     *
  *                                                                            *
  ******************************************************************************/
-zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue)
+static zbx_pp_task_t	*pp_task_queue_pop_shared(zbx_pp_queue_t *queue)
 {
 	zbx_pp_task_t	*task = NULL;
 
@@ -339,6 +475,128 @@ zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue)
 	return NULL;
 }
 
+#ifdef HAVE_ATOMIC_BUILTINS
+/******************************************************************************
+ *                                                                            *
+ * Purpose: move a batch of tasks from shared task lists to worker task ring  *
+ *                                                                            *
+ * Parameters: queue - [IN] task queue                                        *
+ *             ring  - [IN] task ring of the calling worker                   *
+ *                                                                            *
+ * Comments: The batch size (including the task already popped by worker)     *
+ *           depends on the number of pending tasks per worker, so with low   *
+ *           load tasks are still popped one by one.                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_task_queue_fill_ring(zbx_pp_queue_t *queue, zbx_pp_task_ring_t *ring)
+{
+	zbx_uint64_t	batch_num;
+	zbx_pp_task_t	*task;
+	int		pushed_num = 0;
+
+	if (PP_TASK_RING_SIZE < (batch_num = queue->pending_num / (zbx_uint64_t)queue->rings_num))
+		batch_num = PP_TASK_RING_SIZE;
+
+	if (1 >= batch_num)
+		return;
+
+	while (0 != --batch_num && NULL != (task = pp_task_queue_pop_shared(queue)))
+	{
+		if (SUCCEED != pp_task_ring_push(ring, task))
+		{
+			/* the ring is drained by its owner before popping new tasks, */
+			/* so it must not be full - return task to shared list         */
+			THIS_SHOULD_NEVER_HAPPEN;
+			queue->pending_num++;
+			queue->processing_num--;
+			(void)zbx_list_prepend(&queue->immediate, task, NULL);
+			break;
+		}
+
+		pushed_num++;
+	}
+
+	/* wake up another worker to steal from the filled ring */
+	if (0 != pushed_num)
+		pp_task_queue_notify(queue);
+}
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pop task from task queue                                          *
+ *                                                                            *
+ * Parameters: queue      - [IN] task queue                                   *
+ *             ring_index - [IN] task ring index of the calling worker        *
+ *                                                                            *
+ * Return value: The popped task or NULL if there are no tasks to be          *
+ *               processed.                                                   *
+ *                                                                            *
+ * Comments: This function is used by workers to pop tasks for processing     *
+ *           and must be called within task queue lock.                       *
+ *           When there are more pending tasks than workers a batch of tasks  *
+ *           is moved into worker task ring, which later is processed without *
+ *           locking task queue (see pp_task_queue_pop_local()). Idle workers *
+ *           steal tasks from task rings of busy workers.                     *
+ *           Task sequences are not affected - a sequence task is requeued    *
+ *           only after it has been finished, so at any time it can be either *
+ *           in shared task lists or in a single task ring.                   *
+ *                                                                            *
+ ******************************************************************************/
+zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue, int ring_index)
+{
+	zbx_pp_task_t	*task;
+
+	if (NULL != (task = pp_task_queue_pop_shared(queue)))
+	{
+#ifdef HAVE_ATOMIC_BUILTINS
+		if (0 != queue->rings_num)
+			pp_task_queue_fill_ring(queue, &queue->rings[ring_index]);
+#else
+		ZBX_UNUSED(ring_index);
+#endif
+		return task;
+	}
+
+#ifdef HAVE_ATOMIC_BUILTINS
+	for (int i = 1; i < queue->rings_num; i++)
+	{
+		if (NULL != (task = pp_task_ring_pop(&queue->rings[(ring_index + i) % queue->rings_num])))
+		{
+			/* there might be more tasks to steal, wake up another worker */
+			pp_task_queue_notify(queue);
+			return task;
+		}
+	}
+#endif
+	return NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pop task from the calling worker task ring                        *
+ *                                                                            *
+ * Parameters: queue      - [IN] task queue                                   *
+ *             ring_index - [IN] task ring index of the calling worker        *
+ *                                                                            *
+ * Return value: The popped task or NULL if the task ring is empty.           *
+ *                                                                            *
+ * Comments: This function is used by workers to process batched tasks        *
+ *           without locking task queue.                                      *
+ *                                                                            *
+ ******************************************************************************/
+zbx_pp_task_t	*pp_task_queue_pop_local(zbx_pp_queue_t *queue, int ring_index)
+{
+#ifdef HAVE_ATOMIC_BUILTINS
+	if (0 != queue->rings_num)
+		return pp_task_ring_pop(&queue->rings[ring_index]);
+#else
+	ZBX_UNUSED(queue);
+	ZBX_UNUSED(ring_index);
+#endif
+	return NULL;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: push finished task into queue                                     *
@@ -23,26 +23,54 @@
 #include "zbxpreproc.h"
 #include "zbxalgo.h"
 
+#define PP_TASK_RING_SIZE	32	/* must be power of 2 */
+#define PP_CACHE_LINE_SIZE	64
+
+typedef struct
+{
+	zbx_uint64_t	sequence;
+	zbx_pp_task_t	*task;
+}
+zbx_pp_task_ring_slot_t;
+
+/* Bounded lock-free worker task ring. The ring is filled only by its owner worker */
+/* while holding task queue lock and can be popped without locking both by owner   */
+/* and by other workers stealing tasks.                                            */
 typedef struct
 {
-	zbx_uint32_t	init_flags;
-	int		workers_num;
-	zbx_uint64_t	pending_num;
-	zbx_uint64_t	finished_num;
-	zbx_uint64_t	processing_num;
+	zbx_pp_task_ring_slot_t	slots[PP_TASK_RING_SIZE];
+
+	zbx_uint64_t		head;
+	char			pad_head[PP_CACHE_LINE_SIZE - sizeof(zbx_uint64_t)];
+	zbx_uint64_t		tail;
+	char			pad_tail[PP_CACHE_LINE_SIZE - sizeof(zbx_uint64_t)];
+}
+zbx_pp_task_ring_t;
+
+typedef struct
+{
+	zbx_uint32_t		init_flags;
+	int			workers_num;
+	zbx_uint64_t		pending_num;
+	zbx_uint64_t		finished_num;
+	zbx_uint64_t		processing_num;
+
+	zbx_hashset_t		sequences;
 
-	zbx_hashset_t	sequences;
+	zbx_list_t		pending;
+	zbx_list_t		immediate;
+	zbx_list_t		finished;
 
-	zbx_list_t	pending;
-	zbx_list_t	immediate;
-	zbx_list_t	finished;
+	/* per worker task rings, not used if atomic operations are not supported */
+	zbx_pp_task_ring_t	*rings;
+	int			rings_num;
 
-	pthread_mutex_t	lock;
-	pthread_cond_t	event;
+	pthread_mutex_t		lock;
+	pthread_cond_t		event;
 }
 zbx_pp_queue_t;
 
-int	pp_task_queue_init(zbx_pp_queue_t *queue, char **error);
+int	pp_task_queue_init(zbx_pp_queue_t *queue, int workers_num, char **error);
 void	pp_task_queue_destroy(zbx_pp_queue_t *queue);
 
 void	pp_task_queue_lock(zbx_pp_queue_t *queue);
@@ -58,7 +86,8 @@ void	pp_task_queue_notify_all(zbx_pp_queue_t *queue);
 void	pp_task_queue_push_test(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 void	pp_task_queue_push(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 
-zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue);
+zbx_pp_task_t	*pp_task_queue_pop_new(zbx_pp_queue_t *queue, int ring_index);
+zbx_pp_task_t	*pp_task_queue_pop_local(zbx_pp_queue_t *queue, int ring_index);
 void	pp_task_queue_push_immediate(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 void	pp_task_queue_push_finished(zbx_pp_queue_t *queue, zbx_pp_task_t *task);
 zbx_pp_task_t	*pp_task_queue_pop_finished(zbx_pp_queue_t *queue);
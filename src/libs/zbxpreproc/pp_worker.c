@@ -99,6 +99,34 @@ static	void	pp_task_process_sequence(zbx_pp_context_t *ctx, zbx_pp_task_t *task_
 	}
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process task                                                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	pp_worker_process_task(zbx_pp_worker_t *worker, zbx_pp_task_t *task)
+{
+	zabbix_log(LOG_LEVEL_TRACE, "%s() process task type:%u itemid:" ZBX_FS_UI64, __func__, task->type,
+			task->itemid);
+
+	switch (task->type)
+	{
+		case ZBX_PP_TASK_TEST:
+			pp_task_process_test(&worker->execute_ctx, task, worker->config_source_ip);
+			break;
+		case ZBX_PP_TASK_VALUE:
+		case ZBX_PP_TASK_VALUE_SEQ:
+			pp_task_process_value(&worker->execute_ctx, task, worker->config_source_ip);
+			break;
+		case ZBX_PP_TASK_DEPENDENT:
+			pp_task_process_dependent(&worker->execute_ctx, task, worker->config_source_ip);
+			break;
+		case ZBX_PP_TASK_SEQUENCE:
+			pp_task_process_sequence(&worker->execute_ctx, task, worker->config_source_ip);
+			break;
+	}
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: preprocessing worker thread entry                                 *
@@ -106,12 +134,12 @@ static	void	pp_task_process_sequence(zbx_pp_context_t *ctx, zbx_pp_task_t *task_
  ******************************************************************************/
 static void	*pp_worker_entry(void *args)
 {
-	zbx_pp_worker_t		*worker = (zbx_pp_worker_t *)args;
-	zbx_pp_queue_t		*queue = worker->queue;
-	zbx_pp_task_t		*in;
-	char			*error = NULL, component[MAX_ID_LEN + 1];
-	sigset_t		mask;
-	int			err;
+	zbx_pp_worker_t			*worker = (zbx_pp_worker_t *)args;
+	zbx_pp_queue_t			*queue = worker->queue;
+	zbx_pp_task_t			*in, *next;
+	char				*error = NULL, component[MAX_ID_LEN + 1];
+	sigset_t			mask;
+	int				err, ring_index = worker->id - 1;
 
 	zbx_snprintf(component, sizeof(component), "%d", worker->id);
 	zbx_set_log_component(component, &worker->logger);
@@ -140,39 +168,33 @@ static void	*pp_worker_entry(void *args)
 
 	while (0 == worker->stop)
 	{
-		if (NULL != (in = pp_task_queue_pop_new(queue)))
+		if (NULL != (in = pp_task_queue_pop_new(queue, ring_index)))
 		{
 			pp_task_queue_unlock(queue);
 
 			zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_BUSY);
 
-			zabbix_log(LOG_LEVEL_TRACE, "%s() process task type:%u itemid:" ZBX_FS_UI64, __func__,
-					in->type, in->itemid);
-
-			switch (in->type)
+			/* process the popped task and the tasks batched into worker task ring, */
+			/* publishing every task as soon as it is finished                      */
+			do
 			{
-				case ZBX_PP_TASK_TEST:
-					pp_task_process_test(&worker->execute_ctx, in, worker->config_source_ip);
-					break;
-				case ZBX_PP_TASK_VALUE:
-				case ZBX_PP_TASK_VALUE_SEQ:
-					pp_task_process_value(&worker->execute_ctx, in, worker->config_source_ip);
-					break;
-				case ZBX_PP_TASK_DEPENDENT:
-					pp_task_process_dependent(&worker->execute_ctx, in, worker->config_source_ip);
-					break;
-				case ZBX_PP_TASK_SEQUENCE:
-					pp_task_process_sequence(&worker->execute_ctx, in, worker->config_source_ip);
-					break;
-			}
+				pp_worker_process_task(worker, in);
 
-			zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_IDLE);
+				if (NULL == (next = pp_task_queue_pop_local(queue, ring_index)))
+					zbx_timekeeper_update(worker->timekeeper, worker->id - 1, ZBX_PROCESS_STATE_IDLE);
 
-			pp_task_queue_lock(queue);
-			pp_task_queue_push_finished(queue, in);
+				pp_task_queue_lock(queue);
+				pp_task_queue_push_finished(queue, in);
+
+				if (NULL != worker->finished_cb)
+					worker->finished_cb(worker->finished_data);
+
+				if (NULL != next)
+					pp_task_queue_unlock(queue);
+			}
+			while (NULL != (in = next));
 
-			if (NULL != worker->finished_cb)
-				worker->finished_cb(worker->finished_data);
+			zbx_regexp_cache_get_stats(&worker->regexp_hits, &worker->regexp_misses);
 
 			continue;
 		}
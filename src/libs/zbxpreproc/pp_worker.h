@@ -47,6 +47,10 @@ typedef struct
 	zbx_log_component_t		logger;
 
 	const char			*config_source_ip;
+
+	/* compiled regexp cache statistics, updated under task queue lock */
+	zbx_uint64_t			regexp_hits;
+	zbx_uint64_t			regexp_misses;
 }
 zbx_pp_worker_t;
 
@@ -262,43 +262,193 @@ int	zbx_regexp_compile_ext(const char *pattern, zbx_regexp_t **regexp, int flags
 	return regexp_compile(pattern, flags, regexp, err_msg);
 }
 
+#define ZBX_REGEXP_CACHE_SIZE	32
+
+typedef struct
+{
+	char		*pattern;
+	zbx_hash_t	hash;
+	int		flags;
+	zbx_uint64_t	lastaccess;
+	zbx_regexp_t	*regexp;
+}
+zbx_regexp_cache_entry_t;
+
+static ZBX_THREAD_LOCAL zbx_regexp_cache_entry_t	regexp_cache[ZBX_REGEXP_CACHE_SIZE];
+static ZBX_THREAD_LOCAL int				regexp_cache_num = 0;
+static ZBX_THREAD_LOCAL zbx_uint64_t			regexp_cache_access = 0;
+static ZBX_THREAD_LOCAL zbx_uint64_t			regexp_cache_hits = 0;
+static ZBX_THREAD_LOCAL zbx_uint64_t			regexp_cache_misses = 0;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables JIT compilation for the compiled regular expression if    *
+ *          it is supported by the regular expression library                 *
+ *                                                                            *
+ * Comments: JIT compilation failure is not an error - pcre2_match() falls    *
+ *           back to the interpreter when JIT code is not available.          *
+ *                                                                            *
+ ******************************************************************************/
+static void	regexp_jit_compile(zbx_regexp_t *regexp)
+{
+#ifdef HAVE_PCRE2_H
+	(void)pcre2_jit_compile(regexp->pcre2_regexp, PCRE2_JIT_COMPLETE);
+#else
+	ZBX_UNUSED(regexp);
+#endif
+}
+
 /****************************************************************************************************
  *                                                                                                  *
- * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the last used regexp.                 *
+ * Purpose: wrapper for zbx_regexp_compile. Caches and reuses the recently used regexps.            *
+ *                                                                                                  *
+ * Parameters:                                                                                      *
+ *     pattern - [IN] regular expression as a text string                                           *
+ *     flags   - [IN] regexp compilation parameters                                                 *
+ *     regexp  - [OUT] compiled regexp, owned by the cache                                          *
+ *     err_msg - [OUT] dynamically allocated error message                                          *
+ *                                                                                                  *
+ * Return value: SUCCEED or FAIL                                                                    *
+ *                                                                                                  *
+ * Comments: The cache is thread local and keeps up to ZBX_REGEXP_CACHE_SIZE compiled regexps,      *
+ *           the least recently used regexp is discarded when the cache is full. The returned       *
+ *           regexp stays valid until the next call of a function compiling uncached pattern in     *
+ *           the same thread.                                                                       *
  *                                                                                                  *
  ****************************************************************************************************/
 static int	regexp_prepare(const char *pattern, int flags, zbx_regexp_t **regexp, char **err_msg)
 {
-	static ZBX_THREAD_LOCAL zbx_regexp_t	*curr_regexp = NULL;
-	static ZBX_THREAD_LOCAL char		*curr_pattern = NULL;
-	static ZBX_THREAD_LOCAL int		curr_flags = 0;
-	int					ret = SUCCEED;
+	zbx_hash_t			hash;
+	int				i;
+	zbx_regexp_cache_entry_t	*entry;
 
-	if (NULL == curr_regexp || 0 != strcmp(curr_pattern, pattern) || curr_flags != flags)
+	hash = zbx_default_string_hash_func(pattern);
+
+	for (i = 0; i < regexp_cache_num; i++)
 	{
-		if (NULL != curr_regexp)
+		entry = &regexp_cache[i];
+
+		if (entry->hash == hash && entry->flags == flags && 0 == strcmp(entry->pattern, pattern))
 		{
-			zbx_regexp_free(curr_regexp);
-			zbx_free(curr_pattern);
+			entry->lastaccess = ++regexp_cache_access;
+			regexp_cache_hits++;
+			*regexp = entry->regexp;
+
+			return SUCCEED;
 		}
+	}
+
+	regexp_cache_misses++;
 
-		curr_regexp = NULL;
-		curr_pattern = NULL;
-		curr_flags = 0;
+	if (SUCCEED != regexp_compile(pattern, flags, regexp, err_msg))
+		return FAIL;
+
+	regexp_jit_compile(*regexp);
+
+	if (ZBX_REGEXP_CACHE_SIZE > regexp_cache_num)
+	{
+		entry = &regexp_cache[regexp_cache_num++];
+	}
+	else
+	{
+		entry = &regexp_cache[0];
 
-		if (SUCCEED == regexp_compile(pattern, flags, &curr_regexp, err_msg))
+		for (i = 1; i < regexp_cache_num; i++)
 		{
-			curr_pattern = zbx_strdup(curr_pattern, pattern);
-			curr_flags = flags;
+			if (regexp_cache[i].lastaccess < entry->lastaccess)
+				entry = &regexp_cache[i];
 		}
-		else
-			ret = FAIL;
+
+		zbx_regexp_free(entry->regexp);
+		zbx_free(entry->pattern);
 	}
 
-	*regexp = curr_regexp;
+	entry->pattern = zbx_strdup(NULL, pattern);
+	entry->hash = hash;
+	entry->flags = flags;
+	entry->lastaccess = ++regexp_cache_access;
+	entry->regexp = *regexp;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles a regular expression with default options using the      *
+ *          compiled regexp cache                                             *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     pattern   - [IN] regular expression as a text string                   *
+ *     regexp    - [OUT] compiled regular expression owned by the cache.      *
+ *                       Must not be freed by the caller.                     *
+ *     err_msg   - [OUT] error message if any                                 *
+ *                                                                            *
+ * Return value: SUCCEED or FAIL                                              *
+ *                                                                            *
+ * Comments: Use this function instead of zbx_regexp_compile() when the same  *
+ *           patterns are compiled repeatedly. The returned regexp stays      *
+ *           valid until the next call of a function compiling regular        *
+ *           expressions in the same thread.                                  *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_regexp_compile_cached(const char *pattern, const zbx_regexp_t **regexp, char **err_msg)
+{
+	zbx_regexp_t	*cached;
+	int		ret;
+
+#ifdef ZBX_REGEXP_NO_AUTO_CAPTURE
+	ret = regexp_prepare(pattern, ZBX_REGEXP_MULTILINE | ZBX_REGEXP_NO_AUTO_CAPTURE, &cached, err_msg);
+#else
+	ret = regexp_prepare(pattern, ZBX_REGEXP_MULTILINE, &cached, err_msg);
+#endif
+	if (SUCCEED == ret)
+		*regexp = cached;
+
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: compiles a regular expression with specified options using the    *
+ *          compiled regexp cache                                             *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     pattern   - [IN] regular expression as a text string                   *
+ *     regexp    - [OUT] compiled regular expression owned by the cache.      *
+ *                       Must not be freed by the caller.                     *
+ *     flags     - [IN] regexp compilation parameters, see                    *
+ *                      zbx_regexp_compile_ext()                              *
+ *     err_msg   - [OUT] error message if any                                 *
+ *                                                                            *
+ * Return value: SUCCEED or FAIL                                              *
+ *                                                                            *
+ ******************************************************************************/
+int	zbx_regexp_compile_ext_cached(const char *pattern, const zbx_regexp_t **regexp, int flags, char **err_msg)
+{
+	zbx_regexp_t	*cached;
+
+	if (SUCCEED != regexp_prepare(pattern, flags, &cached, err_msg))
+		return FAIL;
+
+	*regexp = cached;
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets compiled regexp cache statistics of the calling thread       *
+ *                                                                            *
+ * Parameters: hits   - [OUT] number of patterns found in cache               *
+ *             misses - [OUT] number of patterns compiled                     *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_regexp_cache_get_stats(zbx_uint64_t *hits, zbx_uint64_t *misses)
+{
+	*hits = regexp_cache_hits;
+	*misses = regexp_cache_misses;
+}
+
 /* calculate recursion limit, PCRE man page suggests to reckon on about 500 bytes per recursion */
 /* but to be on the safe side - reckon on 800 bytes and do not set limit higher than 100000 */
 #define REGEXP_RECURSION_STEP	800
@@ -466,8 +616,17 @@ static int	regexp_exec(const char *string, const zbx_regexp_t *regexp, int flags
 		flags |= PCRE2_NO_UTF_CHECK;
 #endif
 
-		if (0 <= (r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, 0, flags,
-			match_data, regexp->match_ctx)))
+		r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, 0, flags,
+				match_data, regexp->match_ctx);
+#ifdef PCRE2_NO_JIT
+		/* JIT uses a small machine stack by default, retry with interpreter that uses heap instead */
+		if (PCRE2_ERROR_JIT_STACKLIMIT == r)
+		{
+			r = pcre2_match(regexp->pcre2_regexp, (PCRE2_SPTR)string, PCRE2_ZERO_TERMINATED, 0,
+					flags | PCRE2_NO_JIT, match_data, regexp->match_ctx);
+		}
+#endif
+		if (0 <= r)
 		{
 			if (NULL != matches)
 			{
@@ -1744,6 +1903,57 @@ void	zbx_regexp_escape(char **string)
 	*string = buffer;
 }
 
+/**********************************************************************************
+ *                                                                                *
+ * Purpose: get literal text contained in every string matching the expression    *
+ *                                                                                *
+ * Parameters: pattern - [IN] the regular expression                              *
+ *                                                                                *
+ * Return value: the literal prefix of expression (must be freed by caller) or    *
+ *               NULL if expression does not start with literal characters or     *
+ *               is invalid                                                       *
+ *                                                                                *
+ * Comments: The literal allows to reject strings with substring search without   *
+ *           running the expression. Expressions with alternatives are skipped    *
+ *           because the prefix is not required to match them.                    *
+ *                                                                                *
+ **********************************************************************************/
+char	*zbx_regexp_get_literal(const char *pattern)
+{
+	const char		*ptr;
+	const zbx_regexp_t	*regexp;
+	char			*literal, *error = NULL;
+	size_t			len;
+
+	if (NULL != strchr(pattern, '|'))
+		return NULL;
+
+	for (ptr = pattern; '\0' != *ptr && NULL == strchr("\\^$.[]()?*+{}", *ptr); ptr++)
+		;
+
+	len = (size_t)(ptr - pattern);
+
+	/* the last character is optional when followed by quantifier allowing zero repetitions */
+	if (0 != len && ('?' == *ptr || '*' == *ptr || '{' == *ptr))
+		len--;
+
+	if (0 == len)
+		return NULL;
+
+	/* do not hide invalid expression from the caller */
+	if (SUCCEED != zbx_regexp_compile_cached(pattern, &regexp, &error))
+	{
+		zbx_free(error);
+		return NULL;
+	}
+
+	literal = (char *)zbx_malloc(NULL, len + 1);
+	memcpy(literal, pattern, len);
+	literal[len] = '\0';
+
+	return literal;
+}
+
 /**********************************************************************************
  *                                                                                *
  * Purpose: remove repeated wildcard characters from the expression               *
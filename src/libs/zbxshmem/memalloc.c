@@ -107,6 +107,10 @@ static void	*__mem_malloc(zbx_shmem_info_t *info, zbx_uint64_t size);
 static void	*__mem_realloc(zbx_shmem_info_t *info, void *old, zbx_uint64_t size);
 static void	__mem_free(zbx_shmem_info_t *info, void *ptr);
 
+static void	*mem_slab_malloc(zbx_shmem_info_t *info, zbx_uint64_t size);
+static void	*mem_slab_realloc(zbx_shmem_info_t *info, void *old, zbx_uint64_t size);
+static void	mem_slab_free(zbx_shmem_info_t *info, void *ptr);
+
 #define SHMEM_SIZE_FIELD	sizeof(zbx_uint64_t)
 
 #define SHMEM_FLG_USED		((__UINT64_C(1))<<63)
@@ -117,6 +121,59 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr);
 #define SHMEM_MIN_SIZE		__UINT64_C(128)
 #define SHMEM_MAX_SIZE		__UINT64_C(0x1000000000)	/* 64 GB */
 
+/******************************************************************************
+ *                                                                            *
+ *                      Some information on slab layout                       *
+ *                  ---------------------------------------                   *
+ *                                                                            *
+ * When slabs are enabled, allocations of up to ZBX_SHMEM_SLAB_MAX_SIZE bytes *
+ * are rounded up to a multiple of 8 and served from a slab page of that      *
+ * size class. A slab page is a single used chunk of SHMEM_SLAB_PAGE_SIZE     *
+ * bytes, split into a page header and equally sized objects:                 *
+ *                                                                            *
+ *     |--------|------ page header ------|--------|-- object --|...|-----|   *
+ *                                                                            *
+ *      chunk     prev, next, free list,    object    user data               *
+ *      size      class index, used count   header                            *
+ *                                                                            *
+ *     the object header occupies the place of the chunk size field and has   *
+ *     SHMEM_FLG_SLAB bit set, so the free functions can tell slab objects    *
+ *     from ordinary chunks. The rest of the header is the object offset from *
+ *     the page header.                                                       *
+ *                                                                            *
+ *     free objects of a page are kept in a singly-linked list stored in the  *
+ *     object user data, pages with free objects are kept in a doubly-linked  *
+ *     list per size class, so both allocation and freeing take constant      *
+ *     time and never merge chunks.                                           *
+ *                                                                            *
+ *     empty pages are returned to the chunk allocator, unless it is the only *
+ *     page with free objects in its size class                               *
+ *                                                                            *
+ *     free slab objects are accounted as free memory of the segment and used *
+ *     objects as used memory, while page and object headers are overhead     *
+ *                                                                            *
+ ******************************************************************************/
+
+typedef struct zbx_shmem_slab_page
+{
+	struct zbx_shmem_slab_page	*prev;
+	struct zbx_shmem_slab_page	*next;
+	void				*free_objects;
+	zbx_uint32_t			class_index;
+	zbx_uint32_t			objects_used;
+}
+zbx_shmem_slab_page_t;
+
+#define SHMEM_FLG_SLAB		((__UINT64_C(1))<<62)
+#define SLAB_OBJECT(ptr)	(0 != ((*(zbx_uint64_t *)(ptr)) & SHMEM_FLG_SLAB))
+#define SLAB_OFFSET(ptr)	((*(zbx_uint64_t *)(ptr)) & ~(SHMEM_FLG_USED | SHMEM_FLG_SLAB))
+
+#define SHMEM_SLAB_PAGE_SIZE	__UINT64_C(4096)
+#define SHMEM_SLAB_HEADER_SIZE	((sizeof(zbx_shmem_slab_page_t) + 7) & ~(size_t)7)
+
+/* slab pages are not created when less than this amount of free memory is left */
+#define SHMEM_SLAB_RESERVE	(4 * SHMEM_SLAB_PAGE_SIZE)
+
 /* helper functions */
 
 static void	*ALIGN4(void *ptr)
@@ -523,6 +580,267 @@ static void	__mem_free(zbx_shmem_info_t *info, void *ptr)
 	}
 }
 
+/* slab functions */
+
+static int	mem_slab_class_by_size(zbx_uint64_t size)
+{
+	return (int)((size + 7) >> 3) - 1;
+}
+
+static zbx_uint64_t	mem_slab_class_size(int index)
+{
+	return (zbx_uint64_t)(index + 1) << 3;
+}
+
+static zbx_uint64_t	mem_slab_class_capacity(int index)
+{
+	return (SHMEM_SLAB_PAGE_SIZE - SHMEM_SLAB_HEADER_SIZE) / (SHMEM_SIZE_FIELD + mem_slab_class_size(index));
+}
+
+static void	*mem_slab_page_object(zbx_shmem_slab_page_t *page, zbx_uint64_t offset)
+{
+	return (void *)((char *)page + offset);
+}
+
+static zbx_uint64_t	mem_slab_free_size(const zbx_shmem_info_t *info)
+{
+	zbx_uint64_t	size = 0;
+
+	for (int i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+		size += (info->slabs[i].objects_num - info->slabs[i].objects_used) * mem_slab_class_size(i);
+
+	return size;
+}
+
+static void	mem_slab_link_page(zbx_shmem_slab_class_t *slab, zbx_shmem_slab_page_t *page)
+{
+	page->prev = NULL;
+	page->next = (zbx_shmem_slab_page_t *)slab->pages;
+
+	if (NULL != page->next)
+		page->next->prev = page;
+
+	slab->pages = page;
+}
+
+static void	mem_slab_unlink_page(zbx_shmem_slab_class_t *slab, zbx_shmem_slab_page_t *page)
+{
+	if (NULL != page->prev)
+		page->prev->next = page->next;
+	else
+		slab->pages = page->next;
+
+	if (NULL != page->next)
+		page->next->prev = page->prev;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates new slab page for the specified size class              *
+ *                                                                            *
+ * Parameters: info  - [IN] shared memory segment                             *
+ *             index - [IN] slab size class                                   *
+ *                                                                            *
+ * Return value: allocated page or NULL if there is not enough free memory    *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_shmem_slab_page_t	*mem_slab_create_page(zbx_shmem_info_t *info, int index)
+{
+	void			*chunk, *object, *next = NULL;
+	zbx_shmem_slab_page_t	*page;
+	zbx_uint64_t		i, capacity, object_size;
+
+	/* free memory includes free slab objects which cannot be used for new pages */
+	if (SHMEM_SLAB_RESERVE > info->free_size - mem_slab_free_size(info))
+		return NULL;
+
+	if (NULL == (chunk = __mem_malloc(info, SHMEM_SLAB_PAGE_SIZE)))
+		return NULL;
+
+	page = (zbx_shmem_slab_page_t *)((char *)chunk + SHMEM_SIZE_FIELD);
+	page->class_index = (zbx_uint32_t)index;
+	page->objects_used = 0;
+
+	object_size = SHMEM_SIZE_FIELD + mem_slab_class_size(index);
+	capacity = mem_slab_class_capacity(index);
+
+	for (i = capacity; 0 < i; i--)
+	{
+		zbx_uint64_t	offset = SHMEM_SLAB_HEADER_SIZE + (i - 1) * object_size;
+
+		object = mem_slab_page_object(page, offset);
+		*(zbx_uint64_t *)object = SHMEM_FLG_SLAB | offset;
+		*(void **)((char *)object + SHMEM_SIZE_FIELD) = next;
+		next = object;
+	}
+
+	page->free_objects = next;
+
+	mem_slab_link_page(&info->slabs[index], page);
+	info->slabs[index].pages_num++;
+	info->slabs[index].objects_num += capacity;
+
+	info->used_size -= CHUNK_SIZE(chunk);
+	info->free_size += capacity * mem_slab_class_size(index);
+
+	return page;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates object from slab of the corresponding size class        *
+ *                                                                            *
+ * Parameters: info - [IN] shared memory segment                              *
+ *             size - [IN] requested size, must not exceed                    *
+ *                         ZBX_SHMEM_SLAB_MAX_SIZE                            *
+ *                                                                            *
+ * Return value: allocated object header (the same way as chunks are          *
+ *               returned by __mem_malloc()) or NULL if a new slab page could *
+ *               not be allocated                                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	*mem_slab_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
+{
+	int			index;
+	void			*object;
+	zbx_shmem_slab_class_t	*slab;
+	zbx_shmem_slab_page_t	*page;
+
+	index = mem_slab_class_by_size(size);
+	slab = &info->slabs[index];
+
+	if (NULL == (page = (zbx_shmem_slab_page_t *)slab->pages) && NULL == (page = mem_slab_create_page(info, index)))
+		return NULL;
+
+	object = page->free_objects;
+	page->free_objects = *(void **)((char *)object + SHMEM_SIZE_FIELD);
+	page->objects_used++;
+	slab->objects_used++;
+
+	info->used_size += mem_slab_class_size(index);
+	info->free_size -= mem_slab_class_size(index);
+
+	*(zbx_uint64_t *)object |= SHMEM_FLG_USED;
+
+	if (NULL == page->free_objects)
+		mem_slab_unlink_page(slab, page);
+
+	return object;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: returns object to its slab page                                   *
+ *                                                                            *
+ * Parameters: info - [IN] shared memory segment                              *
+ *             ptr  - [IN] user data of the object                            *
+ *                                                                            *
+ ******************************************************************************/
+static void	mem_slab_free(zbx_shmem_info_t *info, void *ptr)
+{
+	void			*object;
+	zbx_shmem_slab_class_t	*slab;
+	zbx_shmem_slab_page_t	*page;
+	zbx_uint64_t		offset;
+
+	object = (void *)((char *)ptr - SHMEM_SIZE_FIELD);
+	offset = SLAB_OFFSET(object);
+	page = (zbx_shmem_slab_page_t *)((char *)object - offset);
+	slab = &info->slabs[page->class_index];
+
+	*(zbx_uint64_t *)object = SHMEM_FLG_SLAB | offset;
+	*(void **)ptr = page->free_objects;
+
+	if (NULL == page->free_objects)
+		mem_slab_link_page(slab, page);
+
+	page->free_objects = object;
+	page->objects_used--;
+	slab->objects_used--;
+
+	info->used_size -= mem_slab_class_size((int)page->class_index);
+	info->free_size += mem_slab_class_size((int)page->class_index);
+
+	/* keep the last page with free objects to avoid page allocation */
+	/* and release when an object is repeatedly allocated and freed   */
+	if (0 == page->objects_used && (NULL != page->prev || NULL != page->next))
+	{
+		zbx_uint64_t	capacity = mem_slab_class_capacity((int)page->class_index);
+
+		mem_slab_unlink_page(slab, page);
+		slab->pages_num--;
+		slab->objects_num -= capacity;
+
+		/* restore page chunk accounting before releasing it */
+		info->used_size += CHUNK_SIZE((char *)page - SHMEM_SIZE_FIELD);
+		info->free_size -= capacity * mem_slab_class_size((int)page->class_index);
+
+		__mem_free(info, page);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reallocates slab object                                           *
+ *                                                                            *
+ * Parameters: info - [IN] shared memory segment                              *
+ *             old  - [IN] user data of the object                            *
+ *             size - [IN] new size                                           *
+ *                                                                            *
+ * Return value: reallocated object/chunk header or NULL if there is not      *
+ *               enough memory                                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	*mem_slab_realloc(zbx_shmem_info_t *info, void *old, zbx_uint64_t size)
+{
+	void			*object, *chunk = NULL;
+	zbx_shmem_slab_page_t	*page;
+	zbx_uint64_t		old_size;
+
+	object = (void *)((char *)old - SHMEM_SIZE_FIELD);
+	page = (zbx_shmem_slab_page_t *)((char *)object - SLAB_OFFSET(object));
+	old_size = mem_slab_class_size((int)page->class_index);
+
+	if (ZBX_SHMEM_SLAB_MAX_SIZE >= size)
+	{
+		zbx_uint64_t	new_size = mem_slab_class_size(mem_slab_class_by_size(size));
+
+		/* do not reallocate if not much is freed */
+		if (new_size <= old_size && new_size > old_size / 2)
+			return object;
+
+		chunk = mem_slab_malloc(info, size);
+	}
+
+	if (NULL == chunk && NULL == (chunk = __mem_malloc(info, size)))
+		return NULL;
+
+	memcpy((char *)chunk + SHMEM_SIZE_FIELD, old, MIN(old_size, size));
+	mem_slab_free(info, old);
+
+	return chunk;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: allocates memory from slabs if possible, otherwise from chunks    *
+ *                                                                            *
+ ******************************************************************************/
+static void	*mem_malloc(zbx_shmem_info_t *info, zbx_uint64_t size)
+{
+	void	*chunk;
+
+	if (0 != info->use_slabs && ZBX_SHMEM_SLAB_MAX_SIZE >= size && NULL != (chunk = mem_slab_malloc(info, size)))
+		return chunk;
+
+	return __mem_malloc(info, size);
+}
+
+static void	mem_slab_reset(zbx_shmem_info_t *info)
+{
+	memset(info->slabs, 0, sizeof(info->slabs));
+}
+
 /* public memory interface */
 
 int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *descr, const char *param,
@@ -596,6 +914,8 @@ int	zbx_shmem_create(zbx_shmem_info_t **info, zbx_uint64_t size, const char *des
 	base = (void *)((char *)base + strlen(param) + 1);
 
 	(*info)->allow_oom = allow_oom;
+	(*info)->use_slabs = 0;
+	mem_slab_reset(*info);
 
 	/* prepare shared memory for further allocation by creating one big chunk */
 	(*info)->lo_bound = ALIGN8(base);
@@ -665,6 +985,26 @@ void	zbx_shmem_destroy(zbx_shmem_info_t *info)
 	(void)shmdt(info->base);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: enables slab allocation of small objects                          *
+ *                                                                            *
+ * Parameters: info - [IN] shared memory segment                              *
+ *                                                                            *
+ * Comments: Allocations of up to ZBX_SHMEM_SLAB_MAX_SIZE bytes are served    *
+ *           from slab pages of fixed size classes with constant time         *
+ *           allocation and freeing. This benefits caches allocating lots of  *
+ *           small objects of the same size. Memory of free slab objects can  *
+ *           be reused only by objects of the same size class.                *
+ *           The slabs can be enabled at any time, memory allocated before    *
+ *           is freed the usual way.                                          *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_shmem_enable_slabs(zbx_shmem_info_t *info)
+{
+	info->use_slabs = 1;
+}
+
 void	*__zbx_shmem_malloc(const char *file, int line, zbx_shmem_info_t *info, const void *old, size_t size)
 {
 	void	*chunk;
@@ -683,7 +1023,7 @@ void	*__zbx_shmem_malloc(const char *file, int line, zbx_shmem_info_t *info, con
 		exit(EXIT_FAILURE);
 	}
 
-	chunk = __mem_malloc(info, size);
+	chunk = mem_malloc(info, size);
 
 	if (NULL == chunk)
 	{
@@ -715,7 +1055,9 @@ void	*__zbx_shmem_realloc(const char *file, int line, zbx_shmem_info_t *info, vo
 	}
 
 	if (NULL == old)
-		chunk = __mem_malloc(info, size);
+		chunk = mem_malloc(info, size);
+	else if (SLAB_OBJECT((char *)old - SHMEM_SIZE_FIELD))
+		chunk = mem_slab_realloc(info, old, size);
 	else
 		chunk = __mem_realloc(info, old, size);
 
@@ -745,7 +1087,10 @@ void	__zbx_shmem_free(const char *file, int line, zbx_shmem_info_t *info, void *
 		exit(EXIT_FAILURE);
 	}
 
-	__mem_free(info, ptr);
+	if (SLAB_OBJECT((char *)ptr - SHMEM_SIZE_FIELD))
+		mem_slab_free(info, ptr);
+	else
+		__mem_free(info, ptr);
 }
 
 void	zbx_shmem_clear(zbx_shmem_info_t *info)
@@ -762,6 +1107,7 @@ void	zbx_shmem_clear(zbx_shmem_info_t *info)
 	mem_set_next_chunk(info->buckets[index], NULL);
 	info->used_size = 0;
 	info->free_size = info->total_size;
+	mem_slab_reset(info);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
@@ -800,6 +1146,23 @@ void	zbx_shmem_get_stats(const zbx_shmem_info_t *info, zbx_shmem_stats_t *stats)
 	stats->used_chunks = stats->overhead / (2 * SHMEM_SIZE_FIELD) + 1 - stats->free_chunks;
 	stats->free_size = info->free_size;
 	stats->used_size = info->used_size;
+
+	stats->slab_pages = 0;
+	stats->slab_used_objects = 0;
+	stats->slab_free_objects = 0;
+	stats->slab_used_size = 0;
+	stats->slab_free_size = 0;
+
+	for (i = 0; i < ZBX_SHMEM_SLAB_CLASS_COUNT; i++)
+	{
+		const zbx_shmem_slab_class_t	*slab = &info->slabs[i];
+
+		stats->slab_pages += slab->pages_num;
+		stats->slab_used_objects += slab->objects_used;
+		stats->slab_free_objects += slab->objects_num - slab->objects_used;
+		stats->slab_used_size += slab->objects_used * mem_slab_class_size(i);
+		stats->slab_free_size += (slab->objects_num - slab->objects_used) * mem_slab_class_size(i);
+	}
 }
 
 void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info)
@@ -833,6 +1196,15 @@ void	zbx_shmem_dump_stats(int level, zbx_shmem_info_t *info)
 	zabbix_log(level, "of those, %10llu bytes are used by allocation overhead",
 			(unsigned long long)stats.overhead);
 
+	if (0 != stats.slab_pages)
+	{
+		zabbix_log(level, "slab pages: %llu", (unsigned long long)stats.slab_pages);
+		zabbix_log(level, "of those, %10llu bytes are in %8llu used slab objects",
+				(unsigned long long)stats.slab_used_size, (unsigned long long)stats.slab_used_objects);
+		zabbix_log(level, "of those, %10llu bytes are in %8llu free slab objects",
+				(unsigned long long)stats.slab_free_size, (unsigned long long)stats.slab_free_objects);
+	}
+
 	zabbix_log(level, "================================");
 }
 
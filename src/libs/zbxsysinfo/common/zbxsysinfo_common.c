@@ -111,6 +111,18 @@ void	zbx_set_user_parameter_dir(const char *path)
 	user_parameter_dir = path;
 }
 
+static int	proc_cache_ttl = 0;
+
+void	zbx_set_proc_cache_ttl(int ttl)
+{
+	proc_cache_ttl = ttl;
+}
+
+int	sysinfo_get_proc_cache_ttl(void)
+{
+	return proc_cache_ttl;
+}
+
 static int	only_active(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
 	ZBX_UNUSED(request);
@@ -32,9 +32,7 @@
 #define PROC_VAL_TYPE_TEXT	0
 #define PROC_VAL_TYPE_NUM	1
 #define PROC_VAL_TYPE_BYTE	2
-
-#define PROC_ID_TYPE_USER	0
-#define PROC_ID_TYPE_GROUP	1
+#define PROC_VAL_TYPE_ID	3
 
 typedef struct
 {
@@ -94,6 +92,113 @@ proc_data_t;
 ZBX_PTR_VECTOR_DECL(proc_data_ptr, proc_data_t *)
 ZBX_PTR_VECTOR_IMPL(proc_data_ptr, proc_data_t *)
 
+/* process data groups kept in process snapshot */
+#define PROC_SNAPSHOT_STATUS	0x01	/* /proc/<pid>/status fields */
+#define PROC_SNAPSHOT_STAT	0x02	/* /proc/<pid>/stat fields */
+#define PROC_SNAPSHOT_CMDLINE	0x04	/* /proc/<pid>/cmdline */
+#define PROC_SNAPSHOT_OWNER	0x08	/* owner of /proc/<pid> directory */
+
+/* numeric /proc/<pid>/status fields kept in process snapshot */
+#define PROC_STATUS_PPID		0
+#define PROC_STATUS_UID			1
+#define PROC_STATUS_GID			2
+#define PROC_STATUS_THREADS		3
+#define PROC_STATUS_VOLUNTARY_CTXT	4
+#define PROC_STATUS_NONVOLUNTARY_CTXT	5
+#define PROC_STATUS_VMSIZE		6
+#define PROC_STATUS_VMRSS		7
+#define PROC_STATUS_VMPEAK		8
+#define PROC_STATUS_VMSWAP		9
+#define PROC_STATUS_VMLIB		10
+#define PROC_STATUS_VMLCK		11
+#define PROC_STATUS_VMPIN		12
+#define PROC_STATUS_VMHWM		13
+#define PROC_STATUS_VMDATA		14
+#define PROC_STATUS_VMSTK		15
+#define PROC_STATUS_VMEXE		16
+#define PROC_STATUS_VMPTE		17
+#define PROC_STATUS_FIELDS_NUM		18
+
+typedef struct
+{
+	const char	*label;
+	int		type;
+}
+proc_status_field_t;
+
+static const proc_status_field_t	proc_status_fields[PROC_STATUS_FIELDS_NUM] = {
+	{"PPid", PROC_VAL_TYPE_NUM},
+	{"Uid", PROC_VAL_TYPE_ID},
+	{"Gid", PROC_VAL_TYPE_ID},
+	{"Threads", PROC_VAL_TYPE_NUM},
+	{"voluntary_ctxt_switches", PROC_VAL_TYPE_NUM},
+	{"nonvoluntary_ctxt_switches", PROC_VAL_TYPE_NUM},
+	{"VmSize", PROC_VAL_TYPE_BYTE},
+	{"VmRSS", PROC_VAL_TYPE_BYTE},
+	{"VmPeak", PROC_VAL_TYPE_BYTE},
+	{"VmSwap", PROC_VAL_TYPE_BYTE},
+	{"VmLib", PROC_VAL_TYPE_BYTE},
+	{"VmLck", PROC_VAL_TYPE_BYTE},
+	{"VmPin", PROC_VAL_TYPE_BYTE},
+	{"VmHWM", PROC_VAL_TYPE_BYTE},
+	{"VmData", PROC_VAL_TYPE_BYTE},
+	{"VmStk", PROC_VAL_TYPE_BYTE},
+	{"VmExe", PROC_VAL_TYPE_BYTE},
+	{"VmPTE", PROC_VAL_TYPE_BYTE}
+};
+
+typedef struct
+{
+	unsigned int	pid;
+
+	/* data groups that could not be read */
+	unsigned char	failed;
+
+	/* PROC_SNAPSHOT_STATUS - process name, state and numeric fields */
+	char		*name;
+	char		*state;
+	zbx_uint64_t	status[PROC_STATUS_FIELDS_NUM];
+	zbx_uint32_t	status_found;
+	zbx_uint32_t	status_invalid;
+
+	/* PROC_SNAPSHOT_STAT - process name and cpu utilization, ZBX_MAX_UINT64 if not available */
+	char		*comm;
+	zbx_uint64_t	page_faults;
+	zbx_uint64_t	utime;
+	zbx_uint64_t	stime;
+	zbx_uint64_t	starttime;
+	int		stat_error;
+
+	/* PROC_SNAPSHOT_CMDLINE - command line in format <arg0> <arg1> ... <argN>\0, */
+	/* the 0th argument and its base name                                      */
+	char		*cmdline;
+	size_t		cmdline_nbytes;
+	char		*arg0;
+	const char	*arg0_name;
+
+	/* PROC_SNAPSHOT_OWNER */
+	uid_t		owner;
+}
+proc_snapshot_entry_t;
+
+ZBX_PTR_VECTOR_DECL(proc_snapshot_entry_ptr, proc_snapshot_entry_t *)
+ZBX_PTR_VECTOR_IMPL(proc_snapshot_entry_ptr, proc_snapshot_entry_t *)
+
+/* processes read from /proc, reused by proc.* checks until the snapshot expires */
+typedef struct
+{
+	zbx_vector_proc_snapshot_entry_ptr_t	entries;	/* sorted by pid */
+	unsigned char				flags;		/* loaded data groups */
+	double					time;		/* when the process list was read */
+
+	/* /proc file read buffer */
+	char					*buf;
+	size_t					buf_alloc;
+}
+proc_snapshot_t;
+
+static ZBX_THREAD_LOCAL proc_snapshot_t	*proc_snapshot = NULL;
+
 /******************************************************************************
  *                                                                            *
  * Purpose: frees process data structure                                      *
@@ -125,6 +230,65 @@ static void	proc_data_free(proc_data_t *proc_data)
 	zbx_free(proc_data);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses numeric value of a field in /proc file                     *
+ *                                                                            *
+ * Parameters:                                                                *
+ *     value - [IN] field value following the label, e.g. "   176712 kB\n"    *
+ *     type  - [IN] value type                                                *
+ *     num   - [OUT] numeric result, byte values are converted to bytes       *
+ *                                                                            *
+ * Return value: SUCCEED - the value was parsed successfully                  *
+ *               FAIL    - otherwise                                          *
+ *                                                                            *
+ * Comments: The value string is modified.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_parse_value(char *value, int type, zbx_uint64_t *num)
+{
+	char	*p_unit = NULL;
+
+	if (PROC_VAL_TYPE_BYTE == type)
+	{
+		if (NULL == (p_unit = strrchr(value, ' ')))
+			return FAIL;
+
+		*p_unit++ = '\0';
+	}
+
+	while (' ' == *value || '\t' == *value)
+		value++;
+
+	zbx_rtrim(value, "\n");
+
+	if (PROC_VAL_TYPE_ID == type)
+	{
+		/* only the first (real) id is used from "Uid:" and "Gid:" fields */
+		*num = (zbx_uint64_t)atoi(value);
+		return SUCCEED;
+	}
+
+	if (FAIL == zbx_is_uint64(value, num))
+		return FAIL;
+
+	if (NULL != p_unit)
+	{
+		zbx_rtrim(p_unit, "\n");
+
+		if (0 == strcasecmp(p_unit, "kB"))
+			*num <<= 10;
+		else if (0 == strcasecmp(p_unit, "mB"))
+			*num <<= 20;
+		else if (0 == strcasecmp(p_unit, "GB"))
+			*num <<= 30;
+		else if (0 == strcasecmp(p_unit, "TB"))
+			*num <<= 40;
+	}
+
+	return SUCCEED;
+}
+
 /******************************************************************************
  *                                                                            *
  * Purpose: Reads value from a string in /proc file.                          *
@@ -144,7 +308,7 @@ static void	proc_data_free(proc_data_t *proc_data)
  ******************************************************************************/
 static int	read_value_from_proc_file(FILE *f, long pos, const char *label, int type, zbx_uint64_t *num, char **str)
 {
-	char	buf[MAX_STRING_LEN], *p_value, *p_unit = NULL;
+	char	buf[MAX_STRING_LEN], *p_value;
 	size_t	label_len;
 	int	ret = NOTSUPPORTED;
 
@@ -163,46 +327,20 @@ static int	read_value_from_proc_file(FILE *f, long pos, const char *label, int t
 		if (0 != strncmp(buf, label, label_len))
 			continue;
 
-		if (PROC_VAL_TYPE_BYTE == type)
-		{
-			if (NULL == (p_unit = strrchr(p_value, ' ')))
-			{
-				ret = FAIL;
-				break;
-			}
-
-			*p_unit++ = '\0';
-		}
-
-		while (' ' == *p_value || '\t' == *p_value)
-			p_value++;
-
-		zbx_rtrim(p_value, "\n");
-
 		if (PROC_VAL_TYPE_TEXT == type)
 		{
+			while (' ' == *p_value || '\t' == *p_value)
+				p_value++;
+
+			zbx_rtrim(p_value, "\n");
 			*str = zbx_strdup(NULL, p_value);
 		}
-		else if (FAIL == zbx_is_uint64(p_value, num))
+		else if (FAIL == proc_parse_value(p_value, type, num))
 		{
 			ret = FAIL;
 			break;
 		}
 
-		if (PROC_VAL_TYPE_BYTE == type)
-		{
-			zbx_rtrim(p_unit, "\n");
-
-			if (0 == strcasecmp(p_unit, "kB"))
-				*num <<= 10;
-			else if (0 == strcasecmp(p_unit, "mB"))
-				*num <<= 20;
-			else if (0 == strcasecmp(p_unit, "GB"))
-				*num <<= 30;
-			else if (0 == strcasecmp(p_unit, "TB"))
-				*num <<= 40;
-		}
-
 		ret = SUCCEED;
 		break;
 	}
@@ -216,183 +354,510 @@ static int	read_value_from_proc_file(FILE *f, long pos, const char *label, int t
 	return ret;
 }
 
-static int	proc_read_id(FILE *f_status, int type, zbx_uint64_t *id)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: Reads 64 bit unsigned space or zero character terminated integer  *
+ *          from a text string.                                               *
+ *                                                                            *
+ * Parameters: ptr   - [IN] text string                                       *
+ *             value - [OUT] parsed value                                     *
+ *                                                                            *
+ * Return value: The length of the parsed text or FAIL if parsing failed.     *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_read_value(const char *ptr, zbx_uint64_t *value)
 {
-	char	*id_s, *p;
+	const char	*start = ptr;
+	int		len;
 
-	if (SUCCEED != read_value_from_proc_file(f_status, 0, PROC_ID_TYPE_USER == type ? "Uid" : "Gid",
-			PROC_VAL_TYPE_TEXT, NULL, &id_s))
-	{
+	while (' ' != *ptr && '\0' != *ptr)
+		ptr++;
+
+	len = ptr - start;
+
+	if (SUCCEED == zbx_is_uint64_n(start, len, value))
+		return len;
+
+	return FAIL;
+}
+
+static void	proc_snapshot_entry_free(proc_snapshot_entry_t *entry)
+{
+	zbx_free(entry->name);
+	zbx_free(entry->state);
+	zbx_free(entry->comm);
+	zbx_free(entry->cmdline);
+	zbx_free(entry->arg0);
+
+	zbx_free(entry);
+}
+
+static int	proc_snapshot_entry_compare(const void *d1, const void *d2)
+{
+	const proc_snapshot_entry_t	*e1 = *(const proc_snapshot_entry_t * const *)d1;
+	const proc_snapshot_entry_t	*e2 = *(const proc_snapshot_entry_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(e1->pid, e2->pid);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads whole /proc file into snapshot read buffer                  *
+ *                                                                            *
+ * Parameters: snapshot - [IN/OUT] process snapshot                           *
+ *             dir_fd   - [IN] /proc directory descriptor                     *
+ *             path     - [IN] file path relative to /proc                    *
+ *             len      - [OUT] number of bytes read                          *
+ *                                                                            *
+ * Return value: SUCCEED - the file was read, the buffer is terminated with   *
+ *                         '\0' not included in len                           *
+ *               FAIL    - otherwise, errno is set                            *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_read_file(proc_snapshot_t *snapshot, int dir_fd, const char *path, size_t *len)
+{
+	int	fd, err;
+	ssize_t	n;
+
+	if (-1 == (fd = openat(dir_fd, path, O_RDONLY)))
 		return FAIL;
+
+	*len = 0;
+
+	do
+	{
+		if (*len + 1 >= snapshot->buf_alloc)
+		{
+			snapshot->buf_alloc = (0 == snapshot->buf_alloc ? 4 * ZBX_KIBIBYTE : snapshot->buf_alloc * 2);
+			snapshot->buf = (char *)zbx_realloc(snapshot->buf, snapshot->buf_alloc);
+		}
+
+		if (0 < (n = pread(fd, snapshot->buf + *len, snapshot->buf_alloc - *len - 1, (off_t)*len)))
+			*len += (size_t)n;
 	}
+	while (0 < n);
 
-	if (NULL != (p = strchr(id_s, '\t')))
-		*p = '\0';
+	err = errno;
+	close(fd);
 
-	*id = (zbx_uint64_t)atoi(id_s);
-	zbx_free(id_s);
+	if (-1 == n)
+	{
+		errno = err;
+		return FAIL;
+	}
+
+	snapshot->buf[*len] = '\0';
 
 	return SUCCEED;
 }
 
-static int	get_cmdline(FILE *f_cmd, char **line, size_t *line_offset)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses /proc/<pid>/status file contents                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	proc_snapshot_parse_status(proc_snapshot_entry_t *entry, char *buf)
 {
-	size_t	line_alloc = ZBX_KIBIBYTE, n;
+	char	*line, *next, *value;
 
-	rewind(f_cmd);
+	for (line = buf; '\0' != *line; line = next)
+	{
+		if (NULL != (next = strchr(line, '\n')))
+			*next++ = '\0';
+		else
+			next = line + strlen(line);
 
-	*line = (char *)zbx_malloc(*line, line_alloc + 2);
-	*line_offset = 0;
+		if (NULL == (value = strchr(line, ':')))
+			continue;
 
-	while (0 != (n = fread(*line + *line_offset, 1, line_alloc - *line_offset, f_cmd)))
-	{
-		*line_offset += n;
+		*value++ = '\0';
+
+		if (0 == strcmp(line, "Name") || 0 == strcmp(line, "State"))
+		{
+			while (' ' == *value || '\t' == *value)
+				value++;
+
+			if ('N' == *line)
+				entry->name = zbx_strdup(entry->name, value);
+			else
+				entry->state = zbx_strdup(entry->state, value);
+
+			continue;
+		}
+
+		for (int i = 0; i < PROC_STATUS_FIELDS_NUM; i++)
+		{
+			if (0 != strcmp(line, proc_status_fields[i].label))
+				continue;
+
+			entry->status_found |= (zbx_uint32_t)1 << i;
+
+			if (SUCCEED != proc_parse_value(value, proc_status_fields[i].type, &entry->status[i]))
+				entry->status_invalid |= (zbx_uint32_t)1 << i;
 
-		if (0 != feof(f_cmd))
 			break;
+		}
+	}
+}
 
-		line_alloc *= 2;
-		*line = (char *)zbx_realloc(*line, line_alloc + 2);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses /proc/<pid>/stat file contents                             *
+ *                                                                            *
+ * Comments: The stat_error is set to the result proc_read_cpu_util() would   *
+ *           return for the same contents.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	proc_snapshot_parse_stat(proc_snapshot_entry_t *entry, char *buf)
+{
+	char		*ptr, *pstart;
+	zbx_uint64_t	*value;
+	int		n = 0, offset;
+
+	/* skip to the end of process name to avoid dealing with possible spaces in process name */
+	if (NULL == (ptr = strrchr(buf, ')')))
+	{
+		entry->stat_error = -EFAULT;
+		return;
 	}
 
-	if (0 == ferror(f_cmd))
+	*ptr++ = '\0';
+
+	if (NULL != (pstart = strchr(buf, '(')))
+		entry->comm = zbx_strdup(NULL, pstart + 1);
+
+	while ('\0' != *ptr)
 	{
-		if (0 == *line_offset || '\0' != (*line)[*line_offset - 1])
-			(*line)[(*line_offset)++] = '\0';
-		if (1 == *line_offset || '\0' != (*line)[*line_offset - 2])
-			(*line)[(*line_offset)++] = '\0';
+		if (' ' != *ptr++)
+			continue;
 
-		return SUCCEED;
+		switch (++n)
+		{
+			case 10:
+				value = &entry->page_faults;
+				break;
+			case 12:
+				value = &entry->utime;
+				break;
+			case 13:
+				value = &entry->stime;
+				break;
+			case 20:
+				value = &entry->starttime;
+				break;
+			default:
+				continue;
+		}
+
+		if (FAIL == (offset = proc_read_value(ptr, value)))
+		{
+			*value = ZBX_MAX_UINT64;
+			entry->stat_error = -EINVAL;
+			return;
+		}
+
+		if (20 == n)
+		{
+			entry->stat_error = SUCCEED;
+			return;
+		}
+
+		ptr += offset;
 	}
 
-	zbx_free(*line);
+	entry->stat_error = -ENODATA;
+}
 
-	return FAIL;
+/******************************************************************************
+ *                                                                            *
+ * Purpose: parses /proc/<pid>/cmdline file contents                          *
+ *                                                                            *
+ * Parameters: entry  - [IN/OUT] process snapshot entry                       *
+ *             buf    - [IN] file contents, terminated with '\0'              *
+ *             nbytes - [IN] file size                                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	proc_snapshot_parse_cmdline(proc_snapshot_entry_t *entry, char *buf, size_t nbytes)
+{
+	size_t	len;
+
+	/* add terminating NUL if it is missing due to processes setting their titles or other reasons */
+	if (0 < nbytes && '\0' != buf[nbytes - 1])
+		nbytes++;
+
+	entry->cmdline_nbytes = nbytes;
+	entry->arg0 = zbx_strdup(NULL, buf);
+
+	if (NULL == (entry->arg0_name = strrchr(entry->arg0, '/')))
+		entry->arg0_name = entry->arg0;
+	else
+		entry->arg0_name++;
+
+	/* according to proc(5) the arguments are separated by '\0', the empty last argument is dropped */
+	if (2 <= nbytes && '\0' == buf[nbytes - 2])
+		len = nbytes - 2;
+	else
+		len = (0 < nbytes ? nbytes - 1 : 0);
+
+	for (size_t i = 0; i < len; i++)
+	{
+		if ('\0' == buf[i])
+			buf[i] = ' ';
+	}
+
+	entry->cmdline = zbx_strdup(NULL, buf);
 }
 
-static int	cmp_status(FILE *f_stat, const char *procname)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads the specified data groups of all snapshot processes         *
+ *                                                                            *
+ * Parameters: snapshot - [IN/OUT] process snapshot                           *
+ *             flags    - [IN] data groups to read (PROC_SNAPSHOT_* flags)    *
+ *                                                                            *
+ * Comments: Processes which data cannot be read (for example, processes that *
+ *           have exited after the process list was read) are marked as       *
+ *           failed for the corresponding data groups.                        *
+ *                                                                            *
+ ******************************************************************************/
+static void	proc_snapshot_load(proc_snapshot_t *snapshot, unsigned char flags)
 {
-	char	tmp[MAX_STRING_LEN];
+	char	path[MAX_ID_LEN + 16];
+	int	dir_fd, offset;
+	size_t	len;
 
-	rewind(f_stat);
+	if (-1 == (dir_fd = open("/proc", O_RDONLY | O_DIRECTORY)))
+	{
+		for (int i = 0; i < snapshot->entries.values_num; i++)
+			snapshot->entries.values[i]->failed |= flags;
 
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
+		return;
+	}
+
+	for (int i = 0; i < snapshot->entries.values_num; i++)
 	{
-		if (0 != strncmp(tmp, "Name:\t", 6))
-			continue;
+		proc_snapshot_entry_t	*entry = snapshot->entries.values[i];
 
-		zbx_rtrim(tmp + 6, "\n");
-		if (0 == strcmp(tmp + 6, procname))
-			return SUCCEED;
-		break;
+		offset = zbx_snprintf(path, sizeof(path), "%u", entry->pid);
+
+		if (0 != (flags & PROC_SNAPSHOT_OWNER))
+		{
+			struct stat	st;
+
+			if (0 == fstatat(dir_fd, path, &st, 0))
+				entry->owner = st.st_uid;
+			else
+				entry->failed |= PROC_SNAPSHOT_OWNER;
+		}
+
+		if (0 != (flags & PROC_SNAPSHOT_STATUS))
+		{
+			zbx_strlcpy(path + offset, "/status", sizeof(path) - (size_t)offset);
+
+			if (SUCCEED == proc_snapshot_read_file(snapshot, dir_fd, path, &len))
+				proc_snapshot_parse_status(entry, snapshot->buf);
+			else
+				entry->failed |= PROC_SNAPSHOT_STATUS;
+		}
+
+		if (0 != (flags & PROC_SNAPSHOT_STAT))
+		{
+			zbx_strlcpy(path + offset, "/stat", sizeof(path) - (size_t)offset);
+
+			entry->page_faults = entry->utime = entry->stime = entry->starttime = ZBX_MAX_UINT64;
+
+			if (SUCCEED == proc_snapshot_read_file(snapshot, dir_fd, path, &len))
+			{
+				proc_snapshot_parse_stat(entry, snapshot->buf);
+			}
+			else
+			{
+				entry->stat_error = -errno;
+				entry->failed |= PROC_SNAPSHOT_STAT;
+			}
+		}
+
+		if (0 != (flags & PROC_SNAPSHOT_CMDLINE))
+		{
+			zbx_strlcpy(path + offset, "/cmdline", sizeof(path) - (size_t)offset);
+
+			if (SUCCEED == proc_snapshot_read_file(snapshot, dir_fd, path, &len))
+				proc_snapshot_parse_cmdline(entry, snapshot->buf, len);
+			else
+				entry->failed |= PROC_SNAPSHOT_CMDLINE;
+		}
 	}
 
-	return FAIL;
+	close(dir_fd);
 }
 
-static int	check_procname(FILE *f_cmd, FILE *f_stat, const char *procname)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets process snapshot with the specified data groups loaded       *
+ *                                                                            *
+ * Parameters: flags - [IN] data groups to load (PROC_SNAPSHOT_* flags)       *
+ *             ttl   - [IN] maximum age of the process list in seconds,       *
+ *                          0 - always read a new process list                *
+ *                                                                            *
+ * Return value: The process snapshot or NULL if /proc directory could not be *
+ *               opened, errno is set in this case.                           *
+ *                                                                            *
+ * Comments: Reading /proc files of all processes is the most expensive part  *
+ *           of proc.* checks, so within the snapshot lifetime checks with    *
+ *           different filters reuse the already read data. Data groups that  *
+ *           were not needed by previous checks are read on demand.           *
+ *                                                                            *
+ ******************************************************************************/
+static proc_snapshot_t	*proc_snapshot_get(unsigned char flags, int ttl)
 {
-	char	*tmp = NULL, *p;
-	size_t	l;
-	int	ret = SUCCEED;
+	double	now;
 
-	if (NULL == procname || '\0' == *procname)
-		return SUCCEED;
+	if (NULL == proc_snapshot)
+	{
+		proc_snapshot = (proc_snapshot_t *)zbx_malloc(NULL, sizeof(proc_snapshot_t));
+		memset(proc_snapshot, 0, sizeof(proc_snapshot_t));
+		zbx_vector_proc_snapshot_entry_ptr_create(&proc_snapshot->entries);
+	}
 
-	/* process name in /proc/[pid]/status contains limited number of characters */
-	if (SUCCEED == cmp_status(f_stat, procname))
-		return SUCCEED;
+	now = zbx_time();
 
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
+	if (0 == ttl || now < proc_snapshot->time || now - proc_snapshot->time >= ttl)
 	{
-		if (NULL == (p = strrchr(tmp, '/')))
-			p = tmp;
-		else
-			p++;
+		DIR		*dir;
+		struct dirent	*entries;
+		unsigned int	pid;
+
+		if (NULL == (dir = opendir("/proc")))
+			return NULL;
+
+		zbx_vector_proc_snapshot_entry_ptr_clear_ext(&proc_snapshot->entries, proc_snapshot_entry_free);
 
-		if (0 == strcmp(p, procname))
-			goto clean;
+		while (NULL != (entries = readdir(dir)))
+		{
+			proc_snapshot_entry_t	*entry;
+
+			/* skip entries not containing pids */
+			if (FAIL == zbx_is_uint32(entries->d_name, &pid))
+				continue;
+
+			entry = (proc_snapshot_entry_t *)zbx_malloc(NULL, sizeof(proc_snapshot_entry_t));
+			memset(entry, 0, sizeof(proc_snapshot_entry_t));
+			entry->pid = pid;
+
+			zbx_vector_proc_snapshot_entry_ptr_append(&proc_snapshot->entries, entry);
+		}
+
+		closedir(dir);
+
+		zbx_vector_proc_snapshot_entry_ptr_sort(&proc_snapshot->entries, proc_snapshot_entry_compare);
+
+		proc_snapshot->flags = 0;
+		proc_snapshot->time = now;
 	}
 
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
+	if (0 != (flags &= ~proc_snapshot->flags))
+	{
+		proc_snapshot_load(proc_snapshot, flags);
+		proc_snapshot->flags |= flags;
+	}
 
-	return ret;
+	return proc_snapshot;
 }
 
-static int	check_user(FILE *f_stat, struct passwd *usrinfo)
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets numeric /proc/<pid>/status field of snapshot process         *
+ *                                                                            *
+ * Parameters: entry - [IN] process snapshot entry                            *
+ *             field - [IN] field index (PROC_STATUS_* define)                *
+ *             value - [OUT] field value                                      *
+ *                                                                            *
+ * Return value: SUCCEED - successful reading                                 *
+ *               NOTSUPPORTED - the field was not found. For example,         *
+ *                              /proc/NNN/status files for kernel threads do  *
+ *                              not contain "VmSize:" string.                 *
+ *               FAIL - the field was found but could not be parsed.          *
+ *                                                                            *
+ ******************************************************************************/
+static int	proc_snapshot_get_status_value(const proc_snapshot_entry_t *entry, int field, zbx_uint64_t *value)
 {
-	zbx_uint64_t	uid;
+	zbx_uint32_t	mask = (zbx_uint32_t)1 << field;
 
-	if (NULL == usrinfo || (SUCCEED == proc_read_id(f_stat, PROC_ID_TYPE_USER, &uid) && usrinfo->pw_uid == uid))
-		return SUCCEED;
+	if (0 == (entry->status_found & mask))
+		return NOTSUPPORTED;
 
-	return FAIL;
+	if (0 != (entry->status_invalid & mask))
+		return FAIL;
+
+	*value = entry->status[field];
+
+	return SUCCEED;
 }
 
-static int	check_proccomm(FILE *f_cmd, const char *proccomm)
+static int	proc_snapshot_match_name(const proc_snapshot_entry_t *entry, const char *procname)
 {
-	char	*tmp = NULL;
-	size_t	l;
-	int	ret = SUCCEED;
+	if (NULL == procname || '\0' == *procname)
+		return SUCCEED;
 
-	if (NULL == proccomm || '\0' == *proccomm)
+	/* process name in /proc/[pid]/status contains limited number of characters */
+	if (NULL != entry->name && 0 == strcmp(entry->name, procname))
 		return SUCCEED;
 
-	if (SUCCEED == get_cmdline(f_cmd, &tmp, &l))
-	{
-		l = l - 2;
+	if (NULL != entry->arg0_name && 0 == strcmp(entry->arg0_name, procname))
+		return SUCCEED;
 
-		for (size_t i = 0; i < l; i++)
-			if ('\0' == tmp[i])
-				tmp[i] = ' ';
+	return FAIL;
+}
 
-		if (NULL != zbx_regexp_match(tmp, proccomm, NULL))
-			goto clean;
-	}
+static int	proc_snapshot_match_user(const proc_snapshot_entry_t *entry, const struct passwd *usrinfo)
+{
+	zbx_uint64_t	uid;
 
-	ret = FAIL;
-clean:
-	zbx_free(tmp);
+	if (NULL == usrinfo || (SUCCEED == proc_snapshot_get_status_value(entry, PROC_STATUS_UID, &uid) &&
+			usrinfo->pw_uid == uid))
+	{
+		return SUCCEED;
+	}
 
-	return ret;
+	return FAIL;
 }
 
-static int	check_procstate(FILE *f_stat, int zbx_proc_stat)
+static int	proc_snapshot_match_cmdline(const proc_snapshot_entry_t *entry, const char *proccomm)
 {
-	char	tmp[MAX_STRING_LEN], *p;
+	if (NULL == proccomm || '\0' == *proccomm)
+		return SUCCEED;
 
-	if (ZBX_PROC_STAT_ALL == zbx_proc_stat)
+	if (NULL != entry->cmdline && NULL != zbx_regexp_match(entry->cmdline, proccomm, NULL))
 		return SUCCEED;
 
-	rewind(f_stat);
+	return FAIL;
+}
 
-	while (NULL != fgets(tmp, (int)sizeof(tmp), f_stat))
-	{
-		if (0 != strncmp(tmp, "State:\t", 7))
-			continue;
+static int	proc_snapshot_match_state(const proc_snapshot_entry_t *entry, int zbx_proc_stat)
+{
+	if (ZBX_PROC_STAT_ALL == zbx_proc_stat)
+		return SUCCEED;
 
-		p = tmp + 7;
+	if (NULL == entry->state)
+		return FAIL;
 
-		switch (zbx_proc_stat)
-		{
-			case ZBX_PROC_STAT_RUN:
-				return ('R' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_SLEEP:
-				return ('S' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_ZOMB:
-				return ('Z' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_DISK:
-				return ('D' == *p) ? SUCCEED : FAIL;
-			case ZBX_PROC_STAT_TRACE:
-				return ('T' == *p) ? SUCCEED : FAIL;
-			default:
-				return FAIL;
-		}
+	switch (zbx_proc_stat)
+	{
+		case ZBX_PROC_STAT_RUN:
+			return ('R' == *entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_SLEEP:
+			return ('S' == *entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_ZOMB:
+			return ('Z' == *entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_DISK:
+			return ('D' == *entry->state) ? SUCCEED : FAIL;
+		case ZBX_PROC_STAT_TRACE:
+			return ('T' == *entry->state) ? SUCCEED : FAIL;
+		default:
+			return FAIL;
 	}
-
-	return FAIL;
 }
 
 /******************************************************************************
@@ -518,17 +983,15 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 #define ZBX_VMEXE	12
 #define ZBX_VMPTE	13
 
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
-	DIR		*dir;
-	struct dirent	*entries;
-	struct passwd	*usrinfo;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
-	zbx_uint64_t	mem_size = 0, byte_value = 0, total_memory;
-	double		pct_size = 0.0, pct_value = 0.0;
-	int		do_task, res, mem_type_code, mem_type_tried = 0, proccount = 0, invalid_user = 0,
-			invalid_read = 0;
-	char		*mem_type = NULL;
-	const char	*mem_type_search = NULL;
+	char			*procname, *proccomm, *param;
+	struct passwd		*usrinfo;
+	proc_snapshot_t		*snapshot;
+	zbx_uint64_t		mem_size = 0, byte_value = 0, total_memory;
+	double			pct_size = 0.0, pct_value = 0.0;
+	int			do_task, res, mem_type_code, mem_type_tried = 0, proccount = 0, invalid_user = 0,
+				invalid_read = 0, mem_field = -1;
+	unsigned char		flags = PROC_SNAPSHOT_STATUS;
+	char			*mem_type = NULL;
 
 	if (5 < request->nparam)
 	{
@@ -585,12 +1048,12 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 	if (NULL == mem_type || '\0' == *mem_type || 0 == strcmp(mem_type, "vsize"))
 	{
 		mem_type_code = ZBX_VSIZE;		/* current virtual memory size (total program size) */
-		mem_type_search = "VmSize:\t";
+		mem_field = PROC_STATUS_VMSIZE;
 	}
 	else if (0 == strcmp(mem_type, "rss"))
 	{
 		mem_type_code = ZBX_RSS;		/* current resident set size (size of memory portions) */
-		mem_type_search = "VmRSS:\t";
+		mem_field = PROC_STATUS_VMRSS;
 	}
 	else if (0 == strcmp(mem_type, "pmem"))
 	{
@@ -603,52 +1066,52 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 	else if (0 == strcmp(mem_type, "peak"))
 	{
 		mem_type_code = ZBX_VMPEAK;		/* peak virtual memory size */
-		mem_type_search = "VmPeak:\t";
+		mem_field = PROC_STATUS_VMPEAK;
 	}
 	else if (0 == strcmp(mem_type, "swap"))
 	{
 		mem_type_code = ZBX_VMSWAP;		/* size of swap space used */
-		mem_type_search = "VmSwap:\t";
+		mem_field = PROC_STATUS_VMSWAP;
 	}
 	else if (0 == strcmp(mem_type, "lib"))
 	{
 		mem_type_code = ZBX_VMLIB;		/* size of shared libraries */
-		mem_type_search = "VmLib:\t";
+		mem_field = PROC_STATUS_VMLIB;
 	}
 	else if (0 == strcmp(mem_type, "lck"))
 	{
 		mem_type_code = ZBX_VMLCK;		/* size of locked memory */
-		mem_type_search = "VmLck:\t";
+		mem_field = PROC_STATUS_VMLCK;
 	}
 	else if (0 == strcmp(mem_type, "pin"))
 	{
 		mem_type_code = ZBX_VMPIN;		/* size of pinned pages, they are never swappable */
-		mem_type_search = "VmPin:\t";
+		mem_field = PROC_STATUS_VMPIN;
 	}
 	else if (0 == strcmp(mem_type, "hwm"))
 	{
 		mem_type_code = ZBX_VMHWM;		/* peak resident set size ("high water mark") */
-		mem_type_search = "VmHWM:\t";
+		mem_field = PROC_STATUS_VMHWM;
 	}
 	else if (0 == strcmp(mem_type, "data"))
 	{
 		mem_type_code = ZBX_VMDATA;		/* size of data segment */
-		mem_type_search = "VmData:\t";
+		mem_field = PROC_STATUS_VMDATA;
 	}
 	else if (0 == strcmp(mem_type, "stk"))
 	{
 		mem_type_code = ZBX_VMSTK;		/* size of stack segment */
-		mem_type_search = "VmStk:\t";
+		mem_field = PROC_STATUS_VMSTK;
 	}
 	else if (0 == strcmp(mem_type, "exe"))
 	{
 		mem_type_code = ZBX_VMEXE;		/* size of text (code) segment */
-		mem_type_search = "VmExe:\t";
+		mem_field = PROC_STATUS_VMEXE;
 	}
 	else if (0 == strcmp(mem_type, "pte"))
 	{
 		mem_type_code = ZBX_VMPTE;		/* size of page table entries */
-		mem_type_search = "VmPTE:\t";
+		mem_field = PROC_STATUS_VMPTE;
 	}
 	else
 	{
@@ -675,40 +1138,31 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 
-	if (NULL == (dir = opendir("/proc")))
+	if ((NULL != procname && '\0' != *procname) || (NULL != proccomm && '\0' != *proccomm))
+		flags |= PROC_SNAPSHOT_CMDLINE;
+
+	if (NULL == (snapshot = proc_snapshot_get(flags, sysinfo_get_proc_cache_ttl())))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		return SYSINFO_RET_FAIL;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < snapshot->entries.values_num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
-			continue;
+		const proc_snapshot_entry_t	*entry = snapshot->entries.values[i];
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
+		if (0 != (entry->failed & flags))
 			continue;
 
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_stat = fopen(tmp, "r")))
+		if (FAIL == proc_snapshot_match_name(entry, procname))
 			continue;
 
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
+		if (FAIL == proc_snapshot_match_user(entry, usrinfo))
 			continue;
 
-		if (FAIL == check_user(f_stat, usrinfo))
+		if (FAIL == proc_snapshot_match_cmdline(entry, proccomm))
 			continue;
 
-		if (FAIL == check_proccomm(f_cmd, proccomm))
-			continue;
-
-		rewind(f_stat);
 
 		if (0 == mem_type_tried)
 			mem_type_tried = 1;
@@ -727,7 +1181,7 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 			case ZBX_VMSTK:
 			case ZBX_VMEXE:
 			case ZBX_VMPTE:
-				res = byte_value_from_proc_file(f_stat, mem_type_search, NULL, &byte_value);
+				res = proc_snapshot_get_status_value(entry, mem_field, &byte_value);
 
 				if (NOTSUPPORTED == res)
 					continue;
@@ -742,24 +1196,21 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 				{
 					zbx_uint64_t	m;
 
-					/* VmData, VmStk and VmExe follow in /proc/PID/status file in that order. */
-					/* Therefore we do not rewind f_stat between calls. */
-
-					mem_type_search = "VmData:\t";
+					mem_field = PROC_STATUS_VMDATA;
 
-					if (SUCCEED == (res = byte_value_from_proc_file(f_stat, mem_type_search, NULL,
+					if (SUCCEED == (res = proc_snapshot_get_status_value(entry, mem_field,
 							&byte_value)))
 					{
-						mem_type_search = "VmStk:\t";
+						mem_field = PROC_STATUS_VMSTK;
 
-						if (SUCCEED == (res = byte_value_from_proc_file(f_stat, mem_type_search,
-								NULL, &m)))
+						if (SUCCEED == (res = proc_snapshot_get_status_value(entry, mem_field,
+								&m)))
 						{
 							byte_value += m;
-							mem_type_search = "VmExe:\t";
+							mem_field = PROC_STATUS_VMEXE;
 
-							if (SUCCEED == (res = byte_value_from_proc_file(f_stat,
-									mem_type_search, NULL, &m)))
+							if (SUCCEED == (res = proc_snapshot_get_status_value(entry,
+									mem_field, &m)))
 							{
 								byte_value += m;
 							}
@@ -783,8 +1234,8 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 				}
 				break;
 			case ZBX_PMEM:
-				mem_type_search = "VmRSS:\t";
-				res = byte_value_from_proc_file(f_stat, mem_type_search, NULL, &byte_value);
+				mem_field = PROC_STATUS_VMRSS;
+				res = proc_snapshot_get_status_value(entry, mem_field, &byte_value);
 
 				if (SUCCEED == res)
 				{
@@ -832,18 +1283,10 @@ int	proc_mem(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 	}
 clean:
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
-
 	if ((0 == proccount && 0 != mem_type_tried) || 0 != invalid_read)
 	{
-		char	*s;
-
-		s = zbx_strdup(NULL, mem_type_search);
-		zbx_rtrim(s, ":\t");
-		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot get amount of \"%s\" memory.", s));
-		zbx_free(s);
+		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot get amount of \"%s\" memory.",
+				proc_status_fields[mem_field].label));
 		return SYSINFO_RET_FAIL;
 	}
 out:
@@ -881,12 +1324,11 @@ out:
 
 int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
-	char		tmp[MAX_STRING_LEN], *procname, *proccomm, *param;
-	DIR		*dir;
-	struct dirent	*entries;
+	char		*procname, *proccomm, *param;
 	struct passwd	*usrinfo;
-	FILE		*f_cmd = NULL, *f_stat = NULL;
+	proc_snapshot_t	*snapshot;
 	int		proccount = 0, invalid_user = 0, zbx_proc_stat;
+	unsigned char	flags = PROC_SNAPSHOT_STATUS;
 
 	if (4 < request->nparam)
 	{
@@ -941,214 +1383,42 @@ int	proc_num(AGENT_REQUEST *request, AGENT_RESULT *result)
 	if (1 == invalid_user)	/* handle 0 for non-existent user after all parameters have been parsed and validated */
 		goto out;
 
-	if (NULL == (dir = opendir("/proc")))
+	if ((NULL != procname && '\0' != *procname) || (NULL != proccomm && '\0' != *proccomm))
+		flags |= PROC_SNAPSHOT_CMDLINE;
+
+	if (NULL == (snapshot = proc_snapshot_get(flags, sysinfo_get_proc_cache_ttl())))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		return SYSINFO_RET_FAIL;
 	}
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < snapshot->entries.values_num; i++)
 	{
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_stat);
-
-		if (0 == atoi(entries->d_name))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
+		const proc_snapshot_entry_t	*entry = snapshot->entries.values[i];
 
-		if (NULL == (f_stat = fopen(tmp, "r")))
+		if (0 != (entry->failed & flags))
 			continue;
 
-		if (FAIL == check_procname(f_cmd, f_stat, procname))
+		if (FAIL == proc_snapshot_match_name(entry, procname))
 			continue;
 
-		if (FAIL == check_user(f_stat, usrinfo))
+		if (FAIL == proc_snapshot_match_user(entry, usrinfo))
 			continue;
 
-		if (FAIL == check_proccomm(f_cmd, proccomm))
+		if (FAIL == proc_snapshot_match_cmdline(entry, proccomm))
 			continue;
 
-		if (FAIL == check_procstate(f_stat, zbx_proc_stat))
+		if (FAIL == proc_snapshot_match_state(entry, zbx_proc_stat))
 			continue;
 
 		proccount++;
 	}
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_stat);
-	closedir(dir);
 out:
 	SET_UI64_RESULT(result, proccount);
 
 	return SYSINFO_RET_OK;
 }
 
-/******************************************************************************
- *                                                                            *
- * Purpose: returns process name                                              *
- *                                                                            *
- * Parameters: pid -      [IN]                                                *
- *             procname - [OUT]                                               *
- *                                                                            *
- * Return value: SUCCEED                                                      *
- *               FAIL                                                         *
- *                                                                            *
- * Comments: The process name is allocated by this function and must be freed *
- *           by the caller.                                                   *
- *                                                                            *
- ******************************************************************************/
-static int	proc_get_process_name(pid_t pid, char **procname)
-{
-	int	n, fd;
-	char	tmp[MAX_STRING_LEN], *pend, *pstart;
-
-	zbx_snprintf(tmp, sizeof(tmp), "/proc/%d/stat", (int)pid);
-
-	if (-1 == (fd = open(tmp, O_RDONLY)))
-		return FAIL;
-
-	n = read(fd, tmp, sizeof(tmp));
-	close(fd);
-
-	if (-1 == n)
-		return FAIL;
-
-	for (pend = tmp + n - 1; ')' != *pend && pend > tmp; pend--)
-		;
-
-	*pend = '\0';
-
-	if (NULL == (pstart = strchr(tmp, '(')))
-		return FAIL;
-
-	*procname = zbx_strdup(NULL, pstart + 1);
-
-	return SUCCEED;
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: returns process command line                                      *
- *                                                                            *
- * Parameters: pid            - [IN]                                          *
- *             cmdline        - [OUT] process command line                    *
- *             cmdline_nbytes - [OUT] number of bytes in command line         *
- *                                                                            *
- * Return value: SUCCEED                                                      *
- *               FAIL                                                         *
- *                                                                            *
- * Comments: The command line is allocated by this function and must be freed *
- *           by the caller.                                                   *
- *                                                                            *
- ******************************************************************************/
-static int	proc_get_process_cmdline(pid_t pid, char **cmdline, size_t *cmdline_nbytes)
-{
-	char	tmp[MAX_STRING_LEN];
-	int	fd, n;
-	size_t	cmdline_alloc = ZBX_KIBIBYTE;
-
-	*cmdline_nbytes = 0;
-	zbx_snprintf(tmp, sizeof(tmp), "/proc/%d/cmdline", (int)pid);
-
-	if (-1 == (fd = open(tmp, O_RDONLY)))
-		return FAIL;
-
-	*cmdline = (char *)zbx_malloc(NULL, cmdline_alloc);
-
-	while (0 < (n = read(fd, *cmdline + *cmdline_nbytes, cmdline_alloc - *cmdline_nbytes)))
-	{
-		*cmdline_nbytes += n;
-
-		if (*cmdline_nbytes == cmdline_alloc)
-		{
-			cmdline_alloc *= 2;
-			*cmdline = (char *)zbx_realloc(*cmdline, cmdline_alloc);
-		}
-	}
-
-	close(fd);
-
-	if (0 < *cmdline_nbytes)
-	{
-		/* add terminating NUL if it is missing due to processes setting their titles or other reasons */
-		if ('\0' != (*cmdline)[*cmdline_nbytes - 1])
-		{
-			if (*cmdline_nbytes == cmdline_alloc)
-			{
-				cmdline_alloc += 1;
-				*cmdline = (char *)zbx_realloc(*cmdline, cmdline_alloc);
-			}
-
-			(*cmdline)[*cmdline_nbytes] = '\0';
-			*cmdline_nbytes += 1;
-		}
-	}
-	else
-	{
-		zbx_free(*cmdline);
-	}
-
-	return SUCCEED;
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: returns process user identifier                                   *
- *                                                                            *
- * Parameters: pid - [IN]                                                     *
- *             uid - [OUT]                                                    *
- *                                                                            *
- * Return value: SUCCEED                                                      *
- *               FAIL                                                         *
- *                                                                            *
- ******************************************************************************/
-static int	proc_get_process_uid(pid_t pid, uid_t *uid)
-{
-	char		tmp[MAX_STRING_LEN];
-	zbx_stat_t	st;
-
-	zbx_snprintf(tmp, sizeof(tmp), "/proc/%d", (int)pid);
-
-	if (0 != zbx_stat(tmp, &st))
-		return FAIL;
-
-	*uid = st.st_uid;
-
-	return SUCCEED;
-}
-
-/******************************************************************************
- *                                                                            *
- * Purpose: Reads 64 bit unsigned space or zero character terminated integer  *
- *          from a text string.                                               *
- *                                                                            *
- * Parameters: ptr   - [IN] text string                                       *
- *             value - [OUT] parsed value                                     *
- *                                                                            *
- * Return value: The length of the parsed text or FAIL if parsing failed.     *
- *                                                                            *
- ******************************************************************************/
-static int	proc_read_value(const char *ptr, zbx_uint64_t *value)
-{
-	const char	*start = ptr;
-	int		len;
-
-	while (' ' != *ptr && '\0' != *ptr)
-		ptr++;
-
-	len = ptr - start;
-
-	if (SUCCEED == zbx_is_uint64_n(start, len, value))
-		return len;
-
-	return FAIL;
-}
-
 /******************************************************************************
  *                                                                            *
  * Purpose: Reads process cpu utilization values from /proc/[pid]/stat file.  *
@@ -1291,10 +1561,33 @@ static int	proc_match_cmdline(const zbx_sysinfo_proc_t *proc, const char *cmdlin
  ******************************************************************************/
 void	zbx_proc_get_process_stats(zbx_procstat_util_t *procs, int procs_num)
 {
+	proc_snapshot_entry_t	entry_local, *entry = &entry_local;
+	int			index;
+
 	zabbix_log(LOG_LEVEL_TRACE, "In %s() procs_num:%d", __func__, procs_num);
 
 	for (int i = 0; i < procs_num; i++)
+	{
+		/* use cpu utilization read together with process list by zbx_proc_get_processes() if possible */
+		if (NULL != proc_snapshot && 0 != (proc_snapshot->flags & PROC_SNAPSHOT_STAT))
+		{
+			entry_local.pid = (unsigned int)procs[i].pid;
+
+			if (FAIL != (index = zbx_vector_proc_snapshot_entry_ptr_bsearch(&proc_snapshot->entries, entry,
+					proc_snapshot_entry_compare)))
+			{
+				const proc_snapshot_entry_t	*snapshot_entry = proc_snapshot->entries.values[index];
+
+				procs[i].utime = snapshot_entry->utime;
+				procs[i].stime = snapshot_entry->stime;
+				procs[i].starttime = snapshot_entry->starttime;
+				procs[i].error = snapshot_entry->stat_error;
+				continue;
+			}
+		}
+
 		procs[i].error = proc_read_cpu_util(&procs[i]);
+	}
 
 	zabbix_log(LOG_LEVEL_TRACE, "End of %s()", __func__);
 }
@@ -1303,69 +1596,46 @@ void	zbx_proc_get_process_stats(zbx_procstat_util_t *procs, int procs_num)
  *                                                                            *
  * Purpose: creates process object with specified properties                  *
  *                                                                            *
- * Parameters: pid   - [IN]                                                   *
+ * Parameters: entry - [IN] process snapshot entry                            *
  *             flags - [IN] flags specifying properties to set                *
  *                                                                            *
  * Return value: The created process object or NULL if property reading       *
  *               failed.                                                      *
  *                                                                            *
  ******************************************************************************/
-static zbx_sysinfo_proc_t	*proc_create(int pid, unsigned int flags)
+static zbx_sysinfo_proc_t	*proc_create(const proc_snapshot_entry_t *entry, unsigned int flags)
 {
-	char			*procname = NULL, *cmdline = NULL, *name_arg0 = NULL;
-	uid_t			uid = (uid_t)-1;
-	zbx_sysinfo_proc_t	*proc = NULL;
-	int			ret = FAIL;
-	size_t			cmdline_nbytes;
+	zbx_sysinfo_proc_t	*proc;
 
-	if (0 != (flags & ZBX_SYSINFO_PROC_USER) && SUCCEED != proc_get_process_uid(pid, &uid))
-		goto out;
+	if (0 != (flags & ZBX_SYSINFO_PROC_USER) && 0 != (entry->failed & PROC_SNAPSHOT_OWNER))
+		return NULL;
 
 	if (0 != (flags & (ZBX_SYSINFO_PROC_CMDLINE | ZBX_SYSINFO_PROC_NAME)) &&
-			SUCCEED != proc_get_process_cmdline(pid, &cmdline, &cmdline_nbytes))
+			0 != (entry->failed & PROC_SNAPSHOT_CMDLINE))
 	{
-		goto out;
+		return NULL;
 	}
 
-	if (0 != (flags & ZBX_SYSINFO_PROC_NAME) && SUCCEED != proc_get_process_name(pid, &procname))
-		goto out;
+	if (0 != (flags & ZBX_SYSINFO_PROC_NAME) && NULL == entry->comm)
+		return NULL;
 
-	if (NULL != cmdline)
-	{
-		char		*ptr;
-		unsigned int	i;
+	proc = (zbx_sysinfo_proc_t *)zbx_malloc(NULL, sizeof(zbx_sysinfo_proc_t));
 
-		if (0 != (flags & ZBX_SYSINFO_PROC_NAME))
-		{
-			if (NULL == (ptr = strrchr(cmdline, '/')))
-				name_arg0 = zbx_strdup(NULL, cmdline);
-			else
-				name_arg0 = zbx_strdup(NULL, ptr + 1);
-		}
+	proc->pid = (pid_t)entry->pid;
+	proc->uid = (0 != (flags & ZBX_SYSINFO_PROC_USER) ? entry->owner : (uid_t)-1);
+	proc->name = NULL;
+	proc->cmdline = NULL;
+	proc->name_arg0 = NULL;
 
-		/* according to proc(5) the arguments are separated by '\0' */
-		for (i = 0; i < cmdline_nbytes - 1; i++)
-			if ('\0' == cmdline[i])
-				cmdline[i] = ' ';
-	}
+	if (0 != (flags & ZBX_SYSINFO_PROC_NAME))
+		proc->name = zbx_strdup(NULL, entry->comm);
 
-	ret = SUCCEED;
-out:
-	if (SUCCEED == ret)
+	if (0 != (flags & (ZBX_SYSINFO_PROC_CMDLINE | ZBX_SYSINFO_PROC_NAME)) && 0 != entry->cmdline_nbytes)
 	{
-		proc = (zbx_sysinfo_proc_t *)zbx_malloc(NULL, sizeof(zbx_sysinfo_proc_t));
+		proc->cmdline = zbx_strdup(NULL, entry->cmdline);
 
-		proc->pid = pid;
-		proc->uid = uid;
-		proc->name = procname;
-		proc->cmdline = cmdline;
-		proc->name_arg0 = name_arg0;
-	}
-	else
-	{
-		zbx_free(procname);
-		zbx_free(cmdline);
-		zbx_free(name_arg0);
+		if (0 != (flags & ZBX_SYSINFO_PROC_NAME))
+			proc->name_arg0 = zbx_strdup(NULL, entry->arg0_name);
 	}
 
 	return proc;
@@ -1382,33 +1652,40 @@ out:
  * Return value: SUCCEED - system processes were retrieved successfully       *
  *               FAIL    - failed to open /proc directory                     *
  *                                                                            *
+ * Comments: A new process snapshot is always taken, cpu utilization values   *
+ *           are read along with process names and later used by              *
+ *           zbx_proc_get_process_stats().                                    *
+ *                                                                            *
  ******************************************************************************/
 int	zbx_proc_get_processes(zbx_vector_ptr_t *processes, unsigned int flags)
 {
-	DIR			*dir;
-	struct dirent		*entries;
-	int			ret = FAIL, pid;
+	proc_snapshot_t		*snapshot;
 	zbx_sysinfo_proc_t	*proc;
+	unsigned char		snapshot_flags = 0;
+	int			ret = FAIL;
 
 	zabbix_log(LOG_LEVEL_TRACE, "In %s()", __func__);
 
-	if (NULL == (dir = opendir("/proc")))
+	if (0 != (flags & ZBX_SYSINFO_PROC_USER))
+		snapshot_flags |= PROC_SNAPSHOT_OWNER;
+
+	if (0 != (flags & (ZBX_SYSINFO_PROC_CMDLINE | ZBX_SYSINFO_PROC_NAME)))
+		snapshot_flags |= PROC_SNAPSHOT_CMDLINE;
+
+	if (0 != (flags & ZBX_SYSINFO_PROC_NAME))
+		snapshot_flags |= PROC_SNAPSHOT_STAT;
+
+	if (NULL == (snapshot = proc_snapshot_get(snapshot_flags, 0)))
 		goto out;
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < snapshot->entries.values_num; i++)
 	{
-		/* skip entries not containing pids */
-		if (FAIL == zbx_is_uint32(entries->d_name, &pid))
-			continue;
-
-		if (NULL == (proc = proc_create(pid, flags)))
+		if (NULL == (proc = proc_create(snapshot->entries.values[i], flags)))
 			continue;
 
 		zbx_vector_ptr_append(processes, proc);
 	}
 
-	closedir(dir);
-
 	ret = SUCCEED;
 out:
 	zabbix_log(LOG_LEVEL_TRACE, "End of %s(): %s, processes:%d", __func__, zbx_result_string(ret),
@@ -1745,6 +2022,117 @@ static proc_data_t	*proc_read_data(char *path, int zbx_proc_mode)
 	return proc_data;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: gets process data from process snapshot                           *
+ *                                                                            *
+ * Parameters: entry         - [IN] process snapshot entry                    *
+ *             zbx_proc_mode - [IN] ZBX_PROC_MODE_PROCESS or                  *
+ *                                  ZBX_PROC_MODE_SUMMARY                     *
+ *             total_memory  - [IN] total memory, 0 if not available          *
+ *                                                                            *
+ * Comments: This is proc_get_data() counterpart for processes, threads are   *
+ *           not kept in process snapshot.                                    *
+ *                                                                            *
+ ******************************************************************************/
+static proc_data_t	*proc_snapshot_get_data(const proc_snapshot_entry_t *entry, int zbx_proc_mode,
+		zbx_uint64_t total_memory)
+{
+#define GET_STATUS_VALUE(fld, value)								\
+	do											\
+	{											\
+		if (SUCCEED != proc_snapshot_get_status_value(entry, fld, value))		\
+			*value = ZBX_MAX_UINT64;						\
+	} while(0)
+
+	zbx_uint64_t	val;
+	char		*ptr;
+	long		hz;
+	proc_data_t	*proc_data;
+
+	proc_data = (proc_data_t *)zbx_malloc(NULL, sizeof(proc_data_t));
+
+	if (ZBX_PROC_MODE_SUMMARY != zbx_proc_mode)
+		GET_STATUS_VALUE(PROC_STATUS_PPID, &proc_data->ppid);
+
+	GET_STATUS_VALUE(PROC_STATUS_VMSIZE, &proc_data->vsize);
+	GET_STATUS_VALUE(PROC_STATUS_VMLCK, &proc_data->lck);
+	GET_STATUS_VALUE(PROC_STATUS_VMPIN, &proc_data->pin);
+	GET_STATUS_VALUE(PROC_STATUS_VMDATA, &proc_data->data);
+	GET_STATUS_VALUE(PROC_STATUS_VMSTK, &proc_data->stk);
+	GET_STATUS_VALUE(PROC_STATUS_VMEXE, &proc_data->exe);
+	GET_STATUS_VALUE(PROC_STATUS_VMLIB, &proc_data->lib);
+	GET_STATUS_VALUE(PROC_STATUS_VMPTE, &proc_data->pte);
+	GET_STATUS_VALUE(PROC_STATUS_VMSWAP, &proc_data->swap);
+	GET_STATUS_VALUE(PROC_STATUS_THREADS, &proc_data->threads);
+
+	if (ZBX_MAX_UINT64 == proc_data->exe || ZBX_MAX_UINT64 == proc_data->data ||
+			ZBX_MAX_UINT64 == proc_data->stk)
+	{
+		proc_data->size = ZBX_MAX_UINT64;
+	}
+	else
+		proc_data->size = proc_data->exe + proc_data->data + proc_data->stk;
+
+	if (SUCCEED == proc_snapshot_get_status_value(entry, PROC_STATUS_VMRSS, &proc_data->rss))
+	{
+		proc_data->pmem = 0 != total_memory ? (double)proc_data->rss / (double)total_memory * 100.0 : -1.0;
+	}
+	else
+	{
+		proc_data->rss = ZBX_MAX_UINT64;
+		proc_data->pmem = -1.0;
+	}
+
+	proc_data->tname = NULL;
+
+	if (ZBX_PROC_MODE_PROCESS == zbx_proc_mode)
+	{
+		GET_STATUS_VALUE(PROC_STATUS_VMPEAK, &proc_data->peak);
+		GET_STATUS_VALUE(PROC_STATUS_VMHWM, &proc_data->hwm);
+	}
+
+	GET_STATUS_VALUE(PROC_STATUS_VOLUNTARY_CTXT, &proc_data->ctx_switches);
+	GET_STATUS_VALUE(PROC_STATUS_NONVOLUNTARY_CTXT, &val);
+
+	if (ZBX_MAX_UINT64 != proc_data->ctx_switches && ZBX_MAX_UINT64 != val)
+		proc_data->ctx_switches += val;
+	else if (ZBX_MAX_UINT64 != proc_data->ctx_switches)
+		proc_data->ctx_switches = ZBX_MAX_UINT64;
+
+	proc_data->state = NULL;
+
+	if (ZBX_PROC_MODE_SUMMARY != zbx_proc_mode && NULL != entry->state)
+	{
+		if (NULL != (ptr = strchr(entry->state, '(')))
+		{
+			proc_data->state = zbx_strdup(NULL, ptr + 1);
+			zbx_rtrim(proc_data->state, ")");
+
+			if ('\0' == *proc_data->state)
+				zbx_free(proc_data->state);
+		}
+		else
+			proc_data->state = zbx_strdup(NULL, entry->state);
+	}
+
+	proc_data->page_faults = entry->page_faults;
+	proc_data->cputime_user = -1.0;
+	proc_data->cputime_system = -1.0;
+
+	if (0 < (hz = sysconf(_SC_CLK_TCK)))
+	{
+		if (ZBX_MAX_UINT64 != entry->utime)
+			proc_data->cputime_user = (double)entry->utime / (double)hz;
+
+		if (ZBX_MAX_UINT64 != entry->stime)
+			proc_data->cputime_system = (double)entry->stime / (double)hz;
+	}
+
+	return proc_data;
+#undef GET_STATUS_VALUE
+}
+
 int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 {
 #define SUM_PROC_VALUE(param)									\
@@ -1775,9 +2163,9 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 	char				*procname, *proccomm, *param, *prname = NULL, *cmdline = NULL, *user = NULL,
 					*group = NULL;
 	int				invalid_user = 0, zbx_proc_mode;
-	DIR				*dir;
-	FILE				*f_cmd = NULL, *f_status = NULL, *f_stat = NULL;
-	struct dirent			*entries;
+	unsigned char			flags;
+	zbx_uint64_t			total_memory = 0;
+	proc_snapshot_t			*snapshot;
 	struct passwd			*usrinfo;
 	struct zbx_json			j;
 	zbx_vector_proc_data_ptr_t	proc_data_ctx;
@@ -1837,7 +2225,17 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 		goto out;
 	}
 
-	if (NULL == (dir = opendir("/proc")))
+	flags = PROC_SNAPSHOT_STATUS | PROC_SNAPSHOT_CMDLINE;
+
+	if (ZBX_PROC_MODE_THREAD != zbx_proc_mode)
+	{
+		flags |= PROC_SNAPSHOT_STAT;
+
+		if (SUCCEED != get_total_memory(&total_memory))
+			total_memory = 0;
+	}
+
+	if (NULL == (snapshot = proc_snapshot_get(flags, sysinfo_get_proc_cache_ttl())))
 	{
 		SET_MSG_RESULT(result, zbx_dsprintf(NULL, "Cannot open /proc: %s", zbx_strerror(errno)));
 		return SYSINFO_RET_FAIL;
@@ -1845,74 +2243,46 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 
 	zbx_vector_proc_data_ptr_create(&proc_data_ctx);
 
-	while (NULL != (entries = readdir(dir)))
+	for (int i = 0; i < snapshot->entries.values_num; i++)
 	{
-		char		tmp[MAX_STRING_LEN];
-		unsigned int	pid;
-		zbx_uint64_t	uid, gid;
-		size_t		l;
-		int		ret_uid;
-		proc_data_t	*proc_data;
+		const proc_snapshot_entry_t	*entry = snapshot->entries.values[i];
+		zbx_uint64_t			uid = ZBX_MAX_UINT64, gid = ZBX_MAX_UINT64;
+		int				ret_uid;
+		proc_data_t			*proc_data;
 
-		zbx_fclose(f_cmd);
-		zbx_fclose(f_status);
 		zbx_free(cmdline);
 		zbx_free(prname);
 		zbx_free(user);
 		zbx_free(group);
 
-		if (FAIL == zbx_is_uint32(entries->d_name, &pid))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/cmdline", entries->d_name);
-
-		if (NULL == (f_cmd = fopen(tmp, "r")))
-			continue;
-
-		zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/status", entries->d_name);
-
-		if (NULL == (f_status = fopen(tmp, "r")))
-			continue;
-
-		if (SUCCEED != get_cmdline(f_cmd, &cmdline, &l))
+		if (0 != (entry->failed & flags) || NULL == entry->name)
 			continue;
 
-		if (SUCCEED != read_value_from_proc_file(f_status, 0, "Name", PROC_VAL_TYPE_TEXT, NULL, &prname))
-			continue;
+		prname = zbx_strdup(NULL, entry->name);
 
-		if ('\0' != *cmdline)
+		if ('\0' != *entry->arg0)
 		{
-			char	*p, *pend, sep = 0;
-			size_t	len;
-
-			if (NULL != (pend = strpbrk(cmdline, " :")))
-			{
-				sep = *pend;
-				*pend = '\0';
-			}
+			const char	*p, *pend;
+			size_t		len;
 
-			if (NULL == (p = strrchr(cmdline, '/')))
-				p = cmdline;
-			else
-				p++;
+			if (NULL == (pend = strpbrk(entry->arg0, " :")))
+				pend = entry->arg0 + strlen(entry->arg0);
 
-			if (NULL == prname || (strlen(p) > (len = strlen(prname)) && 0 == strncmp(p, prname, len)))
-				prname = zbx_strdup(prname, p);
+			for (p = pend; p > entry->arg0 && '/' != p[-1]; p--)
+				;
 
-			if (NULL != pend)
-				*pend = sep;
+			if ((size_t)(pend - p) > (len = strlen(prname)) && 0 == strncmp(p, prname, len))
+				prname = zbx_dsprintf(prname, "%.*s", (int)(pend - p), p);
 
-			for (len = 0, l -= 2; len < l; len++)
-			{
-				if ('\0' == cmdline[len])
-					cmdline[len] = ' ';
-			}
+			cmdline = zbx_strdup(NULL, entry->cmdline);
 		}
+		else
+			cmdline = zbx_strdup(NULL, "");
 
-		if (NULL == prname || (NULL != procname && '\0' != *procname && 0 != strcmp(prname, procname)))
+		if (NULL != procname && '\0' != *procname && 0 != strcmp(prname, procname))
 			continue;
 
-		ret_uid = proc_read_id(f_status, PROC_ID_TYPE_USER, &uid);
+		ret_uid = proc_snapshot_get_status_value(entry, PROC_STATUS_UID, &uid);
 
 		if (NULL != usrinfo && (SUCCEED != ret_uid || usrinfo->pw_uid != uid))
 			continue;
@@ -1937,9 +2307,8 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 				user = zbx_strdup(NULL, "-1");
 			}
 
-			if (SUCCEED == proc_read_id(f_status, PROC_ID_TYPE_GROUP, &gid))
+			if (SUCCEED == proc_snapshot_get_status_value(entry, PROC_STATUS_GID, &gid))
 			{
-				gid = (zbx_uint64_t)gid;
 				group = NULL != (grp = getgrgid((gid_t)gid)) ?
 						zbx_strdup(NULL, grp->gr_name) :
 						zbx_dsprintf(NULL, ZBX_FS_UI64, gid);
@@ -1953,9 +2322,10 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 
 		if (ZBX_PROC_MODE_THREAD == zbx_proc_mode)
 		{
+			char	tmp[MAX_STRING_LEN];
 			DIR	*taskdir;
 
-			zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/task", entries->d_name);
+			zbx_snprintf(tmp, sizeof(tmp), "/proc/%u/task", entry->pid);
 
 			if (NULL != (taskdir = opendir(tmp)))
 			{
@@ -1972,7 +2342,7 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 
 					if (NULL != (proc_data = proc_read_data(path, zbx_proc_mode)))
 					{
-						proc_data->pid = pid;
+						proc_data->pid = entry->pid;
 						proc_data->tid = tid;
 						proc_data->cmdline = NULL;
 						proc_data->name = zbx_strdup(NULL, prname);
@@ -1988,42 +2358,30 @@ int	proc_get(AGENT_REQUEST *request, AGENT_RESULT *result)
 		}
 		else
 		{
-			zbx_fclose(f_stat);
-
-			zbx_snprintf(tmp, sizeof(tmp), "/proc/%s/stat", entries->d_name);
-
-			if (NULL == (f_stat = fopen(tmp, "r")))
-				continue;
+			proc_data = proc_snapshot_get_data(entry, zbx_proc_mode, total_memory);
 
-			if (NULL != (proc_data = proc_get_data(f_status, f_stat, zbx_proc_mode)))
+			if (ZBX_PROC_MODE_PROCESS == zbx_proc_mode)
 			{
-				if (ZBX_PROC_MODE_PROCESS == zbx_proc_mode)
-				{
-					proc_data->pid = pid;
-					proc_data->uid = uid;
-					proc_data->gid = gid;
-				}
-				else
-				{
-					zbx_free(cmdline);
-					zbx_free(user);
-					zbx_free(group);
-				}
+				proc_data->pid = entry->pid;
+				proc_data->uid = uid;
+				proc_data->gid = gid;
+			}
+			else
+			{
+				zbx_free(cmdline);
+				zbx_free(user);
+				zbx_free(group);
+			}
 
-				proc_data->name = prname;
-				proc_data->cmdline = cmdline;
-				proc_data->user = user;
-				proc_data->group = group;
+			proc_data->name = prname;
+			proc_data->cmdline = cmdline;
+			proc_data->user = user;
+			proc_data->group = group;
 
-				zbx_vector_proc_data_ptr_append(&proc_data_ctx, proc_data);
-				cmdline = prname = user = group = NULL;
-			}
+			zbx_vector_proc_data_ptr_append(&proc_data_ctx, proc_data);
+			cmdline = prname = user = group = NULL;
 		}
 	}
-	zbx_fclose(f_cmd);
-	zbx_fclose(f_status);
-	zbx_fclose(f_stat);
-	closedir(dir);
 
 	zbx_free(cmdline);
 	zbx_free(prname);
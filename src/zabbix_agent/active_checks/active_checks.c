@@ -37,6 +37,7 @@
 #include "zbx_item_constants.h"
 #include "zbxalgo.h"
 #include "zbxparam.h"
+#include "zbxip.h"
 
 #if defined(ZABBIX_SERVICE)
 #	include "zbxwinservice.h"
@@ -82,6 +83,48 @@ typedef struct
 }
 active_buffer_t;
 
+/* values taken from buffer at once, waiting to be accepted by server */
+typedef struct
+{
+	active_buffer_element_t		*data;
+	int				count;
+	zbx_vector_pre_persistent_t	prep_vec;	/* persistent files data to be written when */
+							/* the batch is accepted by server */
+}
+active_batch_t;
+
+ZBX_PTR_VECTOR_DECL(active_batch_ptr, active_batch_t *)
+ZBX_PTR_VECTOR_IMPL(active_batch_ptr, active_batch_t *)
+
+typedef enum
+{
+	ACTIVE_SENDER_STEP_IDLE = 0,
+	ACTIVE_SENDER_STEP_CONNECT_WAIT,
+	ACTIVE_SENDER_STEP_TLS_WAIT,
+	ACTIVE_SENDER_STEP_SEND,
+	ACTIVE_SENDER_STEP_RECV
+}
+active_sender_step_t;
+
+/* non-blocking sender of spooled batches, at most one request is in flight */
+typedef struct
+{
+	zbx_vector_active_batch_ptr_t	spool;		/* batches in the order they were taken from buffer */
+	int				values_num;	/* number of values in all spooled batches */
+	int				batches_num;	/* number of spooled batches in request in flight */
+	zbx_vector_command_result_ptr_t	commands;	/* command results in request in flight */
+	active_sender_step_t		step;
+	short				event;		/* socket event the request in flight waits for */
+	int				level;
+	int				addrs_tried;
+	time_t				nextsend;	/* earliest time of the next request after failure */
+	zbx_socket_t			s;
+	zbx_tcp_send_context_t		send_context;
+	zbx_tcp_recv_context_t		recv_context;
+	struct zbx_json			json;
+}
+active_sender_t;
+
 typedef struct _zbx_active_command_t zbx_active_command_t;
 ZBX_PTR_VECTOR_DECL(active_command_ptr, zbx_active_command_t *)
 struct _zbx_active_command_t
@@ -95,6 +138,7 @@ ZBX_PTR_VECTOR_DECL(active_metrics_ptr, ZBX_ACTIVE_METRIC *)
 ZBX_PTR_VECTOR_IMPL(active_metrics_ptr, ZBX_ACTIVE_METRIC *)
 
 static ZBX_THREAD_LOCAL active_buffer_t			buffer;
+static ZBX_THREAD_LOCAL active_sender_t			sender;
 static ZBX_THREAD_LOCAL	zbx_vector_command_result_ptr_t	command_results;
 static ZBX_THREAD_LOCAL zbx_vector_active_metrics_ptr_t	active_metrics;
 static ZBX_THREAD_LOCAL	zbx_vector_active_command_ptr_t	active_commands;
@@ -146,6 +190,8 @@ static void	init_active_metrics(int config_buffer_size)
 	}
 
 	zbx_vector_command_result_ptr_create(&command_results);
+	zbx_vector_active_batch_ptr_create(&sender.spool);
+	zbx_vector_command_result_ptr_create(&sender.commands);
 	zbx_vector_active_metrics_ptr_create(&active_metrics);
 	zbx_vector_active_command_ptr_create(&active_commands);
 	zbx_hashset_create(&commands_hash, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
@@ -183,6 +229,29 @@ static void	free_command_result(zbx_command_result_t *result)
 	zbx_free(result);
 }
 
+static void	free_active_batch(active_batch_t *batch)
+{
+	int			i;
+	active_buffer_element_t	*el;
+
+	for (i = 0; i < batch->count; i++)
+	{
+		el = &batch->data[i];
+
+		zbx_free(el->host);
+		zbx_free(el->key);
+		zbx_free(el->value);
+		zbx_free(el->source);
+	}
+
+	zbx_free(batch->data);
+#if !defined(_WINDOWS) && !defined(__MINGW32__)
+	zbx_clean_pre_persistent_elements(&batch->prep_vec);
+#endif
+	zbx_vector_pre_persistent_destroy(&batch->prep_vec);
+	zbx_free(batch);
+}
+
 static void	clean_command_hash(void)
 {
 	zbx_cmd_hash_t		*cmd_hash;
@@ -226,6 +295,21 @@ static void	free_active_metrics(void)
 	zbx_vector_command_result_ptr_clear_ext(&command_results, (zbx_clean_func_t)free_command_result);
 	zbx_vector_command_result_ptr_destroy(&command_results);
 
+	if (ACTIVE_SENDER_STEP_IDLE != sender.step)
+	{
+		if (ACTIVE_SENDER_STEP_RECV == sender.step)
+			zbx_tcp_recv_context_clear(&sender.recv_context);
+
+		zbx_tcp_close(&sender.s);
+		zbx_tcp_send_context_clear(&sender.send_context);
+		zbx_json_free(&sender.json);
+	}
+
+	zbx_vector_active_batch_ptr_clear_ext(&sender.spool, free_active_batch);
+	zbx_vector_active_batch_ptr_destroy(&sender.spool);
+	zbx_vector_command_result_ptr_clear_ext(&sender.commands, (zbx_clean_func_t)free_command_result);
+	zbx_vector_command_result_ptr_destroy(&sender.commands);
+
 	zbx_vector_active_command_ptr_clear_ext(&active_commands, (zbx_clean_func_t)free_command_result);
 	zbx_vector_active_command_ptr_destroy(&active_commands);
 	zbx_hashset_destroy(&commands_hash);
@@ -1049,35 +1133,14 @@ static int	check_response(const char *response)
 	return ret;
 }
 
-static int	format_metric_results(struct zbx_json *json, int now, int config_buffer_send, int config_buffer_size)
+static void	format_metric_results(struct zbx_json *json, const active_batch_t *batch)
 {
-	active_buffer_element_t	*el;
-	int			i, ret = FAIL;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
-
-	if (ZBX_HISTORY_UPLOAD_ENABLED != history_upload)
-	{
-		zabbix_log(LOG_LEVEL_DEBUG, "cannot send buffer: server has paused history upload");
-		goto ret;
-	}
-
-	if (config_buffer_size / 2 > buffer.pcount && config_buffer_size > buffer.count &&
-			config_buffer_send > now - buffer.lastsent)
-	{
-		zabbix_log(LOG_LEVEL_DEBUG, "%s() now:%d lastsent:%d now-lastsent:%d BufferSend:%d; will not send now",
-				__func__, now, buffer.lastsent, now - buffer.lastsent, config_buffer_send);
-		goto ret;
-	}
+	const active_buffer_element_t	*el;
+	int				i;
 
-	if (0 == buffer.count)
-		goto ret;
-
-	zbx_json_addarray(json, ZBX_PROTO_TAG_DATA);
-
-	for (i = 0; i < buffer.count; i++)
+	for (i = 0; i < batch->count; i++)
 	{
-		el = &buffer.data[i];
+		el = &batch->data[i];
 
 		zbx_json_addobject(json, NULL);
 		zbx_json_addstring(json, ZBX_PROTO_TAG_HOST, el->host, ZBX_JSON_TYPE_STRING);
@@ -1117,28 +1180,18 @@ static int	format_metric_results(struct zbx_json *json, int now, int config_buff
 		zbx_json_addint64(json, ZBX_PROTO_TAG_NS, el->ts.ns);
 		zbx_json_close(json);
 	}
-
-	zbx_json_close(json);
-	ret = SUCCEED;
-ret:
-	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
-
-	return ret;
 }
 
-static int	format_command_results(struct zbx_json *json)
+static void	format_command_results(struct zbx_json *json, const zbx_vector_command_result_ptr_t *results)
 {
 	int			i;
 	zbx_command_result_t	*result;
 
-	if (0 == command_results.values_num)
-		return FAIL;
-
 	zbx_json_addarray(json, ZBX_PROTO_TAG_COMMANDS);
 
-	for (i = 0; i < command_results.values_num; i++)
+	for (i = 0; i < results->values_num; i++)
 	{
-		result = (zbx_command_result_t *)command_results.values[i];
+		result = (zbx_command_result_t *)results->values[i];
 
 		if (NULL == result->value)
 			continue;
@@ -1155,38 +1208,111 @@ static int	format_command_results(struct zbx_json *json)
 	}
 
 	zbx_json_close(json);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: moves buffered values into a new batch at the end of the spool,   *
+ *          leaving buffer empty for new values                               *
+ *                                                                            *
+ * Parameters: prep_vec - [IN/OUT] data for writing into persistent files,    *
+ *                                 moved into the batch                       *
+ *             now      - [IN] current time                                   *
+ *                                                                            *
+ * Comments: Persistent files of the batch values are written only when the   *
+ *           batch is accepted by server (proxy).                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	spool_buffer(zbx_vector_pre_persistent_t *prep_vec, int now)
+{
+	active_batch_t	*batch;
+	size_t		sz = (size_t)buffer.count * sizeof(active_buffer_element_t);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() values:%d spooled:%d batches:%d", __func__, buffer.count,
+			sender.values_num, sender.spool.values_num);
 
-	return SUCCEED;
+	batch = (active_batch_t *)zbx_malloc(NULL, sizeof(active_batch_t));
+	batch->data = (active_buffer_element_t *)zbx_malloc(NULL, sz);
+	memcpy(batch->data, buffer.data, sz);
+	batch->count = buffer.count;
+
+	/* logfile processing re-creates its persistent data elements when it finds prep_vec empty */
+	batch->prep_vec = *prep_vec;
+	zbx_vector_pre_persistent_create(prep_vec);
+
+	zbx_vector_active_batch_ptr_append(&sender.spool, batch);
+	sender.values_num += batch->count;
+
+	buffer.count = 0;
+	buffer.pcount = 0;
+	buffer.lastsent = now;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
-static void	clear_metric_results(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_persistent_t *prep_vec, int now,
-		int ret)
+static const char	*get_sender_step_string(active_sender_step_t step)
 {
-	int			i;
-	active_buffer_element_t	*el;
+	switch (step)
+	{
+		case ACTIVE_SENDER_STEP_IDLE:
+			return "idle";
+		case ACTIVE_SENDER_STEP_CONNECT_WAIT:
+			return "connect";
+		case ACTIVE_SENDER_STEP_TLS_WAIT:
+			return "tls";
+		case ACTIVE_SENDER_STEP_SEND:
+			return "send";
+		case ACTIVE_SENDER_STEP_RECV:
+			return "receive";
+		default:
+			return "unknown";
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: completes request to server (proxy)                               *
+ *                                                                            *
+ * Parameters: addrs - [IN] vector with pair of Zabbix server IP or Hostname  *
+ *                          and port number                                   *
+ *             ret   - [IN] SUCCEED - request was accepted by server          *
+ *                          FAIL    - request failed                          *
+ *                                                                            *
+ * Comments: Accepted batches are removed from spool and their persistent     *
+ *           files are written, failed batches are kept to be sent again.     *
+ *                                                                            *
+ ******************************************************************************/
+static void	active_sender_finish(zbx_vector_addr_ptr_t *addrs, int ret)
+{
+	int	i, now = (int)time(NULL);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() batches:%d commands:%d ret:%s", __func__, sender.batches_num,
+			sender.commands.values_num, zbx_result_string(ret));
+
+	if (ACTIVE_SENDER_STEP_RECV == sender.step)
+		zbx_tcp_recv_context_clear(&sender.recv_context);
+
+	if (ACTIVE_SENDER_STEP_CONNECT_WAIT <= sender.step)
+		zbx_tcp_close(&sender.s);
+
+	zbx_tcp_send_context_clear(&sender.send_context);
+	zbx_json_free(&sender.json);
+	sender.step = ACTIVE_SENDER_STEP_IDLE;
 
 	if (SUCCEED == ret)
 	{
-#if !defined(_WINDOWS) && !defined(__MINGW32__)
-		zbx_write_persistent_files(prep_vec);
-		zbx_clean_pre_persistent_elements(prep_vec);
-#else
-		ZBX_UNUSED(prep_vec);
-#endif
-		/* free buffer */
-		for (i = 0; i < buffer.count; i++)
+		for (i = 0; i < sender.batches_num; i++)
 		{
-			el = &buffer.data[i];
+			active_batch_t	*batch = sender.spool.values[0];
 
-			zbx_free(el->host);
-			zbx_free(el->key);
-			zbx_free(el->value);
-			zbx_free(el->source);
+#if !defined(_WINDOWS) && !defined(__MINGW32__)
+			zbx_write_persistent_files(&batch->prep_vec);
+#endif
+			sender.values_num -= batch->count;
+			zbx_vector_active_batch_ptr_remove(&sender.spool, 0);
+			free_active_batch(batch);
 		}
-		buffer.count = 0;
-		buffer.pcount = 0;
-
-		buffer.lastsent = now;
+		zbx_vector_command_result_ptr_clear_ext(&sender.commands, free_command_result);
 
 		if (0 != buffer.first_error)
 		{
@@ -1197,17 +1323,372 @@ static void	clear_metric_results(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_pe
 	}
 	else
 	{
+		/* keep command results in the order they were produced */
+		zbx_vector_command_result_ptr_append_array(&sender.commands, command_results.values,
+				command_results.values_num);
+		zbx_vector_command_result_ptr_clear(&command_results);
+		zbx_vector_command_result_ptr_append_array(&command_results, sender.commands.values,
+				sender.commands.values_num);
+		zbx_vector_command_result_ptr_clear(&sender.commands);
+
 		if (0 == buffer.first_error)
 		{
 			zabbix_log(LOG_LEVEL_WARNING, "Active check data upload started to fail");
 			buffer.first_error = now;
 		}
+
+		sender.nextsend = now + 1;
 	}
+
+	sender.batches_num = 0;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
 
 /******************************************************************************
  *                                                                            *
- * Purpose: sends value stored in buffer to Zabbix server                     *
+ * Purpose: starts non-blocking connection to the first server (proxy)        *
+ *          address not tried yet                                             *
+ *                                                                            *
+ * Return value: SUCCEED - connection is in progress                          *
+ *               FAIL    - all addresses have failed                          *
+ *                                                                            *
+ ******************************************************************************/
+static int	active_sender_connect(zbx_vector_addr_ptr_t *addrs, int config_timeout, const char *config_source_ip)
+{
+	while (sender.addrs_tried < addrs->values_num)
+	{
+		zbx_addr_t	*addr = (zbx_addr_t *)addrs->values[0];
+
+		if (SUCCEED == zbx_socket_connect(&sender.s, SOCK_STREAM, config_source_ip, addr->ip, addr->port,
+				config_timeout))
+		{
+			sender.step = ACTIVE_SENDER_STEP_CONNECT_WAIT;
+			sender.event = POLLOUT;
+
+			return SUCCEED;
+		}
+
+		zabbix_log(sender.level, "Unable to connect to [%s]:%d [%s]", addr->ip, addr->port,
+				zbx_socket_strerror());
+
+		zbx_vector_addr_ptr_remove(addrs, 0);
+		zbx_vector_addr_ptr_append(addrs, addr);
+		sender.addrs_tried++;
+	}
+
+	return FAIL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: handles failed connection by trying the next address              *
+ *                                                                            *
+ ******************************************************************************/
+static void	active_sender_reconnect(zbx_vector_addr_ptr_t *addrs, const char *error, int config_timeout,
+		const char *config_source_ip)
+{
+	zbx_addr_t	*addr = (zbx_addr_t *)addrs->values[0];
+
+	zabbix_log(sender.level, "Unable to connect to [%s]:%d [%s]", addr->ip, addr->port, error);
+
+	zbx_tcp_close(&sender.s);
+	zbx_vector_addr_ptr_remove(addrs, 0);
+	zbx_vector_addr_ptr_append(addrs, addr);
+	sender.addrs_tried++;
+
+	if (SUCCEED != active_sender_connect(addrs, config_timeout, config_source_ip))
+	{
+		sender.step = ACTIVE_SENDER_STEP_IDLE;
+		active_sender_finish(addrs, FAIL);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: starts sending spooled batches and command results to server      *
+ *          (proxy) if sender is idle                                         *
+ *                                                                            *
+ * Comments: All batches spooled so far are sent in one request. At most one  *
+ *           request is in flight, so server receives values in the order of  *
+ *           their ids and does not discard them as already processed.        *
+ *                                                                            *
+ ******************************************************************************/
+static void	active_sender_start(zbx_vector_addr_ptr_t *addrs, int config_timeout, const char *config_source_ip)
+{
+	if (ACTIVE_SENDER_STEP_IDLE != sender.step || time(NULL) < sender.nextsend)
+		return;
+
+	sender.batches_num = (ZBX_HISTORY_UPLOAD_ENABLED == history_upload ? sender.spool.values_num : 0);
+
+	if (0 == sender.batches_num && 0 == command_results.values_num)
+		return;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() host:'%s' port:%d batches:%d values:%d commands:%d", __func__,
+			((zbx_addr_t *)addrs->values[0])->ip, ((zbx_addr_t *)addrs->values[0])->port,
+			sender.batches_num, sender.values_num, command_results.values_num);
+
+	zbx_vector_command_result_ptr_append_array(&sender.commands, command_results.values,
+			command_results.values_num);
+	zbx_vector_command_result_ptr_clear(&command_results);
+
+	zbx_json_init(&sender.json, ZBX_JSON_STAT_BUF_LEN);
+	memset(&sender.send_context, 0, sizeof(sender.send_context));
+
+	sender.level = 0 == buffer.first_error ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG;
+	sender.addrs_tried = 0;
+
+	if (SUCCEED != active_sender_connect(addrs, config_timeout, config_source_ip))
+		active_sender_finish(addrs, FAIL);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() step:'%s'", __func__, get_sender_step_string(sender.step));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: builds request from batches and command results being sent        *
+ *                                                                            *
+ * Parameters: config_timeout - [IN]                                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	active_sender_prepare(int config_timeout)
+{
+	int		i, values_num = 0;
+	zbx_timespec_t	ts;
+
+	zbx_json_addstring(&sender.json, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_VALUE_AGENT_DATA, ZBX_JSON_TYPE_STRING);
+	zbx_json_addstring(&sender.json, ZBX_PROTO_TAG_SESSION, session_token, ZBX_JSON_TYPE_STRING);
+
+	if (0 != sender.batches_num)
+	{
+		zbx_json_addarray(&sender.json, ZBX_PROTO_TAG_DATA);
+
+		for (i = 0; i < sender.batches_num; i++)
+		{
+			format_metric_results(&sender.json, sender.spool.values[i]);
+			values_num += sender.spool.values[i]->count;
+		}
+
+		zbx_json_close(&sender.json);
+	}
+
+	if (0 != sender.commands.values_num)
+		format_command_results(&sender.json, &sender.commands);
+
+	/* request clock is used by server for time correction, so it must be set right before sending */
+	zbx_timespec(&ts);
+	zbx_json_addint64(&sender.json, ZBX_PROTO_TAG_CLOCK, ts.sec);
+	zbx_json_addint64(&sender.json, ZBX_PROTO_TAG_NS, ts.ns);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "JSON before sending [%s]", sender.json.buffer);
+
+	/* connection is established, allow the same time for data transfer as blocking send did */
+	zbx_socket_set_deadline(&sender.s, MIN(MAX(values_num, 1) * config_timeout, 60));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: advances request to server (proxy) without blocking               *
+ *                                                                            *
+ * Parameters: addrs            - [IN] vector with pair of Zabbix server IP   *
+ *                                     or Hostname and port number            *
+ *             config_tls       - [IN]                                        *
+ *             config_timeout   - [IN]                                        *
+ *             config_source_ip - [IN]                                        *
+ *             revents          - [IN] socket events returned by poll or 0    *
+ *                                     if socket deadline has been reached    *
+ *                                                                            *
+ ******************************************************************************/
+static void	active_sender_process(zbx_vector_addr_ptr_t *addrs, const zbx_config_tls_t *config_tls,
+		int config_timeout, const char *config_source_ip, short revents)
+{
+	zbx_addr_t	*addr = (zbx_addr_t *)addrs->values[0];
+	int		errnum = 0;
+	socklen_t	optlen = sizeof(int);
+	short		event;
+	ssize_t		received_len;
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() step:'%s' revents:%d", __func__, get_sender_step_string(sender.step),
+			revents);
+
+	if (0 == revents)
+	{
+		switch (sender.step)
+		{
+			case ACTIVE_SENDER_STEP_CONNECT_WAIT:
+			case ACTIVE_SENDER_STEP_TLS_WAIT:
+				active_sender_reconnect(addrs, "timed out", config_timeout, config_source_ip);
+				break;
+			case ACTIVE_SENDER_STEP_SEND:
+				zabbix_log(sender.level, "Unable to send to [%s]:%d [timed out]", addr->ip, addr->port);
+				active_sender_finish(addrs, FAIL);
+				break;
+			case ACTIVE_SENDER_STEP_RECV:
+				zabbix_log(sender.level, "Unable to receive from [%s]:%d [timed out]", addr->ip,
+						addr->port);
+				active_sender_finish(addrs, FAIL);
+				break;
+			default:
+				THIS_SHOULD_NEVER_HAPPEN;
+		}
+
+		goto out;
+	}
+
+	switch (sender.step)
+	{
+		case ACTIVE_SENDER_STEP_CONNECT_WAIT:
+			if (0 == getsockopt(sender.s.socket, SOL_SOCKET, SO_ERROR, (void *)&errnum, &optlen) &&
+					0 != errnum)
+			{
+#ifdef _WINDOWS
+				active_sender_reconnect(addrs, zbx_strerror_from_system(errnum), config_timeout,
+						config_source_ip);
+#else
+				active_sender_reconnect(addrs, zbx_strerror(errnum), config_timeout, config_source_ip);
+#endif
+				break;
+			}
+
+			sender.step = ACTIVE_SENDER_STEP_TLS_WAIT;
+			ZBX_FALLTHROUGH;
+		case ACTIVE_SENDER_STEP_TLS_WAIT:
+			if (ZBX_TCP_SEC_TLS_CERT == config_tls->connect_mode ||
+					ZBX_TCP_SEC_TLS_PSK == config_tls->connect_mode)
+			{
+				const char	*tls_arg1, *tls_arg2 = NULL, *server_name = NULL;
+				char		*error = NULL;
+
+				event = 0;
+
+				if (ZBX_TCP_SEC_TLS_CERT == config_tls->connect_mode)
+				{
+					tls_arg1 = config_tls->server_cert_issuer;
+					tls_arg2 = config_tls->server_cert_subject;
+				}
+				else
+					tls_arg1 = config_tls->psk_identity;	/* zbx_tls_connect() will find PSK */
+
+				if (SUCCEED != zbx_is_ip(addr->ip))
+					server_name = addr->ip;
+
+				if (SUCCEED != zbx_socket_tls_connect(&sender.s, config_tls->connect_mode, tls_arg1,
+						tls_arg2, server_name, &event, &error))
+				{
+					if (0 != event)
+					{
+						sender.event = event;
+						break;
+					}
+
+					active_sender_reconnect(addrs, error, config_timeout, config_source_ip);
+					zbx_free(error);
+					break;
+				}
+			}
+
+			active_sender_prepare(config_timeout);
+
+			if (SUCCEED != zbx_tcp_send_context_init(sender.json.buffer, sender.json.buffer_size, 0,
+					ZBX_TCP_PROTOCOL, &sender.send_context))
+			{
+				zabbix_log(sender.level, "Unable to send to [%s]:%d [%s]", addr->ip, addr->port,
+						zbx_socket_strerror());
+				active_sender_finish(addrs, FAIL);
+				break;
+			}
+
+			sender.step = ACTIVE_SENDER_STEP_SEND;
+			ZBX_FALLTHROUGH;
+		case ACTIVE_SENDER_STEP_SEND:
+			if (SUCCEED != zbx_tcp_send_context(&sender.s, &sender.send_context, &event))
+			{
+				if (0 != event)
+				{
+					sender.event = event;
+					break;
+				}
+
+				zabbix_log(sender.level, "Unable to send to [%s]:%d [%s]", addr->ip, addr->port,
+						zbx_socket_strerror());
+				active_sender_finish(addrs, FAIL);
+				break;
+			}
+
+			sender.step = ACTIVE_SENDER_STEP_RECV;
+			sender.event = POLLIN;
+			zbx_tcp_recv_context_init(&sender.s, &sender.recv_context, 0);
+			break;
+		case ACTIVE_SENDER_STEP_RECV:
+			if (FAIL == (received_len = zbx_tcp_recv_context(&sender.s, &sender.recv_context, 0, &event)))
+			{
+				if (0 != event)
+				{
+					sender.event = event;
+					break;
+				}
+
+				zabbix_log(sender.level, "Unable to receive from [%s]:%d [%s]", addr->ip, addr->port,
+						zbx_socket_strerror());
+				active_sender_finish(addrs, FAIL);
+				break;
+			}
+
+			zabbix_log(LOG_LEVEL_DEBUG, "JSON back [%s]", ZBX_NULL2STR(sender.s.buffer));
+
+			if (0 == received_len || NULL == sender.s.buffer || SUCCEED != check_response(sender.s.buffer))
+			{
+				zabbix_log(LOG_LEVEL_DEBUG, "NOT OK");
+				active_sender_finish(addrs, FAIL);
+				break;
+			}
+
+			zabbix_log(LOG_LEVEL_DEBUG, "OK");
+			active_sender_finish(addrs, SUCCEED);
+			break;
+		default:
+			THIS_SHOULD_NEVER_HAPPEN;
+	}
+out:
+	zabbix_log(LOG_LEVEL_DEBUG, "End of %s() step:'%s'", __func__, get_sender_step_string(sender.step));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: waits for socket events of request in flight and processes them   *
+ *                                                                            *
+ * Parameters: addrs            - [IN] vector with pair of Zabbix server IP   *
+ *                                     or Hostname and port number            *
+ *             config_tls       - [IN]                                        *
+ *             config_timeout   - [IN]                                        *
+ *             config_source_ip - [IN]                                        *
+ *             timeout_ms       - [IN] maximum time to wait in milliseconds   *
+ *                                                                            *
+ ******************************************************************************/
+static void	active_sender_poll(zbx_vector_addr_ptr_t *addrs, const zbx_config_tls_t *config_tls,
+		int config_timeout, const char *config_source_ip, int timeout_ms)
+{
+	zbx_pollfd_t	pd;
+
+	if (ACTIVE_SENDER_STEP_IDLE == sender.step)
+		return;
+
+	pd.fd = sender.s.socket;
+	pd.events = sender.event;
+	pd.revents = 0;
+
+	if (0 < zbx_socket_poll(&pd, 1, timeout_ms) && 0 != pd.revents)
+	{
+		active_sender_process(addrs, config_tls, config_timeout, config_source_ip, pd.revents);
+	}
+	else if (SUCCEED != zbx_socket_check_deadline(&sender.s))
+		active_sender_process(addrs, config_tls, config_timeout, config_source_ip, 0);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: spools values stored in buffer and sends them to Zabbix server    *
+ *          without waiting for the reply                                     *
  *                                                                            *
  * Parameters:                                                                *
  *   addrs              - [IN] vector with pair of Zabbix server IP or        *
@@ -1223,85 +1704,60 @@ static void	clear_metric_results(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_pe
  * Return value: SUCCEED if:                                                  *
  *                    - no need to send data now (buffer empty or has enough  *
  *                      free elements, or recently sent)                      *
- *                    - data successfully sent to server (proxy)              *
- *               FAIL - error when sending data                               *
+ *                    - data moved from buffer to spool                       *
+ *               FAIL - spool is full, data left in buffer                    *
+ *                                                                            *
+ * Comments: Spool holds at most config_buffer_size values. When both buffer  *
+ *           and spool are full this function waits for the request in        *
+ *           flight to complete, the same as blocking send used to.           *
  *                                                                            *
  ******************************************************************************/
 static int	send_buffer(zbx_vector_addr_ptr_t *addrs, zbx_vector_pre_persistent_t *prep_vec,
 		const zbx_config_tls_t *config_tls, int config_timeout, const char *config_source_ip,
 		int config_buffer_send, int config_buffer_size)
 {
-	int			ret = SUCCEED, ret_metrics, ret_commands, now, level;
-	zbx_timespec_t		ts;
-	zbx_socket_t		s;
-	struct zbx_json		json;
-
-	zabbix_log(LOG_LEVEL_DEBUG, "In %s() host:'%s' port:%d entries:%d/%d",
-			__func__, ((zbx_addr_t *)addrs->values[0])->ip, ((zbx_addr_t *)addrs->values[0])->port,
-			buffer.count, config_buffer_size);
+	int	ret = SUCCEED, now;
 
-	now = (int)time(NULL);
-
-	zbx_json_init(&json, ZBX_JSON_STAT_BUF_LEN);
-	zbx_json_addstring(&json, ZBX_PROTO_TAG_REQUEST, ZBX_PROTO_VALUE_AGENT_DATA, ZBX_JSON_TYPE_STRING);
-	zbx_json_addstring(&json, ZBX_PROTO_TAG_SESSION, session_token, ZBX_JSON_TYPE_STRING);
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() host:'%s' port:%d entries:%d/%d spooled:%d", __func__,
+			((zbx_addr_t *)addrs->values[0])->ip, ((zbx_addr_t *)addrs->values[0])->port, buffer.count,
+			config_buffer_size, sender.values_num);
 
-	ret_metrics = format_metric_results(&json, now, config_buffer_send, config_buffer_size);
-	ret_commands = format_command_results(&json);
+	active_sender_poll(addrs, config_tls, config_timeout, config_source_ip, 0);
 
-	if (FAIL == ret_metrics && FAIL == ret_commands)
-		goto ret;
-
-	level = 0 == buffer.first_error ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG;
+	now = (int)time(NULL);
 
-	if (SUCCEED == (ret = zbx_connect_to_server(&s, config_source_ip, addrs, MIN(buffer.count * config_timeout, 60),
-			config_timeout, 0, level, config_tls)))
+	if (ZBX_HISTORY_UPLOAD_ENABLED != history_upload)
 	{
-		zbx_timespec(&ts);
-		zbx_json_addint64(&json, ZBX_PROTO_TAG_CLOCK, ts.sec);
-		zbx_json_addint64(&json, ZBX_PROTO_TAG_NS, ts.ns);
-
-		zabbix_log(LOG_LEVEL_DEBUG, "JSON before sending [%s]", json.buffer);
+		zabbix_log(LOG_LEVEL_DEBUG, "cannot send buffer: server has paused history upload");
+	}
+	else if (0 != buffer.count)
+	{
+		int	full = (config_buffer_size / 2 <= buffer.pcount || config_buffer_size <= buffer.count);
 
-		if (SUCCEED == (ret = zbx_tcp_send(&s, json.buffer)))
+		if (0 == full && config_buffer_send > now - buffer.lastsent)
 		{
-			if (SUCCEED == (ret = zbx_tcp_recv(&s)))
-			{
-				zabbix_log(LOG_LEVEL_DEBUG, "JSON back [%s]", s.buffer);
-
-				if (NULL == s.buffer || SUCCEED != check_response(s.buffer))
-				{
-					ret = FAIL;
-					zabbix_log(LOG_LEVEL_DEBUG, "NOT OK");
-				}
-				else
-					zabbix_log(LOG_LEVEL_DEBUG, "OK");
-			}
-			else
-			{
-				zabbix_log(level, "Unable to receive from [%s]:%d [%s]",
-						((zbx_addr_t *)addrs->values[0])->ip,
-						((zbx_addr_t *)addrs->values[0])->port,
-						zbx_socket_strerror());
-			}
+			zabbix_log(LOG_LEVEL_DEBUG, "%s() now:%d lastsent:%d now-lastsent:%d BufferSend:%d;"
+					" will not send now", __func__, now, buffer.lastsent, now - buffer.lastsent,
+					config_buffer_send);
 		}
 		else
 		{
-			zabbix_log(level, "Unable to send to [%s]:%d [%s]",
-					((zbx_addr_t *)addrs->values[0])->ip, ((zbx_addr_t *)addrs->values[0])->port,
-					zbx_socket_strerror());
-		}
+			/* values cannot be kept any longer, wait for spool to be freed by request in flight */
+			while (0 != full && config_buffer_size < sender.values_num + buffer.count &&
+					ACTIVE_SENDER_STEP_IDLE != sender.step)
+			{
+				active_sender_poll(addrs, config_tls, config_timeout, config_source_ip, 1000);
+			}
 
-		zbx_tcp_close(&s);
+			if (config_buffer_size >= sender.values_num + buffer.count)
+				spool_buffer(prep_vec, (int)time(NULL));
+			else
+				ret = FAIL;
+		}
 	}
 
-	if (SUCCEED == ret_metrics)
-		clear_metric_results(addrs, prep_vec, now, ret);
+	active_sender_start(addrs, config_timeout, config_source_ip);
 
-	if (SUCCEED == ret && SUCCEED == ret_commands)
-		zbx_vector_command_result_ptr_clear_ext(&command_results, free_command_result);
-ret:
-	zbx_json_free(&json);
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s", __func__, zbx_result_string(ret));
 
 	return ret;
@@ -1846,6 +2302,7 @@ static void	update_schedule(int delta)
 	}
 
 	buffer.lastsent += delta;
+	sender.nextsend += delta;
 }
 
 #ifndef _WINDOWS
@@ -2042,8 +2499,18 @@ ZBX_THREAD_ENTRY(active_checks_thread, args)
 					heartbeat_nextcheck += delta;
 			}
 
-			zbx_setproctitle("active checks #%d [idle 1 sec]", process_num);
-			zbx_sleep(1);
+			if (ACTIVE_SENDER_STEP_IDLE != sender.step)
+			{
+				zbx_setproctitle("active checks #%d [sending data]", process_num);
+				active_sender_poll(&activechk_args.addrs, activechks_args_in->zbx_config_tls,
+						activechks_args_in->config_timeout,
+						activechks_args_in->config_source_ip, 1000);
+			}
+			else
+			{
+				zbx_setproctitle("active checks #%d [idle 1 sec]", process_num);
+				zbx_sleep(1);
+			}
 		}
 
 		lastcheck = now;
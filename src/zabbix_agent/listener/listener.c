@@ -37,69 +37,239 @@
 static volatile sig_atomic_t	need_update_userparam;
 #endif
 
-static void	process_listener(zbx_socket_t *s, int config_timeout)
+/* the time to wait for the next request on the same connection, */
+/* reported to server in the reserved field of response header   */
+#define LISTENER_KEEPALIVE	5
+
+/* the maximum number of idle connections kept open by a listener */
+#define LISTENER_IDLE_MAX	16
+
+/* connection waiting for the next request */
+typedef struct
+{
+	zbx_socket_t	s;
+	time_t		expires;
+}
+listener_conn_t;
+
+typedef struct
+{
+	listener_conn_t	*conns[LISTENER_IDLE_MAX];
+	int		num;
+}
+listener_idle_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process request and send response                                 *
+ *                                                                            *
+ * Parameters: s              - [IN] the connection                           *
+ *             config_timeout - [IN]                                          *
+ *             keepalive      - [IN] the number of seconds the connection is  *
+ *                                   kept open after response, 0 if it is     *
+ *                                   closed                                   *
+ *                                                                            *
+ ******************************************************************************/
+static int	process_request(zbx_socket_t *s, int config_timeout, int keepalive)
 {
 	AGENT_RESULT	result;
 	char		**value = NULL;
-	int		ret;
+	int		ret = SUCCEED;
+	zbx_uint32_t	timeout;
 
-	if (SUCCEED == (ret = zbx_tcp_recv_to(s, config_timeout)))
-	{
-		zbx_uint32_t	timeout;
+	zbx_rtrim(s->buffer, "\r\n");
 
-		zbx_rtrim(s->buffer, "\r\n");
+	zabbix_log(LOG_LEVEL_DEBUG, "Requested [%s]", s->buffer);
 
-		zabbix_log(LOG_LEVEL_DEBUG, "Requested [%s]", s->buffer);
+	if (0 != s->reserved_payload)
+		timeout = s->reserved_payload;
+	else
+		timeout = (zbx_uint32_t)config_timeout;
 
-		if (0 != s->reserved_payload)
-			timeout = s->reserved_payload;
-		else
-			timeout = (zbx_uint32_t)config_timeout;
+	zbx_init_agent_result(&result);
 
-		zbx_init_agent_result(&result);
+	if (SUCCEED == zbx_execute_agent_check(s->buffer, ZBX_PROCESS_WITH_ALIAS, &result, (int)timeout))
+	{
+		if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
+		{
+			zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", *value);
+			ret = zbx_tcp_send_ext(s, *value, strlen(*value), (size_t)keepalive,
+					ZBX_TCP_PROTOCOL, config_timeout);
+		}
+	}
+	else
+	{
+		value = ZBX_GET_MSG_RESULT(&result);
 
-		if (SUCCEED == zbx_execute_agent_check(s->buffer, ZBX_PROCESS_WITH_ALIAS, &result, (int)timeout))
+		if (NULL != value)
 		{
-			if (NULL != (value = ZBX_GET_TEXT_RESULT(&result)))
-			{
-				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [%s]", *value);
-				ret = zbx_tcp_send_to(s, *value, config_timeout);
-			}
+			static char	*buffer = NULL;
+			static size_t	buffer_alloc = 256;
+			size_t		buffer_offset = 0;
+
+			zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED ": %s]", *value);
+
+			if (NULL == buffer)
+				buffer = (char *)zbx_malloc(buffer, buffer_alloc);
+
+			zbx_strncpy_alloc(&buffer, &buffer_alloc, &buffer_offset,
+					ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED));
+			buffer_offset++;
+			zbx_strcpy_alloc(&buffer, &buffer_alloc, &buffer_offset, *value);
+
+			ret = zbx_tcp_send_ext(s, buffer, buffer_offset, (size_t)keepalive,
+					ZBX_TCP_PROTOCOL, config_timeout);
 		}
 		else
 		{
-			value = ZBX_GET_MSG_RESULT(&result);
+			zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED "]");
+			ret = zbx_tcp_send_ext(s, ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED),
+					(size_t)keepalive, ZBX_TCP_PROTOCOL, config_timeout);
+		}
+	}
 
-			if (NULL != value)
-			{
-				static char	*buffer = NULL;
-				static size_t	buffer_alloc = 256;
-				size_t		buffer_offset = 0;
+	zbx_free_agent_result(&result);
 
-				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED ": %s]", *value);
+	return ret;
+}
 
-				if (NULL == buffer)
-					buffer = (char *)zbx_malloc(buffer, buffer_alloc);
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process request received over new connection                      *
+ *                                                                            *
+ ******************************************************************************/
+static int	process_listener(zbx_socket_t *s, int config_timeout, int keepalive)
+{
+	int	ret;
 
-				zbx_strncpy_alloc(&buffer, &buffer_alloc, &buffer_offset,
-						ZBX_NOTSUPPORTED, ZBX_CONST_STRLEN(ZBX_NOTSUPPORTED));
-				buffer_offset++;
-				zbx_strcpy_alloc(&buffer, &buffer_alloc, &buffer_offset, *value);
+	if (SUCCEED == (ret = zbx_tcp_recv_to(s, config_timeout)))
+		ret = process_request(s, config_timeout, keepalive);
 
-				ret = zbx_tcp_send_bytes_to(s, buffer, buffer_offset, config_timeout);
-			}
-			else
-			{
-				zabbix_log(LOG_LEVEL_DEBUG, "Sending back [" ZBX_NOTSUPPORTED "]");
-				ret = zbx_tcp_send_to(s, ZBX_NOTSUPPORTED, config_timeout);
-			}
-		}
+	if (FAIL == ret)
+		zabbix_log(LOG_LEVEL_DEBUG, "Process listener error: %s", zbx_socket_strerror());
+
+	return ret;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: keep accepted connection open for the next request                *
+ *                                                                            *
+ * Parameters: idle - [IN/OUT] idle connections                               *
+ *             s    - [IN/OUT] listening socket with accepted connection, the *
+ *                             connection is moved to idle connections        *
+ *                                                                            *
+ ******************************************************************************/
+static void	listener_idle_add(listener_idle_t *idle, zbx_socket_t *s)
+{
+	listener_conn_t	*conn;
+
+	conn = (listener_conn_t *)zbx_malloc(NULL, sizeof(listener_conn_t));
+	memcpy(&conn->s, s, sizeof(zbx_socket_t));
+
+	if (ZBX_BUF_TYPE_STAT == conn->s.buf_type)
+		conn->s.buffer = conn->s.buf_stat;
+
+	conn->expires = time(NULL) + LISTENER_KEEPALIVE;
+	idle->conns[idle->num++] = conn;
+
+	/* the listening socket no longer owns the connection */
+	s->socket = s->socket_orig;
+	s->accepted = 0;
+	s->buf_type = ZBX_BUF_TYPE_STAT;
+	s->buffer = s->buf_stat;
+#if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
+	s->tls_ctx = NULL;
+#endif
+}
 
-		zbx_free_agent_result(&result);
+static void	listener_idle_remove(listener_idle_t *idle, int index)
+{
+	zbx_tcp_unaccept(&idle->conns[index]->s);
+	zbx_free(idle->conns[index]);
+
+	idle->conns[index] = idle->conns[--idle->num];
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process the next request received over idle connection            *
+ *                                                                            *
+ * Comments: The connection is closed when client closes it or on error.      *
+ *                                                                            *
+ ******************************************************************************/
+static void	listener_idle_process(listener_idle_t *idle, int index, int config_timeout)
+{
+	listener_conn_t	*conn = idle->conns[index];
+
+	if (0 >= zbx_tcp_recv_ext(&conn->s, config_timeout, 0) ||
+			SUCCEED != process_request(&conn->s, config_timeout, LISTENER_KEEPALIVE))
+	{
+		listener_idle_remove(idle, index);
+		return;
 	}
 
-	if (FAIL == ret)
-		zabbix_log(LOG_LEVEL_DEBUG, "Process listener error: %s", zbx_socket_strerror());
+	conn->expires = time(NULL) + LISTENER_KEEPALIVE;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: wait for new connection or for request over idle connection       *
+ *                                                                            *
+ * Parameters: s            - [IN] listening socket                           *
+ *             idle         - [IN/OUT] idle connections, expired connections  *
+ *                                     are closed                             *
+ *             poll_timeout - [IN] seconds to wait                            *
+ *                                                                            *
+ * Return value: index of idle connection with pending request,               *
+ *               ZBX_LISTENER_ACCEPT - new connection is pending,             *
+ *               ZBX_LISTENER_IDLE   - nothing happened                       *
+ *                                                                            *
+ * Comments: Idle connections are polled together with listening socket, so   *
+ *           kept connections do not prevent listener from accepting new      *
+ *           connections.                                                     *
+ *                                                                            *
+ ******************************************************************************/
+#define ZBX_LISTENER_ACCEPT	-1
+#define ZBX_LISTENER_IDLE	-2
+static int	listener_wait(zbx_socket_t *s, listener_idle_t *idle, int poll_timeout)
+{
+	zbx_pollfd_t	pds[ZBX_SOCKET_COUNT + LISTENER_IDLE_MAX];
+	int		i, rc, pds_num = 0;
+	time_t		now = time(NULL);
+
+	for (i = 0; i < idle->num;)
+	{
+		if (idle->conns[i]->expires <= now)
+			listener_idle_remove(idle, i);
+		else
+			i++;
+	}
+
+	for (i = 0; i < s->num_socks; i++, pds_num++)
+	{
+		pds[pds_num].fd = s->sockets[i];
+		pds[pds_num].events = POLLIN;
+		pds[pds_num].revents = 0;
+	}
+
+	for (i = 0; i < idle->num; i++, pds_num++)
+	{
+		pds[pds_num].fd = idle->conns[i]->s.socket;
+		pds[pds_num].events = POLLIN;
+		pds[pds_num].revents = 0;
+	}
+
+	if (0 >= (rc = zbx_socket_poll(pds, (unsigned long)pds_num, poll_timeout * 1000)))
+		return ZBX_LISTENER_IDLE;
+
+	for (i = 0; i < idle->num; i++)
+	{
+		if (0 != pds[s->num_socks + i].revents)
+			return i;
+	}
+
+	return ZBX_LISTENER_ACCEPT;
 }
 
 #ifndef _WINDOWS
@@ -117,10 +287,11 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 	char				*msg = NULL;
 #endif
 	zbx_socket_t			s;
+	listener_idle_t			idle;
 	zbx_thread_listener_args	*init_child_args_in;
 	zbx_thread_info_t		*info = &((zbx_thread_args_t *)args)->info;
 	unsigned char			process_type = ((zbx_thread_args_t *)args)->info.process_type;
-	int				ret, server_num = ((zbx_thread_args_t *)args)->info.server_num,
+	int				ret, index, server_num = ((zbx_thread_args_t *)args)->info.server_num,
 					process_num = ((zbx_thread_args_t *)args)->info.process_num;
 
 	init_child_args_in = (zbx_thread_listener_args *)((((zbx_thread_args_t *)args))->args);
@@ -129,6 +300,7 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 			server_num, get_process_type_string(process_type), process_num);
 
 	memcpy(&s, init_child_args_in->listen_sock, sizeof(zbx_socket_t));
+	idle.num = 0;
 
 	zbx_free(args);
 
@@ -153,9 +325,22 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 #endif
 
 		zbx_setproctitle("listener #%d [waiting for connection]", process_num);
-		ret = zbx_tcp_accept(&s, init_child_args_in->zbx_config_tls->accept_modes, POLL_TIMEOUT);
+		index = listener_wait(&s, &idle, POLL_TIMEOUT);
 		zbx_update_env(get_process_type_string(process_type), zbx_time());
 
+		if (ZBX_LISTENER_IDLE == index)
+			continue;
+
+		if (ZBX_LISTENER_ACCEPT != index)
+		{
+			zbx_setproctitle("listener #%d [processing request]", process_num);
+			listener_idle_process(&idle, index, init_child_args_in->config_timeout);
+			continue;
+		}
+
+		/* the connection might have been accepted by another listener */
+		ret = zbx_tcp_accept(&s, init_child_args_in->zbx_config_tls->accept_modes, 0);
+
 		if (TIMEOUT_ERROR == ret)
 			continue;
 
@@ -175,7 +360,13 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 						&msg)))
 #endif
 				{
-					process_listener(&s, init_child_args_in->config_timeout);
+					int	keepalive = LISTENER_IDLE_MAX > idle.num ? LISTENER_KEEPALIVE : 0;
+
+					if (SUCCEED == process_listener(&s, init_child_args_in->config_timeout,
+							keepalive) && 0 != keepalive)
+					{
+						listener_idle_add(&idle, &s);
+					}
 				}
 			}
 
@@ -202,6 +393,9 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 			zbx_sleep(1);
 	}
 
+	while (0 < idle.num)
+		listener_idle_remove(&idle, 0);
+
 #ifdef _WINDOWS
 	ZBX_DO_EXIT();
 
@@ -214,3 +408,8 @@ ZBX_THREAD_ENTRY(listener_thread, args)
 #endif
 #undef POLL_TIMEOUT
 }
+
+#undef ZBX_LISTENER_ACCEPT
+#undef ZBX_LISTENER_IDLE
+#undef LISTENER_IDLE_MAX
+#undef LISTENER_KEEPALIVE
@@ -1955,6 +1955,10 @@ clean:
 	return	ret;
 }
 
+/* check if any byte of 64-bit word is zero */
+#define WORD_ONES		(~(zbx_uint64_t)0 / 0xff)
+#define WORD_HAS_ZERO(word)	(((word) - WORD_ONES) & ~(word) & (WORD_ONES << 7))
+
 static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const char *cr, const char *lf,
 		size_t szbyte)
 {
@@ -1962,6 +1966,23 @@ static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const c
 	{
 		for (; p < p_end; p++)
 		{
+			zbx_uint64_t	word;
+
+			/* skip 8 bytes at a time while there are no NULL, LF and CR bytes */
+			for (; p + sizeof(word) <= p_end; p += sizeof(word))
+			{
+				memcpy(&word, p, sizeof(word));
+
+				if (0 != (WORD_HAS_ZERO(word) | WORD_HAS_ZERO(word ^ (WORD_ONES * 0xa)) |
+						WORD_HAS_ZERO(word ^ (WORD_ONES * 0xd))))
+				{
+					break;
+				}
+			}
+
+			if (p >= p_end)
+				break;
+
 			/* detect NULL byte and replace it with '?' character */
 			if (0x0 == *p)
 			{
@@ -2030,6 +2051,9 @@ static char	*buf_find_newline(char *p, char **p_next, const char *p_end, const c
 	}
 }
 
+#undef WORD_ONES
+#undef WORD_HAS_ZERO
+
 static void	log_regexp_runtime_error(const char *key, const char *err_msg, zbx_uint64_t itemid,
 		int *runtime_error_logging_allowed)
 {
@@ -2047,6 +2071,21 @@ static void	log_regexp_runtime_error(const char *key, const char *err_msg, zbx_u
 		zabbix_log(LOG_LEVEL_WARNING, "itemid " ZBX_FS_UI64 ": regexp runtime error: %s", itemid, err_msg);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: match log record against regular expression, rejecting records    *
+ *          without the literal part of expression by substring search        *
+ *                                                                            *
+ ******************************************************************************/
+static int	log_regexp_sub(zbx_vector_expression_t *regexps, const char *value, const char *pattern,
+		const char *literal, const char *output_template, char **output, char **err_msg)
+{
+	if (NULL != literal && NULL == strstr(value, literal))
+		return ZBX_REGEXP_NO_MATCH;
+
+	return zbx_regexp_sub_ex2(regexps, value, pattern, ZBX_CASE_SENSITIVE, output_template, output, err_msg);
+}
+
 /******************************************************************************
  *                                                                            *
  * Comments: Thread-safe                                                      *
@@ -2065,8 +2104,8 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 
 	int				ret, nbytes;
 	const char			*cr, *lf, *p_end;
-	char				*p_start, *p, *p_nl, *p_next, *item_value = NULL;
-	size_t				szbyte;
+	char				*p_start, *p, *p_nl, *p_next, *item_value = NULL, *literal = NULL;
+	size_t				szbyte, tail = 0;
 	zbx_offset_t			offset;
 	const int			is_count_item = (0 != (ZBX_METRIC_FLAG_LOG_COUNT & flags)) ? 1 : 0;
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
@@ -2087,6 +2126,21 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 
 	zbx_find_cr_lf_szbyte(encoding, &cr, &lf, &szbyte);
 
+	/* offset of the buffer beginning, the file position is tracked from here on to avoid system calls */
+	if ((zbx_offset_t)-1 == (offset = zbx_lseek(fd, 0, SEEK_CUR)))
+	{
+		*big_rec = 0;
+		*err_msg = zbx_dsprintf(*err_msg, "Cannot set position to 0 in file: %s", zbx_strerror(errno));
+		ret = FAIL;
+		goto out;
+	}
+#if defined(POSIX_FADV_SEQUENTIAL)
+	/* the file is read till the end, let the kernel read ahead more aggressively */
+	(void)posix_fadvise(fd, (off_t)offset, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+	if (NULL != pattern && '\0' != *pattern && '@' != *pattern)
+		literal = zbx_regexp_get_literal(pattern);
+
 	for (;;)
 	{
 		if (0 >= *p_count || 0 >= *s_count)
@@ -2096,15 +2150,8 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 			goto out;
 		}
 
-		if ((zbx_offset_t)-1 == (offset = zbx_lseek(fd, 0, SEEK_CUR)))
-		{
-			*big_rec = 0;
-			*err_msg = zbx_dsprintf(*err_msg, "Cannot set position to 0 in file: %s", zbx_strerror(errno));
-			ret = FAIL;
-			goto out;
-		}
-
-		if (-1 == (nbytes = (int)read(fd, buf, (size_t)BUF_SIZE)))
+		/* an incomplete record left from the previous read is already at the beginning of buffer */
+		if (-1 == (nbytes = (int)read(fd, buf + tail, (size_t)BUF_SIZE - tail)))
 		{
 			/* error on read */
 			*big_rec = 0;
@@ -2113,6 +2160,9 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 			goto out;
 		}
 
+		nbytes += (int)tail;
+		tail = 0;
+
 		if (0 == nbytes)
 		{
 			/* end of file reached */
@@ -2174,7 +2224,7 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 					processed_size = (size_t)offset + (size_t)nbytes;
 					send_err = FAIL;
 
-					regexp_ret = zbx_regexp_sub_ex2(regexps, value, pattern, ZBX_CASE_SENSITIVE,
+					regexp_ret = log_regexp_sub(regexps, value, pattern, literal,
 							(0 == is_count_item) ? output_template : NULL,
 							(0 == is_count_item) ? &item_value : NULL, err_msg);
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
@@ -2272,6 +2322,8 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 					/* checked the first part against the regexp. */
 					*lastlogsize = (size_t)offset + (size_t)nbytes;
 				}
+
+				offset += nbytes;
 			}
 		}
 		else
@@ -2311,7 +2363,7 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 					processed_size = (size_t)offset + (size_t)(p_next - buf);
 					send_err = FAIL;
 
-					regexp_ret = zbx_regexp_sub_ex2(regexps, value, pattern, ZBX_CASE_SENSITIVE,
+					regexp_ret = log_regexp_sub(regexps, value, pattern, literal,
 							(0 == is_count_item) ? output_template : NULL,
 							(0 == is_count_item) ? &item_value : NULL, err_msg);
 #if !defined(_WINDOWS) && !defined(__MINGW32__)
@@ -2412,20 +2464,15 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 
 				if (NULL == (p_nl = buf_find_newline(p, &p_next, p_end, cr, lf, szbyte)))
 				{
-					/* There are no complete records in the buffer. */
-					/* Try to read more data from this position if available. */
+					/* There are no complete records in the buffer. Move the rest */
+					/* to the beginning of buffer and read more data after it. */
 					if (p_end > p)
 						logfile->incomplete = 1;
 
-					if ((zbx_offset_t)-1 == zbx_lseek(fd, *lastlogsize, SEEK_SET))
-					{
-						*err_msg = zbx_dsprintf(*err_msg, "Cannot set position to " ZBX_FS_UI64
-								" in file: %s", *lastlogsize, zbx_strerror(errno));
-						ret = FAIL;
-						goto out;
-					}
-					else
-						break;
+					tail = (size_t)(p_end - p_start);
+					memmove(buf, p_start, tail);
+					offset += p_start - buf;
+					break;
 				}
 				else
 					logfile->incomplete = 0;
@@ -2433,6 +2480,8 @@ static int	zbx_read2(int fd, unsigned char flags, struct st_logfile *logfile, zb
 		}
 	}
 out:
+	zbx_free(literal);
+
 	return ret;
 
 #undef BUF_SIZE
@@ -56,6 +56,7 @@ static char	**config_aliases = NULL;
 static char	**config_load_module = NULL;
 static char	**zbx_config_user_parameters = NULL;
 static char	*config_user_parameter_dir = NULL;
+static int	config_proc_cache_ttl = 0;
 #if defined(_WINDOWS)
 static char	**config_perf_counters = NULL;
 static char	**config_perf_counters_en = NULL;
@@ -950,6 +951,8 @@ static void	zbx_load_config(int requirement, ZBX_TASK_EX *task)
 			PARM_OPT,	0,			1},
 		{"User",			&config_user,				TYPE_STRING,
 			PARM_OPT,	0,			0},
+		{"ProcCacheTTL",		&config_proc_cache_ttl,			TYPE_INT,
+			PARM_OPT,	0,			SEC_PER_MIN},
 #endif
 #ifdef _WINDOWS
 		{"PerfCounter",			&config_perf_counters,			TYPE_MULTISTRING,
@@ -1641,6 +1644,7 @@ int	main(int argc, char **argv)
 		default:
 			zbx_load_config(ZBX_CFG_FILE_REQUIRED, &t);
 			zbx_set_user_parameter_dir(config_user_parameter_dir);
+			zbx_set_proc_cache_ttl(config_proc_cache_ttl);
 			load_aliases(config_aliases);
 #ifdef _WINDOWS
 			if (0 == (t.flags & ZBX_TASK_FLAG_FOREGROUND))
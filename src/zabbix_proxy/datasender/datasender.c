@@ -83,6 +83,8 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, const z
 		zbx_thread_datasender_args *args)
 {
 	static int		data_timestamp = 0, task_timestamp = 0, upload_state = SUCCEED;
+	/* compression codec negotiated with server by the previous exchange */
+	static unsigned char	compress_flags = ZBX_TCP_COMPRESS;
 
 	zbx_socket_t		sock;
 	struct zbx_json		j;
@@ -174,7 +176,10 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, const z
 		if (0 != (flags & ZBX_DATASENDER_HISTORY) && 0 != (proxy_delay = zbx_proxy_get_delay(history_lastid)))
 			zbx_json_adduint64(&j, ZBX_PROTO_TAG_PROXY_DELAY, proxy_delay);
 
-		if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+		zbx_add_compress_codecs(&j);
+
+		if (SUCCEED != zbx_compress_ext(zbx_tcp_compress_codec(compress_flags), j.buffer, j.buffer_size,
+				&buffer, &buffer_size))
 		{
 			zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 			goto clean;
@@ -199,11 +204,13 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, const z
 
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
-		upload_state = zbx_put_data_to_server(&sock, &buffer, buffer_size, reserved, &error);
+		upload_state = zbx_put_data_to_server(&sock, &buffer, buffer_size, reserved, compress_flags, &error);
 		get_hist_upload_state(sock.buffer, hist_upload_state);
 
 		if (SUCCEED != upload_state)
 		{
+			/* fall back to zlib in case server does not support the negotiated codec anymore */
+			compress_flags = ZBX_TCP_COMPRESS;
 			*more = ZBX_PROXY_DATA_DONE;
 			if (ZBX_PROXY_UPLOAD_DISABLED != *hist_upload_state)
 			{
@@ -221,7 +228,11 @@ static int	proxy_data_sender(int *more, int now, int *hist_upload_state, const z
 			{
 				if (SUCCEED == zbx_json_brackets_by_name(&jp, ZBX_PROTO_TAG_TASKS, &jp_tasks))
 					flags |= ZBX_DATASENDER_TASKS_RECV;
+
+				compress_flags = zbx_get_compress_flags(&jp);
 			}
+			else
+				compress_flags = ZBX_TCP_COMPRESS;
 
 			if (0 != (flags & ZBX_DATASENDER_DB_UPDATE))
 			{
@@ -270,6 +281,8 @@ clean:
 	zbx_json_free(&j);
 	zbx_free(buffer);
 
+	zbx_dc_flush_compress_stats();
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s():%s more:%d flags:0x" ZBX_FS_UX64, __func__,
 			zbx_result_string(upload_state), *more, flags);
 
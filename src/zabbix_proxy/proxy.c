@@ -102,7 +102,7 @@ static const char	*help_message[] = {
 	"                                   target is not specified",
 	"      " ZBX_SNMP_CACHE_RELOAD "          Reload SNMP cache",
 	"      " ZBX_DIAGINFO "=section           Log internal diagnostic information of the",
-	"                                 section (historycache, preprocessing, locks) or",
+	"                                 section (historycache, preprocessing, locks, pollers) or",
 	"                                 everything if section is not specified",
 	"      " ZBX_PROF_ENABLE "=target         Enable profiling, affects all processes if",
 	"                                   target is not specified",
@@ -55,6 +55,7 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_VERSION, ZABBIX_VERSION, ZBX_JSON_TYPE_STRING);
 	zbx_json_addstring(&j, ZBX_PROTO_TAG_SESSION, zbx_dc_get_session_token(), ZBX_JSON_TYPE_STRING);
 	zbx_json_adduint64(&j, ZBX_PROTO_TAG_CONFIG_REVISION, zbx_dc_get_received_revision());
+	zbx_add_compress_codecs(&j);
 
 	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
@@ -77,7 +78,7 @@ static void	process_configuration_sync(size_t *data_size, zbx_synced_new_config_
 #undef CONFIG_PROXYCONFIG_RETRY
 	zbx_update_selfmon_counter(thread_info, ZBX_PROCESS_STATE_BUSY);
 
-	if (SUCCEED != zbx_get_data_from_server(&sock, &buffer, buffer_size, reserved, &error))
+	if (SUCCEED != zbx_get_data_from_server(&sock, &buffer, buffer_size, reserved, ZBX_TCP_COMPRESS, &error))
 	{
 		zabbix_log(LOG_LEVEL_WARNING, "cannot obtain configuration data from server at \"%s\": %s",
 				sock.peer, error);
@@ -150,6 +151,7 @@ out:
 	zbx_free(error);
 	zbx_free(buffer);
 	zbx_json_free(&j);
+	zbx_dc_flush_compress_stats();
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 }
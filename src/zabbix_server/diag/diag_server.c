@@ -545,6 +545,11 @@ int	diag_add_section_info(const char *section, const struct zbx_json_parse *jp,
 		zbx_diag_add_locks_info(json);
 		ret = SUCCEED;
 	}
+	else if (0 == strcmp(section, ZBX_DIAG_POLLERS))
+	{
+		zbx_diag_add_pollers_info(json);
+		ret = SUCCEED;
+	}
 	else if (0 == strcmp(section, ZBX_DIAG_CONNECTOR))
 		ret = zbx_diag_add_connector_info(jp, json, error);
 	else
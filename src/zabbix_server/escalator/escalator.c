@@ -102,6 +102,28 @@ typedef struct
 }
 zbx_service_role_t;
 
+/* escalation scheduled in escalator process memory */
+typedef struct
+{
+	zbx_uint64_t		escalationid;
+	zbx_timer_wheel_node_t	node;
+}
+zbx_escalation_timer_t;
+
+/* escalations of one escalation source handled by the escalator process */
+typedef struct
+{
+	zbx_hashset_t		timers;
+	zbx_timer_wheel_t	wheel;
+
+	/* the time of the last full synchronization with database, 0 if not synchronized */
+	int			sync_time;
+}
+zbx_escalation_schedule_t;
+
+/* period of full escalation schedule synchronization with database */
+#define ZBX_ESCALATION_SYNC_PERIOD	(10 * SEC_PER_MIN)
+
 ZBX_VECTOR_DECL(service_alarm, zbx_service_alarm_t)
 ZBX_VECTOR_IMPL(service_alarm, zbx_service_alarm_t)
 
@@ -3364,6 +3386,177 @@ out:
 #undef ZBX_DIFF_ESCALATION_UPDATE_STATUS
 #undef ZBX_DIFF_ESCALATION_UPDATE
 
+static void	escalation_schedule_init(zbx_escalation_schedule_t *schedule, int now)
+{
+	zbx_hashset_create(&schedule->timers, 100, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_timer_wheel_create(&schedule->wheel, now);
+	schedule->sync_time = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: schedule escalation for processing at the specified time          *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_set(zbx_escalation_schedule_t *schedule, zbx_uint64_t escalationid, int nextcheck)
+{
+	zbx_escalation_timer_t	*timer, timer_local;
+
+	if (NULL == (timer = (zbx_escalation_timer_t *)zbx_hashset_search(&schedule->timers, &escalationid)))
+	{
+		memset(&timer_local, 0, sizeof(timer_local));
+		timer_local.escalationid = escalationid;
+		timer = (zbx_escalation_timer_t *)zbx_hashset_insert(&schedule->timers, &timer_local,
+				sizeof(timer_local));
+	}
+	else if (SUCCEED == zbx_timer_wheel_scheduled(&timer->node))
+	{
+		if (timer->node.expires == nextcheck)
+			return;
+
+		zbx_timer_wheel_remove(&schedule->wheel, &timer->node);
+	}
+
+	zbx_timer_wheel_insert(&schedule->wheel, &timer->node, nextcheck);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: remove escalation from schedule                                   *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_remove(zbx_escalation_schedule_t *schedule, zbx_uint64_t escalationid)
+{
+	zbx_escalation_timer_t	*timer;
+
+	if (NULL == (timer = (zbx_escalation_timer_t *)zbx_hashset_search(&schedule->timers, &escalationid)))
+		return;
+
+	if (SUCCEED == zbx_timer_wheel_scheduled(&timer->node))
+		zbx_timer_wheel_remove(&schedule->wheel, &timer->node);
+
+	zbx_hashset_remove_direct(&schedule->timers, timer);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read escalation schedule from database                            *
+ *                                                                            *
+ * Parameters: schedule - [IN/OUT] escalation schedule                        *
+ *             filter   - [IN] SQL condition selecting escalations handled    *
+ *                             by the schedule                                *
+ *             now      - [IN] current time                                   *
+ *                                                                            *
+ * Comments: Escalations are created and recovered by other processes with    *
+ *           zero nextcheck, so only those are read between full              *
+ *           synchronizations.                                                *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_sync(zbx_escalation_schedule_t *schedule, const char *filter, int now)
+{
+	zbx_db_result_t	result;
+	zbx_db_row_t	row;
+	const char	*nextcheck_filter = " and nextcheck=0";
+
+	if (now - schedule->sync_time >= ZBX_ESCALATION_SYNC_PERIOD)
+	{
+		zbx_hashset_clear(&schedule->timers);
+		zbx_timer_wheel_create(&schedule->wheel, MIN(schedule->wheel.time, now));
+		schedule->sync_time = now;
+		nextcheck_filter = "";
+	}
+
+	result = zbx_db_select("select escalationid,nextcheck from escalations where %s%s", filter, nextcheck_filter);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t	escalationid;
+
+		ZBX_STR2UINT64(escalationid, row[0]);
+		escalation_schedule_set(schedule, escalationid, atoi(row[1]));
+	}
+	zbx_db_free_result(result);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reschedule processed escalations according to their state in      *
+ *          database                                                          *
+ *                                                                            *
+ * Comments: Escalations missing from database are dropped from schedule.     *
+ *           If database cannot be queried the escalations are left           *
+ *           scheduled for retry.                                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_update(zbx_escalation_schedule_t *schedule, const zbx_uint64_t *escalationids,
+		int escalationids_num)
+{
+	zbx_db_result_t		result;
+	zbx_db_row_t		row;
+	char			*sql = NULL;
+	size_t			sql_alloc = 0, sql_offset = 0;
+	int			i;
+	zbx_vector_uint64_t	updated_ids;
+
+	zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset, "select escalationid,nextcheck from escalations where");
+	zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "escalationid", escalationids, escalationids_num);
+
+	result = zbx_db_select("%s", sql);
+	zbx_free(sql);
+
+	if (NULL == result)
+		return;
+
+	zbx_vector_uint64_create(&updated_ids);
+
+	while (NULL != (row = zbx_db_fetch(result)))
+	{
+		zbx_uint64_t	escalationid;
+
+		ZBX_STR2UINT64(escalationid, row[0]);
+		escalation_schedule_set(schedule, escalationid, atoi(row[1]));
+		zbx_vector_uint64_append(&updated_ids, escalationid);
+	}
+	zbx_db_free_result(result);
+
+	zbx_vector_uint64_sort(&updated_ids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	for (i = 0; i < escalationids_num; i++)
+	{
+		if (FAIL == zbx_vector_uint64_bsearch(&updated_ids, escalationids[i], ZBX_DEFAULT_UINT64_COMPARE_FUNC))
+			escalation_schedule_remove(schedule, escalationids[i]);
+	}
+
+	zbx_vector_uint64_destroy(&updated_ids);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get escalations due for processing                                *
+ *                                                                            *
+ * Comments: The expired escalations are rescheduled after escalator          *
+ *           frequency, so they are retried if their processing is            *
+ *           interrupted before escalation_schedule_update() reads back their *
+ *           state from database.                                             *
+ *                                                                            *
+ ******************************************************************************/
+static void	escalation_schedule_expire(zbx_escalation_schedule_t *schedule, int now,
+		zbx_vector_uint64_t *escalationids)
+{
+	zbx_timer_wheel_node_t	*node;
+
+	while (NULL != (node = zbx_timer_wheel_expire(&schedule->wheel, now)))
+	{
+		zbx_escalation_timer_t	*timer;
+
+		timer = (zbx_escalation_timer_t *)((char *)node - offsetof(zbx_escalation_timer_t, node));
+		zbx_vector_uint64_append(escalationids, timer->escalationid);
+		zbx_timer_wheel_insert(&schedule->wheel, &timer->node, now + CONFIG_ESCALATOR_FREQUENCY);
+	}
+
+	zbx_vector_uint64_sort(escalationids, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+}
+
 /*******************************************************************************
  *                                                                             *
  * Purpose: Executes escalation steps and recovery operations;                 *
@@ -3373,6 +3566,7 @@ out:
  *                                                                             *
  * Parameters: now                    - [IN] current time                      *
  *             nextcheck              - [IN/OUT] time of next invocation       *
+ *             schedule               - [IN/OUT] escalations of the source     *
  *             escalation_source      - [IN] type of escalations to be handled *
  *             default_timezone       - [IN]                                   *
  *             process_num            - [IN] process number                    *
@@ -3391,17 +3585,20 @@ out:
  *           in process_actions().                                             *
  *                                                                             *
  *******************************************************************************/
-static int	process_escalations(int now, int *nextcheck, unsigned int escalation_source,
+static int	process_escalations(int now, int *nextcheck, zbx_escalation_schedule_t *schedule,
+		unsigned int escalation_source,
 		const char *default_timezone, int process_num, int config_timeout, int config_trapper_timeout,
 		const char *config_source_ip, zbx_get_config_forks_f get_config_forks, unsigned char program_type)
 {
-	int				ret = 0;
+#	define ZBX_ESCALATIONS_PER_STEP	1000
+
+	int				ret = 0, i, esc_nextcheck;
 	zbx_db_result_t			result;
 	zbx_db_row_t			row;
 	char				*filter = NULL;
 	size_t				filter_alloc = 0, filter_offset = 0;
 	zbx_vector_db_escalation_ptr_t	escalations;
-	zbx_vector_uint64_t		actionids, eventids, problem_eventids;
+	zbx_vector_uint64_t		actionids, eventids, problem_eventids, escalationids;
 	zbx_db_escalation		*escalation;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
@@ -3410,6 +3607,7 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 	zbx_vector_uint64_create(&actionids);
 	zbx_vector_uint64_create(&eventids);
 	zbx_vector_uint64_create(&problem_eventids);
+	zbx_vector_uint64_create(&escalationids);
 
 	/* Selection of escalations to be processed:                                                          */
 	/*                                                                                                    */
@@ -3466,54 +3664,61 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 			break;
 	}
 
-	result = zbx_db_select("select escalationid,actionid,triggerid,eventid,r_eventid,nextcheck,esc_step,status,"
-					"itemid,acknowledgeid,servicealarmid,serviceid"
-				" from escalations"
-				" where %s and nextcheck<=%d"
-				" order by actionid,triggerid,itemid," ZBX_SQL_SORT_ASC("r_eventid") ",escalationid",
-				filter, now + CONFIG_ESCALATOR_FREQUENCY);
+	escalation_schedule_sync(schedule, filter, now);
 	zbx_free(filter);
 
-	while (NULL != (row = zbx_db_fetch(result)) && ZBX_IS_RUNNING())
+	escalation_schedule_expire(schedule, now, &escalationids);
+
+	for (i = 0; i < escalationids.values_num && ZBX_IS_RUNNING(); i += ZBX_ESCALATIONS_PER_STEP)
 	{
-#		define ZBX_ESCALATIONS_PER_STEP	1000
+		char	*sql = NULL;
+		size_t	sql_alloc = 0, sql_offset = 0;
+		int	ids_num = MIN(ZBX_ESCALATIONS_PER_STEP, escalationids.values_num - i);
 
-		int	esc_nextcheck;
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+				"select escalationid,actionid,triggerid,eventid,r_eventid,nextcheck,esc_step,status,"
+					"itemid,acknowledgeid,servicealarmid,serviceid"
+				" from escalations"
+				" where");
+		zbx_db_add_condition_alloc(&sql, &sql_alloc, &sql_offset, "escalationid", escalationids.values + i,
+				ids_num);
+		zbx_strcpy_alloc(&sql, &sql_alloc, &sql_offset,
+				" order by actionid,triggerid,itemid," ZBX_SQL_SORT_ASC("r_eventid") ",escalationid");
 
-		esc_nextcheck = atoi(row[5]);
+		result = zbx_db_select("%s", sql);
+		zbx_free(sql);
 
-		/* skip escalations that must be checked in next CONFIG_ESCALATOR_FREQUENCY period */
-		if (esc_nextcheck > now)
+		while (NULL != (row = zbx_db_fetch(result)))
 		{
-			if (esc_nextcheck < *nextcheck)
-				*nextcheck = esc_nextcheck;
+			/* escalation was rescheduled by another process after it was read into schedule */
+			if ((esc_nextcheck = atoi(row[5])) > now)
+				continue;
 
-			continue;
+			escalation = (zbx_db_escalation *)zbx_malloc(NULL, sizeof(zbx_db_escalation));
+			escalation->nextcheck = esc_nextcheck;
+			ZBX_DBROW2UINT64(escalation->r_eventid, row[4]);
+			ZBX_STR2UINT64(escalation->escalationid, row[0]);
+			ZBX_STR2UINT64(escalation->actionid, row[1]);
+			ZBX_DBROW2UINT64(escalation->triggerid, row[2]);
+			ZBX_DBROW2UINT64(escalation->eventid, row[3]);
+			escalation->esc_step = atoi(row[6]);
+			escalation->status = atoi(row[7]);
+			ZBX_DBROW2UINT64(escalation->itemid, row[8]);
+			ZBX_DBROW2UINT64(escalation->acknowledgeid, row[9]);
+			ZBX_DBROW2UINT64(escalation->servicealarmid, row[10]);
+			ZBX_DBROW2UINT64(escalation->serviceid, row[11]);
+
+			zbx_vector_db_escalation_ptr_append(&escalations, escalation);
+			zbx_vector_uint64_append(&actionids, escalation->actionid);
+			zbx_vector_uint64_append(&eventids, escalation->eventid);
+			zbx_vector_uint64_append(&problem_eventids, escalation->eventid);
+
+			if (0 < escalation->r_eventid)
+				zbx_vector_uint64_append(&eventids, escalation->r_eventid);
 		}
+		zbx_db_free_result(result);
 
-		escalation = (zbx_db_escalation *)zbx_malloc(NULL, sizeof(zbx_db_escalation));
-		escalation->nextcheck = esc_nextcheck;
-		ZBX_DBROW2UINT64(escalation->r_eventid, row[4]);
-		ZBX_STR2UINT64(escalation->escalationid, row[0]);
-		ZBX_STR2UINT64(escalation->actionid, row[1]);
-		ZBX_DBROW2UINT64(escalation->triggerid, row[2]);
-		ZBX_DBROW2UINT64(escalation->eventid, row[3]);
-		escalation->esc_step = atoi(row[6]);
-		escalation->status = atoi(row[7]);
-		ZBX_DBROW2UINT64(escalation->itemid, row[8]);
-		ZBX_DBROW2UINT64(escalation->acknowledgeid, row[9]);
-		ZBX_DBROW2UINT64(escalation->servicealarmid, row[10]);
-		ZBX_DBROW2UINT64(escalation->serviceid, row[11]);
-
-		zbx_vector_db_escalation_ptr_append(&escalations, escalation);
-		zbx_vector_uint64_append(&actionids, escalation->actionid);
-		zbx_vector_uint64_append(&eventids, escalation->eventid);
-		zbx_vector_uint64_append(&problem_eventids, escalation->eventid);
-
-		if (0 < escalation->r_eventid)
-			zbx_vector_uint64_append(&eventids, escalation->r_eventid);
-
-		if (ZBX_ESCALATIONS_PER_STEP <= escalations.values_num)
+		if (0 < escalations.values_num)
 		{
 			ret += process_db_escalations(now, nextcheck, &escalations, &eventids, &problem_eventids,
 					&actionids, default_timezone, config_timeout, config_trapper_timeout,
@@ -3525,26 +3730,25 @@ static int	process_escalations(int now, int *nextcheck, unsigned int escalation_
 			zbx_vector_uint64_clear(&problem_eventids);
 		}
 
-#		undef ZBX_ESCALATIONS_PER_STEP
+		/* processed escalations are either deleted or have nextcheck updated in database */
+		escalation_schedule_update(schedule, escalationids.values + i, ids_num);
 	}
-	zbx_db_free_result(result);
 
-	if (0 < escalations.values_num)
-	{
-		ret += process_db_escalations(now, nextcheck, &escalations, &eventids, &problem_eventids,
-				&actionids, default_timezone, config_timeout, config_trapper_timeout,
-				config_source_ip, get_config_forks, program_type);
-		zbx_vector_db_escalation_ptr_clear_ext(&escalations, (void (*)(zbx_db_escalation *))zbx_ptr_free);
-	}
+	/* escalations left unprocessed on shutdown stay scheduled for retry */
+	if (FAIL != (esc_nextcheck = zbx_timer_wheel_next(&schedule->wheel)) && esc_nextcheck < *nextcheck)
+		*nextcheck = esc_nextcheck;
 
 	zbx_vector_db_escalation_ptr_destroy(&escalations);
 	zbx_vector_uint64_destroy(&actionids);
 	zbx_vector_uint64_destroy(&eventids);
 	zbx_vector_uint64_destroy(&problem_eventids);
+	zbx_vector_uint64_destroy(&escalationids);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
 	return ret;	/* performance metric */
+
+#	undef ZBX_ESCALATIONS_PER_STEP
 }
 
 /******************************************************************************
@@ -3566,6 +3770,8 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 	int				server_num = ((zbx_thread_args_t *)args)->info.server_num;
 	int				process_num = ((zbx_thread_args_t *)args)->info.process_num;
 	unsigned char			process_type = ((zbx_thread_args_t *)args)->info.process_type;
+	/* trigger, item, service and default escalation schedules */
+	zbx_escalation_schedule_t	schedules[4];
 
 	zabbix_log(LOG_LEVEL_INFORMATION, "%s #%d started [%s #%d]", get_program_type_string(info->program_type),
 			server_num, get_process_type_string(process_type), process_num);
@@ -3580,6 +3786,9 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 
 	zbx_db_connect(ZBX_DB_CONNECT_NORMAL);
 
+	for (int i = 0; i < (int)ARRSIZE(schedules); i++)
+		escalation_schedule_init(&schedules[i], (int)last_stat_time);
+
 	while (ZBX_IS_RUNNING())
 	{
 		int		now, nextcheck;
@@ -3602,19 +3811,23 @@ ZBX_THREAD_ENTRY(escalator_thread, args)
 		zbx_config_get(&cfg, ZBX_CONFIG_FLAGS_DEFAULT_TIMEZONE);
 
 		nextcheck = time(NULL) + CONFIG_ESCALATOR_FREQUENCY;
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_TRIGGER,
+		escalations_count += process_escalations(time(NULL), &nextcheck, &schedules[0],
+				ZBX_ESCALATION_SOURCE_TRIGGER,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->get_process_forks_cb_arg, info->program_type);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_ITEM,
+		escalations_count += process_escalations(time(NULL), &nextcheck, &schedules[1],
+				ZBX_ESCALATION_SOURCE_ITEM,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->get_process_forks_cb_arg, info->program_type);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_SERVICE,
+		escalations_count += process_escalations(time(NULL), &nextcheck, &schedules[2],
+				ZBX_ESCALATION_SOURCE_SERVICE,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->get_process_forks_cb_arg, info->program_type);
-		escalations_count += process_escalations(time(NULL), &nextcheck, ZBX_ESCALATION_SOURCE_DEFAULT,
+		escalations_count += process_escalations(time(NULL), &nextcheck, &schedules[3],
+				ZBX_ESCALATION_SOURCE_DEFAULT,
 				cfg.default_timezone, process_num, escalator_args_in->config_timeout,
 				escalator_args_in->config_trapper_timeout, escalator_args_in->config_source_ip,
 				escalator_args_in->get_process_forks_cb_arg, info->program_type);
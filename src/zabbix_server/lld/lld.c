@@ -980,6 +980,9 @@ static int	lld_rows_get(const char *value, zbx_lld_filter_t *filter, zbx_vector_
 		goto out;
 	}
 
+	/* rows are accessed by macro paths and filters, index is closed when discovery rule is processed */
+	zbx_json_index_open(&jp);
+
 	if ('[' == *jp.start)
 	{
 		jp_array = jp;
@@ -1218,6 +1221,7 @@ out:
 	zbx_vector_lld_macro_path_clear_ext(&lld_macro_paths, zbx_lld_macro_path_free);
 	zbx_vector_lld_macro_path_destroy(&lld_macro_paths);
 
+	zbx_json_index_close();
 	zbx_dc_close_user_macros(um_handle);
 
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
@@ -24,6 +24,149 @@
 #include "zbxsysinfo.h"
 #include "async_poller.h"
 #include "zbxpoller.h"
+#include "zbxstr.h"
+
+/* idle connection kept open by passive agent */
+typedef struct
+{
+	zbx_uint64_t	interfaceid;
+	zbx_socket_t	*s;
+	char		*addr;
+	unsigned short	port;
+	unsigned char	tls_connect;
+	char		*tls_arg1;
+	char		*tls_arg2;
+	time_t		expires;
+}
+zbx_agent_conn_t;
+
+static void	agent_conn_clean(zbx_agent_conn_t *conn)
+{
+	if (NULL != conn->s)
+	{
+		zbx_tcp_close(conn->s);
+		zbx_free(conn->s);
+	}
+
+	zbx_free(conn->addr);
+	zbx_free(conn->tls_arg1);
+	zbx_free(conn->tls_arg2);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: take idle connection to the item interface from pool              *
+ *                                                                            *
+ * Return value: SUCCEED - the connection was moved to the agent context      *
+ *               FAIL    - there is no usable idle connection                 *
+ *                                                                            *
+ ******************************************************************************/
+static int	agent_pool_take(zbx_agent_context *agent_context)
+{
+	zbx_agent_conn_t	*conn;
+	zbx_pollfd_t		pd;
+
+	if (NULL == (conn = (zbx_agent_conn_t *)zbx_hashset_search(&agent_context->pool->connections,
+			&agent_context->item.interface.interfaceid)))
+	{
+		return FAIL;
+	}
+
+	if (conn->expires <= time(NULL) || conn->port != agent_context->item.interface.port ||
+			conn->tls_connect != agent_context->tls_connect ||
+			0 != strcmp(conn->addr, agent_context->item.interface.addr) ||
+			0 != zbx_strcmp_null(conn->tls_arg1, agent_context->tls_arg1) ||
+			0 != zbx_strcmp_null(conn->tls_arg2, agent_context->tls_arg2))
+	{
+		zbx_hashset_remove_direct(&agent_context->pool->connections, conn);
+		return FAIL;
+	}
+
+	/* idle connection becomes readable when agent closes it */
+	pd.fd = conn->s->socket;
+	pd.events = POLLIN;
+	pd.revents = 0;
+
+	if (0 != zbx_socket_poll(&pd, 1, 0))
+	{
+		zbx_hashset_remove_direct(&agent_context->pool->connections, conn);
+		return FAIL;
+	}
+
+	memcpy(&agent_context->s, conn->s, sizeof(zbx_socket_t));
+
+	if (ZBX_BUF_TYPE_STAT == agent_context->s.buf_type)
+		agent_context->s.buffer = agent_context->s.buf_stat;
+
+	zbx_free(conn->s);
+	zbx_hashset_remove_direct(&agent_context->pool->connections, conn);
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: keep the connection open for the next item of the same interface  *
+ *                                                                            *
+ * Parameters: agent_context - [IN] the agent context, its socket is moved to *
+ *                                  pool                                      *
+ *             keepalive     - [IN] the number of seconds agent will wait for *
+ *                                  the next request                          *
+ *                                                                            *
+ ******************************************************************************/
+static void	agent_pool_put(zbx_agent_context *agent_context, int keepalive)
+{
+	zbx_agent_conn_t	conn_local, *conn;
+
+	/* keep only the most recent connection */
+	if (NULL != (conn = (zbx_agent_conn_t *)zbx_hashset_search(&agent_context->pool->connections,
+			&agent_context->item.interface.interfaceid)))
+	{
+		zbx_hashset_remove_direct(&agent_context->pool->connections, conn);
+	}
+
+	conn_local.interfaceid = agent_context->item.interface.interfaceid;
+	conn_local.s = (zbx_socket_t *)zbx_malloc(NULL, sizeof(zbx_socket_t));
+	memcpy(conn_local.s, &agent_context->s, sizeof(zbx_socket_t));
+
+	if (ZBX_BUF_TYPE_STAT == conn_local.s->buf_type)
+		conn_local.s->buffer = conn_local.s->buf_stat;
+
+	conn_local.addr = zbx_strdup(NULL, agent_context->item.interface.addr);
+	conn_local.port = agent_context->item.interface.port;
+	conn_local.tls_connect = agent_context->tls_connect;
+	conn_local.tls_arg1 = (NULL != agent_context->tls_arg1 ? zbx_strdup(NULL, agent_context->tls_arg1) : NULL);
+	conn_local.tls_arg2 = (NULL != agent_context->tls_arg2 ? zbx_strdup(NULL, agent_context->tls_arg2) : NULL);
+
+	/* leave a second for the next request to reach agent */
+	conn_local.expires = time(NULL) + keepalive - 1;
+
+	zbx_hashset_insert(&agent_context->pool->connections, &conn_local, sizeof(conn_local));
+
+	zbx_socket_clean(&agent_context->s);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get the time agent keeps connection open after response           *
+ *                                                                            *
+ * Return value: the number of seconds or 0 if agent closes the connection    *
+ *                                                                            *
+ * Comments: Agents supporting keep-alive report the time in the reserved     *
+ *           field of uncompressed response header.                           *
+ *                                                                            *
+ ******************************************************************************/
+static int	agent_response_keepalive(const zbx_agent_context *agent_context)
+{
+#define AGENT_KEEPALIVE_MAX	SEC_PER_MIN
+	const zbx_tcp_recv_context_t	*context = &agent_context->tcp_recv_context;
+
+	if (ZBX_TCP_PROTOCOL != context->protocol_version || AGENT_KEEPALIVE_MAX < context->reserved)
+		return 0;
+
+	return (int)context->reserved;
+#undef AGENT_KEEPALIVE_MAX
+}
 
 static const char	*get_agent_step_string(zbx_zabbix_agent_step_t step)
 {
@@ -42,6 +185,55 @@ static const char	*get_agent_step_string(zbx_zabbix_agent_step_t step)
 	}
 }
 
+static int	agent_task_connect(zbx_agent_context *agent_context, const char *addr)
+{
+	if (NULL != agent_context->pool)
+		agent_context->pool->stats.opened++;
+
+	if (SUCCEED != zbx_socket_connect(&agent_context->s, SOCK_STREAM, agent_context->config_source_ip, addr,
+			agent_context->item.interface.port, agent_context->config_timeout))
+	{
+		agent_context->item.ret = NETWORK_ERROR;
+		SET_MSG_RESULT(&agent_context->item.result, zbx_dsprintf(NULL, "Get value from agent failed during %s",
+				get_agent_step_string(agent_context->step)));
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: send the request again over new connection after the connection   *
+ *          taken from pool turned out to be closed by agent                  *
+ *                                                                            *
+ ******************************************************************************/
+static int	agent_task_reconnect(zbx_agent_context *agent_context, const char *addr, int *fd)
+{
+	zabbix_log(LOG_LEVEL_DEBUG, "%s() itemid:" ZBX_FS_UI64 " idle connection was closed by agent", __func__,
+			agent_context->item.itemid);
+
+	if (ZABBIX_AGENT_STEP_RECV == agent_context->step)
+		zbx_tcp_recv_context_clear(&agent_context->tcp_recv_context);
+
+	zbx_tcp_close(&agent_context->s);
+	zbx_socket_clean(&agent_context->s);
+	agent_context->reused = 0;
+
+	zbx_tcp_send_context_clear(&agent_context->tcp_send_context);
+	zbx_tcp_send_context_init(agent_context->item.key, strlen(agent_context->item.key),
+			(size_t)agent_context->config_timeout, ZBX_TCP_PROTOCOL, &agent_context->tcp_send_context);
+
+	agent_context->step = ZABBIX_AGENT_STEP_CONNECT_WAIT;
+
+	if (SUCCEED != agent_task_connect(agent_context, addr))
+		return FAIL;
+
+	*fd = agent_context->s.socket;
+
+	return SUCCEED;
+}
+
 static zbx_async_task_state_t	get_task_state_for_event(short event)
 {
 	if (POLLIN & event)
@@ -77,15 +269,23 @@ static int	agent_task_process(short event, void *data, int *fd, const char *addr
 		zabbix_log(LOG_LEVEL_DEBUG, "In %s() step '%s' event:%d itemid:" ZBX_FS_UI64, __func__,
 				get_agent_step_string(agent_context->step), event, agent_context->item.itemid);
 
-		if (SUCCEED != zbx_socket_connect(&agent_context->s, SOCK_STREAM, agent_context->config_source_ip,
-				addr, agent_context->item.interface.port, agent_context->config_timeout))
+		if (NULL != agent_context->pool)
 		{
-			agent_context->item.ret = NETWORK_ERROR;
-			SET_MSG_RESULT(&agent_context->item.result, zbx_dsprintf(NULL, "Get value from agent failed"
-					" during %s", get_agent_step_string(agent_context->step)));
-			goto stop;
+			agent_context->pool->stats.requests++;
+
+			if (SUCCEED == agent_pool_take(agent_context))
+			{
+				agent_context->reused = 1;
+				agent_context->step = ZABBIX_AGENT_STEP_SEND;
+				*fd = agent_context->s.socket;
+
+				return ZBX_ASYNC_TASK_WRITE;
+			}
 		}
 
+		if (SUCCEED != agent_task_connect(agent_context, addr))
+			goto stop;
+
 		*fd = agent_context->s.socket;
 
 		return ZBX_ASYNC_TASK_WRITE;
@@ -195,6 +395,13 @@ static int	agent_task_process(short event, void *data, int *fd, const char *addr
 				if (ZBX_ASYNC_TASK_STOP != (state = get_task_state_for_event(event_new)))
 					return state;
 
+				if (1 == agent_context->reused)
+				{
+					if (SUCCEED == agent_task_reconnect(agent_context, addr, fd))
+						return ZBX_ASYNC_TASK_WRITE;
+					break;
+				}
+
 				SET_MSG_RESULT(&agent_context->item.result, zbx_dsprintf(NULL, "Get value from agent"
 						" failed: cannot send: %s", zbx_socket_strerror()));
 				agent_context->item.ret = NETWORK_ERROR;
@@ -210,22 +417,48 @@ static int	agent_task_process(short event, void *data, int *fd, const char *addr
 			if (FAIL != (received_len = zbx_tcp_recv_context(&agent_context->s,
 					&agent_context->tcp_recv_context, agent_context->item.flags, &event_new)))
 			{
+				int	keepalive;
+
+				if (0 == received_len && 1 == agent_context->reused)
+				{
+					if (SUCCEED == agent_task_reconnect(agent_context, addr, fd))
+						return ZBX_ASYNC_TASK_WRITE;
+					break;
+				}
+
 				agent_context->item.ret = SUCCEED;
 				zbx_agent_handle_response(&agent_context->s, received_len, &agent_context->item.ret,
 						agent_context->item.interface.addr, &agent_context->item.result);
 
+				if (NULL != agent_context->pool && NETWORK_ERROR != agent_context->item.ret &&
+						1 < (keepalive = agent_response_keepalive(agent_context)))
+				{
+					agent_pool_put(agent_context, keepalive);
+				}
+
 				break;
 			}
 
 			if (ZBX_ASYNC_TASK_STOP != (state = get_task_state_for_event(event_new)))
 				return state;
 
+			/* resend only if nothing was received, the request might have not reached agent */
+			if (1 == agent_context->reused && 0 == agent_context->tcp_recv_context.buf_stat_bytes)
+			{
+				if (SUCCEED == agent_task_reconnect(agent_context, addr, fd))
+					return ZBX_ASYNC_TASK_WRITE;
+				break;
+			}
+
 			SET_MSG_RESULT(&agent_context->item.result, zbx_dsprintf(NULL, "Get value from agent failed:"
 					" cannot read response: %s", zbx_socket_strerror()));
 			agent_context->item.ret = NETWORK_ERROR;
 			break;
 	}
 stop:
+	if (ZABBIX_AGENT_STEP_RECV == agent_context->step)
+		zbx_tcp_recv_context_clear(&agent_context->tcp_recv_context);
+
 	zbx_tcp_send_context_clear(&agent_context->tcp_send_context);
 	zbx_tcp_close(&agent_context->s);
 
@@ -243,7 +476,7 @@ void	zbx_async_check_agent_clean(zbx_agent_context *agent_context)
 
 int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip)
+		const char *config_source_ip, zbx_agent_pool_t *pool)
 {
 	zbx_agent_context	*agent_context = zbx_malloc(NULL, sizeof(zbx_agent_context));
 	int			ret = NOTSUPPORTED;
@@ -267,6 +500,8 @@ int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_
 	zbx_strlcpy(agent_context->item.host, item->host.host, sizeof(agent_context->item.host));
 
 	agent_context->config_source_ip = config_source_ip;
+	agent_context->pool = pool;
+	agent_context->reused = 0;
 
 	zbx_init_agent_result(&agent_context->item.result);
 
@@ -330,3 +565,45 @@ out:
 
 	return ret;
 }
+
+void	zbx_async_agent_pool_init(zbx_agent_pool_t *pool)
+{
+	zbx_hashset_create_ext(&pool->connections, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)agent_conn_clean,
+			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+
+	memset(&pool->stats, 0, sizeof(pool->stats));
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: close idle connections agents are about to close                  *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_agent_pool_expire(zbx_agent_pool_t *pool, time_t now)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_agent_conn_t	*conn;
+
+	zbx_hashset_iter_reset(&pool->connections, &iter);
+
+	while (NULL != (conn = (zbx_agent_conn_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (conn->expires <= now)
+			zbx_hashset_iter_remove(&iter);
+	}
+}
+
+void	zbx_async_agent_pool_flush_stats(zbx_agent_pool_t *pool)
+{
+	if (0 == pool->stats.opened && 0 == pool->stats.requests)
+		return;
+
+	zbx_dc_update_agent_conn_stats(&pool->stats);
+	memset(&pool->stats, 0, sizeof(pool->stats));
+}
+
+void	zbx_async_agent_pool_destroy(zbx_agent_pool_t *pool)
+{
+	zbx_hashset_destroy(&pool->connections);
+}
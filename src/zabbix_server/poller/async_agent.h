@@ -32,6 +32,14 @@ typedef enum
 }
 zbx_zabbix_agent_step_t;
 
+/* idle connections kept open by passive agents, by interface */
+typedef struct
+{
+	zbx_hashset_t			connections;
+	zbx_dc_agent_conn_stats_t	stats;		/* not yet added to configuration cache */
+}
+zbx_agent_pool_t;
+
 typedef struct
 {
 	zbx_dc_item_context_t	item;
@@ -47,12 +55,19 @@ typedef struct
 	unsigned char		tls_connect;
 	const char		*config_source_ip;
 	int			config_timeout;
+	zbx_agent_pool_t	*pool;
+	int			reused;		/* the connection was taken from pool */
 }
 zbx_agent_context;
 
 int	zbx_async_check_agent(zbx_dc_item_t *item, AGENT_RESULT *result,  zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip);
+		const char *config_source_ip, zbx_agent_pool_t *pool);
 void	zbx_async_check_agent_clean(zbx_agent_context *agent_context);
 
+void	zbx_async_agent_pool_init(zbx_agent_pool_t *pool);
+void	zbx_async_agent_pool_expire(zbx_agent_pool_t *pool, time_t now);
+void	zbx_async_agent_pool_flush_stats(zbx_agent_pool_t *pool);
+void	zbx_async_agent_pool_destroy(zbx_agent_pool_t *pool);
+
 #endif
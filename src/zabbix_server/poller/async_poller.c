@@ -221,9 +221,13 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 	zbx_timespec_t			timespec;
 	int				i, total = 0;
 	zbx_vector_poller_item_t	poller_items;
-
+#ifdef HAVE_NETSNMP
+	zbx_hashset_t			snmp_batches;
+#endif
 	zbx_vector_poller_item_create(&poller_items);
 #ifdef HAVE_NETSNMP
+	zbx_hashset_create(&snmp_batches, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
 	if (1 == poller_config->clear_cache)
 	{
 		if (0 != poller_config->processing)
@@ -280,7 +284,7 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 			{
 				errcodes[i] = zbx_async_check_agent(&items[i], &results[i], process_agent_result,
 						poller_config, poller_config, poller_config->base, poller_config->dnsbase,
-						poller_config->config_source_ip);
+						poller_config->config_source_ip, &poller_config->agent_pool);
 			}
 			else
 			{
@@ -289,7 +293,7 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 
 				errcodes[i] = zbx_async_check_snmp(&items[i], &results[i], process_snmp_result,
 						poller_config, poller_config, poller_config->base, poller_config->dnsbase,
-						poller_config->config_source_ip);
+						poller_config->config_source_ip, &snmp_batches);
 	#else
 				errcodes[i] = NOTSUPPORTED;
 				SET_MSG_RESULT(&results[i], zbx_strdup(NULL, "Support for SNMP checks was not compiled in."));
@@ -322,7 +326,9 @@ static void	async_initiate_queued_checks(zbx_poller_config_t *poller_config, con
 		zbx_poller_item_free(poller_items.values[j]);
 	}
 #ifdef HAVE_NETSNMP
+	zbx_async_check_snmp_flush(&snmp_batches);
 exit:
+	zbx_hashset_destroy(&snmp_batches);
 #endif
 	if (0 != total)
 		zabbix_log(LOG_LEVEL_DEBUG, "End of %s(): num:%d", __func__, total);
@@ -346,6 +352,12 @@ static void	async_timer(evutil_socket_t fd, short events, void *arg)
 
 	if (ZBX_IS_RUNNING())
 		zbx_async_manager_queue_sync(poller_config->manager);
+
+	if (ZBX_POLLER_TYPE_AGENT == poller_config->poller_type)
+	{
+		zbx_async_agent_pool_expire(&poller_config->agent_pool, time(NULL));
+		zbx_async_agent_pool_flush_stats(&poller_config->agent_pool);
+	}
 }
 
 static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_poller_args *poller_args_in,
@@ -359,6 +371,7 @@ static void	async_poller_init(zbx_poller_config_t *poller_config, zbx_thread_pol
 	zbx_hashset_create_ext(&poller_config->interfaces, 100, ZBX_DEFAULT_UINT64_HASH_FUNC,
 			ZBX_DEFAULT_UINT64_COMPARE_FUNC, (zbx_clean_func_t)zbx_interface_status_clean,
 			ZBX_DEFAULT_MEM_MALLOC_FUNC, ZBX_DEFAULT_MEM_REALLOC_FUNC, ZBX_DEFAULT_MEM_FREE_FUNC);
+	zbx_async_agent_pool_init(&poller_config->agent_pool);
 
 	if (NULL == (poller_config->base = event_base_new()))
 	{
@@ -448,6 +461,7 @@ static void	async_poller_destroy(zbx_poller_config_t *poller_config)
 	event_base_free(poller_config->base);
 	zbx_hashset_clear(&poller_config->interfaces);
 	zbx_hashset_destroy(&poller_config->interfaces);
+	zbx_async_agent_pool_destroy(&poller_config->agent_pool);
 }
 
 #ifdef HAVE_LIBCURL
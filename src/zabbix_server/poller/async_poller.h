@@ -24,6 +24,7 @@
 #include "zbxthreads.h"
 #include "zbxcacheconfig.h"
 #include "async_manager.h"
+#include "async_agent.h"
 
 typedef struct
 {
@@ -50,6 +51,7 @@ typedef struct
 	struct event_base	*base;
 	struct evdns_base	*dnsbase;
 	zbx_hashset_t		interfaces;
+	zbx_agent_pool_t	agent_pool;
 #ifdef HAVE_LIBCURL
 	CURLM			*curl_handle;
 #endif
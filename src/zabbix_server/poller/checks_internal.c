@@ -1026,6 +1026,126 @@ int	get_value_internal(const zbx_dc_item_t *item, AGENT_RESULT *result, const zb
 			goto out;
 		}
 	}
+	else if (0 == strcmp(tmp, "agent_connections"))		/* zabbix[agent_connections,<mode>] */
+	{
+		zbx_dc_agent_conn_stats_t	stats;
+
+		if (2 < nparams)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		tmp = get_rparam(&request, 1);
+		zbx_dc_get_agent_conn_stats(&stats);
+
+		if (NULL == tmp || '\0' == *tmp || 0 == strcmp(tmp, "requests"))
+		{
+			SET_UI64_RESULT(result, stats.requests);
+		}
+		else if (0 == strcmp(tmp, "opened"))
+		{
+			SET_UI64_RESULT(result, stats.opened);
+		}
+		else if (0 == strcmp(tmp, "reused"))
+		{
+			SET_UI64_RESULT(result, stats.requests - stats.opened);
+		}
+		else if (0 == strcmp(tmp, "preused"))
+		{
+			SET_DBL_RESULT(result, (0 == stats.requests ? 0 :
+					(double)(stats.requests - stats.opened) / (double)stats.requests * 100));
+		}
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
+			goto out;
+		}
+	}
+	else if (0 == strcmp(tmp, "function_cache"))		/* zabbix[function_cache,<mode>] */
+	{
+		zbx_dc_func_cache_stats_t	stats;
+
+		if (2 < nparams)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		tmp = get_rparam(&request, 1);
+		zbx_dc_get_func_cache_stats(&stats);
+
+		if (NULL == tmp || '\0' == *tmp || 0 == strcmp(tmp, "hits"))
+		{
+			SET_UI64_RESULT(result, stats.hits);
+		}
+		else if (0 == strcmp(tmp, "misses"))
+		{
+			SET_UI64_RESULT(result, stats.misses);
+		}
+		else if (0 == strcmp(tmp, "phits"))
+		{
+			zbx_uint64_t	total = stats.hits + stats.misses;
+
+			SET_DBL_RESULT(result, (0 == total ? 0 : (double)stats.hits / (double)total * 100));
+		}
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
+			goto out;
+		}
+	}
+	else if (0 == strcmp(tmp, "compression"))		/* zabbix[compression,<codec>,<mode>] */
+	{
+		zbx_compress_stats_t	stats;
+		int			codec;
+
+		if (3 < nparams)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid number of parameters."));
+			goto out;
+		}
+
+		tmp = get_rparam(&request, 1);
+
+		for (codec = 0; codec < ZBX_COMPRESS_CODEC_NUM; codec++)
+		{
+			if (NULL != tmp && 0 == strcmp(tmp, zbx_compress_codec_name(codec)))
+				break;
+		}
+
+		if (ZBX_COMPRESS_CODEC_NUM == codec)
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid second parameter."));
+			goto out;
+		}
+
+		tmp = get_rparam(&request, 2);
+		zbx_dc_get_compress_stats(codec, &stats);
+
+		if (NULL == tmp || '\0' == *tmp || 0 == strcmp(tmp, "ratio"))
+		{
+			SET_DBL_RESULT(result, (0 == stats.size_compressed ? 0 :
+					(double)stats.size / (double)stats.size_compressed));
+		}
+		else if (0 == strcmp(tmp, "bytes"))
+		{
+			SET_UI64_RESULT(result, stats.size);
+		}
+		else if (0 == strcmp(tmp, "compressed"))
+		{
+			SET_UI64_RESULT(result, stats.size_compressed);
+		}
+		else if (0 == strcmp(tmp, "cpu"))
+		{
+			SET_DBL_RESULT(result, stats.cpu_time);
+		}
+		else
+		{
+			SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid third parameter."));
+			goto out;
+		}
+	}
 	else
 	{
 		SET_MSG_RESULT(result, zbx_strdup(NULL, "Invalid first parameter."));
@@ -146,6 +146,9 @@ zbx_bulkwalk_context_t;
 ZBX_PTR_VECTOR_DECL(bulkwalk_context, zbx_bulkwalk_context_t*)
 ZBX_PTR_VECTOR_IMPL(bulkwalk_context, zbx_bulkwalk_context_t*)
 
+ZBX_PTR_VECTOR_DECL(snmp_context, zbx_snmp_context_t *)
+ZBX_PTR_VECTOR_IMPL(snmp_context, zbx_snmp_context_t *)
+
 struct zbx_snmp_context
 {
 	void				*arg;
@@ -172,8 +175,25 @@ struct zbx_snmp_context
 	char				*snmpv3_privpassphrase;
 	const char			*config_source_ip;
 	unsigned char			snmp_oid_type;
+	struct event_base		*base;
+	struct evdns_base		*dnsbase;
+	zbx_async_task_clear_cb_t	clear_cb;
+	zbx_vector_snmp_context_t	batch;		/* items requested together with this one, */
+							/* the owner of the batch is the last one  */
+	int				batch_offset;	/* the first item of the current request */
+	int				batch_size;	/* the number of items per request       */
+	int				batch_max_succeed;
+	int				batch_min_fail;
 };
 
+typedef struct
+{
+	zbx_uint64_t		interfaceid;
+	zbx_snmp_context_t	*leader;
+	int			max_vars;
+}
+zbx_snmp_batch_t;
+
 typedef struct
 {
 	AGENT_RESULT		*result;
@@ -2240,6 +2260,101 @@ out:
 	return ret;
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: process response to the request of several batched items          *
+ *                                                                            *
+ * Parameters: status        - [IN] the response status                       *
+ *             response      - [IN] the response PDU                          *
+ *             snmp_context  - [IN] the batch owner                           *
+ *             error         - [OUT] the error message                        *
+ *             max_error_len - [IN] the error buffer size                     *
+ *                                                                            *
+ * Return value: SUCCEED - the response was processed, the values or errors   *
+ *                         are set to the requested items                     *
+ *               other   - the request failed for the whole batch             *
+ *                                                                            *
+ * Comments: If the agent refuses the request with several variables, the     *
+ *           request size is halved and the same items are requested again.   *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_batch_handle_response(int status, struct snmp_pdu *response, zbx_snmp_context_t *snmp_context,
+		char *error, size_t max_error_len)
+{
+	struct variable_list	*var;
+	int			i, num;
+	char			err[MAX_STRING_LEN];
+
+	num = MIN(snmp_context->batch_size, snmp_context->batch.values_num - snmp_context->batch_offset);
+
+	zabbix_log(LOG_LEVEL_DEBUG, "In %s() offset:%d num:%d", __func__, snmp_context->batch_offset, num);
+
+	if (STAT_SUCCESS != status)
+	{
+		return zbx_get_snmp_response_error(snmp_context->ssp, &snmp_context->item.interface, status, response,
+				error, max_error_len);
+	}
+
+	if (SNMP_ERR_NOERROR != response->errstat)
+	{
+		zbx_snmp_context_t	*member;
+
+		if (1 < num)
+		{
+			if (SNMP_ERR_TOOBIG == response->errstat)
+				snmp_context->batch_min_fail = MIN(snmp_context->batch_min_fail, num);
+
+			snmp_context->batch_size = num / 2;
+
+			return SUCCEED;
+		}
+
+		member = snmp_context->batch.values[snmp_context->batch_offset++];
+		member->item.ret = zbx_get_snmp_response_error(snmp_context->ssp, &snmp_context->item.interface, status,
+				response, err, sizeof(err));
+		SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, err));
+
+		return SUCCEED;
+	}
+
+	var = response->variables;
+
+	for (i = 0; i < num; i++)
+	{
+		zbx_snmp_context_t	*member = snmp_context->batch.values[snmp_context->batch_offset + i];
+		const zbx_snmp_oid_t	*p_oid = member->bulkwalk_contexts.values[0]->p_oid;
+
+		if (NULL == var)
+		{
+			member->item.ret = NOTSUPPORTED;
+			SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, "No variables"));
+			continue;
+		}
+
+		if (var->name_length < p_oid->root_oid_len ||
+				0 != memcmp(p_oid->root_oid, var->name, p_oid->root_oid_len * sizeof(oid)))
+		{
+			member->item.ret = NOTSUPPORTED;
+			SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, "OID mismatched"));
+		}
+		else if (SUCCEED == (member->item.ret = snmp_get_value_from_var(var, &member->results,
+				&member->results_alloc, &member->results_offset, err, sizeof(err))))
+		{
+			SET_TEXT_RESULT(&member->item.result, member->results);
+			member->results = NULL;
+		}
+		else
+			SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, err));
+
+		var = var->next_variable;
+	}
+
+	snmp_context->batch_max_succeed = MAX(snmp_context->batch_max_succeed, num);
+	snmp_context->batch_offset += num;
+
+	return SUCCEED;
+}
+
 static int	asynch_response(int operation, struct snmp_session *sp, int reqid, struct snmp_pdu *pdu, void *magic)
 {
 	zbx_bulkwalk_context_t	*bulkwalk_context;
@@ -2295,9 +2410,19 @@ static int	asynch_response(int operation, struct snmp_session *sp, int reqid, st
 	{
 		char	error[MAX_STRING_LEN];
 
-		if (SUCCEED != (ret = snmp_bulkwalk_handle_response(stat, pdu, bulkwalk_context, &snmp_context->results,
-				&snmp_context->results_alloc, &snmp_context->results_offset, snmp_context->ssp,
-				&snmp_context->item.interface, snmp_context->snmp_oid_type, error, sizeof(error))))
+		if (0 != snmp_context->batch.values_num)
+		{
+			ret = snmp_batch_handle_response(stat, pdu, snmp_context, error, sizeof(error));
+		}
+		else
+		{
+			ret = snmp_bulkwalk_handle_response(stat, pdu, bulkwalk_context, &snmp_context->results,
+					&snmp_context->results_alloc, &snmp_context->results_offset, snmp_context->ssp,
+					&snmp_context->item.interface, snmp_context->snmp_oid_type, error,
+					sizeof(error));
+		}
+
+		if (SUCCEED != ret)
 		{
 			bulkwalk_context->error = zbx_strdup(bulkwalk_context->error, error);
 		}
@@ -2389,6 +2514,34 @@ static int	snmp_bulkwalk_add(zbx_snmp_context_t *snmp_context, int *fd, char *er
 			goto out;
 		}
 	}
+	else if (0 != snmp_context->batch.values_num)
+	{
+		int	i, end;
+
+		if (NULL == (pdu = snmp_pdu_create(SNMP_MSG_GET)))
+		{
+			zbx_strlcpy(error, "snmp_pdu_create(): cannot create PDU object.", max_error_len);
+			ret = CONFIG_ERROR;
+			goto out;
+		}
+
+		end = MIN(snmp_context->batch_offset + snmp_context->batch_size, snmp_context->batch.values_num);
+
+		for (i = snmp_context->batch_offset; i < end; i++)
+		{
+			const zbx_bulkwalk_context_t	*member;
+
+			member = snmp_context->batch.values[i]->bulkwalk_contexts.values[0];
+
+			if (NULL == snmp_add_null_var(pdu, member->name, member->name_length))
+			{
+				zbx_strlcpy(error, "snmp_add_null_var(): cannot add null variable.", max_error_len);
+				ret = CONFIG_ERROR;
+				snmp_free_pdu(pdu);
+				goto out;
+			}
+		}
+	}
 	else
 	{
 		/* create PDU */
@@ -2492,6 +2645,84 @@ void	zbx_unset_snmp_bulkwalk_options(void)
 	snmp_bulkwalk_set_options(&default_opts);
 }
 
+/******************************************************************************
+ *                                                                            *
+ * Purpose: set timeout error to the item                                     *
+ *                                                                            *
+ * Parameters: snmp_context - [IN] the item context                           *
+ *             probe        - [IN] 1 if the SNMPv3 engine was not probed yet  *
+ *             dnserr       - [IN] the name resolution error, can be NULL     *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_set_timeout_result(zbx_snmp_context_t *snmp_context, int probe, const char *dnserr)
+{
+	char			buffer[MAX_OID_LEN];
+	zbx_bulkwalk_context_t	*bulkwalk_context = snmp_context->bulkwalk_contexts.values[snmp_context->i];
+
+	snprint_objid(buffer, sizeof(buffer), bulkwalk_context->name, bulkwalk_context->name_length);
+
+	if (NULL != dnserr)
+	{
+		SET_MSG_RESULT(&snmp_context->item.result, zbx_dsprintf(NULL,
+				"cannot resolve address [[%s]:%hu]: timed out: %s",
+				snmp_context->item.interface.addr, snmp_context->item.interface.port, dnserr));
+	}
+	else if (ZBX_IF_SNMP_VERSION_3 == snmp_context->snmp_version && 0 == probe)
+	{
+		SET_MSG_RESULT(&snmp_context->item.result, zbx_dsprintf(NULL,
+				"Probe successful, cannot retrieve OID: '%s' from [[%s]:%hu]: timed out", buffer,
+				snmp_context->item.interface.addr, snmp_context->item.interface.port));
+	}
+	else
+	{
+		SET_MSG_RESULT(&snmp_context->item.result, zbx_dsprintf(NULL,
+				"cannot retrieve OID: '%s' from [[%s]:%hu]: timed out", buffer,
+				snmp_context->item.interface.addr, snmp_context->item.interface.port));
+	}
+
+	snmp_context->item.ret = TIMEOUT_ERROR;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: pass results of the batched items to the poller                   *
+ *                                                                            *
+ * Parameters: snmp_context - [IN] the batch owner                            *
+ *                                                                            *
+ * Comments: The items not requested because the batch failed get the error   *
+ *           of the batch owner.                                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	snmp_batch_finish(zbx_snmp_context_t *snmp_context)
+{
+	int	i;
+
+	for (i = 0; i < snmp_context->batch.values_num; i++)
+	{
+		zbx_snmp_context_t	*member = snmp_context->batch.values[i];
+
+		if (member == snmp_context)
+			continue;
+
+		if (0 == member->item.result.type)
+		{
+			member->item.ret = snmp_context->item.ret;
+			SET_MSG_RESULT(&member->item.result, zbx_strdup(NULL, NULL != snmp_context->item.result.msg ?
+					snmp_context->item.result.msg : "Get value failed"));
+		}
+
+		member->clear_cb(member);
+	}
+
+	zbx_vector_snmp_context_clear(&snmp_context->batch);
+
+	if (0 != snmp_context->batch_max_succeed || ZBX_MAX_SNMP_ITEMS + 1 != snmp_context->batch_min_fail)
+	{
+		zbx_dc_config_update_interface_snmp_stats(snmp_context->item.interface.interfaceid,
+				snmp_context->batch_max_succeed, snmp_context->batch_min_fail);
+	}
+}
+
 static int	snmp_task_process(short event, void *data, int *fd, const char *addr, char *dnserr)
 {
 	zbx_bulkwalk_context_t	*bulkwalk_context;
@@ -2516,34 +2747,24 @@ static int	snmp_task_process(short event, void *data, int *fd, const char *addr,
 	{
 		if (0 != (event & EV_TIMEOUT))
 		{
-			char	buffer[MAX_OID_LEN];
+			if (0 != snmp_context->batch.values_num)
+			{
+				int	i, num;
 
-			snprint_objid(buffer, sizeof(buffer), bulkwalk_context->name, bulkwalk_context->name_length);
+				num = MIN(snmp_context->batch_size, snmp_context->batch.values_num -
+						snmp_context->batch_offset);
 
-			if (NULL != dnserr)
-			{
-				SET_MSG_RESULT(&snmp_context->item.result, zbx_dsprintf(NULL,
-						"cannot resolve address [[%s]:%hu]: timed out: %s",
-						snmp_context->item.interface.addr, snmp_context->item.interface.port,
-						dnserr));
-				snmp_context->item.ret = TIMEOUT_ERROR;
-			}
-			else if (ZBX_IF_SNMP_VERSION_3 == snmp_context->snmp_version && 0 == snmp_context->probe)
-			{
-				SET_MSG_RESULT(&snmp_context->item.result, zbx_dsprintf(NULL,
-						"Probe successful, cannot retrieve OID: '%s' from [[%s]:%hu]:"
-						" timed out", buffer, snmp_context->item.interface.addr,
-						snmp_context->item.interface.port));
-				snmp_context->item.ret = TIMEOUT_ERROR;
+				if (1 < num && NULL == dnserr && 0 == snmp_context->probe)
+					snmp_context->batch_min_fail = MIN(snmp_context->batch_min_fail, num);
+
+				for (i = snmp_context->batch_offset; i < snmp_context->batch.values_num; i++)
+				{
+					snmp_set_timeout_result(snmp_context->batch.values[i], snmp_context->probe,
+							dnserr);
+				}
 			}
 			else
-			{
-				SET_MSG_RESULT(&snmp_context->item.result, zbx_dsprintf(NULL,
-						"cannot retrieve OID: '%s' from [[%s]:%hu]:"
-						" timed out", buffer, snmp_context->item.interface.addr,
-						snmp_context->item.interface.port));
-				snmp_context->item.ret = TIMEOUT_ERROR;
-			}
+				snmp_set_timeout_result(snmp_context, snmp_context->probe, dnserr);
 
 			goto stop;
 		}
@@ -2603,7 +2824,12 @@ static int	snmp_task_process(short event, void *data, int *fd, const char *addr,
 					snmp_context->item.itemid);
 		}
 
-		if (0 == bulkwalk_context->running)
+		if (0 != snmp_context->batch.values_num)
+		{
+			if (snmp_context->batch_offset == snmp_context->batch.values_num)
+				goto stop;
+		}
+		else if (0 == bulkwalk_context->running)
 		{
 			if (0 == bulkwalk_context->vars_num && SNMP_MSG_GETBULK == bulkwalk_context->pdu_type)
 			{
@@ -2651,6 +2877,9 @@ static int	snmp_task_process(short event, void *data, int *fd, const char *addr,
 	else
 		task_ret = ZBX_ASYNC_TASK_READ;
 stop:
+	if (ZBX_ASYNC_TASK_STOP == task_ret && 0 != snmp_context->batch.values_num)
+		snmp_batch_finish(snmp_context);
+
 	zabbix_log(LOG_LEVEL_DEBUG, "End of %s()", __func__);
 
 	return task_ret;
@@ -2686,12 +2915,150 @@ void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context)
 	zbx_vector_bulkwalk_context_destroy(&snmp_context->bulkwalk_contexts);
 	zbx_vector_snmp_oid_clear_ext(&snmp_context->param_oids, vector_snmp_oid_free);
 	zbx_vector_snmp_oid_destroy(&snmp_context->param_oids);
+	zbx_vector_snmp_context_destroy(&snmp_context->batch);
 	zbx_free(snmp_context);
 }
 
+static int	snmp_context_batchable(const zbx_snmp_context_t *leader, const zbx_snmp_context_t *snmp_context)
+{
+	if (leader->config_timeout != snmp_context->config_timeout ||
+			leader->snmp_version != snmp_context->snmp_version ||
+			leader->snmpv3_securitylevel != snmp_context->snmpv3_securitylevel ||
+			leader->snmpv3_authprotocol != snmp_context->snmpv3_authprotocol ||
+			leader->snmpv3_privprotocol != snmp_context->snmpv3_privprotocol ||
+			leader->arg != snmp_context->arg)
+	{
+		return FAIL;
+	}
+
+	if (0 != zbx_strcmp_null(leader->snmp_community, snmp_context->snmp_community) ||
+			0 != zbx_strcmp_null(leader->snmpv3_securityname, snmp_context->snmpv3_securityname) ||
+			0 != zbx_strcmp_null(leader->snmpv3_contextname, snmp_context->snmpv3_contextname) ||
+			0 != zbx_strcmp_null(leader->snmpv3_authpassphrase, snmp_context->snmpv3_authpassphrase) ||
+			0 != zbx_strcmp_null(leader->snmpv3_privpassphrase, snmp_context->snmpv3_privpassphrase))
+	{
+		return FAIL;
+	}
+
+	return SUCCEED;
+}
+
+static void	snmp_batch_start(zbx_snmp_context_t *leader)
+{
+	if (0 != leader->batch.values_num)
+	{
+		zbx_vector_snmp_context_append(&leader->batch, leader);
+		leader->batch_size = leader->batch.values_num;
+	}
+
+	zbx_async_poller_add_task(leader->base, leader->dnsbase, leader->item.interface.addr, leader,
+			leader->config_timeout, snmp_task_process, leader->clear_cb);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: add GET item to the batch of its interface                        *
+ *                                                                            *
+ * Parameters: batches      - [IN/OUT] the batches being collected            *
+ *             snmp_context - [IN] the item context                           *
+ *                                                                            *
+ * Return value: SUCCEED - the item will be requested with the batch          *
+ *               FAIL    - the item cannot be batched                         *
+ *                                                                            *
+ * Comments: The batch size is limited by the number of variables suggested   *
+ *           for the interface. Full batches are started immediately.         *
+ *                                                                            *
+ ******************************************************************************/
+static int	snmp_batch_add(zbx_hashset_t *batches, zbx_snmp_context_t *snmp_context)
+{
+	zbx_snmp_batch_t	*batch;
+
+	if (ZBX_SNMP_GET != snmp_context->snmp_oid_type || 1 != snmp_context->param_oids.values_num ||
+			ZBX_IF_SNMP_VERSION_1 == snmp_context->snmp_version)
+	{
+		return FAIL;
+	}
+
+	if (NULL == (batch = (zbx_snmp_batch_t *)zbx_hashset_search(batches,
+			&snmp_context->item.interface.interfaceid)))
+	{
+		zbx_snmp_batch_t	batch_local;
+
+		batch_local.interfaceid = snmp_context->item.interface.interfaceid;
+		batch_local.leader = NULL;
+		batch_local.max_vars = zbx_dc_config_get_suggested_snmp_vars(batch_local.interfaceid, NULL);
+
+		batch = (zbx_snmp_batch_t *)zbx_hashset_insert(batches, &batch_local, sizeof(batch_local));
+	}
+
+	if (1 >= batch->max_vars)
+		return FAIL;
+
+	if (NULL == batch->leader)
+	{
+		batch->leader = snmp_context;
+		return SUCCEED;
+	}
+
+	if (SUCCEED != snmp_context_batchable(batch->leader, snmp_context))
+		return FAIL;
+
+	zbx_vector_snmp_context_append(&batch->leader->batch, snmp_context);
+
+	if (batch->leader->batch.values_num + 1 >= batch->max_vars)
+	{
+		snmp_batch_start(batch->leader);
+		batch->leader = NULL;
+	}
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start requests of the collected batches                           *
+ *                                                                            *
+ * Parameters: batches - [IN] the batches collected by zbx_async_check_snmp() *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_async_check_snmp_flush(zbx_hashset_t *batches)
+{
+	zbx_hashset_iter_t	iter;
+	zbx_snmp_batch_t	*batch;
+
+	zbx_hashset_iter_reset(batches, &iter);
+
+	while (NULL != (batch = (zbx_snmp_batch_t *)zbx_hashset_iter_next(&iter)))
+	{
+		if (NULL != batch->leader)
+		{
+			snmp_batch_start(batch->leader);
+			batch->leader = NULL;
+		}
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start asynchronous SNMP check                                     *
+ *                                                                            *
+ * Parameters: item             - [IN] the item to check                      *
+ *             result           - [OUT] the error if check cannot be started  *
+ *             clear_cb         - [IN] the callback to pass the result        *
+ *             arg              - [IN] the callback argument                  *
+ *             arg_action       - [IN] the poller configuration, can be NULL  *
+ *             base             - [IN] the event base                         *
+ *             dnsbase          - [IN] the DNS resolver base                  *
+ *             config_source_ip - [IN] the source address                     *
+ *             batches          - [IN/OUT] the batches of GET items requested *
+ *                                together, zbx_async_check_snmp_flush()      *
+ *                                must be called after the last item is       *
+ *                                added; NULL to request the item separately  *
+ *                                                                            *
+ ******************************************************************************/
 int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip)
+		const char *config_source_ip, zbx_hashset_t *batches)
 {
 	int			i, ret = SUCCEED, pdu_type;
 	AGENT_REQUEST		request;
@@ -2742,7 +3109,15 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 	snmp_context->snmpv3_privpassphrase = item->snmpv3_privpassphrase;
 	item->snmpv3_privpassphrase = NULL;
 	snmp_context->config_source_ip = config_source_ip;
-
+	snmp_context->base = base;
+	snmp_context->dnsbase = dnsbase;
+	snmp_context->clear_cb = clear_cb;
+	snmp_context->batch_offset = 0;
+	snmp_context->batch_size = 1;
+	snmp_context->batch_max_succeed = 0;
+	snmp_context->batch_min_fail = ZBX_MAX_SNMP_ITEMS + 1;
+
+	zbx_vector_snmp_context_create(&snmp_context->batch);
 	zbx_vector_bulkwalk_context_create(&snmp_context->bulkwalk_contexts);
 
 	zbx_init_agent_request(&request);
@@ -2801,8 +3176,8 @@ int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_ta
 		zbx_vector_bulkwalk_context_append(&snmp_context->bulkwalk_contexts, bulkwalk_context);
 	}
 
-	zbx_async_poller_add_task(base, dnsbase, snmp_context->item.interface.addr, snmp_context, item->timeout,
-			snmp_task_process, clear_cb);
+	if (NULL == batches || SUCCEED != snmp_batch_add(batches, snmp_context))
+		snmp_batch_start(snmp_context);
 
 	ret = SUCCEED;
 out:
@@ -3206,7 +3581,7 @@ void	get_values_snmp(zbx_dc_item_t *items, AGENT_RESULT *results, int *errcodes,
 		zbx_set_snmp_bulkwalk_options(progname);
 
 		if (SUCCEED == (errcodes[j] = zbx_async_check_snmp(&items[j], &results[j], process_snmp_result,
-				&snmp_result, NULL, snmp_result.base, dnsbase, config_source_ip)))
+				&snmp_result, NULL, snmp_result.base, dnsbase, config_source_ip, NULL)))
 		{
 			if (1 == snmp_result.finished || -1 != event_base_dispatch(snmp_result.base))
 			{
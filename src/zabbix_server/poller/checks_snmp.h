@@ -47,7 +47,8 @@ void	zbx_clear_cache_snmp(unsigned char process_type, int process_num, const cha
 
 int	zbx_async_check_snmp(zbx_dc_item_t *item, AGENT_RESULT *result, zbx_async_task_clear_cb_t clear_cb,
 		void *arg, void *arg_action, struct event_base *base, struct evdns_base *dnsbase,
-		const char *config_source_ip);
+		const char *config_source_ip, zbx_hashset_t *batches);
+void	zbx_async_check_snmp_flush(zbx_hashset_t *batches);
 zbx_dc_item_context_t	*zbx_async_check_snmp_get_item_context(zbx_snmp_context_t *snmp_context);
 void	*zbx_async_check_snmp_get_arg(zbx_snmp_context_t *snmp_context);
 void	zbx_async_check_snmp_clean(zbx_snmp_context_t *snmp_context);
@@ -1346,7 +1346,7 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 
 	zbx_update_proxy_data(&proxy, version_str, version_int, time(NULL), ZBX_FLAGS_PROXY_DIFF_UPDATE_CONFIG);
 
-	flags |= ZBX_TCP_COMPRESS;
+	flags |= zbx_get_compress_flags(jp);
 
 	if (ZBX_PROXY_VERSION_CURRENT != proxy.compatibility)
 	{
@@ -1370,7 +1370,8 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	if (SUCCEED != zbx_compress_ext(zbx_tcp_compress_codec((unsigned char)flags), j.buffer, j.buffer_size,
+			&buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
@@ -1381,8 +1382,9 @@ void	zbx_send_proxyconfig(zbx_socket_t *sock, const struct zbx_json_parse *jp,
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
 
 	zabbix_log(loglevel, "sending configuration data to proxy \"%s\" at \"%s\", datalen "
-			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with compression ratio %.1f", proxy.name,
+			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with %s compression ratio %.1f", proxy.name,
 			sock->peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
+			zbx_compress_codec_name(zbx_tcp_compress_codec((unsigned char)flags)),
 			(double)reserved / (double)buffer_size);
 
 	ret = zbx_tcp_send_ext(sock, buffer, buffer_size, reserved, (unsigned char)flags,
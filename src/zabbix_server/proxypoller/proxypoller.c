@@ -170,6 +170,7 @@ static int	get_data_from_proxy(zbx_dc_proxy_t *proxy, const char *request, int c
 	zbx_json_init(&j, ZBX_JSON_STAT_BUF_LEN);
 
 	zbx_json_addstring(&j, "request", request, ZBX_JSON_TYPE_STRING);
+	zbx_add_compress_codecs(&j);
 
 	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
 	{
@@ -285,6 +286,9 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 		goto clean;
 	}
 
+	/* compress configuration with the best codec proxy has advertised */
+	flags = ZBX_TCP_PROTOCOL | zbx_get_compress_flags(&jp);
+
 	zbx_json_clean(&j);
 
 	if (SUCCEED != (ret = zbx_proxyconfig_get_data(proxy, &jp, &j, &status, config_vault, config_source_ip,
@@ -295,7 +299,8 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 		goto clean;
 	}
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	if (SUCCEED != zbx_compress_ext(zbx_tcp_compress_codec((unsigned char)flags), j.buffer, j.buffer_size,
+			&buffer, &buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		ret = FAIL;
@@ -308,8 +313,9 @@ static int	proxy_send_configuration(zbx_dc_proxy_t *proxy, const zbx_config_vaul
 	loglevel = (ZBX_PROXYCONFIG_STATUS_DATA == status ? LOG_LEVEL_WARNING : LOG_LEVEL_DEBUG);
 
 	zabbix_log(loglevel, "sending configuration data to proxy \"%s\" at \"%s\", datalen "
-			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with compression ratio %.1f", proxy->name,
+			ZBX_FS_SIZE_T ", bytes " ZBX_FS_SIZE_T " with %s compression ratio %.1f", proxy->name,
 			s.peer, (zbx_fs_size_t)reserved, (zbx_fs_size_t)buffer_size,
+			zbx_compress_codec_name(zbx_tcp_compress_codec((unsigned char)flags)),
 			(double)reserved / buffer_size);
 
 	ret = send_data_to_proxy(proxy, &s, buffer, buffer_size, reserved, flags);
@@ -716,6 +722,7 @@ ZBX_THREAD_ENTRY(proxypoller_thread, args)
 				proxy_poller_args_in->config_ssl_key_location,
 				proxy_poller_args_in->events_cbs, proxy_poller_args_in->proxyconfig_frequency,
 				proxy_poller_args_in->proxydata_frequency);
+		zbx_dc_flush_compress_stats();
 		total_sec += zbx_time() - sec;
 
 		nextcheck = zbx_dc_config_get_proxypoller_nextcheck();
@@ -64,6 +64,9 @@ int	zbx_send_proxy_data_response(const zbx_dc_proxy_t *proxy, zbx_socket_t *sock
 	if (0 != tasks.values_num)
 		zbx_tm_json_serialize_tasks(&json, &tasks);
 
+	/* advertise supported codecs for the next proxy data upload */
+	zbx_add_compress_codecs(&json);
+
 	flags |= ZBX_TCP_COMPRESS;
 
 	if (SUCCEED == (ret = zbx_tcp_send_ext(sock, json.buffer, strlen(json.buffer), 0, flags, config_timeout)))
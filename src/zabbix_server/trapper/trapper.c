@@ -46,6 +46,8 @@
 #include "version.h"
 #include "zbxscripts.h"
 
+#include <event2/event.h>
+
 #ifdef HAVE_NETSNMP
 #	include "zbxrtc.h"
 #endif
@@ -1106,6 +1108,9 @@ static int	comms_parse_response(char *xml, char *host, size_t host_len, char *ke
 	return ret;
 }
 
+/* minimum size of JSON message to build structural index for */
+#define TRAPPER_JSON_INDEX_SIZE	(64 * ZBX_KIBIBYTE)
+
 static int	process_trap(zbx_socket_t *sock, char *s, ssize_t bytes_received, zbx_timespec_t *ts,
 		const zbx_config_comms_args_t *config_comms, const zbx_config_vault_t *config_vault,
 		int config_startup_time, const zbx_events_funcs_t *events_cbs, int proxydata_frequency,
@@ -1141,6 +1146,10 @@ static int	process_trap(zbx_socket_t *sock, char *s, ssize_t bytes_received, zbx
 			return FAIL;
 		}
 
+		/* large data messages are navigated with structural index */
+		if (TRAPPER_JSON_INDEX_SIZE <= bytes_received)
+			zbx_json_index_open(&jp);
+
 		if (0 == strcmp(value, ZBX_PROTO_VALUE_AGENT_DATA))
 		{
 			recv_agenthistory(sock, &jp, ts, config_comms->config_timeout);
@@ -1209,6 +1218,8 @@ static int	process_trap(zbx_socket_t *sock, char *s, ssize_t bytes_received, zbx
 			zabbix_log(LOG_LEVEL_WARNING, "unknown request received from \"%s\": [%s]", sock->peer,
 				value);
 		}
+
+		zbx_json_index_close();
 	}
 	else if (0 == strncmp(s, "ZBX_GET_ACTIVE_CHECKS", 21))	/* request for list of active checks */
 	{
@@ -1292,19 +1303,302 @@ static int	process_trap(zbx_socket_t *sock, char *s, ssize_t bytes_received, zbx
 
 	return ret;
 }
+#undef TRAPPER_JSON_INDEX_SIZE
 
-static void	process_trapper_child(zbx_socket_t *sock, zbx_timespec_t *ts,
-		const zbx_config_comms_args_t *config_comms, const zbx_config_vault_t *config_vault,
-		int config_startup_time, const zbx_events_funcs_t *events_cbs, int proxydata_frequency,
-		zbx_get_config_forks_f get_config_forks)
+/* the maximum number of connections served concurrently by a trapper process */
+#define TRAPPER_CONNECTIONS_MAX	1000
+
+typedef struct
+{
+	struct event_base	*base;
+	zbx_socket_t		*listen_sock;
+	struct event		*listen_events[ZBX_SOCKET_COUNT];
+	struct event		*timer;
+	int			listening;
+	int			timeout;
+	zbx_vector_ptr_t	connections;
+	zbx_vector_ptr_t	requests;
+}
+trapper_events_t;
+
+typedef struct
+{
+	zbx_socket_t		s;
+	zbx_tcp_recv_context_t	recv_context;
+	zbx_timespec_t		ts;
+	time_t			deadline;
+	int			handshake;
+	ssize_t			bytes_received;
+	struct event		*event;
+	trapper_events_t	*trapper;
+}
+trapper_conn_t;
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: start or stop accepting new connections                           *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_listen(trapper_events_t *trapper, int listen)
+{
+	int	i;
+
+	if (listen == trapper->listening)
+		return;
+
+	for (i = 0; i < trapper->listen_sock->num_socks; i++)
+	{
+		if (0 != listen)
+			event_add(trapper->listen_events[i], NULL);
+		else
+			event_del(trapper->listen_events[i]);
+	}
+
+	trapper->listening = listen;
+}
+
+static void	trapper_conn_free(trapper_conn_t *conn)
+{
+	if (NULL != conn->event)
+		event_free(conn->event);
+
+	if (0 != conn->handshake)
+		zbx_tcp_recv_context_clear(&conn->recv_context);
+
+	zbx_tcp_unaccept(&conn->s);
+	zbx_free(conn);
+}
+
+static void	trapper_conn_close(trapper_conn_t *conn)
+{
+	trapper_events_t	*trapper = conn->trapper;
+	int			i;
+
+	if (FAIL != (i = zbx_vector_ptr_search(&trapper->connections, conn, ZBX_DEFAULT_PTR_COMPARE_FUNC)))
+		zbx_vector_ptr_remove_noorder(&trapper->connections, i);
+
+	trapper_conn_free(conn);
+	trapper_listen(trapper, 1);
+}
+
+static void	trapper_conn_event_cb(evutil_socket_t fd, short what, void *arg);
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: wait for connection socket to become ready                        *
+ *                                                                            *
+ * Parameters: conn - [IN] the connection                                     *
+ *             what - [IN] EV_READ or EV_WRITE                                *
+ *                                                                            *
+ * Comments: The connection is closed when the trapper timeout is reached.    *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_conn_wait(trapper_conn_t *conn, short what)
+{
+	struct timeval	tv;
+	time_t		now;
+
+	if (conn->deadline <= (now = time(NULL)))
+	{
+		trapper_conn_close(conn);
+		return;
+	}
+
+	if (NULL != conn->event)
+		event_free(conn->event);
+
+	conn->event = event_new(conn->trapper->base, conn->s.socket, what, trapper_conn_event_cb, conn);
+
+	tv.tv_sec = conn->deadline - now;
+	tv.tv_usec = 0;
+	event_add(conn->event, &tv);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: read available request data from connection                       *
+ *                                                                            *
+ * Comments: When the whole request is received the connection is queued for  *
+ *           processing, otherwise it waits for more data.                    *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_conn_read(trapper_conn_t *conn)
+{
+	short	events;
+
+	if (FAIL != (conn->bytes_received = zbx_tcp_recv_context(&conn->s, &conn->recv_context, ZBX_TCP_LARGE,
+			&events)))
+	{
+		zbx_vector_ptr_append(&conn->trapper->requests, conn);
+		return;
+	}
+
+	if (0 == events)
+	{
+		trapper_conn_close(conn);
+		return;
+	}
+
+	trapper_conn_wait(conn, 0 != (events & POLLIN) ? EV_READ : EV_WRITE);
+}
+
+static void	trapper_conn_event_cb(evutil_socket_t fd, short what, void *arg)
+{
+	trapper_conn_t	*conn = (trapper_conn_t *)arg;
+	short		events;
+
+	ZBX_UNUSED(fd);
+
+	if (0 != (what & EV_TIMEOUT))
+	{
+		zabbix_log(LOG_LEVEL_DEBUG, "timeout while receiving data from %s", conn->s.peer);
+		trapper_conn_close(conn);
+		return;
+	}
+
+	if (0 == conn->handshake)
+	{
+		/* Trapper has to accept all types of connections it can accept with the specified configuration. */
+		/* Only after receiving data it is known who has sent them and one can decide to accept or discard */
+		/* the data. */
+		if (SUCCEED != zbx_tcp_accept_handshake(&conn->s, ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK |
+				ZBX_TCP_SEC_UNENCRYPTED, &events))
+		{
+			if (0 != events)
+			{
+				trapper_conn_wait(conn, 0 != (events & POLLIN) ? EV_READ : EV_WRITE);
+				return;
+			}
+
+			zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming connection: %s",
+					zbx_socket_strerror());
+			trapper_conn_close(conn);
+			return;
+		}
+
+		conn->handshake = 1;
+		zbx_tcp_recv_context_init(&conn->s, &conn->recv_context, ZBX_TCP_LARGE);
+	}
+
+	trapper_conn_read(conn);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: accept new connection                                             *
+ *                                                                            *
+ * Comments: The connection handshake is done when the first data arrives and *
+ *           TLS handshake continues as the socket becomes ready, so slow or  *
+ *           idle connections do not block other connections.                 *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_accept_cb(evutil_socket_t fd, short what, void *arg)
 {
-	ssize_t	bytes_received;
+	trapper_events_t	*trapper = (trapper_events_t *)arg;
+	trapper_conn_t		*conn;
+	int			ret;
+
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(what);
+
+	conn = (trapper_conn_t *)zbx_malloc(NULL, sizeof(trapper_conn_t));
+	memcpy(&conn->s, trapper->listen_sock, sizeof(zbx_socket_t));
+
+	if (SUCCEED != (ret = zbx_tcp_accept_connection(&conn->s, 0)))
+	{
+		/* the connection might have been accepted by another trapper process */
+		if (TIMEOUT_ERROR != ret)
+		{
+			zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming connection: %s",
+					zbx_socket_strerror());
+		}
 
-	if (FAIL == (bytes_received = zbx_tcp_recv_ext(sock, config_comms->config_trapper_timeout, ZBX_TCP_LARGE)))
+		zbx_free(conn);
 		return;
+	}
+
+	/* get connection timestamp */
+	zbx_timespec(&conn->ts);
+
+	conn->deadline = (time_t)conn->ts.sec + trapper->timeout;
+	conn->handshake = 0;
+	conn->event = NULL;
+	conn->trapper = trapper;
 
-	process_trap(sock, sock->buffer, bytes_received, ts, config_comms, config_vault, config_startup_time,
-			events_cbs, proxydata_frequency, get_config_forks);
+	zbx_vector_ptr_append(&trapper->connections, conn);
+
+	if (TRAPPER_CONNECTIONS_MAX <= trapper->connections.values_num)
+		trapper_listen(trapper, 0);
+
+	trapper_conn_wait(conn, EV_READ);
+}
+
+static void	trapper_timer_cb(evutil_socket_t fd, short what, void *arg)
+{
+	ZBX_UNUSED(fd);
+	ZBX_UNUSED(what);
+	ZBX_UNUSED(arg);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: initialize event driven connection handling                       *
+ *                                                                            *
+ * Comments: Connections are accepted and requests received without blocking, *
+ *           so a trapper process can wait for many slow clients at once and  *
+ *           uses its database connection only to process complete requests.  *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_events_init(trapper_events_t *trapper, zbx_socket_t *listen_sock, int timeout,
+		const struct timeval *tv)
+{
+	int	i;
+
+	if (NULL == (trapper->base = event_base_new()))
+	{
+		zabbix_log(LOG_LEVEL_ERR, "cannot initialize event base");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < listen_sock->num_socks; i++)
+	{
+		trapper->listen_events[i] = event_new(trapper->base, listen_sock->sockets[i], EV_READ | EV_PERSIST,
+				trapper_accept_cb, trapper);
+	}
+
+	/* wake up periodically to check for shutdown */
+	trapper->timer = event_new(trapper->base, -1, EV_PERSIST, trapper_timer_cb, NULL);
+	event_add(trapper->timer, tv);
+
+	trapper->listen_sock = listen_sock;
+	trapper->listening = 0;
+	trapper->timeout = timeout;
+	zbx_vector_ptr_create(&trapper->connections);
+	zbx_vector_ptr_create(&trapper->requests);
+
+	trapper_listen(trapper, 1);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: close open connections and free event driven connection handling  *
+ *                                                                            *
+ ******************************************************************************/
+static void	trapper_events_destroy(trapper_events_t *trapper)
+{
+	int	i;
+
+	for (i = 0; i < trapper->connections.values_num; i++)
+		trapper_conn_free((trapper_conn_t *)trapper->connections.values[i]);
+
+	zbx_vector_ptr_destroy(&trapper->connections);
+	zbx_vector_ptr_destroy(&trapper->requests);
+
+	for (i = 0; i < trapper->listen_sock->num_socks; i++)
+		event_free(trapper->listen_events[i]);
+
+	event_free(trapper->timer);
+	event_base_free(trapper->base);
 }
 
 ZBX_THREAD_ENTRY(trapper_thread, args)
@@ -1313,8 +1607,9 @@ ZBX_THREAD_ENTRY(trapper_thread, args)
 	zbx_thread_trapper_args	*trapper_args_in = (zbx_thread_trapper_args *)
 					(((zbx_thread_args_t *)args)->args);
 	double			sec = 0.0;
-	zbx_socket_t		s;
-	int			ret;
+	trapper_events_t	trapper;
+	struct timeval		tv = {POLL_TIMEOUT, 0};
+	int			i;
 	const zbx_thread_info_t	*info = &((zbx_thread_args_t *)args)->info;
 	int			server_num = ((zbx_thread_args_t *)args)->info.server_num;
 	int			process_num = ((zbx_thread_args_t *)args)->info.process_num;
@@ -1331,8 +1626,6 @@ ZBX_THREAD_ENTRY(trapper_thread, args)
 
 	zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
-	memcpy(&s, trapper_args_in->listen_sock, sizeof(zbx_socket_t));
-
 #if defined(HAVE_GNUTLS) || defined(HAVE_OPENSSL)
 	zbx_tls_init_child(trapper_args_in->config_comms->config_tls, zbx_get_program_type_cb);
 	find_psk_in_cache = zbx_dc_get_psk_by_identity;
@@ -1346,6 +1639,9 @@ ZBX_THREAD_ENTRY(trapper_thread, args)
 			trapper_args_in->config_comms->config_timeout, &rtc);
 #endif
 
+	trapper_events_init(&trapper, trapper_args_in->listen_sock,
+			trapper_args_in->config_comms->config_trapper_timeout, &tv);
+
 	while (ZBX_IS_RUNNING())
 	{
 #ifdef HAVE_NETSNMP
@@ -1359,62 +1655,53 @@ ZBX_THREAD_ENTRY(trapper_thread, args)
 
 		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_IDLE);
 
-		/* Trapper has to accept all types of connections it can accept with the specified configuration. */
-		/* Only after receiving data it is known who has sent them and one can decide to accept or discard */
-		/* the data. */
-		ret = zbx_tcp_accept(&s, ZBX_TCP_SEC_TLS_CERT | ZBX_TCP_SEC_TLS_PSK | ZBX_TCP_SEC_UNENCRYPTED,
-				POLL_TIMEOUT);
+		event_base_loop(trapper.base, EVLOOP_ONCE);
 		zbx_update_env(get_process_type_string(process_type), zbx_time());
 
-		if (TIMEOUT_ERROR == ret)
+		if (0 == trapper.requests.values_num)
 			continue;
 
-		if (SUCCEED == ret)
-		{
-			zbx_timespec_t	ts;
-
-			/* get connection timestamp */
-			zbx_timespec(&ts);
-
-			zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
+		zbx_update_selfmon_counter(info, ZBX_PROCESS_STATE_BUSY);
 
-			zbx_setproctitle("%s #%d [processing data]", get_process_type_string(process_type),
-					process_num);
+		zbx_setproctitle("%s #%d [processing data]", get_process_type_string(process_type), process_num);
 
 #ifdef HAVE_NETSNMP
-			while (SUCCEED == zbx_rtc_wait(&rtc, info, &rtc_cmd, &rtc_data, 0) && 0 != rtc_cmd)
+		while (SUCCEED == zbx_rtc_wait(&rtc, info, &rtc_cmd, &rtc_data, 0) && 0 != rtc_cmd)
+		{
+			if (ZBX_RTC_SNMP_CACHE_RELOAD == rtc_cmd && 0 == snmp_reload)
 			{
-				if (ZBX_RTC_SNMP_CACHE_RELOAD == rtc_cmd && 0 == snmp_reload)
-				{
-					zbx_clear_cache_snmp(process_type, process_num, trapper_args_in->progname);
-					snmp_reload = 1;
-				}
-				else if (ZBX_RTC_SHUTDOWN == rtc_cmd)
-				{
-					zbx_tcp_unaccept(&s);
-					goto out;
-				}
-
+				zbx_clear_cache_snmp(process_type, process_num, trapper_args_in->progname);
+				snmp_reload = 1;
 			}
-#endif
-			sec = zbx_time();
-			process_trapper_child(&s, &ts, trapper_args_in->config_comms, trapper_args_in->config_vault,
-					trapper_args_in->config_startup_time, trapper_args_in->events_cbs,
-					trapper_args_in->proxydata_frequency,
-					trapper_args_in->get_process_forks_cb_arg);
-			sec = zbx_time() - sec;
+			else if (ZBX_RTC_SHUTDOWN == rtc_cmd)
+				goto out;
 
-			zbx_tcp_unaccept(&s);
 		}
-		else
+#endif
+		sec = zbx_time();
+
+		for (i = 0; i < trapper.requests.values_num; i++)
 		{
-			zabbix_log(LOG_LEVEL_WARNING, "failed to accept an incoming connection: %s",
-					zbx_socket_strerror());
+			trapper_conn_t	*conn = (trapper_conn_t *)trapper.requests.values[i];
+
+			process_trap(&conn->s, conn->s.buffer, conn->bytes_received, &conn->ts,
+					trapper_args_in->config_comms, trapper_args_in->config_vault,
+					trapper_args_in->config_startup_time, trapper_args_in->events_cbs,
+					trapper_args_in->proxydata_frequency, trapper_args_in->get_process_forks_cb_arg);
+
+			trapper_conn_close(conn);
 		}
+
+		zbx_vector_ptr_clear(&trapper.requests);
+		zbx_dc_flush_compress_stats();
+
+		sec = zbx_time() - sec;
 	}
 #ifdef HAVE_NETSNMP
 out:
 #endif
+	trapper_events_destroy(&trapper);
+
 	zbx_setproctitle("%s #%d [terminated]", get_process_type_string(process_type), process_num);
 
 	while (1)
@@ -1422,3 +1709,4 @@ out:
 
 #undef POLL_TIMEOUT
 }
+#undef TRAPPER_CONNECTIONS_MAX
@@ -72,14 +72,15 @@ static void	active_passive_misconfig(zbx_socket_t *sock, int config_timeout)
  *             buffer          -                                              *
  *             buffer_size     -                                              *
  *             reserved        -                                              *
+ *             flags           - [IN] the compression flags                   *
  *             config_timeout  - [IN]                                         *
  *             error           - [OUT] the error message                      *
  *                                                                            *
  ******************************************************************************/
 static int	send_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_size, size_t reserved,
-		int config_timeout, char **error)
+		unsigned char flags, int config_timeout, char **error)
 {
-	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | ZBX_TCP_COMPRESS,
+	if (SUCCEED != zbx_tcp_send_ext(sock, *buffer, buffer_size, reserved, ZBX_TCP_PROTOCOL | flags,
 			config_timeout))
 	{
 		*error = zbx_strdup(*error, zbx_socket_strerror());
@@ -99,14 +100,16 @@ static int	send_data_to_server(zbx_socket_t *sock, char **buffer, size_t buffer_
  * Purpose: sends 'proxy data' request to server                              *
  *                                                                            *
  * Parameters: sock                - [IN] connection socket                   *
+ *             jp_request          - [IN] received request                    *
  *             ts                  - [IN] connection timestamp                *
  *             config_comms        - [IN] proxy configuration for             *
  *                                        communication with server           *
  *             get_program_type_cb - [IN] callback to get program type        *
  *                                                                            *
  ******************************************************************************/
-static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
-		const zbx_config_comms_args_t *config_comms, zbx_get_program_type_f get_program_type_cb)
+static void	send_proxy_data(zbx_socket_t *sock, const struct zbx_json_parse *jp_request,
+		const zbx_timespec_t *ts, const zbx_config_comms_args_t *config_comms,
+		zbx_get_program_type_f get_program_type_cb)
 {
 	struct zbx_json		j;
 	zbx_uint64_t		areg_lastid = 0, history_lastid = 0, discovery_lastid = 0;
@@ -115,6 +118,7 @@ static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_vector_tm_task_t	tasks;
 	struct zbx_json_parse	jp, jp_tasks;
 	size_t			buffer_size, reserved;
+	unsigned char		flags;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -159,7 +163,10 @@ static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	if (0 != history_lastid && 0 != (proxy_delay = zbx_proxy_get_delay(history_lastid)))
 		zbx_json_addint64(&j, ZBX_PROTO_TAG_PROXY_DELAY, proxy_delay);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	flags = zbx_get_compress_flags(jp_request);
+
+	if (SUCCEED != zbx_compress_ext(zbx_tcp_compress_codec(flags), j.buffer, j.buffer_size, &buffer,
+			&buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
@@ -168,8 +175,8 @@ static void	send_proxy_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	reserved = j.buffer_size;
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
 
-	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, config_comms->config_timeout,
-			&error))
+	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, flags,
+			config_comms->config_timeout, &error))
 	{
 		zbx_set_availability_diff_ts(availability_ts);
 
@@ -226,12 +233,13 @@ out:
  * Purpose: sends 'task data' request to server                               *
  *                                                                            *
  * Parameters: sock             - [IN] connection socket                      *
+ *             jp_request       - [IN] received request                       *
  *             ts               - [IN] connection timestamp                   *
  *             config_comms     - [IN] proxy configuration for communication  *
  *                                     with server                            *
  *                                                                            *
  ******************************************************************************/
-static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
+static void	send_task_data(zbx_socket_t *sock, const struct zbx_json_parse *jp_request, const zbx_timespec_t *ts,
 		const zbx_config_comms_args_t *config_comms)
 {
 	struct zbx_json		j;
@@ -239,6 +247,7 @@ static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_vector_tm_task_t	tasks;
 	struct zbx_json_parse	jp, jp_tasks;
 	size_t			buffer_size, reserved;
+	unsigned char		flags;
 
 	zabbix_log(LOG_LEVEL_DEBUG, "In %s()", __func__);
 
@@ -261,7 +270,10 @@ static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_CLOCK, ts->sec);
 	zbx_json_addint64(&j, ZBX_PROTO_TAG_NS, ts->ns);
 
-	if (SUCCEED != zbx_compress(j.buffer, j.buffer_size, &buffer, &buffer_size))
+	flags = zbx_get_compress_flags(jp_request);
+
+	if (SUCCEED != zbx_compress_ext(zbx_tcp_compress_codec(flags), j.buffer, j.buffer_size, &buffer,
+			&buffer_size))
 	{
 		zabbix_log(LOG_LEVEL_ERR,"cannot compress data: %s", zbx_compress_strerror());
 		goto clean;
@@ -270,8 +282,8 @@ static void	send_task_data(zbx_socket_t *sock, const zbx_timespec_t *ts,
 	reserved = j.buffer_size;
 	zbx_json_free(&j);	/* json buffer can be large, free as fast as possible */
 
-	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, config_comms->config_timeout,
-			&error))
+	if (SUCCEED == send_data_to_server(sock, &buffer, buffer_size, reserved, flags,
+			config_comms->config_timeout, &error))
 	{
 		zbx_db_begin();
 
@@ -320,7 +332,6 @@ int	trapper_process_request(const char *request, zbx_socket_t *sock, const struc
 		const zbx_config_vault_t *config_vault, int proxydata_frequency,
 		zbx_get_program_type_f get_program_type_cb, const zbx_events_funcs_t *events_cbs)
 {
-	ZBX_UNUSED(jp);
 	ZBX_UNUSED(ts);
 	ZBX_UNUSED(proxydata_frequency);
 	ZBX_UNUSED(events_cbs);
@@ -350,7 +361,7 @@ int	trapper_process_request(const char *request, zbx_socket_t *sock, const struc
 	{
 		if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_PROXY_PASSIVE))
 		{
-			send_proxy_data(sock, ts, config_comms, get_program_type_cb);
+			send_proxy_data(sock, jp, ts, config_comms, get_program_type_cb);
 			return SUCCEED;
 		}
 		return FAIL;
@@ -359,7 +370,7 @@ int	trapper_process_request(const char *request, zbx_socket_t *sock, const struc
 	{
 		if (0 != (get_program_type_cb() & ZBX_PROGRAM_TYPE_PROXY_PASSIVE))
 		{
-			send_task_data(sock, ts, config_comms);
+			send_task_data(sock, jp, ts, config_comms);
 			return SUCCEED;
 		}
 		return FAIL;
@@ -58,18 +58,21 @@ AC_DEFUN([CONF_TESTS],
 			tests/libs/zbxalgo/Makefile
 			tests/libs/zbxcommon/Makefile
 			tests/libs/zbxcomms/Makefile
+			tests/libs/zbxcompress/Makefile
 			tests/libs/zbxcommshigh/Makefile
 			tests/libs/zbxconf/Makefile
 			tests/libs/zbxdbcache/Makefile
 			tests/libs/zbxdbhigh/Makefile
 			tests/libs/zbxeval/Makefile
 			tests/libs/zbxhistory/Makefile
+			tests/libs/zbxicmpping/Makefile
 			tests/libs/zbxjson/Makefile
 			tests/libs/zbxmodules/Makefile
 			tests/libs/zbxpoller/Makefile
 			tests/libs/zbxpreproc/Makefile
 			tests/libs/zbxprometheus/Makefile
 			tests/libs/zbxregexp/Makefile
+			tests/libs/zbxshmem/Makefile
 			tests/libs/zbxexpression/Makefile
 			tests/libs/zbxsysinfo/Makefile
 			tests/libs/zbxsysinfo/common/Makefile
@@ -77,8 +80,11 @@ AC_DEFUN([CONF_TESTS],
 			tests/libs/zbxtrends/Makefile
 			tests/libs/zbxhttp/Makefile
 			tests/libs/zbxtime/Makefile
+			tests/zabbix_agent/Makefile
+			tests/zabbix_agent/logfiles/Makefile
 			tests/zabbix_server/Makefile
 			tests/zabbix_server/pinger/Makefile
+			tests/zabbix_server/poller/Makefile
 			tests/zabbix_server/service/Makefile
 			tests/zabbix_server/trapper/Makefile
 			tests/mocks/Makefile
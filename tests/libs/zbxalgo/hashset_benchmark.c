@@ -0,0 +1,174 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxalgo.h"
+#include "zbxtime.h"
+
+typedef struct
+{
+	zbx_uint64_t	id;
+	zbx_uint64_t	value;
+}
+zbx_benchmark_entry_t;
+
+static void	benchmark_print(const char *impl, const char *op, int keys_num, double time)
+{
+	printf("%s %s keys:%d time:%.3f ops/s:%.0f\n", impl, op, keys_num, time, (double)keys_num / time);
+}
+
+static void	benchmark_hashset(const zbx_uint64_t *keys, int keys_num)
+{
+	zbx_hashset_t		hs;
+	zbx_benchmark_entry_t	entry;
+	double			time_start;
+	int			i, found = 0;
+
+	zbx_hashset_create(&hs, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+	{
+		entry.id = keys[i];
+		entry.value = (zbx_uint64_t)i;
+		zbx_hashset_insert(&hs, &entry, sizeof(entry));
+	}
+
+	benchmark_print("chained", "insert", keys_num, zbx_time() - time_start);
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+	{
+		if (NULL != zbx_hashset_search(&hs, &keys[(i * 31) % keys_num]))
+			found++;
+	}
+
+	benchmark_print("chained", "search", keys_num, zbx_time() - time_start);
+	zbx_mock_assert_int_eq("found keys", keys_num, found);
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+	{
+		entry.id = keys[i] + 1;
+
+		if (NULL != zbx_hashset_search(&hs, &entry))
+			found++;
+	}
+
+	benchmark_print("chained", "search missing", keys_num, zbx_time() - time_start);
+	zbx_mock_assert_int_eq("found keys", keys_num, found);
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+		zbx_hashset_remove(&hs, &keys[i]);
+
+	benchmark_print("chained", "remove", keys_num, zbx_time() - time_start);
+	zbx_mock_assert_int_eq("remaining keys", 0, hs.num_data);
+
+	zbx_hashset_destroy(&hs);
+}
+
+static void	benchmark_oahashset(const zbx_uint64_t *keys, int keys_num)
+{
+	zbx_oahashset_t		hs;
+	zbx_benchmark_entry_t	entry;
+	double			time_start;
+	int			i, found = 0;
+
+	zbx_oahashset_create(&hs, 0, sizeof(zbx_benchmark_entry_t), ZBX_DEFAULT_UINT64_HASH_FUNC,
+			ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+	{
+		entry.id = keys[i];
+		entry.value = (zbx_uint64_t)i;
+		zbx_oahashset_insert(&hs, &entry, sizeof(entry));
+	}
+
+	benchmark_print("open addressing", "insert", keys_num, zbx_time() - time_start);
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+	{
+		if (NULL != zbx_oahashset_search(&hs, &keys[(i * 31) % keys_num]))
+			found++;
+	}
+
+	benchmark_print("open addressing", "search", keys_num, zbx_time() - time_start);
+	zbx_mock_assert_int_eq("found keys", keys_num, found);
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+	{
+		entry.id = keys[i] + 1;
+
+		if (NULL != zbx_oahashset_search(&hs, &entry))
+			found++;
+	}
+
+	benchmark_print("open addressing", "search missing", keys_num, zbx_time() - time_start);
+	zbx_mock_assert_int_eq("found keys", keys_num, found);
+	time_start = zbx_time();
+
+	for (i = 0; i < keys_num; i++)
+		zbx_oahashset_remove(&hs, &keys[i]);
+
+	benchmark_print("open addressing", "remove", keys_num, zbx_time() - time_start);
+	zbx_mock_assert_int_eq("remaining keys", 0, hs.num_data);
+
+	zbx_oahashset_destroy(&hs);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_uint64_t	*keys;
+	int		i, keys_num;
+
+	ZBX_UNUSED(state);
+
+	keys_num = (int)zbx_mock_get_parameter_uint64("in.keys");
+	keys = (zbx_uint64_t *)zbx_malloc(NULL, sizeof(zbx_uint64_t) * (size_t)keys_num);
+
+	/* sparse identifiers inserted in random order, the even step keeps key + 1 missing */
+	for (i = 0; i < keys_num; i++)
+		keys[i] = (zbx_uint64_t)i * 7918 + 100000;
+
+	srand(0);
+
+	for (i = keys_num - 1; 0 < i; i--)
+	{
+		int		j = rand() % (i + 1);
+		zbx_uint64_t	key = keys[i];
+
+		keys[i] = keys[j];
+		keys[j] = key;
+	}
+
+	benchmark_hashset(keys, keys_num);
+	benchmark_oahashset(keys, keys_num);
+
+	zbx_free(keys);
+}
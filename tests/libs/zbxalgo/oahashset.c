@@ -0,0 +1,264 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxalgo.h"
+
+#define OAHASHSET_TEST_MAX_ALLOCS	8
+
+typedef struct
+{
+	zbx_uint64_t	id;
+	zbx_uint64_t	value;
+}
+zbx_mock_entry_t;
+
+static int	mock_allocs_num;
+
+static void	*mock_malloc(void *old, size_t size)
+{
+	mock_allocs_num++;
+
+	return zbx_malloc(old, size);
+}
+
+static void	*mock_realloc(void *old, size_t size)
+{
+	mock_allocs_num++;
+
+	return zbx_realloc(old, size);
+}
+
+static void	mock_free(void *ptr)
+{
+	zbx_free(ptr);
+}
+
+static zbx_hash_t	mock_collide_hash(const void *data)
+{
+	ZBX_UNUSED(data);
+
+	return 0;
+}
+
+/* returns hash function specified by the optional in.hash parameter */
+static zbx_hash_func_t	mock_get_hash_func(void)
+{
+	const char	*hash;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter_exists("in.hash"))
+		return ZBX_DEFAULT_UINT64_HASH_FUNC;
+
+	if (0 == strcmp(hash = zbx_mock_get_parameter_string("in.hash"), "collide"))
+		return mock_collide_hash;
+
+	if (0 != strcmp(hash, "default"))
+		fail_msg("unknown hash function \"%s\"", hash);
+
+	return ZBX_DEFAULT_UINT64_HASH_FUNC;
+}
+
+static void	mock_read_keys(const char *path, zbx_vector_uint64_t *keys)
+{
+	zbx_mock_handle_t	hkeys, hkey;
+	zbx_mock_error_t	err;
+
+	hkeys = zbx_mock_get_parameter_handle(path);
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hkeys, &hkey))))
+	{
+		zbx_uint64_t	key;
+
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_uint64(hkey, &key)))
+			fail_msg("Cannot read key: %s", zbx_mock_error_string(err));
+
+		zbx_vector_uint64_append(keys, key);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: performs random operations on open addressing and chained         *
+ *          hashsets and checks that their contents match                     *
+ *                                                                            *
+ ******************************************************************************/
+static void	mock_compare_random(zbx_hash_func_t hash_func, int iterations, int range)
+{
+	zbx_oahashset_t		oahs;
+	zbx_hashset_t		hs;
+	zbx_oahashset_iter_t	iter;
+	zbx_mock_entry_t	entry, *oa_entry, *entry_ptr;
+	int			i, num;
+
+	zbx_oahashset_create(&oahs, 0, sizeof(zbx_mock_entry_t), hash_func, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	zbx_hashset_create(&hs, 0, hash_func, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	srand(0);
+
+	for (i = 0; i < iterations; i++)
+	{
+		entry.id = (zbx_uint64_t)(rand() % range);
+		entry.value = (zbx_uint64_t)i;
+
+		switch (rand() % 4)
+		{
+			case 0:
+			case 1:
+				if (NULL == (oa_entry = (zbx_mock_entry_t *)zbx_oahashset_insert(&oahs, &entry,
+						sizeof(entry))))
+				{
+					fail_msg("cannot insert entry " ZBX_FS_UI64, entry.id);
+				}
+
+				entry_ptr = (zbx_mock_entry_t *)zbx_hashset_insert(&hs, &entry, sizeof(entry));
+				zbx_mock_assert_uint64_eq("inserted value", entry_ptr->value, oa_entry->value);
+				break;
+			case 2:
+				oa_entry = (zbx_mock_entry_t *)zbx_oahashset_search(&oahs, &entry);
+				entry_ptr = (zbx_mock_entry_t *)zbx_hashset_search(&hs, &entry);
+
+				if (NULL == entry_ptr)
+				{
+					zbx_mock_assert_ptr_eq("found entry", NULL, oa_entry);
+					break;
+				}
+
+				if (NULL == oa_entry)
+					fail_msg("entry " ZBX_FS_UI64 " was not found", entry.id);
+
+				zbx_mock_assert_uint64_eq("found value", entry_ptr->value, oa_entry->value);
+				zbx_oahashset_remove_direct(&oahs, oa_entry);
+				zbx_hashset_remove_direct(&hs, entry_ptr);
+				break;
+			default:
+				zbx_oahashset_remove(&oahs, &entry);
+				zbx_hashset_remove(&hs, &entry);
+				break;
+		}
+
+		zbx_mock_assert_int_eq("number of entries", hs.num_data, oahs.num_data);
+
+		/* the slot array must stay proportional to the number of entries, even with colliding hashes */
+		if (oahs.num_slots + oahs.num_overflow > 32 * (oahs.num_data + range))
+			fail_msg("too many slots %d for %d entries", oahs.num_slots + oahs.num_overflow, oahs.num_data);
+	}
+
+	num = 0;
+	zbx_oahashset_iter_reset(&oahs, &iter);
+
+	while (NULL != (oa_entry = (zbx_mock_entry_t *)zbx_oahashset_iter_next(&iter)))
+	{
+		if (NULL == (entry_ptr = (zbx_mock_entry_t *)zbx_hashset_search(&hs, oa_entry)))
+			fail_msg("unexpected entry " ZBX_FS_UI64, oa_entry->id);
+
+		zbx_mock_assert_uint64_eq("iterated value", entry_ptr->value, oa_entry->value);
+		num++;
+	}
+
+	zbx_mock_assert_int_eq("number of iterated entries", hs.num_data, num);
+
+	zbx_hashset_destroy(&hs);
+	zbx_oahashset_destroy(&oahs);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_oahashset_t		hs;
+	zbx_oahashset_iter_t	iter;
+	zbx_vector_uint64_t	keys, expected;
+	zbx_mock_entry_t	entry, *entry_ptr;
+	zbx_uint64_t		divisor;
+	zbx_hash_func_t		hash_func;
+	int			i;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_uint64_create(&keys);
+	zbx_vector_uint64_create(&expected);
+
+	hash_func = mock_get_hash_func();
+	zbx_oahashset_create_ext(&hs, 0, sizeof(zbx_mock_entry_t), hash_func, ZBX_DEFAULT_UINT64_COMPARE_FUNC, NULL,
+			mock_malloc, mock_realloc, mock_free);
+
+	mock_read_keys("in.insert", &keys);
+
+	for (i = 0; i < keys.values_num; i++)
+	{
+		entry.id = keys.values[i];
+		entry.value = keys.values[i] * 2;
+		if (NULL == (entry_ptr = (zbx_mock_entry_t *)zbx_oahashset_insert(&hs, &entry, sizeof(entry))))
+			fail_msg("cannot insert key " ZBX_FS_UI64, keys.values[i]);
+
+		zbx_mock_assert_uint64_eq("inserted key", keys.values[i], entry_ptr->id);
+	}
+
+	/* entries are stored in the slot array, memory is allocated only when the slot array grows */
+	if (OAHASHSET_TEST_MAX_ALLOCS < mock_allocs_num)
+		fail_msg("%d allocations for %d inserted keys", mock_allocs_num, keys.values_num);
+
+	zbx_vector_uint64_clear(&keys);
+	mock_read_keys("in.remove", &keys);
+
+	for (i = 0; i < keys.values_num; i++)
+		zbx_oahashset_remove(&hs, &keys.values[i]);
+
+	/* remove remaining keys divisible by the specified divisor while iterating */
+	divisor = zbx_mock_get_parameter_uint64("in.iter_remove");
+	zbx_oahashset_iter_reset(&hs, &iter);
+
+	while (NULL != (entry_ptr = (zbx_mock_entry_t *)zbx_oahashset_iter_next(&iter)))
+	{
+		if (0 == entry_ptr->id % divisor)
+			zbx_oahashset_iter_remove(&iter);
+	}
+
+	zbx_vector_uint64_clear(&keys);
+	zbx_oahashset_iter_reset(&hs, &iter);
+
+	while (NULL != (entry_ptr = (zbx_mock_entry_t *)zbx_oahashset_iter_next(&iter)))
+	{
+		zbx_mock_assert_uint64_eq("entry value", entry_ptr->id * 2, entry_ptr->value);
+		zbx_vector_uint64_append(&keys, entry_ptr->id);
+	}
+
+	zbx_vector_uint64_sort(&keys, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+	mock_read_keys("out.keys", &expected);
+
+	zbx_mock_assert_int_eq("number of entries", expected.values_num, hs.num_data);
+	zbx_mock_assert_int_eq("number of iterated entries", expected.values_num, keys.values_num);
+
+	for (i = 0; i < expected.values_num; i++)
+	{
+		zbx_mock_assert_uint64_eq("key", expected.values[i], keys.values[i]);
+
+		if (NULL == zbx_oahashset_search(&hs, &keys.values[i]))
+			fail_msg("cannot find key " ZBX_FS_UI64, keys.values[i]);
+	}
+
+	zbx_oahashset_destroy(&hs);
+	zbx_vector_uint64_destroy(&expected);
+	zbx_vector_uint64_destroy(&keys);
+
+	mock_compare_random(hash_func, (int)zbx_mock_get_parameter_uint64("in.random.iterations"),
+			(int)zbx_mock_get_parameter_uint64("in.random.range"));
+}
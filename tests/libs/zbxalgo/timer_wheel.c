@@ -0,0 +1,182 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxalgo.h"
+
+static void	mock_read_ints(zbx_mock_handle_t handle, zbx_vector_int32_t *values)
+{
+	zbx_mock_handle_t	hvalue;
+	zbx_mock_error_t	err;
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(handle, &hvalue))))
+	{
+		int	value;
+
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_int(hvalue, &value)))
+			fail_msg("Cannot read value: %s", zbx_mock_error_string(err));
+
+		zbx_vector_int32_append(values, value);
+	}
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: performs random operations on timer wheel and checks that nodes   *
+ *          are expired exactly when their expiry time is reached             *
+ *                                                                            *
+ ******************************************************************************/
+static void	mock_compare_random(int iterations, int nodes_num, int range)
+{
+	zbx_timer_wheel_t	wheel;
+	zbx_timer_wheel_node_t	*nodes, *node;
+	int			i, j, now = 1000000, scheduled = 0;
+
+	nodes = (zbx_timer_wheel_node_t *)zbx_calloc(NULL, (size_t)nodes_num, sizeof(zbx_timer_wheel_node_t));
+	zbx_timer_wheel_create(&wheel, now);
+
+	srand(0);
+
+	for (i = 0; i < iterations; i++)
+	{
+		node = &nodes[rand() % nodes_num];
+
+		switch (rand() % 4)
+		{
+			case 0:
+			case 1:
+				if (SUCCEED == zbx_timer_wheel_scheduled(node))
+				{
+					zbx_timer_wheel_remove(&wheel, node);
+					scheduled--;
+				}
+
+				/* mostly short delays with occasional long ones */
+				zbx_timer_wheel_insert(&wheel, node, now + (0 == rand() % 8 ? rand() % range :
+						rand() % 300));
+				scheduled++;
+				break;
+			case 2:
+				if (SUCCEED == zbx_timer_wheel_scheduled(node))
+				{
+					zbx_timer_wheel_remove(&wheel, node);
+					scheduled--;
+				}
+				break;
+			default:
+				now += rand() % 600;
+
+				while (NULL != (node = zbx_timer_wheel_expire(&wheel, now)))
+				{
+					if (node->expires > now)
+						fail_msg("node expiring at %d was expired at %d", node->expires, now);
+
+					scheduled--;
+				}
+
+				for (j = 0; j < nodes_num; j++)
+				{
+					if (SUCCEED == zbx_timer_wheel_scheduled(&nodes[j]) && nodes[j].expires <= now)
+						fail_msg("node expiring at %d was not expired at %d", nodes[j].expires, now);
+				}
+				break;
+		}
+
+		zbx_mock_assert_int_eq("number of scheduled nodes", scheduled, wheel.nodes_num);
+	}
+
+	zbx_free(nodes);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_timer_wheel_t	wheel;
+	zbx_timer_wheel_node_t	*nodes, *node;
+	zbx_vector_int32_t	values, expected, expired;
+	zbx_mock_handle_t	hsteps, hstep;
+	int			i, nodes_num, next;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_int32_create(&values);
+	zbx_vector_int32_create(&expected);
+	zbx_vector_int32_create(&expired);
+
+	zbx_timer_wheel_create(&wheel, (int)zbx_mock_get_parameter_uint64("in.time"));
+
+	mock_read_ints(zbx_mock_get_parameter_handle("in.nodes"), &values);
+	nodes_num = values.values_num;
+	nodes = (zbx_timer_wheel_node_t *)zbx_calloc(NULL, (size_t)MAX(nodes_num, 1), sizeof(zbx_timer_wheel_node_t));
+
+	for (i = 0; i < nodes_num; i++)
+		zbx_timer_wheel_insert(&wheel, &nodes[i], values.values[i]);
+
+	zbx_vector_int32_clear(&values);
+	mock_read_ints(zbx_mock_get_parameter_handle("in.remove"), &values);
+
+	for (i = 0; i < values.values_num; i++)
+		zbx_timer_wheel_remove(&wheel, &nodes[values.values[i]]);
+
+	hsteps = zbx_mock_get_parameter_handle("in.steps");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hsteps, &hstep))
+	{
+		int	now;
+
+		now = (int)zbx_mock_get_object_member_uint64(hstep, "now");
+
+		next = zbx_timer_wheel_next(&wheel);
+		zbx_mock_assert_int_eq("next expiry time", (int)zbx_mock_get_object_member_uint64(hstep, "next"),
+				FAIL == next ? 0 : next);
+
+		while (NULL != (node = zbx_timer_wheel_expire(&wheel, now)))
+		{
+			zbx_mock_assert_int_eq("node scheduling", FAIL, zbx_timer_wheel_scheduled(node));
+			zbx_vector_int32_append(&expired, node->expires);
+		}
+
+		zbx_vector_int32_sort(&expired, ZBX_DEFAULT_INT_COMPARE_FUNC);
+
+		zbx_vector_int32_clear(&expected);
+		mock_read_ints(zbx_mock_get_object_member_handle(hstep, "expired"), &expected);
+
+		zbx_mock_assert_int_eq("number of expired nodes", expected.values_num, expired.values_num);
+
+		for (i = 0; i < expected.values_num; i++)
+			zbx_mock_assert_int_eq("expired node", expected.values[i], expired.values[i]);
+
+		zbx_vector_int32_clear(&expired);
+	}
+
+	zbx_mock_assert_int_eq("number of remaining nodes", (int)zbx_mock_get_parameter_uint64("out.remaining"),
+			wheel.nodes_num);
+
+	zbx_free(nodes);
+	zbx_vector_int32_destroy(&expired);
+	zbx_vector_int32_destroy(&expected);
+	zbx_vector_int32_destroy(&values);
+
+	mock_compare_random((int)zbx_mock_get_parameter_uint64("in.random.iterations"),
+			(int)zbx_mock_get_parameter_uint64("in.random.nodes"),
+			(int)zbx_mock_get_parameter_uint64("in.random.range"));
+}
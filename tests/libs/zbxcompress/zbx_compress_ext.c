@@ -0,0 +1,165 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcompress.h"
+
+static int	mock_str_to_codec(const char *str)
+{
+	if (0 == strcmp(str, "zlib"))
+		return ZBX_COMPRESS_ZLIB;
+
+	if (0 == strcmp(str, "zstd"))
+		return ZBX_COMPRESS_ZSTD;
+
+	if (0 == strcmp(str, "lz4"))
+		return ZBX_COMPRESS_LZ4;
+
+	fail_msg("unknown compression codec \"%s\"", str);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char		*data;
+	char			*in, *compressed, *out, *stream_out = NULL;
+	size_t			data_len, in_len, compressed_len, out_len, offset, chunk = 0;
+	int			codec, i, repeat;
+	zbx_uncompress_stream_t	*stream;
+	zbx_compress_stats_t	stats[ZBX_COMPRESS_CODEC_NUM];
+
+	ZBX_UNUSED(state);
+
+	codec = mock_str_to_codec(zbx_mock_get_parameter_string("in.codec"));
+
+	if (SUCCEED != zbx_compress_codec_supported(codec))
+		skip();
+
+	data = zbx_mock_get_parameter_string("in.data");
+	repeat = (int)zbx_mock_get_parameter_uint64("in.repeat");
+	data_len = strlen(data);
+
+	in_len = data_len * (size_t)repeat;
+	in = (char *)zbx_malloc(NULL, in_len + 1);
+
+	for (i = 0; i < repeat; i++)
+		memcpy(in + data_len * (size_t)i, data, data_len);
+
+	/* reset statistics */
+	zbx_compress_get_stats(stats);
+
+	if (SUCCEED != zbx_compress_ext(codec, in, in_len, &compressed, &compressed_len))
+		fail_msg("cannot compress data: %s", zbx_compress_strerror());
+
+	zbx_compress_get_stats(stats);
+	zbx_mock_assert_uint64_eq("statistics size", in_len, stats[codec].size);
+	zbx_mock_assert_uint64_eq("statistics compressed size", compressed_len, stats[codec].size_compressed);
+
+	if (1 < repeat && compressed_len >= in_len)
+	{
+		fail_msg("compressed size " ZBX_FS_SIZE_T " is not less than input size " ZBX_FS_SIZE_T,
+				(zbx_fs_size_t)compressed_len, (zbx_fs_size_t)in_len);
+	}
+
+	out_len = in_len;
+	out = (char *)zbx_malloc(NULL, out_len + 1);
+
+	if (SUCCEED != zbx_uncompress_ext(codec, compressed, compressed_len, out, &out_len))
+		fail_msg("cannot uncompress data: %s", zbx_compress_strerror());
+
+	zbx_mock_assert_uint64_eq("uncompressed size", in_len, out_len);
+
+	if (0 != memcmp(in, out, in_len))
+		fail_msg("uncompressed data does not match input data");
+
+	/* uncompress data received in small parts */
+	if (NULL == (stream = zbx_uncompress_stream_open(codec, in_len)))
+		fail_msg("cannot open uncompression stream: %s", zbx_compress_strerror());
+
+	for (offset = 0; offset < compressed_len; offset += chunk)
+	{
+		chunk = MIN(compressed_len - offset, 7);
+
+		if (SUCCEED != zbx_uncompress_stream_write(stream, compressed + offset, chunk))
+			fail_msg("cannot uncompress data part: %s", zbx_compress_strerror());
+	}
+
+	if (SUCCEED != zbx_uncompress_stream_close(stream, &stream_out, &out_len))
+		fail_msg("cannot finish uncompression stream: %s", zbx_compress_strerror());
+
+	zbx_mock_assert_uint64_eq("stream uncompressed size", in_len, out_len);
+
+	if (0 != memcmp(in, stream_out, in_len) || '\0' != stream_out[in_len])
+		fail_msg("stream uncompressed data does not match input data");
+
+	zbx_free(stream_out);
+
+	/* maximum size larger than the uncompressed data */
+	if (NULL == (stream = zbx_uncompress_stream_open(codec, in_len * 1000)))
+		fail_msg("cannot open uncompression stream: %s", zbx_compress_strerror());
+
+	zbx_mock_assert_result_eq("stream write", SUCCEED, zbx_uncompress_stream_write(stream, compressed,
+			compressed_len));
+	zbx_mock_assert_result_eq("stream close", SUCCEED, zbx_uncompress_stream_close(stream, &stream_out,
+			&out_len));
+	zbx_mock_assert_uint64_eq("stream uncompressed size", in_len, out_len);
+
+	if (0 != memcmp(in, stream_out, in_len))
+		fail_msg("stream uncompressed data does not match input data");
+
+	zbx_free(stream_out);
+
+	/* maximum size too small for the uncompressed data */
+	if (1 < in_len)
+	{
+		if (NULL == (stream = zbx_uncompress_stream_open(codec, in_len / 2)))
+			fail_msg("cannot open uncompression stream: %s", zbx_compress_strerror());
+
+		if (SUCCEED == zbx_uncompress_stream_write(stream, compressed, compressed_len))
+		{
+			zbx_mock_assert_result_eq("stream close", FAIL, zbx_uncompress_stream_close(stream, NULL,
+					NULL));
+		}
+		else
+			zbx_uncompress_stream_close(stream, NULL, NULL);
+	}
+
+	/* incomplete compressed data */
+	if (NULL == (stream = zbx_uncompress_stream_open(codec, in_len)))
+		fail_msg("cannot open uncompression stream: %s", zbx_compress_strerror());
+
+	zbx_mock_assert_result_eq("stream write", SUCCEED, zbx_uncompress_stream_write(stream, compressed,
+			compressed_len - 1));
+	zbx_mock_assert_result_eq("stream close", FAIL, zbx_uncompress_stream_close(stream, &stream_out, NULL));
+
+	/* data compressed with one codec must not be accepted by the other */
+	out_len = in_len;
+	zbx_mock_assert_result_eq("uncompress with other codec", FAIL, zbx_uncompress_ext(
+			ZBX_COMPRESS_ZLIB == codec ? ZBX_COMPRESS_ZSTD : ZBX_COMPRESS_ZLIB, compressed,
+			compressed_len, out, &out_len));
+
+	zbx_free(out);
+	zbx_free(compressed);
+	zbx_free(in);
+}
@@ -0,0 +1,219 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcacheconfig.h"
+#include "zbxmutexs.h"
+#include "dbcache.h"
+
+#define MOCK_SHARD_ITEMS_MAX	1000
+
+typedef struct
+{
+	zbx_hc_item_t	item;
+	zbx_uint64_t	ts;
+}
+mock_hc_item_t;
+
+static int	mock_queue_elem_compare_func(const void *d1, const void *d2)
+{
+	const zbx_binary_heap_elem_t	*e1 = (const zbx_binary_heap_elem_t *)d1;
+	const zbx_binary_heap_elem_t	*e2 = (const zbx_binary_heap_elem_t *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(e1->key, e2->key);
+
+	return 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: reads shards from test data, shard items are identified by value  *
+ *          timestamps stored in element keys, item identifiers are           *
+ *          shard * 1000 + item index                                         *
+ *                                                                            *
+ ******************************************************************************/
+static int	mock_read_shards(zbx_binary_heap_t *queues, int queues_max, zbx_vector_ptr_t *items)
+{
+	zbx_mock_handle_t	hshards, hshard, hts;
+	zbx_mock_error_t	err;
+	int			queues_num = 0;
+
+	hshards = zbx_mock_get_parameter_handle("in.shards");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hshards, &hshard))))
+	{
+		int	index = 0;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("Cannot read shard: %s", zbx_mock_error_string(err));
+
+		if (queues_num == queues_max)
+			fail_msg("too many shards");
+
+		zbx_binary_heap_create(&queues[queues_num], mock_queue_elem_compare_func, ZBX_BINARY_HEAP_OPTION_EMPTY);
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hshard, &hts))))
+		{
+			mock_hc_item_t		*item;
+			zbx_binary_heap_elem_t	elem;
+			zbx_uint64_t		ts;
+
+			if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_uint64(hts, &ts)))
+				fail_msg("Cannot read timestamp: %s", zbx_mock_error_string(err));
+
+			/* items have no values, so popping fails if item data is accessed */
+			item = (mock_hc_item_t *)zbx_malloc(NULL, sizeof(mock_hc_item_t));
+			memset(item, 0, sizeof(mock_hc_item_t));
+			item->item.itemid = (zbx_uint64_t)(queues_num * MOCK_SHARD_ITEMS_MAX + index++);
+			item->ts = ts;
+
+			elem.key = ts << 32;
+			elem.data = (void *)item;
+			zbx_binary_heap_insert(&queues[queues_num], &elem);
+
+			zbx_vector_ptr_append(items, item);
+		}
+
+		queues_num++;
+	}
+
+	return queues_num;
+}
+
+static void	mock_item_free(mock_hc_item_t *item)
+{
+	zbx_free(item);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: syncers pop batches from history queue shards in turns, each      *
+ *          starting from its own shard that is advanced after every batch,   *
+ *          checks that items are popped oldest first within shards and that  *
+ *          shards without own syncer are not starved                         *
+ *                                                                            *
+ ******************************************************************************/
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_binary_heap_t	queues[ZBX_MUTEX_HISTORY_QUEUE_NUM];
+	zbx_vector_ptr_t	items, batch;
+	zbx_vector_uint64_t	popped[ZBX_MUTEX_HISTORY_QUEUE_NUM], expected;
+	zbx_uint64_t		last_ts[ZBX_MUTEX_HISTORY_QUEUE_NUM] = {0};
+	int			queues_num, syncers_num, batch_size, syncer, i, j, round;
+	zbx_mock_handle_t	hsyncers, hsyncer, hts;
+	zbx_mock_error_t	err;
+
+	ZBX_UNUSED(state);
+
+	zbx_vector_ptr_create(&items);
+	zbx_vector_ptr_create(&batch);
+	zbx_vector_uint64_create(&expected);
+
+	queues_num = mock_read_shards(queues, ZBX_MUTEX_HISTORY_QUEUE_NUM, &items);
+	syncers_num = (int)zbx_mock_get_parameter_uint64("in.syncers");
+	batch_size = (int)zbx_mock_get_parameter_uint64("in.batch");
+
+	if (0 == syncers_num || ZBX_MUTEX_HISTORY_QUEUE_NUM < syncers_num)
+		fail_msg("invalid number of syncers %d", syncers_num);
+
+	for (syncer = 0; syncer < syncers_num; syncer++)
+		zbx_vector_uint64_create(&popped[syncer]);
+
+	for (round = 0;; round++)
+	{
+		int	popped_num = 0;
+
+		for (syncer = 0; syncer < syncers_num; syncer++)
+		{
+			zbx_vector_ptr_clear(&batch);
+			hc_pop_queue_items(queues, queues_num, (syncer + round) % queues_num, batch_size, &batch);
+
+			if (batch_size < batch.values_num)
+				fail_msg("popped %d items while batch size is %d", batch.values_num, batch_size);
+
+			for (i = 0; i < batch.values_num; i++)
+			{
+				const mock_hc_item_t	*item = (const mock_hc_item_t *)batch.values[i];
+				int			shard = (int)(item->item.itemid / MOCK_SHARD_ITEMS_MAX);
+
+				if (item->ts < last_ts[shard])
+				{
+					fail_msg("item with timestamp " ZBX_FS_UI64 " popped from shard %d after "
+							ZBX_FS_UI64, item->ts, shard, last_ts[shard]);
+				}
+
+				last_ts[shard] = item->ts;
+				zbx_vector_uint64_append(&popped[syncer], item->ts);
+			}
+
+			popped_num += batch.values_num;
+		}
+
+		if (0 == popped_num)
+			break;
+	}
+
+	hsyncers = zbx_mock_get_parameter_handle("out.syncers");
+
+	for (syncer = 0; ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hsyncers, &hsyncer))); syncer++)
+	{
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("Cannot read syncer: %s", zbx_mock_error_string(err));
+
+		if (syncer == syncers_num)
+			fail_msg("too many expected syncers");
+
+		zbx_vector_uint64_clear(&expected);
+
+		while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(hsyncer, &hts))))
+		{
+			zbx_uint64_t	ts;
+
+			if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != (err = zbx_mock_uint64(hts, &ts)))
+				fail_msg("Cannot read timestamp: %s", zbx_mock_error_string(err));
+
+			zbx_vector_uint64_append(&expected, ts);
+		}
+
+		zbx_mock_assert_int_eq("number of popped items", expected.values_num, popped[syncer].values_num);
+
+		for (j = 0; j < expected.values_num; j++)
+			zbx_mock_assert_uint64_eq("popped timestamp", expected.values[j], popped[syncer].values[j]);
+	}
+
+	zbx_mock_assert_int_eq("number of syncers", syncers_num, syncer);
+
+	for (i = 0; i < queues_num; i++)
+	{
+		zbx_mock_assert_int_eq("remaining shard items", 0, queues[i].elems_num);
+		zbx_binary_heap_destroy(&queues[i]);
+	}
+
+	for (syncer = 0; syncer < syncers_num; syncer++)
+		zbx_vector_uint64_destroy(&popped[syncer]);
+
+	zbx_vector_ptr_clear_ext(&items, (zbx_clean_func_t)mock_item_free);
+	zbx_vector_ptr_destroy(&items);
+	zbx_vector_ptr_destroy(&batch);
+	zbx_vector_uint64_destroy(&expected);
+}
@@ -49,7 +49,7 @@ void	zbx_vc_common_test_func(
 		zbx_vc_test_get_values_setup_cb get_values_cb,
 		int test_check_result)
 {
-	int				err, seconds, count, cache_mode;
+	int				err, seconds, count, cache_mode, compression = ZBX_VC_COMPRESSION_NONE;
 	zbx_vector_history_record_t	expected, returned;
 	const char			*data;
 	char				*error;
@@ -67,7 +67,14 @@ void	zbx_vc_common_test_func(
 	err = zbx_locks_create(&error);
 	zbx_mock_assert_result_eq("Lock initialization failed", SUCCEED, err);
 
-	err = zbx_vc_init(get_zbx_config_value_cache_size(), &error);
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter("in.compression", &handle) &&
+			ZBX_MOCK_SUCCESS == zbx_mock_string(handle, &data) &&
+			0 == strcmp(data, "ZBX_VC_COMPRESSION_DELTA"))
+	{
+		compression = ZBX_VC_COMPRESSION_DELTA;
+	}
+
+	err = zbx_vc_init(get_zbx_config_value_cache_size(), compression, &error);
 	zbx_mock_assert_result_eq("Value cache initialization failed", SUCCEED, err);
 
 	zbx_vc_enable();
@@ -0,0 +1,126 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcachevalue.h"
+#include "valuecache_test.h"
+#include "mocks/valuecache/valuecache_mock.h"
+
+#include "zbx_vc_common.h"
+
+static void	zbx_vc_test_check_aggregate(zbx_mock_handle_t hrequest, zbx_mock_handle_t hexpected)
+{
+	zbx_uint64_t		itemid;
+	unsigned char		value_type;
+	int			seconds, count, ret;
+	zbx_timespec_t		ts;
+	zbx_vc_aggregate_t	aggregate;
+
+	zbx_vcmock_get_request_params(hrequest, &itemid, &value_type, &seconds, &count, &ts);
+	ret = zbx_vc_get_aggregate(itemid, value_type, seconds, &ts, &aggregate);
+
+	zbx_mock_assert_result_eq("zbx_vc_get_aggregate() return value",
+			zbx_mock_str_to_return_code(zbx_mock_get_object_member_string(hexpected, "return")), ret);
+
+	if (SUCCEED != ret)
+		return;
+
+	zbx_mock_assert_int_eq("values_num", (int)zbx_mock_get_object_member_uint64(hexpected, "values_num"),
+			aggregate.values_num);
+
+	if (ITEM_VALUE_TYPE_FLOAT == value_type)
+	{
+		zbx_mock_assert_double_eq("sum", zbx_mock_get_object_member_float(hexpected, "sum"), aggregate.sum.dbl);
+		zbx_mock_assert_double_eq("min", zbx_mock_get_object_member_float(hexpected, "min"), aggregate.min.dbl);
+		zbx_mock_assert_double_eq("max", zbx_mock_get_object_member_float(hexpected, "max"), aggregate.max.dbl);
+	}
+	else
+	{
+		zbx_mock_assert_uint64_eq("sum", zbx_mock_get_object_member_uint64(hexpected, "sum"),
+				aggregate.sum.ui64);
+		zbx_mock_assert_uint64_eq("min", zbx_mock_get_object_member_uint64(hexpected, "min"),
+				aggregate.min.ui64);
+		zbx_mock_assert_uint64_eq("max", zbx_mock_get_object_member_uint64(hexpected, "max"),
+				aggregate.max.ui64);
+	}
+
+	zbx_mock_assert_double_eq("avg", zbx_mock_get_object_member_float(hexpected, "avg"), aggregate.avg);
+}
+
+void	zbx_vc_test_get_aggregate_setup(zbx_mock_handle_t *handle, zbx_vector_ptr_t *history, int *err,
+		const char **data, int *ret_flush)
+{
+	zbx_mock_handle_t	hrequests, hrequest, hexpected, hitem;
+	zbx_uint64_t		itemid;
+	unsigned char		value_type;
+	int			seconds, count;
+	zbx_timespec_t		ts;
+	zbx_vc_aggregate_t	aggregate;
+
+	*handle = zbx_mock_get_parameter_handle("in.test");
+	zbx_vcmock_set_time(*handle, "time");
+	zbx_vcmock_set_mode(*handle, "cache mode");
+	zbx_vcmock_set_cache_size(*handle, "cache size");
+
+	/* the first request of a period adds it to the item */
+
+	hrequests = zbx_mock_get_object_member_handle(*handle, "requests");
+
+	while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hrequests, &hitem))
+	{
+		zbx_vcmock_get_request_params(hitem, &itemid, &value_type, &seconds, &count, &ts);
+		zbx_mock_assert_result_eq("zbx_vc_get_aggregate() return value", FAIL,
+				zbx_vc_get_aggregate(itemid, value_type, seconds, &ts, &aggregate));
+	}
+
+	zbx_vc_flush_stats();
+
+	zbx_vector_ptr_create(history);
+	zbx_vcmock_get_dc_history(zbx_mock_get_object_member_handle(*handle, "values"), history);
+
+	*err = zbx_vc_add_values(history, ret_flush);
+	*data = zbx_mock_get_parameter_string("out.return");
+	zbx_mock_assert_int_eq("zbx_vc_add_values()", zbx_mock_str_to_return_code(*data), *err);
+
+	zbx_vector_ptr_clear_ext(history, zbx_vcmock_free_dc_history);
+	zbx_vector_ptr_destroy(history);
+
+	/* check the aggregates after the values were added */
+
+	hrequests = zbx_mock_get_object_member_handle(*handle, "requests");
+	hexpected = zbx_mock_get_parameter_handle("out.aggregates");
+
+	while (ZBX_MOCK_END_OF_VECTOR != zbx_mock_vector_element(hrequests, &hrequest))
+	{
+		if (ZBX_MOCK_SUCCESS != zbx_mock_vector_element(hexpected, &hitem))
+			fail_msg("out.aggregates does not match in.test.requests");
+
+		zbx_vc_test_check_aggregate(hrequest, hitem);
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_vc_common_test_func(state, zbx_vc_test_get_aggregate_setup, NULL, NULL, 0);
+}
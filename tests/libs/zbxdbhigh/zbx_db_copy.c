@@ -0,0 +1,144 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxdbhigh.h"
+#include "zbxdbschema.h"
+#include "zbxnum.h"
+
+static char	*copy_sql, *copy_data;
+static size_t	copy_size;
+
+int	__wrap_zbx_db_copy_basic(const char *sql, const char *data, size_t size);
+
+int	__wrap_zbx_db_copy_basic(const char *sql, const char *data, size_t size)
+{
+	copy_sql = zbx_strdup(copy_sql, sql);
+	copy_data = (char *)zbx_realloc(copy_data, size);
+	memcpy(copy_data, data, size);
+	copy_size = size;
+
+	return ZBX_DB_OK;
+}
+
+static void	mock_read_value(const zbx_db_field_t *field, const char *str, zbx_db_value_t *value)
+{
+	switch (field->type)
+	{
+		case ZBX_TYPE_ID:
+		case ZBX_TYPE_UINT:
+			if (SUCCEED != zbx_is_uint64(str, &value->ui64))
+				fail_msg("invalid field \"%s\" value \"%s\"", field->name, str);
+			break;
+		case ZBX_TYPE_INT:
+			value->i32 = atoi(str);
+			break;
+		case ZBX_TYPE_FLOAT:
+			value->dbl = atof(str);
+			break;
+		default:
+			value->str = (char *)str;
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	const zbx_db_table_t	*table;
+	const zbx_db_field_t	*fields[ZBX_MAX_FIELDS];
+	zbx_db_value_t		values[ZBX_MAX_FIELDS], *pvalues[ZBX_MAX_FIELDS];
+	int			fields_num = 0, i;
+	zbx_mock_handle_t	hfields, hrows, hrow, hvalue;
+	zbx_mock_error_t	err;
+	const char		*str;
+	zbx_db_copy_t		copy;
+	char			*data = NULL, *expected;
+	size_t			data_alloc = 0, data_offset = 0;
+
+	ZBX_UNUSED(state);
+
+	if (NULL == (table = zbx_db_get_table(zbx_mock_get_parameter_string("in.table"))))
+		fail_msg("unknown table");
+
+	hfields = zbx_mock_get_parameter_handle("in.fields");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hfields, &hvalue)))
+	{
+		if (ZBX_MOCK_SUCCESS != err || ZBX_MOCK_SUCCESS != zbx_mock_string(hvalue, &str))
+			fail_msg("cannot read field name");
+
+		if (NULL == (fields[fields_num++] = zbx_db_get_field(table, str)))
+			fail_msg("unknown field \"%s\"", str);
+	}
+
+	zbx_db_copy_prepare_dyn(&copy, table, fields, fields_num);
+
+	for (i = 0; i < fields_num; i++)
+		pvalues[i] = &values[i];
+
+	hrows = zbx_mock_get_parameter_handle("in.rows");
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = zbx_mock_vector_element(hrows, &hrow)))
+	{
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read row");
+
+		for (i = 0; i < fields_num; i++)
+		{
+			if (ZBX_MOCK_SUCCESS != zbx_mock_vector_element(hrow, &hvalue) ||
+					ZBX_MOCK_SUCCESS != zbx_mock_string(hvalue, &str))
+			{
+				fail_msg("cannot read field \"%s\" value", fields[i]->name);
+			}
+
+			mock_read_value(fields[i], str, &values[i]);
+		}
+
+		zbx_db_copy_add_values_dyn(&copy, pvalues, fields_num);
+	}
+
+	zbx_mock_assert_result_eq("zbx_db_copy_execute()", SUCCEED, zbx_db_copy_execute(&copy));
+
+	/* nothing is copied without rows */
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter_exists("out.sql"))
+	{
+		zbx_mock_assert_ptr_eq("copy statement", NULL, copy_sql);
+		goto out;
+	}
+
+	zbx_mock_assert_str_eq("copy statement", zbx_mock_get_parameter_string("out.sql"), copy_sql);
+
+	for (i = 0; i < (int)copy_size; i++)
+		zbx_snprintf_alloc(&data, &data_alloc, &data_offset, "%02x", (unsigned char)copy_data[i]);
+
+	/* expected data is split with spaces for readability */
+	expected = zbx_strdup(NULL, zbx_mock_get_parameter_string("out.data"));
+	zbx_remove_chars(expected, " \n");
+	zbx_mock_assert_str_eq("copy data", expected, data);
+
+	zbx_free(expected);
+	zbx_free(data);
+out:
+	zbx_db_copy_clean(&copy);
+	zbx_free(copy_data);
+	zbx_free(copy_sql);
+}
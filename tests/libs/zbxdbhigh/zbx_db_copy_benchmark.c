@@ -0,0 +1,148 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxdbhigh.h"
+#include "zbxtime.h"
+
+/* The benchmark measures history syncer side of writing history batches - building */
+/* bulk insert statements or encoding bulk copy data. Statements are not sent to     */
+/* database, only their sizes are counted.                                            */
+
+static zbx_uint64_t	sent_bytes;
+
+int	__wrap_zbx_db_vexecute(const char *fmt, va_list args);
+int	__wrap_zbx_db_copy_basic(const char *sql, const char *data, size_t size);
+
+int	__wrap_zbx_db_vexecute(const char *fmt, va_list args)
+{
+	sent_bytes += (zbx_uint64_t)vsnprintf(NULL, 0, fmt, args);
+
+	return ZBX_DB_OK;
+}
+
+int	__wrap_zbx_db_copy_basic(const char *sql, const char *data, size_t size)
+{
+	ZBX_UNUSED(data);
+
+	sent_bytes += strlen(sql) + size;
+
+	return ZBX_DB_OK;
+}
+
+static void	benchmark_print(const char *impl, const char *table, int values_num, double time)
+{
+	printf("%s %s values:%d time:%.3f values/s:%.0f bytes/value:%.1f\n", impl, table, values_num, time,
+			(double)values_num / time, (double)sent_bytes / values_num);
+}
+
+static void	benchmark_insert(const char *table, unsigned char value_type, int values_num, int batch_size)
+{
+	zbx_db_insert_t	db_insert;
+	double		time_start;
+	int		i, j;
+
+	sent_bytes = 0;
+	time_start = zbx_time();
+
+	for (i = 0; i < values_num; i += batch_size)
+	{
+		zbx_db_insert_prepare(&db_insert, table, "itemid", "clock", "ns", "value", (char *)NULL);
+
+		for (j = i; j < i + batch_size && j < values_num; j++)
+		{
+			zbx_uint64_t	itemid = (zbx_uint64_t)(j % 10000) + 100000;
+
+			switch (value_type)
+			{
+				case ITEM_VALUE_TYPE_FLOAT:
+					zbx_db_insert_add_values(&db_insert, itemid, 1700000000 + j, j, (double)j / 3);
+					break;
+				case ITEM_VALUE_TYPE_UINT64:
+					zbx_db_insert_add_values(&db_insert, itemid, 1700000000 + j, j, (zbx_uint64_t)j * 1000);
+					break;
+				default:
+					zbx_db_insert_add_values(&db_insert, itemid, 1700000000 + j, j, "text 'value'");
+			}
+		}
+
+		zbx_mock_assert_result_eq("zbx_db_insert_execute()", SUCCEED, zbx_db_insert_execute(&db_insert));
+		zbx_db_insert_clean(&db_insert);
+	}
+
+	benchmark_print("insert", table, values_num, zbx_time() - time_start);
+}
+
+static void	benchmark_copy(const char *table, unsigned char value_type, int values_num, int batch_size)
+{
+	zbx_db_copy_t	db_copy;
+	double		time_start;
+	int		i, j;
+
+	sent_bytes = 0;
+	time_start = zbx_time();
+
+	for (i = 0; i < values_num; i += batch_size)
+	{
+		zbx_db_copy_prepare(&db_copy, table, "itemid", "clock", "ns", "value", (char *)NULL);
+
+		for (j = i; j < i + batch_size && j < values_num; j++)
+		{
+			zbx_uint64_t	itemid = (zbx_uint64_t)(j % 10000) + 100000;
+
+			switch (value_type)
+			{
+				case ITEM_VALUE_TYPE_FLOAT:
+					zbx_db_copy_add_values(&db_copy, itemid, 1700000000 + j, j, (double)j / 3);
+					break;
+				case ITEM_VALUE_TYPE_UINT64:
+					zbx_db_copy_add_values(&db_copy, itemid, 1700000000 + j, j, (zbx_uint64_t)j * 1000);
+					break;
+				default:
+					zbx_db_copy_add_values(&db_copy, itemid, 1700000000 + j, j, "text 'value'");
+			}
+		}
+
+		zbx_mock_assert_result_eq("zbx_db_copy_execute()", SUCCEED, zbx_db_copy_execute(&db_copy));
+		zbx_db_copy_clean(&db_copy);
+	}
+
+	benchmark_print("copy", table, values_num, zbx_time() - time_start);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char	*table;
+	unsigned char	value_type;
+	int		values_num, batch_size;
+
+	ZBX_UNUSED(state);
+
+	table = zbx_mock_get_parameter_string("in.table");
+	value_type = zbx_mock_str_to_value_type(zbx_mock_get_parameter_string("in.type"));
+	values_num = (int)zbx_mock_get_parameter_uint64("in.values");
+	batch_size = (int)zbx_mock_get_parameter_uint64("in.batch");
+
+	benchmark_insert(table, value_type, values_num, batch_size);
+	benchmark_copy(table, value_type, values_num, batch_size);
+}
@@ -82,6 +82,9 @@ void	zbx_mock_test_entry(void **state)
 
 	zbx_mock_assert_result_eq("return value", expected_ret, returned_ret);
 
+	if (SUCCEED != expected_ret && ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("out.error"))
+		zbx_mock_assert_str_eq("error message", zbx_mock_get_parameter_string("out.error"), error);
+
 	if (SUCCEED == expected_ret)
 	{
 		/* use custom epsilon for floating point values to account for */
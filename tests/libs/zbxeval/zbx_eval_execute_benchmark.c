@@ -0,0 +1,118 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxeval.h"
+#include "zbxnum.h"
+#include "zbxtime.h"
+#include "mock_eval.h"
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: sets token values as numeric values, like trigger functions are   *
+ *          set after evaluation                                              *
+ *                                                                            *
+ ******************************************************************************/
+static void	benchmark_read_values(zbx_eval_context_t *ctx, const char *path)
+{
+	zbx_mock_handle_t	htokens, htoken;
+	zbx_mock_error_t	err;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_parameter(path, &htokens))
+		return;
+
+	while (ZBX_MOCK_END_OF_VECTOR != (err = (zbx_mock_vector_element(htokens, &htoken))))
+	{
+		const char	*data, *value;
+		int		i;
+		size_t		data_len;
+
+		if (ZBX_MOCK_SUCCESS != err)
+			fail_msg("cannot read token contents");
+
+		data = zbx_mock_get_object_member_string(htoken, "token");
+		value = zbx_mock_get_object_member_string(htoken, "value");
+		data_len = strlen(data);
+
+		for (i = 0; i < ctx->stack.values_num; i++)
+		{
+			zbx_eval_token_t	*token = &ctx->stack.values[i];
+			zbx_uint64_t		ui64;
+
+			if (data_len != token->loc.r - token->loc.l + 1 ||
+					0 != memcmp(data, ctx->expression + token->loc.l, data_len))
+			{
+				continue;
+			}
+
+			if (SUCCEED == zbx_is_uint64(value, &ui64))
+				zbx_variant_set_ui64(&token->value, ui64);
+			else if (SUCCEED == zbx_is_double(value, NULL))
+				zbx_variant_set_dbl(&token->value, atof(value));
+			else
+				zbx_variant_set_str(&token->value, zbx_strdup(NULL, value));
+		}
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_eval_context_t	ctx;
+	zbx_variant_t		value;
+	char			*error = NULL;
+	const char		*expression;
+	double			time_start, time;
+	int			i, iterations;
+
+	ZBX_UNUSED(state);
+
+	expression = zbx_mock_get_parameter_string("in.expression");
+	iterations = (int)zbx_mock_get_parameter_uint64("in.iterations");
+
+	if (SUCCEED != zbx_eval_parse_expression(&ctx, expression, mock_eval_read_rules("in.rules"), &error))
+		fail_msg("failed to parse expression: %s", error);
+
+	benchmark_read_values(&ctx, "in.values");
+
+	time_start = zbx_time();
+
+	for (i = 0; i < iterations; i++)
+	{
+		if (SUCCEED != zbx_eval_execute(&ctx, NULL, &value, &error))
+			fail_msg("failed to execute expression: %s", error);
+
+		if (i != iterations - 1)
+			zbx_variant_clear(&value);
+	}
+
+	time = zbx_time() - time_start;
+
+	printf("%s executions:%d time:%.3f ops/s:%.0f\n", expression, iterations, time, (double)iterations / time);
+
+	zbx_mock_assert_str_eq("output value", zbx_mock_get_parameter_string("out.value"),
+			zbx_variant_value_desc(&value));
+
+	zbx_variant_clear(&value);
+	zbx_eval_clear(&ctx);
+}
@@ -0,0 +1,84 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxicmpping.h"
+
+static const char	*get_source_ip(void)
+{
+	return NULL;
+}
+
+/* fping is not used, the test requires privileges to open ICMP sockets */
+static const char	*get_fping_location(void)
+{
+	return "/nonexistent/fping";
+}
+
+static const char	*get_tmpdir(void)
+{
+	return "/tmp";
+}
+
+static const char	*get_progname(void)
+{
+	return "zbx_ping";
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_config_icmpping_t	config = {get_source_ip, get_fping_location, get_fping_location, get_tmpdir,
+					get_progname};
+	ZBX_FPING_HOST		host;
+	char			error[MAX_STRING_LEN];
+	int			ret, count;
+
+	ZBX_UNUSED(state);
+
+#ifndef HAVE_IPV6
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.ipv6_required"))
+		skip();
+#endif
+	zbx_init_library_icmpping(&config);
+
+	memset(&host, 0, sizeof(host));
+	host.addr = (char *)zbx_mock_get_parameter_string("in.addr");
+	count = (int)zbx_mock_get_parameter_uint64("in.count");
+
+	ret = zbx_ping(&host, 1, count, (int)zbx_mock_get_parameter_uint64("in.period"), 0,
+			(int)zbx_mock_get_parameter_uint64("in.timeout"), 0, 0, error, sizeof(error));
+
+	/* ICMP sockets cannot be opened without privileges and fping is not available */
+	if (SUCCEED != ret)
+		skip();
+
+	zbx_mock_assert_int_eq("sent requests", (int)zbx_mock_get_parameter_uint64("out.cnt"), host.cnt);
+	zbx_mock_assert_int_eq("received replies", (int)zbx_mock_get_parameter_uint64("out.rcv"), host.rcv);
+
+	if (0 != host.rcv)
+	{
+		if (host.min > host.max || host.min * host.rcv > host.sum || host.max * host.rcv < host.sum)
+			fail_msg("inconsistent response times min:" ZBX_FS_DBL " max:" ZBX_FS_DBL " sum:" ZBX_FS_DBL,
+					host.min, host.max, host.sum);
+	}
+}
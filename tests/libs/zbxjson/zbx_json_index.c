@@ -0,0 +1,111 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxjson.h"
+#include "zbxstr.h"
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: describe JSON structure as list of element offsets and closing    *
+ *          bracket offsets of nested objects and arrays                      *
+ *                                                                            *
+ ******************************************************************************/
+static void	json_walk(const char *base, const struct zbx_json_parse *jp, char **out, size_t *out_alloc,
+		size_t *out_offset)
+{
+	const char		*p = NULL, *value;
+	char			name[MAX_STRING_LEN];
+	struct zbx_json_parse	jp_child;
+
+	zbx_snprintf_alloc(out, out_alloc, out_offset, "%c", *jp->start);
+
+	for (;;)
+	{
+		if ('{' == *jp->start)
+		{
+			if (NULL == (value = p = zbx_json_pair_next(jp, p, name, sizeof(name))))
+				break;
+
+			zbx_snprintf_alloc(out, out_alloc, out_offset, "%s:", name);
+		}
+		else
+		{
+			if (NULL == (value = p = zbx_json_next(jp, p)))
+				break;
+		}
+
+		zbx_snprintf_alloc(out, out_alloc, out_offset, "%d", (int)(value - base));
+
+		if (SUCCEED == zbx_json_brackets_open(value, &jp_child))
+		{
+			zbx_snprintf_alloc(out, out_alloc, out_offset, "-%d", (int)(jp_child.end - base));
+			json_walk(base, &jp_child, out, out_alloc, out_offset);
+		}
+
+		zbx_chrcpy_alloc(out, out_alloc, out_offset, ' ');
+	}
+
+	zbx_snprintf_alloc(out, out_alloc, out_offset, "%c", *jp->end);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char		*json;
+	char			*buffer, *expected = NULL, *result = NULL;
+	size_t			expected_alloc = 0, expected_offset, result_alloc = 0, result_offset;
+	int			shift;
+	struct zbx_json_parse	jp;
+
+	ZBX_UNUSED(state);
+
+	json = zbx_mock_get_parameter_string("in.json");
+	buffer = (char *)zbx_malloc(NULL, strlen(json) + 64 + 1);
+
+	/* move text across index block boundaries */
+	for (shift = 0; shift < 64; shift++)
+	{
+		memset(buffer, ' ', (size_t)shift);
+		memcpy(buffer + shift, json, strlen(json) + 1);
+
+		if (SUCCEED != zbx_json_open(buffer, &jp))
+			fail_msg("cannot open JSON: %s", zbx_json_strerror());
+
+		expected_offset = 0;
+		json_walk(buffer, &jp, &expected, &expected_alloc, &expected_offset);
+
+		zbx_json_index_open(&jp);
+
+		result_offset = 0;
+		json_walk(buffer, &jp, &result, &result_alloc, &result_offset);
+
+		zbx_json_index_close();
+
+		zbx_mock_assert_str_eq("Invalid structure with index", expected, result);
+	}
+
+	zbx_free(result);
+	zbx_free(expected);
+	zbx_free(buffer);
+}
@@ -0,0 +1,192 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxcommon.h"
+#include "zbxcacheconfig.h"
+#include "zbxtimekeeper.h"
+#include "zbxpreproc.h"
+#include "libs/zbxpreproc/pp_queue.h"
+#include "libs/zbxpreproc/pp_task.h"
+#include "libs/zbxpreproc/pp_worker.h"
+
+#define PP_TEST_ITEMS_NUM	100
+
+static pthread_cond_t	finished_event = PTHREAD_COND_INITIALIZER;
+
+static void	test_finished_cb(void *data)
+{
+	ZBX_UNUSED(data);
+
+	pthread_cond_signal(&finished_event);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: requeue finished sequence task and check value ordering           *
+ *                                                                            *
+ * Return value: The finished value task.                                     *
+ *                                                                            *
+ ******************************************************************************/
+static zbx_pp_task_t	*test_requeue_sequence(zbx_pp_queue_t *queue, zbx_pp_task_t *task_seq, int *last_sec)
+{
+	zbx_pp_task_sequence_t	*d_seq = (zbx_pp_task_sequence_t *)PP_TASK_DATA(task_seq);
+	zbx_pp_task_t		*task, *next;
+	zbx_pp_task_value_t	*d;
+
+	if (SUCCEED != zbx_list_pop(&d_seq->tasks, (void **)&task))
+		fail_msg("empty task sequence");
+
+	d = (zbx_pp_task_value_t *)PP_TASK_DATA(task);
+
+	if (d->ts.sec < last_sec[task->itemid])
+		fail_msg("itemid " ZBX_FS_UI64 " value %d processed after %d", task->itemid, d->ts.sec,
+				last_sec[task->itemid]);
+
+	last_sec[task->itemid] = d->ts.sec;
+
+	if (SUCCEED == zbx_list_peek(&d_seq->tasks, (void **)&next))
+	{
+		pp_task_queue_push_immediate(queue, task_seq);
+		pp_task_queue_notify(queue);
+	}
+	else
+	{
+		pp_task_queue_remove_sequence(queue, task_seq->itemid);
+		pp_task_free(task_seq);
+	}
+
+	return task;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_pp_queue_t			queue;
+	zbx_pp_worker_t			*workers;
+	zbx_timekeeper_t		*timekeeper;
+	zbx_pp_item_preproc_t		*preproc;
+	zbx_dc_um_shared_handle_t	um_handle = {.um_cache = NULL, .refcount = 1};
+	char				*error = NULL;
+	int				i, workers_num, tasks_num, finished_num = 0, started_num = 0,
+					last_sec[PP_TEST_ITEMS_NUM] = {0}, *finished;
+	unsigned char			sequential;
+	zbx_timespec_t			ts = {0, 0};
+
+	ZBX_UNUSED(state);
+
+	workers_num = (int)zbx_mock_get_parameter_uint64("in.workers");
+	tasks_num = (int)zbx_mock_get_parameter_uint64("in.tasks");
+	sequential = (unsigned char)zbx_mock_get_parameter_uint64("in.sequential");
+
+	memset(&queue, 0, sizeof(queue));
+
+	if (SUCCEED != pp_task_queue_init(&queue, workers_num, &error))
+		fail_msg("cannot initialize task queue: %s", error);
+
+	timekeeper = zbx_timekeeper_create(workers_num, NULL);
+	preproc = zbx_pp_item_preproc_create(0, ITEM_TYPE_TRAPPER, ITEM_VALUE_TYPE_UINT64, 0);
+	workers = (zbx_pp_worker_t *)zbx_calloc(NULL, (size_t)workers_num, sizeof(zbx_pp_worker_t));
+	finished = (int *)zbx_calloc(NULL, (size_t)tasks_num, sizeof(int));
+
+	for (i = 0; i < workers_num; i++)
+	{
+		if (SUCCEED != pp_worker_init(&workers[i], i + 1, &queue, timekeeper, NULL, &error))
+			fail_msg("cannot start worker: %s", error);
+
+		pp_worker_set_finished_cb(&workers[i], test_finished_cb, NULL);
+	}
+
+	while (started_num != workers_num)
+	{
+		pp_task_queue_lock(&queue);
+		started_num = queue.workers_num;
+		pp_task_queue_unlock(&queue);
+	}
+
+	pp_task_queue_lock(&queue);
+
+	for (i = 0; i < tasks_num; i++)
+	{
+		zbx_variant_t	value;
+		zbx_pp_task_t	*task;
+
+		zbx_variant_set_ui64(&value, (zbx_uint64_t)i);
+		ts.sec = i;
+
+		if (0 == sequential)
+		{
+			task = pp_task_value_create(i % PP_TEST_ITEMS_NUM, preproc, &um_handle, &value, ts, NULL,
+					NULL);
+		}
+		else
+		{
+			task = pp_task_value_seq_create(i % PP_TEST_ITEMS_NUM, preproc, &um_handle, &value, ts,
+					NULL, NULL);
+		}
+
+		pp_task_queue_push(&queue, task);
+	}
+
+	pp_task_queue_notify_all(&queue);
+
+	while (finished_num < tasks_num)
+	{
+		zbx_pp_task_t	*task;
+
+		while (NULL != (task = pp_task_queue_pop_finished(&queue)))
+		{
+			zbx_pp_task_value_t	*d;
+
+			if (ZBX_PP_TASK_SEQUENCE == task->type)
+				task = test_requeue_sequence(&queue, task, last_sec);
+
+			d = (zbx_pp_task_value_t *)PP_TASK_DATA(task);
+
+			if (0 > d->ts.sec || tasks_num <= d->ts.sec || 0 != finished[d->ts.sec]++)
+				fail_msg("unexpected finished task %d", d->ts.sec);
+
+			pp_task_free(task);
+			finished_num++;
+		}
+
+		if (finished_num < tasks_num)
+			pthread_cond_wait(&finished_event, &queue.lock);
+	}
+
+	for (i = 0; i < workers_num; i++)
+		pp_worker_stop(&workers[i]);
+
+	pp_task_queue_notify_all(&queue);
+	pp_task_queue_unlock(&queue);
+
+	for (i = 0; i < workers_num; i++)
+		pp_worker_destroy(&workers[i]);
+
+	zbx_mock_assert_int_eq("finished tasks", tasks_num, finished_num);
+
+	zbx_free(finished);
+	zbx_free(workers);
+	zbx_timekeeper_free(timekeeper);
+	zbx_pp_item_preproc_release(preproc);
+	pp_task_queue_destroy(&queue);
+}
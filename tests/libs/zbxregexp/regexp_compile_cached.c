@@ -0,0 +1,62 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxregexp.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char		*pattern, *str;
+	const zbx_regexp_t	*regexp;
+	zbx_mock_handle_t	hpatterns, hpattern;
+	zbx_uint64_t		hits, misses;
+	char			*error = NULL;
+	int			ret, expected_ret;
+
+	ZBX_UNUSED(state);
+
+	str = zbx_mock_get_parameter_string("in.value");
+	hpatterns = zbx_mock_get_parameter_handle("in.patterns");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hpatterns, &hpattern))
+	{
+		pattern = zbx_mock_get_object_member_string(hpattern, "pattern");
+		expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_object_member_string(hpattern, "result"));
+
+		if (SUCCEED != zbx_regexp_compile_cached(pattern, &regexp, &error))
+			fail_msg("cannot compile pattern \"%s\": %s", pattern, error);
+
+		ret = (0 == zbx_regexp_match_precompiled(str, regexp)) ? SUCCEED : FAIL;
+
+		if (ret != expected_ret)
+		{
+			fail_msg("String \"%s\" unexpectedly %s pattern \"%s\"",
+					str, SUCCEED == ret ? "matches" : "doesn't match", pattern);
+		}
+	}
+
+	zbx_regexp_cache_get_stats(&hits, &misses);
+
+	zbx_mock_assert_uint64_eq("cache hits", zbx_mock_get_parameter_uint64("out.hits"), hits);
+	zbx_mock_assert_uint64_eq("cache misses", zbx_mock_get_parameter_uint64("out.misses"), misses);
+}
@@ -0,0 +1,50 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxregexp.h"
+
+void	zbx_mock_test_entry(void **state)
+{
+	const char	*pattern, *expected;
+	char		*literal;
+
+	ZBX_UNUSED(state);
+
+	pattern = zbx_mock_get_parameter_string("in.pattern");
+	literal = zbx_regexp_get_literal(pattern);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("out.literal"))
+	{
+		expected = zbx_mock_get_parameter_string("out.literal");
+
+		if (NULL == literal)
+			fail_msg("expected literal \"%s\" but got none", expected);
+
+		zbx_mock_assert_str_eq("literal", expected, literal);
+	}
+	else if (NULL != literal)
+		fail_msg("unexpected literal \"%s\"", literal);
+
+	zbx_free(literal);
+}
@@ -0,0 +1,145 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "zbxshmem.h"
+#include "zbxalgo.h"
+
+typedef struct
+{
+	unsigned char	*ptr;
+	size_t		size;
+}
+zbx_mock_shmem_alloc_t;
+
+static void	mock_fill(zbx_mock_shmem_alloc_t *alloc, int index)
+{
+	memset(alloc->ptr, (unsigned char)index, alloc->size);
+}
+
+static void	mock_check(const zbx_mock_shmem_alloc_t *alloc, int index)
+{
+	size_t	i;
+
+	for (i = 0; i < alloc->size; i++)
+	{
+		if ((unsigned char)index != alloc->ptr[i])
+			fail_msg("allocation #%d of size " ZBX_FS_SIZE_T " was overwritten", index,
+					(zbx_fs_size_t)alloc->size);
+	}
+}
+
+static void	mock_check_stats(zbx_shmem_info_t *info, const char *path)
+{
+	zbx_shmem_stats_t	stats;
+	zbx_mock_handle_t	hstats;
+
+	zbx_shmem_get_stats(info, &stats);
+	hstats = zbx_mock_get_parameter_handle(path);
+
+	zbx_mock_assert_uint64_eq("slab pages", zbx_mock_get_object_member_uint64(hstats, "pages"),
+			stats.slab_pages);
+	zbx_mock_assert_uint64_eq("used slab objects", zbx_mock_get_object_member_uint64(hstats, "used"),
+			stats.slab_used_objects);
+	zbx_mock_assert_uint64_eq("free slab objects", zbx_mock_get_object_member_uint64(hstats, "free"),
+			stats.slab_free_objects);
+
+	if (stats.slab_free_size > stats.free_size)
+	{
+		fail_msg("free memory " ZBX_FS_UI64 " does not include free slab objects " ZBX_FS_UI64,
+				stats.free_size, stats.slab_free_size);
+	}
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_shmem_info_t	*info;
+	zbx_mock_handle_t	hallocs, halloc;
+	zbx_mock_shmem_alloc_t	*allocs = NULL;
+	int			i, j, allocs_num = 0, allocs_alloc = 0;
+	char			*error = NULL;
+
+	ZBX_UNUSED(state);
+
+	if (SUCCEED != zbx_shmem_create(&info, zbx_mock_get_parameter_uint64("in.size"), "test cache", "TestCache",
+			0, &error))
+	{
+		fail_msg("cannot create shared memory: %s", error);
+	}
+
+	zbx_shmem_enable_slabs(info);
+
+	hallocs = zbx_mock_get_parameter_handle("in.allocs");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hallocs, &halloc))
+	{
+		size_t	size;
+		int	count;
+
+		size = (size_t)zbx_mock_get_object_member_uint64(halloc, "size");
+		count = (int)zbx_mock_get_object_member_uint64(halloc, "count");
+
+		for (j = 0; j < count; j++)
+		{
+			if (allocs_num == allocs_alloc)
+			{
+				allocs_alloc = MAX(16, allocs_alloc * 2);
+				allocs = (zbx_mock_shmem_alloc_t *)zbx_realloc(allocs,
+						sizeof(zbx_mock_shmem_alloc_t) * (size_t)allocs_alloc);
+			}
+
+			allocs[allocs_num].size = size;
+			allocs[allocs_num].ptr = (unsigned char *)zbx_shmem_malloc(info, NULL, size);
+			mock_fill(&allocs[allocs_num], allocs_num);
+			allocs_num++;
+		}
+	}
+
+	for (i = 0; i < allocs_num; i++)
+		mock_check(&allocs[i], i);
+
+	mock_check_stats(info, "out.allocated");
+
+	/* grow every other allocation, then release all of them */
+
+	for (i = 0; i < allocs_num; i += 2)
+	{
+		allocs[i].ptr = (unsigned char *)zbx_shmem_realloc(info, allocs[i].ptr, allocs[i].size * 2);
+		memset(allocs[i].ptr + allocs[i].size, (unsigned char)i, allocs[i].size);
+		allocs[i].size *= 2;
+	}
+
+	for (i = 0; i < allocs_num; i++)
+	{
+		mock_check(&allocs[i], i);
+		zbx_shmem_free(info, allocs[i].ptr);
+	}
+
+	mock_check_stats(info, "out.freed");
+
+	/* slab pages kept for reuse must not be reported as used memory */
+	zbx_mock_assert_uint64_eq("used memory", 0, info->used_size);
+
+	zbx_free(allocs);
+	zbx_shmem_destroy(info);
+}
@@ -0,0 +1,61 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../../src/libs/zbxsysinfo/linux/proc.c"
+
+static int	str_to_value_type(const char *str)
+{
+	if (0 == strcmp(str, "PROC_VAL_TYPE_NUM"))
+		return PROC_VAL_TYPE_NUM;
+
+	if (0 == strcmp(str, "PROC_VAL_TYPE_BYTE"))
+		return PROC_VAL_TYPE_BYTE;
+
+	if (0 == strcmp(str, "PROC_VAL_TYPE_ID"))
+		return PROC_VAL_TYPE_ID;
+
+	fail_msg("unknown value type \"%s\"", str);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	char		*value;
+	zbx_uint64_t	num;
+	int		ret, expected_ret;
+
+	ZBX_UNUSED(state);
+
+	value = zbx_strdup(NULL, zbx_mock_get_parameter_string("in.value"));
+	ret = proc_parse_value(value, str_to_value_type(zbx_mock_get_parameter_string("in.type")), &num);
+
+	expected_ret = zbx_mock_str_to_return_code(zbx_mock_get_parameter_string("out.return"));
+	zbx_mock_assert_result_eq("proc_parse_value() return value", expected_ret, ret);
+
+	if (SUCCEED == expected_ret)
+		zbx_mock_assert_uint64_eq("parsed value", zbx_mock_get_parameter_uint64("out.num"), num);
+
+	zbx_free(value);
+}
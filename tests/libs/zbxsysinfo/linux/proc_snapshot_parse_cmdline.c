@@ -0,0 +1,55 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../../src/libs/zbxsysinfo/linux/proc.c"
+
+void	zbx_mock_test_entry(void **state)
+{
+	proc_snapshot_entry_t	entry;
+	const char		*data;
+	char			*buf;
+	size_t			data_len;
+
+	ZBX_UNUSED(state);
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_binary(zbx_mock_get_parameter_handle("in.cmdline"), &data, &data_len))
+		fail_msg("invalid binary parameter \"in.cmdline\"");
+
+	/* the file contents are terminated with '\0' not included in file size as by proc_snapshot_read_file() */
+	buf = (char *)zbx_malloc(NULL, data_len + 1);
+	memcpy(buf, data, data_len);
+	buf[data_len] = '\0';
+
+	memset(&entry, 0, sizeof(entry));
+	proc_snapshot_parse_cmdline(&entry, buf, data_len);
+
+	zbx_mock_assert_str_eq("cmdline", zbx_mock_get_parameter_string("out.cmdline"), entry.cmdline);
+	zbx_mock_assert_str_eq("arg0", zbx_mock_get_parameter_string("out.arg0"), entry.arg0);
+	zbx_mock_assert_str_eq("arg0 name", zbx_mock_get_parameter_string("out.arg0_name"), entry.arg0_name);
+	zbx_mock_assert_uint64_eq("cmdline size", zbx_mock_get_parameter_uint64("out.nbytes"), entry.cmdline_nbytes);
+
+	zbx_free(entry.cmdline);
+	zbx_free(entry.arg0);
+	zbx_free(buf);
+}
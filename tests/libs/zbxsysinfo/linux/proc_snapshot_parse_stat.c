@@ -0,0 +1,86 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../../src/libs/zbxsysinfo/linux/proc.c"
+
+static int	str_to_stat_error(const char *str)
+{
+	if (0 == strcmp(str, "SUCCEED"))
+		return SUCCEED;
+
+	if (0 == strcmp(str, "EFAULT"))
+		return -EFAULT;
+
+	if (0 == strcmp(str, "EINVAL"))
+		return -EINVAL;
+
+	if (0 == strcmp(str, "ENODATA"))
+		return -ENODATA;
+
+	fail_msg("unknown stat error \"%s\"", str);
+
+	return FAIL;
+}
+
+static void	mock_assert_stat_value(const char *name, zbx_uint64_t value)
+{
+	char	path[MAX_STRING_LEN];
+
+	zbx_snprintf(path, sizeof(path), "out.%s", name);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists(path))
+		zbx_mock_assert_uint64_eq(name, zbx_mock_get_parameter_uint64(path), value);
+	else
+		zbx_mock_assert_uint64_eq(name, ZBX_MAX_UINT64, value);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	proc_snapshot_entry_t	entry;
+	char			*buf;
+
+	ZBX_UNUSED(state);
+
+	memset(&entry, 0, sizeof(entry));
+	entry.page_faults = entry.utime = entry.stime = entry.starttime = ZBX_MAX_UINT64;
+	buf = zbx_strdup(NULL, zbx_mock_get_parameter_string("in.stat"));
+
+	proc_snapshot_parse_stat(&entry, buf);
+
+	zbx_mock_assert_int_eq("stat error", str_to_stat_error(zbx_mock_get_parameter_string("out.error")),
+			entry.stat_error);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("out.comm"))
+		zbx_mock_assert_str_eq("comm", zbx_mock_get_parameter_string("out.comm"), entry.comm);
+	else
+		zbx_mock_assert_ptr_eq("comm", NULL, entry.comm);
+
+	mock_assert_stat_value("page_faults", entry.page_faults);
+	mock_assert_stat_value("utime", entry.utime);
+	mock_assert_stat_value("stime", entry.stime);
+	mock_assert_stat_value("starttime", entry.starttime);
+
+	zbx_free(entry.comm);
+	zbx_free(buf);
+}
@@ -0,0 +1,92 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../../src/libs/zbxsysinfo/linux/proc.c"
+
+static void	mock_assert_optional_str_eq(const char *path, const char *value)
+{
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists(path))
+		zbx_mock_assert_str_eq(path, zbx_mock_get_parameter_string(path), value);
+	else
+		zbx_mock_assert_ptr_eq(path, NULL, value);
+}
+
+static int	status_field_index(const char *label)
+{
+	for (int i = 0; i < PROC_STATUS_FIELDS_NUM; i++)
+	{
+		if (0 == strcmp(label, proc_status_fields[i].label))
+			return i;
+	}
+
+	fail_msg("unknown status field \"%s\"", label);
+
+	return FAIL;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	proc_snapshot_entry_t	entry;
+	zbx_mock_handle_t	hfields, hfield, hvalue;
+	zbx_uint32_t		found = 0, invalid = 0;
+	char			*buf;
+	int			i;
+
+	ZBX_UNUSED(state);
+
+	memset(&entry, 0, sizeof(entry));
+	buf = zbx_strdup(NULL, zbx_mock_get_parameter_string("in.status"));
+
+	proc_snapshot_parse_status(&entry, buf);
+
+	mock_assert_optional_str_eq("out.name", entry.name);
+	mock_assert_optional_str_eq("out.state", entry.state);
+
+	hfields = zbx_mock_get_parameter_handle("out.fields");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hfields, &hfield))
+	{
+		i = status_field_index(zbx_mock_get_object_member_string(hfield, "label"));
+		found |= (zbx_uint32_t)1 << i;
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hfield, "value", &hvalue))
+		{
+			zbx_uint64_t	value;
+
+			if (ZBX_MOCK_SUCCESS != zbx_mock_uint64(hvalue, &value))
+				fail_msg("invalid value of field \"%s\"", proc_status_fields[i].label);
+
+			zbx_mock_assert_uint64_eq(proc_status_fields[i].label, value, entry.status[i]);
+		}
+		else
+			invalid |= (zbx_uint32_t)1 << i;
+	}
+
+	zbx_mock_assert_uint64_eq("found fields", found, entry.status_found);
+	zbx_mock_assert_uint64_eq("invalid fields", invalid, entry.status_invalid);
+
+	zbx_free(entry.name);
+	zbx_free(entry.state);
+	zbx_free(buf);
+}
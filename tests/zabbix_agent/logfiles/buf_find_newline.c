@@ -0,0 +1,86 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/zabbix_agent/logfiles/logfiles.c"
+
+static void	get_binary_parameter(const char *path, const char **data, size_t *len)
+{
+	if (ZBX_MOCK_SUCCESS != zbx_mock_binary(zbx_mock_get_parameter_handle(path), data, len))
+		fail_msg("invalid binary parameter \"%s\"", path);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_mock_handle_t	hrecords, hrecord;
+	const char		*data, *expected, *encoding = "", *cr, *lf;
+	char			*buf, *p, *p_nl, *p_next;
+	size_t			data_len, expected_len, szbyte;
+
+	ZBX_UNUSED(state);
+
+	get_binary_parameter("in.data", &data, &data_len);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.encoding"))
+		encoding = zbx_mock_get_parameter_string("in.encoding");
+
+	zbx_find_cr_lf_szbyte(encoding, &cr, &lf, &szbyte);
+
+	/* the data is copied to exact size buffer so that reading past the end is detected by memory checkers */
+	buf = (char *)zbx_malloc(NULL, data_len);
+	memcpy(buf, data, data_len);
+	p = buf;
+
+	hrecords = zbx_mock_get_parameter_handle("out.records");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hrecords, &hrecord))
+	{
+		if (ZBX_MOCK_SUCCESS != zbx_mock_binary(hrecord, &expected, &expected_len))
+			fail_msg("invalid binary record");
+
+		if (NULL == (p_nl = buf_find_newline(p, &p_next, buf + data_len, cr, lf, szbyte)))
+			fail_msg("expected record at offset %d", (int)(p - buf));
+
+		zbx_mock_assert_int_eq("record length", (int)expected_len, (int)(p_nl - p));
+
+		if (0 != memcmp(expected, p, expected_len))
+			fail_msg("unexpected record at offset %d", (int)(p - buf));
+
+		p = p_next;
+	}
+
+	zbx_mock_assert_ptr_eq("line end after the last record", NULL,
+			buf_find_newline(p, &p_next, buf + data_len, cr, lf, szbyte));
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("out.rest"))
+		get_binary_parameter("out.rest", &expected, &expected_len);
+	else
+		expected_len = 0;
+
+	zbx_mock_assert_int_eq("rest length", (int)expected_len, (int)(buf + data_len - p));
+
+	if (0 != expected_len && 0 != memcmp(expected, p, expected_len))
+		fail_msg("unexpected data after the last record");
+
+	zbx_free(buf);
+}
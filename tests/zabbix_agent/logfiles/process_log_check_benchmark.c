@@ -0,0 +1,165 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/zabbix_agent/logfiles/logfiles.c"
+
+/* The benchmark measures how fast a log[] item reads a generated log file. The file is read */
+/* with zbx_read2(), the reader of process_log_check(), from a descriptor opened by the      */
+/* benchmark because test programs are linked with open() and stat() mocked. Values are not  */
+/* sent anywhere, only counted.                                                              */
+
+static int	values_num;
+
+static int	benchmark_process_value(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_result,
+		const char *host, const char *key, const char *value, unsigned char state, zbx_uint64_t *lastlogsize,
+		const int *mtime, const unsigned long *timestamp, const char *source, const unsigned short *severity,
+		const unsigned long *logeventid, unsigned char flags, const zbx_config_tls_t *config_tls,
+		int config_timeout, const char *config_source_ip, int config_buffer_send, int config_buffer_size)
+{
+	ZBX_UNUSED(addrs);
+	ZBX_UNUSED(agent2_result);
+	ZBX_UNUSED(host);
+	ZBX_UNUSED(key);
+	ZBX_UNUSED(value);
+	ZBX_UNUSED(state);
+	ZBX_UNUSED(lastlogsize);
+	ZBX_UNUSED(mtime);
+	ZBX_UNUSED(timestamp);
+	ZBX_UNUSED(source);
+	ZBX_UNUSED(severity);
+	ZBX_UNUSED(logeventid);
+	ZBX_UNUSED(flags);
+	ZBX_UNUSED(config_tls);
+	ZBX_UNUSED(config_timeout);
+	ZBX_UNUSED(config_source_ip);
+	ZBX_UNUSED(config_buffer_send);
+	ZBX_UNUSED(config_buffer_size);
+
+	values_num++;
+
+	return SUCCEED;
+}
+
+static zbx_uint64_t	benchmark_write_file(int fd, int lines_num, int error_every)
+{
+	char		*data = NULL;
+	size_t		data_alloc = 0, data_offset = 0;
+	int		i;
+	zbx_uint64_t	size = 0;
+
+	for (i = 0; i < lines_num; i++)
+	{
+		if (0 == i % error_every)
+		{
+			zbx_snprintf_alloc(&data, &data_alloc, &data_offset, "2023-11-01 12:00:00.%03d ERROR %d"
+					" cannot process request from 192.168.1.%d: connection reset by peer\n",
+					i % 1000, i, i % 255);
+		}
+		else
+		{
+			zbx_snprintf_alloc(&data, &data_alloc, &data_offset, "2023-11-01 12:00:00.%03d INFO %d"
+					" request from 192.168.1.%d served in %d ms path=/api/v1/items/%d\n",
+					i % 1000, i, i % 255, i % 500, i);
+		}
+
+		if (ZBX_MEBIBYTE <= data_offset || i == lines_num - 1)
+		{
+			if ((ssize_t)data_offset != write(fd, data, data_offset))
+				fail_msg("cannot write file: %s", zbx_strerror(errno));
+
+			size += data_offset;
+			data_offset = 0;
+		}
+	}
+
+	zbx_free(data);
+
+	return size;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	struct st_logfile	logfile;
+	zbx_vector_expression_t	regexps;
+	zbx_uint64_t		size, lastlogsize = 0, lastlogsize_sent = 0;
+	int			fd, lines_num, error_every, maxlines, mtime = 0, mtime_sent = 0, big_rec = 0,
+				checks_num = 0;
+	const char		*pattern = "", *output_template = NULL;
+	char			filename[] = "/tmp/zbx_log_benchmark_XXXXXX", *error = NULL;
+	double			time_start, time;
+
+	ZBX_UNUSED(state);
+
+	lines_num = (int)zbx_mock_get_parameter_uint64("in.lines");
+	error_every = (int)zbx_mock_get_parameter_uint64("in.error_every");
+	maxlines = (int)zbx_mock_get_parameter_uint64("in.maxlines");
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.pattern"))
+		pattern = zbx_mock_get_parameter_string("in.pattern");
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.output"))
+		output_template = zbx_mock_get_parameter_string("in.output");
+
+	if (-1 == (fd = mkstemp(filename)))
+		fail_msg("cannot create file \"%s\": %s", filename, zbx_strerror(errno));
+
+	size = benchmark_write_file(fd, lines_num, error_every);
+
+	memset(&logfile, 0, sizeof(logfile));
+	zbx_vector_expression_create(&regexps);
+
+	values_num = 0;
+	time_start = zbx_time();
+
+	/* every check reads from the last processed position like process_log() does */
+	while (lastlogsize < size)
+	{
+		int	s_count = maxlines, p_count = MAX_VALUE_LINES_MULTIPLIER * maxlines;
+
+		zbx_lseek(fd, (zbx_offset_t)lastlogsize, SEEK_SET);
+
+		if (SUCCEED != zbx_read2(fd, ZBX_METRIC_FLAG_LOG_LOG, &logfile, &lastlogsize, &mtime, &big_rec, "",
+				&regexps, pattern, output_template, &p_count, &s_count, benchmark_process_value, NULL,
+				NULL, "benchmark", "log[]", &lastlogsize_sent, &mtime_sent, NULL, NULL, NULL, 3, NULL,
+				0, 0, 0, &error))
+		{
+			fail_msg("log check failed: %s", ZBX_NULL2STR(error));
+		}
+
+		checks_num++;
+	}
+
+	time = zbx_time() - time_start;
+
+	printf("log[,%s] lines:%d values:%d checks:%d time:%.3f MB/s:%.1f lines/s:%.0f\n", pattern, lines_num,
+			values_num, checks_num, time, (double)size / time / ZBX_MEBIBYTE, (double)lines_num / time);
+
+	zbx_mock_assert_uint64_eq("processed size", size, lastlogsize);
+	zbx_mock_assert_int_eq("values", (int)zbx_mock_get_parameter_uint64("out.values"), values_num);
+
+	close(fd);
+	unlink(filename);
+
+	zbx_vector_expression_destroy(&regexps);
+}
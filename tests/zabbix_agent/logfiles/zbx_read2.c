@@ -0,0 +1,179 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+
+#include "../../../src/zabbix_agent/logfiles/logfiles.c"
+
+static zbx_vector_str_t	values;
+
+static int	read2_process_value(zbx_vector_addr_ptr_t *addrs, zbx_vector_ptr_t *agent2_result, const char *host,
+		const char *key, const char *value, unsigned char state, zbx_uint64_t *lastlogsize, const int *mtime,
+		const unsigned long *timestamp, const char *source, const unsigned short *severity,
+		const unsigned long *logeventid, unsigned char flags, const zbx_config_tls_t *config_tls,
+		int config_timeout, const char *config_source_ip, int config_buffer_send, int config_buffer_size)
+{
+	ZBX_UNUSED(addrs);
+	ZBX_UNUSED(agent2_result);
+	ZBX_UNUSED(host);
+	ZBX_UNUSED(key);
+	ZBX_UNUSED(state);
+	ZBX_UNUSED(lastlogsize);
+	ZBX_UNUSED(mtime);
+	ZBX_UNUSED(timestamp);
+	ZBX_UNUSED(source);
+	ZBX_UNUSED(severity);
+	ZBX_UNUSED(logeventid);
+	ZBX_UNUSED(flags);
+	ZBX_UNUSED(config_tls);
+	ZBX_UNUSED(config_timeout);
+	ZBX_UNUSED(config_source_ip);
+	ZBX_UNUSED(config_buffer_send);
+	ZBX_UNUSED(config_buffer_size);
+
+	zbx_vector_str_append(&values, zbx_strdup(NULL, value));
+
+	return SUCCEED;
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: get data block, either a binary string or an object with binary   *
+ *          'data' repeated 'repeat' times, occurring 'count' times           *
+ *                                                                            *
+ ******************************************************************************/
+static void	read2_get_block(zbx_mock_handle_t hblock, char **data, size_t *data_alloc, size_t *data_offset,
+		zbx_uint64_t *count)
+{
+	zbx_mock_handle_t	hdata, hmember;
+	const char		*block;
+	size_t			block_len;
+	zbx_uint64_t		i, repeat = 1;
+
+	*count = 1;
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hblock, "data", &hdata))
+	{
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hblock, "repeat", &hmember) &&
+				ZBX_MOCK_SUCCESS != zbx_mock_uint64(hmember, &repeat))
+		{
+			fail_msg("invalid block repeat value");
+		}
+
+		if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hblock, "count", &hmember) &&
+				ZBX_MOCK_SUCCESS != zbx_mock_uint64(hmember, count))
+		{
+			fail_msg("invalid block count value");
+		}
+	}
+	else
+		hdata = hblock;
+
+	if (ZBX_MOCK_SUCCESS != zbx_mock_binary(hdata, &block, &block_len))
+		fail_msg("invalid binary data block");
+
+	for (i = 0; i < repeat; i++)
+		zbx_str_memcpy_alloc(data, data_alloc, data_offset, block, block_len);
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_mock_handle_t	hblocks, hblock;
+	struct st_logfile	logfile;
+	zbx_vector_expression_t	regexps;
+	zbx_uint64_t		lastlogsize = 0, lastlogsize_sent = 0;
+	int			fd, mtime = 0, mtime_sent = 0, big_rec = 0, p_count = 1000000, s_count = 1000000, i;
+	char			filename[] = "/tmp/zbx_read2_XXXXXX", *data = NULL, *err_msg = NULL;
+	size_t			data_alloc = 0, data_offset = 0;
+	const char		*encoding = "", *pattern = "";
+
+	ZBX_UNUSED(state);
+
+	hblocks = zbx_mock_get_parameter_handle("in.file");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hblocks, &hblock))
+	{
+		zbx_uint64_t	count;
+
+		read2_get_block(hblock, &data, &data_alloc, &data_offset, &count);
+	}
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.encoding"))
+		encoding = zbx_mock_get_parameter_string("in.encoding");
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.pattern"))
+		pattern = zbx_mock_get_parameter_string("in.pattern");
+
+	if (-1 == (fd = mkstemp(filename)))
+		fail_msg("cannot create file \"%s\": %s", filename, zbx_strerror(errno));
+
+	if ((ssize_t)data_offset != write(fd, data, data_offset))
+		fail_msg("cannot write file \"%s\": %s", filename, zbx_strerror(errno));
+
+	zbx_lseek(fd, 0, SEEK_SET);
+
+	memset(&logfile, 0, sizeof(logfile));
+	zbx_vector_expression_create(&regexps);
+	zbx_vector_str_create(&values);
+
+	zbx_mock_assert_result_eq("zbx_read2() return value", SUCCEED, zbx_read2(fd, ZBX_METRIC_FLAG_LOG_LOG,
+			&logfile, &lastlogsize, &mtime, &big_rec, encoding, &regexps, pattern, NULL, &p_count, &s_count,
+			read2_process_value, NULL, NULL, "", "log[]", &lastlogsize_sent, &mtime_sent, NULL, NULL, NULL,
+			3, NULL, 0, 0, 0, &err_msg));
+
+	hblocks = zbx_mock_get_parameter_handle("out.values");
+	i = 0;
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hblocks, &hblock))
+	{
+		char		*expected = NULL;
+		size_t		expected_alloc = 0, expected_offset = 0;
+		zbx_uint64_t	count;
+
+		read2_get_block(hblock, &expected, &expected_alloc, &expected_offset, &count);
+
+		for (; 0 < count; count--, i++)
+		{
+			if (i >= values.values_num)
+				fail_msg("expected more than %d values", values.values_num);
+
+			zbx_mock_assert_int_eq("value length", (int)expected_offset, (int)strlen(values.values[i]));
+			zbx_mock_assert_str_eq("value", expected, values.values[i]);
+		}
+
+		zbx_free(expected);
+	}
+
+	zbx_mock_assert_int_eq("number of values", i, values.values_num);
+	zbx_mock_assert_uint64_eq("lastlogsize", zbx_mock_get_parameter_uint64("out.lastlogsize"), lastlogsize);
+	zbx_mock_assert_int_eq("incomplete", (int)zbx_mock_get_parameter_uint64("out.incomplete"),
+			logfile.incomplete);
+	zbx_mock_assert_int_eq("big_rec", (int)zbx_mock_get_parameter_uint64("out.big_rec"), big_rec);
+
+	close(fd);
+	unlink(filename);
+
+	zbx_vector_str_clear_ext(&values, zbx_str_free);
+	zbx_vector_str_destroy(&values);
+	zbx_vector_expression_destroy(&regexps);
+	zbx_free(data);
+}
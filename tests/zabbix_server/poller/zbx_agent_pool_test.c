@@ -0,0 +1,118 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxcommon.h"
+
+#include "../../../src/zabbix_server/poller/async_agent.c"
+
+int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num);
+
+int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num)
+{
+	ZBX_UNUSED(local_server_num);
+	ZBX_UNUSED(local_process_type);
+	ZBX_UNUSED(local_process_num);
+
+	return 0;
+}
+
+int	MAIN_ZABBIX_ENTRY(int flags)
+{
+	ZBX_UNUSED(flags);
+
+	return 0;
+}
+
+void	zbx_mock_test_entry(void **state)
+{
+	zbx_agent_pool_t	pool;
+	zbx_agent_context	agent_context;
+	zbx_agent_conn_t	*conn;
+	zbx_hashset_iter_t	iter;
+	int			keepalive, ret, fds[2] = {-1, -1};
+	char			addr[] = "127.0.0.1";
+
+	ZBX_UNUSED(state);
+
+	zbx_async_agent_pool_init(&pool);
+
+	memset(&agent_context, 0, sizeof(agent_context));
+	agent_context.pool = &pool;
+	agent_context.item.interface.interfaceid = 1;
+	agent_context.item.interface.addr = addr;
+	agent_context.item.interface.port = 10050;
+	agent_context.tls_connect = ZBX_TCP_SEC_UNENCRYPTED;
+	zbx_socket_clean(&agent_context.s);
+
+	agent_context.tcp_recv_context.protocol_version = (unsigned char)zbx_mock_get_parameter_uint64("in.protocol");
+	agent_context.tcp_recv_context.reserved = (zbx_uint64_t)zbx_mock_get_parameter_uint64("in.reserved");
+
+	keepalive = agent_response_keepalive(&agent_context);
+	zbx_mock_assert_int_eq("keep-alive", (int)zbx_mock_get_parameter_uint64("out.keepalive"), keepalive);
+
+	if (0 != keepalive)
+	{
+		if (0 != socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+			fail_msg("cannot create socket pair: %s", zbx_strerror(errno));
+
+		agent_context.s.socket = fds[0];
+		agent_pool_put(&agent_context, keepalive);
+	}
+
+	zbx_hashset_iter_reset(&pool.connections, &iter);
+
+	while (NULL != (conn = (zbx_agent_conn_t *)zbx_hashset_iter_next(&iter)))
+	{
+		zbx_mock_assert_ptr_eq("pooled socket buffer", conn->s->buf_stat, conn->s->buffer);
+		conn->expires -= (time_t)zbx_mock_get_parameter_uint64("in.elapsed");
+	}
+
+	zbx_async_agent_pool_expire(&pool, time(NULL));
+	zbx_mock_assert_int_eq("pooled connections", (int)zbx_mock_get_parameter_uint64("out.pooled"),
+			pool.connections.num_data);
+
+	if (ZBX_MOCK_SUCCESS == zbx_mock_parameter_exists("in.port"))
+		agent_context.item.interface.port = (unsigned short)zbx_mock_get_parameter_uint64("in.port");
+
+	if (-1 != fds[1] && 0 == strcmp("yes", zbx_mock_get_parameter_string("in.agent_closed")))
+	{
+		close(fds[1]);
+		fds[1] = -1;
+	}
+
+	ret = agent_pool_take(&agent_context);
+	zbx_mock_assert_result_eq("take connection", zbx_mock_str_to_return_code(zbx_mock_get_parameter_string(
+			"out.return")), ret);
+	zbx_mock_assert_int_eq("connections left in pool", 0, pool.connections.num_data);
+
+	if (SUCCEED == ret)
+	{
+		zbx_mock_assert_int_eq("taken socket", fds[0], agent_context.s.socket);
+		zbx_mock_assert_ptr_eq("taken socket buffer", agent_context.s.buf_stat, agent_context.s.buffer);
+		zbx_tcp_close(&agent_context.s);
+	}
+
+	if (-1 != fds[1])
+		close(fds[1]);
+
+	zbx_async_agent_pool_destroy(&pool);
+}
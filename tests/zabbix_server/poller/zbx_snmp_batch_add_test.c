@@ -0,0 +1,284 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxcommon.h"
+
+#include "../../../src/zabbix_server/poller/checks_snmp.c"
+
+#define MOCK_SNMP_ITEMS_MAX	64
+
+static void	*started[MOCK_SNMP_ITEMS_MAX];
+static int	started_num;
+
+int	__wrap_zbx_dc_config_get_suggested_snmp_vars(zbx_uint64_t interfaceid, int *bulk);
+void	__wrap_zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase, const char *addr,
+		void *data, int timeout, zbx_async_task_process_cb_t process_cb, zbx_async_task_clear_cb_t clear_cb);
+
+int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num);
+
+int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num)
+{
+	ZBX_UNUSED(local_server_num);
+	ZBX_UNUSED(local_process_type);
+	ZBX_UNUSED(local_process_num);
+
+	return 0;
+}
+
+int	MAIN_ZABBIX_ENTRY(int flags)
+{
+	ZBX_UNUSED(flags);
+
+	return 0;
+}
+
+int	__wrap_zbx_dc_config_get_suggested_snmp_vars(zbx_uint64_t interfaceid, int *bulk)
+{
+	zbx_mock_handle_t	hinterfaces, hinterface;
+
+	if (NULL != bulk)
+		*bulk = 1;
+
+	hinterfaces = zbx_mock_get_parameter_handle("in.interfaces");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hinterfaces, &hinterface))
+	{
+		if (interfaceid == zbx_mock_get_object_member_uint64(hinterface, "interfaceid"))
+			return (int)zbx_mock_get_object_member_uint64(hinterface, "max_vars");
+	}
+
+	fail_msg("unexpected interface " ZBX_FS_UI64, interfaceid);
+
+	return 0;
+}
+
+void	__wrap_zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase, const char *addr,
+		void *data, int timeout, zbx_async_task_process_cb_t process_cb, zbx_async_task_clear_cb_t clear_cb)
+{
+	ZBX_UNUSED(ev);
+	ZBX_UNUSED(dnsbase);
+	ZBX_UNUSED(addr);
+	ZBX_UNUSED(timeout);
+	ZBX_UNUSED(process_cb);
+	ZBX_UNUSED(clear_cb);
+
+	if (MOCK_SNMP_ITEMS_MAX == started_num)
+		fail_msg("too many started requests");
+
+	started[started_num++] = data;
+}
+
+#ifdef HAVE_NETSNMP
+static unsigned char	mock_str_to_snmp_oid_type(const char *str)
+{
+	if (0 == strcmp(str, "get"))
+		return ZBX_SNMP_GET;
+
+	if (0 == strcmp(str, "walk"))
+		return ZBX_SNMP_WALK;
+
+	fail_msg("unknown SNMP OID type: %s", str);
+
+	return ZBX_SNMP_GET;
+}
+
+static int	mock_context_index(zbx_snmp_context_t **contexts, int contexts_num, const zbx_snmp_context_t *context)
+{
+	int	i;
+
+	for (i = 0; i < contexts_num; i++)
+	{
+		if (contexts[i] == context)
+			return i;
+	}
+
+	fail_msg("unknown SNMP context");
+
+	return -1;
+}
+
+static zbx_snmp_context_t	*mock_snmp_context_create(zbx_mock_handle_t hitem)
+{
+	zbx_snmp_context_t	*snmp_context;
+
+	snmp_context = (zbx_snmp_context_t *)zbx_malloc(NULL, sizeof(zbx_snmp_context_t));
+	memset(snmp_context, 0, sizeof(zbx_snmp_context_t));
+
+	snmp_context->item.interface.interfaceid = zbx_mock_get_object_member_uint64(hitem, "interfaceid");
+	snmp_context->snmp_oid_type = mock_str_to_snmp_oid_type(zbx_mock_get_object_member_string(hitem, "type"));
+	snmp_context->snmp_version = (unsigned char)zbx_mock_get_object_member_uint64(hitem, "version");
+	snmp_context->snmp_community = zbx_strdup(NULL, zbx_mock_get_object_member_string(hitem, "community"));
+	snmp_context->config_timeout = 3;
+	snmp_context->batch_size = 1;
+	snmp_context->batch_min_fail = ZBX_MAX_SNMP_ITEMS + 1;
+
+	zbx_vector_snmp_context_create(&snmp_context->batch);
+	zbx_vector_snmp_oid_create(&snmp_context->param_oids);
+	zbx_vector_snmp_oid_append(&snmp_context->param_oids, NULL);
+
+	return snmp_context;
+}
+
+static void	mock_snmp_context_free(zbx_snmp_context_t *snmp_context)
+{
+	zbx_vector_snmp_oid_destroy(&snmp_context->param_oids);
+	zbx_vector_snmp_context_destroy(&snmp_context->batch);
+	zbx_free(snmp_context->snmp_community);
+	zbx_free(snmp_context);
+}
+
+/* compare started requests by the first requested item, requests of different interfaces */
+/* are started in hashset order when batches are flushed                                  */
+static int	mock_batch_compare(const void *d1, const void *d2)
+{
+	const zbx_vector_uint64_t	*b1 = *(const zbx_vector_uint64_t * const *)d1;
+	const zbx_vector_uint64_t	*b2 = *(const zbx_vector_uint64_t * const *)d2;
+
+	ZBX_RETURN_IF_NOT_EQUAL(b1->values[0], b2->values[0]);
+
+	return 0;
+}
+#endif
+
+void	zbx_mock_test_entry(void **state)
+{
+#ifdef HAVE_NETSNMP
+	zbx_snmp_context_t	*contexts[MOCK_SNMP_ITEMS_MAX];
+	zbx_vector_ptr_t	batches;
+	zbx_hashset_t		snmp_batches;
+	zbx_mock_handle_t	hitems, hitem, hbatched, hbatches, hbatch, hindex;
+	zbx_mock_error_t	err;
+	int			i, j, contexts_num = 0;
+
+	ZBX_UNUSED(state);
+
+	hitems = zbx_mock_get_parameter_handle("in.items");
+	hbatched = zbx_mock_get_parameter_handle("out.batched");
+
+	zbx_hashset_create(&snmp_batches, 0, ZBX_DEFAULT_UINT64_HASH_FUNC, ZBX_DEFAULT_UINT64_COMPARE_FUNC);
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hitems, &hitem))
+	{
+		zbx_mock_handle_t	hret;
+		const char		*ret_str;
+
+		if (MOCK_SNMP_ITEMS_MAX == contexts_num)
+			fail_msg("too many items");
+
+		contexts[contexts_num] = mock_snmp_context_create(hitem);
+
+		if (ZBX_MOCK_SUCCESS != (err = zbx_mock_vector_element(hbatched, &hret)) ||
+				ZBX_MOCK_SUCCESS != (err = zbx_mock_string(hret, &ret_str)))
+		{
+			fail_msg("cannot read expected result of item #%d: %s", contexts_num,
+					zbx_mock_error_string(err));
+		}
+
+		zbx_mock_assert_result_eq("snmp_batch_add()", zbx_mock_str_to_return_code(ret_str),
+				snmp_batch_add(&snmp_batches, contexts[contexts_num]));
+
+		contexts_num++;
+	}
+
+	zbx_async_check_snmp_flush(&snmp_batches);
+	zbx_hashset_destroy(&snmp_batches);
+
+	/* requested items, the batch owner is requested last */
+	zbx_vector_ptr_create(&batches);
+
+	for (i = 0; i < started_num; i++)
+	{
+		zbx_snmp_context_t	*leader = (zbx_snmp_context_t *)started[i];
+		zbx_vector_uint64_t	*batch;
+
+		batch = (zbx_vector_uint64_t *)zbx_malloc(NULL, sizeof(zbx_vector_uint64_t));
+		zbx_vector_uint64_create(batch);
+
+		if (0 == leader->batch.values_num)
+		{
+			zbx_vector_uint64_append(batch, (zbx_uint64_t)mock_context_index(contexts, contexts_num,
+					leader));
+		}
+		else
+		{
+			zbx_mock_assert_int_eq("batch size", leader->batch.values_num, leader->batch_size);
+			zbx_mock_assert_ptr_eq("batch owner", leader,
+					leader->batch.values[leader->batch.values_num - 1]);
+
+			for (j = 0; j < leader->batch.values_num; j++)
+			{
+				zbx_vector_uint64_append(batch, (zbx_uint64_t)mock_context_index(contexts,
+						contexts_num, leader->batch.values[j]));
+			}
+		}
+
+		zbx_vector_ptr_append(&batches, batch);
+	}
+
+	zbx_vector_ptr_sort(&batches, mock_batch_compare);
+
+	hbatches = zbx_mock_get_parameter_handle("out.batches");
+
+	for (i = 0; ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hbatches, &hbatch); i++)
+	{
+		zbx_vector_uint64_t	*batch;
+
+		if (i >= batches.values_num)
+			fail_msg("expected more than %d requests", batches.values_num);
+
+		batch = (zbx_vector_uint64_t *)batches.values[i];
+
+		for (j = 0; ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hbatch, &hindex); j++)
+		{
+			zbx_uint64_t	index;
+
+			if (j >= batch->values_num)
+				fail_msg("expected more than %d items in request #%d", batch->values_num, i);
+
+			if (ZBX_MOCK_SUCCESS != (err = zbx_mock_uint64(hindex, &index)))
+				fail_msg("cannot read item index: %s", zbx_mock_error_string(err));
+
+			zbx_mock_assert_uint64_eq("requested item", index, batch->values[j]);
+		}
+
+		zbx_mock_assert_int_eq("number of items in request", j, batch->values_num);
+	}
+
+	zbx_mock_assert_int_eq("number of requests", i, batches.values_num);
+
+	for (i = 0; i < batches.values_num; i++)
+	{
+		zbx_vector_uint64_destroy((zbx_vector_uint64_t *)batches.values[i]);
+		zbx_free(batches.values[i]);
+	}
+
+	zbx_vector_ptr_destroy(&batches);
+
+	for (i = 0; i < contexts_num; i++)
+		mock_snmp_context_free(contexts[i]);
+#else
+	ZBX_UNUSED(state);
+
+	skip();
+#endif
+}
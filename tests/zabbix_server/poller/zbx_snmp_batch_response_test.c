@@ -0,0 +1,263 @@
+/*
+** Zabbix
+** Copyright (C) 2001-2023 Zabbix SIA
+**
+** This program is free software; you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation; either version 2 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+**/
+
+#include "zbxmocktest.h"
+#include "zbxmockdata.h"
+#include "zbxmockassert.h"
+#include "zbxmockutil.h"
+#include "zbxcommon.h"
+
+#include "../../../src/zabbix_server/poller/checks_snmp.c"
+
+#define MOCK_SNMP_ITEMS_MAX	64
+
+void	__wrap_zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase, const char *addr,
+		void *data, int timeout, zbx_async_task_process_cb_t process_cb, zbx_async_task_clear_cb_t clear_cb);
+
+int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num);
+
+int	get_process_info_by_thread(int local_server_num, unsigned char *local_process_type, int *local_process_num)
+{
+	ZBX_UNUSED(local_server_num);
+	ZBX_UNUSED(local_process_type);
+	ZBX_UNUSED(local_process_num);
+
+	return 0;
+}
+
+int	MAIN_ZABBIX_ENTRY(int flags)
+{
+	ZBX_UNUSED(flags);
+
+	return 0;
+}
+
+void	__wrap_zbx_async_poller_add_task(struct event_base *ev, struct evdns_base *dnsbase, const char *addr,
+		void *data, int timeout, zbx_async_task_process_cb_t process_cb, zbx_async_task_clear_cb_t clear_cb)
+{
+	ZBX_UNUSED(ev);
+	ZBX_UNUSED(dnsbase);
+	ZBX_UNUSED(addr);
+	ZBX_UNUSED(data);
+	ZBX_UNUSED(timeout);
+	ZBX_UNUSED(process_cb);
+	ZBX_UNUSED(clear_cb);
+}
+
+#ifdef HAVE_NETSNMP
+static long	mock_str_to_errstat(const char *str)
+{
+	if (0 == strcmp(str, "noError"))
+		return SNMP_ERR_NOERROR;
+
+	if (0 == strcmp(str, "tooBig"))
+		return SNMP_ERR_TOOBIG;
+
+	if (0 == strcmp(str, "noSuchName"))
+		return SNMP_ERR_NOSUCHNAME;
+
+	if (0 == strcmp(str, "genErr"))
+		return SNMP_ERR_GENERR;
+
+	fail_msg("unknown SNMP error status: %s", str);
+
+	return SNMP_ERR_NOERROR;
+}
+
+static zbx_snmp_context_t	*mock_snmp_context_create(int index)
+{
+	zbx_snmp_context_t	*snmp_context;
+	zbx_bulkwalk_context_t	*bulkwalk_context;
+	zbx_snmp_oid_t		*p_oid;
+	oid			root_oid[] = {1, 3, 6, 1, 2, 1, 1, 0, 0};
+
+	snmp_context = (zbx_snmp_context_t *)zbx_malloc(NULL, sizeof(zbx_snmp_context_t));
+	memset(snmp_context, 0, sizeof(zbx_snmp_context_t));
+
+	snmp_context->item.interface.interfaceid = 1;
+	snmp_context->item.ret = FAIL;
+	snmp_context->snmp_oid_type = ZBX_SNMP_GET;
+	snmp_context->snmp_version = ZBX_IF_SNMP_VERSION_2;
+	snmp_context->batch_size = 1;
+	snmp_context->batch_min_fail = ZBX_MAX_SNMP_ITEMS + 1;
+	zbx_init_agent_result(&snmp_context->item.result);
+
+	root_oid[7] = (oid)index + 1;
+
+	p_oid = (zbx_snmp_oid_t *)zbx_malloc(NULL, sizeof(zbx_snmp_oid_t));
+	memcpy(p_oid->root_oid, root_oid, sizeof(root_oid));
+	p_oid->root_oid_len = ARRSIZE(root_oid);
+	p_oid->str_oid = NULL;
+
+	bulkwalk_context = (zbx_bulkwalk_context_t *)zbx_malloc(NULL, sizeof(zbx_bulkwalk_context_t));
+	memset(bulkwalk_context, 0, sizeof(zbx_bulkwalk_context_t));
+	bulkwalk_context->p_oid = p_oid;
+
+	zbx_vector_snmp_context_create(&snmp_context->batch);
+	zbx_vector_snmp_oid_create(&snmp_context->param_oids);
+	zbx_vector_snmp_oid_append(&snmp_context->param_oids, p_oid);
+	zbx_vector_bulkwalk_context_create(&snmp_context->bulkwalk_contexts);
+	zbx_vector_bulkwalk_context_append(&snmp_context->bulkwalk_contexts, bulkwalk_context);
+
+	return snmp_context;
+}
+
+static void	mock_snmp_context_free(zbx_snmp_context_t *snmp_context)
+{
+	zbx_free(snmp_context->bulkwalk_contexts.values[0]);
+	zbx_vector_bulkwalk_context_destroy(&snmp_context->bulkwalk_contexts);
+	zbx_free(snmp_context->param_oids.values[0]);
+	zbx_vector_snmp_oid_destroy(&snmp_context->param_oids);
+	zbx_vector_snmp_context_destroy(&snmp_context->batch);
+	zbx_free_agent_result(&snmp_context->item.result);
+	zbx_free(snmp_context->results);
+	zbx_free(snmp_context);
+}
+
+/******************************************************************************
+ *                                                                            *
+ * Purpose: create response to the current request of the batch, the value    *
+ *          of each returned variable is the index of the requested item      *
+ *                                                                            *
+ ******************************************************************************/
+static struct snmp_pdu	*mock_response_create(zbx_mock_handle_t hresponse, const zbx_snmp_context_t *leader)
+{
+	struct snmp_pdu	*pdu;
+	int		i, vars_num;
+
+	pdu = snmp_pdu_create(SNMP_MSG_RESPONSE);
+	pdu->errstat = mock_str_to_errstat(zbx_mock_get_object_member_string(hresponse, "errstat"));
+
+	if (SNMP_ERR_NOERROR != pdu->errstat)
+		return pdu;
+
+	vars_num = (int)zbx_mock_get_object_member_uint64(hresponse, "vars");
+
+	for (i = 0; i < vars_num; i++)
+	{
+		const zbx_snmp_context_t	*member = leader->batch.values[leader->batch_offset + i];
+		const zbx_snmp_oid_t		*p_oid = member->bulkwalk_contexts.values[0]->p_oid;
+		long				value = leader->batch_offset + i;
+
+		snmp_pdu_add_variable(pdu, p_oid->root_oid, p_oid->root_oid_len, ASN_INTEGER, (u_char *)&value,
+				sizeof(value));
+	}
+
+	return pdu;
+}
+#endif
+
+void	zbx_mock_test_entry(void **state)
+{
+#ifdef HAVE_NETSNMP
+	zbx_snmp_context_t	*contexts[MOCK_SNMP_ITEMS_MAX], *leader;
+	zbx_mock_handle_t	hresponses, hresponse, hstates, hstate, hresults, hresult, herror;
+	zbx_mock_error_t	err;
+	int			i, items_num;
+	char			error[MAX_STRING_LEN];
+
+	ZBX_UNUSED(state);
+
+	if (MOCK_SNMP_ITEMS_MAX < (items_num = (int)zbx_mock_get_parameter_uint64("in.items")) || 2 > items_num)
+		fail_msg("invalid number of items: %d", items_num);
+
+	for (i = 0; i < items_num; i++)
+		contexts[i] = mock_snmp_context_create(i);
+
+	/* the batch owner is requested last */
+	leader = contexts[items_num - 1];
+
+	for (i = 0; i < items_num - 1; i++)
+		zbx_vector_snmp_context_append(&leader->batch, contexts[i]);
+
+	snmp_batch_start(leader);
+
+	hresponses = zbx_mock_get_parameter_handle("in.responses");
+	hstates = zbx_mock_get_parameter_handle("out.states");
+
+	while (ZBX_MOCK_SUCCESS == zbx_mock_vector_element(hresponses, &hresponse))
+	{
+		struct snmp_pdu	*pdu;
+
+		if (leader->batch_offset == leader->batch.values_num)
+			fail_msg("response to a finished batch");
+
+		pdu = mock_response_create(hresponse, leader);
+		zbx_mock_assert_result_eq("snmp_batch_handle_response()", SUCCEED,
+				snmp_batch_handle_response(STAT_SUCCESS, pdu, leader, error, sizeof(error)));
+		snmp_free_pdu(pdu);
+
+		if (ZBX_MOCK_SUCCESS != (err = zbx_mock_vector_element(hstates, &hstate)))
+			fail_msg("cannot read expected batch state: %s", zbx_mock_error_string(err));
+
+		zbx_mock_assert_int_eq("batch offset", zbx_mock_get_object_member_int(hstate, "offset"),
+				leader->batch_offset);
+		zbx_mock_assert_int_eq("batch size", zbx_mock_get_object_member_int(hstate, "size"),
+				leader->batch_size);
+		zbx_mock_assert_int_eq("batch min fail", zbx_mock_get_object_member_int(hstate, "min_fail"),
+				leader->batch_min_fail);
+		zbx_mock_assert_int_eq("batch max succeed", zbx_mock_get_object_member_int(hstate, "max_succeed"),
+				leader->batch_max_succeed);
+	}
+
+	zbx_mock_assert_int_eq("requested items", leader->batch.values_num, leader->batch_offset);
+
+	hresults = zbx_mock_get_parameter_handle("out.results");
+
+	for (i = 0; i < items_num; i++)
+	{
+		AGENT_RESULT	*result = &leader->batch.values[i]->item.result;
+		int		ret = leader->batch.values[i]->item.ret;
+
+		if (ZBX_MOCK_SUCCESS != (err = zbx_mock_vector_element(hresults, &hresult)))
+			fail_msg("cannot read expected result of item #%d: %s", i, zbx_mock_error_string(err));
+
+		zbx_mock_assert_result_eq("item result", zbx_mock_str_to_return_code(
+				zbx_mock_get_object_member_string(hresult, "ret")), ret);
+
+		if (SUCCEED == ret)
+		{
+			if (NULL == ZBX_GET_TEXT_RESULT(result))
+				fail_msg("item #%d has no value", i);
+
+			zbx_mock_assert_str_eq("item value", zbx_mock_get_object_member_string(hresult, "value"),
+					*ZBX_GET_TEXT_RESULT(result));
+		}
+		else if (ZBX_MOCK_SUCCESS == zbx_mock_object_member(hresult, "error", &herror))
+		{
+			const char	*expected_error;
+
+			if (NULL == ZBX_GET_MSG_RESULT(result))
+				fail_msg("item #%d has no error", i);
+
+			if (ZBX_MOCK_SUCCESS != (err = zbx_mock_string(herror, &expected_error)))
+				fail_msg("cannot read expected error: %s", zbx_mock_error_string(err));
+
+			zbx_mock_assert_str_eq("item error", expected_error, *ZBX_GET_MSG_RESULT(result));
+		}
+	}
+
+	for (i = 0; i < items_num; i++)
+		mock_snmp_context_free(contexts[i]);
+#else
+	ZBX_UNUSED(state);
+
+	skip();
+#endif
+}
@@ -36,6 +36,7 @@
 void	*mock_streams[ZBX_MOCK_MAX_FILES];
 
 static zbx_mock_handle_t	fragments;
+static int			fragments_socket = -1;
 
 static FILE	*(*fopen_mock_callback)(const char *, const char *) = NULL;
 
@@ -58,6 +59,7 @@ int	__wrap___fxstat(int __ver, int __fildes, struct stat *__stat_buf);
 #endif
 
 int	__real_open(const char *path, int oflag, ...);
+ssize_t	__real_read(int fildes, void *buf, size_t nbyte);
 int	__real_stat(const char *path, struct stat *buf);
 int	__real_fstat(int __fildes, struct stat *__stat_buf);
 #ifdef HAVE_FXSTAT
@@ -184,13 +186,14 @@ int	__wrap_connect(int socket, void *addr, socklen_t address_len)
 {
 	zbx_mock_error_t	error;
 
-	ZBX_UNUSED(socket);
 	ZBX_UNUSED(addr);
 	ZBX_UNUSED(address_len);
 
 	if (ZBX_MOCK_SUCCESS != (error = zbx_mock_in_parameter("fragments", &fragments)))
 		fail_msg("Cannot get fragments handle: %s", zbx_mock_error_string(error));
 
+	fragments_socket = socket;
+
 	return 0;
 }
 
@@ -226,11 +229,10 @@ int	__wrap_open(const char *path, int oflag, ...)
 
 /******************************************************************************
  *                                                                            *
- * Comments: Note that simply wrapping read function will break any compiled  *
- *           in tool, that would attempt to use read() function. In this case *
- *           some safeguards must be added to implement pass-through          *
- *           functionality like it's done with open/fxstat etc functions for  *
- *           coverage builds.                                                 *
+ * Comments: Only descriptors returned by mocked open() and the socket        *
+ *           passed to mocked connect() are read from test case fragments,    *
+ *           other descriptors are read with real read() function, like it's  *
+ *           done with open/fxstat etc functions for coverage builds.         *
  *                                                                            *
  ******************************************************************************/
 ssize_t	__wrap_read(int fildes, void *buf, size_t nbyte)
@@ -241,7 +243,8 @@ ssize_t	__wrap_read(int fildes, void *buf, size_t nbyte)
 	zbx_mock_handle_t	fragment;
 	size_t			length;
 
-	ZBX_UNUSED(fildes);
+	if (INT_MAX != fildes && fragments_socket != fildes)
+		return __real_read(fildes, buf, nbyte);
 
 	if (0 == remaining_length)
 	{